@@ -0,0 +1,89 @@
+//
+//  JRPCArgumentPlan.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCJSONWriter.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Extracts the argument at argIndex of an invocation as an object that can be used in the JSON-RPC request
+ Raises NSInvalidArgumentException if the argument value cannot be represented in JSON
+ */
+typedef id _Nonnull (*JRPCArgumentExtractor)(NSInvocation *invocation, NSInteger argIndex);
+
+/**
+ Writes the argument at argIndex of an invocation as JSON, without boxing primitives
+ Raises NSInvalidArgumentException if the argument value cannot be represented in JSON
+ */
+typedef void (*JRPCArgumentEncoder)(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex);
+
+/**
+ Sets the argument at argIndex of an invocation from a JSON-RPC parameter value, unboxing primitives
+ @return NO if the value cannot be converted to the argument type, e.g. a string for a number
+ */
+typedef BOOL (*JRPCArgumentDecoder)(NSInvocation *invocation, NSInteger argIndex, id _Nullable value);
+
+/**
+ JRPCArgumentPlan is the precompiled plan for marshalling a single argument of a proxied method into a JSON-RPC parameter
+ Plans are built once per argument when the proxy is initialized, so the type encoding is never inspected on each call
+ */
+typedef struct JRPCArgumentPlan {
+    /** The single character Objective-C runtime type encoding of the argument */
+    char typeEncoding;
+    /** The function specialised for the argument type that extracts & boxes its value */
+    JRPCArgumentExtractor extractor;
+    /** The function specialised for the argument type that writes its value straight into a JSON request */
+    JRPCArgumentEncoder encoder;
+    /** The function specialised for the argument type that sets its value from a JSON-RPC parameter, when dispatching requests (see JRPCDispatcher) */
+    JRPCArgumentDecoder decoder;
+    /** The JSON text written before the value, i.e. the separator and (BY-NAME) the quoted param name. Owned by the method descriptor */
+    const char *prefix;
+    /** The length of prefix */
+    NSUInteger prefixLength;
+} JRPCArgumentPlan;
+
+/**
+ Compiles the plan for an argument
+ @param typeEncoding The Objective-C runtime type encoding of the argument
+ @param plan On return, the plan for the argument if supported
+ @return YES if the type encoding is supported, otherwise NO
+ */
+FOUNDATION_EXTERN BOOL JRPCArgumentPlanForTypeEncoding(const char *typeEncoding, JRPCArgumentPlan *plan);
+
+/**
+ Determines the JSON representation of an object parameter, applying jsonRPCRequestRepresentation if required (see JRPCTransformable)
+ @param obj The object parameter value
+ @return obj if it is a valid JSON object, or its jsonRPCRequestRepresentation if that is. nil if the object cannot be represented in JSON
+ @discussion Whether a class is natively JSON serializable or needs transforming is cached per class, so only container objects are ever walked to check validity.
+ NSData, alone or in containers, is also returned for codecs that carry binary natively (see JRPCCodec), and rejected later if the request is encoded as JSON
+ */
+FOUNDATION_EXTERN id _Nullable JRPCJSONObjectForParameter(id _Nullable obj);
+
+NS_ASSUME_NONNULL_END
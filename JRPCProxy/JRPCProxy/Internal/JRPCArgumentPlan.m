@@ -0,0 +1,355 @@
+//
+//  JRPCArgumentPlan.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCArgumentPlan.h"
+#import "JRPCNumericArray.h"
+#import "JRPCTransformable.h"
+#import "JRPCJSONReader.h"
+#import <objc/runtime.h>
+#import <stdatomic.h>
+
+#pragma mark - Object parameter kinds
+
+/** How an object parameter of a given class is represented in JSON */
+typedef NS_ENUM(uint8_t, JRPCParameterKind) {
+    /** Not yet determined */
+    JRPCParameterKindUnknown = 0,
+    /** NSString & NSNull are always valid JSON */
+    JRPCParameterKindNative,
+    /** NSNumber is valid JSON unless NaN or infinite */
+    JRPCParameterKindNumber,
+    /** NSArray & NSDictionary are valid JSON if their contents are */
+    JRPCParameterKindContainer,
+    /** NSData is not JSON, but is passed through for codecs that carry it natively. The JSON writer rejects it */
+    JRPCParameterKindData,
+    /** Instances implement jsonRPCRequestRepresentation */
+    JRPCParameterKindTransformable,
+    /** Cannot be represented in JSON */
+    JRPCParameterKindUnsupported
+};
+
+// Small lock-free cache of parameter class => kind, shared by all proxies since the kind only depends on the class
+// An entry is claimed once by a CAS on its class, then its kind is published. A reader that finds the class before the kind is published treats it as a miss
+#define JRPC_PARAMETER_KIND_CACHE_SIZE 64
+typedef struct {
+    _Atomic(uintptr_t) cls;
+    _Atomic(uint8_t) kind;
+} JRPCParameterKindCacheEntry;
+static JRPCParameterKindCacheEntry sParameterKindCache[JRPC_PARAMETER_KIND_CACHE_SIZE];
+
+static JRPCParameterKind JRPCComputeParameterKind(Class cls) {
+    if ([cls isSubclassOfClass:[NSString class]] || [cls isSubclassOfClass:[NSNull class]]) {
+        return JRPCParameterKindNative;
+    }
+    if ([cls isSubclassOfClass:[NSNumber class]]) {
+        return JRPCParameterKindNumber;
+    }
+    if ([cls isSubclassOfClass:[NSArray class]] || [cls isSubclassOfClass:[NSDictionary class]]) {
+        return JRPCParameterKindContainer;
+    }
+    if ([cls isSubclassOfClass:[NSData class]]) {
+        return JRPCParameterKindData;
+    }
+    if ([cls instancesRespondToSelector:@selector(jsonRPCRequestRepresentation)]) {
+        return JRPCParameterKindTransformable;
+    }
+    return JRPCParameterKindUnsupported;
+}
+
+static JRPCParameterKind JRPCParameterKindForClass(Class cls) {
+    uintptr_t key = (uintptr_t)cls;
+    NSUInteger slot = (NSUInteger)(key >> 4);
+    for (NSUInteger probe = 0; probe < JRPC_PARAMETER_KIND_CACHE_SIZE; ++probe) {
+        JRPCParameterKindCacheEntry *entry = &sParameterKindCache[(slot + probe) % JRPC_PARAMETER_KIND_CACHE_SIZE];
+        uintptr_t entryKey = atomic_load_explicit(&entry->cls, memory_order_acquire);
+        if (entryKey == key) {
+            JRPCParameterKind kind = atomic_load_explicit(&entry->kind, memory_order_acquire);
+            return (JRPCParameterKindUnknown != kind) ? kind : JRPCComputeParameterKind(cls);
+        }
+        if (0 == entryKey) {
+            JRPCParameterKind kind = JRPCComputeParameterKind(cls);
+            if (atomic_compare_exchange_strong_explicit(&entry->cls, &entryKey, key, memory_order_acq_rel, memory_order_acquire)) {
+                atomic_store_explicit(&entry->kind, kind, memory_order_release);
+                return kind;
+            }
+            if (entryKey == key) {
+                // Another thread claimed the entry for the same class
+                return kind;
+            }
+            // Another thread claimed the entry for a different class, keep probing
+        }
+    }
+    // Cache is full
+    return JRPCComputeParameterKind(cls);
+}
+
+// Walks a container that NSJSONSerialization rejected, in case that is only because it holds NSData
+static BOOL JRPCIsValidContainerWithData(id obj) {
+    if ([obj isKindOfClass:[NSString class]] || [obj isKindOfClass:[NSNull class]] || [obj isKindOfClass:[NSData class]]) {
+        return YES;
+    }
+    if ([obj isKindOfClass:[NSNumber class]]) {
+        return isfinite([(NSNumber*)obj doubleValue]);
+    }
+    if ([obj isKindOfClass:[NSArray class]]) {
+        for (id element in (NSArray*)obj) {
+            if (!JRPCIsValidContainerWithData(element)) {
+                return NO;
+            }
+        }
+        return YES;
+    }
+    if ([obj isKindOfClass:[NSDictionary class]]) {
+        __block BOOL valid = YES;
+        [(NSDictionary*)obj enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            valid = [key isKindOfClass:[NSString class]] && JRPCIsValidContainerWithData(value);
+            *stop = !valid;
+        }];
+        return valid;
+    }
+    return NO;
+}
+
+static id JRPCValidJSONObject(id obj, JRPCParameterKind kind) {
+    switch (kind) {
+        case JRPCParameterKindNative:
+        case JRPCParameterKindData:
+            return obj;
+        case JRPCParameterKindNumber:
+            return isfinite([(NSNumber*)obj doubleValue]) ? obj : nil;
+        case JRPCParameterKindContainer:
+            return ([NSJSONSerialization isValidJSONObject:obj] || JRPCIsValidContainerWithData(obj)) ? obj : nil;
+        default:
+            return nil;
+    }
+}
+
+id JRPCJSONObjectForParameter(id obj) {
+    if (!obj) {
+        return nil;
+    }
+    JRPCParameterKind kind = JRPCParameterKindForClass(object_getClass(obj));
+    id jsonObj = JRPCValidJSONObject(obj, kind);
+    if (!jsonObj && JRPCParameterKindUnsupported != kind && [obj respondsToSelector:@selector(jsonRPCRequestRepresentation)]) {
+        // Not natively JSON serializable, so process the optional transformation. The representation itself is not transformed again.
+        id newParam = [obj jsonRPCRequestRepresentation];
+        if (newParam) {
+            jsonObj = JRPCValidJSONObject(newParam, JRPCParameterKindForClass(object_getClass(newParam)));
+        }
+    }
+    return jsonObj;
+}
+
+#pragma mark - Extractors
+
+// Primitives are boxed in NSNumber
+#define JRPC_NUMBER_EXTRACTOR(name, type) \
+static id JRPCExtract##name(NSInvocation *invocation, NSInteger argIndex) { \
+    type value = 0; \
+    [invocation getArgument:&value atIndex:argIndex]; \
+    return @(value); \
+}
+
+JRPC_NUMBER_EXTRACTOR(Bool, _Bool)
+JRPC_NUMBER_EXTRACTOR(Char, char)
+JRPC_NUMBER_EXTRACTOR(Int, int)
+JRPC_NUMBER_EXTRACTOR(Short, short)
+JRPC_NUMBER_EXTRACTOR(Long, long)
+JRPC_NUMBER_EXTRACTOR(LongLong, long long)
+JRPC_NUMBER_EXTRACTOR(UnsignedChar, unsigned char)
+JRPC_NUMBER_EXTRACTOR(UnsignedInt, unsigned int)
+JRPC_NUMBER_EXTRACTOR(UnsignedShort, unsigned short)
+JRPC_NUMBER_EXTRACTOR(UnsignedLong, unsigned long)
+JRPC_NUMBER_EXTRACTOR(UnsignedLongLong, unsigned long long)
+JRPC_NUMBER_EXTRACTOR(Float, float)
+JRPC_NUMBER_EXTRACTOR(Double, double)
+
+// Character strings are boxed in NSString
+static id JRPCExtractCString(NSInvocation *invocation, NSInteger argIndex) {
+    char *value = NULL;
+    [invocation getArgument:&value atIndex:argIndex];
+    NSString *string = value ? [[NSString alloc] initWithUTF8String:value] : nil;
+    // Fall back to the system encoding for NULL and non UTF-8 strings
+    return string ? : [NSString stringWithFormat:@"%s", value];
+}
+
+// Objects are passed through, or transformed, if they can be represented in JSON
+static id JRPCExtractObject(NSInvocation *invocation, NSInteger argIndex) {
+    __unsafe_unretained id obj = nil;
+    [invocation getArgument:&obj atIndex:argIndex];
+    id jsonObj = JRPCJSONObjectForParameter(obj);
+    if (!jsonObj) {
+        // Not JSON serializable
+        [NSException raise:NSInvalidArgumentException format:@"Unsupported object type for param at index=%li, obj=%@", (long)argIndex-2, obj];
+    }
+    return jsonObj;
+}
+
+#pragma mark - Encoders
+
+#define JRPC_SIGNED_ENCODER(name, type) \
+static void JRPCEncode##name(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) { \
+    type value = 0; \
+    [invocation getArgument:&value atIndex:argIndex]; \
+    JRPCJSONWriterAppendInt64(writer, (int64_t)value); \
+}
+
+#define JRPC_UNSIGNED_ENCODER(name, type) \
+static void JRPCEncode##name(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) { \
+    type value = 0; \
+    [invocation getArgument:&value atIndex:argIndex]; \
+    JRPCJSONWriterAppendUInt64(writer, (uint64_t)value); \
+}
+
+// Floats are widened to double, which is what boxing them in NSNumber would have serialized
+#define JRPC_REAL_ENCODER(name, type) \
+static void JRPCEncode##name(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) { \
+    type value = 0; \
+    [invocation getArgument:&value atIndex:argIndex]; \
+    if (!isfinite(value)) { \
+        [NSException raise:NSInvalidArgumentException format:@"Unsupported (NaN or infinite) value for param at index=%li", (long)argIndex-2]; \
+    } \
+    JRPCJSONWriterAppendDouble(writer, (double)value); \
+}
+
+static void JRPCEncodeBool(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) {
+    _Bool value = 0;
+    [invocation getArgument:&value atIndex:argIndex];
+    JRPCJSONWriterAppendBool(writer, value);
+}
+
+JRPC_SIGNED_ENCODER(Char, char)
+JRPC_SIGNED_ENCODER(Int, int)
+JRPC_SIGNED_ENCODER(Short, short)
+JRPC_SIGNED_ENCODER(Long, long)
+JRPC_SIGNED_ENCODER(LongLong, long long)
+JRPC_UNSIGNED_ENCODER(UnsignedChar, unsigned char)
+JRPC_UNSIGNED_ENCODER(UnsignedInt, unsigned int)
+JRPC_UNSIGNED_ENCODER(UnsignedShort, unsigned short)
+JRPC_UNSIGNED_ENCODER(UnsignedLong, unsigned long)
+JRPC_UNSIGNED_ENCODER(UnsignedLongLong, unsigned long long)
+JRPC_REAL_ENCODER(Float, float)
+JRPC_REAL_ENCODER(Double, double)
+
+static void JRPCEncodeCString(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) {
+    JRPCJSONWriterAppendString(writer, JRPCExtractCString(invocation, argIndex));
+}
+
+static void JRPCEncodeObject(JRPCJSONWriter *writer, NSInvocation *invocation, NSInteger argIndex) {
+    __unsafe_unretained id obj = nil;
+    [invocation getArgument:&obj atIndex:argIndex];
+    if ([obj isKindOfClass:[JRPCNumericArray class]]) {
+        // Written straight from the buffer rather than from its representation, which boxes every element
+        JRPCNumericArray *array = obj;
+        JRPCJSONWriterAppendNumericArray(writer, array.data.bytes, array.count, [[array class] objCType][0]);
+        return;
+    }
+    JRPCJSONWriterAppendObject(writer, JRPCExtractObject(invocation, argIndex));
+}
+
+#pragma mark - Decoders
+
+// Primitives are unboxed from NSNumber. Anything else, including null, is rejected rather than read as 0, as is a number the type cannot hold
+#define JRPC_NUMBER_DECODER(name, type, accessor) \
+static BOOL JRPCDecode##name(NSInvocation *invocation, NSInteger argIndex, id value) { \
+    if (![value isKindOfClass:[NSNumber class]] || !JRPCJSONNumberFitsType(value, @encode(type)[0])) { \
+        return NO; \
+    } \
+    type argument = [(NSNumber*)value accessor]; \
+    [invocation setArgument:&argument atIndex:argIndex]; \
+    return YES; \
+}
+
+JRPC_NUMBER_DECODER(Bool, _Bool, boolValue)
+JRPC_NUMBER_DECODER(Char, char, charValue)
+JRPC_NUMBER_DECODER(Int, int, intValue)
+JRPC_NUMBER_DECODER(Short, short, shortValue)
+JRPC_NUMBER_DECODER(Long, long, longValue)
+JRPC_NUMBER_DECODER(LongLong, long long, longLongValue)
+JRPC_NUMBER_DECODER(UnsignedChar, unsigned char, unsignedCharValue)
+JRPC_NUMBER_DECODER(UnsignedInt, unsigned int, unsignedIntValue)
+JRPC_NUMBER_DECODER(UnsignedShort, unsigned short, unsignedShortValue)
+JRPC_NUMBER_DECODER(UnsignedLong, unsigned long, unsignedLongValue)
+JRPC_NUMBER_DECODER(UnsignedLongLong, unsigned long long, unsignedLongLongValue)
+JRPC_NUMBER_DECODER(Float, float, floatValue)
+JRPC_NUMBER_DECODER(Double, double, doubleValue)
+
+// Character strings point into the NSString, so the invocation must retain its arguments (which copies C strings) before the string is released
+static BOOL JRPCDecodeCString(NSInvocation *invocation, NSInteger argIndex, id value) {
+    if (![value isKindOfClass:[NSString class]]) {
+        return NO;
+    }
+    const char *argument = [(NSString*)value UTF8String];
+    [invocation setArgument:&argument atIndex:argIndex];
+    return YES;
+}
+
+// Objects are passed as they are, except null which is passed as nil
+static BOOL JRPCDecodeObject(NSInvocation *invocation, NSInteger argIndex, id value) {
+    __unsafe_unretained id argument = (value == [NSNull null]) ? nil : value;
+    [invocation setArgument:&argument atIndex:argIndex];
+    return YES;
+}
+
+#pragma mark - Plans
+
+BOOL JRPCArgumentPlanForTypeEncoding(const char *typeEncoding, JRPCArgumentPlan *plan) {
+    // We only support SOME of the basic types
+    // See https://developer.apple.com/library/mac/documentation/Cocoa/Conceptual/ObjCRuntimeGuide/Articles/ocrtTypeEncodings.html
+    if (1 != strlen(typeEncoding)) {
+        return NO;
+    }
+    JRPCArgumentExtractor extractor = NULL;
+    JRPCArgumentEncoder encoder = NULL;
+    JRPCArgumentDecoder decoder = NULL;
+    switch (typeEncoding[0]) {
+        case 'B': extractor = JRPCExtractBool; encoder = JRPCEncodeBool; decoder = JRPCDecodeBool; break;                                         // A C++ bool or a C99 _Bool (Swift bridges booleans to this!)
+        case 'c': extractor = JRPCExtractChar; encoder = JRPCEncodeChar; decoder = JRPCDecodeChar; break;                                         // char
+        case 'i': extractor = JRPCExtractInt; encoder = JRPCEncodeInt; decoder = JRPCDecodeInt; break;                                            // int
+        case 's': extractor = JRPCExtractShort; encoder = JRPCEncodeShort; decoder = JRPCDecodeShort; break;                                      // short
+        case 'l': extractor = JRPCExtractLong; encoder = JRPCEncodeLong; decoder = JRPCDecodeLong; break;                                         // long, treated as 32-bit on 64-bit systems
+        case 'q': extractor = JRPCExtractLongLong; encoder = JRPCEncodeLongLong; decoder = JRPCDecodeLongLong; break;                             // long long
+        case 'C': extractor = JRPCExtractUnsignedChar; encoder = JRPCEncodeUnsignedChar; decoder = JRPCDecodeUnsignedChar; break;                 // unsigned char
+        case 'I': extractor = JRPCExtractUnsignedInt; encoder = JRPCEncodeUnsignedInt; decoder = JRPCDecodeUnsignedInt; break;                    // unsigned int
+        case 'S': extractor = JRPCExtractUnsignedShort; encoder = JRPCEncodeUnsignedShort; decoder = JRPCDecodeUnsignedShort; break;              // unsigned short
+        case 'L': extractor = JRPCExtractUnsignedLong; encoder = JRPCEncodeUnsignedLong; decoder = JRPCDecodeUnsignedLong; break;                 // unsigned long
+        case 'Q': extractor = JRPCExtractUnsignedLongLong; encoder = JRPCEncodeUnsignedLongLong; decoder = JRPCDecodeUnsignedLongLong; break;     // unsigned long long
+        case 'f': extractor = JRPCExtractFloat; encoder = JRPCEncodeFloat; decoder = JRPCDecodeFloat; break;                                      // float
+        case 'd': extractor = JRPCExtractDouble; encoder = JRPCEncodeDouble; decoder = JRPCDecodeDouble; break;                                   // double
+        case '*': extractor = JRPCExtractCString; encoder = JRPCEncodeCString; decoder = JRPCDecodeCString; break;                                // character string
+        case '@': extractor = JRPCExtractObject; encoder = JRPCEncodeObject; decoder = JRPCDecodeObject; break;                                   // Objects
+        default:
+            return NO;
+    }
+    plan->typeEncoding = typeEncoding[0];
+    plan->extractor = extractor;
+    plan->encoder = encoder;
+    plan->decoder = decoder;
+    return YES;
+}
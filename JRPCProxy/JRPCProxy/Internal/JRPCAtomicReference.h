@@ -0,0 +1,78 @@
+//
+//  JRPCAtomicReference.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import <pthread.h>
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** An object replaced in a JRPCAtomicReference, and the epoch it was replaced in */
+typedef struct JRPCAtomicReferenceRetired {
+    void *value;
+    uint64_t epoch;
+} JRPCAtomicReferenceRetired;
+
+/**
+ JRPCAtomicReference holds an object that is read on every call but rarely replaced, e.g. a setting, so that reads never take a lock.
+ Atomic properties take a lock on every read, shared by every thread reading the same property, which serialises callers on different threads.
+ A read here is an atomic load, bracketed by stores to a record of the reading thread's own, so readers on different threads share nothing they write.
+ Since a reader on another thread may still be retaining a replaced object, it is released once every thread reading when it was replaced has
+ finished (epoch based reclamation): this is checked as the reference is next replaced, so at most a few replaced objects are held at a time.
+ */
+typedef struct JRPCAtomicReference {
+    _Atomic(void *) value;
+    /** Serialises replacements, and guards the objects replaced */
+    pthread_mutex_t lock;
+    /** The objects replaced that a reader may still hold */
+    JRPCAtomicReferenceRetired * _Nullable retired;
+    NSUInteger retiredCount;
+    NSUInteger retiredCapacity;
+} JRPCAtomicReference;
+
+/** Initializes a reference to nil. Every initialized reference must be finished with JRPCAtomicReferenceDestroy() */
+FOUNDATION_EXTERN void JRPCAtomicReferenceInit(JRPCAtomicReference *reference);
+
+/** Releases the object referenced and all those it replaced */
+FOUNDATION_EXTERN void JRPCAtomicReferenceDestroy(JRPCAtomicReference *reference);
+
+/** Returns the object referenced, retained by the caller */
+FOUNDATION_EXTERN id _Nullable JRPCAtomicReferenceLoad(JRPCAtomicReference *reference);
+
+/** Replaces the object referenced, unless it is already value */
+FOUNDATION_EXTERN void JRPCAtomicReferenceStore(JRPCAtomicReference *reference, id _Nullable value);
+
+/**
+ Sets the object referenced if it is nil, without taking a lock, e.g. to publish a value created lazily on whichever thread needs it first
+ @return The object referenced afterwards: value, or the object another thread set first
+ */
+FOUNDATION_EXTERN id JRPCAtomicReferenceStoreIfNil(JRPCAtomicReference *reference, id value);
+
+NS_ASSUME_NONNULL_END
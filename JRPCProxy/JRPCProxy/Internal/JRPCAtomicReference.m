@@ -0,0 +1,179 @@
+//
+//  JRPCAtomicReference.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCAtomicReference.h"
+#import <stdlib.h>
+
+/**
+ A thread that reads references, and the epoch its current read began in (0 when it is not reading)
+ Records are never freed: one is reused by another thread once its own exits. Each has a cache line of its own, so readers share nothing they write
+ */
+typedef struct JRPCAtomicReferenceReader {
+    _Atomic(uint64_t) epoch;
+    atomic_bool inUse;
+    struct JRPCAtomicReferenceReader *next;
+} JRPCAtomicReferenceReader;
+
+#define JRPC_ATOMIC_REFERENCE_CACHE_LINE_SIZE 64
+
+// Advanced each time an object is replaced, so readers that began before can be told from those that began after
+static _Atomic(uint64_t) JRPCAtomicReferenceEpoch = 1;
+// Every reader record, pushed onto the front
+static _Atomic(JRPCAtomicReferenceReader *) JRPCAtomicReferenceReaders = NULL;
+static pthread_key_t JRPCAtomicReferenceReaderKey;
+static pthread_once_t JRPCAtomicReferenceReaderKeyOnce = PTHREAD_ONCE_INIT;
+static __thread JRPCAtomicReferenceReader *JRPCAtomicReferenceCurrentReader = NULL;
+
+static void JRPCAtomicReferenceReleaseReader(void *reader) {
+    atomic_store(&((JRPCAtomicReferenceReader *)reader)->inUse, false);
+}
+
+static void JRPCAtomicReferenceCreateReaderKey(void) {
+    pthread_key_create(&JRPCAtomicReferenceReaderKey, JRPCAtomicReferenceReleaseReader);
+}
+
+// Takes a record left by a thread that has exited, or adds one, for the calling thread
+static JRPCAtomicReferenceReader *JRPCAtomicReferenceRegisterReader(void) {
+    pthread_once(&JRPCAtomicReferenceReaderKeyOnce, JRPCAtomicReferenceCreateReaderKey);
+    JRPCAtomicReferenceReader *reader = NULL;
+    for (JRPCAtomicReferenceReader *candidate = atomic_load(&JRPCAtomicReferenceReaders); candidate && !reader; candidate = candidate->next) {
+        bool unused = false;
+        if (atomic_compare_exchange_strong(&candidate->inUse, &unused, true)) {
+            reader = candidate;
+        }
+    }
+    if (!reader) {
+        void *memory = NULL;
+        if (0 != posix_memalign(&memory, JRPC_ATOMIC_REFERENCE_CACHE_LINE_SIZE,
+                                MAX(sizeof(JRPCAtomicReferenceReader), (size_t)JRPC_ATOMIC_REFERENCE_CACHE_LINE_SIZE))) {
+            [NSException raise:NSMallocException format:@"Unable to allocate an atomic reference reader"];
+        }
+        reader = memory;
+        atomic_init(&reader->epoch, 0);
+        atomic_init(&reader->inUse, true);
+        JRPCAtomicReferenceReader *head = atomic_load(&JRPCAtomicReferenceReaders);
+        do {
+            reader->next = head;
+        } while (!atomic_compare_exchange_weak(&JRPCAtomicReferenceReaders, &head, reader));
+    }
+    pthread_setspecific(JRPCAtomicReferenceReaderKey, reader);
+    JRPCAtomicReferenceCurrentReader = reader;
+    return reader;
+}
+
+// Releases the replaced objects no reader can still hold: those replaced before the oldest read still going on began. Called with the lock held
+static void JRPCAtomicReferenceReclaim(JRPCAtomicReference *reference) {
+    uint64_t oldestEpoch = UINT64_MAX;
+    for (JRPCAtomicReferenceReader *reader = atomic_load(&JRPCAtomicReferenceReaders); reader; reader = reader->next) {
+        uint64_t epoch = atomic_load(&reader->epoch);
+        if (0 != epoch && epoch < oldestEpoch) {
+            oldestEpoch = epoch;
+        }
+    }
+    NSUInteger keptCount = 0;
+    for (NSUInteger i = 0; i < reference->retiredCount; ++i) {
+        if (reference->retired[i].epoch < oldestEpoch) {
+            CFRelease(reference->retired[i].value);
+        }
+        else {
+            reference->retired[keptCount++] = reference->retired[i];
+        }
+    }
+    reference->retiredCount = keptCount;
+}
+
+void JRPCAtomicReferenceInit(JRPCAtomicReference *reference) {
+    atomic_init(&reference->value, NULL);
+    pthread_mutex_init(&reference->lock, NULL);
+    reference->retired = NULL;
+    reference->retiredCount = 0;
+    reference->retiredCapacity = 0;
+}
+
+void JRPCAtomicReferenceDestroy(JRPCAtomicReference *reference) {
+    void *value = atomic_exchange_explicit(&reference->value, NULL, memory_order_acquire);
+    if (value) {
+        CFRelease(value);
+    }
+    // Nothing reads a reference being destroyed
+    for (NSUInteger i = 0; i < reference->retiredCount; ++i) {
+        CFRelease(reference->retired[i].value);
+    }
+    free(reference->retired);
+    reference->retired = NULL;
+    reference->retiredCount = 0;
+    pthread_mutex_destroy(&reference->lock);
+}
+
+id JRPCAtomicReferenceLoad(JRPCAtomicReference *reference) {
+    JRPCAtomicReferenceReader *reader = JRPCAtomicReferenceCurrentReader ? : JRPCAtomicReferenceRegisterReader();
+    // Sequentially consistent, so either a replacement sees this read going on, or this read sees the replacement
+    atomic_store(&reader->epoch, atomic_load_explicit(&JRPCAtomicReferenceEpoch, memory_order_relaxed));
+    void *value = atomic_load(&reference->value);
+    // Retained before the read ends, after which the object may be released if it has been replaced
+    if (value) {
+        CFRetain(value);
+    }
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+    return CFBridgingRelease(value);
+}
+
+void JRPCAtomicReferenceStore(JRPCAtomicReference *reference, id value) {
+    pthread_mutex_lock(&reference->lock);
+    if ((__bridge void *)value == atomic_load(&reference->value)) {
+        pthread_mutex_unlock(&reference->lock);
+        return;
+    }
+    void *previousValue = atomic_exchange(&reference->value, (void *)CFBridgingRetain(value));
+    if (previousValue) {
+        // Kept until the readers that may have just read it are done with it
+        if (reference->retiredCount == reference->retiredCapacity) {
+            reference->retiredCapacity = MAX(reference->retiredCapacity * 2, (NSUInteger)4);
+            reference->retired = reallocf(reference->retired, reference->retiredCapacity * sizeof(JRPCAtomicReferenceRetired));
+            if (!reference->retired) {
+                [NSException raise:NSMallocException format:@"Unable to allocate the objects replaced in an atomic reference"];
+            }
+        }
+        reference->retired[reference->retiredCount++] = (JRPCAtomicReferenceRetired){ previousValue, atomic_fetch_add(&JRPCAtomicReferenceEpoch, 1) };
+    }
+    JRPCAtomicReferenceReclaim(reference);
+    pthread_mutex_unlock(&reference->lock);
+}
+
+id JRPCAtomicReferenceStoreIfNil(JRPCAtomicReference *reference, id value) {
+    void *expected = NULL;
+    void *retainedValue = (void *)CFBridgingRetain(value);
+    if (atomic_compare_exchange_strong_explicit(&reference->value, &expected, retainedValue, memory_order_acq_rel, memory_order_acquire)) {
+        return value;
+    }
+    // Another thread got there first
+    CFRelease(retainedValue);
+    return (__bridge id)expected;
+}
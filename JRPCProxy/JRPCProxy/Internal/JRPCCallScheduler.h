@@ -0,0 +1,79 @@
+//
+//  JRPCCallScheduler.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCScheduling.h"
+#import "JRPCPendingRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCCallScheduler limits the number of requests a proxy has in flight at once, holding the rest in a queue per JRPCCallPriority
+ Whenever a slot is free the oldest request of the highest priority waiting is sent. The limit adapts to the latency of responses in AIMD fashion:
+ it grows by one for each limit's worth of responses that arrive within twice the lowest latency recently seen, and shrinks by a quarter
+ (at most once per round trip) when latency rises beyond that or a request times out. It never exceeds maxConcurrentCalls. All methods are thread safe
+ */
+@interface JRPCCallScheduler : NSObject
+
+/**
+ Initializes a scheduler
+ @param sendBlock Called with each request as it is let through, on the thread that scheduled or completed a request. Never called with the lock held
+ @return An initialized scheduler
+ */
+- (instancetype) initWithSendBlock:(void (^)(JRPCPendingRequest *request))sendBlock NS_DESIGNATED_INITIALIZER;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+/** The most requests in flight at once, or 0 (the default) for no limit. Raising it sends waiting requests straight away. Read without a lock */
+@property (atomic, assign) NSUInteger maxConcurrentCalls;
+
+/** If YES (the default), the limit adapts to latency below maxConcurrentCalls. Otherwise it is always maxConcurrentCalls */
+@property (atomic, assign) BOOL adaptsConcurrencyLimit;
+
+/**
+ Sends a request if a slot is free, otherwise queues it
+ @param request The request, which is marked scheduled
+ @param priority The queue the request waits in
+ */
+- (void) scheduleRequest:(JRPCPendingRequest*)request priority:(JRPCCallPriority)priority;
+
+/**
+ Frees the slot of a request once it completes, sending the next request waiting. A request completed while waiting is dropped from its queue
+ @param request A completed request that was scheduled
+ @param timedOut YES if the request timed out, which counts as a sign of congestion
+ */
+- (void) completeRequest:(JRPCPendingRequest*)request timedOut:(BOOL)timedOut;
+
+/** The scheduler statistics */
+@property (nonatomic, readonly) JRPCSchedulerStatistics statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
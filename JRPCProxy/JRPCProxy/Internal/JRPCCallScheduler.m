@@ -0,0 +1,233 @@
+//
+//  JRPCCallScheduler.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCCallScheduler.h"
+#import <pthread.h>
+#import <stdatomic.h>
+
+// The limit shrinks by this factor on congestion
+static const double kJRPCSchedulerDecreaseFactor = 0.75;
+// Latency beyond this multiple of the lowest latency seen is congestion
+static const double kJRPCSchedulerLatencyTolerance = 2.0;
+// Weight of each new sample in the smoothed latency
+static const double kJRPCSchedulerSmoothing = 0.2;
+// The lowest latency is re-measured over each window of this many samples, so it follows a network that has become slower
+static const NSUInteger kJRPCSchedulerBaselineWindow = 100;
+
+@interface JRPCCallScheduler() {
+    // A copy of _maxConcurrentCalls, read without the lock by the proxy on every call to find out if there is a limit at all
+    _Atomic(NSUInteger) _publishedMaxConcurrentCalls;
+    // Guards everything below
+    pthread_mutex_t _lock;
+    NSUInteger _maxConcurrentCalls;
+    // The adaptive limit, fractional so it can grow by less than one per response
+    double _limit;
+    NSUInteger _inFlightCount;
+    NSTimeInterval _minLatency;
+    NSTimeInterval _windowMinLatency;
+    NSUInteger _windowSampleCount;
+    NSTimeInterval _smoothedLatency;
+    NSTimeInterval _lastDecreaseTime;
+    JRPCSchedulerLaneStatistics _lanes[JRPC_CALL_PRIORITY_COUNT];
+}
+@property (nonatomic, copy) void (^sendBlock)(JRPCPendingRequest *request);
+// The requests waiting in each lane, oldest first. May include requests completed while waiting, which are skipped
+@property (nonatomic, strong) NSArray<NSMutableArray<JRPCPendingRequest*>*> *queues;
+@end
+
+@implementation JRPCCallScheduler
+
+- (instancetype) initWithSendBlock:(void (^)(JRPCPendingRequest *request))sendBlock {
+    self = [super init];
+    if (self) {
+        atomic_init(&_publishedMaxConcurrentCalls, 0);
+        pthread_mutex_init(&_lock, NULL);
+        self.sendBlock = sendBlock;
+        NSMutableArray *queues = [[NSMutableArray alloc] initWithCapacity:JRPC_CALL_PRIORITY_COUNT];
+        for (NSUInteger i = 0; i < JRPC_CALL_PRIORITY_COUNT; ++i) {
+            [queues addObject:[[NSMutableArray alloc] init]];
+        }
+        self.queues = [queues copy];
+        _adaptsConcurrencyLimit = YES;
+        _minLatency = DBL_MAX;
+        _windowMinLatency = DBL_MAX;
+    }
+    return self;
+}
+
+- (void) dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (NSUInteger) maxConcurrentCalls {
+    return atomic_load_explicit(&_publishedMaxConcurrentCalls, memory_order_acquire);
+}
+
+- (void) setMaxConcurrentCalls:(NSUInteger)maxConcurrentCalls {
+    pthread_mutex_lock(&_lock);
+    // Start optimistic, at the cap
+    if (0 == _maxConcurrentCalls || _limit > maxConcurrentCalls) {
+        _limit = maxConcurrentCalls;
+    }
+    _maxConcurrentCalls = maxConcurrentCalls;
+    atomic_store_explicit(&_publishedMaxConcurrentCalls, maxConcurrentCalls, memory_order_release);
+    NSArray<JRPCPendingRequest*> *admitted = [self admitRequests];
+    pthread_mutex_unlock(&_lock);
+    [self sendRequests:admitted];
+}
+
+- (JRPCSchedulerStatistics) statistics {
+    JRPCSchedulerStatistics statistics;
+    pthread_mutex_lock(&_lock);
+    statistics.concurrencyLimit = [self concurrencyLimit];
+    statistics.inFlightCount = _inFlightCount;
+    memcpy(statistics.lanes, _lanes, sizeof(_lanes));
+    pthread_mutex_unlock(&_lock);
+    return statistics;
+}
+
+- (void) scheduleRequest:(JRPCPendingRequest*)request priority:(JRPCCallPriority)priority {
+    NSUInteger lane = MIN((NSUInteger)MAX(priority, 0), JRPC_CALL_PRIORITY_COUNT - 1);
+    pthread_mutex_lock(&_lock);
+    // Marked with the lock held, so a completion racing this waits until the request is in its queue, and then takes it out
+    request.scheduled = YES;
+    request.scheduledTime = [NSProcessInfo processInfo].systemUptime;
+    request.priority = (JRPCCallPriority)lane;
+    [self.queues[lane] addObject:request];
+    _lanes[lane].queueDepth++;
+    NSArray<JRPCPendingRequest*> *admitted = [self admitRequests];
+    pthread_mutex_unlock(&_lock);
+    [self sendRequests:admitted];
+}
+
+- (void) completeRequest:(JRPCPendingRequest*)request timedOut:(BOOL)timedOut {
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    pthread_mutex_lock(&_lock);
+    if (request.sentTime > 0) {
+        _inFlightCount--;
+        if (timedOut) {
+            [self decreaseLimitAtTime:now];
+        }
+        else {
+            [self addLatencySample:now - request.sentTime atTime:now];
+        }
+        request.sentTime = 0;
+    }
+    else if (request.scheduledTime > 0) {
+        // Completed while waiting, so it is skipped when it reaches the front of its queue
+        _lanes[request.priority].queueDepth--;
+        request.scheduledTime = 0;
+    }
+    NSArray<JRPCPendingRequest*> *admitted = [self admitRequests];
+    pthread_mutex_unlock(&_lock);
+    [self sendRequests:admitted];
+}
+
+#pragma mark - Private (called with _lock held, except sendRequests:)
+
+- (NSUInteger) concurrencyLimit {
+    if (0 == _maxConcurrentCalls) {
+        return NSUIntegerMax;
+    }
+    return self.adaptsConcurrencyLimit ? MAX((NSUInteger)_limit, 1) : _maxConcurrentCalls;
+}
+
+- (NSArray<JRPCPendingRequest*>*) admitRequests {
+    NSMutableArray<JRPCPendingRequest*> *admitted = nil;
+    NSUInteger limit = [self concurrencyLimit];
+    NSTimeInterval now = 0;
+    while (_inFlightCount < limit) {
+        JRPCPendingRequest *request = nil;
+        for (NSUInteger lane = 0; lane < JRPC_CALL_PRIORITY_COUNT && !request; ++lane) {
+            NSMutableArray<JRPCPendingRequest*> *queue = self.queues[lane];
+            while (queue.count > 0 && !request) {
+                JRPCPendingRequest *next = queue.firstObject;
+                [queue removeObjectAtIndex:0];
+                // A request completed while waiting is dropped. Its queue depth is accounted for by completeRequest:timedOut:, which may still be to come
+                if (next.scheduledTime > 0 && !next.isCompleted) {
+                    request = next;
+                }
+            }
+        }
+        if (!request) {
+            break;
+        }
+        if (0 == now) {
+            now = [NSProcessInfo processInfo].systemUptime;
+        }
+        JRPCSchedulerLaneStatistics *laneStatistics = &_lanes[request.priority];
+        NSTimeInterval waitTime = now - request.scheduledTime;
+        laneStatistics->queueDepth--;
+        laneStatistics->sentCount++;
+        laneStatistics->totalWaitTime += waitTime;
+        laneStatistics->maxWaitTime = MAX(laneStatistics->maxWaitTime, waitTime);
+        request.sentTime = now;
+        _inFlightCount++;
+        if (!admitted) {
+            admitted = [[NSMutableArray alloc] init];
+        }
+        [admitted addObject:request];
+    }
+    return admitted;
+}
+
+- (void) sendRequests:(NSArray<JRPCPendingRequest*>*)requests {
+    for (JRPCPendingRequest *request in requests) {
+        self.sendBlock(request);
+    }
+}
+
+- (void) addLatencySample:(NSTimeInterval)latency atTime:(NSTimeInterval)now {
+    _windowMinLatency = MIN(_windowMinLatency, latency);
+    if (++_windowSampleCount >= kJRPCSchedulerBaselineWindow) {
+        _minLatency = _windowMinLatency;
+        _windowMinLatency = DBL_MAX;
+        _windowSampleCount = 0;
+    }
+    _minLatency = MIN(_minLatency, latency);
+    _smoothedLatency = (0 == _smoothedLatency) ? latency : (1.0 - kJRPCSchedulerSmoothing) * _smoothedLatency + kJRPCSchedulerSmoothing * latency;
+    if (_smoothedLatency > _minLatency * kJRPCSchedulerLatencyTolerance) {
+        [self decreaseLimitAtTime:now];
+    }
+    else if (_maxConcurrentCalls > 0) {
+        // Additive increase, of about one per limit's worth of responses
+        _limit = MIN(_limit + 1.0 / MAX(_limit, 1.0), (double)_maxConcurrentCalls);
+    }
+}
+
+- (void) decreaseLimitAtTime:(NSTimeInterval)now {
+    // Responses to requests sent before the last decrease still reflect the old limit, so wait a round trip before decreasing again
+    if (now - _lastDecreaseTime < _smoothedLatency) {
+        return;
+    }
+    _limit = MAX(_limit * kJRPCSchedulerDecreaseFactor, 1.0);
+    _lastDecreaseTime = now;
+}
+
+@end
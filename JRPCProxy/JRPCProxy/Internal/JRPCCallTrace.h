@@ -0,0 +1,149 @@
+//
+//  JRPCCallTrace.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCTracer.h"
+#import "JRPCMetricsRecorder.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The kind of a span, with the values of OTLP's SpanKind */
+typedef NS_ENUM(uint8_t, JRPCSpanKind) {
+    /** A phase of a call */
+    JRPCSpanKindInternal = 1,
+    /** A request handled by a dispatcher */
+    JRPCSpanKindServer = 2,
+    /** A call made through a proxy */
+    JRPCSpanKindClient = 3
+};
+
+/** A span, as written to a JRPCTracer */
+typedef struct JRPCSpan {
+    /** The name, of which the first JRPC_SPAN_NAME_LENGTH - 1 bytes are kept */
+    const char *name;
+    JRPCSpanKind kind;
+    /** The 128 bit trace id */
+    uint64_t traceIdHigh;
+    uint64_t traceIdLow;
+    uint64_t spanId;
+    /** 0 for the root span of a trace */
+    uint64_t parentSpanId;
+    /** From JRPCHistogramNow() */
+    uint64_t startTime;
+    uint64_t endTime;
+    /** The spans of a call share a track, which is a thread of the Chrome trace */
+    uint32_t track;
+    /** YES if the call completed with an error, with the code of the error */
+    BOOL failed;
+    NSInteger errorCode;
+} JRPCSpan;
+
+/** The size of the name kept by each span, including the terminating NUL */
+#define JRPC_SPAN_NAME_LENGTH 64
+
+@interface JRPCTracer()
+
+/**
+ Decides whether to trace a call
+ @param sampleRate The sample rate of the method called, or negative to use the tracer's sampleRate
+ @return YES if the call is traced
+ */
+- (BOOL) sampleWithRate:(double)sampleRate;
+
+/** Returns a new random, non-zero span or trace id */
+- (uint64_t) newIdentifier;
+
+/** Returns a new track, for the spans of one call */
+- (uint32_t) newTrack;
+
+/** Writes a span to the ring buffer, overwriting the oldest if it is full */
+- (void) recordSpan:(const JRPCSpan*)span;
+
+@end
+
+/**
+ JRPCCallTrace is the trace of one sampled call: its root span, which is written when the call completes, and the child spans of its phases.
+ The proxy passes a nil trace for calls that are not sampled, so that every message below is a no-op
+ */
+@interface JRPCCallTrace : NSObject
+
+/**
+ Starts the trace of a call made through a proxy, if it is sampled
+ @param tracer The proxy's tracer
+ @param descriptor The descriptor of the method called, whose traceSampleRate is used
+ @return A trace starting now, or nil if the call is not sampled
+ */
++ (nullable instancetype) traceWithTracer:(JRPCTracer*)tracer descriptor:(JRPCMethodDescriptor*)descriptor;
+
+/**
+ Starts the trace of a request handled by a dispatcher, joining the trace of the call that sent it
+ @param tracer The dispatcher's tracer
+ @param traceContext The request's JRPCTraceContextKey member
+ @param methodName The JSON-RPC method name
+ @return A trace starting now, or nil if the request has no valid trace context or its call was not sampled
+ */
++ (nullable instancetype) traceWithTracer:(JRPCTracer*)tracer traceContext:(nullable id)traceContext methodName:(NSString*)methodName;
+
+/** When the call was made, from JRPCHistogramNow() */
+@property (nonatomic, readonly) uint64_t startTime;
+
+/** The W3C traceparent of the call's span, sent as the request's JRPCTraceContextKey member */
+@property (nonatomic, readonly) NSString *traceContext;
+
+/**
+ Writes the child span of a phase of the call, ending now
+ @param phase The phase
+ @param startTime When the phase started, from JRPCHistogramNow()
+ */
+- (void) recordPhase:(JRPCMetricsPhase)phase sinceTime:(uint64_t)startTime;
+
+/**
+ Writes the call's span, ending now. Called once, just before its completion block
+ @param error The error the call completed with, or nil
+ */
+- (void) finishWithError:(nullable NSError*)error;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/** Returns the start time of a phase to record in metrics and/or a trace, or 0 without calling the clock if both are nil */
+NS_INLINE uint64_t JRPCPhaseStartTime(JRPCMetricsRecorder * _Nullable metrics, JRPCCallTrace * _Nullable trace) {
+    return (metrics || trace) ? JRPCHistogramNow() : 0;
+}
+
+/** Records a phase of a call in metrics and its trace, either of which may be nil */
+NS_INLINE void JRPCRecordPhase(JRPCMetricsRecorder * _Nullable metrics, JRPCCallTrace * _Nullable trace, JRPCMetricsPhase phase, uint64_t startTime) {
+    [metrics recordPhase:phase sinceTime:startTime];
+    [trace recordPhase:phase sinceTime:startTime];
+}
+
+NS_ASSUME_NONNULL_END
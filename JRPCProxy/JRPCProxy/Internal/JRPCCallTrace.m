@@ -0,0 +1,171 @@
+//
+//  JRPCCallTrace.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCCallTrace.h"
+
+// The span names of each JRPCMetricsPhase
+static const char * const kJRPCPhaseSpanNames[JRPC_METRICS_PHASE_COUNT] = {
+    "marshalling",
+    "serialization",
+    "transport",
+    "deserialization",
+    "completion queue"
+};
+
+// The length of a version 00 traceparent: 00-<trace id>-<parent id>-<flags>
+#define JRPC_TRACE_CONTEXT_LENGTH 55
+
+@interface JRPCCallTrace()
+@property (nonatomic, strong) JRPCTracer *tracer;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) JRPCSpanKind kind;
+@property (nonatomic, assign) uint64_t traceIdHigh;
+@property (nonatomic, assign) uint64_t traceIdLow;
+@property (nonatomic, assign) uint64_t spanId;
+@property (nonatomic, assign) uint64_t parentSpanId;
+@property (nonatomic, assign) uint32_t track;
+@property (nonatomic, assign) uint64_t startTime;
+@end
+
+static BOOL JRPCParseHex(const char *digits, int count, uint64_t *value) {
+    uint64_t result = 0;
+    for (int i = 0; i < count; ++i) {
+        char c = digits[i];
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint64_t)(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f') {
+            digit = (uint64_t)(c - 'a' + 10);
+        }
+        else {
+            // Only lowercase hex is valid in a traceparent
+            return NO;
+        }
+        result = (result << 4) | digit;
+    }
+    *value = result;
+    return YES;
+}
+
+static BOOL JRPCParseHexByte(const char *digits, uint8_t *value) {
+    uint64_t result = 0;
+    if (!JRPCParseHex(digits, 2, &result)) {
+        return NO;
+    }
+    *value = (uint8_t)result;
+    return YES;
+}
+
+@implementation JRPCCallTrace
+
++ (instancetype) traceWithTracer:(JRPCTracer*)tracer descriptor:(JRPCMethodDescriptor*)descriptor {
+    if (![tracer sampleWithRate:descriptor.traceSampleRate]) {
+        return nil;
+    }
+    JRPCCallTrace *trace = [[self alloc] initWithTracer:tracer name:descriptor.methodName kind:JRPCSpanKindClient];
+    trace.traceIdHigh = [tracer newIdentifier];
+    trace.traceIdLow = [tracer newIdentifier];
+    return trace;
+}
+
++ (instancetype) traceWithTracer:(JRPCTracer*)tracer traceContext:(id)traceContext methodName:(NSString*)methodName {
+    if (![traceContext isKindOfClass:[NSString class]] || JRPC_TRACE_CONTEXT_LENGTH != [traceContext length]) {
+        return nil;
+    }
+    char context[JRPC_TRACE_CONTEXT_LENGTH + 1];
+    if (![traceContext getCString:context maxLength:sizeof(context) encoding:NSASCIIStringEncoding]) {
+        return nil;
+    }
+    uint64_t traceIdHigh = 0, traceIdLow = 0, parentSpanId = 0;
+    uint8_t flags = 0;
+    if (!JRPCParseHex(context + 3, 16, &traceIdHigh) || !JRPCParseHex(context + 19, 16, &traceIdLow) ||
+        !JRPCParseHex(context + 36, 16, &parentSpanId) || !JRPCParseHexByte(context + 53, &flags) ||
+        '-' != context[2] || '-' != context[35] || '-' != context[52] || 0 != strncmp(context, "00", 2)) {
+        return nil;
+    }
+    // Only calls the proxy sampled are joined, and the ids must be valid
+    if (!(flags & 0x01) || (0 == traceIdHigh && 0 == traceIdLow) || 0 == parentSpanId) {
+        return nil;
+    }
+    JRPCCallTrace *trace = [[self alloc] initWithTracer:tracer name:methodName kind:JRPCSpanKindServer];
+    trace.traceIdHigh = traceIdHigh;
+    trace.traceIdLow = traceIdLow;
+    trace.parentSpanId = parentSpanId;
+    return trace;
+}
+
+- (instancetype) initWithTracer:(JRPCTracer*)tracer name:(NSString*)name kind:(JRPCSpanKind)kind {
+    self = [super init];
+    if (self) {
+        self.tracer = tracer;
+        self.name = name;
+        self.kind = kind;
+        self.spanId = [tracer newIdentifier];
+        self.track = [tracer newTrack];
+        self.startTime = JRPCHistogramNow();
+    }
+    return self;
+}
+
+- (NSString*) traceContext {
+    return [NSString stringWithFormat:@"00-%016llx%016llx-%016llx-01", self.traceIdHigh, self.traceIdLow, self.spanId];
+}
+
+- (JRPCSpan) spanWithName:(const char *)name kind:(JRPCSpanKind)kind startTime:(uint64_t)startTime {
+    JRPCSpan span = {
+        .name = name,
+        .kind = kind,
+        .traceIdHigh = self.traceIdHigh,
+        .traceIdLow = self.traceIdLow,
+        .startTime = startTime,
+        .endTime = JRPCHistogramNow(),
+        .track = self.track
+    };
+    return span;
+}
+
+- (void) recordPhase:(JRPCMetricsPhase)phase sinceTime:(uint64_t)startTime {
+    JRPCSpan span = [self spanWithName:kJRPCPhaseSpanNames[phase] kind:JRPCSpanKindInternal startTime:startTime];
+    span.spanId = [self.tracer newIdentifier];
+    span.parentSpanId = self.spanId;
+    [self.tracer recordSpan:&span];
+}
+
+- (void) finishWithError:(NSError*)error {
+    JRPCSpan span = [self spanWithName:self.name.UTF8String kind:self.kind startTime:self.startTime];
+    span.spanId = self.spanId;
+    span.parentSpanId = self.parentSpanId;
+    span.failed = (nil != error);
+    span.errorCode = error.code;
+    [self.tracer recordSpan:&span];
+}
+
+@end
@@ -0,0 +1,102 @@
+//
+//  JRPCCompletionThunk.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCResponse.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The number of elements passed in each chunk to a block streaming its result in chunks, unless set for the method */
+#define JRPC_DEFAULT_RESULT_CHUNK_SIZE 100
+
+/**
+ JRPCCompletionThunk calls the completion block of a proxied method with a JSON-RPC result, casting the block according to its signature.
+ Everything that depends on the block signature (the result type, the result class & its JRPCTransformable initializer) is resolved once when the thunk is created.
+ Block signatures are fixed per protocol method, so a thunk is created from the first block passed to a method and reused for all subsequent calls.
+ */
+@interface JRPCCompletionThunk : NSObject
+
+/**
+ Creates a thunk for calling blocks with the same signature as completionBlock
+ @param completionBlock A completion block of the form ^(<Result Type> result, NSError *error)
+ @return An initialized thunk
+ @discussion Raises NSInternalInconsistencyException if the result type is not supported
+ */
++ (instancetype) thunkForCompletionBlock:(id)completionBlock;
+
+/** The single character Objective-C runtime type encoding of the block result parameter. '@' for all objects */
+@property (nonatomic, readonly) char resultType;
+
+/** The class of the block result parameter if declared, otherwise Nil. For a block streaming its result, the class of each element or chunk */
+@property (nonatomic, readonly, nullable) Class resultClass;
+
+/**
+ YES if the block streams an array result, with the form ^(<Element Class> *element, BOOL done, NSError *error), or with an NSArray first param to be
+ passed chunks of elements. Such blocks are called with each element or chunk as it is created, then once with done YES
+ */
+@property (nonatomic, readonly) BOOL streamsResult;
+
+/**
+ Creates the object result of a response for the completion block in advance, so that invokeCompletionBlock:response:error: does not have to
+ @param response A JSON-RPC response without an error
+ */
+- (void) prepareResultOfResponse:(JRPCResponse*)response;
+
+/**
+ Calls a completion block with the result of a JSON-RPC call
+ @param completionBlock A block with the signature this thunk was created for
+ @param response The JSON-RPC response, or nil if the call failed. Primitive results are read directly from it, object results are created from it
+ and transformed to resultClass if it implements initWithJSONRPCResponseResult: (see JRPCTransformable)
+ @param error The error, or nil if the call succeeded
+ */
+- (void) invokeCompletionBlock:(id)completionBlock response:(nullable JRPCResponse*)response error:(nullable NSError*)error;
+
+/**
+ Calls a block streaming its result with the elements of a JSON-RPC array result, a chunk at a time, then once more with done YES & any error.
+ Each element or chunk is released before the next is created, so however long the result only one chunk of it is ever held as objects
+ @param completionBlock A block with the signature this thunk was created for, which must stream its result
+ @param response The JSON-RPC response, or nil if the call failed
+ @param error The error, or nil if the call succeeded. A result that is not an array, or whose elements cannot be created or are not of the class
+ the block declares, ends the stream with a JRPCErrorResponseSerializationCode error
+ @param chunkSize The number of elements in each chunk, for blocks passed chunks. Ignored for blocks passed single elements
+ @param elementClass The class to transform the elements of each chunk to (see JRPCTransformable), or Nil to pass them as they are. Ignored for blocks
+ passed single elements, whose elements are transformed to the class the block declares
+ */
+- (void) streamResultToCompletionBlock:(id)completionBlock
+                              response:(nullable JRPCResponse*)response
+                                 error:(nullable NSError*)error
+                             chunkSize:(NSUInteger)chunkSize
+                          elementClass:(nullable Class)elementClass;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
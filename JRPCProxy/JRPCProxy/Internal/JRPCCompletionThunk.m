@@ -0,0 +1,304 @@
+//
+//  JRPCCompletionThunk.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCCompletionThunk.h"
+#import "JRPCNumericArray.h"
+#import "JRPCTransformable.h"
+#import "JRPCError.h"
+#import "CTBlockDescription.h"
+#import <objc/runtime.h>
+
+/** Calls a completion block, casting it to the signature the thunk was created for */
+typedef void (*JRPCCompletionInvoker)(JRPCCompletionThunk *thunk, id block, JRPCResponse *response, NSError *error);
+
+/** The IMP of initWithJSONRPCResponseResult:, which consumes the allocated receiver and returns a retained object, like any initializer */
+typedef id (*JRPCResultInitializerIMP)(__attribute__((ns_consumed)) id self, SEL _cmd, id result) __attribute__((ns_returns_retained));
+
+@interface JRPCCompletionThunk()
+@property (nonatomic, assign) char resultType;
+@property (nonatomic, strong) Class resultClass;
+@property (nonatomic, copy) NSString *resultTypeEncoding;
+@property (nonatomic, assign) JRPCCompletionInvoker invoker;
+@property (nonatomic, assign) JRPCResultInitializerIMP resultInitializer;
+@property (nonatomic, assign) BOOL resultIsNumericArray;
+@property (nonatomic, assign) BOOL streamsResult;
+// YES if a block streaming its result is passed chunks of elements, rather than single elements
+@property (nonatomic, assign) BOOL streamsChunks;
+@end
+
+#pragma mark - Invokers
+
+// Reports a number the result type cannot hold, e.g. 1e10 or NaN for an int, which C leaves undefined to convert, as a response serialization error
+static NSError *JRPCResultRangeError(NSError *error, char resultType) {
+    return error ? : [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:@{
+        NSDebugDescriptionErrorKey : [NSString stringWithFormat:@"Result is out of the range of type %c", resultType] }];
+}
+
+// Primitive results are read straight from the response data when possible, otherwise unboxed from NSNumber. A number out of range is passed as 0
+#define JRPC_NUMBER_INVOKER(name, type, accessor) \
+static void JRPCInvoke##name(JRPCCompletionThunk *thunk, id block, JRPCResponse *response, NSError *error) { \
+    type value = 0; \
+    JRPCJSONScalar scalar; \
+    if ([response getResultScalar:&scalar]) { \
+        if (JRPCJSONScalarFitsType(scalar, @encode(type)[0])) { \
+            value = JRPC_JSON_SCALAR_VALUE(type, scalar); \
+        } \
+        else { \
+            error = JRPCResultRangeError(error, @encode(type)[0]); \
+        } \
+    } \
+    else { \
+        id result = [response resultWithError:NULL]; \
+        if (![result isKindOfClass:[NSNumber class]] || JRPCJSONNumberFitsType(result, @encode(type)[0])) { \
+            value = [(NSNumber*)result accessor]; \
+        } \
+        else { \
+            error = JRPCResultRangeError(error, @encode(type)[0]); \
+        } \
+    } \
+    ((void (^)(type, NSError*))block)(value, error); \
+}
+
+JRPC_NUMBER_INVOKER(Bool, _Bool, boolValue)
+JRPC_NUMBER_INVOKER(Char, char, charValue)
+JRPC_NUMBER_INVOKER(Int, int, intValue)
+JRPC_NUMBER_INVOKER(Short, short, shortValue)
+JRPC_NUMBER_INVOKER(Long, long, longValue)
+JRPC_NUMBER_INVOKER(LongLong, long long, longLongValue)
+JRPC_NUMBER_INVOKER(UnsignedChar, unsigned char, unsignedCharValue)
+JRPC_NUMBER_INVOKER(UnsignedInt, unsigned int, unsignedIntValue)
+JRPC_NUMBER_INVOKER(UnsignedShort, unsigned short, unsignedShortValue)
+JRPC_NUMBER_INVOKER(UnsignedLong, unsigned long, unsignedLongValue)
+JRPC_NUMBER_INVOKER(UnsignedLongLong, unsigned long long, unsignedLongLongValue)
+JRPC_NUMBER_INVOKER(Float, float, floatValue)
+JRPC_NUMBER_INVOKER(Double, double, doubleValue)
+
+// Creates the result object, reporting a result that cannot be parsed as a response serialization error
+static id JRPCResultForResponse(JRPCResponse *response, NSError **error) {
+    NSError *parseError = nil;
+    id result = [response resultWithError:&parseError];
+    if (parseError && !*error) {
+        *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:@{ NSUnderlyingErrorKey : parseError }];
+    }
+    return result;
+}
+
+// Untyped objects (id) are passed directly
+static void JRPCInvokeObject(JRPCCompletionThunk *thunk, id block, JRPCResponse *response, NSError *error) {
+    id result = JRPCResultForResponse(response, &error);
+    ((void (^)(id, NSError*))block)(result, error);
+}
+
+// Typed objects are transformed to the result class if required, and must be of that class
+static void JRPCInvokeTypedObject(JRPCCompletionThunk *thunk, id block, JRPCResponse *response, NSError *error) {
+    Class resultClass = thunk.resultClass;
+    // Numeric arrays are read straight from the response data when possible, otherwise transformed from an NSArray like any other result
+    id result = thunk.resultIsNumericArray ? [response resultAsNumericArrayOfClass:resultClass] : nil;
+    if (!result) {
+        result = JRPCResultForResponse(response, &error);
+    }
+    if (result && resultClass && ![result isKindOfClass:resultClass]) {
+        // Process optional transformation of result if an alternative initializer has been supplied
+        JRPCResultInitializerIMP resultInitializer = thunk.resultInitializer;
+        if (resultInitializer) {
+            id newResult = resultInitializer([resultClass alloc], @selector(initWithJSONRPCResponseResult:), result);
+            // Override JSON-RPC result object with transformed result if available
+            result = newResult ? : result;
+        }
+    }
+    if (!result || (resultClass && [result isKindOfClass:resultClass])) {
+        // param type matches result type, so call completion directly
+        ((void (^)(id, NSError*))block)(result, error);
+    }
+    else {
+        [NSException raise:NSInternalInconsistencyException format:@"Unable to call completion block due to unsupported result type %@", thunk.resultTypeEncoding];
+    }
+}
+
+// Streaming blocks are passed the default chunk size, with elements as they are, unless the method sets them
+static void JRPCInvokeStreamingResult(JRPCCompletionThunk *thunk, id block, JRPCResponse *response, NSError *error) {
+    [thunk streamResultToCompletionBlock:block response:response error:error chunkSize:JRPC_DEFAULT_RESULT_CHUNK_SIZE elementClass:Nil];
+}
+
+// Returns an element of a streamed result as an instance of cls, transforming it if required, or nil if it is neither of that class nor can be created from it
+static id JRPCStreamedElement(id element, Class cls, JRPCResultInitializerIMP initializer) {
+    if (!cls || [element isKindOfClass:cls]) {
+        return element;
+    }
+    id transformed = initializer ? initializer([cls alloc], @selector(initWithJSONRPCResponseResult:), element) : nil;
+    return [transformed isKindOfClass:cls] ? transformed : nil;
+}
+
+// YES for the type encoding of BOOL, which is _Bool on some platforms and signed char on others
+static BOOL JRPCIsBoolTypeEncoding(const char *typeEncoding) {
+    return 0 == strcmp(typeEncoding, "B") || 0 == strcmp(typeEncoding, "c");
+}
+
+@implementation JRPCCompletionThunk
+
++ (instancetype) thunkForCompletionBlock:(id)completionBlock {
+    return [[self alloc] initWithCompletionBlock:completionBlock];
+}
+
+- (instancetype) initWithCompletionBlock:(id)completionBlock {
+    self = [super init];
+    if (self) {
+        CTBlockDescription *blockDesc = [[CTBlockDescription alloc] initWithBlock:completionBlock];
+        NSMethodSignature *blockSig = blockDesc.blockSignature;
+        // The block params start at index 1 (0 = self), and we know 2 should be @"NSError" by convention
+        // Note: for block signatures, we don't just get '@' for object params, we get an objc string literal, e.g. '@"NSString"' / '@"NSError"'
+        // However, primitives DO follow standard objc type encodings:
+        // See https://developer.apple.com/library/mac/documentation/Cocoa/Conceptual/ObjCRuntimeGuide/Articles/ocrtTypeEncodings.html
+        const char *resultTypeEncodingStr = [blockSig getArgumentTypeAtIndex:1];
+        self.resultTypeEncoding = [NSString stringWithUTF8String:resultTypeEncodingStr];
+        self.resultType = resultTypeEncodingStr[0];
+        if (4 == blockSig.numberOfArguments && JRPCIsBoolTypeEncoding([blockSig getArgumentTypeAtIndex:2])) {
+            // ^(element, BOOL done, NSError *error) streams an array result, an element or chunk of them at a time
+            if ('@' != resultTypeEncodingStr[0]) {
+                [NSException raise:NSInternalInconsistencyException format:@"Unsupported completion type encoding for streamed element: %s", resultTypeEncodingStr];
+            }
+            NSString *classStr = [self.resultTypeEncoding stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"@\""]];
+            Class resultClass = classStr.length ? NSClassFromString(classStr) : Nil;
+            self.resultClass = resultClass;
+            self.streamsResult = YES;
+            self.streamsChunks = [resultClass isSubclassOfClass:[NSArray class]];
+            SEL jsonObjectInitializer = @selector(initWithJSONRPCResponseResult:);
+            if (resultClass && !self.streamsChunks && class_respondsToSelector(resultClass, jsonObjectInitializer)) {
+                self.resultInitializer = (JRPCResultInitializerIMP)class_getMethodImplementation(resultClass, jsonObjectInitializer);
+            }
+            self.invoker = JRPCInvokeStreamingResult;
+        }
+        else if (1 == strlen(resultTypeEncodingStr)) {
+            switch (resultTypeEncodingStr[0]) {
+                case 'B': self.invoker = JRPCInvokeBool; break;                 // _Bool
+                case 'c': self.invoker = JRPCInvokeChar; break;                 // char
+                case 'i': self.invoker = JRPCInvokeInt; break;                  // int
+                case 's': self.invoker = JRPCInvokeShort; break;                // short
+                case 'l': self.invoker = JRPCInvokeLong; break;                 // long
+                case 'q': self.invoker = JRPCInvokeLongLong; break;             // long long
+                case 'C': self.invoker = JRPCInvokeUnsignedChar; break;         // unsigned char
+                case 'I': self.invoker = JRPCInvokeUnsignedInt; break;          // unsigned int
+                case 'S': self.invoker = JRPCInvokeUnsignedShort; break;        // unsigned short
+                case 'L': self.invoker = JRPCInvokeUnsignedLong; break;         // unsigned long
+                case 'Q': self.invoker = JRPCInvokeUnsignedLongLong; break;     // unsigned long long
+                case 'f': self.invoker = JRPCInvokeFloat; break;                // float
+                case 'd': self.invoker = JRPCInvokeDouble; break;               // double
+                case '@': self.invoker = JRPCInvokeObject; break;               // Object
+                default:
+                    [NSException raise:NSInternalInconsistencyException format:@"Unsupported completion type encoding for result: %c", resultTypeEncodingStr[0]];
+                    break;
+            }
+        }
+        else if ('@' == resultTypeEncodingStr[0]) {
+            // Strip obj string literal syntax to get object class name
+            NSString *classStr = [self.resultTypeEncoding stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"@\""]];
+            Class resultClass = NSClassFromString(classStr);
+            self.resultClass = resultClass;
+            // Look up the optional JRPCTransformable initializer once, rather than on every response
+            SEL jsonObjectInitializer = @selector(initWithJSONRPCResponseResult:);
+            if (resultClass && class_respondsToSelector(resultClass, jsonObjectInitializer)) {
+                self.resultInitializer = (JRPCResultInitializerIMP)class_getMethodImplementation(resultClass, jsonObjectInitializer);
+            }
+            self.resultIsNumericArray = [resultClass isSubclassOfClass:[JRPCNumericArray class]] && resultClass != [JRPCNumericArray class];
+            self.invoker = JRPCInvokeTypedObject;
+        }
+        else {
+            [NSException raise:NSInternalInconsistencyException format:@"Unsupported completion type encoding for result: %s", resultTypeEncodingStr];
+        }
+    }
+    return self;
+}
+
+- (void) prepareResultOfResponse:(JRPCResponse*)response {
+    if (self.streamsResult) {
+        // Created an element at a time as the block is called instead
+        return;
+    }
+    if (self.resultIsNumericArray && [response resultAsNumericArrayOfClass:self.resultClass]) {
+        return;
+    }
+    [response resultWithError:NULL];
+}
+
+- (void) invokeCompletionBlock:(id)completionBlock response:(JRPCResponse*)response error:(NSError*)error {
+    self.invoker(self, completionBlock, response, error);
+}
+
+- (void) streamResultToCompletionBlock:(id)completionBlock
+                              response:(JRPCResponse*)response
+                                 error:(NSError*)error
+                             chunkSize:(NSUInteger)chunkSize
+                          elementClass:(Class)elementClass {
+    void (^streamBlock)(id, BOOL, NSError*) = completionBlock;
+    if (response && !error) {
+        BOOL streamsChunks = self.streamsChunks;
+        Class cls = streamsChunks ? elementClass : self.resultClass;
+        JRPCResultInitializerIMP initializer = self.resultInitializer;
+        SEL jsonObjectInitializer = @selector(initWithJSONRPCResponseResult:);
+        if (streamsChunks && elementClass && class_respondsToSelector(elementClass, jsonObjectInitializer)) {
+            initializer = (JRPCResultInitializerIMP)class_getMethodImplementation(elementClass, jsonObjectInitializer);
+        }
+        chunkSize = MAX(chunkSize, 1);
+        __block NSMutableArray *chunk = streamsChunks ? [[NSMutableArray alloc] initWithCapacity:chunkSize] : nil;
+        __block BOOL elementMismatch = NO;
+        NSError *parseError = nil;
+        BOOL parsed = [response enumerateResultElementsUsingBlock:^(id element, BOOL *stop) {
+            // Whatever transforming the element autoreleases goes before the next is transformed
+            @autoreleasepool {
+                id value = JRPCStreamedElement(element, cls, initializer);
+                if (!value) {
+                    elementMismatch = YES;
+                    *stop = YES;
+                    return;
+                }
+                if (!streamsChunks) {
+                    streamBlock(value, NO, nil);
+                    return;
+                }
+                [chunk addObject:value];
+                if (chunk.count == chunkSize) {
+                    // Handed over rather than copied, so a new array is started for the next chunk
+                    streamBlock(chunk, NO, nil);
+                    chunk = [[NSMutableArray alloc] initWithCapacity:chunkSize];
+                }
+            }
+        } error:&parseError];
+        if (!parsed || elementMismatch) {
+            NSDictionary *userInfo = parseError ? @{ NSUnderlyingErrorKey : parseError } :
+                @{ NSDebugDescriptionErrorKey : [NSString stringWithFormat:@"Result element is not of class %@", NSStringFromClass(cls)] };
+            error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:userInfo];
+        }
+        else if (chunk.count > 0) {
+            streamBlock(chunk, NO, nil);
+        }
+    }
+    streamBlock(nil, YES, error);
+}
+
+@end
@@ -0,0 +1,72 @@
+//
+//  JRPCDispatchData.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Helpers for payloads held as dispatch_data_t, which is an NSData whose bytes may be in any number of separate regions.
+ Asking one for its bytes joins the regions into a new buffer, so these work a region at a time instead
+ */
+
+/**
+ Returns data as dispatch data without copying its bytes. Dispatch data is returned as it is, anything else is wrapped in a single region that retains it
+ @param data The data to wrap
+ @return Dispatch data holding the same bytes
+ */
+FOUNDATION_EXTERN dispatch_data_t JRPCDispatchDataWithData(NSData *data);
+
+/**
+ Makes a range of some dispatch data contiguous. Free when the range lies within one region, otherwise only the range is copied
+ @param data The dispatch data
+ @param range The range of bytes wanted, which must lie within data
+ @return The bytes in range, which stay valid for the life of the returned NSData
+ */
+FOUNDATION_EXTERN NSData *JRPCDispatchDataInRange(dispatch_data_t data, NSRange range);
+
+/**
+ Copies a few bytes of some dispatch data, wherever the regions split them, e.g. a frame header
+ @param data The dispatch data
+ @param offset The offset of the first byte
+ @param bytes The buffer to copy into
+ @param length The number of bytes to copy, which must lie within data
+ */
+FOUNDATION_EXTERN void JRPCDispatchDataGetBytes(dispatch_data_t data, NSUInteger offset, void *bytes, NSUInteger length);
+
+/**
+ Finds the first occurrence of a byte in some dispatch data, searching each region in place
+ @param data The dispatch data
+ @param byte The byte to find
+ @param offset The offset to start searching from
+ @return The offset of the byte, or NSNotFound if it does not occur at or after offset
+ */
+FOUNDATION_EXTERN NSUInteger JRPCDispatchDataIndexOfByte(dispatch_data_t data, uint8_t byte, NSUInteger offset);
+
+NS_ASSUME_NONNULL_END
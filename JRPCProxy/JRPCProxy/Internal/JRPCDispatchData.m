@@ -0,0 +1,95 @@
+//
+//  JRPCDispatchData.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCDispatchData.h"
+
+// The class of dispatch data objects, which is private
+static Class JRPCDispatchDataClass(void) {
+    static Class dispatchDataClass;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dispatchDataClass = [(NSObject*)dispatch_data_create("", 1, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT) class];
+    });
+    return dispatchDataClass;
+}
+
+dispatch_data_t JRPCDispatchDataWithData(NSData *data) {
+    if ([data isKindOfClass:JRPCDispatchDataClass()]) {
+        return (dispatch_data_t)data;
+    }
+    if (0 == data.length) {
+        return dispatch_data_empty;
+    }
+    // Copying immutable data just retains it. The destructor releases it along with the region
+    NSData *immutableData = [data copy];
+    return dispatch_data_create(immutableData.bytes, immutableData.length, NULL, ^{
+        (void)immutableData;
+    });
+}
+
+NSData *JRPCDispatchDataInRange(dispatch_data_t data, NSRange range) {
+    if (0 != range.location || range.length != dispatch_data_get_size(data)) {
+        data = dispatch_data_create_subrange(data, range.location, range.length);
+    }
+    // A map of a single region returns the region itself. The map is an NSData whose bytes are the mapped bytes
+    return (NSData*)dispatch_data_create_map(data, NULL, NULL);
+}
+
+void JRPCDispatchDataGetBytes(dispatch_data_t data, NSUInteger offset, void *bytes, NSUInteger length) {
+    __block uint8_t *destination = bytes;
+    __block NSUInteger remaining = length;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t regionOffset, const void *buffer, size_t size) {
+        if (regionOffset + size <= offset) {
+            return true;
+        }
+        NSUInteger start = (offset > regionOffset) ? offset - regionOffset : 0;
+        NSUInteger count = MIN(size - start, remaining);
+        memcpy(destination, (const uint8_t*)buffer + start, count);
+        destination += count;
+        remaining -= count;
+        return remaining > 0;
+    });
+}
+
+NSUInteger JRPCDispatchDataIndexOfByte(dispatch_data_t data, uint8_t byte, NSUInteger offset) {
+    __block NSUInteger index = NSNotFound;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t regionOffset, const void *buffer, size_t size) {
+        if (regionOffset + size <= offset) {
+            return true;
+        }
+        NSUInteger start = (offset > regionOffset) ? offset - regionOffset : 0;
+        const uint8_t *found = memchr((const uint8_t*)buffer + start, byte, size - start);
+        if (found) {
+            index = regionOffset + (NSUInteger)(found - (const uint8_t*)buffer);
+            return false;
+        }
+        return true;
+    });
+    return index;
+}
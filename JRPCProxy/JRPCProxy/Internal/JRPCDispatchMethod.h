@@ -0,0 +1,77 @@
+//
+//  JRPCDispatchMethod.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCMethodDescriptor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Called with the result or error of a dispatched method. Primitive results are boxed in NSNumber, and object results passed as they are */
+typedef void (^JRPCDispatchReply)(id _Nullable result, NSError * _Nullable error);
+
+/**
+ JRPCDispatchMethod holds everything JRPCDispatcher needs to call a protocol method for a JSON-RPC request: the method descriptor, shared with
+ the client side, for the naming convention & argument plans, and the declared param & result types, which the public runtime does not record
+ for methods and which are read from a signature block instead (see JRPCDispatchTarget). Built once per method when the dispatcher is initialized,
+ then immutable
+ */
+@interface JRPCDispatchMethod : NSObject
+
+/**
+ Creates a dispatch method for a method of a protocol
+ @param methodDesc The protocol method description as returned by the Objective-C runtime
+ @param signatureBlock A block taking the method's params (see JRPCDispatchTarget), or nil to pass object params as they are and take object results
+ @param paramStructure The parameter structure of the JSON-RPC service
+ @return An initialized dispatch method
+ @discussion Raises NSInvalidArgumentException if the method does not follow the conventions described in JRPCAbstractProxy.h, uses unsupported
+ types, or does not take the params of signatureBlock
+ */
++ (instancetype) methodWithMethodDescription:(struct objc_method_description)methodDesc
+                              signatureBlock:(nullable id)signatureBlock
+                              paramStructure:(JRPCParameterStructure)paramStructure;
+
+/** The descriptor of the method */
+@property (nonatomic, readonly) JRPCMethodDescriptor *descriptor;
+
+/**
+ Creates an invocation of the method with arguments unmarshalled from JSON-RPC params. Its arguments are retained, so it may be invoked later on another queue
+ @param target The object implementing the method
+ @param params The JSON-RPC params: an array BY-POSITION, an object BY-NAME, or nil if absent
+ @param reply Called with the result when the implementation calls the completion block. Ignored for methods without a completion block
+ @return The invocation, or nil if the params do not match the method's params
+ */
+- (nullable NSInvocation*) invocationWithTarget:(id)target params:(nullable id)params reply:(JRPCDispatchReply)reply;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
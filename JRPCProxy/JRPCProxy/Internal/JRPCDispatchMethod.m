@@ -0,0 +1,270 @@
+//
+//  JRPCDispatchMethod.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCDispatchMethod.h"
+#import "JRPCTransformable.h"
+#import "CTBlockDescription.h"
+#import <objc/runtime.h>
+
+/** The declared class of an object param, and whether it can be created from a JSON value (see JRPCTransformable) */
+typedef struct JRPCDispatchParamType {
+    __unsafe_unretained Class cls;      // Classes are never deallocated
+    BOOL transformable;
+} JRPCDispatchParamType;
+
+@interface JRPCDispatchMethod()
+@property (nonatomic, strong) JRPCMethodDescriptor *descriptor;
+// The single character type encoding of the completion block result, '@' for objects
+@property (nonatomic, assign) char resultType;
+// YES if the completion block streams an array result, and whether it is passed chunks of elements rather than single elements
+@property (nonatomic, assign) BOOL streamsResult;
+@property (nonatomic, assign) BOOL streamsChunks;
+// paramCount in length
+@property (nonatomic, assign) JRPCDispatchParamType *paramTypes;
+@end
+
+// Returns the class named by an extended object type encoding, e.g. @"NSString", or Nil for id and anything else
+static Class JRPCClassForExtendedTypeEncoding(const char *typeEncoding) {
+    if (0 != strncmp(typeEncoding, "@\"", 2)) {
+        return Nil;
+    }
+    // Any protocols follow the class name, e.g. @"NSObject<NSCopying>", and id<Protocol> has no class name
+    const char *name = typeEncoding + 2;
+    size_t length = strcspn(name, "\"<");
+    if (0 == length) {
+        return Nil;
+    }
+    char className[256];
+    if (length >= sizeof(className)) {
+        return Nil;
+    }
+    memcpy(className, name, length);
+    className[length] = '\0';
+    return objc_getClass(className);
+}
+
+// Returns the block signature from an extended block type encoding, e.g. v@?q@"NSError" from @?<v@?q@"NSError">, or nil if it is not recorded
+static NSMethodSignature *JRPCBlockSignatureForExtendedTypeEncoding(const char *typeEncoding) {
+    size_t length = strlen(typeEncoding);
+    if (length < 4 || 0 != strncmp(typeEncoding, "@?<", 3) || '>' != typeEncoding[length - 1]) {
+        return nil;
+    }
+    NSString *blockTypes = [[NSString alloc] initWithBytes:typeEncoding + 3 length:length - 4 encoding:NSUTF8StringEncoding];
+    return [NSMethodSignature signatureWithObjCTypes:blockTypes.UTF8String];
+}
+
+// YES if a signature block's params have the types of a method's, after self & _cmd. Only the first character is compared, since the block's
+// encoding is extended with class names & block signatures and the method's is not
+static BOOL JRPCSignatureMatchesMethodSignature(NSMethodSignature *blockSig, NSMethodSignature *methodSig) {
+    if (blockSig.numberOfArguments + 1 != methodSig.numberOfArguments) {
+        return NO;
+    }
+    for (NSUInteger i = 2; i < methodSig.numberOfArguments; ++i) {
+        if ([blockSig getArgumentTypeAtIndex:i - 1][0] != [methodSig getArgumentTypeAtIndex:i][0]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+// YES for the type encoding of BOOL, which is _Bool on some platforms and signed char on others
+static BOOL JRPCIsBoolTypeEncoding(const char *typeEncoding) {
+    return 0 == strcmp(typeEncoding, "B") || 0 == strcmp(typeEncoding, "c");
+}
+
+// Primitive results are boxed in NSNumber, as they would be in a response
+#define JRPC_NUMBER_COMPLETION_BLOCK(type) \
+    ^(type result, NSError *error) { \
+        reply(@(result), error); \
+    }
+
+// Returns a completion block of the shape the method declares, which passes its result to reply
+static id JRPCCompletionBlockForResultType(char resultType, JRPCDispatchReply reply) {
+    switch (resultType) {
+        case 'B': return JRPC_NUMBER_COMPLETION_BLOCK(_Bool);
+        case 'c': return ^(char result, NSError *error) {
+            // As an integer, as the proxy writes char params, rather than as the boolean NSNumber would take it for
+            reply(@((int)result), error);
+        };
+        case 'i': return JRPC_NUMBER_COMPLETION_BLOCK(int);
+        case 's': return JRPC_NUMBER_COMPLETION_BLOCK(short);
+        case 'l': return JRPC_NUMBER_COMPLETION_BLOCK(long);
+        case 'q': return JRPC_NUMBER_COMPLETION_BLOCK(long long);
+        case 'C': return JRPC_NUMBER_COMPLETION_BLOCK(unsigned char);
+        case 'I': return JRPC_NUMBER_COMPLETION_BLOCK(unsigned int);
+        case 'S': return JRPC_NUMBER_COMPLETION_BLOCK(unsigned short);
+        case 'L': return JRPC_NUMBER_COMPLETION_BLOCK(unsigned long);
+        case 'Q': return JRPC_NUMBER_COMPLETION_BLOCK(unsigned long long);
+        case 'f': return JRPC_NUMBER_COMPLETION_BLOCK(float);
+        case 'd': return JRPC_NUMBER_COMPLETION_BLOCK(double);
+        case '@': return ^(id result, NSError *error) {
+            reply(result, error);
+        };
+        default: return nil;
+    }
+}
+
+// Returns a completion block for a method streaming its result, which collects the elements or chunks and replies with them as one array when done
+static id JRPCStreamingCompletionBlock(BOOL streamsChunks, JRPCDispatchReply reply) {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    return ^(id elementOrChunk, BOOL done, NSError *error) {
+        if (done) {
+            reply(error ? nil : elements, error);
+        }
+        else if (streamsChunks) {
+            [elements addObjectsFromArray:elementOrChunk];
+        }
+        else {
+            [elements addObject:elementOrChunk ? : [NSNull null]];
+        }
+    };
+}
+
+@implementation JRPCDispatchMethod
+
++ (instancetype) methodWithMethodDescription:(struct objc_method_description)methodDesc
+                              signatureBlock:(id)signatureBlock
+                              paramStructure:(JRPCParameterStructure)paramStructure {
+    return [[self alloc] initWithMethodDescription:methodDesc signatureBlock:signatureBlock paramStructure:paramStructure];
+}
+
+- (instancetype) initWithMethodDescription:(struct objc_method_description)methodDesc
+                            signatureBlock:(id)signatureBlock
+                            paramStructure:(JRPCParameterStructure)paramStructure {
+    self = [super init];
+    if (self) {
+        JRPCMethodDescriptor *descriptor = [JRPCMethodDescriptor descriptorWithMethodDescription:methodDesc paramStructure:paramStructure];
+        self.descriptor = descriptor;
+        self.paramTypes = calloc(MAX(descriptor.paramCount, 1), sizeof(JRPCDispatchParamType));
+        self.resultType = '@';
+        // Without a signature block, object params are passed as they are and results treated as objects. The block's params are the method's,
+        // without self & _cmd, so method argument i is block argument i - 1
+        NSMethodSignature *extendedSig = signatureBlock ? [[CTBlockDescription alloc] initWithBlock:signatureBlock].blockSignature : nil;
+        if (signatureBlock && !JRPCSignatureMatchesMethodSignature(extendedSig, descriptor.methodSignature)) {
+            [NSException raise:NSInvalidArgumentException format:@"The signature block for selector: %@ does not take the same params as the method",
+             NSStringFromSelector(methodDesc.name)];
+        }
+        if (extendedSig) {
+            SEL jsonObjectInitializer = @selector(initWithJSONRPCResponseResult:);
+            for (NSUInteger i = 0; i < descriptor.paramCount; ++i) {
+                Class cls = JRPCClassForExtendedTypeEncoding([extendedSig getArgumentTypeAtIndex:i + 1]);
+                self.paramTypes[i].cls = cls;
+                self.paramTypes[i].transformable = cls && class_respondsToSelector(cls, jsonObjectInitializer);
+            }
+            // The block params start at index 1 (0 = the block itself), and the last should be NSError by convention
+            NSMethodSignature *blockSig = descriptor.isNotification ? nil :
+                JRPCBlockSignatureForExtendedTypeEncoding([extendedSig getArgumentTypeAtIndex:descriptor.completionBlockIndex - 1]);
+            if (blockSig.numberOfArguments == 3) {
+                self.resultType = [blockSig getArgumentTypeAtIndex:1][0];
+            }
+            else if (blockSig.numberOfArguments == 4 && JRPCIsBoolTypeEncoding([blockSig getArgumentTypeAtIndex:2])) {
+                Class elementClass = JRPCClassForExtendedTypeEncoding([blockSig getArgumentTypeAtIndex:1]);
+                self.resultType = [blockSig getArgumentTypeAtIndex:1][0];
+                self.streamsResult = YES;
+                self.streamsChunks = [elementClass isSubclassOfClass:[NSArray class]];
+            }
+        }
+        // Streamed elements can only be objects
+        if ((self.streamsResult && '@' != self.resultType) || !JRPCCompletionBlockForResultType(self.resultType, ^(id result, NSError *error) {})) {
+            [NSException raise:NSInvalidArgumentException format:@"Unsupported completion type encoding for result: %c of selector: %@",
+             self.resultType, NSStringFromSelector(methodDesc.name)];
+        }
+    }
+    return self;
+}
+
+- (void) dealloc {
+    free(_paramTypes);
+}
+
+// Converts an object param to its declared class if required. Returns NO if it is neither of that class nor can be created from it
+- (BOOL) argument:(id __strong *)value forParamAtIndex:(NSUInteger)index {
+    JRPCDispatchParamType paramType = self.paramTypes[index];
+    if (!paramType.cls || !*value || [NSNull null] == *value || [*value isKindOfClass:paramType.cls]) {
+        return YES;
+    }
+    if (paramType.transformable) {
+        id transformed = [(id<JRPCTransformable>)[paramType.cls alloc] initWithJSONRPCResponseResult:*value];
+        if ([transformed isKindOfClass:paramType.cls]) {
+            *value = transformed;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+- (NSInvocation*) invocationWithTarget:(id)target params:(id)params reply:(JRPCDispatchReply)reply {
+    JRPCMethodDescriptor *descriptor = self.descriptor;
+    NSUInteger paramCount = descriptor.paramCount;
+    NSArray *positionalParams = nil;
+    NSDictionary *namedParams = nil;
+    if ([params isKindOfClass:[NSArray class]]) {
+        positionalParams = params;
+        if (positionalParams.count != paramCount) {
+            return nil;
+        }
+    }
+    else if ([params isKindOfClass:[NSDictionary class]]) {
+        // Only methods of a BY-NAME protocol have param names
+        namedParams = params;
+        if (!descriptor.paramNames) {
+            return nil;
+        }
+    }
+    else if (params || paramCount > 0) {
+        return nil;
+    }
+    NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:descriptor.methodSignature];
+    invocation.target = target;
+    invocation.selector = descriptor.selector;
+    // Converted arguments are held here until the invocation retains its arguments, the others by params
+    NS_VALID_UNTIL_END_OF_SCOPE NSMutableArray *convertedArguments = nil;
+    const JRPCArgumentPlan *argumentPlans = descriptor.argumentPlans;
+    for (NSUInteger i = 0; i < paramCount; ++i) {
+        // A missing BY-NAME param is null
+        id param = positionalParams ? positionalParams[i] : namedParams[descriptor.paramNames[i]];
+        id argument = param;
+        if (![self argument:&argument forParamAtIndex:i] || !argumentPlans[i].decoder(invocation, (NSInteger)i + 2, argument)) {
+            return nil;
+        }
+        if (argument != param) {
+            convertedArguments = convertedArguments ? : [[NSMutableArray alloc] init];
+            [convertedArguments addObject:argument];
+        }
+    }
+    if (!descriptor.isNotification) {
+        id completionBlock = self.streamsResult ? JRPCStreamingCompletionBlock(self.streamsChunks, reply) : JRPCCompletionBlockForResultType(self.resultType, reply);
+        [invocation setArgument:&completionBlock atIndex:descriptor.completionBlockIndex];
+    }
+    [invocation retainArguments];
+    return invocation;
+}
+
+@end
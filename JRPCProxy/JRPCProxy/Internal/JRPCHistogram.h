@@ -0,0 +1,84 @@
+//
+//  JRPCHistogram.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCMetrics.h"
+#import <mach/mach_time.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Returns the current time in mach_absolute_time() units, for timing with JRPCHistogram */
+NS_INLINE uint64_t JRPCHistogramNow(void) {
+    return mach_absolute_time();
+}
+
+/**
+ JRPCHistogram counts durations in log-linear buckets, as HdrHistogram does: durations under 32ns have a bucket each, and above that every power of two
+ is split into 16 buckets, so a bucket is never wider than 1/16 of the durations in it. Durations over 2^40ns are counted in the last bucket.
+ Recording is a handful of relaxed atomic operations without locks, so any number of threads may record at once, and with a snapshot being taken
+ */
+@interface JRPCHistogram : NSObject
+
+/**
+ Records the time elapsed since a start time
+ @param startTime The start time, from JRPCHistogramNow()
+ */
+- (void) recordSinceTime:(uint64_t)startTime;
+
+/**
+ Records a duration
+ @param nanoseconds The duration in nanoseconds
+ */
+- (void) recordNanoseconds:(uint64_t)nanoseconds;
+
+/** Returns the distribution recorded so far */
+- (JRPCHistogramSnapshot*) snapshot;
+
+/** Discards the durations recorded so far. Durations recorded meanwhile may be kept or discarded */
+- (void) reset;
+
+@end
+
+@interface JRPCHistogramSnapshot()
+
+/**
+ Creates a snapshot. Used by JRPCHistogram
+ @param buckets The counts of each bucket, bucketCount of them, which are copied
+ */
+- (instancetype) initWithBuckets:(const uint64_t *)buckets
+                     bucketCount:(NSUInteger)bucketCount
+                           count:(uint64_t)count
+                      totalNanos:(uint64_t)totalNanos
+                    minimumNanos:(uint64_t)minimumNanos
+                    maximumNanos:(uint64_t)maximumNanos NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,196 @@
+//
+//  JRPCHistogram.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCHistogram.h"
+#import <stdatomic.h>
+
+// Each power of two above 2^JRPC_HISTOGRAM_SUB_BUCKET_BITS is split into 2^JRPC_HISTOGRAM_SUB_BUCKET_BITS buckets
+#define JRPC_HISTOGRAM_SUB_BUCKET_BITS 4
+#define JRPC_HISTOGRAM_SUB_BUCKET_COUNT (1 << JRPC_HISTOGRAM_SUB_BUCKET_BITS)
+// The highest power of two counted. Longer durations are counted in the last bucket
+#define JRPC_HISTOGRAM_MAX_MAGNITUDE 40
+#define JRPC_HISTOGRAM_MAX_NANOS ((1ULL << (JRPC_HISTOGRAM_MAX_MAGNITUDE + 1)) - 1)
+#define JRPC_HISTOGRAM_BUCKET_COUNT ((JRPC_HISTOGRAM_MAX_MAGNITUDE - JRPC_HISTOGRAM_SUB_BUCKET_BITS + 2) * JRPC_HISTOGRAM_SUB_BUCKET_COUNT)
+
+// Values below 2 * JRPC_HISTOGRAM_SUB_BUCKET_COUNT index their own bucket. Above that, the magnitude picks a group of buckets and the next bits the bucket
+static inline NSUInteger JRPCHistogramBucketIndex(uint64_t nanos) {
+    if (nanos < JRPC_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return (NSUInteger)nanos;
+    }
+    unsigned magnitude = 63 - __builtin_clzll(nanos);
+    unsigned group = magnitude - JRPC_HISTOGRAM_SUB_BUCKET_BITS + 1;
+    NSUInteger subBucket = (NSUInteger)(nanos >> (magnitude - JRPC_HISTOGRAM_SUB_BUCKET_BITS)) - JRPC_HISTOGRAM_SUB_BUCKET_COUNT;
+    return group * JRPC_HISTOGRAM_SUB_BUCKET_COUNT + subBucket;
+}
+
+// The highest value counted in a bucket
+static inline uint64_t JRPCHistogramBucketHighestValue(NSUInteger index) {
+    NSUInteger group = index / JRPC_HISTOGRAM_SUB_BUCKET_COUNT;
+    uint64_t subBucket = index % JRPC_HISTOGRAM_SUB_BUCKET_COUNT;
+    if (0 == group) {
+        return subBucket;
+    }
+    uint64_t lowestValue = (JRPC_HISTOGRAM_SUB_BUCKET_COUNT + subBucket) << (group - 1);
+    return lowestValue + (1ULL << (group - 1)) - 1;
+}
+
+static inline NSTimeInterval JRPCHistogramSecondsWithNanos(uint64_t nanos) {
+    return (NSTimeInterval)nanos / NSEC_PER_SEC;
+}
+
+@implementation JRPCHistogram {
+    _Atomic(uint64_t) _totalNanos;
+    _Atomic(uint64_t) _minimumNanos;
+    _Atomic(uint64_t) _maximumNanos;
+    _Atomic(uint64_t) _buckets[JRPC_HISTOGRAM_BUCKET_COUNT];
+}
+
+- (instancetype) init {
+    self = [super init];
+    if (self) {
+        // Everything else starts at 0, as the object is zero filled
+        atomic_store_explicit(&_minimumNanos, UINT64_MAX, memory_order_relaxed);
+    }
+    return self;
+}
+
+- (void) recordSinceTime:(uint64_t)startTime {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    [self recordNanoseconds:(JRPCHistogramNow() - startTime) * timebase.numer / timebase.denom];
+}
+
+- (void) recordNanoseconds:(uint64_t)nanoseconds {
+    uint64_t nanos = MIN(nanoseconds, JRPC_HISTOGRAM_MAX_NANOS);
+    atomic_fetch_add_explicit(&_buckets[JRPCHistogramBucketIndex(nanos)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_totalNanos, nanos, memory_order_relaxed);
+    // The extremes only change while a histogram is new, so these rarely loop
+    uint64_t minimumNanos = atomic_load_explicit(&_minimumNanos, memory_order_relaxed);
+    while (nanos < minimumNanos && !atomic_compare_exchange_weak_explicit(&_minimumNanos, &minimumNanos, nanos, memory_order_relaxed, memory_order_relaxed)) {
+    }
+    uint64_t maximumNanos = atomic_load_explicit(&_maximumNanos, memory_order_relaxed);
+    while (nanos > maximumNanos && !atomic_compare_exchange_weak_explicit(&_maximumNanos, &maximumNanos, nanos, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+- (JRPCHistogramSnapshot*) snapshot {
+    uint64_t buckets[JRPC_HISTOGRAM_BUCKET_COUNT];
+    uint64_t count = 0;
+    for (NSUInteger i = 0; i < JRPC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        buckets[i] = atomic_load_explicit(&_buckets[i], memory_order_relaxed);
+        count += buckets[i];
+    }
+    // The count is taken from the buckets, so percentiles always add up even while durations are being recorded
+    uint64_t minimumNanos = atomic_load_explicit(&_minimumNanos, memory_order_relaxed);
+    return [[JRPCHistogramSnapshot alloc] initWithBuckets:buckets
+                                              bucketCount:JRPC_HISTOGRAM_BUCKET_COUNT
+                                                    count:count
+                                               totalNanos:atomic_load_explicit(&_totalNanos, memory_order_relaxed)
+                                             minimumNanos:(count > 0 && UINT64_MAX != minimumNanos) ? minimumNanos : 0
+                                             maximumNanos:count > 0 ? atomic_load_explicit(&_maximumNanos, memory_order_relaxed) : 0];
+}
+
+- (void) reset {
+    for (NSUInteger i = 0; i < JRPC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        atomic_store_explicit(&_buckets[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&_totalNanos, 0, memory_order_relaxed);
+    atomic_store_explicit(&_minimumNanos, UINT64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&_maximumNanos, 0, memory_order_relaxed);
+}
+
+@end
+
+@implementation JRPCHistogramSnapshot {
+    NSData *_buckets;
+    uint64_t _totalNanos;
+    uint64_t _minimumNanos;
+    uint64_t _maximumNanos;
+}
+
+- (instancetype) initWithBuckets:(const uint64_t *)buckets
+                     bucketCount:(NSUInteger)bucketCount
+                           count:(uint64_t)count
+                      totalNanos:(uint64_t)totalNanos
+                    minimumNanos:(uint64_t)minimumNanos
+                    maximumNanos:(uint64_t)maximumNanos {
+    self = [super init];
+    if (self) {
+        _buckets = [NSData dataWithBytes:buckets length:bucketCount * sizeof(uint64_t)];
+        _count = count;
+        _totalNanos = totalNanos;
+        _minimumNanos = minimumNanos;
+        _maximumNanos = maximumNanos;
+    }
+    return self;
+}
+
+- (NSTimeInterval) minimum {
+    return JRPCHistogramSecondsWithNanos(_minimumNanos);
+}
+
+- (NSTimeInterval) maximum {
+    return JRPCHistogramSecondsWithNanos(_maximumNanos);
+}
+
+- (NSTimeInterval) mean {
+    return self.count > 0 ? JRPCHistogramSecondsWithNanos(_totalNanos) / self.count : 0;
+}
+
+- (NSTimeInterval) valueAtPercentile:(double)percentile {
+    if (0 == self.count) {
+        return 0;
+    }
+    // The rank of the duration wanted, counting from 1
+    uint64_t rank = (uint64_t)ceil(MAX(0.0, MIN(percentile, 100.0)) / 100.0 * self.count);
+    rank = MAX(rank, 1);
+    const uint64_t *buckets = _buckets.bytes;
+    NSUInteger bucketCount = _buckets.length / sizeof(uint64_t);
+    uint64_t countBelow = 0;
+    for (NSUInteger i = 0; i < bucketCount; ++i) {
+        countBelow += buckets[i];
+        if (countBelow >= rank) {
+            // Reported as the highest duration the bucket counts, but never outside what was recorded
+            uint64_t nanos = MAX(MIN(JRPCHistogramBucketHighestValue(i), _maximumNanos), _minimumNanos);
+            return JRPCHistogramSecondsWithNanos(nanos);
+        }
+    }
+    return self.maximum;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"<%@: count=%llu mean=%gs p50=%gs p99=%gs max=%gs>", NSStringFromClass([self class]),
+            self.count, self.mean, [self valueAtPercentile:50], [self valueAtPercentile:99], self.maximum];
+}
+
+@end
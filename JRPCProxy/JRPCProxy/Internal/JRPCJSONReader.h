@@ -0,0 +1,158 @@
+//
+//  JRPCJSONReader.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The byte ranges of the members of a JSON-RPC response object within the response data, or of a request object within the request data
+ Each range covers the complete JSON text of the member value. The location is NSNotFound if the member is absent
+ */
+typedef struct JRPCJSONResponseEnvelope {
+    NSRange version;
+    NSRange requestId;
+    NSRange result;
+    NSRange error;
+    NSRange method;
+} JRPCJSONResponseEnvelope;
+
+/** How the value of a JRPCJSONScalar is held */
+typedef NS_ENUM(uint8_t, JRPCJSONScalarKind) {
+    /** An integer that fits in int64_t. Also used for true (1), false (0) & null (0) */
+    JRPCJSONScalarKindInteger = 0,
+    /** A positive integer too large for int64_t */
+    JRPCJSONScalarKindUnsignedInteger,
+    /** A number with a fraction or exponent, or an integer too large for uint64_t */
+    JRPCJSONScalarKindReal
+};
+
+/** A JSON number or literal read without boxing it in NSNumber */
+typedef struct JRPCJSONScalar {
+    JRPCJSONScalarKind kind;
+    union {
+        int64_t integer;
+        uint64_t unsignedInteger;
+        double real;
+    };
+} JRPCJSONScalar;
+
+/** Converts a scalar to a C numeric type using C conversion rules, as the NSNumber accessors do. Check JRPCJSONScalarFitsType() first */
+#define JRPC_JSON_SCALAR_VALUE(type, scalar) \
+    ((JRPCJSONScalarKindReal == (scalar).kind) ? (type)(scalar).real : \
+     (JRPCJSONScalarKindUnsignedInteger == (scalar).kind) ? (type)(scalar).unsignedInteger : (type)(scalar).integer)
+
+/**
+ Checks a real number can be converted to a C numeric type, which C leaves undefined for an integer type if the number is NaN or out of its range
+ @param real The number
+ @param type The Objective-C type encoding of the type, e.g. 'i' for int
+ @return NO for an integer type the number does not fit once truncated, otherwise YES
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONRealFitsType(double real, char type);
+
+/** Checks a scalar can be converted to a C numeric type with JRPC_JSON_SCALAR_VALUE. Only a real can fail to. See JRPCJSONRealFitsType() */
+NS_INLINE BOOL JRPCJSONScalarFitsType(JRPCJSONScalar scalar, char type) {
+    return JRPCJSONScalarKindReal != scalar.kind || JRPCJSONRealFitsType(scalar.real, type);
+}
+
+/** Checks an NSNumber can be converted to a C numeric type with its accessors. Only a floating point number can fail to. See JRPCJSONRealFitsType() */
+FOUNDATION_EXTERN BOOL JRPCJSONNumberFitsType(NSNumber *number, char type);
+
+/**
+ Scans a JSON-RPC response object, recording where its members are without creating any objects
+ The whole document is checked to be syntactically valid JSON, but member values other than the envelope keys are only skipped over
+ @param data The data containing the UTF-8 encoded JSON-RPC response
+ @param range The range of the response within data
+ @param envelope On return, the ranges of the response members, relative to the start of data
+ @return YES if the range holds a JSON object, otherwise NO
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONScanResponseEnvelope(NSData *data, NSRange range, JRPCJSONResponseEnvelope *envelope);
+
+/**
+ Scans a JSON array, e.g. a JSON-RPC batch response, finding each element without creating any objects
+ @param data The UTF-8 encoded JSON array
+ @param block Called with the range of the JSON text of each element, in order
+ @return YES if the data is a syntactically valid JSON array, otherwise NO. The block may have been called for some elements before an error is found
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONScanArray(NSData *data, void (NS_NOESCAPE ^block)(NSRange elementRange));
+
+/**
+ Scans a JSON-RPC response object held in the regions of some dispatch data, e.g. as read from a socket, without copying them into one buffer
+ @param data The UTF-8 encoded JSON-RPC response, in any number of regions
+ @param envelope On return, the ranges of the response members, relative to the start of data. A member may span regions
+ @return YES if the data holds a JSON object, otherwise NO
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONScanResponseEnvelopeInDispatchData(dispatch_data_t data, JRPCJSONResponseEnvelope *envelope);
+
+/**
+ Scans a JSON array held in the regions of some dispatch data, without copying them into one buffer. See JRPCJSONScanArray()
+ @param data The UTF-8 encoded JSON array, in any number of regions
+ @param block Called with the range of the JSON text of each element relative to the start of data, in order. An element may span regions
+ @return YES if the data is a syntactically valid JSON array, otherwise NO
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONScanArrayInDispatchData(dispatch_data_t data, void (NS_NOESCAPE ^block)(NSRange elementRange));
+
+/**
+ Reads a JSON value that is a number, true, false or null directly into a scalar
+ @param bytes The JSON text of a single value, as located by JRPCJSONScanResponseEnvelope()
+ @param length The length of the JSON text
+ @param scalar On return, the value if it is a scalar
+ @return YES if the value is a scalar, NO for strings, arrays & objects
+ */
+FOUNDATION_EXTERN BOOL JRPCJSONReadScalar(const uint8_t *bytes, NSUInteger length, JRPCJSONScalar *scalar);
+
+/**
+ Reads a JSON array of numbers directly into a C array of the given type, without creating an NSNumber per element
+ Elements are converted using C conversion rules, as the NSNumber accessors do
+ @param bytes The JSON text of a single value, as located by JRPCJSONScanResponseEnvelope()
+ @param length The length of the JSON text
+ @param type The Objective-C type encoding of the elements: 's' (int16_t), 'i' (int32_t), 'q' (int64_t), 'f' (float) or 'd' (double)
+ @return The elements, or nil if the value is not an array of numbers
+ */
+FOUNDATION_EXTERN NSData * _Nullable JRPCJSONReadNumericArray(const uint8_t *bytes, NSUInteger length, char type);
+
+/**
+ Creates the Foundation objects for a single JSON value within some data
+ Strings without escapes are decoded directly, anything else is parsed by NSJSONSerialization without copying the data
+ @param data The data containing the value
+ @param range The range of the JSON text of the value, as located by JRPCJSONScanResponseEnvelope()
+ @param error On return, the parse error if the value could not be created
+ @return The value, or nil if it could not be parsed
+ */
+FOUNDATION_EXTERN id _Nullable JRPCJSONObjectInRange(NSData *data, NSRange range, NSError * _Nullable * _Nullable error);
+
+/**
+ Reads a JSON-RPC id within some data, as jsonRPC_requestId would return it. Integer ids, as the proxy generates, are read without the parser
+ @param data The data containing the id
+ @param range The range of the JSON text of the id, as located by JRPCJSONScanResponseEnvelope()
+ @return The id if it is a number or a string, otherwise nil
+ */
+FOUNDATION_EXTERN id _Nullable JRPCJSONRequestIdInRange(NSData *data, NSRange range);
+
+NS_ASSUME_NONNULL_END
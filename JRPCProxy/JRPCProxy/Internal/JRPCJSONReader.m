@@ -0,0 +1,642 @@
+//
+//  JRPCJSONReader.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCJSONReader.h"
+#import <xlocale.h>
+
+// Nesting deeper than this is rejected rather than risk exhausting the stack
+#define JRPC_JSON_MAX_DEPTH 512
+
+#pragma mark - Scanning
+
+/** A contiguous part of the input, which may be in several parts e.g. the regions of a dispatch_data_t */
+typedef struct JRPCJSONRegion {
+    const uint8_t *bytes;
+    NSUInteger length;
+} JRPCJSONRegion;
+
+typedef struct JRPCJSONCursor {
+    // The current region
+    const uint8_t *start;
+    const uint8_t *p;
+    const uint8_t *end;
+    // The offset of start within the input
+    NSUInteger offset;
+    // The regions after the current one, none for contiguous input
+    const JRPCJSONRegion *nextRegion;
+    const JRPCJSONRegion *endRegion;
+} JRPCJSONCursor;
+
+static inline JRPCJSONCursor JRPCJSONCursorMake(const JRPCJSONRegion *regions, NSUInteger regionCount, NSUInteger offset) {
+    JRPCJSONCursor cursor = { regions[0].bytes, regions[0].bytes, regions[0].bytes + regions[0].length, offset, regions + 1, regions + regionCount };
+    return cursor;
+}
+
+// Moves the cursor to the start of the next non-empty region. Returns NO at the end of the input
+static BOOL JRPCJSONNextRegion(JRPCJSONCursor *cursor) {
+    while (cursor->nextRegion < cursor->endRegion) {
+        const JRPCJSONRegion *region = cursor->nextRegion++;
+        cursor->offset += (NSUInteger)(cursor->end - cursor->start);
+        cursor->start = cursor->p = region->bytes;
+        cursor->end = region->bytes + region->length;
+        if (region->length > 0) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// YES if there is a byte at the cursor, moving on to the next region if the current one is used up
+static inline BOOL JRPCJSONHasByte(JRPCJSONCursor *cursor) {
+    return cursor->p < cursor->end || JRPCJSONNextRegion(cursor);
+}
+
+// The offset of the cursor within the input
+static inline NSUInteger JRPCJSONCursorOffset(const JRPCJSONCursor *cursor) {
+    return cursor->offset + (NSUInteger)(cursor->p - cursor->start);
+}
+
+static inline void JRPCJSONSkipWhitespace(JRPCJSONCursor *cursor) {
+    while (JRPCJSONHasByte(cursor) && (' ' == *cursor->p || '\n' == *cursor->p || '\r' == *cursor->p || '\t' == *cursor->p)) {
+        ++cursor->p;
+    }
+}
+
+static inline BOOL JRPCJSONIsDigit(uint8_t c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline BOOL JRPCJSONIsHexDigit(uint8_t c) {
+    return JRPCJSONIsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static BOOL JRPCJSONSkipString(JRPCJSONCursor *cursor) {
+    // Opening quote
+    ++cursor->p;
+    while (JRPCJSONHasByte(cursor)) {
+        uint8_t c = *cursor->p++;
+        if ('"' == c) {
+            return YES;
+        }
+        if (c < 0x20) {
+            // Control characters must be escaped
+            return NO;
+        }
+        if ('\\' == c) {
+            if (!JRPCJSONHasByte(cursor)) {
+                return NO;
+            }
+            c = *cursor->p++;
+            if ('u' == c) {
+                for (int i = 0; i < 4; ++i) {
+                    if (!JRPCJSONHasByte(cursor) || !JRPCJSONIsHexDigit(*cursor->p++)) {
+                        return NO;
+                    }
+                }
+            } else if (!strchr("\"\\/bfnrt", c) || 0 == c) {
+                return NO;
+            }
+        }
+    }
+    return NO;
+}
+
+static BOOL JRPCJSONSkipDigits(JRPCJSONCursor *cursor) {
+    BOOL skipped = NO;
+    while (JRPCJSONHasByte(cursor) && JRPCJSONIsDigit(*cursor->p)) {
+        ++cursor->p;
+        skipped = YES;
+    }
+    return skipped;
+}
+
+static BOOL JRPCJSONSkipNumber(JRPCJSONCursor *cursor) {
+    if ('-' == *cursor->p) {
+        ++cursor->p;
+    }
+    if (JRPCJSONHasByte(cursor) && '0' == *cursor->p) {
+        ++cursor->p;
+    } else if (!JRPCJSONSkipDigits(cursor)) {
+        return NO;
+    }
+    if (JRPCJSONHasByte(cursor) && '.' == *cursor->p) {
+        ++cursor->p;
+        if (!JRPCJSONSkipDigits(cursor)) {
+            return NO;
+        }
+    }
+    if (JRPCJSONHasByte(cursor) && ('e' == *cursor->p || 'E' == *cursor->p)) {
+        ++cursor->p;
+        if (JRPCJSONHasByte(cursor) && ('+' == *cursor->p || '-' == *cursor->p)) {
+            ++cursor->p;
+        }
+        if (!JRPCJSONSkipDigits(cursor)) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+static BOOL JRPCJSONSkipLiteral(JRPCJSONCursor *cursor, const char *literal, size_t length) {
+    if ((size_t)(cursor->end - cursor->p) >= length) {
+        if (0 != memcmp(cursor->p, literal, length)) {
+            return NO;
+        }
+        cursor->p += length;
+        return YES;
+    }
+    // The literal may span regions
+    for (size_t i = 0; i < length; ++i) {
+        if (!JRPCJSONHasByte(cursor) || (uint8_t)literal[i] != *cursor->p) {
+            return NO;
+        }
+        ++cursor->p;
+    }
+    return YES;
+}
+
+static BOOL JRPCJSONSkipValue(JRPCJSONCursor *cursor, NSUInteger depth);
+
+// Skips the members of an object or the elements of an array, the cursor being just past the opening bracket
+static BOOL JRPCJSONSkipContainer(JRPCJSONCursor *cursor, NSUInteger depth, BOOL isObject) {
+    uint8_t close = isObject ? '}' : ']';
+    JRPCJSONSkipWhitespace(cursor);
+    if (JRPCJSONHasByte(cursor) && close == *cursor->p) {
+        ++cursor->p;
+        return YES;
+    }
+    while (JRPCJSONHasByte(cursor)) {
+        if (isObject) {
+            if ('"' != *cursor->p || !JRPCJSONSkipString(cursor)) {
+                return NO;
+            }
+            JRPCJSONSkipWhitespace(cursor);
+            if (!JRPCJSONHasByte(cursor) || ':' != *cursor->p++) {
+                return NO;
+            }
+            JRPCJSONSkipWhitespace(cursor);
+        }
+        if (!JRPCJSONSkipValue(cursor, depth + 1)) {
+            return NO;
+        }
+        JRPCJSONSkipWhitespace(cursor);
+        if (!JRPCJSONHasByte(cursor)) {
+            return NO;
+        }
+        uint8_t c = *cursor->p++;
+        if (close == c) {
+            return YES;
+        }
+        if (',' != c) {
+            return NO;
+        }
+        JRPCJSONSkipWhitespace(cursor);
+    }
+    return NO;
+}
+
+static BOOL JRPCJSONSkipValue(JRPCJSONCursor *cursor, NSUInteger depth) {
+    if (!JRPCJSONHasByte(cursor) || depth > JRPC_JSON_MAX_DEPTH) {
+        return NO;
+    }
+    switch (*cursor->p) {
+        case '"':
+            return JRPCJSONSkipString(cursor);
+        case '{':
+            ++cursor->p;
+            return JRPCJSONSkipContainer(cursor, depth, YES);
+        case '[':
+            ++cursor->p;
+            return JRPCJSONSkipContainer(cursor, depth, NO);
+        case 't':
+            return JRPCJSONSkipLiteral(cursor, "true", 4);
+        case 'f':
+            return JRPCJSONSkipLiteral(cursor, "false", 5);
+        case 'n':
+            return JRPCJSONSkipLiteral(cursor, "null", 4);
+        default:
+            return JRPCJSONSkipNumber(cursor);
+    }
+}
+
+// Copies bytes at an offset within the input, which may span regions
+static void JRPCJSONCopyBytes(const JRPCJSONRegion *regions, NSUInteger regionCount, NSUInteger offset, uint8_t *buffer, NSUInteger length) {
+    for (NSUInteger i = 0; i < regionCount && length > 0; ++i) {
+        if (offset >= regions[i].length) {
+            offset -= regions[i].length;
+            continue;
+        }
+        NSUInteger count = MIN(length, regions[i].length - offset);
+        memcpy(buffer, regions[i].bytes + offset, count);
+        buffer += count;
+        length -= count;
+        offset = 0;
+    }
+}
+
+static inline BOOL JRPCJSONKeyEquals(const uint8_t *key, NSUInteger keyLength, const char *name, size_t nameLength) {
+    return keyLength == nameLength && 0 == memcmp(key, name, nameLength);
+}
+
+// Scans a response object in regions that start at baseOffset within the input
+static BOOL JRPCJSONScanEnvelopeInRegions(const JRPCJSONRegion *regions, NSUInteger regionCount, NSUInteger baseOffset, JRPCJSONResponseEnvelope *envelope) {
+    envelope->version = envelope->requestId = envelope->result = envelope->error = envelope->method = NSMakeRange(NSNotFound, 0);
+    JRPCJSONCursor cursor = JRPCJSONCursorMake(regions, regionCount, baseOffset);
+    JRPCJSONSkipWhitespace(&cursor);
+    if (!JRPCJSONHasByte(&cursor) || '{' != *cursor.p++) {
+        return NO;
+    }
+    JRPCJSONSkipWhitespace(&cursor);
+    BOOL closed = NO;
+    if (JRPCJSONHasByte(&cursor) && '}' == *cursor.p) {
+        ++cursor.p;
+        closed = YES;
+    }
+    while (!closed && JRPCJSONHasByte(&cursor)) {
+        // Member key. Envelope keys never need escaping, so the raw bytes are compared
+        if ('"' != *cursor.p) {
+            return NO;
+        }
+        const uint8_t *key = cursor.p + 1;
+        NSUInteger keyRegionOffset = cursor.offset;
+        NSUInteger keyOffset = JRPCJSONCursorOffset(&cursor) + 1;
+        if (!JRPCJSONSkipString(&cursor)) {
+            return NO;
+        }
+        NSUInteger keyLength = JRPCJSONCursorOffset(&cursor) - 1 - keyOffset;
+        uint8_t keyBytes[8];
+        if (keyRegionOffset != cursor.offset && keyLength <= sizeof(keyBytes)) {
+            // The key spans regions. Only short keys can be envelope keys, so only those are gathered to compare
+            JRPCJSONCopyBytes(regions, regionCount, keyOffset - baseOffset, keyBytes, keyLength);
+            key = keyBytes;
+        }
+        else if (keyRegionOffset != cursor.offset) {
+            key = NULL;
+        }
+        JRPCJSONSkipWhitespace(&cursor);
+        if (!JRPCJSONHasByte(&cursor) || ':' != *cursor.p++) {
+            return NO;
+        }
+        JRPCJSONSkipWhitespace(&cursor);
+        // Member value
+        if (!JRPCJSONHasByte(&cursor)) {
+            return NO;
+        }
+        NSUInteger valueOffset = JRPCJSONCursorOffset(&cursor);
+        if (!JRPCJSONSkipValue(&cursor, 1)) {
+            return NO;
+        }
+        NSRange valueRange = NSMakeRange(valueOffset, JRPCJSONCursorOffset(&cursor) - valueOffset);
+        if (!key) {
+            // Too long to be an envelope key
+        } else if (JRPCJSONKeyEquals(key, keyLength, "result", 6)) {
+            envelope->result = valueRange;
+        } else if (JRPCJSONKeyEquals(key, keyLength, "error", 5)) {
+            envelope->error = valueRange;
+        } else if (JRPCJSONKeyEquals(key, keyLength, "id", 2)) {
+            envelope->requestId = valueRange;
+        } else if (JRPCJSONKeyEquals(key, keyLength, "jsonrpc", 7)) {
+            envelope->version = valueRange;
+        } else if (JRPCJSONKeyEquals(key, keyLength, "method", 6)) {
+            envelope->method = valueRange;
+        }
+        JRPCJSONSkipWhitespace(&cursor);
+        if (!JRPCJSONHasByte(&cursor)) {
+            return NO;
+        }
+        uint8_t c = *cursor.p++;
+        if ('}' == c) {
+            closed = YES;
+        } else if (',' == c) {
+            JRPCJSONSkipWhitespace(&cursor);
+        } else {
+            return NO;
+        }
+    }
+    // Nothing but whitespace may follow the response object
+    JRPCJSONSkipWhitespace(&cursor);
+    return closed && !JRPCJSONHasByte(&cursor);
+}
+
+static BOOL JRPCJSONScanArrayInRegions(const JRPCJSONRegion *regions, NSUInteger regionCount, void (NS_NOESCAPE ^block)(NSRange elementRange)) {
+    JRPCJSONCursor cursor = JRPCJSONCursorMake(regions, regionCount, 0);
+    JRPCJSONSkipWhitespace(&cursor);
+    if (!JRPCJSONHasByte(&cursor) || '[' != *cursor.p++) {
+        return NO;
+    }
+    JRPCJSONSkipWhitespace(&cursor);
+    BOOL closed = NO;
+    if (JRPCJSONHasByte(&cursor) && ']' == *cursor.p) {
+        ++cursor.p;
+        closed = YES;
+    }
+    while (!closed && JRPCJSONHasByte(&cursor)) {
+        NSUInteger elementOffset = JRPCJSONCursorOffset(&cursor);
+        if (!JRPCJSONSkipValue(&cursor, 1)) {
+            return NO;
+        }
+        block(NSMakeRange(elementOffset, JRPCJSONCursorOffset(&cursor) - elementOffset));
+        JRPCJSONSkipWhitespace(&cursor);
+        if (!JRPCJSONHasByte(&cursor)) {
+            return NO;
+        }
+        uint8_t c = *cursor.p++;
+        if (']' == c) {
+            closed = YES;
+        } else if (',' == c) {
+            JRPCJSONSkipWhitespace(&cursor);
+        } else {
+            return NO;
+        }
+    }
+    // Nothing but whitespace may follow the array
+    JRPCJSONSkipWhitespace(&cursor);
+    return closed && !JRPCJSONHasByte(&cursor);
+}
+
+// Calls block with the regions of some dispatch data, without copying them. There is always at least one region, which may be empty
+static BOOL JRPCJSONWithRegions(dispatch_data_t data, BOOL (NS_NOESCAPE ^block)(const JRPCJSONRegion *regions, NSUInteger regionCount)) {
+    static const uint8_t empty = 0;
+    __block NSUInteger regionCount = 0;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        ++regionCount;
+        return true;
+    });
+    JRPCJSONRegion inlineRegions[16];
+    JRPCJSONRegion *regions = (regionCount <= 16) ? inlineRegions : malloc(regionCount * sizeof(JRPCJSONRegion));
+    if (!regions) {
+        return NO;
+    }
+    regions[0] = (JRPCJSONRegion){ &empty, 0 };
+    __block NSUInteger i = 0;
+    // The regions are retained by data, so their bytes stay put after the applier returns
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        regions[i++] = (JRPCJSONRegion){ buffer, size };
+        return true;
+    });
+    BOOL result = block(regions, MAX(regionCount, 1));
+    if (regions != inlineRegions) {
+        free(regions);
+    }
+    return result;
+}
+
+BOOL JRPCJSONScanResponseEnvelope(NSData *data, NSRange range, JRPCJSONResponseEnvelope *envelope) {
+    JRPCJSONRegion region = { (const uint8_t*)data.bytes + range.location, range.length };
+    return JRPCJSONScanEnvelopeInRegions(&region, 1, range.location, envelope);
+}
+
+BOOL JRPCJSONScanArray(NSData *data, void (NS_NOESCAPE ^block)(NSRange elementRange)) {
+    JRPCJSONRegion region = { data.bytes, data.length };
+    return JRPCJSONScanArrayInRegions(&region, 1, block);
+}
+
+BOOL JRPCJSONScanResponseEnvelopeInDispatchData(dispatch_data_t data, JRPCJSONResponseEnvelope *envelope) {
+    return JRPCJSONWithRegions(data, ^BOOL(const JRPCJSONRegion *regions, NSUInteger regionCount) {
+        return JRPCJSONScanEnvelopeInRegions(regions, regionCount, 0, envelope);
+    });
+}
+
+BOOL JRPCJSONScanArrayInDispatchData(dispatch_data_t data, void (NS_NOESCAPE ^block)(NSRange elementRange)) {
+    return JRPCJSONWithRegions(data, ^BOOL(const JRPCJSONRegion *regions, NSUInteger regionCount) {
+        return JRPCJSONScanArrayInRegions(regions, regionCount, block);
+    });
+}
+
+#pragma mark - Scalars
+
+BOOL JRPCJSONReadScalar(const uint8_t *bytes, NSUInteger length, JRPCJSONScalar *scalar) {
+    if (0 == length) {
+        return NO;
+    }
+    switch (bytes[0]) {
+        case 't':
+            scalar->kind = JRPCJSONScalarKindInteger;
+            scalar->integer = 1;
+            return YES;
+        case 'f':
+        case 'n':
+            scalar->kind = JRPCJSONScalarKindInteger;
+            scalar->integer = 0;
+            return YES;
+        case '"':
+        case '[':
+        case '{':
+            return NO;
+        default:
+            break;
+    }
+    // Integers are accumulated directly, falling back to strtod for fractions, exponents & overflow
+    BOOL negative = ('-' == bytes[0]);
+    uint64_t magnitude = 0;
+    BOOL integral = YES;
+    for (NSUInteger i = negative ? 1 : 0; i < length; ++i) {
+        uint8_t c = bytes[i];
+        if (!JRPCJSONIsDigit(c)) {
+            integral = NO;
+            break;
+        }
+        uint64_t digit = (uint64_t)(c - '0');
+        if (magnitude > (UINT64_MAX - digit) / 10) {
+            integral = NO;
+            break;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    if (integral) {
+        if (!negative && magnitude > (uint64_t)INT64_MAX) {
+            scalar->kind = JRPCJSONScalarKindUnsignedInteger;
+            scalar->unsignedInteger = magnitude;
+            return YES;
+        }
+        if (!negative || magnitude <= (uint64_t)INT64_MAX + 1) {
+            scalar->kind = JRPCJSONScalarKindInteger;
+            scalar->integer = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+            return YES;
+        }
+    }
+    // strtod needs a terminated string. Anything longer than this is not a number we can represent faithfully anyway
+    char text[64];
+    if (length >= sizeof(text)) {
+        return NO;
+    }
+    memcpy(text, bytes, length);
+    text[length] = '\0';
+    // The C locale (NULL) is used explicitly so the decimal separator is always '.'
+    scalar->kind = JRPCJSONScalarKindReal;
+    scalar->real = strtod_l(text, NULL, NULL);
+    return YES;
+}
+
+#pragma mark - Conversions
+
+// Truncation toward zero must leave a value of the integer type: -2^(bits-1) <= value < 2^(bits-1), or 0 <= value < 2^bits if unsigned.
+// The bounds are powers of two, so exact as doubles. NaN fails every comparison
+static BOOL JRPCJSONRealFitsInteger(double real, size_t size, BOOL isSigned) {
+    double limit = ldexp(1.0, (int)(size * CHAR_BIT) - (isSigned ? 1 : 0));
+    double truncated = trunc(real);
+    return truncated >= (isSigned ? -limit : 0.0) && truncated < limit;
+}
+
+BOOL JRPCJSONRealFitsType(double real, char type) {
+    switch (type) {
+        case 'c': return JRPCJSONRealFitsInteger(real, sizeof(char), YES);
+        case 's': return JRPCJSONRealFitsInteger(real, sizeof(short), YES);
+        case 'i': return JRPCJSONRealFitsInteger(real, sizeof(int), YES);
+        case 'l': return JRPCJSONRealFitsInteger(real, sizeof(long), YES);
+        case 'q': return JRPCJSONRealFitsInteger(real, sizeof(long long), YES);
+        case 'C': return JRPCJSONRealFitsInteger(real, sizeof(unsigned char), NO);
+        case 'S': return JRPCJSONRealFitsInteger(real, sizeof(unsigned short), NO);
+        case 'I': return JRPCJSONRealFitsInteger(real, sizeof(unsigned int), NO);
+        case 'L': return JRPCJSONRealFitsInteger(real, sizeof(unsigned long), NO);
+        case 'Q': return JRPCJSONRealFitsInteger(real, sizeof(unsigned long long), NO);
+        // Any number converts to _Bool, float & double
+        default: return YES;
+    }
+}
+
+BOOL JRPCJSONNumberFitsType(NSNumber *number, char type) {
+    char numberType = number.objCType[0];
+    return ('f' != numberType && 'd' != numberType) || JRPCJSONRealFitsType(number.doubleValue, type);
+}
+
+#pragma mark - Numeric arrays
+
+#define JRPC_STORE_NUMERIC_ELEMENT(elementType, elements, index, scalar) \
+    ((elementType *)(elements))[index] = JRPC_JSON_SCALAR_VALUE(elementType, scalar)
+
+NSData *JRPCJSONReadNumericArray(const uint8_t *bytes, NSUInteger length, char type) {
+    size_t elementSize;
+    switch (type) {
+        case 's': elementSize = sizeof(int16_t); break;
+        case 'i': elementSize = sizeof(int32_t); break;
+        case 'q': elementSize = sizeof(int64_t); break;
+        case 'f': elementSize = sizeof(float); break;
+        case 'd': elementSize = sizeof(double); break;
+        default: return nil;
+    }
+    JRPCJSONRegion region = { bytes, length };
+    JRPCJSONCursor cursor = JRPCJSONCursorMake(&region, 1, 0);
+    JRPCJSONSkipWhitespace(&cursor);
+    if (cursor.p >= cursor.end || '[' != *cursor.p++) {
+        return nil;
+    }
+    // An array of numbers has exactly one comma between each element, so counting them with memchr (vectorised by libc) sizes the elements in a single
+    // allocation. Any other array is rejected below before the count matters
+    NSUInteger capacity = 1;
+    for (const uint8_t *comma = cursor.p; (comma = memchr(comma, ',', (size_t)(cursor.end - comma))) != NULL; ++comma) {
+        ++capacity;
+    }
+    void *elements = malloc(capacity * elementSize);
+    if (NULL == elements) {
+        return nil;
+    }
+    NSUInteger count = 0;
+    JRPCJSONSkipWhitespace(&cursor);
+    BOOL closed = NO;
+    if (cursor.p < cursor.end && ']' == *cursor.p) {
+        ++cursor.p;
+        closed = YES;
+    }
+    while (!closed && cursor.p < cursor.end && count < capacity) {
+        const uint8_t *element = cursor.p;
+        JRPCJSONScalar scalar;
+        if ('-' != *element && !JRPCJSONIsDigit(*element)) {
+            break;
+        }
+        // An element the type cannot hold makes it not an array of that type, as anything other than a number does
+        if (!JRPCJSONSkipNumber(&cursor) || !JRPCJSONReadScalar(element, (NSUInteger)(cursor.p - element), &scalar) ||
+            !JRPCJSONScalarFitsType(scalar, type)) {
+            break;
+        }
+        switch (type) {
+            case 's': JRPC_STORE_NUMERIC_ELEMENT(int16_t, elements, count, scalar); break;
+            case 'i': JRPC_STORE_NUMERIC_ELEMENT(int32_t, elements, count, scalar); break;
+            case 'q': JRPC_STORE_NUMERIC_ELEMENT(int64_t, elements, count, scalar); break;
+            case 'f': JRPC_STORE_NUMERIC_ELEMENT(float, elements, count, scalar); break;
+            case 'd': JRPC_STORE_NUMERIC_ELEMENT(double, elements, count, scalar); break;
+        }
+        ++count;
+        JRPCJSONSkipWhitespace(&cursor);
+        if (cursor.p >= cursor.end) {
+            break;
+        }
+        uint8_t c = *cursor.p++;
+        if (']' == c) {
+            closed = YES;
+        } else if (',' == c) {
+            JRPCJSONSkipWhitespace(&cursor);
+        } else {
+            break;
+        }
+    }
+    JRPCJSONSkipWhitespace(&cursor);
+    if (!closed || cursor.p != cursor.end) {
+        free(elements);
+        return nil;
+    }
+    return [[NSData alloc] initWithBytesNoCopy:elements length:count * elementSize freeWhenDone:YES];
+}
+
+#pragma mark - Objects
+
+id JRPCJSONObjectInRange(NSData *data, NSRange range, NSError **error) {
+    const uint8_t *bytes = (const uint8_t*)data.bytes + range.location;
+    if (range.length >= 2 && '"' == bytes[0] && !memchr(bytes + 1, '\\', range.length - 2)) {
+        // Plain strings are decoded without going through NSJSONSerialization
+        NSString *string = [[NSString alloc] initWithBytes:bytes + 1 length:range.length - 2 encoding:NSUTF8StringEncoding];
+        if (string) {
+            return string;
+        }
+    }
+    // The parser reads straight from the response data, which outlives this call
+    NSData *valueData = [[NSData alloc] initWithBytesNoCopy:(void*)bytes length:range.length freeWhenDone:NO];
+    return [NSJSONSerialization JSONObjectWithData:valueData options:NSJSONReadingAllowFragments error:error];
+}
+
+id JRPCJSONRequestIdInRange(NSData *data, NSRange range) {
+    const uint8_t *bytes = (const uint8_t*)data.bytes + range.location;
+    JRPCJSONScalar scalar;
+    if (JRPCJSONReadScalar(bytes, range.length, &scalar)) {
+        // Numbers only, not null, true or false
+        if ('-' != bytes[0] && (bytes[0] < '0' || bytes[0] > '9')) {
+            return nil;
+        }
+        switch (scalar.kind) {
+            case JRPCJSONScalarKindInteger:
+                return @(scalar.integer);
+            case JRPCJSONScalarKindUnsignedInteger:
+                return @(scalar.unsignedInteger);
+            case JRPCJSONScalarKindReal:
+                return @(scalar.real);
+        }
+    }
+    id requestId = JRPCJSONObjectInRange(data, range, NULL);
+    return [requestId isKindOfClass:[NSString class]] ? requestId : nil;
+}
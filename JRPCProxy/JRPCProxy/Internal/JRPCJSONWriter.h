@@ -0,0 +1,137 @@
+//
+//  JRPCJSONWriter.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The number of bytes a writer can hold before spilling to the heap */
+#define JRPC_JSON_WRITER_INLINE_CAPACITY 1024
+
+/** The size of each buffer after the first, when a writer writes chunks */
+#define JRPC_JSON_WRITER_CHUNK_CAPACITY 65536
+
+/**
+ JRPCJSONWriter writes JSON text directly into a growable byte buffer, without building Foundation objects first.
+ The buffer starts inline in the struct, so a writer declared on the stack only touches the heap for large payloads.
+ Output follows NSJSONSerialization conventions: no whitespace, '/' is escaped, non-ASCII is written as raw UTF-8 and integral numbers have no fraction.
+ */
+typedef struct JRPCJSONWriter {
+    uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger capacity;
+    /** If YES, dictionary keys are written in sorted order so that equal dictionaries are always written the same. Defaults to NO */
+    BOOL sortsKeys;
+    /**
+     If YES, NSData is written as its bytes in hex between angle brackets, which cannot be confused with any JSON value. The output is then not
+     valid JSON, but still identifies the value, e.g. in a cache key. Defaults to NO, when NSData raises like any other non-JSON type
+     */
+    BOOL writesData;
+    /**
+     If YES, a full buffer is kept as a chunk and writing carries on in a new one, rather than the buffer being grown by copying it.
+     Read the output with JRPCJSONWriterCopyDispatchData(), which joins the chunks without copying them. Defaults to NO
+     */
+    BOOL writesChunks;
+    /** The full chunks, a retained dispatch_data_t, or NULL */
+    void *chunks;
+    uint8_t inlineBytes[JRPC_JSON_WRITER_INLINE_CAPACITY];
+} JRPCJSONWriter;
+
+/** Initializes a writer. Every initialized writer must be finished with JRPCJSONWriterCopyData() or JRPCJSONWriterDestroy() */
+FOUNDATION_EXTERN void JRPCJSONWriterInit(JRPCJSONWriter *writer);
+
+/** Releases any heap storage held by the writer */
+FOUNDATION_EXTERN void JRPCJSONWriterDestroy(JRPCJSONWriter *writer);
+
+/** Returns the written bytes, handing over the heap buffer if there is one so they are not copied again. The writer is left empty */
+FOUNDATION_EXTERN NSData *JRPCJSONWriterCopyData(JRPCJSONWriter *writer);
+
+/** Returns the output as dispatch data, one region per chunk, and resets the writer. Heap buffers are handed over rather than copied */
+FOUNDATION_EXTERN dispatch_data_t JRPCJSONWriterCopyDispatchData(JRPCJSONWriter *writer);
+
+/** Grows the writer so at least additional more bytes may be written */
+FOUNDATION_EXTERN void JRPCJSONWriterGrow(JRPCJSONWriter *writer, NSUInteger additional);
+
+/** Returns a pointer to space for at least additional more bytes. Advance writer->length by the number of bytes actually written */
+NS_INLINE uint8_t *JRPCJSONWriterReserve(JRPCJSONWriter *writer, NSUInteger additional) {
+    if (writer->length + additional > writer->capacity) {
+        JRPCJSONWriterGrow(writer, additional);
+    }
+    return writer->bytes + writer->length;
+}
+
+/** Appends raw bytes, which must already be valid JSON text */
+NS_INLINE void JRPCJSONWriterAppendBytes(JRPCJSONWriter *writer, const void *bytes, NSUInteger length) {
+    memcpy(JRPCJSONWriterReserve(writer, length), bytes, length);
+    writer->length += length;
+}
+
+/** Appends a single raw byte, e.g. a structural character */
+NS_INLINE void JRPCJSONWriterAppendByte(JRPCJSONWriter *writer, uint8_t byte) {
+    *JRPCJSONWriterReserve(writer, 1) = byte;
+    writer->length += 1;
+}
+
+/** Appends true or false */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendBool(JRPCJSONWriter *writer, BOOL value);
+
+/** Appends a signed integer */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendInt64(JRPCJSONWriter *writer, int64_t value);
+
+/** Appends an unsigned integer */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendUInt64(JRPCJSONWriter *writer, uint64_t value);
+
+/** Appends a finite floating point number using the fewest significant digits (up to 17) that round trip. Negative zero is written as -0.0 */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendDouble(JRPCJSONWriter *writer, double value);
+
+/** Appends a finite float using the fewest significant digits (up to 9) that read back as the same float. Negative zero is written as -0.0 */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendFloat(JRPCJSONWriter *writer, float value);
+
+/**
+ Appends a JSON array of numbers straight from a C array, without creating an NSNumber per element
+ Raises NSInvalidArgumentException if an element is NaN or infinite, or type is not supported
+ @param values The elements
+ @param count The number of elements
+ @param type The Objective-C type encoding of the elements: 's' (int16_t), 'i' (int32_t), 'q' (int64_t), 'f' (float) or 'd' (double)
+ */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendNumericArray(JRPCJSONWriter *writer, const void *values, NSUInteger count, char type);
+
+/** Appends a quoted, escaped JSON string from UTF-8 bytes */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendUTF8String(JRPCJSONWriter *writer, const char *utf8, NSUInteger length);
+
+/** Appends a quoted, escaped JSON string */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendString(JRPCJSONWriter *writer, NSString *string);
+
+/**
+ Appends a JSON value for a valid JSON object (see NSJSONSerialization isValidJSONObject:)
+ Raises NSInvalidArgumentException if obj or anything it contains is not a JSON type
+ */
+FOUNDATION_EXTERN void JRPCJSONWriterAppendObject(JRPCJSONWriter *writer, id obj);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,459 @@
+//
+//  JRPCJSONWriter.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCJSONWriter.h"
+#import <xlocale.h>
+
+#pragma mark - Buffer
+
+void JRPCJSONWriterInit(JRPCJSONWriter *writer) {
+    writer->bytes = writer->inlineBytes;
+    writer->length = 0;
+    writer->capacity = JRPC_JSON_WRITER_INLINE_CAPACITY;
+    writer->sortsKeys = NO;
+    writer->writesData = NO;
+    writer->writesChunks = NO;
+    writer->chunks = NULL;
+}
+
+void JRPCJSONWriterDestroy(JRPCJSONWriter *writer) {
+    if (writer->bytes != writer->inlineBytes) {
+        free(writer->bytes);
+    }
+    if (writer->chunks) {
+        (void)(__bridge_transfer dispatch_data_t)writer->chunks;
+    }
+    JRPCJSONWriterInit(writer);
+}
+
+// Appends the buffer to the chunks, handing over a heap buffer, and leaves the writer with no buffer
+static void JRPCJSONWriterSealChunk(JRPCJSONWriter *writer) {
+    dispatch_data_t chunk = nil;
+    if (writer->bytes == writer->inlineBytes) {
+        // At most JRPC_JSON_WRITER_INLINE_CAPACITY bytes are copied out of the struct
+        chunk = dispatch_data_create(writer->bytes, writer->length, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+    }
+    else if (writer->length > 0) {
+        chunk = dispatch_data_create(writer->bytes, writer->length, NULL, DISPATCH_DATA_DESTRUCTOR_FREE);
+    }
+    else {
+        free(writer->bytes);
+    }
+    if (chunk) {
+        dispatch_data_t chunks = writer->chunks ? dispatch_data_create_concat((__bridge_transfer dispatch_data_t)writer->chunks, chunk) : chunk;
+        writer->chunks = (__bridge_retained void*)chunks;
+    }
+    writer->bytes = writer->inlineBytes;
+    writer->length = 0;
+    writer->capacity = 0;
+}
+
+NSData *JRPCJSONWriterCopyData(JRPCJSONWriter *writer) {
+    if (writer->chunks) {
+        // dispatch_data_t is an NSData, which is flattened if it is ever asked for its bytes
+        return (NSData*)JRPCJSONWriterCopyDispatchData(writer);
+    }
+    NSData *data = nil;
+    if (writer->bytes == writer->inlineBytes) {
+        data = [[NSData alloc] initWithBytes:writer->bytes length:writer->length];
+    } else {
+        // The NSData takes ownership of the heap buffer
+        data = [[NSData alloc] initWithBytesNoCopy:writer->bytes length:writer->length freeWhenDone:YES];
+    }
+    JRPCJSONWriterInit(writer);
+    return data;
+}
+
+dispatch_data_t JRPCJSONWriterCopyDispatchData(JRPCJSONWriter *writer) {
+    JRPCJSONWriterSealChunk(writer);
+    dispatch_data_t data = writer->chunks ? (__bridge_transfer dispatch_data_t)writer->chunks : dispatch_data_empty;
+    writer->chunks = NULL;
+    JRPCJSONWriterInit(writer);
+    return data;
+}
+
+void JRPCJSONWriterGrow(JRPCJSONWriter *writer, NSUInteger additional) {
+    if (writer->writesChunks) {
+        // The full buffer becomes a chunk as it is, and writing carries on in a new one
+        JRPCJSONWriterSealChunk(writer);
+        NSUInteger capacity = MAX(JRPC_JSON_WRITER_CHUNK_CAPACITY, additional);
+        writer->bytes = malloc(capacity);
+        if (!writer->bytes) {
+            writer->bytes = writer->inlineBytes;
+            [NSException raise:NSMallocException format:@"Failed to allocate JSON chunk of %lu bytes", (unsigned long)capacity];
+        }
+        writer->capacity = capacity;
+        return;
+    }
+    NSUInteger capacity = MAX(writer->capacity * 2, writer->length + additional);
+    uint8_t *bytes = NULL;
+    if (writer->bytes == writer->inlineBytes) {
+        bytes = malloc(capacity);
+        if (bytes) {
+            memcpy(bytes, writer->inlineBytes, writer->length);
+        }
+    } else {
+        bytes = realloc(writer->bytes, capacity);
+    }
+    if (!bytes) {
+        [NSException raise:NSMallocException format:@"Failed to grow JSON buffer to %lu bytes", (unsigned long)capacity];
+    }
+    writer->bytes = bytes;
+    writer->capacity = capacity;
+}
+
+#pragma mark - Scalars
+
+void JRPCJSONWriterAppendBool(JRPCJSONWriter *writer, BOOL value) {
+    if (value) {
+        JRPCJSONWriterAppendBytes(writer, "true", 4);
+    } else {
+        JRPCJSONWriterAppendBytes(writer, "false", 5);
+    }
+}
+
+static const char kJRPCDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+void JRPCJSONWriterAppendUInt64(JRPCJSONWriter *writer, uint64_t value) {
+    // Written backwards two digits at a time, UINT64_MAX has 20 digits
+    char digits[20];
+    char *p = digits + sizeof(digits);
+    while (value >= 100) {
+        const char *pair = &kJRPCDigitPairs[(value % 100) * 2];
+        value /= 100;
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+    }
+    if (value >= 10) {
+        const char *pair = &kJRPCDigitPairs[value * 2];
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    JRPCJSONWriterAppendBytes(writer, p, (NSUInteger)(digits + sizeof(digits) - p));
+}
+
+void JRPCJSONWriterAppendInt64(JRPCJSONWriter *writer, int64_t value) {
+    if (value < 0) {
+        JRPCJSONWriterAppendByte(writer, '-');
+        // Negate as unsigned so INT64_MIN does not overflow
+        JRPCJSONWriterAppendUInt64(writer, (uint64_t)0 - (uint64_t)value);
+    } else {
+        JRPCJSONWriterAppendUInt64(writer, (uint64_t)value);
+    }
+}
+
+// Negative zero keeps its sign and a fraction, since "-0" reads back as the integer 0
+static const char kJRPCNegativeZero[] = "-0.0";
+
+void JRPCJSONWriterAppendDouble(JRPCJSONWriter *writer, double value) {
+    if (0 == value && signbit(value)) {
+        JRPCJSONWriterAppendBytes(writer, kJRPCNegativeZero, sizeof(kJRPCNegativeZero) - 1);
+        return;
+    }
+    // Integral values are written without a fraction or exponent, as NSJSONSerialization does
+    if (fabs(value) < 1e15 && value == trunc(value)) {
+        JRPCJSONWriterAppendInt64(writer, (int64_t)value);
+        return;
+    }
+    // Otherwise use the shortest of 15, 16 or 17 significant digits that parses back to the same value
+    // The C locale (NULL) is used explicitly so the decimal separator is always '.'
+    char text[32];
+    int length = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+        length = snprintf_l(text, sizeof(text), NULL, "%.*g", precision, value);
+        if (17 == precision || strtod_l(text, NULL, NULL) == value) {
+            break;
+        }
+    }
+    JRPCJSONWriterAppendBytes(writer, text, (NSUInteger)length);
+}
+
+void JRPCJSONWriterAppendFloat(JRPCJSONWriter *writer, float value) {
+    if (0 == value && signbit(value)) {
+        JRPCJSONWriterAppendBytes(writer, kJRPCNegativeZero, sizeof(kJRPCNegativeZero) - 1);
+        return;
+    }
+    if (fabsf(value) < 1e7f && value == truncf(value)) {
+        JRPCJSONWriterAppendInt64(writer, (int64_t)value);
+        return;
+    }
+    // As for doubles, but a float needs at most 9 significant digits
+    char text[32];
+    int length = 0;
+    for (int precision = 6; precision <= 9; ++precision) {
+        length = snprintf_l(text, sizeof(text), NULL, "%.*g", precision, (double)value);
+        if (9 == precision || strtof_l(text, NULL, NULL) == value) {
+            break;
+        }
+    }
+    JRPCJSONWriterAppendBytes(writer, text, (NSUInteger)length);
+}
+
+#pragma mark - Numeric arrays
+
+// The longest text of an element and the comma after it, so the whole array can be reserved up front and never grows while it is written
+static NSUInteger JRPCJSONMaxNumericElementLength(char type) {
+    switch (type) {
+        case 's': return 7;     // -32768,
+        case 'i': return 12;    // -2147483648,
+        case 'q': return 21;    // -9223372036854775808,
+        case 'f':               // e.g. -1.17549435e-38,
+        case 'd': return 25;    // e.g. -2.2250738585072014e-308,
+        default: return 0;
+    }
+}
+
+#define JRPC_APPEND_NUMERIC_ELEMENTS(elementType, appendElement) \
+    for (NSUInteger i = 0; i < count; ++i) { \
+        if (i > 0) { \
+            JRPCJSONWriterAppendByte(writer, ','); \
+        } \
+        appendElement(writer, ((const elementType *)values)[i]); \
+    }
+
+// Non-finite elements are checked in one pass first, so the array is never left half written
+#define JRPC_CHECK_FINITE_ELEMENTS(elementType) \
+    for (NSUInteger i = 0; i < count; ++i) { \
+        if (!isfinite(((const elementType *)values)[i])) { \
+            [NSException raise:NSInvalidArgumentException format:@"Invalid number value (NaN or infinity) at index %lu in JSON write", (unsigned long)i]; \
+        } \
+    }
+
+void JRPCJSONWriterAppendNumericArray(JRPCJSONWriter *writer, const void *values, NSUInteger count, char type) {
+    NSUInteger maxElementLength = JRPCJSONMaxNumericElementLength(type);
+    if (0 == maxElementLength) {
+        [NSException raise:NSInvalidArgumentException format:@"Unsupported numeric array type '%c' in JSON write", type];
+    }
+    JRPCJSONWriterReserve(writer, count * maxElementLength + 2);
+    JRPCJSONWriterAppendByte(writer, '[');
+    switch (type) {
+        case 's':
+            JRPC_APPEND_NUMERIC_ELEMENTS(int16_t, JRPCJSONWriterAppendInt64)
+            break;
+        case 'i':
+            JRPC_APPEND_NUMERIC_ELEMENTS(int32_t, JRPCJSONWriterAppendInt64)
+            break;
+        case 'q':
+            JRPC_APPEND_NUMERIC_ELEMENTS(int64_t, JRPCJSONWriterAppendInt64)
+            break;
+        case 'f':
+            JRPC_CHECK_FINITE_ELEMENTS(float)
+            JRPC_APPEND_NUMERIC_ELEMENTS(float, JRPCJSONWriterAppendFloat)
+            break;
+        case 'd':
+            JRPC_CHECK_FINITE_ELEMENTS(double)
+            JRPC_APPEND_NUMERIC_ELEMENTS(double, JRPCJSONWriterAppendDouble)
+            break;
+    }
+    JRPCJSONWriterAppendByte(writer, ']');
+}
+
+#pragma mark - Strings
+
+static const char kJRPCHexDigits[] = "0123456789abcdef";
+
+// Escapes UTF-8 bytes into the writer. Only ASCII is ever escaped, so multi-byte sequences pass through untouched and
+// the input may be split anywhere between code points
+static void JRPCJSONWriterAppendEscapedUTF8(JRPCJSONWriter *writer, const uint8_t *utf8, NSUInteger length) {
+    // Work in chunks so the worst case reservation (every byte written as \u00XX) stays small
+    static const NSUInteger kChunkLength = 256;
+    while (length > 0) {
+        NSUInteger chunkLength = MIN(length, kChunkLength);
+        uint8_t *start = JRPCJSONWriterReserve(writer, chunkLength * 6);
+        uint8_t *out = start;
+        for (NSUInteger i = 0; i < chunkLength; ++i) {
+            uint8_t c = utf8[i];
+            if (c >= 0x20 && '"' != c && '\\' != c && '/' != c) {
+                *out++ = c;
+                continue;
+            }
+            *out++ = '\\';
+            switch (c) {
+                case '"':  *out++ = '"'; break;
+                case '\\': *out++ = '\\'; break;
+                case '/':  *out++ = '/'; break;
+                case '\b': *out++ = 'b'; break;
+                case '\f': *out++ = 'f'; break;
+                case '\n': *out++ = 'n'; break;
+                case '\r': *out++ = 'r'; break;
+                case '\t': *out++ = 't'; break;
+                default:
+                    *out++ = 'u';
+                    *out++ = '0';
+                    *out++ = '0';
+                    *out++ = (uint8_t)kJRPCHexDigits[c >> 4];
+                    *out++ = (uint8_t)kJRPCHexDigits[c & 0xF];
+                    break;
+            }
+        }
+        writer->length += (NSUInteger)(out - start);
+        utf8 += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+void JRPCJSONWriterAppendUTF8String(JRPCJSONWriter *writer, const char *utf8, NSUInteger length) {
+    JRPCJSONWriterAppendByte(writer, '"');
+    JRPCJSONWriterAppendEscapedUTF8(writer, (const uint8_t*)utf8, length);
+    JRPCJSONWriterAppendByte(writer, '"');
+}
+
+void JRPCJSONWriterAppendString(JRPCJSONWriter *writer, NSString *string) {
+    JRPCJSONWriterAppendByte(writer, '"');
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    const char *ascii = CFStringGetCStringPtr(cfString, kCFStringEncodingASCII);
+    if (ascii) {
+        // ASCII strings are stored contiguously, one byte per character
+        JRPCJSONWriterAppendEscapedUTF8(writer, (const uint8_t*)ascii, (NSUInteger)CFStringGetLength(cfString));
+    } else {
+        // Transcode through a small stack buffer, so no intermediate string or data is created
+        uint8_t chunk[256];
+        NSRange remaining = NSMakeRange(0, string.length);
+        while (remaining.length > 0) {
+            NSUInteger used = 0;
+            if (![string getBytes:chunk maxLength:sizeof(chunk) usedLength:&used encoding:NSUTF8StringEncoding
+                          options:NSStringEncodingConversionAllowLossy range:remaining remainingRange:&remaining] || 0 == used) {
+                break;
+            }
+            JRPCJSONWriterAppendEscapedUTF8(writer, chunk, used);
+        }
+    }
+    JRPCJSONWriterAppendByte(writer, '"');
+}
+
+#pragma mark - Objects
+
+static void JRPCJSONWriterAppendNumber(JRPCJSONWriter *writer, NSNumber *number) {
+    CFTypeRef cfNumber = (__bridge CFTypeRef)number;
+    if (kCFBooleanTrue == cfNumber || kCFBooleanFalse == cfNumber) {
+        JRPCJSONWriterAppendBool(writer, kCFBooleanTrue == cfNumber);
+        return;
+    }
+    if (!isfinite(number.doubleValue)) {
+        [NSException raise:NSInvalidArgumentException format:@"Invalid number value (NaN or infinity) in JSON write"];
+    }
+    if ([number isKindOfClass:[NSDecimalNumber class]]) {
+        // Keep every digit of a decimal
+        NSString *decimal = number.stringValue;
+        JRPCJSONWriterAppendBytes(writer, decimal.UTF8String, [decimal lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+        return;
+    }
+    switch (number.objCType[0]) {
+        case 'f':
+        case 'd':
+            JRPCJSONWriterAppendDouble(writer, number.doubleValue);
+            break;
+        case 'Q':
+            JRPCJSONWriterAppendUInt64(writer, number.unsignedLongLongValue);
+            break;
+        default:
+            JRPCJSONWriterAppendInt64(writer, number.longLongValue);
+            break;
+    }
+}
+
+void JRPCJSONWriterAppendObject(JRPCJSONWriter *writer, id obj) {
+    if ([obj isKindOfClass:[NSString class]]) {
+        JRPCJSONWriterAppendString(writer, obj);
+    } else if ([obj isKindOfClass:[NSNumber class]]) {
+        JRPCJSONWriterAppendNumber(writer, obj);
+    } else if ([obj isKindOfClass:[NSNull class]]) {
+        JRPCJSONWriterAppendBytes(writer, "null", 4);
+    } else if ([obj isKindOfClass:[NSArray class]]) {
+        JRPCJSONWriterAppendByte(writer, '[');
+        BOOL first = YES;
+        for (id element in (NSArray*)obj) {
+            if (!first) {
+                JRPCJSONWriterAppendByte(writer, ',');
+            }
+            first = NO;
+            JRPCJSONWriterAppendObject(writer, element);
+        }
+        JRPCJSONWriterAppendByte(writer, ']');
+    } else if ([obj isKindOfClass:[NSDictionary class]]) {
+        JRPCJSONWriterAppendByte(writer, '{');
+        __block BOOL first = YES;
+        void (^appendMember)(id, id, BOOL*) = ^(id key, id value, BOOL *stop) {
+            if (![key isKindOfClass:[NSString class]]) {
+                [NSException raise:NSInvalidArgumentException format:@"Invalid (non-string) key in JSON dictionary, key=%@", key];
+            }
+            if (!first) {
+                JRPCJSONWriterAppendByte(writer, ',');
+            }
+            first = NO;
+            JRPCJSONWriterAppendString(writer, key);
+            JRPCJSONWriterAppendByte(writer, ':');
+            JRPCJSONWriterAppendObject(writer, value);
+        };
+        if (writer->sortsKeys) {
+            NSDictionary *dict = (NSDictionary*)obj;
+            for (id key in [dict.allKeys sortedArrayUsingComparator:^NSComparisonResult(id key1, id key2) {
+                // Non-string keys are left in place, to be rejected by appendMember
+                if (![key1 isKindOfClass:[NSString class]] || ![key2 isKindOfClass:[NSString class]]) {
+                    return NSOrderedSame;
+                }
+                return [(NSString*)key1 compare:key2 options:NSLiteralSearch];
+            }]) {
+                appendMember(key, dict[key], NULL);
+            }
+        } else {
+            [(NSDictionary*)obj enumerateKeysAndObjectsUsingBlock:appendMember];
+        }
+        JRPCJSONWriterAppendByte(writer, '}');
+    } else if (writer->writesData && [obj isKindOfClass:[NSData class]]) {
+        NSData *data = (NSData*)obj;
+        uint8_t *dest = JRPCJSONWriterReserve(writer, 2 * data.length + 2);
+        *dest++ = '<';
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+            for (NSUInteger i = 0; i < byteRange.length; ++i) {
+                uint8_t byte = ((const uint8_t *)bytes)[i];
+                dest[2 * (byteRange.location + i)] = (uint8_t)kJRPCHexDigits[byte >> 4];
+                dest[2 * (byteRange.location + i) + 1] = (uint8_t)kJRPCHexDigits[byte & 0xF];
+            }
+        }];
+        dest[2 * data.length] = '>';
+        writer->length += 2 * data.length + 2;
+    } else {
+        [NSException raise:NSInvalidArgumentException format:@"Invalid type in JSON write (%@)", [obj class]];
+    }
+}
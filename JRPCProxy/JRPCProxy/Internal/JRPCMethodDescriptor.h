@@ -0,0 +1,153 @@
+//
+//  JRPCMethodDescriptor.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import <objc/runtime.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCArgumentPlan.h"
+#import "JRPCCompletionThunk.h"
+#import "JRPCCachePolicy.h"
+#import "JRPCScheduling.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCMethodDescriptor holds everything JRPCAbstractProxy needs to know to map a proxied protocol method onto a JSON-RPC request
+ Descriptors are built once per selector when the proxy is initialized, so none of the selector parsing is repeated on each call.
+ They are immutable after creation apart from the completion block shape, which can only be discovered from the first block passed to the method
+ (protocol metadata only records '@?' for block parameters), and the per-method settings. Those are published atomically and read without locks,
+ so descriptors may be shared between threads.
+ */
+@interface JRPCMethodDescriptor : NSObject
+
+/**
+ Creates a descriptor for a protocol method, validating it against the proxy's naming & type conventions
+ @param methodDesc The protocol method description as returned by the Objective-C runtime
+ @param paramStructure The parameter structure of the JSON-RPC service being proxied
+ @return An initialized descriptor
+ @discussion Raises NSInvalidArgumentException if the method does not follow the conventions described in JRPCAbstractProxy.h, or uses unsupported types
+ */
++ (instancetype) descriptorWithMethodDescription:(struct objc_method_description)methodDesc
+                                  paramStructure:(JRPCParameterStructure)paramStructure;
+
+/** The selector of the proxied protocol method */
+@property (nonatomic, readonly) SEL selector;
+
+/** The method signature of the proxied protocol method, as returned to the runtime from methodSignatureForSelector: */
+@property (nonatomic, readonly) NSMethodSignature *methodSignature;
+
+/** The JSON-RPC method name */
+@property (nonatomic, readonly) NSString *methodName;
+
+/** The JSON-RPC parameter names when using JRPCParameterStructureByName, otherwise nil */
+@property (nonatomic, readonly, nullable) NSArray<NSString*> *paramNames;
+
+/** The number of JSON-RPC parameters i.e. the number of method arguments excluding self, _cmd & the completion block (if any) */
+@property (nonatomic, readonly) NSUInteger paramCount;
+
+/** The index of the completion block in the NSInvocation arguments, NSNotFound for notifications */
+@property (nonatomic, readonly) NSUInteger completionBlockIndex;
+
+/** YES if the method has no completion block, so is sent as a JSON-RPC notification: without an id, and expecting no response */
+@property (nonatomic, readonly) BOOL isNotification;
+
+/** The marshalling plans for the JSON-RPC parameters, paramCount in length. Index 0 is the plan for NSInvocation argument index 2 */
+@property (nonatomic, readonly) const JRPCArgumentPlan *argumentPlans;
+
+/**
+ Marshals the JSON-RPC parameter values from an invocation of the method using the precompiled argument plans
+ @param invocation An invocation of the method
+ @return The parameter values, in the order they appear in the selector
+ */
+- (NSArray*) paramValuesFromInvocation:(NSInvocation*)invocation;
+
+/**
+ Encodes a complete JSON-RPC request for an invocation of the method directly to JSON text
+ The constant parts of the request (version, method name, param names) are pre-encoded when the descriptor is built and each argument
+ is written straight from the invocation by its argument plan, so no request dictionary or boxed values are created
+ @param invocation An invocation of the method
+ @param requestId The JSON-RPC request id, ignored for notifications which have no id
+ @param traceContext The trace context to send as the JRPCTraceContextKey member, or nil to send none
+ @return The UTF-8 encoded JSON-RPC request
+ @discussion Raises NSInvalidArgumentException if an argument value cannot be represented in JSON
+ */
+- (NSData*) requestDataForInvocation:(NSInvocation*)invocation requestId:(NSUInteger)requestId traceContext:(nullable NSString*)traceContext;
+
+/**
+ Encodes the JSON-RPC request for an invocation of the method as dispatch data. See requestDataForInvocation:requestId:traceContext:
+ A request larger than the writer's inline buffer is written in chunks, each a region of the data, so it is never copied to grow it
+ */
+- (dispatch_data_t) requestDispatchDataForInvocation:(NSInvocation*)invocation requestId:(NSUInteger)requestId traceContext:(nullable NSString*)traceContext;
+
+/**
+ Encodes the key used to cache responses to an invocation of the method
+ The key is the JSON-RPC request without its id, with the keys of any dictionary params sorted so that equal params always give the same key
+ @param invocation An invocation of the method
+ @return The cache key
+ @discussion Raises NSInvalidArgumentException if an argument value cannot be represented in JSON
+ */
+- (NSData*) cacheKeyForInvocation:(NSInvocation*)invocation;
+
+/** The policy for caching responses to the method, or nil if they are not cached */
+@property (atomic, strong, nullable) JRPCCachePolicy *cachePolicy;
+
+/** The priority of calls to the method when the proxy limits the calls in flight. Defaults to JRPCCallPriorityDefault */
+@property (atomic, assign) JRPCCallPriority priority;
+
+/** The timeout of calls to the method in seconds, overriding the proxy's default. Negative (the default) to use the proxy's default, 0 for none */
+@property (atomic, assign) NSTimeInterval timeout;
+
+/** The fraction of calls to the method traced, from 0 to 1, overriding the tracer's sampleRate. Negative (the default) to use the tracer's */
+@property (atomic, assign) double traceSampleRate;
+
+/** The number of elements in each chunk passed to a completion block streaming its result in chunks. Defaults to JRPC_DEFAULT_RESULT_CHUNK_SIZE */
+@property (atomic, assign) NSUInteger resultChunkSize;
+
+/** The class the elements of each chunk passed to a completion block streaming its result are transformed to, or Nil (the default) for none */
+@property (atomic, assign, nullable) Class resultElementClass;
+
+/**
+ The thunk used to call the completion block with the result, which holds the parsed completion block shape
+ nil until resolved from the first completion block passed to the method
+ */
+@property (atomic, readonly, nullable) JRPCCompletionThunk *completionThunk;
+
+/**
+ Returns the completion thunk, resolving it from a completion block if it has not been already
+ @param completionBlock A completion block passed to the method
+ @return The thunk. If several threads resolve it at once they all get the same one
+ */
+- (JRPCCompletionThunk*) completionThunkForCompletionBlock:(id)completionBlock;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
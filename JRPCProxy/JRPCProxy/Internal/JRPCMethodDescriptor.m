@@ -0,0 +1,325 @@
+//
+//  JRPCMethodDescriptor.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCMethodDescriptor.h"
+#import "JRPCAtomicReference.h"
+#import "NSDictionary+JSONRPC.h"
+#import "JRPCTracer.h"
+
+static const NSString * const kJSONRPCVersion = @"2.0";
+
+// The Objective-C runtime type encoding for a block parameter
+static const char * const kJRPCBlockTypeEncoding = "@?";
+
+// Methods with up to this many params marshal their values on the stack
+#define JRPC_MAX_INLINE_PARAMS 16
+
+@interface JRPCMethodDescriptor() {
+    // Read on every call, so without the lock an atomic property takes
+    JRPCAtomicReference _cachePolicy;
+    JRPCAtomicReference _completionThunk;
+}
+@property (nonatomic, assign) SEL selector;
+@property (nonatomic, strong) NSMethodSignature *methodSignature;
+@property (nonatomic, copy) NSString *methodName;
+@property (nonatomic, copy) NSArray<NSString*> *paramNames;
+@property (nonatomic, assign) NSUInteger paramCount;
+@property (nonatomic, assign) NSUInteger completionBlockIndex;
+@property (nonatomic, assign) BOOL isNotification;
+// Pre-encoded JSON text for the constant parts of a request: {"jsonrpc":"2.0","method":"<methodName>"[,"params":[ or {]
+@property (nonatomic, strong) NSData *requestPrefix;
+// Backing storage for the argument plan prefixes
+@property (nonatomic, strong) NSData *paramPrefixes;
+// Pre-encoded JSON text following the params: [] or }],"id": for requests, [] or }] for notifications. The closing brace is written per request
+@property (nonatomic, strong) NSData *requestSuffix;
+@end
+
+@implementation JRPCMethodDescriptor
+
++ (instancetype) descriptorWithMethodDescription:(struct objc_method_description)methodDesc
+                                  paramStructure:(JRPCParameterStructure)paramStructure {
+    return [[self alloc] initWithMethodDescription:methodDesc paramStructure:paramStructure];
+}
+
+- (instancetype) initWithMethodDescription:(struct objc_method_description)methodDesc
+                            paramStructure:(JRPCParameterStructure)paramStructure {
+    self = [super init];
+    if (self) {
+        JRPCAtomicReferenceInit(&_cachePolicy);
+        JRPCAtomicReferenceInit(&_completionThunk);
+        NSString *selStr = NSStringFromSelector(methodDesc.name);
+        NSMethodSignature *sig = [NSMethodSignature signatureWithObjCTypes:methodDesc.types];
+        // Since JSON-RPC is async by nature, the return type of proxied methods should ALWAYS be void
+        if (0 != strcmp(sig.methodReturnType, @encode(void))) {
+            [NSException raise:NSInvalidArgumentException format:@"Proxied selector: %@ MUST return void", selStr];
+        }
+        // first arg is self, second arg is SEL (_cmd), last arg is completion block
+        // Methods without a completion block are JSON-RPC notifications, which have no response
+        BOOL isNotification = (sig.numberOfArguments < 3 || 0 != strcmp([sig getArgumentTypeAtIndex:sig.numberOfArguments - 1], kJRPCBlockTypeEncoding));
+        NSUInteger completionBlockIndex = isNotification ? NSNotFound : sig.numberOfArguments - 1;
+        // Validate the parameter type encodings, compiling the plan for marshalling each one
+        NSUInteger paramCount = (isNotification ? sig.numberOfArguments : completionBlockIndex) - 2;
+        JRPCArgumentPlan *argumentPlans = calloc(MAX(paramCount, 1), sizeof(JRPCArgumentPlan));
+        _argumentPlans = argumentPlans;
+        for (NSUInteger i = 0; i < paramCount; ++i) {
+            const char *argTypeEncoding = [sig getArgumentTypeAtIndex:i + 2];
+            if (!JRPCArgumentPlanForTypeEncoding(argTypeEncoding, &argumentPlans[i])) {
+                [NSException raise:NSInvalidArgumentException format:@"Unsupported param type encoding %s for param at index %li of selector: %@", argTypeEncoding, (long)i, selStr];
+            }
+        }
+        // Extract method and param names from selector
+        NSMutableArray<NSString*> *selComps = [[selStr componentsSeparatedByString:@":"] mutableCopy];
+        if (paramCount > 0 || !isNotification) {
+            // We expect >= TWO elements in the array, with the last an empty string, since a selector string with >= 1 param should always end with a colon ':'
+            NSAssert(selComps.lastObject.length == 0, @"Selector parse error, SEL does not end in colon: %@", selStr);
+            [selComps removeLastObject];    // Ditch the trailing empty string
+        }
+        NSString *methodName = nil;
+        NSArray<NSString*> *paramNames = nil;
+        if (0 == paramCount && isNotification) {
+            // A notification without params has a selector without a colon, the whole selector is the method name
+            methodName = selStr;
+            paramNames = (JRPCParameterStructureByName == paramStructure) ? @[] : nil;
+        }
+        else if (JRPCParameterStructureByName == paramStructure) {
+            // Parse out method name from first component of selector. i.e <methodName>With<Param1Name>:
+            NSString *selFirstComp = selComps[0];
+            NSRange rangeOfWith = [selFirstComp rangeOfString:@"With"];
+            if (NSNotFound == rangeOfWith.location) {
+                [NSException raise:NSInvalidArgumentException format:@"Selector: %@ does not match JSON-RPC params by-name naming convention: <methodName>With<ParamName>...", selStr];
+            }
+            methodName = [selFirstComp substringToIndex:rangeOfWith.location];
+            if (!isNotification) {
+                // Drop the last parameter, it's the completion block which does not participate in JSON-RPC
+                [selComps removeLastObject];
+            }
+            if (selComps.count > 0) {
+                // replace first param name with the part following 'With' so that selComps is now the parameter list
+                NSString *firstParamName = [selFirstComp substringFromIndex:rangeOfWith.location + rangeOfWith.length];
+                // convert first char of firstParamName to lower case
+                if (firstParamName.length < 2) {
+                    firstParamName = [firstParamName lowercaseString];
+                } else {
+                    firstParamName = [NSString stringWithFormat:@"%@%@", [[firstParamName substringToIndex:1] lowercaseString], [firstParamName substringFromIndex:1]];
+                }
+                selComps[0] = firstParamName;
+            }
+            NSAssert(selComps.count == paramCount, @"Param name/type mismatch for selector: %@", selStr);
+            // Deep copy so that the names are immutable, and shared by every request for this method
+            paramNames = [[NSArray alloc] initWithArray:selComps copyItems:YES];
+        }
+        else {
+            // By-Position: method name is entire first component of the selector. 'doSomethingWithCompletion:' is NOT supported, should be simply 'doSomething:'
+            methodName = selComps[0];
+        }
+        self.selector = methodDesc.name;
+        self.methodSignature = sig;
+        self.methodName = methodName;
+        self.paramNames = paramNames;
+        self.paramCount = paramCount;
+        self.completionBlockIndex = completionBlockIndex;
+        self.isNotification = isNotification;
+        self.timeout = -1.0;
+        self.traceSampleRate = -1.0;
+        self.resultChunkSize = JRPC_DEFAULT_RESULT_CHUNK_SIZE;
+        self.priority = JRPCCallPriorityDefault;
+        [self prepareRequestEncodingWithPlans:argumentPlans];
+    }
+    return self;
+}
+
+- (void) prepareRequestEncodingWithPlans:(JRPCArgumentPlan*)argumentPlans {
+    BOOL byName = (nil != self.paramNames);
+    BOOL hasParams = (self.paramCount > 0);
+    JRPCJSONWriter writer;
+    // Request prefix
+    JRPCJSONWriterInit(&writer);
+    JRPCJSONWriterAppendByte(&writer, '{');
+    JRPCJSONWriterAppendString(&writer, (NSString*)kJSONRPCVersionKey);
+    JRPCJSONWriterAppendByte(&writer, ':');
+    JRPCJSONWriterAppendString(&writer, (NSString*)kJSONRPCVersion);
+    JRPCJSONWriterAppendByte(&writer, ',');
+    JRPCJSONWriterAppendString(&writer, (NSString*)kJSONRPCMethodKey);
+    JRPCJSONWriterAppendByte(&writer, ':');
+    JRPCJSONWriterAppendString(&writer, self.methodName);
+    if (hasParams) {
+        JRPCJSONWriterAppendByte(&writer, ',');
+        JRPCJSONWriterAppendString(&writer, (NSString*)kJSONRPCParamsKey);
+        JRPCJSONWriterAppendByte(&writer, ':');
+        JRPCJSONWriterAppendByte(&writer, byName ? '{' : '[');
+    }
+    self.requestPrefix = JRPCJSONWriterCopyData(&writer);
+    // Param prefixes, all written into one buffer then pointed at by the plans
+    NSUInteger *offsets = calloc(self.paramCount + 1, sizeof(NSUInteger));
+    for (NSUInteger i = 0; i < self.paramCount; ++i) {
+        offsets[i] = writer.length;
+        if (i > 0) {
+            JRPCJSONWriterAppendByte(&writer, ',');
+        }
+        if (byName) {
+            JRPCJSONWriterAppendString(&writer, self.paramNames[i]);
+            JRPCJSONWriterAppendByte(&writer, ':');
+        }
+    }
+    offsets[self.paramCount] = writer.length;
+    self.paramPrefixes = JRPCJSONWriterCopyData(&writer);
+    const char *paramPrefixBytes = self.paramPrefixes.bytes;
+    for (NSUInteger i = 0; i < self.paramCount; ++i) {
+        argumentPlans[i].prefix = paramPrefixBytes + offsets[i];
+        argumentPlans[i].prefixLength = offsets[i + 1] - offsets[i];
+    }
+    free(offsets);
+    // Request suffix, the id value, any trace context and the closing brace are written per request. Notifications have no id
+    if (hasParams) {
+        JRPCJSONWriterAppendByte(&writer, byName ? '}' : ']');
+    }
+    if (!self.isNotification) {
+        JRPCJSONWriterAppendByte(&writer, ',');
+        JRPCJSONWriterAppendString(&writer, (NSString*)kJSONRPCRequestIdKey);
+        JRPCJSONWriterAppendByte(&writer, ':');
+    }
+    self.requestSuffix = JRPCJSONWriterCopyData(&writer);
+}
+
+- (void) dealloc {
+    free((void*)_argumentPlans);
+    JRPCAtomicReferenceDestroy(&_cachePolicy);
+    JRPCAtomicReferenceDestroy(&_completionThunk);
+}
+
+- (JRPCCachePolicy*) cachePolicy {
+    return JRPCAtomicReferenceLoad(&_cachePolicy);
+}
+
+- (void) setCachePolicy:(JRPCCachePolicy*)cachePolicy {
+    JRPCAtomicReferenceStore(&_cachePolicy, cachePolicy);
+}
+
+- (JRPCCompletionThunk*) completionThunk {
+    return JRPCAtomicReferenceLoad(&_completionThunk);
+}
+
+- (JRPCCompletionThunk*) completionThunkForCompletionBlock:(id)completionBlock {
+    JRPCCompletionThunk *thunk = JRPCAtomicReferenceLoad(&_completionThunk);
+    if (!thunk) {
+        thunk = JRPCAtomicReferenceStoreIfNil(&_completionThunk, [JRPCCompletionThunk thunkForCompletionBlock:completionBlock]);
+    }
+    return thunk;
+}
+
+- (NSArray*) paramValuesFromInvocation:(NSInvocation*)invocation {
+    // first arg is self, second arg is SEL (_cmd), last arg is completion block (if any)
+    NSUInteger paramCount = self.paramCount;
+    const JRPCArgumentPlan *argumentPlans = self.argumentPlans;
+    if (paramCount <= JRPC_MAX_INLINE_PARAMS) {
+        __strong id paramValues[JRPC_MAX_INLINE_PARAMS];
+        for (NSUInteger i = 0; i < paramCount; ++i) {
+            paramValues[i] = argumentPlans[i].extractor(invocation, (NSInteger)i + 2);
+        }
+        return [[NSArray alloc] initWithObjects:paramValues count:paramCount];
+    }
+    NSMutableArray *paramValues = [[NSMutableArray alloc] initWithCapacity:paramCount];
+    for (NSUInteger i = 0; i < paramCount; ++i) {
+        [paramValues addObject:argumentPlans[i].extractor(invocation, (NSInteger)i + 2)];
+    }
+    return [paramValues copy];  // copy strips mutability
+}
+
+- (NSData*) requestDataForInvocation:(NSInvocation*)invocation requestId:(NSUInteger)requestId traceContext:(NSString*)traceContext {
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    [self writeRequestForInvocation:invocation requestId:requestId traceContext:traceContext writer:&writer];
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+- (dispatch_data_t) requestDispatchDataForInvocation:(NSInvocation*)invocation requestId:(NSUInteger)requestId traceContext:(NSString*)traceContext {
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    // A large request is written in chunks, rather than copied each time the buffer grows
+    writer.writesChunks = YES;
+    [self writeRequestForInvocation:invocation requestId:requestId traceContext:traceContext writer:&writer];
+    return JRPCJSONWriterCopyDispatchData(&writer);
+}
+
+- (void) writeRequestForInvocation:(NSInvocation*)invocation
+                         requestId:(NSUInteger)requestId
+                      traceContext:(NSString*)traceContext
+                            writer:(JRPCJSONWriter*)writer {
+    NSData *requestPrefix = self.requestPrefix;
+    NSData *requestSuffix = self.requestSuffix;
+    NSUInteger paramCount = self.paramCount;
+    const JRPCArgumentPlan *argumentPlans = self.argumentPlans;
+    @try {
+        JRPCJSONWriterAppendBytes(writer, requestPrefix.bytes, requestPrefix.length);
+        for (NSUInteger i = 0; i < paramCount; ++i) {
+            JRPCJSONWriterAppendBytes(writer, argumentPlans[i].prefix, argumentPlans[i].prefixLength);
+            argumentPlans[i].encoder(writer, invocation, (NSInteger)i + 2);
+        }
+        JRPCJSONWriterAppendBytes(writer, requestSuffix.bytes, requestSuffix.length);
+        if (!self.isNotification) {
+            JRPCJSONWriterAppendUInt64(writer, requestId);
+        }
+        if (traceContext) {
+            JRPCJSONWriterAppendByte(writer, ',');
+            JRPCJSONWriterAppendString(writer, JRPCTraceContextKey);
+            JRPCJSONWriterAppendByte(writer, ':');
+            JRPCJSONWriterAppendString(writer, traceContext);
+        }
+        JRPCJSONWriterAppendByte(writer, '}');
+    }
+    @catch (NSException *exception) {
+        JRPCJSONWriterDestroy(writer);
+        @throw;
+    }
+}
+
+- (NSData*) cacheKeyForInvocation:(NSInvocation*)invocation {
+    NSData *requestPrefix = self.requestPrefix;
+    NSUInteger paramCount = self.paramCount;
+    const JRPCArgumentPlan *argumentPlans = self.argumentPlans;
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    writer.sortsKeys = YES;
+    writer.writesData = YES;
+    @try {
+        // The params are self delimiting, so no suffix is needed
+        JRPCJSONWriterAppendBytes(&writer, requestPrefix.bytes, requestPrefix.length);
+        for (NSUInteger i = 0; i < paramCount; ++i) {
+            JRPCJSONWriterAppendBytes(&writer, argumentPlans[i].prefix, argumentPlans[i].prefixLength);
+            argumentPlans[i].encoder(&writer, invocation, (NSInteger)i + 2);
+        }
+    }
+    @catch (NSException *exception) {
+        JRPCJSONWriterDestroy(&writer);
+        @throw;
+    }
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+@end
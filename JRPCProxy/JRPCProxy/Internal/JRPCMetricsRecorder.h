@@ -0,0 +1,103 @@
+//
+//  JRPCMetricsRecorder.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCMetrics.h"
+#import "JRPCHistogram.h"
+#import "JRPCMethodDescriptor.h"
+#import "JRPCPendingRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCMetricsRecorder holds the metrics of a JRPCAbstractProxy: a latency histogram per method & per phase, and counters of errors, bytes & calls in flight.
+ Everything is recorded without locks, from whichever thread the call is on. The proxy passes a nil recorder when metrics are disabled,
+ so that every message below is a no-op and the only cost to a call is deciding which recorder to use
+ */
+@interface JRPCMetricsRecorder : NSObject
+
+/**
+ Creates a recorder
+ @param methodDescriptors The descriptors of the methods calls may be made to. Calls to methods with the same JSON-RPC method name share a histogram
+ @return An initialized recorder
+ */
+- (instancetype) initWithMethodDescriptors:(NSArray<JRPCMethodDescriptor*>*)methodDescriptors NS_DESIGNATED_INITIALIZER;
+
+/**
+ Records the time spent in a phase of a call or batch
+ @param phase The phase
+ @param startTime When the phase started, from JRPCHistogramNow()
+ */
+- (void) recordPhase:(JRPCMetricsPhase)phase sinceTime:(uint64_t)startTime;
+
+/** Counts a call as in flight, from when it is made. Its callTime must be set */
+- (void) beginRequest:(JRPCPendingRequest*)request;
+
+/** Records the latency of a call, and counts it as no longer in flight. Called once, just before its completion block */
+- (void) endRequest:(JRPCPendingRequest*)request;
+
+/** Counts an error a call completed with, if it is in JRPCErrorDomain. nil is ignored */
+- (void) recordError:(nullable NSError*)error;
+
+/** Counts the bytes of an encoded request, batch or notification passed to the transport. Request objects, for transports that perform serialization, are ignored */
+- (void) recordSentPayload:(nullable id)payload;
+
+/** Counts the bytes of an encoded response passed back by the transport */
+- (void) recordReceivedData:(nullable NSData*)data;
+
+/** Returns the metrics recorded so far */
+- (JRPCMetricsSnapshot*) snapshot;
+
+/** Discards the metrics recorded so far, except the calls in flight */
+- (void) reset;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/** Returns the start time of a phase to time with recorder, or 0 without calling the clock if recorder is nil */
+NS_INLINE uint64_t JRPCMetricsStartTime(JRPCMetricsRecorder * _Nullable recorder) {
+    return recorder ? JRPCHistogramNow() : 0;
+}
+
+@interface JRPCMetricsSnapshot()
+
+/** Creates a snapshot. Used by JRPCMetricsRecorder */
+- (instancetype) initWithMethodLatencies:(NSDictionary<NSString*, JRPCHistogramSnapshot*>*)methodLatencies
+                          phaseLatencies:(NSArray<JRPCHistogramSnapshot*>*)phaseLatencies
+                             errorCounts:(NSDictionary<NSNumber*, NSNumber*>*)errorCounts
+                               bytesSent:(uint64_t)bytesSent
+                           bytesReceived:(uint64_t)bytesReceived
+                           callsInFlight:(NSUInteger)callsInFlight NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
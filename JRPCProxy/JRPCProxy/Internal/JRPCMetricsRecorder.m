@@ -0,0 +1,193 @@
+//
+//  JRPCMetricsRecorder.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCMetricsRecorder.h"
+#import "JRPCError.h"
+#import <stdatomic.h>
+
+// JRPCErrorDomain codes are counted in an array, from the first
+#define JRPC_METRICS_FIRST_ERROR_CODE JRPCErrorRequestSerializationCode
+#define JRPC_METRICS_ERROR_CODE_COUNT (JRPCErrorCancelledCode - JRPCErrorRequestSerializationCode + 1)
+
+@implementation JRPCMetricsRecorder {
+    // Histogram of each method keyed by descriptor, not retaining the keys. Immutable after init, so read without locks
+    CFDictionaryRef _methodHistograms;
+    NSDictionary<NSString*, JRPCHistogram*> *_methodHistogramsByName;
+    NSArray<JRPCHistogram*> *_phaseHistograms;
+    _Atomic(uint64_t) _errorCounts[JRPC_METRICS_ERROR_CODE_COUNT];
+    _Atomic(uint64_t) _bytesSent;
+    _Atomic(uint64_t) _bytesReceived;
+    _Atomic(NSInteger) _callsInFlight;
+}
+
+- (instancetype) initWithMethodDescriptors:(NSArray<JRPCMethodDescriptor*>*)methodDescriptors {
+    self = [super init];
+    if (self) {
+        CFMutableDictionaryRef methodHistograms = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        NSMutableDictionary<NSString*, JRPCHistogram*> *methodHistogramsByName = [[NSMutableDictionary alloc] init];
+        for (JRPCMethodDescriptor *descriptor in methodDescriptors) {
+            if (descriptor.isNotification) {
+                // Notifications never complete, so have no latency
+                continue;
+            }
+            JRPCHistogram *histogram = methodHistogramsByName[descriptor.methodName];
+            if (!histogram) {
+                histogram = [[JRPCHistogram alloc] init];
+                methodHistogramsByName[descriptor.methodName] = histogram;
+            }
+            CFDictionarySetValue(methodHistograms, (__bridge const void *)descriptor, (__bridge const void *)histogram);
+        }
+        _methodHistograms = CFDictionaryCreateCopy(kCFAllocatorDefault, methodHistograms);
+        CFRelease(methodHistograms);
+        _methodHistogramsByName = [methodHistogramsByName copy];
+        NSMutableArray<JRPCHistogram*> *phaseHistograms = [[NSMutableArray alloc] initWithCapacity:JRPC_METRICS_PHASE_COUNT];
+        for (NSUInteger i = 0; i < JRPC_METRICS_PHASE_COUNT; ++i) {
+            [phaseHistograms addObject:[[JRPCHistogram alloc] init]];
+        }
+        _phaseHistograms = [phaseHistograms copy];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    CFRelease(_methodHistograms);
+}
+
+- (void) recordPhase:(JRPCMetricsPhase)phase sinceTime:(uint64_t)startTime {
+    [_phaseHistograms[phase] recordSinceTime:startTime];
+}
+
+- (void) beginRequest:(JRPCPendingRequest*)request {
+    atomic_fetch_add_explicit(&_callsInFlight, 1, memory_order_relaxed);
+}
+
+- (void) endRequest:(JRPCPendingRequest*)request {
+    atomic_fetch_sub_explicit(&_callsInFlight, 1, memory_order_relaxed);
+    JRPCHistogram *histogram = (__bridge JRPCHistogram*)CFDictionaryGetValue(_methodHistograms, (__bridge const void *)request.descriptor);
+    [histogram recordSinceTime:request.callTime];
+}
+
+- (void) recordError:(NSError*)error {
+    if (![JRPCErrorDomain isEqualToString:error.domain]) {
+        return;
+    }
+    NSInteger index = error.code - JRPC_METRICS_FIRST_ERROR_CODE;
+    if (index >= 0 && index < JRPC_METRICS_ERROR_CODE_COUNT) {
+        atomic_fetch_add_explicit(&_errorCounts[index], 1, memory_order_relaxed);
+    }
+}
+
+- (void) recordSentPayload:(id)payload {
+    if ([payload isKindOfClass:[NSData class]]) {
+        atomic_fetch_add_explicit(&_bytesSent, [(NSData*)payload length], memory_order_relaxed);
+    }
+}
+
+- (void) recordReceivedData:(NSData*)data {
+    atomic_fetch_add_explicit(&_bytesReceived, data.length, memory_order_relaxed);
+}
+
+- (JRPCMetricsSnapshot*) snapshot {
+    NSMutableDictionary<NSString*, JRPCHistogramSnapshot*> *methodLatencies = [[NSMutableDictionary alloc] initWithCapacity:_methodHistogramsByName.count];
+    [_methodHistogramsByName enumerateKeysAndObjectsUsingBlock:^(NSString *methodName, JRPCHistogram *histogram, BOOL *stop) {
+        methodLatencies[methodName] = [histogram snapshot];
+    }];
+    NSMutableArray<JRPCHistogramSnapshot*> *phaseLatencies = [[NSMutableArray alloc] initWithCapacity:JRPC_METRICS_PHASE_COUNT];
+    for (JRPCHistogram *histogram in _phaseHistograms) {
+        [phaseLatencies addObject:[histogram snapshot]];
+    }
+    NSMutableDictionary<NSNumber*, NSNumber*> *errorCounts = [[NSMutableDictionary alloc] init];
+    for (NSInteger i = 0; i < JRPC_METRICS_ERROR_CODE_COUNT; ++i) {
+        uint64_t errorCount = atomic_load_explicit(&_errorCounts[i], memory_order_relaxed);
+        if (errorCount > 0) {
+            errorCounts[@(JRPC_METRICS_FIRST_ERROR_CODE + i)] = @(errorCount);
+        }
+    }
+    // A call may end on one thread before another has counted it beginning
+    NSInteger callsInFlight = atomic_load_explicit(&_callsInFlight, memory_order_relaxed);
+    return [[JRPCMetricsSnapshot alloc] initWithMethodLatencies:[methodLatencies copy]
+                                                 phaseLatencies:[phaseLatencies copy]
+                                                    errorCounts:[errorCounts copy]
+                                                      bytesSent:atomic_load_explicit(&_bytesSent, memory_order_relaxed)
+                                                  bytesReceived:atomic_load_explicit(&_bytesReceived, memory_order_relaxed)
+                                                  callsInFlight:(NSUInteger)MAX(callsInFlight, 0)];
+}
+
+- (void) reset {
+    for (JRPCHistogram *histogram in _methodHistogramsByName.allValues) {
+        [histogram reset];
+    }
+    for (JRPCHistogram *histogram in _phaseHistograms) {
+        [histogram reset];
+    }
+    for (NSUInteger i = 0; i < JRPC_METRICS_ERROR_CODE_COUNT; ++i) {
+        atomic_store_explicit(&_errorCounts[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&_bytesSent, 0, memory_order_relaxed);
+    atomic_store_explicit(&_bytesReceived, 0, memory_order_relaxed);
+}
+
+@end
+
+@implementation JRPCMetricsSnapshot {
+    NSArray<JRPCHistogramSnapshot*> *_phaseLatencies;
+}
+
+- (instancetype) initWithMethodLatencies:(NSDictionary<NSString*, JRPCHistogramSnapshot*>*)methodLatencies
+                          phaseLatencies:(NSArray<JRPCHistogramSnapshot*>*)phaseLatencies
+                             errorCounts:(NSDictionary<NSNumber*, NSNumber*>*)errorCounts
+                               bytesSent:(uint64_t)bytesSent
+                           bytesReceived:(uint64_t)bytesReceived
+                           callsInFlight:(NSUInteger)callsInFlight {
+    self = [super init];
+    if (self) {
+        _methodLatencies = methodLatencies;
+        _phaseLatencies = phaseLatencies;
+        _errorCounts = errorCounts;
+        _bytesSent = bytesSent;
+        _bytesReceived = bytesReceived;
+        _callsInFlight = callsInFlight;
+    }
+    return self;
+}
+
+- (JRPCHistogramSnapshot*) latencyForPhase:(JRPCMetricsPhase)phase {
+    if (phase < 0 || phase >= JRPC_METRICS_PHASE_COUNT) {
+        [NSException raise:NSInvalidArgumentException format:@"%ld is not a JRPCMetricsPhase", (long)phase];
+    }
+    return _phaseLatencies[phase];
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"<%@: methodLatencies=%@ errorCounts=%@ bytesSent=%llu bytesReceived=%llu callsInFlight=%lu>", NSStringFromClass([self class]),
+            self.methodLatencies, self.errorCounts, self.bytesSent, self.bytesReceived, (unsigned long)self.callsInFlight];
+}
+
+@end
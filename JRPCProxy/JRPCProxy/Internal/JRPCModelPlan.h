@@ -0,0 +1,127 @@
+//
+//  JRPCModelPlan.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import <objc/runtime.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** How the value of a model property is converted to & from JSON */
+typedef NS_ENUM(uint8_t, JRPCModelValueKind) {
+    /** A primitive, from & to NSNumber. See getter & setter */
+    JRPCModelValueKindPrimitive = 0,
+    /** Any other object, passed as it is if it is of the declared class, and represented as a param would be */
+    JRPCModelValueKindObject,
+    /** A model, mapped with its own plan */
+    JRPCModelValueKindModel,
+    /** A class implementing initWithJSONRPCResponseResult: (see JRPCTransformable) */
+    JRPCModelValueKindTransformable,
+    /** An array whose elements are of elementKind */
+    JRPCModelValueKindArray
+};
+
+typedef struct JRPCModelProperty JRPCModelProperty;
+
+/** Reads a primitive property, boxed in NSNumber */
+typedef NSNumber * _Nonnull (*JRPCModelPrimitiveGetter)(id model, const JRPCModelProperty *property);
+
+/** Sets a primitive property from an NSNumber */
+typedef void (*JRPCModelPrimitiveSetter)(id model, const JRPCModelProperty *property, NSNumber *value);
+
+/**
+ JRPCModelProperty is the precompiled plan for mapping a single property of a model class. Properties backed by an instance variable are read &
+ written straight through it, even if readonly, and others through their accessors
+ */
+struct JRPCModelProperty {
+    /** The key of the property in JSON objects. Owned by the plan */
+    __unsafe_unretained NSString *key;
+    JRPCModelValueKind kind;
+    /** The offset of the backing instance variable, or -1 to use the accessors */
+    ptrdiff_t ivarOffset;
+    /** The backing instance variable, or NULL */
+    Ivar _Nullable ivar;
+    SEL getter;
+    /** NULL if the property is readonly and not backed by an instance variable */
+    SEL _Nullable setter;
+    /** The functions specialised for the primitive type, for JRPCModelValueKindPrimitive */
+    JRPCModelPrimitiveGetter _Nullable getPrimitive;
+    JRPCModelPrimitiveSetter _Nullable setPrimitive;
+    /** The declared class of an object property, or Nil for id */
+    __unsafe_unretained Class _Nullable cls;
+    /** YES if the property copies its value */
+    BOOL copies;
+    /** For JRPCModelValueKindArray, how elements are converted, and their class (see jsonRPCElementClassesByPropertyName) */
+    JRPCModelValueKind elementKind;
+    __unsafe_unretained Class _Nullable elementClass;
+};
+
+/**
+ JRPCModelPlan is the precompiled plan for mapping a model class (see JRPCModel.h) to & from JSON objects. Each class's properties are
+ introspected once, the first time it is mapped, and the plan shared by every mapping of the class after that
+ */
+@interface JRPCModelPlan : NSObject
+
+/**
+ Returns the plan for a model class
+ @param modelClass A class conforming to JRPCModelMapping
+ @return The plan, built on the first call for the class and cached after that
+ */
++ (JRPCModelPlan*) planForClass:(Class)modelClass;
+
+/** YES if instances of the class are mapped with a plan, i.e. it conforms to JRPCModelMapping */
++ (BOOL) isModelClass:(Class)cls;
+
+/** The model class */
+@property (nonatomic, readonly) Class modelClass;
+
+/** The number of properties mapped */
+@property (nonatomic, readonly) NSUInteger propertyCount;
+
+/** The property plans, propertyCount in length */
+@property (nonatomic, readonly) const JRPCModelProperty *properties;
+
+/**
+ Sets the properties of a model from the members of a JSON object. Members without a property, and properties without a member, are ignored
+ @return NO if a member cannot be converted to its property's type
+ */
+- (BOOL) fillModel:(id)model withJSONObject:(NSDictionary*)jsonObject;
+
+/** Creates and fills a new model, or returns nil if jsonObject is not an object or cannot be converted */
+- (nullable id) newModelWithJSONObject:(id)jsonObject;
+
+/** Returns the JSON object representation of a model. Properties that are nil are omitted */
+- (NSDictionary*) JSONObjectWithModel:(id)model;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
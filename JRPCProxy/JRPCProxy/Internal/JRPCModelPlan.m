@@ -0,0 +1,449 @@
+//
+//  JRPCModelPlan.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCModelPlan.h"
+#import "JRPCModel.h"
+#import "JRPCArgumentPlan.h"
+#import "JRPCTransformable.h"
+#import <objc/message.h>
+#import <stdatomic.h>
+
+#pragma mark - Primitives
+
+// Primitives are read & written in place when backed by an instance variable, otherwise through their accessors
+#define JRPC_MODEL_PRIMITIVE(name, type, accessor) \
+static NSNumber *JRPCModelGet##name(id model, const JRPCModelProperty *property) { \
+    type value = (property->ivarOffset >= 0) ? \
+        *(type *)((uint8_t *)(__bridge void *)model + property->ivarOffset) : \
+        ((type (*)(id, SEL))objc_msgSend)(model, property->getter); \
+    return @(value); \
+} \
+static void JRPCModelSet##name(id model, const JRPCModelProperty *property, NSNumber *number) { \
+    type value = [number accessor]; \
+    if (property->ivarOffset >= 0) { \
+        *(type *)((uint8_t *)(__bridge void *)model + property->ivarOffset) = value; \
+    } \
+    else { \
+        ((void (*)(id, SEL, type))objc_msgSend)(model, property->setter, value); \
+    } \
+}
+
+JRPC_MODEL_PRIMITIVE(Bool, _Bool, boolValue)
+JRPC_MODEL_PRIMITIVE(Char, char, charValue)
+JRPC_MODEL_PRIMITIVE(Int, int, intValue)
+JRPC_MODEL_PRIMITIVE(Short, short, shortValue)
+JRPC_MODEL_PRIMITIVE(Long, long, longValue)
+JRPC_MODEL_PRIMITIVE(LongLong, long long, longLongValue)
+JRPC_MODEL_PRIMITIVE(UnsignedChar, unsigned char, unsignedCharValue)
+JRPC_MODEL_PRIMITIVE(UnsignedInt, unsigned int, unsignedIntValue)
+JRPC_MODEL_PRIMITIVE(UnsignedShort, unsigned short, unsignedShortValue)
+JRPC_MODEL_PRIMITIVE(UnsignedLong, unsigned long, unsignedLongValue)
+JRPC_MODEL_PRIMITIVE(UnsignedLongLong, unsigned long long, unsignedLongLongValue)
+JRPC_MODEL_PRIMITIVE(Float, float, floatValue)
+JRPC_MODEL_PRIMITIVE(Double, double, doubleValue)
+
+static BOOL JRPCModelPrimitiveForTypeEncoding(char typeEncoding, JRPCModelPrimitiveGetter *getter, JRPCModelPrimitiveSetter *setter) {
+    switch (typeEncoding) {
+        case 'B': *getter = JRPCModelGetBool; *setter = JRPCModelSetBool; break;
+        case 'c': *getter = JRPCModelGetChar; *setter = JRPCModelSetChar; break;
+        case 'i': *getter = JRPCModelGetInt; *setter = JRPCModelSetInt; break;
+        case 's': *getter = JRPCModelGetShort; *setter = JRPCModelSetShort; break;
+        case 'l': *getter = JRPCModelGetLong; *setter = JRPCModelSetLong; break;
+        case 'q': *getter = JRPCModelGetLongLong; *setter = JRPCModelSetLongLong; break;
+        case 'C': *getter = JRPCModelGetUnsignedChar; *setter = JRPCModelSetUnsignedChar; break;
+        case 'I': *getter = JRPCModelGetUnsignedInt; *setter = JRPCModelSetUnsignedInt; break;
+        case 'S': *getter = JRPCModelGetUnsignedShort; *setter = JRPCModelSetUnsignedShort; break;
+        case 'L': *getter = JRPCModelGetUnsignedLong; *setter = JRPCModelSetUnsignedLong; break;
+        case 'Q': *getter = JRPCModelGetUnsignedLongLong; *setter = JRPCModelSetUnsignedLongLong; break;
+        case 'f': *getter = JRPCModelGetFloat; *setter = JRPCModelSetFloat; break;
+        case 'd': *getter = JRPCModelGetDouble; *setter = JRPCModelSetDouble; break;
+        default:
+            return NO;
+    }
+    return YES;
+}
+
+#pragma mark - Objects
+
+static JRPCModelValueKind JRPCModelValueKindForClass(Class cls) {
+    if (!cls) {
+        return JRPCModelValueKindObject;
+    }
+    if ([JRPCModelPlan isModelClass:cls]) {
+        return JRPCModelValueKindModel;
+    }
+    // JSON types are passed as they are, even though some implement initWithJSONRPCResponseResult: through categories
+    if ([cls isSubclassOfClass:[NSString class]] || [cls isSubclassOfClass:[NSNumber class]] ||
+        [cls isSubclassOfClass:[NSArray class]] || [cls isSubclassOfClass:[NSDictionary class]]) {
+        return JRPCModelValueKindObject;
+    }
+    if ([cls instancesRespondToSelector:@selector(initWithJSONRPCResponseResult:)]) {
+        return JRPCModelValueKindTransformable;
+    }
+    return JRPCModelValueKindObject;
+}
+
+static id JRPCModelObjectGet(id model, const JRPCModelProperty *property) {
+    return property->ivar ? object_getIvar(model, property->ivar) : ((id (*)(id, SEL))objc_msgSend)(model, property->getter);
+}
+
+static void JRPCModelObjectSet(id model, const JRPCModelProperty *property, id value) {
+    if (property->copies) {
+        value = [value copy];
+    }
+    if (property->ivar) {
+        // Follows the memory management of the instance variable, i.e. strong or weak
+        object_setIvar(model, property->ivar, value);
+    }
+    else {
+        ((void (*)(id, SEL, id))objc_msgSend)(model, property->setter, value);
+    }
+}
+
+// Converts a JSON value to an object of kind. Returns NO if it cannot be. null is nil
+static BOOL JRPCModelDecodeValue(JRPCModelValueKind kind, Class cls, id value, id __strong *object) {
+    if ([NSNull null] == value) {
+        *object = nil;
+        return YES;
+    }
+    switch (kind) {
+        case JRPCModelValueKindModel:
+            *object = [[JRPCModelPlan planForClass:cls] newModelWithJSONObject:value];
+            return nil != *object;
+        case JRPCModelValueKindTransformable:
+            *object = [value isKindOfClass:cls] ? value : [(id<JRPCTransformable>)[cls alloc] initWithJSONRPCResponseResult:value];
+            return nil != *object;
+        default:
+            *object = value;
+            return !cls || [value isKindOfClass:cls];
+    }
+}
+
+static BOOL JRPCModelDecodeArray(const JRPCModelProperty *property, id value, id __strong *object) {
+    if ([NSNull null] == value) {
+        *object = nil;
+        return YES;
+    }
+    if (![value isKindOfClass:[NSArray class]]) {
+        return NO;
+    }
+    NSArray *array = value;
+    NSUInteger count = array.count;
+    if (JRPCModelValueKindObject == property->elementKind && !property->elementClass) {
+        *object = array;
+        return YES;
+    }
+    // Built in a C array, so the elements are not added one at a time
+    __strong id *elements = (__strong id *)calloc(MAX(count, 1), sizeof(id));
+    BOOL valid = YES;
+    NSUInteger index = 0;
+    for (id element in array) {
+        if (!JRPCModelDecodeValue(property->elementKind, property->elementClass, element, &elements[index]) || !elements[index]) {
+            // A null element is not an element of the class, and cannot be held in an array as nil
+            valid = NO;
+            break;
+        }
+        index++;
+    }
+    if (valid) {
+        *object = [NSArray arrayWithObjects:elements count:count];
+    }
+    for (NSUInteger i = 0; i < count; ++i) {
+        elements[i] = nil;
+    }
+    free(elements);
+    return valid;
+}
+
+static id JRPCModelEncodeValue(JRPCModelValueKind kind, id value) {
+    if (JRPCModelValueKindModel == kind) {
+        return [[JRPCModelPlan planForClass:[value class]] JSONObjectWithModel:value];
+    }
+    // Represented as a param would be. Anything that cannot be is left as it is, and rejected when the request is encoded
+    return JRPCJSONObjectForParameter(value) ? : value;
+}
+
+#pragma mark - Plan cache
+
+// Small lock-free cache of model class => plan, since classes are never unloaded and plans are immutable
+// An entry is claimed once by a CAS on its class, then its plan is published. A reader that finds the class before the plan is published builds its own
+#define JRPC_MODEL_PLAN_CACHE_SIZE 256
+typedef struct {
+    _Atomic(uintptr_t) cls;
+    _Atomic(void *) plan;
+} JRPCModelPlanCacheEntry;
+static JRPCModelPlanCacheEntry sModelPlanCache[JRPC_MODEL_PLAN_CACHE_SIZE];
+
+@interface JRPCModelPlan() {
+    JRPCModelProperty *_properties;
+}
+@property (nonatomic, strong) Class modelClass;
+@property (nonatomic, assign) NSUInteger propertyCount;
+// Holds the keys the properties refer to, in the same order
+@property (nonatomic, copy) NSArray<NSString*> *keys;
+@end
+
+@implementation JRPCModelPlan
+
++ (BOOL) isModelClass:(Class)cls {
+    return [cls conformsToProtocol:@protocol(JRPCModelMapping)];
+}
+
++ (JRPCModelPlan*) planForClass:(Class)modelClass {
+    uintptr_t key = (uintptr_t)modelClass;
+    NSUInteger slot = (NSUInteger)(key >> 4);
+    for (NSUInteger probe = 0; probe < JRPC_MODEL_PLAN_CACHE_SIZE; ++probe) {
+        JRPCModelPlanCacheEntry *entry = &sModelPlanCache[(slot + probe) % JRPC_MODEL_PLAN_CACHE_SIZE];
+        uintptr_t entryKey = atomic_load_explicit(&entry->cls, memory_order_acquire);
+        if (entryKey == key) {
+            void *plan = atomic_load_explicit(&entry->plan, memory_order_acquire);
+            return plan ? (__bridge JRPCModelPlan*)plan : [[self alloc] initWithClass:modelClass];
+        }
+        if (0 == entryKey) {
+            JRPCModelPlan *plan = [[self alloc] initWithClass:modelClass];
+            if (atomic_compare_exchange_strong_explicit(&entry->cls, &entryKey, key, memory_order_acq_rel, memory_order_acquire)) {
+                // Held by the cache for good
+                atomic_store_explicit(&entry->plan, (void *)CFBridgingRetain(plan), memory_order_release);
+                return plan;
+            }
+            if (entryKey == key) {
+                // Another thread claimed the entry for the same class
+                return plan;
+            }
+            // Another thread claimed the entry for a different class, keep probing
+        }
+    }
+    // Cache is full
+    return [[self alloc] initWithClass:modelClass];
+}
+
+- (instancetype) initWithClass:(Class)modelClass {
+    self = [super init];
+    if (self) {
+        if (![[self class] isModelClass:modelClass]) {
+            [NSException raise:NSInvalidArgumentException format:@"%@ does not conform to JRPCModelMapping", NSStringFromClass(modelClass)];
+        }
+        self.modelClass = modelClass;
+        NSDictionary<NSString*, NSString*> *keysByPropertyName = nil;
+        if ([modelClass respondsToSelector:@selector(jsonRPCKeysByPropertyName)]) {
+            keysByPropertyName = [(Class<JRPCModelMapping>)modelClass jsonRPCKeysByPropertyName];
+        }
+        NSDictionary<NSString*, Class> *elementClassesByPropertyName = nil;
+        if ([modelClass respondsToSelector:@selector(jsonRPCElementClassesByPropertyName)]) {
+            elementClassesByPropertyName = [(Class<JRPCModelMapping>)modelClass jsonRPCElementClassesByPropertyName];
+        }
+        NSMutableData *properties = [[NSMutableData alloc] init];
+        NSMutableArray<NSString*> *keys = [[NSMutableArray alloc] init];
+        NSMutableSet<NSString*> *propertyNames = [[NSMutableSet alloc] init];
+        // Subclass properties first, so a redeclared property is mapped as the subclass declares it
+        for (Class cls = modelClass; cls && cls != [NSObject class] && cls != [JRPCModel class]; cls = class_getSuperclass(cls)) {
+            unsigned int propertyCount = 0;
+            objc_property_t *propertyList = class_copyPropertyList(cls, &propertyCount);
+            for (unsigned int i = 0; i < propertyCount; ++i) {
+                NSString *name = @(property_getName(propertyList[i]));
+                if ([propertyNames containsObject:name]) {
+                    continue;
+                }
+                [propertyNames addObject:name];
+                JRPCModelProperty property;
+                if ([self getProperty:&property forObjCProperty:propertyList[i] class:cls name:name elementClass:elementClassesByPropertyName[name]]) {
+                    NSString *key = [keysByPropertyName[name] copy] ? : name;
+                    [keys addObject:key];
+                    property.key = key;
+                    [properties appendBytes:&property length:sizeof(property)];
+                }
+            }
+            free(propertyList);
+        }
+        self.propertyCount = properties.length / sizeof(JRPCModelProperty);
+        _properties = malloc(MAX(properties.length, 1));
+        memcpy(_properties, properties.bytes, properties.length);
+        self.keys = keys;
+    }
+    return self;
+}
+
+- (void) dealloc {
+    free(_properties);
+}
+
+- (const JRPCModelProperty*) properties {
+    return _properties;
+}
+
+// Compiles the plan for a property from its attributes. Returns NO if it is not mapped: a computed readonly property, or of an unsupported type
+- (BOOL) getProperty:(JRPCModelProperty*)property
+     forObjCProperty:(objc_property_t)objcProperty
+               class:(Class)cls
+                name:(NSString*)name
+        elementClass:(Class)elementClass {
+    memset(property, 0, sizeof(*property));
+    property->ivarOffset = -1;
+    BOOL readonly = NO;
+    NSString *typeEncoding = nil;
+    unsigned int attributeCount = 0;
+    objc_property_attribute_t *attributes = property_copyAttributeList(objcProperty, &attributeCount);
+    for (unsigned int i = 0; i < attributeCount; ++i) {
+        switch (attributes[i].name[0]) {
+            case 'T': typeEncoding = @(attributes[i].value); break;
+            case 'R': readonly = YES; break;
+            case 'C': property->copies = YES; break;
+            case 'G': property->getter = sel_registerName(attributes[i].value); break;
+            case 'S': property->setter = sel_registerName(attributes[i].value); break;
+            case 'V': property->ivar = class_getInstanceVariable(cls, attributes[i].value); break;
+            default: break;
+        }
+    }
+    free(attributes);
+    if (!property->getter) {
+        property->getter = NSSelectorFromString(name);
+    }
+    if (!property->setter && !readonly) {
+        property->setter = NSSelectorFromString([NSString stringWithFormat:@"set%@%@:", [[name substringToIndex:1] uppercaseString], [name substringFromIndex:1]]);
+    }
+    if (readonly) {
+        property->setter = NULL;
+    }
+    // e.g. hash & description, which classes adopting the NSObject protocol declare
+    if (!property->ivar && !property->setter) {
+        return NO;
+    }
+    if (property->ivar) {
+        property->ivarOffset = ivar_getOffset(property->ivar);
+    }
+    const char *type = typeEncoding.UTF8String;
+    if (1 == strlen(type) && JRPCModelPrimitiveForTypeEncoding(type[0], &property->getPrimitive, &property->setPrimitive)) {
+        property->kind = JRPCModelValueKindPrimitive;
+        return YES;
+    }
+    if ('@' != type[0] || '?' == type[1]) {
+        // Structs, pointers & blocks are not mapped
+        return NO;
+    }
+    // @"ClassName" or @"ClassName<Protocol>", @"<Protocol>" or @ for id
+    Class propertyClass = Nil;
+    if ('"' == type[1]) {
+        NSString *className = [[typeEncoding substringWithRange:NSMakeRange(2, typeEncoding.length - 3)] componentsSeparatedByString:@"<"][0];
+        propertyClass = className.length ? NSClassFromString(className) : Nil;
+    }
+    property->cls = propertyClass;
+    property->kind = JRPCModelValueKindForClass(propertyClass);
+    if (elementClass && [propertyClass isSubclassOfClass:[NSArray class]]) {
+        property->kind = JRPCModelValueKindArray;
+        property->elementClass = elementClass;
+        property->elementKind = JRPCModelValueKindForClass(elementClass);
+    }
+    return YES;
+}
+
+#pragma mark - Mapping
+
+- (BOOL) fillModel:(id)model withJSONObject:(NSDictionary*)jsonObject {
+    CFDictionaryRef members = (__bridge CFDictionaryRef)jsonObject;
+    const JRPCModelProperty *properties = _properties;
+    for (NSUInteger i = 0; i < _propertyCount; ++i) {
+        const JRPCModelProperty *property = &properties[i];
+        id value = (__bridge id)CFDictionaryGetValue(members, (__bridge const void *)property->key);
+        if (!value) {
+            continue;
+        }
+        if (JRPCModelValueKindPrimitive == property->kind) {
+            if ([value isKindOfClass:[NSNumber class]]) {
+                property->setPrimitive(model, property, value);
+            }
+            else if ([NSNull null] == value) {
+                property->setPrimitive(model, property, @0);
+            }
+            else {
+                return NO;
+            }
+            continue;
+        }
+        id object = nil;
+        BOOL valid = (JRPCModelValueKindArray == property->kind) ?
+            JRPCModelDecodeArray(property, value, &object) :
+            JRPCModelDecodeValue(property->kind, property->cls, value, &object);
+        if (!valid) {
+            return NO;
+        }
+        JRPCModelObjectSet(model, property, object);
+    }
+    return YES;
+}
+
+- (id) newModelWithJSONObject:(id)jsonObject {
+    if (![jsonObject isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    id model = [[_modelClass alloc] init];
+    return [self fillModel:model withJSONObject:jsonObject] ? model : nil;
+}
+
+- (NSDictionary*) JSONObjectWithModel:(id)model {
+    NSUInteger count = _propertyCount;
+    __unsafe_unretained id memberKeys[MAX(count, 1)];
+    // Values are held strongly until the dictionary is created, since they may be created here
+    __strong id *memberValues = (__strong id *)calloc(MAX(count, 1), sizeof(id));
+    NSUInteger memberCount = 0;
+    const JRPCModelProperty *properties = _properties;
+    for (NSUInteger i = 0; i < count; ++i) {
+        const JRPCModelProperty *property = &properties[i];
+        id value = nil;
+        if (JRPCModelValueKindPrimitive == property->kind) {
+            value = property->getPrimitive(model, property);
+        }
+        else {
+            id object = JRPCModelObjectGet(model, property);
+            if (object && JRPCModelValueKindArray == property->kind && [object isKindOfClass:[NSArray class]]) {
+                NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:[object count]];
+                for (id element in (NSArray*)object) {
+                    [array addObject:JRPCModelEncodeValue(property->elementKind, element)];
+                }
+                value = array;
+            }
+            else if (object) {
+                value = JRPCModelEncodeValue(property->kind, object);
+            }
+        }
+        if (value) {
+            memberKeys[memberCount] = property->key;
+            memberValues[memberCount] = value;
+            memberCount++;
+        }
+    }
+    NSDictionary *jsonObject = [NSDictionary dictionaryWithObjects:memberValues forKeys:memberKeys count:memberCount];
+    for (NSUInteger i = 0; i < memberCount; ++i) {
+        memberValues[i] = nil;
+    }
+    free(memberValues);
+    return jsonObject;
+}
+
+@end
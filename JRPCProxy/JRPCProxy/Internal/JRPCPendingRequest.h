@@ -0,0 +1,130 @@
+//
+//  JRPCPendingRequest.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCMethodDescriptor.h"
+#import "JRPCCall.h"
+#import "JRPCScheduling.h"
+
+@class JRPCMetricsRecorder;
+@class JRPCCallTrace;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCPendingRequest is a call to a proxied method that has been marshalled into a JSON-RPC request, but not yet completed
+ It holds what is needed to complete the call when its response arrives, so requests can be queued (e.g. for batching) and matched to responses by id
+ A request is completed exactly once, by whichever of its response, timeout or cancellation comes first
+ */
+@interface JRPCPendingRequest : NSObject <JRPCCall>
+
+/**
+ Creates a pending request
+ @param requestId The JSON-RPC request id
+ @param descriptor The descriptor of the proxied method called
+ @param completionBlock The completion block of the call, or nil if the call only refreshes the response cache
+ @param payload The JSON-RPC request, an NSDictionary for transports that perform serialization, otherwise the encoded NSData.
+ nil for calls waiting on an identical request already in flight
+ @param cacheKey The response cache key of the call, or nil if the method's responses are not cached
+ @return An initialized pending request
+ */
++ (instancetype) requestWithId:(NSUInteger)requestId
+                    descriptor:(JRPCMethodDescriptor*)descriptor
+               completionBlock:(nullable id)completionBlock
+                       payload:(nullable id)payload
+                      cacheKey:(nullable NSData*)cacheKey;
+
+/** The JSON-RPC request id */
+@property (nonatomic, readonly) NSUInteger requestId;
+
+/** The descriptor of the proxied method called */
+@property (nonatomic, readonly) JRPCMethodDescriptor *descriptor;
+
+/** The completion block of the call, or nil if the call only refreshes the response cache. Released once the request is completed */
+@property (atomic, readonly, nullable) id completionBlock;
+
+/** The JSON-RPC request, an NSDictionary for transports that perform serialization, otherwise the encoded NSData. Released once the request is completed */
+@property (atomic, readonly, nullable) id payload;
+
+/** The response cache key of the call, or nil if the method's responses are not cached */
+@property (nonatomic, readonly, nullable) NSData *cacheKey;
+
+/** The cache key of the identical request in flight a call waits on instead of sending its own, or nil. Set by the proxy before the call is captured */
+@property (atomic, copy, nullable) NSData *coalescedCacheKey;
+
+/**
+ Marks the request completed, releasing its completion block, payload & trace and cancelling its timeout
+ @param completionBlock On return, the completion block to call
+ @return YES the first time it is called, otherwise NO as the request has already been completed
+ */
+- (BOOL) takeCompletionBlock:(id _Nullable __strong * _Nonnull)completionBlock;
+
+/**
+ Takes the completion block without completing the request, which goes on for the calls waiting on it as though it only refreshed the cache
+ The call's handle reports it completed only once the request is
+ @return The completion block to call, or nil if the request has already been completed or its completion block taken
+ */
+- (nullable id) detachCompletionBlock;
+
+/** Called by cancel, until the request is completed. Set by the proxy when the call's handle is requested */
+@property (atomic, copy, nullable) void (^cancelHandler)(JRPCPendingRequest *request);
+
+/** YES if the request was given to the proxy's JRPCCallScheduler, which must be told when it completes. Set by the scheduler with its lock held */
+@property (atomic, assign, getter=isScheduled) BOOL scheduled;
+
+/** The queue the request waits in for the scheduler. Only accessed by the scheduler */
+@property (nonatomic, assign) JRPCCallPriority priority;
+
+/** When the request was given to the scheduler, as a system uptime, or 0 once it has completed. Only accessed by the scheduler */
+@property (nonatomic, assign) NSTimeInterval scheduledTime;
+
+/** When the scheduler sent the request, as a system uptime, or 0 if it has not been sent or has completed. Only accessed by the scheduler */
+@property (nonatomic, assign) NSTimeInterval sentTime;
+
+/** The metrics the call is recorded in, or nil if metrics were disabled when it was made. Set before the request is sent */
+@property (nonatomic, strong, nullable) JRPCMetricsRecorder *metrics;
+
+/** The trace of the call, or nil if it was not sampled or the proxy had no tracer. Set before the request is sent, released once it is completed */
+@property (atomic, strong, nullable) JRPCCallTrace *trace;
+
+/**
+ Sets the timer that times the request out, which is resumed here and cancelled when the request is completed, or straight away if it already has been
+ The timer's handler may retain the request, since cancelling the timer releases it
+ */
+- (void) setTimeoutTimer:(dispatch_source_t)timer;
+
+/** When the call was made, from JRPCHistogramNow(). Only set with metrics or a trace */
+@property (nonatomic, assign) uint64_t callTime;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
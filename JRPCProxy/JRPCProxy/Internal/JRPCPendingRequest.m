@@ -0,0 +1,145 @@
+//
+//  JRPCPendingRequest.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCPendingRequest.h"
+#import <stdatomic.h>
+
+@interface JRPCPendingRequest() {
+    atomic_bool _completed;
+    // Guarded by @synchronized (self)
+    id _completionBlock;
+    dispatch_source_t _timeoutTimer;
+}
+@property (nonatomic, assign) NSUInteger requestId;
+@property (nonatomic, strong) JRPCMethodDescriptor *descriptor;
+@property (atomic, strong) id payload;
+@property (nonatomic, copy) NSData *cacheKey;
+@end
+
+@implementation JRPCPendingRequest
+
++ (instancetype) requestWithId:(NSUInteger)requestId
+                    descriptor:(JRPCMethodDescriptor*)descriptor
+               completionBlock:(id)completionBlock
+                       payload:(id)payload
+                      cacheKey:(NSData*)cacheKey {
+    return [[self alloc] initWithId:requestId descriptor:descriptor completionBlock:completionBlock payload:payload cacheKey:cacheKey];
+}
+
+- (instancetype) initWithId:(NSUInteger)requestId
+                 descriptor:(JRPCMethodDescriptor*)descriptor
+            completionBlock:(id)completionBlock
+                    payload:(id)payload
+                   cacheKey:(NSData*)cacheKey {
+    self = [super init];
+    if (self) {
+        self.requestId = requestId;
+        self.descriptor = descriptor;
+        _completionBlock = completionBlock;
+        self.payload = payload;
+        self.cacheKey = cacheKey;
+        atomic_init(&_completed, false);
+    }
+    return self;
+}
+
+- (BOOL) takeCompletionBlock:(id __strong *)completionBlock {
+    if (atomic_exchange(&_completed, true)) {
+        *completionBlock = nil;
+        return NO;
+    }
+    *completionBlock = [self exchangeCompletionBlock];
+    self.cancelHandler = nil;
+    // Nothing the request holds is needed once it is completed, so none of it waits for the timeout to have fired
+    self.payload = nil;
+    self.trace = nil;
+    [self cancelTimeoutTimer];
+    return YES;
+}
+
+- (id) detachCompletionBlock {
+    if (self.isCompleted) {
+        return nil;
+    }
+    self.cancelHandler = nil;
+    // Exchanged under the lock, so the block is handed out once even if the request is completed meanwhile
+    return [self exchangeCompletionBlock];
+}
+
+- (id) completionBlock {
+    @synchronized (self) {
+        return _completionBlock;
+    }
+}
+
+- (id) exchangeCompletionBlock {
+    id completionBlock = nil;
+    @synchronized (self) {
+        completionBlock = _completionBlock;
+        _completionBlock = nil;
+    }
+    return completionBlock;
+}
+
+- (void) setTimeoutTimer:(dispatch_source_t)timer {
+    @synchronized (self) {
+        _timeoutTimer = timer;
+    }
+    dispatch_resume(timer);
+    // Completed before the timer was set, so takeCompletionBlock: did not see it
+    if (self.isCompleted) {
+        [self cancelTimeoutTimer];
+    }
+}
+
+- (void) cancelTimeoutTimer {
+    dispatch_source_t timer = nil;
+    @synchronized (self) {
+        timer = _timeoutTimer;
+        _timeoutTimer = nil;
+    }
+    if (timer) {
+        dispatch_source_cancel(timer);
+    }
+}
+
+#pragma mark - JRPCCall
+
+- (BOOL) isCompleted {
+    return atomic_load(&_completed);
+}
+
+- (void) cancel {
+    void (^cancelHandler)(JRPCPendingRequest*) = self.cancelHandler;
+    if (cancelHandler && !self.isCompleted) {
+        cancelHandler(self);
+    }
+}
+
+@end
@@ -0,0 +1,123 @@
+//
+//  JRPCResponse.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCJSONReader.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCResponse is a JSON-RPC response whose members are only turned into objects when they are asked for
+ Responses created from data are scanned once to find the envelope members, then the error object or result value is parsed on demand,
+ so an error response never parses its result and a primitive result is read straight into a C scalar.
+ Responses are not thread safe, they are handed from queue to queue rather than shared. Copies are independent, so may be used on different queues.
+ */
+@interface JRPCResponse : NSObject <NSCopying>
+
+/**
+ Creates a response from serialized JSON-RPC response data
+ @param data The UTF-8 encoded JSON-RPC response
+ @return An initialized response, or nil if the data is not a JSON object
+ */
++ (nullable instancetype) responseWithData:(NSData*)data;
+
+/**
+ Creates a response from part of some data, e.g. one element of a batch response
+ @param data The data containing the UTF-8 encoded JSON-RPC response. It is retained, not copied
+ @param range The range of the response within data
+ @return An initialized response, or nil if the range does not hold a JSON object
+ */
++ (nullable instancetype) responseWithData:(NSData*)data range:(NSRange)range;
+
+/**
+ Creates a response from part of some dispatch data, e.g. as read from a socket in fragments
+ The envelope is scanned across the regions of the data without joining them. Each member is only made contiguous when it is read,
+ which is free when it lies within one region, so only a member that spans regions is ever copied
+ @param data The dispatch data containing the UTF-8 encoded JSON-RPC response. It is retained, not copied
+ @param range The range of the response within data
+ @return An initialized response, or nil if the range does not hold a JSON object
+ */
++ (nullable instancetype) responseWithDispatchData:(dispatch_data_t)data range:(NSRange)range;
+
+/**
+ Creates a response from a JSON-RPC response object, as returned by transports that perform serialization
+ @param jsonObject The JSON-RPC response object
+ @return An initialized response, or nil if the object is not a dictionary
+ */
++ (nullable instancetype) responseWithJSONObject:(id)jsonObject;
+
+/** The length of the JSON text of the response, or 0 for responses created from an object */
+@property (nonatomic, readonly) NSUInteger length;
+
+/** The id member, or nil if absent. NSNull if the server could not determine the request id */
+@property (nonatomic, readonly, nullable) id requestId;
+
+/** YES if the response has a non-null error member */
+@property (nonatomic, readonly) BOOL hasError;
+
+/** The error member, or nil if hasError is NO. An error member that is not an object is returned as an empty dictionary */
+@property (nonatomic, readonly, nullable) NSDictionary *error;
+
+/**
+ The result member, created on first use
+ @param error On return, the parse error if the result could not be created
+ @return The result, or nil if absent or it could not be parsed
+ */
+- (nullable id) resultWithError:(NSError * _Nullable * _Nullable)error;
+
+/**
+ Reads a number, true, false or null result without creating an object
+ @param scalar On return, the result value
+ @return YES if the response was created from data and the result is a scalar, otherwise NO and the result should be read with resultWithError:
+ */
+- (BOOL) getResultScalar:(JRPCJSONScalar*)scalar;
+
+/**
+ Reads an array of numbers result straight into a numeric array, without creating an NSNumber per element. Created on first use
+ @param arrayClass A concrete subclass of JRPCNumericArray
+ @return The result, or nil if the response was not created from data or the result is not an array of numbers, in which case it should be read
+ with resultWithError: and transformed
+ */
+- (nullable id) resultAsNumericArrayOfClass:(Class)arrayClass;
+
+/**
+ Creates the elements of an array result one at a time, without creating the array, so that only the elements the caller still holds are in memory.
+ Each element is only made contiguous when it is created, so elements of dispatch data are copied one at a time, and only if they span regions
+ @param block Called with each element in order. May set *stop to YES to create no more
+ @param error On return, the parse error if the result is not an array, or an element could not be created
+ @return YES if every element was created, or the block stopped. A null or absent result has no elements
+ */
+- (BOOL) enumerateResultElementsUsingBlock:(void (NS_NOESCAPE ^)(id element, BOOL *stop))block error:(NSError * _Nullable * _Nullable)error;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
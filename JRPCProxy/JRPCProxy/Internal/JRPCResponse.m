@@ -0,0 +1,326 @@
+//
+//  JRPCResponse.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCResponse.h"
+#import "JRPCDispatchData.h"
+#import "JRPCNumericArray.h"
+#import "NSDictionary+JSONRPC.h"
+
+@interface JRPCResponse()
+// Set for responses created from data
+@property (nonatomic, strong) NSData *data;
+// Set instead of data for responses created from dispatch data
+@property (nonatomic, strong) dispatch_data_t dispatchData;
+@property (nonatomic, assign) JRPCJSONResponseEnvelope envelope;
+@property (nonatomic, assign) NSUInteger length;
+// Set for responses created from an object
+@property (nonatomic, strong) NSDictionary *jsonObject;
+// The result, once created
+@property (nonatomic, strong) id result;
+@property (nonatomic, assign) BOOL resultParsed;
+// The result read as a numeric array, once created
+@property (nonatomic, strong) JRPCNumericArray *numericArrayResult;
+@end
+
+@implementation JRPCResponse
+
++ (instancetype) responseWithData:(NSData*)data {
+    return [self responseWithData:data range:NSMakeRange(0, data.length)];
+}
+
++ (instancetype) responseWithData:(NSData*)data range:(NSRange)range {
+    JRPCJSONResponseEnvelope envelope;
+    if (!JRPCJSONScanResponseEnvelope(data, range, &envelope)) {
+        return nil;
+    }
+    return [[self alloc] initWithData:data envelope:envelope length:range.length];
+}
+
++ (instancetype) responseWithDispatchData:(dispatch_data_t)data range:(NSRange)range {
+    if (0 != range.location || range.length != dispatch_data_get_size(data)) {
+        data = dispatch_data_create_subrange(data, range.location, range.length);
+    }
+    JRPCJSONResponseEnvelope envelope;
+    if (!JRPCJSONScanResponseEnvelopeInDispatchData(data, &envelope)) {
+        return nil;
+    }
+    JRPCResponse *response = [[self alloc] initWithData:nil envelope:envelope length:range.length];
+    response.dispatchData = data;
+    return response;
+}
+
++ (instancetype) responseWithJSONObject:(id)jsonObject {
+    if (![jsonObject isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    return [[self alloc] initWithJSONObject:jsonObject];
+}
+
+- (instancetype) initWithData:(NSData*)data envelope:(JRPCJSONResponseEnvelope)envelope length:(NSUInteger)length {
+    self = [super init];
+    if (self) {
+        self.data = data;
+        self.envelope = envelope;
+        self.length = length;
+    }
+    return self;
+}
+
+- (instancetype) initWithJSONObject:(NSDictionary*)jsonObject {
+    self = [super init];
+    if (self) {
+        self.jsonObject = jsonObject;
+    }
+    return self;
+}
+
+// Returns data holding the member in range, adjusting range to its place within it. A member of dispatch data is made contiguous on its own,
+// which only copies it if it spans regions
+- (NSData*) dataForMemberInRange:(NSRange*)range {
+    if (!self.dispatchData) {
+        return self.data;
+    }
+    NSData *member = JRPCDispatchDataInRange(self.dispatchData, *range);
+    *range = NSMakeRange(0, range->length);
+    return member;
+}
+
+- (id) requestId {
+    if (self.jsonObject) {
+        return self.jsonObject[kJSONRPCRequestIdKey];
+    }
+    NSRange idRange = self.envelope.requestId;
+    if (NSNotFound == idRange.location) {
+        return nil;
+    }
+    NSData *data = [self dataForMemberInRange:&idRange];
+    const uint8_t *bytes = (const uint8_t*)data.bytes + idRange.location;
+    if ('n' == bytes[0]) {
+        return [NSNull null];
+    }
+    // Integer ids, as the proxy generates, are read without the parser
+    JRPCJSONScalar scalar;
+    if (('-' == bytes[0] || (bytes[0] >= '0' && bytes[0] <= '9')) &&
+        JRPCJSONReadScalar(bytes, idRange.length, &scalar) && JRPCJSONScalarKindInteger == scalar.kind) {
+        return @(scalar.integer);
+    }
+    return JRPCJSONObjectInRange(data, idRange, NULL);
+}
+
+- (BOOL) hasError {
+    if (self.jsonObject) {
+        id error = self.jsonObject[kJSONRPCErrorKey];
+        return error && error != [NSNull null];
+    }
+    NSRange errorRange = self.envelope.error;
+    if (NSNotFound == errorRange.location) {
+        return NO;
+    }
+    // Only the first byte is needed to tell null from an error object
+    errorRange.length = 1;
+    NSData *data = [self dataForMemberInRange:&errorRange];
+    return 'n' != ((const uint8_t*)data.bytes)[errorRange.location];
+}
+
+- (NSDictionary*) error {
+    if (!self.hasError) {
+        return nil;
+    }
+    id error = nil;
+    if (self.jsonObject) {
+        error = self.jsonObject[kJSONRPCErrorKey];
+    } else {
+        NSRange errorRange = self.envelope.error;
+        error = JRPCJSONObjectInRange([self dataForMemberInRange:&errorRange], errorRange, NULL);
+    }
+    return [error isKindOfClass:[NSDictionary class]] ? error : @{};
+}
+
+- (id) resultWithError:(NSError**)error {
+    if (!self.resultParsed) {
+        NSRange resultRange = self.envelope.result;
+        if (self.jsonObject) {
+            self.result = self.jsonObject[kJSONRPCResultKey];
+        } else if (NSNotFound != resultRange.location) {
+            NSError *parseError = nil;
+            self.result = JRPCJSONObjectInRange([self dataForMemberInRange:&resultRange], resultRange, &parseError);
+            if (!self.result) {
+                // Not cached, so the error is reported every time
+                if (error) {
+                    *error = parseError;
+                }
+                return nil;
+            }
+        }
+        self.resultParsed = YES;
+    }
+    return self.result;
+}
+
+- (BOOL) getResultScalar:(JRPCJSONScalar*)scalar {
+    NSRange resultRange = self.envelope.result;
+    if (self.jsonObject || NSNotFound == resultRange.location) {
+        return NO;
+    }
+    NSData *data = [self dataForMemberInRange:&resultRange];
+    return JRPCJSONReadScalar((const uint8_t*)data.bytes + resultRange.location, resultRange.length, scalar);
+}
+
+- (id) resultAsNumericArrayOfClass:(Class)arrayClass {
+    if ([self.numericArrayResult isMemberOfClass:arrayClass]) {
+        return self.numericArrayResult;
+    }
+    NSRange resultRange = self.envelope.result;
+    if (self.jsonObject || NSNotFound == resultRange.location) {
+        return nil;
+    }
+    NSData *data = [self dataForMemberInRange:&resultRange];
+    NSData *elements = JRPCJSONReadNumericArray((const uint8_t*)data.bytes + resultRange.location, resultRange.length, [arrayClass objCType][0]);
+    if (!elements) {
+        return nil;
+    }
+    self.numericArrayResult = [[arrayClass alloc] initWithData:elements];
+    return self.numericArrayResult;
+}
+
+- (BOOL) enumerateResultElementsUsingBlock:(void (NS_NOESCAPE ^)(id element, BOOL *stop))block error:(NSError**)error {
+    NSRange resultRange = self.envelope.result;
+    if (self.jsonObject || self.resultParsed) {
+        // Already objects, so there is nothing to save by creating them one at a time
+        NSError *resultError = nil;
+        id result = [self resultWithError:&resultError];
+        if (resultError) {
+            if (error) {
+                *error = resultError;
+            }
+            return NO;
+        }
+        if (!result || [NSNull null] == result) {
+            return YES;
+        }
+        if (![result isKindOfClass:[NSArray class]]) {
+            return [self notAnArrayWithError:error];
+        }
+        BOOL stop = NO;
+        for (id element in (NSArray*)result) {
+            block(element, &stop);
+            if (stop) {
+                break;
+            }
+        }
+        return YES;
+    }
+    if (NSNotFound == resultRange.location) {
+        return YES;
+    }
+    // The first byte tells null & arrays from anything else
+    NSRange firstByteRange = NSMakeRange(resultRange.location, 1);
+    NSData *firstByteData = [self dataForMemberInRange:&firstByteRange];
+    uint8_t firstByte = ((const uint8_t*)firstByteData.bytes)[firstByteRange.location];
+    if ('n' == firstByte) {
+        return YES;
+    }
+    if ('[' != firstByte) {
+        return [self notAnArrayWithError:error];
+    }
+    __block BOOL stop = NO;
+    __block NSError *elementError = nil;
+    BOOL scanned = NO;
+    if (self.dispatchData) {
+        dispatch_data_t resultData = dispatch_data_create_subrange(self.dispatchData, resultRange.location, resultRange.length);
+        scanned = JRPCJSONScanArrayInDispatchData(resultData, ^(NSRange elementRange) {
+            if (stop) {
+                return;
+            }
+            // Whatever parsing the element autoreleases goes before the next is parsed
+            @autoreleasepool {
+                NSError *parseError = nil;
+                id element = JRPCJSONObjectInRange(JRPCDispatchDataInRange(resultData, elementRange), NSMakeRange(0, elementRange.length), &parseError);
+                if (!element) {
+                    elementError = parseError;
+                    stop = YES;
+                    return;
+                }
+                block(element, &stop);
+            }
+        });
+    }
+    else {
+        // The result is scanned in place, within the response data that self holds on to
+        NSData *resultData = [NSData dataWithBytesNoCopy:(void*)((const uint8_t*)self.data.bytes + resultRange.location)
+                                                  length:resultRange.length freeWhenDone:NO];
+        scanned = JRPCJSONScanArray(resultData, ^(NSRange elementRange) {
+            if (stop) {
+                return;
+            }
+            // Whatever parsing the element autoreleases goes before the next is parsed
+            @autoreleasepool {
+                NSError *parseError = nil;
+                id element = JRPCJSONObjectInRange(resultData, elementRange, &parseError);
+                if (!element) {
+                    elementError = parseError;
+                    stop = YES;
+                    return;
+                }
+                block(element, &stop);
+            }
+        });
+    }
+    if (elementError || (!scanned && !stop)) {
+        if (error) {
+            *error = elementError ? : [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                                      userInfo:@{ NSDebugDescriptionErrorKey : @"Result is not a valid JSON array" }];
+        }
+        return NO;
+    }
+    return YES;
+}
+
+- (BOOL) notAnArrayWithError:(NSError**)error {
+    if (error) {
+        *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                 userInfo:@{ NSDebugDescriptionErrorKey : @"Result is not an array" }];
+    }
+    return NO;
+}
+
+#pragma mark - NSCopying
+
+- (id) copyWithZone:(NSZone *)zone {
+    // The data & parsed values are immutable, so are shared with the copy
+    JRPCResponse *copy = self.jsonObject ? [[[self class] alloc] initWithJSONObject:self.jsonObject] :
+                                           [[[self class] alloc] initWithData:self.data envelope:self.envelope length:self.length];
+    copy.dispatchData = self.dispatchData;
+    copy.result = self.result;
+    copy.resultParsed = self.resultParsed;
+    copy.numericArrayResult = self.numericArrayResult;
+    return copy;
+}
+
+@end
@@ -0,0 +1,109 @@
+//
+//  JRPCResponseCache.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCCachePolicy.h"
+#import "JRPCResponse.h"
+#import "JRPCPendingRequest.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The outcome of looking up a call in a JRPCResponseCache */
+typedef NS_ENUM(NSInteger, JRPCResponseCacheResult) {
+    /** Nothing usable is cached and no identical request is in flight. The caller must send the request, then call completeRequest:forKey:response:policy: */
+    JRPCResponseCacheResultMiss = 0,
+    /** An identical request is in flight and the call has been added to those waiting for it */
+    JRPCResponseCacheResultCoalesced,
+    /** A fresh response, or a stale one already being revalidated, is returned */
+    JRPCResponseCacheResultHit,
+    /** A stale response is returned. The caller must send the request to revalidate it, then call completeRequest:forKey:response:policy: */
+    JRPCResponseCacheResultStaleHit
+};
+
+/**
+ JRPCResponseCache holds the cached responses of a proxy, and the requests in flight for cached methods so identical calls can share them
+ Entries are keyed by JRPCMethodDescriptor cacheKeyForInvocation:, and the limits of each JRPCCachePolicy are applied to the entries stored with it.
+ Responses are copied into and out of the cache, so callers never share a response object. All methods are thread safe
+ */
+@interface JRPCResponseCache : NSObject
+
+/**
+ Looks up a call, starting a request for it if it must be sent
+ @param key The cache key of the call
+ @param policy The cache policy of the method called
+ @param call The call, which is added to the waiters if an identical request is in flight
+ @param response On return, a copy of the cached response for JRPCResponseCacheResultHit & JRPCResponseCacheResultStaleHit, otherwise nil
+ @return What the caller should do with the call
+ */
+- (JRPCResponseCacheResult) lookupCallWithKey:(NSData*)key
+                                       policy:(JRPCCachePolicy*)policy
+                                         call:(JRPCPendingRequest*)call
+                                     response:(JRPCResponse * _Nullable __autoreleasing * _Nonnull)response;
+
+/**
+ Records the request sent for a key after a JRPCResponseCacheResultMiss or JRPCResponseCacheResultStaleHit, so it can be abandoned
+ @param request The request sent
+ @param key The cache key of the request
+ */
+- (void) startRequest:(JRPCPendingRequest*)request forKey:(NSData*)key;
+
+/**
+ Ends the request in flight for a key, caching its response
+ @param request The request started for the key, or nil if it failed before it could be started
+ @param key The cache key of the request
+ @param response The response to cache, or nil if the request failed. It is copied, and its result should already be parsed
+ @param policy The cache policy to store the response with, or nil not to store it
+ @return The calls that were waiting for the request, to be completed with its response. Empty if the request was abandoned
+ */
+- (NSArray<JRPCPendingRequest*>*) completeRequest:(nullable JRPCPendingRequest*)request
+                                           forKey:(NSData*)key
+                                         response:(nullable JRPCResponse*)response
+                                           policy:(nullable JRPCCachePolicy*)policy;
+
+/**
+ Gives up on a call that timed out or was cancelled: the request started for the key, or one of the calls waiting for it
+ The request goes on while calls are waiting for it, and is abandoned once its own call and all of those have been given up on
+ @param call The call given up on
+ @param key The cache key of the request
+ @return The request to cancel & complete, which is no longer in flight for the key, or nil if it is still needed
+ */
+- (nullable JRPCPendingRequest*) abandonCall:(JRPCPendingRequest*)call forKey:(NSData*)key;
+
+/** Removes the responses cached with a policy */
+- (void) removeResponsesForPolicy:(JRPCCachePolicy*)policy;
+
+/** Removes all cached responses. Requests in flight are unaffected */
+- (void) removeAllResponses;
+
+/** The cache counters */
+@property (nonatomic, readonly) JRPCCacheStatistics statistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,272 @@
+//
+//  JRPCResponseCache.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCResponseCache.h"
+#import <pthread.h>
+
+/** A cached response */
+@interface JRPCResponseCacheEntry : NSObject
+@property (nonatomic, strong) JRPCResponse *response;
+@property (nonatomic, strong) JRPCCachePolicy *policy;
+@property (nonatomic, assign) NSUInteger cost;
+// System uptimes when the response stops being fresh, and stops being usable at all
+@property (nonatomic, assign) NSTimeInterval freshUntil;
+@property (nonatomic, assign) NSTimeInterval staleUntil;
+@end
+
+@implementation JRPCResponseCacheEntry
+@end
+
+/** The entries stored with one policy, whose limits apply to them together */
+@interface JRPCResponseCacheBucket : NSObject
+// Keys, oldest first
+@property (nonatomic, strong) NSMutableOrderedSet<NSData*> *keys;
+@property (nonatomic, assign) NSUInteger bytes;
+@end
+
+@implementation JRPCResponseCacheBucket
+@end
+
+/** A request in flight, and the identical calls waiting for its response */
+@interface JRPCResponseCacheFlight : NSObject
+// nil until the request is started
+@property (nonatomic, strong) JRPCPendingRequest *request;
+// The request's own call has been given up on
+@property (nonatomic, assign) BOOL abandoned;
+@property (nonatomic, strong) NSMutableArray<JRPCPendingRequest*> *waiters;
+@end
+
+@implementation JRPCResponseCacheFlight
+@end
+
+@interface JRPCResponseCache() {
+    // Guards everything below
+    pthread_mutex_t _lock;
+    JRPCCacheStatistics _statistics;
+}
+@property (nonatomic, strong) NSMutableDictionary<NSData*, JRPCResponseCacheEntry*> *entries;
+@property (nonatomic, strong) NSMapTable<JRPCCachePolicy*, JRPCResponseCacheBucket*> *buckets;
+// The requests in flight, and the calls waiting for each
+@property (nonatomic, strong) NSMutableDictionary<NSData*, JRPCResponseCacheFlight*> *inFlight;
+@end
+
+@implementation JRPCResponseCache
+
+- (instancetype) init {
+    self = [super init];
+    if (self) {
+        pthread_mutex_init(&_lock, NULL);
+        self.entries = [[NSMutableDictionary alloc] init];
+        // Policies are compared by identity
+        self.buckets = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                                 valueOptions:NSPointerFunctionsStrongMemory
+                                                     capacity:0];
+        self.inFlight = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (JRPCCacheStatistics) statistics {
+    pthread_mutex_lock(&_lock);
+    JRPCCacheStatistics statistics = _statistics;
+    pthread_mutex_unlock(&_lock);
+    return statistics;
+}
+
+- (JRPCResponseCacheResult) lookupCallWithKey:(NSData*)key
+                                       policy:(JRPCCachePolicy*)policy
+                                         call:(JRPCPendingRequest*)call
+                                     response:(JRPCResponse * __autoreleasing *)response {
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    JRPCResponseCacheResult result = JRPCResponseCacheResultMiss;
+    *response = nil;
+    pthread_mutex_lock(&_lock);
+    JRPCResponseCacheEntry *entry = self.entries[key];
+    if (entry && entry.policy == policy && now < entry.staleUntil) {
+        *response = [entry.response copy];
+        if (now < entry.freshUntil) {
+            _statistics.hits++;
+            result = JRPCResponseCacheResultHit;
+        }
+        else {
+            _statistics.staleHits++;
+            // Only the first call to find it stale revalidates it
+            result = self.inFlight[key] ? JRPCResponseCacheResultHit : JRPCResponseCacheResultStaleHit;
+        }
+    }
+    else {
+        if (entry) {
+            // Expired, or cached with a policy no longer set
+            [self removeEntryForKey:key];
+        }
+        JRPCResponseCacheFlight *flight = self.inFlight[key];
+        if (flight) {
+            [flight.waiters addObject:call];
+            _statistics.coalesced++;
+            result = JRPCResponseCacheResultCoalesced;
+        }
+        else {
+            _statistics.misses++;
+        }
+    }
+    if (JRPCResponseCacheResultMiss == result || JRPCResponseCacheResultStaleHit == result) {
+        JRPCResponseCacheFlight *flight = [[JRPCResponseCacheFlight alloc] init];
+        flight.waiters = [[NSMutableArray alloc] init];
+        self.inFlight[key] = flight;
+    }
+    pthread_mutex_unlock(&_lock);
+    return result;
+}
+
+- (void) startRequest:(JRPCPendingRequest*)request forKey:(NSData*)key {
+    pthread_mutex_lock(&_lock);
+    JRPCResponseCacheFlight *flight = self.inFlight[key];
+    if (flight && !flight.request) {
+        flight.request = request;
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSArray<JRPCPendingRequest*>*) completeRequest:(JRPCPendingRequest*)request
+                                           forKey:(NSData*)key
+                                         response:(JRPCResponse*)response
+                                           policy:(JRPCCachePolicy*)policy {
+    NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+    JRPCResponseCacheEntry *entry = nil;
+    if (response && policy) {
+        entry = [[JRPCResponseCacheEntry alloc] init];
+        entry.response = [response copy];
+        entry.policy = policy;
+        entry.cost = key.length + response.length;
+        entry.freshUntil = now + policy.timeToLive;
+        entry.staleUntil = entry.freshUntil + policy.staleWhileRevalidate;
+    }
+    pthread_mutex_lock(&_lock);
+    // An abandoned request is no longer in flight, and an identical one may have been started since
+    JRPCResponseCacheFlight *flight = self.inFlight[key];
+    NSArray<JRPCPendingRequest*> *waiters = @[];
+    if (flight && flight.request == request) {
+        waiters = [flight.waiters copy];
+        [self.inFlight removeObjectForKey:key];
+    }
+    if (entry) {
+        [self storeEntry:entry forKey:key now:now];
+    }
+    pthread_mutex_unlock(&_lock);
+    return waiters;
+}
+
+- (JRPCPendingRequest*) abandonCall:(JRPCPendingRequest*)call forKey:(NSData*)key {
+    JRPCPendingRequest *abandonedRequest = nil;
+    pthread_mutex_lock(&_lock);
+    JRPCResponseCacheFlight *flight = self.inFlight[key];
+    if (flight) {
+        if (flight.request == call) {
+            flight.abandoned = YES;
+        }
+        [flight.waiters removeObjectIdenticalTo:call];
+        // Waiters that have been completed on their own no longer need the request either
+        [flight.waiters removeObjectsAtIndexes:[flight.waiters indexesOfObjectsPassingTest:^BOOL(JRPCPendingRequest *waiter, NSUInteger index, BOOL *stop) {
+            return waiter.isCompleted;
+        }]];
+        if (flight.abandoned && 0 == flight.waiters.count) {
+            abandonedRequest = flight.request;
+            [self.inFlight removeObjectForKey:key];
+        }
+    }
+    else {
+        // Already completed, or never started
+        abandonedRequest = (call.cacheKey ? call : nil);
+    }
+    pthread_mutex_unlock(&_lock);
+    return abandonedRequest;
+}
+
+- (void) removeResponsesForPolicy:(JRPCCachePolicy*)policy {
+    pthread_mutex_lock(&_lock);
+    JRPCResponseCacheBucket *bucket = [self.buckets objectForKey:policy];
+    [self.entries removeObjectsForKeys:bucket.keys.array];
+    [self.buckets removeObjectForKey:policy];
+    pthread_mutex_unlock(&_lock);
+}
+
+- (void) removeAllResponses {
+    pthread_mutex_lock(&_lock);
+    [self.entries removeAllObjects];
+    [self.buckets removeAllObjects];
+    pthread_mutex_unlock(&_lock);
+}
+
+#pragma mark - Private (called with _lock held)
+
+- (void) storeEntry:(JRPCResponseCacheEntry*)entry forKey:(NSData*)key now:(NSTimeInterval)now {
+    [self removeEntryForKey:key];
+    JRPCCachePolicy *policy = entry.policy;
+    JRPCResponseCacheBucket *bucket = [self.buckets objectForKey:policy];
+    if (!bucket) {
+        bucket = [[JRPCResponseCacheBucket alloc] init];
+        bucket.keys = [[NSMutableOrderedSet alloc] init];
+        [self.buckets setObject:bucket forKey:policy];
+    }
+    self.entries[key] = entry;
+    [bucket.keys addObject:key];
+    bucket.bytes += entry.cost;
+    // Keep within the policy's limits, removing expired responses first, then the oldest
+    NSUInteger maxEntryCount = policy.maxEntryCount;
+    NSUInteger maxBytes = policy.maxBytes;
+    while (bucket.keys.count > 0 &&
+           ((maxEntryCount > 0 && bucket.keys.count > maxEntryCount) || (maxBytes > 0 && bucket.bytes > maxBytes))) {
+        NSData *victimKey = bucket.keys.firstObject;
+        for (NSData *bucketKey in bucket.keys) {
+            if (self.entries[bucketKey].staleUntil <= now) {
+                victimKey = bucketKey;
+                break;
+            }
+        }
+        [self removeEntryForKey:victimKey];
+        _statistics.evictions++;
+    }
+}
+
+- (void) removeEntryForKey:(NSData*)key {
+    JRPCResponseCacheEntry *entry = self.entries[key];
+    if (!entry) {
+        return;
+    }
+    JRPCResponseCacheBucket *bucket = [self.buckets objectForKey:entry.policy];
+    [bucket.keys removeObject:key];
+    bucket.bytes -= entry.cost;
+    [self.entries removeObjectForKey:key];
+}
+
+@end
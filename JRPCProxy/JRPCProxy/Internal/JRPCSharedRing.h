@@ -0,0 +1,203 @@
+//
+//  JRPCSharedRing.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import <stdatomic.h>
+#import <sys/types.h>
+#if !defined(__linux__)
+#import <semaphore.h>
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ The layout of the shared memory region between a JRPCSharedMemoryTransport (the client) and a JRPCSharedMemoryEndpoint (the server).
+ Both ends are on the same host, so integers are in host byte order. The region holds a header, then two rings of the same capacity:
+ requests from the client to the server, then responses from the server to the client. Each ring has a single producer & a single consumer
+ (one process each), is a JRPCSharedRingHeader followed by capacity bytes, and carries frames starting on an 8 byte boundary:
+   length       uint32, of the payload, or JRPC_SHARED_RING_WRAP if the frame would not fit before the end, and the next starts at the beginning
+   tag          uint32, matching a response to its request. 0 for a notification, which has no response
+   payload      length bytes of JSON-RPC request or response
+   padding      0 to 7 bytes
+ head & tail count the bytes ever written & consumed, so their difference is the bytes in use, and either modulo capacity is an offset.
+ The producer writes whole frames, then publishes them all by storing head once; the consumer handles every frame up to head, then frees them all
+ by storing tail once. A consumer with nothing to read spins for a while, then sets consumerWaiting and sleeps until the producer rings the
+ doorbell, which the producer only does when it sees consumerWaiting, so a busy pair never makes a system call.
+ On Linux the doorbell is a futex on the doorbell word. Elsewhere it is a named semaphore per ring, since there is no public futex.
+ Each end records its process id in the region header, so the other can tell when it has exited without closing. A sleeping consumer checks
+ on Linux each time its futex wait times out, and elsewhere, where a semaphore wait cannot time out, when woken by a process exit source.
+ */
+
+#define JRPC_SHARED_REGION_MAGIC 0x315248534350524AULL // "JRPCSHR1" on a little endian host
+#define JRPC_SHARED_REGION_VERSION 2
+#define JRPC_SHARED_RING_FRAME_HEADER_LENGTH 8
+#define JRPC_SHARED_RING_ALIGNMENT 8
+#define JRPC_SHARED_RING_WRAP UINT32_MAX
+#define JRPC_SHARED_RING_MIN_CAPACITY 4096
+#define JRPC_SHARED_CACHE_LINE_SIZE 64
+// How long a consumer sleeps before checking that its producer is still running, where waits can time out
+#define JRPC_SHARED_RING_LIVENESS_INTERVAL 0.25
+// How long a producer waits for room in a full ring before giving its consumer up as hung
+#define JRPC_SHARED_RING_STALL_TIMEOUT 10.0
+
+/** The state of each end of the region, so that either can tell when the other has gone */
+typedef NS_ENUM(uint32_t, JRPCSharedPeerState) {
+    JRPCSharedPeerStateAbsent   = 0,
+    JRPCSharedPeerStateOpen     = 1,
+    JRPCSharedPeerStateClosed   = 2
+};
+
+/** Which ring of the region */
+typedef NS_ENUM(NSUInteger, JRPCSharedRingIndex) {
+    JRPCSharedRingIndexRequests     = 0,
+    JRPCSharedRingIndexResponses    = 1
+};
+
+/** The header at the start of the region */
+typedef struct JRPCSharedRegionHeader {
+    uint64_t magic;
+    uint32_t version;
+    /** The bytes of each ring after its header, a power of 2 */
+    uint32_t ringCapacity;
+    _Atomic uint32_t serverState;
+    _Atomic uint32_t clientState;
+    /** The process of each end, stored before its state is opened. 0 until then */
+    _Atomic int32_t serverPid;
+    _Atomic int32_t clientPid;
+    uint8_t padding[JRPC_SHARED_CACHE_LINE_SIZE - 32];
+} JRPCSharedRegionHeader;
+
+/** The header of a ring. Each side's fields are on cache lines of their own, so the producer & consumer do not contend for them */
+typedef struct JRPCSharedRingHeader {
+    /** Bytes ever written. Only stored by the producer */
+    _Atomic uint64_t head;
+    uint8_t headPadding[JRPC_SHARED_CACHE_LINE_SIZE - 8];
+    /** Bytes ever consumed. Only stored by the consumer */
+    _Atomic uint64_t tail;
+    uint8_t tailPadding[JRPC_SHARED_CACHE_LINE_SIZE - 8];
+    /** Non-zero while the consumer is asleep, or about to be */
+    _Atomic uint32_t consumerWaiting;
+    /** Incremented to wake the consumer. The futex word on Linux */
+    _Atomic uint32_t doorbell;
+    uint8_t doorbellPadding[JRPC_SHARED_CACHE_LINE_SIZE - 8];
+} JRPCSharedRingHeader;
+
+/** A ring of a mapped region, as seen by one process */
+typedef struct JRPCSharedRing {
+    JRPCSharedRingHeader *header;
+    uint8_t *data;
+    uint64_t capacity;
+#if !defined(__linux__)
+    /** The doorbell, SEM_FAILED until opened */
+    sem_t *doorbell;
+#endif
+} JRPCSharedRing;
+
+/** A mapped region */
+typedef struct JRPCSharedRegion {
+    void * _Nullable base;
+    size_t length;
+    JRPCSharedRegionHeader *header;
+    JRPCSharedRing rings[2];
+} JRPCSharedRegion;
+
+/** The largest payload a ring of capacity bytes can carry. Any frame up to half the capacity fits once the ring has drained, wherever it starts */
+NS_INLINE NSUInteger JRPCSharedRingMaxPayloadLength(uint64_t capacity) {
+    return (NSUInteger)(capacity / 2 - JRPC_SHARED_RING_FRAME_HEADER_LENGTH);
+}
+
+/** Returns an NSPOSIXErrorDomain error */
+FOUNDATION_EXTERN NSError *JRPCSharedPOSIXError(int code, NSString * _Nullable description);
+
+/**
+ Creates & maps a region, replacing any left under the same name, e.g. by a server that crashed
+ @param name The name of the region, starting with '/'. Apple platforms limit it to 29 characters
+ @param ringCapacity The bytes of each ring, rounded up to a power of 2 of at least JRPC_SHARED_RING_MIN_CAPACITY
+ */
+FOUNDATION_EXTERN BOOL JRPCSharedRegionCreate(NSString *name, NSUInteger ringCapacity, JRPCSharedRegion *region, NSError **error);
+
+/** Maps an existing region. Fails with EPROTO if it is not a region of this version */
+FOUNDATION_EXTERN BOOL JRPCSharedRegionOpen(NSString *name, JRPCSharedRegion *region, NSError **error);
+
+/** Unmaps a region. The other end keeps its own mapping */
+FOUNDATION_EXTERN void JRPCSharedRegionClose(JRPCSharedRegion *region);
+
+/** Removes the name of a region & its doorbells, so no other end can open it. Those mapped already are unaffected */
+FOUNDATION_EXTERN void JRPCSharedRegionUnlink(NSString *name);
+
+/**
+ Writes a frame, if there is room for it, and publishes it to the consumer, ringing the doorbell if it is asleep. Only one thread may write at a time
+ @param payload The payload, in any number of byte ranges (e.g. dispatch data), of at most JRPCSharedRingMaxPayloadLength()
+ @return NO if the ring is too full, in which case nothing is written
+ */
+FOUNDATION_EXTERN BOOL JRPCSharedRingWrite(JRPCSharedRing *ring, uint32_t tag, NSData *payload);
+
+/**
+ Writes a frame as JRPCSharedRingWrite() does, backing off while the ring is full until the consumer makes room
+ @param consumerPid The process reading the ring, or 0 if not yet known
+ @param shouldStop Checked while waiting for room
+ @param error Set to ENOTCONN if shouldStop returns YES, or ECONNRESET if the consumer's process exits or the ring stays too full for
+ JRPC_SHARED_RING_STALL_TIMEOUT, as a consumer that has stopped reading without exiting would otherwise hold up the producer forever
+ */
+FOUNDATION_EXTERN BOOL JRPCSharedRingWriteWaiting(JRPCSharedRing *ring, uint32_t tag, NSData *payload, pid_t consumerPid,
+                                                  BOOL (NS_NOESCAPE ^shouldStop)(void), NSError **error);
+
+/**
+ Passes every frame published so far to block, in the order they were written, then frees them all at once. Only one thread may read at a time
+ @param block Called with each frame's tag & payload, which is only valid until the block returns
+ @return The number of frames read
+ */
+FOUNDATION_EXTERN NSUInteger JRPCSharedRingDrain(JRPCSharedRing *ring, void (NS_NOESCAPE ^block)(uint32_t tag, const uint8_t *bytes, uint32_t length));
+
+/**
+ Waits until there is a frame to read, spinning first, then asleep until the producer rings the doorbell
+ @param spinCount The times to check for a frame before sleeping
+ @param shouldStop Checked before sleeping, after the consumer is marked as waiting, so a stop followed by JRPCSharedRingWake() is never missed
+ @discussion May return early, so callers check for frames & whether to stop again. On Linux it returns after JRPC_SHARED_RING_LIVENESS_INTERVAL
+ at most, so callers finding nothing to read check that the producer is still running
+ */
+FOUNDATION_EXTERN void JRPCSharedRingWait(JRPCSharedRing *ring, NSUInteger spinCount, BOOL (NS_NOESCAPE ^shouldStop)(void));
+
+/** Wakes the consumer whether or not there is anything to read, e.g. to tell it that its peer has closed */
+FOUNDATION_EXTERN void JRPCSharedRingWake(JRPCSharedRing *ring);
+
+/** Waits a little longer on each attempt, e.g. for room in a full ring: spinning at first, then yielding the CPU, then sleeping */
+FOUNDATION_EXTERN void JRPCSharedRingBackoff(NSUInteger attempt);
+
+/** YES unless the process has exited. A pid of 0, for an end not yet attached, is taken to be running */
+FOUNDATION_EXTERN BOOL JRPCSharedProcessIsRunning(pid_t pid);
+
+/**
+ Calls handler once the process exits, or straight away if it already has, where JRPCSharedRingWait() cannot time out
+ @return A source to cancel once the process no longer needs watching, or NULL on Linux, where sleeping consumers check for themselves
+ */
+FOUNDATION_EXTERN dispatch_source_t _Nullable JRPCSharedProcessExitSource(pid_t pid, dispatch_block_t handler);
+
+NS_ASSUME_NONNULL_END
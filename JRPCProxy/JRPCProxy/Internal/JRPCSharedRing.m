@@ -0,0 +1,449 @@
+//
+//  JRPCSharedRing.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCSharedRing.h"
+#import <fcntl.h>
+#import <sched.h>
+#import <signal.h>
+#import <time.h>
+#import <unistd.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#if defined(__linux__)
+#import <linux/futex.h>
+#import <sys/syscall.h>
+#endif
+
+// Attempts at writing to a full ring spent spinning, then yielding, before sleeping between them
+#define JRPC_SHARED_BACKOFF_SPIN_ATTEMPTS 64
+#define JRPC_SHARED_BACKOFF_YIELD_ATTEMPTS 128
+#define JRPC_SHARED_BACKOFF_SLEEP_MICROSECONDS 50
+// Attempts at writing to a full ring between checks that its consumer is still there, once sleeping between them
+#define JRPC_SHARED_BACKOFF_CHECK_ATTEMPTS 1024
+
+// Tells the core it is spinning, which saves power and lets a sibling hardware thread run
+static inline void JRPCSharedSpinPause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__arm64__) || defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// The bytes a frame with a payload of length takes in the ring, including its header & padding
+static inline uint64_t JRPCSharedRingFrameLength(uint32_t length) {
+    uint64_t frameLength = JRPC_SHARED_RING_FRAME_HEADER_LENGTH + (uint64_t)length;
+    return (frameLength + JRPC_SHARED_RING_ALIGNMENT - 1) & ~(uint64_t)(JRPC_SHARED_RING_ALIGNMENT - 1);
+}
+
+static NSTimeInterval JRPCSharedMonotonicTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (NSTimeInterval)now.tv_sec + (NSTimeInterval)now.tv_nsec / NSEC_PER_SEC;
+}
+
+static size_t JRPCSharedRegionLength(uint64_t ringCapacity) {
+    return sizeof(JRPCSharedRegionHeader) + 2 * (sizeof(JRPCSharedRingHeader) + (size_t)ringCapacity);
+}
+
+#if !defined(__linux__)
+// Each ring's doorbell is a semaphore named after the region. Returned as a string, since its UTF8String lives no longer than the string does
+static NSString *JRPCSharedDoorbellName(NSString *name, JRPCSharedRingIndex index) {
+    return [name stringByAppendingString:(JRPCSharedRingIndexRequests == index) ? @".q" : @".r"];
+}
+#endif
+
+NSError *JRPCSharedPOSIXError(int code, NSString *description) {
+    NSDictionary *userInfo = description ? @{ NSDebugDescriptionErrorKey : description } : nil;
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:code userInfo:userInfo];
+}
+
+// Clears a region, so that it can be closed whatever stage opening it fails at
+static void JRPCSharedRegionReset(JRPCSharedRegion *region) {
+    memset(region, 0, sizeof(*region));
+#if !defined(__linux__)
+    region->rings[JRPCSharedRingIndexRequests].doorbell = SEM_FAILED;
+    region->rings[JRPCSharedRingIndexResponses].doorbell = SEM_FAILED;
+#endif
+}
+
+// Maps the region open on fileDescriptor
+static BOOL JRPCSharedRegionMap(int fileDescriptor, size_t length, JRPCSharedRegion *region, NSError **error) {
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (MAP_FAILED == base) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(errno, @"Unable to map the shared region");
+        }
+        return NO;
+    }
+    region->base = base;
+    region->length = length;
+    region->header = (JRPCSharedRegionHeader*)base;
+    return YES;
+}
+
+// Points the rings at the mapped region, the requests ring first
+static void JRPCSharedRegionLocateRings(JRPCSharedRegion *region, uint64_t ringCapacity) {
+    uint8_t *ringBase = (uint8_t*)region->base + sizeof(JRPCSharedRegionHeader);
+    for (NSUInteger i = 0; i < 2; ++i) {
+        JRPCSharedRing *ring = &region->rings[i];
+        ring->header = (JRPCSharedRingHeader*)ringBase;
+        ring->data = ringBase + sizeof(JRPCSharedRingHeader);
+        ring->capacity = ringCapacity;
+        ringBase += sizeof(JRPCSharedRingHeader) + ringCapacity;
+    }
+}
+
+#if !defined(__linux__)
+static BOOL JRPCSharedRegionOpenDoorbells(NSString *name, BOOL create, JRPCSharedRegion *region, NSError **error) {
+    for (NSUInteger i = 0; i < 2; ++i) {
+        NSString *doorbellName = JRPCSharedDoorbellName(name, i);
+        sem_t *doorbell = create ? sem_open(doorbellName.UTF8String, O_CREAT | O_EXCL, S_IRUSR | S_IWUSR, 0) : sem_open(doorbellName.UTF8String, 0);
+        if (SEM_FAILED == doorbell) {
+            if (error) {
+                *error = JRPCSharedPOSIXError(errno, @"Unable to open the doorbell of the shared region");
+            }
+            return NO;
+        }
+        region->rings[i].doorbell = doorbell;
+    }
+    return YES;
+}
+#endif
+
+BOOL JRPCSharedRegionCreate(NSString *name, NSUInteger ringCapacity, JRPCSharedRegion *region, NSError **error) {
+    JRPCSharedRegionReset(region);
+    if (ringCapacity > (NSUInteger)1 << 31) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(EINVAL, @"Ring capacity is too large");
+        }
+        return NO;
+    }
+    uint64_t capacity = JRPC_SHARED_RING_MIN_CAPACITY;
+    while (capacity < ringCapacity) {
+        capacity <<= 1;
+    }
+    JRPCSharedRegionUnlink(name);
+    int fileDescriptor = shm_open(name.UTF8String, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(errno, @"Unable to create the shared region");
+        }
+        return NO;
+    }
+    // Zero filled, so both rings start empty and neither end is open
+    size_t length = JRPCSharedRegionLength(capacity);
+    BOOL mapped = NO;
+    if (0 != ftruncate(fileDescriptor, (off_t)length)) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(errno, @"Unable to size the shared region");
+        }
+    }
+    else {
+        mapped = JRPCSharedRegionMap(fileDescriptor, length, region, error);
+    }
+    close(fileDescriptor);
+    if (mapped) {
+        JRPCSharedRegionLocateRings(region, capacity);
+    }
+#if !defined(__linux__)
+    if (mapped && !JRPCSharedRegionOpenDoorbells(name, YES, region, error)) {
+        JRPCSharedRegionClose(region);
+        mapped = NO;
+    }
+#endif
+    if (!mapped) {
+        JRPCSharedRegionUnlink(name);
+        return NO;
+    }
+    JRPCSharedRegionHeader *header = region->header;
+    header->version = JRPC_SHARED_REGION_VERSION;
+    header->ringCapacity = (uint32_t)capacity;
+    // The magic goes last, so a client that opens the region before it is ready sees that it is not
+    atomic_thread_fence(memory_order_release);
+    header->magic = JRPC_SHARED_REGION_MAGIC;
+    return YES;
+}
+
+BOOL JRPCSharedRegionOpen(NSString *name, JRPCSharedRegion *region, NSError **error) {
+    JRPCSharedRegionReset(region);
+    int fileDescriptor = shm_open(name.UTF8String, O_RDWR, 0);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(errno, @"Unable to open the shared region");
+        }
+        return NO;
+    }
+    // Some platforms report the size rounded up to a whole page
+    struct stat status;
+    BOOL mapped = NO;
+    if (0 != fstat(fileDescriptor, &status)) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(errno, @"Unable to read the size of the shared region");
+        }
+    }
+    else if ((size_t)status.st_size < sizeof(JRPCSharedRegionHeader)) {
+        if (error) {
+            *error = JRPCSharedPOSIXError(EPROTO, @"Not a shared region");
+        }
+    }
+    else {
+        mapped = JRPCSharedRegionMap(fileDescriptor, (size_t)status.st_size, region, error);
+    }
+    close(fileDescriptor);
+    if (!mapped) {
+        return NO;
+    }
+    JRPCSharedRegionHeader *header = region->header;
+    // The magic is written last, so the rest of the header is read after it
+    uint64_t magic = header->magic;
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t capacity = header->ringCapacity;
+    if (JRPC_SHARED_REGION_MAGIC != magic || JRPC_SHARED_REGION_VERSION != header->version ||
+        capacity < JRPC_SHARED_RING_MIN_CAPACITY || 0 != (capacity & (capacity - 1)) || JRPCSharedRegionLength(capacity) > region->length) {
+        JRPCSharedRegionClose(region);
+        if (error) {
+            *error = JRPCSharedPOSIXError(EPROTO, @"Not a shared region of this version");
+        }
+        return NO;
+    }
+    JRPCSharedRegionLocateRings(region, capacity);
+#if !defined(__linux__)
+    if (!JRPCSharedRegionOpenDoorbells(name, NO, region, error)) {
+        JRPCSharedRegionClose(region);
+        return NO;
+    }
+#endif
+    return YES;
+}
+
+void JRPCSharedRegionClose(JRPCSharedRegion *region) {
+#if !defined(__linux__)
+    for (NSUInteger i = 0; i < 2; ++i) {
+        if (SEM_FAILED != region->rings[i].doorbell) {
+            sem_close(region->rings[i].doorbell);
+            region->rings[i].doorbell = SEM_FAILED;
+        }
+    }
+#endif
+    if (region->base) {
+        munmap(region->base, region->length);
+        region->base = NULL;
+    }
+}
+
+void JRPCSharedRegionUnlink(NSString *name) {
+    shm_unlink(name.UTF8String);
+#if !defined(__linux__)
+    NSString *requestsDoorbellName = JRPCSharedDoorbellName(name, JRPCSharedRingIndexRequests);
+    NSString *responsesDoorbellName = JRPCSharedDoorbellName(name, JRPCSharedRingIndexResponses);
+    sem_unlink(requestsDoorbellName.UTF8String);
+    sem_unlink(responsesDoorbellName.UTF8String);
+#endif
+}
+
+#pragma mark - Rings
+
+// Wakes the consumer by ringing the doorbell
+static void JRPCSharedRingRing(JRPCSharedRing *ring) {
+    atomic_fetch_add_explicit(&ring->header->doorbell, 1, memory_order_release);
+#if defined(__linux__)
+    // Not FUTEX_PRIVATE_FLAG, since the waiter is in another process
+    syscall(SYS_futex, &ring->header->doorbell, FUTEX_WAKE, 1, NULL, NULL, 0);
+#else
+    sem_post(ring->doorbell);
+#endif
+}
+
+BOOL JRPCSharedRingWrite(JRPCSharedRing *ring, uint32_t tag, NSData *payload) {
+    JRPCSharedRingHeader *header = ring->header;
+    uint64_t capacity = ring->capacity;
+    // Only this side stores head, while tail is stored by the consumer once it has finished with the frames before it
+    uint64_t head = atomic_load_explicit(&header->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&header->tail, memory_order_acquire);
+    uint32_t length = (uint32_t)payload.length;
+    uint64_t frameLength = JRPCSharedRingFrameLength(length);
+    uint64_t offset = head & (capacity - 1);
+    uint64_t untilEnd = capacity - offset;
+    // A frame that does not fit before the end leaves the rest of the ring unused
+    uint64_t needed = (frameLength > untilEnd) ? untilEnd + frameLength : frameLength;
+    if (needed > capacity - (head - tail)) {
+        return NO;
+    }
+    if (frameLength > untilEnd) {
+        uint32_t wrap = JRPC_SHARED_RING_WRAP;
+        memcpy(ring->data + offset, &wrap, sizeof(wrap));
+        head += untilEnd;
+        offset = 0;
+    }
+    uint8_t *frame = ring->data + offset;
+    memcpy(frame, &length, sizeof(length));
+    memcpy(frame + sizeof(length), &tag, sizeof(tag));
+    // Straight from each region of dispatch data, without joining them first
+    [payload enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        memcpy(frame + JRPC_SHARED_RING_FRAME_HEADER_LENGTH + byteRange.location, bytes, byteRange.length);
+    }];
+    atomic_store_explicit(&header->head, head + frameLength, memory_order_release);
+    // Pairs with the fence in JRPCSharedRingWait: either the consumer sees the new head before sleeping, or this sees that it is waiting
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&header->consumerWaiting, memory_order_relaxed) &&
+        atomic_exchange_explicit(&header->consumerWaiting, 0, memory_order_relaxed)) {
+        JRPCSharedRingRing(ring);
+    }
+    return YES;
+}
+
+BOOL JRPCSharedRingWriteWaiting(JRPCSharedRing *ring, uint32_t tag, NSData *payload, pid_t consumerPid,
+                                BOOL (NS_NOESCAPE ^shouldStop)(void), NSError **error) {
+    NSTimeInterval deadline = 0;
+    for (NSUInteger attempt = 0; !shouldStop(); ++attempt) {
+        if (JRPCSharedRingWrite(ring, tag, payload)) {
+            return YES;
+        }
+        // Checked now & then, once the wait is long enough that the check costs nothing by comparison
+        if (attempt >= JRPC_SHARED_BACKOFF_YIELD_ATTEMPTS && 0 == attempt % JRPC_SHARED_BACKOFF_CHECK_ATTEMPTS) {
+            NSTimeInterval now = JRPCSharedMonotonicTime();
+            if (0 == deadline) {
+                deadline = now + JRPC_SHARED_RING_STALL_TIMEOUT;
+            }
+            if (!JRPCSharedProcessIsRunning(consumerPid) || now >= deadline) {
+                if (error) {
+                    *error = JRPCSharedPOSIXError(ECONNRESET, @"The other end has exited or stopped reading");
+                }
+                return NO;
+            }
+        }
+        JRPCSharedRingBackoff(attempt);
+    }
+    if (error) {
+        *error = JRPCSharedPOSIXError(ENOTCONN, @"Not connected");
+    }
+    return NO;
+}
+
+NSUInteger JRPCSharedRingDrain(JRPCSharedRing *ring, void (NS_NOESCAPE ^block)(uint32_t tag, const uint8_t *bytes, uint32_t length)) {
+    JRPCSharedRingHeader *header = ring->header;
+    uint64_t capacity = ring->capacity;
+    uint64_t tail = atomic_load_explicit(&header->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&header->head, memory_order_acquire);
+    NSUInteger count = 0;
+    while (tail != head) {
+        uint64_t offset = tail & (capacity - 1);
+        uint32_t length, tag;
+        memcpy(&length, ring->data + offset, sizeof(length));
+        if (JRPC_SHARED_RING_WRAP == length) {
+            tail += capacity - offset;
+            continue;
+        }
+        if (length > JRPCSharedRingMaxPayloadLength(capacity)) {
+            // Only a producer writing out of turn leaves a frame like this, and nothing after it can be trusted
+            tail = head;
+            break;
+        }
+        memcpy(&tag, ring->data + offset + sizeof(length), sizeof(tag));
+        block(tag, ring->data + offset + JRPC_SHARED_RING_FRAME_HEADER_LENGTH, length);
+        tail += JRPCSharedRingFrameLength(length);
+        ++count;
+    }
+    // Every frame read is freed at once
+    atomic_store_explicit(&header->tail, tail, memory_order_release);
+    return count;
+}
+
+void JRPCSharedRingWait(JRPCSharedRing *ring, NSUInteger spinCount, BOOL (NS_NOESCAPE ^shouldStop)(void)) {
+    JRPCSharedRingHeader *header = ring->header;
+    uint64_t tail = atomic_load_explicit(&header->tail, memory_order_relaxed);
+    for (NSUInteger i = 0; i < spinCount; ++i) {
+        if (atomic_load_explicit(&header->head, memory_order_acquire) != tail) {
+            return;
+        }
+        JRPCSharedSpinPause();
+    }
+    // Read before checking for frames, so a doorbell rung after the check makes the futex wait return straight away
+    uint32_t doorbell = atomic_load_explicit(&header->doorbell, memory_order_acquire);
+    atomic_store_explicit(&header->consumerWaiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&header->head, memory_order_acquire) != tail || shouldStop()) {
+        atomic_store_explicit(&header->consumerWaiting, 0, memory_order_relaxed);
+        return;
+    }
+#if defined(__linux__)
+    // Woken now & then even if the doorbell never rings, so a producer that has exited is noticed
+    struct timespec timeout = { 0, (long)(JRPC_SHARED_RING_LIVENESS_INTERVAL * NSEC_PER_SEC) };
+    syscall(SYS_futex, &header->doorbell, FUTEX_WAIT, doorbell, &timeout, NULL, 0);
+#else
+    // The semaphore counts rings made before this waits, so none are missed
+    (void)doorbell;
+    while (0 != sem_wait(ring->doorbell) && EINTR == errno);
+#endif
+}
+
+void JRPCSharedRingWake(JRPCSharedRing *ring) {
+    atomic_store_explicit(&ring->header->consumerWaiting, 0, memory_order_relaxed);
+    JRPCSharedRingRing(ring);
+}
+
+void JRPCSharedRingBackoff(NSUInteger attempt) {
+    if (attempt < JRPC_SHARED_BACKOFF_SPIN_ATTEMPTS) {
+        JRPCSharedSpinPause();
+    }
+    else if (attempt < JRPC_SHARED_BACKOFF_YIELD_ATTEMPTS) {
+        sched_yield();
+    }
+    else {
+        usleep(JRPC_SHARED_BACKOFF_SLEEP_MICROSECONDS);
+    }
+}
+
+BOOL JRPCSharedProcessIsRunning(pid_t pid) {
+    // EPERM means there is a process, just one this process may not signal
+    return pid <= 0 || 0 == kill(pid, 0) || EPERM == errno;
+}
+
+dispatch_source_t JRPCSharedProcessExitSource(pid_t pid, dispatch_block_t handler) {
+#if defined(__linux__)
+    return NULL;
+#else
+    if (pid <= 0) {
+        return NULL;
+    }
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_PROC, (uintptr_t)pid, DISPATCH_PROC_EXIT,
+                                                      dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    if (source) {
+        dispatch_source_set_event_handler(source, handler);
+        dispatch_resume(source);
+    }
+    // A process that exited before it was watched never fires the source
+    if (!source || !JRPCSharedProcessIsRunning(pid)) {
+        dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), handler);
+    }
+    return source;
+#endif
+}
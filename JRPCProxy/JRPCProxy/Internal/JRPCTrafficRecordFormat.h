@@ -0,0 +1,118 @@
+//
+//  JRPCTrafficRecordFormat.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ The layout of a traffic recording file, shared by JRPCRecordingTransport, which writes it, and JRPCTrafficRecording, which maps it.
+ All integers are little endian. The file starts with a header:
+   magic        8 bytes, "JRPCREC1"
+   startTime    uint64, when recording started in nanoseconds since 1970
+ followed by records, each starting on an 8 byte boundary so the file can be read in place once mapped:
+   length       uint32, of the whole record including this header & padding
+   kind         uint8, a JRPCTrafficRecordKind
+   flags        uint8, JRPC_TRAFFIC_RECORD_FLAG_FAILED if the request failed
+   reserved     uint16, 0
+   sentTime     uint64, nanoseconds from startTime to when the request was sent
+   latency      uint64, nanoseconds from sending the request to its response or failure
+   requestLength  uint32
+   responseLength uint32
+   request      JSON text of the request object, or array of them for a batch
+   response     JSON text of the response, or for a failure an object with the "domain", "code" & "message" of the NSError. Empty for a notification
+   padding      0 to 7 zero bytes
+ A record is only complete once all its bytes are written, so a file cut short, e.g. by a crash, is read up to its last whole record
+ */
+
+#define JRPC_TRAFFIC_FILE_MAGIC "JRPCREC1"
+#define JRPC_TRAFFIC_FILE_MAGIC_LENGTH 8
+#define JRPC_TRAFFIC_FILE_HEADER_LENGTH 16
+#define JRPC_TRAFFIC_RECORD_HEADER_LENGTH 32
+#define JRPC_TRAFFIC_RECORD_ALIGNMENT 8
+#define JRPC_TRAFFIC_RECORD_FLAG_FAILED 0x01
+
+// The keys of the JSON object recorded in place of the response of a failed request
+static NSString * const kJRPCTrafficErrorDomainKey = @"domain";
+static NSString * const kJRPCTrafficErrorCodeKey = @"code";
+static NSString * const kJRPCTrafficErrorMessageKey = @"message";
+
+/** The header of a record, as it is held in memory */
+typedef struct JRPCTrafficRecordHeader {
+    uint32_t length;
+    uint8_t kind;
+    uint8_t flags;
+    uint64_t sentTime;
+    uint64_t latency;
+    uint32_t requestLength;
+    uint32_t responseLength;
+} JRPCTrafficRecordHeader;
+
+/** Returns the length of a record with a request & response of the given lengths, including padding */
+NS_INLINE NSUInteger JRPCTrafficRecordLength(NSUInteger requestLength, NSUInteger responseLength) {
+    NSUInteger length = JRPC_TRAFFIC_RECORD_HEADER_LENGTH + requestLength + responseLength;
+    return (length + JRPC_TRAFFIC_RECORD_ALIGNMENT - 1) & ~(NSUInteger)(JRPC_TRAFFIC_RECORD_ALIGNMENT - 1);
+}
+
+/** Writes a record header into JRPC_TRAFFIC_RECORD_HEADER_LENGTH bytes */
+NS_INLINE void JRPCTrafficRecordHeaderWrite(const JRPCTrafficRecordHeader *header, uint8_t *bytes) {
+    uint32_t length = CFSwapInt32HostToLittle(header->length);
+    uint64_t sentTime = CFSwapInt64HostToLittle(header->sentTime);
+    uint64_t latency = CFSwapInt64HostToLittle(header->latency);
+    uint32_t requestLength = CFSwapInt32HostToLittle(header->requestLength);
+    uint32_t responseLength = CFSwapInt32HostToLittle(header->responseLength);
+    memset(bytes, 0, JRPC_TRAFFIC_RECORD_HEADER_LENGTH);
+    memcpy(bytes, &length, 4);
+    bytes[4] = header->kind;
+    bytes[5] = header->flags;
+    memcpy(bytes + 8, &sentTime, 8);
+    memcpy(bytes + 16, &latency, 8);
+    memcpy(bytes + 24, &requestLength, 4);
+    memcpy(bytes + 28, &responseLength, 4);
+}
+
+/** Reads a record header from JRPC_TRAFFIC_RECORD_HEADER_LENGTH bytes */
+NS_INLINE void JRPCTrafficRecordHeaderRead(JRPCTrafficRecordHeader *header, const uint8_t *bytes) {
+    uint32_t length, requestLength, responseLength;
+    uint64_t sentTime, latency;
+    memcpy(&length, bytes, 4);
+    memcpy(&sentTime, bytes + 8, 8);
+    memcpy(&latency, bytes + 16, 8);
+    memcpy(&requestLength, bytes + 24, 4);
+    memcpy(&responseLength, bytes + 28, 4);
+    header->length = CFSwapInt32LittleToHost(length);
+    header->kind = bytes[4];
+    header->flags = bytes[5];
+    header->sentTime = CFSwapInt64LittleToHost(sentTime);
+    header->latency = CFSwapInt64LittleToHost(latency);
+    header->requestLength = CFSwapInt32LittleToHost(requestLength);
+    header->responseLength = CFSwapInt32LittleToHost(responseLength);
+}
+
+NS_ASSUME_NONNULL_END
@@ -28,6 +28,12 @@
  */
 
 @import Foundation;
+#import "JRPCCachePolicy.h"
+#import "JRPCCall.h"
+#import "JRPCCodec.h"
+#import "JRPCScheduling.h"
+#import "JRPCMetrics.h"
+#import "JRPCTracer.h"
 @protocol JRPCProxyTransport;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -69,6 +75,26 @@ typedef NS_ENUM(NSUInteger, JRPCParameterStructure)  {
  Note: There are no param names. The leading part of the selector IS the method name in entireity. Other params have no names including the trailing completion block
  Swift:
  @objc func <methodName>(_ param1Value:<Param1Type>, _ param2Value:<Param2Type> ... _ completion:(Any?, NSError) -> Void) -> Void
+ 
+ NOTIFICATIONS:
+ A method without a completion block is sent as a JSON-RPC notification (a request without an id) and no response is expected. e.g.
+ - (void) <methodName>With<Param1Name>:(Param1Type)param1Value ...         (BY-NAME)
+ - (void) methodName:(Param1Type)param1Value ...                           (BY-POSITION)
+ - (void) methodName                                                       (either, without params)
+ Notifications are sent as soon as they are called, and are never batched
+ 
+ STREAMING ARRAY RESULTS:
+ A completion block with a BOOL done param between the result & error is passed the elements of an array result rather than the whole array, e.g.
+ - (void) <methodName>...:(void (^)(<Element Class> *element, BOOL done, NSError *error))completion    (each element, with done NO)
+ - (void) <methodName>...:(void (^)(NSArray *chunk, BOOL done, NSError *error))completion               (chunks of elements, with done NO)
+ followed by a last call with a nil element/chunk and done YES, with any error. Elements are created from the response as they are passed, so only
+ one element or chunk of a large result is ever held as objects. See setResultChunkSize:elementClass:forSelector:
+ 
+ THREAD SAFETY:
+ A proxy may be called from any number of threads at once, without locking around it. Every call gets its own request id, and the state
+ shared between calls is either immutable after the proxy is created (the method descriptors), read without locks (settings), or locked
+ per method or request rather than across the proxy. Calls only contend with each other when they share a response cache or a concurrency limit.
+ Settings may be changed from any thread at any time, and apply to calls made afterwards.
 */
 @interface JRPCAbstractProxy : NSProxy
 
@@ -88,7 +114,155 @@ typedef NS_ENUM(NSUInteger, JRPCParameterStructure)  {
  The dispatch queue that will be used to call the completion blocks of proxied protocol methods
  If nil (the default) then the result of calling dispatch_get_main_queue() will be used
  */
-@property(nonatomic, strong, nullable) dispatch_queue_t rpcCompletionQueue;
+@property(atomic, strong, nullable) dispatch_queue_t rpcCompletionQueue;
+
+/**
+ If YES, and rpcCompletionQueue is not the main queue, responses are parsed on rpcCompletionQueue and completion blocks are called straight away
+ on the same thread, with no further dispatch. Suitable for a concurrent or otherwise lightly loaded rpcCompletionQueue. Defaults to NO
+ @discussion Otherwise responses are parsed on an internal queue and each completion block is dispatched once to rpcCompletionQueue.
+ When the transport performs JSON serialization, the response is always handled on rpcCompletionQueue and completion blocks are called inline
+ */
+@property(atomic, assign) BOOL invokesCompletionBlocksInline;
+
+/**
+ Calls made within this many seconds of the first call of a batch are sent together in a single JSON-RPC batch request, and their responses are
+ passed back to each call's completion block by request id. 0 (the default) disables batching
+ @discussion Batching requires the transport to implement the batch method matching its serialization strategy (see JRPCProxyTransport), otherwise calls are sent individually
+ */
+@property(atomic, assign) NSTimeInterval batchWindow;
+
+/** The maximum number of calls in a batch. A full batch is sent without waiting for batchWindow to elapse. 0 (the default) for no limit */
+@property(atomic, assign) NSUInteger maxBatchSize;
+
+/**
+ The maximum size in bytes of the requests in a batch. A call that would take a batch over this size is sent in the next batch. 0 (the default) for no limit
+ Only applies when the proxy performs serialization, since the size of request objects is not known
+ */
+@property(atomic, assign) NSUInteger maxBatchBytes;
+
+/**
+ The codecs the proxy may encode requests & decode responses with, in order of preference. Defaults to a single JRPCJSONCodec
+ The first codec whose name is in the transport's supportedCodecNames is used, and the transport told with useCodecWithName: (see JRPCProxyTransport).
+ A transport that does not implement supportedCodecNames only supports JSON. Raises NSInvalidArgumentException if the transport supports none of the codecs
+ @discussion Only used when the proxy performs serialization. Set before making calls, since responses are decoded with the codec in use when they arrive
+ */
+@property(atomic, copy) NSArray<id<JRPCCodec>> *codecs;
+
+/** The codec negotiated with the transport from codecs, or nil if the transport performs serialization */
+@property(atomic, readonly, nullable) id<JRPCCodec> codec;
+
+/** Sends any calls waiting to be batched immediately, without waiting for batchWindow to elapse */
+- (void) flushBatch;
+
+/**
+ Caches the responses of a method, and shares a single request between identical calls made while one is in flight
+ Calls are identical when they have the same method name & params, regardless of the order of keys in dictionary params. Errors are never cached.
+ Only set a policy for methods that are idempotent
+ @param policy The cache policy for the method, or nil (the default) to stop caching it. Responses cached under a previous policy are no longer returned
+ @param selector A method of the proxied protocol with a completion block. Raises NSInvalidArgumentException for any other selector
+ */
+- (void) setCachePolicy:(nullable JRPCCachePolicy*)policy forSelector:(SEL)selector;
+
+/**
+ The number of seconds after a call is made to give up waiting for its response, and call its completion block with a JRPCErrorTimedOutCode error.
+ 0 (the default) for no timeout. See also setTimeout:forSelector:
+ @discussion The transport is told it can drop a request that times out, if it implements cancelJSONRPCRequestWithId:, and a response that arrives later is discarded
+ */
+@property(atomic, assign) NSTimeInterval defaultTimeout;
+
+/**
+ Sets the timeout of a method, overriding defaultTimeout
+ @param timeout The timeout in seconds, 0 for no timeout, or negative to use defaultTimeout again
+ @param selector A method of the proxied protocol with a completion block. Raises NSInvalidArgumentException for any other selector
+ */
+- (void) setTimeout:(NSTimeInterval)timeout forSelector:(SEL)selector;
+
+/**
+ Makes a call of the proxied protocol and returns a handle for it, which can be used to cancel it
+ e.g. id<JRPCCall> call = [proxy callWithHandle:^{ [proxy fetchWithId:42 completion:^(id result, NSError *error) { ... }]; }];
+ @param call A block that calls a method of the proxy, on the current thread
+ @return A handle to the first call the block made, or nil if it made none (notifications have no handle)
+ @discussion Calls to a cached method that share an identical request in flight are cancelled individually, but cancelling or timing out the call
+ that sent the request completes all of them
+ */
+- (nullable id<JRPCCall>) callWithHandle:(void (NS_NOESCAPE ^)(void))call;
+
+/**
+ The most calls sent and awaiting a response at once. Further calls wait in a queue for their method's priority (see setPriority:forSelector:),
+ and are sent highest priority first as responses arrive. 0 (the default) for no limit, when calls are sent as soon as they are made
+ @discussion Notifications are never held back, and calls answered from the response cache are not counted
+ */
+@property(atomic, assign) NSUInteger maxConcurrentCalls;
+
+/**
+ If YES (the default), the number of calls in flight adapts to the latency of responses, up to maxConcurrentCalls: it grows while responses arrive
+ within twice the lowest latency recently seen, and shrinks when they are slower or calls time out. If NO it is always maxConcurrentCalls
+ */
+@property(atomic, assign) BOOL adaptsConcurrencyLimit;
+
+/**
+ Sets the priority of a method's calls, when maxConcurrentCalls limits the calls in flight. Methods default to JRPCCallPriorityDefault
+ @param priority The priority of the method's calls
+ @param selector A method of the proxied protocol with a completion block. Raises NSInvalidArgumentException for any other selector
+ */
+- (void) setPriority:(JRPCCallPriority)priority forSelector:(SEL)selector;
+
+/** Queue depths, wait times and the current limit of calls in flight. See maxConcurrentCalls */
+@property(nonatomic, readonly) JRPCSchedulerStatistics schedulerStatistics;
+
+/** Discards all cached responses. Requests already in flight are unaffected */
+- (void) removeAllCachedResponses;
+
+/** The response cache counters, across all methods */
+@property(nonatomic, readonly) JRPCCacheStatistics cacheStatistics;
+
+/**
+ If YES, the proxy records the latency of each method's calls and of each phase of them, and counts errors, bytes and calls in flight. Defaults to NO
+ @discussion Metrics are recorded without locks. While disabled, a call checks this flag once, and nothing is timed or counted.
+ Calls answered from the response cache are not recorded. Disabling keeps the metrics recorded so far, to be continued if enabled again
+ */
+@property(atomic, assign) BOOL metricsEnabled;
+
+/** The metrics recorded since they were first enabled or last reset, or nil if metrics are disabled */
+@property(nonatomic, readonly, nullable) JRPCMetricsSnapshot *metricsSnapshot;
+
+/** Discards the metrics recorded so far, except the count of calls in flight */
+- (void) resetMetrics;
+
+/** Told the proxy's metrics every metricsReportInterval, on rpcCompletionQueue, while metrics are enabled */
+@property(atomic, weak, nullable) id<JRPCMetricsDelegate> metricsDelegate;
+
+/** The seconds between reports to metricsDelegate. 0 (the default) for no reports */
+@property(atomic, assign) NSTimeInterval metricsReportInterval;
+
+/**
+ The tracer that sampled calls write their spans to, or nil (the default) for no tracing. See JRPCTracer
+ @discussion While nil, a call checks it once and nothing is traced. Calls answered from the response cache are not traced.
+ The phases of a batch are written to the trace of each call in it
+ */
+@property(atomic, strong, nullable) JRPCTracer *tracer;
+
+/**
+ If YES, traced requests carry their trace context in a JRPCTraceContextKey member, so that a server (e.g. a JRPCDispatcher with a tracer) can
+ join the trace. Defaults to NO, as servers may reject requests with members the specification does not define
+ */
+@property(atomic, assign) BOOL injectsTraceContext;
+
+/**
+ Sets the fraction of a method's calls that are traced, overriding the tracer's sampleRate
+ @param sampleRate The fraction from 0 to 1, e.g. 0.01 to trace 1% of calls, or negative to use the tracer's sampleRate again
+ @param selector A method of the proxied protocol. Raises NSInvalidArgumentException for any other selector
+ */
+- (void) setTraceSampleRate:(double)sampleRate forSelector:(SEL)selector;
+
+/**
+ Sets how a method whose completion block streams its result in chunks (see STREAMING ARRAY RESULTS above) is passed the elements
+ @param chunkSize The number of elements in each chunk but the last, which may have fewer. Defaults to 100
+ @param elementClass The class to transform each element to (see JRPCTransformable), or Nil (the default) to pass the elements as they are.
+ An element that is neither of this class nor can be transformed to it ends the stream with a JRPCErrorResponseSerializationCode error
+ @param selector A method of the proxied protocol with a completion block. Raises NSInvalidArgumentException for any other selector
+ */
+- (void) setResultChunkSize:(NSUInteger)chunkSize elementClass:(nullable Class)elementClass forSelector:(SEL)selector;
 
 /** init is unavailable */
 - (instancetype) init __attribute__((unavailable("init is not available, use proxyForProtocol:transport: class method")));
@@ -29,25 +29,98 @@
 
 #import "JRPCAbstractProxy.h"
 #import "JRPCProxyTransport.h"
-#import "JRPCTransformable.h"
 #import "NSDictionary+JSONRPC.h"
 #import "JRPCError.h"
-#import "CTBlockDescription.h"
+#import "JRPCMethodDescriptor.h"
+#import "JRPCResponse.h"
+#import "JRPCPendingRequest.h"
+#import "JRPCResponseCache.h"
+#import "JRPCCallScheduler.h"
+#import "JRPCJSONReader.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCAtomicReference.h"
+#import "JRPCDispatchData.h"
+#import "JRPCMetricsRecorder.h"
+#import "JRPCCallTrace.h"
 #import <objc/runtime.h>
+#import <pthread.h>
+#import <stdatomic.h>
 
 // JSON-RPC Version
 static const NSString * const kJSONRPCVersion = @"2.0";
 
-@interface JRPCAbstractProxy()
+@interface JRPCAbstractProxy() {
+    // Incremented atomically, so calls made at once on different threads never share an id
+    _Atomic(NSUInteger) _nextRequestId;
+    // Read on every call, so without the lock an atomic property takes
+    JRPCAtomicReference _rpcCompletionQueueReference;
+    JRPCAtomicReference _codecReference;
+    // Checked once per call. The recorder is created when metrics are first enabled, and kept
+    _Atomic(bool) _metricsEnabled;
+    JRPCAtomicReference _metricsReference;
+    // Guards the report timer & its interval
+    pthread_mutex_t _metricsTimerLock;
+    NSTimeInterval _metricsReportInterval;
+    // Checked once per call, so tracing costs nothing while it is nil
+    JRPCAtomicReference _tracerReference;
+}
 @property (nonatomic, strong) Protocol *protocol;
 @property (nonatomic, assign) JRPCParameterStructure paramStructure;
 @property (nonatomic, strong) id<JRPCProxyTransport> transport;
 @property (nonatomic, assign) BOOL transportPerformsSerialization;
+// Set when the proxy performs serialization, and the transport takes & returns dispatch data
+@property (nonatomic, assign) BOOL transportUsesDispatchData;
+// Root of the proxy's internal queues, which all target it
+@property (nonatomic, strong) dispatch_queue_t rootQueue;
 @property (nonatomic, strong) dispatch_queue_t serializationQueue;
-@property (atomic) NSUInteger jsonRPCRequestId;
+@property (nonatomic, assign) CFDictionaryRef methodDescriptors;
+@property (nonatomic, assign) BOOL transportSupportsBatches;
+@property (nonatomic, assign) BOOL transportSupportsNotifications;
+@property (nonatomic, assign) BOOL transportSupportsCancellation;
+@property (nonatomic, strong) dispatch_queue_t batchQueue;
+// The batch being collected, only accessed on batchQueue
+@property (nonatomic, strong) NSMutableArray<JRPCPendingRequest*> *pendingBatch;
+@property (nonatomic, assign) NSUInteger pendingBatchBytes;
+@property (nonatomic, assign) NSUInteger batchGeneration;
+@property (nonatomic, strong) JRPCResponseCache *responseCache;
+@property (nonatomic, strong) JRPCCallScheduler *scheduler;
+@property (atomic, copy) NSArray<id<JRPCCodec>> *preferredCodecs;
+@property (atomic, strong) id<JRPCCodec> codec;
+// Reports to metricsDelegate, only accessed with _metricsTimerLock held
+@property (nonatomic, strong) dispatch_source_t metricsTimer;
 @end
 
+static const char *JSON_RPC_ROOT_QUEUE_NAME = "JRPCAbstractProxyQueue";
 static const char *JSON_RPC_SERIALIZATION_QUEUE_NAME = "JRPCAbstractProxySerializationQueue";
+static const char *JSON_RPC_BATCH_QUEUE_NAME = "JRPCAbstractProxyBatchQueue";
+
+// The proxy encodes & scans JSON itself rather than calling the default JSON codec. Subclasses may encode differently, so are called like any other codec
+static inline BOOL JRPCCodecIsJSON(id<JRPCCodec> codec) {
+    return [codec isMemberOfClass:[JRPCJSONCodec class]];
+}
+
+// Thread specific slot holding the array that collects the handle of the call made inside callWithHandle:, or NULL outside it
+static pthread_key_t JRPCCallCaptureKey(void) {
+    static pthread_key_t key;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&key, NULL);
+    });
+    return key;
+}
+
+// The start time of a phase of a batch, or 0 if it is neither recorded in metrics nor traced
+static uint64_t JRPCBatchStartTime(NSArray<JRPCPendingRequest*> *batch) {
+    if (batch.firstObject.metrics) {
+        return JRPCHistogramNow();
+    }
+    for (JRPCPendingRequest *request in batch) {
+        if (request.trace) {
+            return JRPCHistogramNow();
+        }
+    }
+    return 0;
+}
 
 @implementation JRPCAbstractProxy
 
@@ -62,458 +135,1219 @@ static const char *JSON_RPC_SERIALIZATION_QUEUE_NAME = "JRPCAbstractProxySeriali
 - (id) initWithProtocol:(Protocol *)protocol
          paramStructure:(JRPCParameterStructure)paramStructure
               transport:(id<JRPCProxyTransport>)transport {
+    atomic_init(&_nextRequestId, 0);
+    JRPCAtomicReferenceInit(&_rpcCompletionQueueReference);
+    JRPCAtomicReferenceInit(&_codecReference);
+    atomic_init(&_metricsEnabled, false);
+    JRPCAtomicReferenceInit(&_metricsReference);
+    pthread_mutex_init(&_metricsTimerLock, NULL);
+    JRPCAtomicReferenceInit(&_tracerReference);
     // Verify that the transport implements AT LEAST one of the optional transport methods:
     self.transportPerformsSerialization = [transport respondsToSelector:@selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:)];
-    if (!self.transportPerformsSerialization &&
+    self.transportUsesDispatchData = !self.transportPerformsSerialization &&
+        [transport respondsToSelector:@selector(sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion:)];
+    if (!self.transportPerformsSerialization && !self.transportUsesDispatchData &&
         ![transport respondsToSelector:@selector(sendJSONRPCPayloadWithRequestData:completionQueue:completion:)]) {
         [NSException raise:NSInvalidArgumentException format:@"transport MUST implement at least one method"];
         return nil;
     }
-    // TODO: validate type encodings of protocol methods as per parameter structure and fail if necessary by returning nil
+    // Parse & validate the protocol methods up front. This will raise if any method does not follow convention
+    self.methodDescriptors = [[self class] newMethodDescriptorsForProtocol:protocol paramStructure:paramStructure];
     self.protocol = protocol;
     self.paramStructure = paramStructure;
     self.transport = transport;
-    if (!self.transportPerformsSerialization) {
-        self.serializationQueue = dispatch_queue_create(JSON_RPC_SERIALIZATION_QUEUE_NAME, DISPATCH_QUEUE_CONCURRENT);
+    // None of the proxy's own work is done on the main queue
+    self.rootQueue = dispatch_queue_create(JSON_RPC_ROOT_QUEUE_NAME, DISPATCH_QUEUE_CONCURRENT);
+    self.serializationQueue = dispatch_queue_create(JSON_RPC_SERIALIZATION_QUEUE_NAME, DISPATCH_QUEUE_CONCURRENT);
+    dispatch_set_target_queue(self.serializationQueue, self.rootQueue);
+    // Batches are sent with the batch method matching the transport's serialization strategy.
+    // Likewise notifications, otherwise they are sent as requests and the response is ignored
+    if (self.transportPerformsSerialization) {
+        self.transportSupportsBatches = [transport respondsToSelector:@selector(sendJSONRPCBatchPayloadWithRequestObjects:completionQueue:completion:)];
+        self.transportSupportsNotifications = [transport respondsToSelector:@selector(sendJSONRPCNotificationWithRequestObject:)];
+    }
+    else if (self.transportUsesDispatchData) {
+        self.transportSupportsBatches = [transport respondsToSelector:@selector(sendJSONRPCBatchPayloadWithRequestDispatchData:completionQueue:completion:)];
+        self.transportSupportsNotifications = [transport respondsToSelector:@selector(sendJSONRPCNotificationWithRequestDispatchData:)];
+    }
+    else {
+        self.transportSupportsBatches = [transport respondsToSelector:@selector(sendJSONRPCBatchPayloadWithRequestData:completionQueue:completion:)];
+        self.transportSupportsNotifications = [transport respondsToSelector:@selector(sendJSONRPCNotificationWithRequestData:)];
+    }
+    self.transportSupportsCancellation = [transport respondsToSelector:@selector(cancelJSONRPCRequestWithId:)];
+    self.codecs = @[ [[JRPCJSONCodec alloc] init] ];
+    if (self.transportSupportsBatches) {
+        self.batchQueue = dispatch_queue_create(JSON_RPC_BATCH_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(self.batchQueue, self.rootQueue);
+        self.pendingBatch = [[NSMutableArray alloc] init];
     }
-    self.jsonRPCRequestId = 0;
+    self.responseCache = [[JRPCResponseCache alloc] init];
+    __weak typeof(self) weakSelf = self;
+    self.scheduler = [[JRPCCallScheduler alloc] initWithSendBlock:^(JRPCPendingRequest *request) {
+        [weakSelf sendPendingRequest:request];
+    }];
     return self;
 }
 
-- (dispatch_queue_t) rpcCompletionQueue {
-    return _rpcCompletionQueue ? : dispatch_get_main_queue();
-}
-
-- (dispatch_queue_t) serializationQueue {
-    return _serializationQueue ? : dispatch_get_main_queue();
-}
-
-- (NSArray*) paramValuesFromInvocation:(NSInvocation*)invocation {
-    // first arg is self, second arg is SEL (_cmd), last arg is completion block
-    NSMutableArray *paramValues = [[NSMutableArray alloc] initWithCapacity:invocation.methodSignature.numberOfArguments - 3];
-    for (int i = 2; i < invocation.methodSignature.numberOfArguments - 1; ++i) {
-        // Look up the Objective-C runtime type encoding for the argument
-        // See https://developer.apple.com/library/mac/documentation/Cocoa/Conceptual/ObjCRuntimeGuide/Articles/ocrtTypeEncodings.html
-        const char *argTypeEncoding = [invocation.methodSignature getArgumentTypeAtIndex:i];
-        if (1 == strlen(argTypeEncoding))
-        {
-            // We only support SOME of the basic types
-            char encodedType = argTypeEncoding[0];
-            switch (encodedType) {
-                case 'B':   // A C++ bool or a C99 _Bool (Swift bridges booleans to this!)
-                {
-                    _Bool value = false;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithBool:value]];
-               }
-                    break;
-                case 'c':   // char => box in NSNumber
-                {
-                    char value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithChar:value]];
-                }
-                    break;
-                case 'i':   // int => box in NSNumber
-                {
-                    int value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithInt:value]];
-                }
-                    break;
-                case 's':   // short => box in NSNumber
-                {
-                    short value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithShort:value]];
-                }
-                    break;
-                case 'l':   // long, treated as 32-bit on 64-bit systems => box in NSNumber
-                {
-                    long value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithLong:value]];
-                }
-                    break;
-                case 'q':   // long long => box in NSNumber
-                {
-                    long long value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithLongLong:value]];
-                }
-                    break;
-                case 'C':   // unsigned char => box in NSNumber
-                {
-                    unsigned char value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithUnsignedChar:value]];
-                }
-                    break;
-                case 'I':   // unsigned int => box in NSNumber
-                {
-                    unsigned int value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithUnsignedInt:value]];
-                }
-                    break;
-                case 'S':   // unsigned short => box in NSNumber
-                {
-                    unsigned short value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithUnsignedShort:value]];
-                }
-                    break;
-                case 'L':   // unsigned long => box in NSNumber
-                {
-                    unsigned long value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithUnsignedLong:value]];
-                }
-                    break;
-                case 'Q':   // unsigned long long => box in NSNumber
-                {
-                    unsigned long long value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithUnsignedLongLong:value]];
-                }
-                    break;
-                case 'f':   // float => box in NSNumber
-                {
-                    float value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithFloat:value]];
-                }
-                    break;
-                case 'd':   // double => box in NSNumber
-                {
-                    double value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSNumber numberWithDouble:value]];
-                }
-                    break;
-                case '*':   // character string => box in NSString
-                {
-                    char *value = 0;
-                    [invocation getArgument:&value atIndex:i];
-                    [paramValues addObject:[NSString stringWithFormat:@"%s", value]];
-                }
-                    break;
-                case '@':   // Objects
-                {
-                    __unsafe_unretained NSObject *obj = nil;
-                    [invocation getArgument:&obj atIndex:i];
-                    // Process optional transformation of parameter if not natively JSON serializable
-                    obj = [self transformedJSONParameterForParameter:obj];
-                    // Ensure transformed result is JSON serializable
-                    if ([[self class] isValidJSONObject:obj]) {
-                        // JSON serializable parameters are added directly to the JSON-RPC request parameters
-                        [paramValues addObject:obj];
-                    } else {
-                        // Not JSON serializable
-                        [NSException raise:NSInvalidArgumentException format:@"Unsupported object type for param at index=%li, obj=%@", (long)i-2, obj];
-                    }
+- (void) dealloc {
+    if (_methodDescriptors) {
+        CFRelease(_methodDescriptors);
+    }
+    JRPCAtomicReferenceDestroy(&_rpcCompletionQueueReference);
+    JRPCAtomicReferenceDestroy(&_codecReference);
+    if (_metricsTimer) {
+        dispatch_source_cancel(_metricsTimer);
+    }
+    JRPCAtomicReferenceDestroy(&_metricsReference);
+    pthread_mutex_destroy(&_metricsTimerLock);
+    JRPCAtomicReferenceDestroy(&_tracerReference);
+}
 
-                }
-                    break;
-                default:
-                    [NSException raise:NSInvalidArgumentException format:@"Unsupported param type %s for param at index %li",argTypeEncoding, (long)i-2];
-                    break;
-            }
-        }
-        else {
-            [NSException raise:NSInvalidArgumentException format:@"Unsupported param type encoding %s for param at index %li", argTypeEncoding, (long)i-2];
++ (CFDictionaryRef) newMethodDescriptorsForProtocol:(Protocol *)protocol
+                                     paramStructure:(JRPCParameterStructure)paramStructure CF_RETURNS_RETAINED {
+    // Table of JRPCMethodDescriptor keyed by SEL. It is never mutated after init, so is safe to read from any thread
+    CFMutableDictionaryRef methodDescriptors = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+    [self addMethodDescriptorsForProtocol:protocol paramStructure:paramStructure toTable:methodDescriptors];
+    CFDictionaryRef immutableMethodDescriptors = CFDictionaryCreateCopy(kCFAllocatorDefault, methodDescriptors);
+    CFRelease(methodDescriptors);
+    return immutableMethodDescriptors;
+}
+
++ (void) addMethodDescriptorsForProtocol:(Protocol *)protocol
+                          paramStructure:(JRPCParameterStructure)paramStructure
+                                 toTable:(CFMutableDictionaryRef)methodDescriptors {
+    // Only required instance methods are supported
+    unsigned int methodCount = 0;
+    struct objc_method_description *methodDescs = protocol_copyMethodDescriptionList(protocol, YES, YES, &methodCount);
+    for (unsigned int i = 0; i < methodCount; ++i) {
+        JRPCMethodDescriptor *descriptor = [JRPCMethodDescriptor descriptorWithMethodDescription:methodDescs[i] paramStructure:paramStructure];
+        CFDictionarySetValue(methodDescriptors, descriptor.selector, (__bridge const void *)descriptor);
+    }
+    free(methodDescs);
+    // Include the methods of adopted protocols, except NSObject which is implemented by NSProxy itself
+    unsigned int protocolCount = 0;
+    Protocol * __unsafe_unretained *protocols = protocol_copyProtocolList(protocol, &protocolCount);
+    for (unsigned int i = 0; i < protocolCount; ++i) {
+        if (!protocol_isEqual(protocols[i], @protocol(NSObject))) {
+            [self addMethodDescriptorsForProtocol:protocols[i] paramStructure:paramStructure toTable:methodDescriptors];
         }
     }
-    return [paramValues copy];  // copy strips mutability
+    free(protocols);
+}
+
+- (JRPCMethodDescriptor*) descriptorForSelector:(SEL)selector {
+    return (__bridge JRPCMethodDescriptor*)CFDictionaryGetValue(self.methodDescriptors, selector);
+}
+
+- (dispatch_queue_t) rpcCompletionQueue {
+    return JRPCAtomicReferenceLoad(&_rpcCompletionQueueReference) ? : dispatch_get_main_queue();
+}
+
+- (void) setRpcCompletionQueue:(dispatch_queue_t)rpcCompletionQueue {
+    JRPCAtomicReferenceStore(&_rpcCompletionQueueReference, rpcCompletionQueue);
+}
+
+- (NSUInteger) nextRequestId {
+    // Only uniqueness matters, not ordering with other memory, so relaxed is enough
+    return atomic_fetch_add_explicit(&_nextRequestId, 1, memory_order_relaxed);
+}
+
+// Returns the queue the transport should call back on with the response to a request being sent now, and where to call the completion block from there.
+// Decided as each request is sent, since rpcCompletionQueue may change before its response arrives
+- (dispatch_queue_t) responseQueueWithCompletionQueue:(dispatch_queue_t *)completionQueue {
+    dispatch_queue_t rpcCompletionQueue = self.rpcCompletionQueue;
+    if (self.transportPerformsSerialization ||
+        (self.invokesCompletionBlocksInline && rpcCompletionQueue != dispatch_get_main_queue())) {
+        // The response is handled on rpcCompletionQueue, so the completion block is called inline (nil)
+        *completionQueue = nil;
+        return rpcCompletionQueue;
+    }
+    // The response is parsed on the serialization queue, then the completion block dispatched to rpcCompletionQueue
+    *completionQueue = rpcCompletionQueue;
+    return self.serializationQueue;
 }
 
-- (void) dispatchJSONRPCRequest:(NSDictionary*)jsonRPCRequest completionBlock:(id)completionBlock {
+- (void) dispatchJSONRPCRequest:(JRPCPendingRequest*)request {
+    // Released if the request was completed, e.g. timed out, before it could be sent
+    NSDictionary *payload = request.payload;
+    if (!payload) {
+        return;
+    }
     __weak typeof(self) weakSelf = self;
-    // Dispatch to transport on the main queue, handling response on RPC completion queue
-    [weakSelf.transport sendJSONRPCPayloadWithRequestObject:jsonRPCRequest completionQueue:weakSelf.rpcCompletionQueue completion:^(NSDictionary *jsonRPCResponse, NSError *transportError) {
+    dispatch_queue_t completionQueue = nil;
+    dispatch_queue_t responseQueue = [self responseQueueWithCompletionQueue:&completionQueue];
+    JRPCMetricsRecorder *metrics = request.metrics;
+    JRPCCallTrace *trace = request.trace;
+    uint64_t transportTime = JRPCPhaseStartTime(metrics, trace);
+    // Dispatch to transport, handling response on RPC completion queue
+    [self.transport sendJSONRPCPayloadWithRequestObject:payload completionQueue:responseQueue completion:^(NSDictionary *jsonRPCResponse, NSError *transportError) {
+        JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseTransport, transportTime);
         if (jsonRPCResponse) {
-            // Complete request with response object
-            [weakSelf completeJSONRPCRequest:jsonRPCRequest response:jsonRPCResponse error:nil completionBlock:completionBlock];
+            JRPCResponse *response = [JRPCResponse responseWithJSONObject:jsonRPCResponse];
+            if (response) {
+                // Complete request with response object
+                [weakSelf completeJSONRPCRequest:request response:response error:nil completionQueue:completionQueue];
+            }
+            else {
+                // Transport returned something other than a response object
+                NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:nil];
+                [weakSelf completeJSONRPCRequest:request response:nil error:error completionQueue:completionQueue];
+            }
         }
         else {
             // Transport error
             NSDictionary *userInfo = transportError ? @{ NSUnderlyingErrorKey : transportError } : nil;
             NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:userInfo];
-            [weakSelf completeJSONRPCRequest:jsonRPCRequest response:nil error:error completionBlock:completionBlock];
+            [weakSelf completeJSONRPCRequest:request response:nil error:error completionQueue:completionQueue];
         }
     }];
 }
 
-- (void) dispatchSerializedJSONRPCRequest:(NSDictionary*)jsonRPCRequest completionBlock:(id)completionBlock {
+- (void) dispatchSerializedJSONRPCRequest:(JRPCPendingRequest*)request {
+    // Released if the request was completed, e.g. timed out, before it could be sent
+    NSData *payload = request.payload;
+    if (!payload) {
+        return;
+    }
     __weak typeof(self) weakSelf = self;
-    // Serialize request
-    [self serializeJSONRPCRequest:jsonRPCRequest completion:^(NSData *jsonRPCData, NSError *reqSerError) {
-        if (jsonRPCData) {
-            // Dispatch to transport on the main queue, handling response on RPC completion queue
-            [weakSelf.transport sendJSONRPCPayloadWithRequestData:jsonRPCData completionQueue:weakSelf.rpcCompletionQueue completion:^(NSData *responseData, NSError *transportError) {
-                if (responseData) {
-                    // Deserialize response
-                    [weakSelf deserializeJSONRPCResponse:responseData completion:^(NSDictionary *jsonRPCResponse, NSError *respSerError) {
-                        if (jsonRPCResponse) {
-                            // Complete request with response object
-                            [weakSelf completeJSONRPCRequest:jsonRPCRequest response:jsonRPCResponse error:nil completionBlock:completionBlock];
-                        }
-                        else {
-                            // Response deserialization error
-                            NSDictionary *userInfo = respSerError ? @{ NSUnderlyingErrorKey : respSerError } : nil;
-                            NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:userInfo];
-                            [weakSelf completeJSONRPCRequest:jsonRPCRequest response:nil error:error completionBlock:completionBlock];
-                        }
-                    }];
+    dispatch_queue_t completionQueue = nil;
+    dispatch_queue_t responseQueue = [self responseQueueWithCompletionQueue:&completionQueue];
+    JRPCMetricsRecorder *metrics = request.metrics;
+    JRPCCallTrace *trace = request.trace;
+    [metrics recordSentPayload:payload];
+    uint64_t transportTime = JRPCPhaseStartTime(metrics, trace);
+    JRPCTransportDataCompletion completion = ^(NSData *responseData, NSError *transportError) {
+        JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseTransport, transportTime);
+        if (responseData) {
+            // Deserialize response
+            [metrics recordReceivedData:responseData];
+            uint64_t deserializationTime = JRPCPhaseStartTime(metrics, trace);
+            NSError *respSerError = nil;
+            JRPCResponse *response = [weakSelf responseFromData:responseData descriptor:request.descriptor parseResult:(nil != completionQueue) error:&respSerError];
+            JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseDeserialization, deserializationTime);
+            if (response) {
+                // Complete request with response object
+                [weakSelf completeJSONRPCRequest:request response:response error:nil completionQueue:completionQueue];
+            }
+            else {
+                // Response deserialization error
+                NSDictionary *userInfo = respSerError ? @{ NSUnderlyingErrorKey : respSerError } : nil;
+                NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:userInfo];
+                [weakSelf completeJSONRPCRequest:request response:nil error:error completionQueue:completionQueue];
+            }
+        }
+        else {
+            // Transport error
+            NSDictionary *userInfo = transportError ? @{ NSUnderlyingErrorKey : transportError } : nil;
+            NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:userInfo];
+            [weakSelf completeJSONRPCRequest:request response:nil error:error completionQueue:completionQueue];
+        }
+    };
+    // Dispatch pre-encoded request to transport, which calls back on the queue the response is parsed on
+    if (self.transportUsesDispatchData) {
+        [self.transport sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload completionQueue:responseQueue completion:^(dispatch_data_t responseData, NSError *transportError) {
+            // Dispatch data is an NSData, and is scanned in its regions when parsed
+            completion((NSData*)responseData, transportError);
+        }];
+    }
+    else {
+        [self.transport sendJSONRPCPayloadWithRequestData:payload completionQueue:responseQueue completion:completion];
+    }
+}
+
+- (JRPCResponse*) responseFromData:(NSData*)responseData descriptor:(JRPCMethodDescriptor*)descriptor parseResult:(BOOL)parseResult error:(NSError**)error {
+    JRPCResponse *response = nil;
+    id<JRPCCodec> codec = self.codec;
+    if (JRPCCodecIsJSON(codec)) {
+        // Only the envelope is scanned here, the result & error are parsed when needed
+        response = [self responseWithJSONData:responseData range:NSMakeRange(0, responseData.length)];
+    }
+    else {
+        id responseObject = [codec decodeData:responseData error:error];
+        if (!responseObject) {
+            return nil;
+        }
+        response = [JRPCResponse responseWithJSONObject:responseObject];
+    }
+    if (!response) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                     userInfo:@{ NSDebugDescriptionErrorKey : @"Response is not a valid JSON-RPC response object" }];
+        }
+        return nil;
+    }
+    if (parseResult) {
+        [self prepareResponse:response descriptor:descriptor];
+    }
+    return response;
+}
+
+// Dispatch data from the transport is scanned across its regions, rather than asking it for its bytes which would join them
+- (JRPCResponse*) responseWithJSONData:(NSData*)responseData range:(NSRange)range {
+    if (self.transportUsesDispatchData) {
+        return [JRPCResponse responseWithDispatchData:(dispatch_data_t)responseData range:range];
+    }
+    return [JRPCResponse responseWithData:responseData range:range];
+}
+
+- (void) prepareResponse:(JRPCResponse*)response descriptor:(JRPCMethodDescriptor*)descriptor {
+    JRPCCompletionThunk *thunk = descriptor.completionThunk;
+    if (!response.hasError && '@' == thunk.resultType && !thunk.streamsResult) {
+        // The completion block needs an object result, so create it now rather than on the completion queue
+        [thunk prepareResultOfResponse:response];
+    }
+}
+
+// Returns NO if the request had already been completed, e.g. it timed out or was cancelled, in which case the response is discarded
+- (BOOL) completeJSONRPCRequest:(JRPCPendingRequest*)request
+                       response:(JRPCResponse*)response
+                          error:(NSError*)error
+                completionQueue:(dispatch_queue_t)completionQueue {
+    // Read first, since completing the request releases its trace
+    JRPCCallTrace *trace = request.trace;
+    id completionBlock = nil;
+    if (![request takeCompletionBlock:&completionBlock]) {
+        return NO;
+    }
+    if (request.isScheduled) {
+        // Free the request's slot, letting the next call waiting through
+        BOOL timedOut = (!response && JRPCErrorTimedOutCode == error.code && [JRPCErrorDomain isEqualToString:error.domain]);
+        [self.scheduler completeRequest:request timedOut:timedOut];
+    }
+    // Map any JSON-RPC error returned by the server into an NSError
+    if (response.hasError) {
+        error = [self errorForServerResponse:response];
+        response = nil;
+    }
+    JRPCMetricsRecorder *metrics = request.metrics;
+    [metrics recordError:error];
+    NSArray<JRPCPendingRequest*> *waiters = nil;
+    if (request.cacheKey) {
+        // Cache the response if its result can be parsed, and complete every call waiting on this request with it
+        NSError *resultError = nil;
+        if (response) {
+            [response resultWithError:&resultError];
+        }
+        JRPCResponse *cacheResponse = (response && !resultError) ? response : nil;
+        waiters = [self.responseCache completeRequest:request
+                                               forKey:request.cacheKey
+                                             response:cacheResponse
+                                               policy:request.descriptor.cachePolicy];
+    }
+    uint64_t dispatchTime = JRPCPhaseStartTime(metrics, trace);
+    void (^complete)(void) = ^{
+        if (completionQueue) {
+            JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseCompletionQueue, dispatchTime);
+        }
+        [metrics endRequest:request];
+        [trace finishWithError:error];
+        // Requests that only refresh the cache have no completion block. Calls sharing a response each get their own copy
+        if (completionBlock) {
+            [self invokeCompletionBlock:completionBlock descriptor:request.descriptor response:(waiters.count > 0 ? [response copy] : response) error:error];
+        }
+        for (JRPCPendingRequest *waiter in waiters) {
+            // Waiters that timed out or were cancelled have already been completed
+            id waiterCompletionBlock = nil;
+            if ([waiter takeCompletionBlock:&waiterCompletionBlock] && waiterCompletionBlock) {
+                [self invokeCompletionBlock:waiterCompletionBlock descriptor:waiter.descriptor response:[response copy] error:error];
+            }
+        }
+    };
+    // complete with result/error, inline if already on the RPC completion queue
+    if (completionQueue) {
+        dispatch_async(completionQueue, complete);
+    }
+    else {
+        complete();
+    }
+    return YES;
+}
+
+- (NSError*) errorForServerResponse:(JRPCResponse*)response {
+    NSDictionary* jsonRPCError = response.error;
+    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+    NSNumber *jsonErrorCode = jsonRPCError[kJSONRPCErrorCodeKey];
+    NSString *jsonErrorMsg = jsonRPCError[kJSONRPCErrorMessageKey];
+    id jsonErrorData = jsonRPCError[kJSONRPCErrorDataKey];
+    if (jsonErrorCode) {
+        userInfo[kJRPCErrorCodeKey] = jsonErrorCode;
+    }
+    if (jsonErrorMsg) {
+        userInfo[kJRPCErrorMessageKey] = jsonErrorMsg;
+    }
+    if (jsonErrorData) {
+        userInfo[kJRPCErrorDataKey] = jsonErrorData;
+    }
+    return [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorServerResponseCode userInfo:[userInfo copy]];
+}
+
+#pragma mark - Batching
+
+- (void) flushBatch {
+    if (self.transportSupportsBatches) {
+        dispatch_async(self.batchQueue, ^{
+            [self sendPendingBatch];
+        });
+    }
+}
+
+- (void) enqueueBatchRequest:(JRPCPendingRequest*)request {
+    NSTimeInterval batchWindow = self.batchWindow;
+    NSUInteger maxBatchSize = self.maxBatchSize;
+    NSUInteger maxBatchBytes = self.maxBatchBytes;
+    id payload = request.payload;
+    NSUInteger requestBytes = [payload isKindOfClass:[NSData class]] ? [(NSData*)payload length] : 0;
+    dispatch_async(self.batchQueue, ^{
+        // A call that would take the batch over budget goes in the next batch
+        if (maxBatchBytes > 0 && self.pendingBatch.count > 0 && self.pendingBatchBytes + requestBytes > maxBatchBytes) {
+            [self sendPendingBatch];
+        }
+        [self.pendingBatch addObject:request];
+        self.pendingBatchBytes += requestBytes;
+        if (maxBatchSize > 0 && self.pendingBatch.count >= maxBatchSize) {
+            [self sendPendingBatch];
+        }
+        else if (1 == self.pendingBatch.count) {
+            // The first call of a batch opens the window. The batch may have been sent by the time it closes, so check it is the same batch
+            NSUInteger batchGeneration = self.batchGeneration;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(batchWindow * NSEC_PER_SEC)), self.batchQueue, ^{
+                if (batchGeneration == self.batchGeneration) {
+                    [self sendPendingBatch];
                 }
-                else {
-                    // Transport error
-                    NSDictionary *userInfo = transportError ? @{ NSUnderlyingErrorKey : transportError } : nil;
-                    NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:userInfo];
-                    [weakSelf completeJSONRPCRequest:jsonRPCRequest response:nil error:error completionBlock:completionBlock];
+            });
+        }
+    });
+}
+
+- (void) sendPendingBatch {
+    // Calls cancelled or timed out while waiting for the batch are not sent
+    NSArray<JRPCPendingRequest*> *batch = [self.pendingBatch filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(JRPCPendingRequest *request, NSDictionary *bindings) {
+        return !request.isCompleted;
+    }]];
+    [self.pendingBatch removeAllObjects];
+    self.pendingBatchBytes = 0;
+    self.batchGeneration++;
+    if (0 == batch.count) {
+        return;
+    }
+    if (1 == batch.count) {
+        // No point wrapping a lone call in a batch
+        [self dispatchPendingRequest:batch.firstObject];
+    }
+    else if (self.transportPerformsSerialization) {
+        [self dispatchJSONRPCBatch:batch];
+    }
+    else {
+        [self dispatchSerializedJSONRPCBatch:batch];
+    }
+}
+
+- (void) dispatchPendingRequest:(JRPCPendingRequest*)request {
+    if (self.transportPerformsSerialization) {
+        [self dispatchJSONRPCRequest:request];
+    }
+    else {
+        [self dispatchSerializedJSONRPCRequest:request];
+    }
+}
+
+- (void) dispatchJSONRPCBatch:(NSArray<JRPCPendingRequest*>*)batch {
+    NSMutableArray<NSDictionary*> *jsonRPCRequests = [[NSMutableArray alloc] initWithCapacity:batch.count];
+    for (JRPCPendingRequest *request in batch) {
+        // Calls completed since the batch was taken have released their payload, and are answered already
+        NSDictionary *payload = request.payload;
+        if (payload) {
+            [jsonRPCRequests addObject:payload];
+        }
+    }
+    if (0 == jsonRPCRequests.count) {
+        return;
+    }
+    __weak typeof(self) weakSelf = self;
+    dispatch_queue_t completionQueue = nil;
+    dispatch_queue_t responseQueue = [self responseQueueWithCompletionQueue:&completionQueue];
+    uint64_t transportTime = JRPCBatchStartTime(batch);
+    [self.transport sendJSONRPCBatchPayloadWithRequestObjects:[jsonRPCRequests copy] completionQueue:responseQueue completion:^(NSArray<NSDictionary*> *jsonRPCResponses, NSError *transportError) {
+        [weakSelf recordPhase:JRPCMetricsPhaseTransport ofBatch:batch sinceTime:transportTime];
+        if (jsonRPCResponses) {
+            NSMutableArray<JRPCResponse*> *responses = [[NSMutableArray alloc] initWithCapacity:jsonRPCResponses.count];
+            for (id jsonRPCResponse in jsonRPCResponses) {
+                JRPCResponse *response = [JRPCResponse responseWithJSONObject:jsonRPCResponse];
+                if (response) {
+                    [responses addObject:response];
                 }
-            }];
+            }
+            [weakSelf completeJSONRPCBatch:batch responses:responses error:nil completionQueue:completionQueue];
         }
         else {
-            // Request serialization failure
-            typeof(weakSelf) sSelf = weakSelf;
-            NSDictionary *userInfo = reqSerError ? @{ NSUnderlyingErrorKey : reqSerError } : nil;
-            NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorRequestSerializationCode userInfo:userInfo];
-            [sSelf completeJSONRPCRequest:jsonRPCRequest response:nil error:error completionBlock:completionBlock];
+            // Transport error
+            NSDictionary *userInfo = transportError ? @{ NSUnderlyingErrorKey : transportError } : nil;
+            NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:userInfo];
+            [weakSelf completeJSONRPCBatch:batch responses:nil error:error completionQueue:completionQueue];
         }
     }];
 }
 
-- (void) serializeJSONRPCRequest:(NSDictionary*)jsonRPCRequest completion:(void (^_Nonnull)(NSData*, NSError*))completion {
-    // Serialize request to JSON data on serializationqueue
-    dispatch_async(self.serializationQueue, ^{
-        NSError *reqSerError = nil;
-        NSData *jsonRPCData = [NSJSONSerialization dataWithJSONObject:jsonRPCRequest options:0 error:&reqSerError];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            completion(jsonRPCData, reqSerError);
-        });
-    });
+- (void) dispatchSerializedJSONRPCBatch:(NSArray<JRPCPendingRequest*>*)batch {
+    // The requests are already encoded, so the batch is just those joined into an array
+    NSMutableArray<NSData*> *encodedRequests = [[NSMutableArray alloc] initWithCapacity:batch.count];
+    for (JRPCPendingRequest *request in batch) {
+        // Calls completed since the batch was taken have released their payload, and are answered already
+        NSData *payload = request.payload;
+        if (payload) {
+            [encodedRequests addObject:payload];
+        }
+    }
+    if (0 == encodedRequests.count) {
+        return;
+    }
+    id batchPayload = self.transportUsesDispatchData ?
+        (id)[self batchDispatchDataWithEncodedRequests:encodedRequests] :
+        [self.codec encodeArrayWithEncodedObjects:encodedRequests];
+    __weak typeof(self) weakSelf = self;
+    dispatch_queue_t completionQueue = nil;
+    dispatch_queue_t responseQueue = [self responseQueueWithCompletionQueue:&completionQueue];
+    // A batch is recorded in the metrics of its first call
+    JRPCMetricsRecorder *metrics = batch.firstObject.metrics;
+    [metrics recordSentPayload:batchPayload];
+    uint64_t transportTime = JRPCBatchStartTime(batch);
+    JRPCTransportDataCompletion completion = ^(NSData *responseData, NSError *transportError) {
+        [weakSelf recordPhase:JRPCMetricsPhaseTransport ofBatch:batch sinceTime:transportTime];
+        if (responseData) {
+            // Deserialize responses
+            [metrics recordReceivedData:responseData];
+            uint64_t deserializationTime = JRPCBatchStartTime(batch);
+            NSError *respSerError = nil;
+            NSArray<JRPCResponse*> *responses = [weakSelf batchResponsesFromData:responseData error:&respSerError];
+            [weakSelf recordPhase:JRPCMetricsPhaseDeserialization ofBatch:batch sinceTime:deserializationTime];
+            if (responses) {
+                [weakSelf completeJSONRPCBatch:batch responses:responses error:nil completionQueue:completionQueue];
+            }
+            else {
+                // Response deserialization error
+                NSDictionary *userInfo = respSerError ? @{ NSUnderlyingErrorKey : respSerError } : nil;
+                NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorResponseSerializationCode userInfo:userInfo];
+                [weakSelf completeJSONRPCBatch:batch responses:nil error:error completionQueue:completionQueue];
+            }
+        }
+        else {
+            // Transport error
+            NSDictionary *userInfo = transportError ? @{ NSUnderlyingErrorKey : transportError } : nil;
+            NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:userInfo];
+            [weakSelf completeJSONRPCBatch:batch responses:nil error:error completionQueue:completionQueue];
+        }
+    };
+    if (self.transportUsesDispatchData) {
+        [self.transport sendJSONRPCBatchPayloadWithRequestDispatchData:batchPayload completionQueue:responseQueue completion:^(dispatch_data_t responseData, NSError *transportError) {
+            completion((NSData*)responseData, transportError);
+        }];
+    }
+    else {
+        [self.transport sendJSONRPCBatchPayloadWithRequestData:batchPayload completionQueue:responseQueue completion:completion];
+    }
 }
 
-- (void) deserializeJSONRPCResponse:(NSData*)responseData completion:(void (^_Nonnull)(NSDictionary*, NSError*))completion {
-    // Deserialize response data on serialization queue
-    dispatch_async(self.serializationQueue, ^{
-        NSError *respSerError = nil;
-        NSDictionary *jsonRPCResponse = [NSJSONSerialization JSONObjectWithData:responseData options:0 error:&respSerError];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            completion(jsonRPCResponse, respSerError);
-        });
+// A phase of a batch is recorded once in the metrics of its first call, and in the trace of every call in it
+- (void) recordPhase:(JRPCMetricsPhase)phase ofBatch:(NSArray<JRPCPendingRequest*>*)batch sinceTime:(uint64_t)startTime {
+    [batch.firstObject.metrics recordPhase:phase sinceTime:startTime];
+    for (JRPCPendingRequest *request in batch) {
+        [request.trace recordPhase:phase sinceTime:startTime];
+    }
+}
+
+- (dispatch_data_t) batchDispatchDataWithEncodedRequests:(NSArray<NSData*>*)encodedRequests {
+    id<JRPCCodec> codec = self.codec;
+    if (!JRPCCodecIsJSON(codec)) {
+        // Other codecs join the requests themselves, into one buffer
+        return JRPCDispatchDataWithData([codec encodeArrayWithEncodedObjects:encodedRequests]);
+    }
+    // The regions of each request are linked between the brackets & commas, without copying them
+    static dispatch_data_t openBracket, comma, closeBracket;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        openBracket = dispatch_data_create("[", 1, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+        comma = dispatch_data_create(",", 1, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+        closeBracket = dispatch_data_create("]", 1, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
     });
+    dispatch_data_t batchData = openBracket;
+    for (NSUInteger i = 0; i < encodedRequests.count; ++i) {
+        if (i > 0) {
+            batchData = dispatch_data_create_concat(batchData, comma);
+        }
+        batchData = dispatch_data_create_concat(batchData, (dispatch_data_t)encodedRequests[i]);
+    }
+    return dispatch_data_create_concat(batchData, closeBracket);
 }
 
-- (void) completeJSONRPCRequest:(NSDictionary*)jsonRPCRequest
-                       response:(NSDictionary*)jsonRPCResponse
-                          error:(NSError*)error
-                completionBlock:(id)completionBlock {
-    
-    id jsonResult = nil;
-    if (jsonRPCResponse) {
-        jsonResult = jsonRPCResponse[kJSONRPCResultKey];
-        // Map any JSON-RPC error returned by the server into an NSError and recurse
-        NSDictionary* jsonRPCError = jsonRPCResponse[kJSONRPCErrorKey];
-        if (jsonRPCError) {
-            NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
-            NSNumber *jsonErrorCode = jsonRPCError[kJSONRPCErrorCodeKey];
-            NSString *jsonErrorMsg = jsonRPCError[kJSONRPCErrorMessageKey];
-            id jsonErrorData = jsonRPCError[kJSONRPCErrorDataKey];
-            if (jsonErrorCode) {
-                userInfo[kJRPCErrorCodeKey] = jsonErrorCode;
+- (NSArray<JRPCResponse*>*) batchResponsesFromData:(NSData*)responseData error:(NSError**)error {
+    id<JRPCCodec> codec = self.codec;
+    if (!JRPCCodecIsJSON(codec)) {
+        return [self batchResponsesFromData:responseData codec:codec error:error];
+    }
+    // Each response is only scanned here, its result & error are parsed when needed
+    NSMutableArray<JRPCResponse*> *responses = [[NSMutableArray alloc] init];
+    void (^addResponse)(NSRange) = ^(NSRange elementRange) {
+        JRPCResponse *response = [self responseWithJSONData:responseData range:elementRange];
+        if (response) {
+            [responses addObject:response];
+        }
+    };
+    BOOL isArray = self.transportUsesDispatchData ?
+        JRPCJSONScanArrayInDispatchData((dispatch_data_t)responseData, addResponse) :
+        JRPCJSONScanArray(responseData, addResponse);
+    if (!isArray) {
+        // A batch the server could not process at all gets a single response
+        [responses removeAllObjects];
+        JRPCResponse *response = [self responseWithJSONData:responseData range:NSMakeRange(0, responseData.length)];
+        if (!response) {
+            if (error) {
+                *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                         userInfo:@{ NSDebugDescriptionErrorKey : @"Response is not a valid JSON-RPC batch response" }];
             }
-            if (jsonErrorMsg) {
-                userInfo[kJRPCErrorMessageKey] = jsonErrorMsg;
+            return nil;
+        }
+        [responses addObject:response];
+    }
+    return [responses copy];
+}
+
+- (NSArray<JRPCResponse*>*) batchResponsesFromData:(NSData*)responseData codec:(id<JRPCCodec>)codec error:(NSError**)error {
+    id responseObject = [codec decodeData:responseData error:error];
+    if (!responseObject) {
+        return nil;
+    }
+    if ([responseObject isKindOfClass:[NSArray class]]) {
+        NSMutableArray<JRPCResponse*> *responses = [[NSMutableArray alloc] initWithCapacity:[responseObject count]];
+        for (id jsonRPCResponse in (NSArray*)responseObject) {
+            JRPCResponse *response = [JRPCResponse responseWithJSONObject:jsonRPCResponse];
+            if (response) {
+                [responses addObject:response];
             }
-            if (jsonErrorData) {
-                userInfo[kJRPCErrorDataKey] = jsonErrorData;
+        }
+        return [responses copy];
+    }
+    // A batch the server could not process at all gets a single response
+    JRPCResponse *response = [JRPCResponse responseWithJSONObject:responseObject];
+    if (!response) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                     userInfo:@{ NSDebugDescriptionErrorKey : @"Response is not a valid JSON-RPC batch response" }];
+        }
+        return nil;
+    }
+    return @[ response ];
+}
+
+- (void) completeJSONRPCBatch:(NSArray<JRPCPendingRequest*>*)batch
+                    responses:(NSArray<JRPCResponse*>*)responses
+                        error:(NSError*)error
+              completionQueue:(dispatch_queue_t)completionQueue {
+    // Match the responses to calls, then complete them all with a single dispatch to the completion queue
+    NSMutableArray *matchedResponses = [[NSMutableArray alloc] initWithCapacity:batch.count];
+    if (responses) {
+        // Responses may be in any order, so match them to calls by id
+        NSMutableDictionary<id, JRPCResponse*> *responsesById = [[NSMutableDictionary alloc] initWithCapacity:responses.count];
+        JRPCResponse *batchErrorResponse = nil;
+        for (JRPCResponse *response in responses) {
+            id requestId = response.requestId;
+            if (requestId && [NSNull null] != requestId) {
+                responsesById[requestId] = response;
             }
-            NSError *serverError = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorServerResponseCode userInfo:[userInfo copy]];
-            // Recurse with mapped JSON-RPC error received from server
-            [self completeJSONRPCRequest:jsonRPCRequest response:nil error:serverError completionBlock:completionBlock];
-            return;
+            else if (response.hasError) {
+                // An error the server could not attribute to a call, e.g. the batch could not be parsed, applies to every call without its own response
+                batchErrorResponse = response;
+            }
+        }
+        for (JRPCPendingRequest *request in batch) {
+            JRPCResponse *response = responsesById[@(request.requestId)] ? : batchErrorResponse;
+            if (response && completionQueue) {
+                [self prepareResponse:response descriptor:request.descriptor];
+            }
+            [matchedResponses addObject:response ? : [NSNull null]];
         }
     }
-    // complete with result/error
-    dispatch_async(self.rpcCompletionQueue, ^{
-        [self invokeCompletionBlock:completionBlock result:jsonResult error:error];
+    uint64_t dispatchTime = JRPCBatchStartTime(batch);
+    void (^completeBatch)(void) = ^{
+        if (completionQueue) {
+            [self recordPhase:JRPCMetricsPhaseCompletionQueue ofBatch:batch sinceTime:dispatchTime];
+        }
+        for (NSUInteger i = 0; i < batch.count; ++i) {
+            JRPCPendingRequest *request = batch[i];
+            JRPCResponse *response = (i < matchedResponses.count && [NSNull null] != matchedResponses[i]) ? matchedResponses[i] : nil;
+            NSError *requestError = error;
+            if (!response && !requestError) {
+                requestError = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorBatchResponseMissingCode userInfo:nil];
+            }
+            [self completeJSONRPCRequest:request response:response error:requestError completionQueue:nil];
+        }
+    };
+    if (completionQueue) {
+        dispatch_async(completionQueue, completeBatch);
+    }
+    else {
+        completeBatch();
+    }
+}
+
+#pragma mark - Caching
+
+- (void) setCachePolicy:(JRPCCachePolicy*)policy forSelector:(SEL)selector {
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:selector];
+    if (!descriptor || descriptor.isNotification) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is not a method of the protocol with a completion block", NSStringFromSelector(selector)];
+        return;
+    }
+    JRPCCachePolicy *previousPolicy = descriptor.cachePolicy;
+    descriptor.cachePolicy = policy;
+    if (previousPolicy && ![self isCachePolicyInUse:previousPolicy]) {
+        [self.responseCache removeResponsesForPolicy:previousPolicy];
+    }
+}
+
+- (BOOL) isCachePolicyInUse:(JRPCCachePolicy*)policy {
+    CFIndex count = CFDictionaryGetCount(self.methodDescriptors);
+    const void **descriptors = malloc(sizeof(void*) * count);
+    CFDictionaryGetKeysAndValues(self.methodDescriptors, NULL, descriptors);
+    BOOL inUse = NO;
+    for (CFIndex i = 0; i < count && !inUse; ++i) {
+        inUse = (((__bridge JRPCMethodDescriptor*)descriptors[i]).cachePolicy == policy);
+    }
+    free(descriptors);
+    return inUse;
+}
+
+- (void) removeAllCachedResponses {
+    [self.responseCache removeAllResponses];
+}
+
+- (JRPCCacheStatistics) cacheStatistics {
+    return self.responseCache.statistics;
+}
+
+// Looks up a call to a method with a cache policy. Returns YES if a request must be sent for it, with the completion block to send it with
+- (BOOL) lookupCachedCallWithDescriptor:(JRPCMethodDescriptor*)descriptor
+                                 policy:(JRPCCachePolicy*)policy
+                               cacheKey:(NSData*)cacheKey
+                        completionBlock:(id __strong *)completionBlock {
+    JRPCPendingRequest *call = [JRPCPendingRequest requestWithId:0 descriptor:descriptor completionBlock:*completionBlock payload:nil cacheKey:nil];
+    JRPCResponse *cachedResponse = nil;
+    switch ([self.responseCache lookupCallWithKey:cacheKey policy:policy call:call response:&cachedResponse]) {
+        case JRPCResponseCacheResultMiss:
+            return YES;
+        case JRPCResponseCacheResultCoalesced:
+            // Completed with the response to the request in flight, unless its own timeout elapses first
+            call.coalescedCacheKey = cacheKey;
+            [self captureCall:call];
+            [self scheduleTimeoutForRequest:call];
+            return NO;
+        case JRPCResponseCacheResultHit:
+            [self captureCall:call];
+            [self completeJSONRPCRequest:call response:cachedResponse error:nil completionQueue:self.rpcCompletionQueue];
+            return NO;
+        case JRPCResponseCacheResultStaleHit:
+            // Complete with the stale response, and send the request only to refresh the cache
+            [self captureCall:call];
+            [self completeJSONRPCRequest:call response:cachedResponse error:nil completionQueue:self.rpcCompletionQueue];
+            *completionBlock = nil;
+            return YES;
+    }
+}
+
+// Completes the calls coalesced onto a request that could not be encoded, and lets the next identical call send its own
+- (void) failCallsWaitingForKey:(NSData*)cacheKey exception:(NSException*)exception {
+    NSArray<JRPCPendingRequest*> *waiters = [self.responseCache completeRequest:nil forKey:cacheKey response:nil policy:nil];
+    if (0 == waiters.count) {
+        return;
+    }
+    NSDictionary *userInfo = exception.reason ? @{ NSDebugDescriptionErrorKey : exception.reason } : nil;
+    NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorRequestSerializationCode userInfo:userInfo];
+    for (JRPCPendingRequest *waiter in waiters) {
+        [self completeJSONRPCRequest:waiter response:nil error:error completionQueue:self.rpcCompletionQueue];
+    }
+}
+
+#pragma mark - Timeouts & Cancellation
+
+- (void) setTimeout:(NSTimeInterval)timeout forSelector:(SEL)selector {
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:selector];
+    if (!descriptor || descriptor.isNotification) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is not a method of the protocol with a completion block", NSStringFromSelector(selector)];
+        return;
+    }
+    descriptor.timeout = timeout;
+}
+
+- (id<JRPCCall>) callWithHandle:(void (NS_NOESCAPE ^)(void))call {
+    // The call is collected through a thread specific slot, which costs calls made without a handle a single lookup
+    NSMutableArray<JRPCPendingRequest*> *calls = [[NSMutableArray alloc] initWithCapacity:1];
+    pthread_key_t key = JRPCCallCaptureKey();
+    void *outerCalls = pthread_getspecific(key);
+    pthread_setspecific(key, (__bridge const void *)calls);
+    @try {
+        call();
+    }
+    @finally {
+        pthread_setspecific(key, outerCalls);
+    }
+    return calls.firstObject;
+}
+
+- (void) captureCall:(JRPCPendingRequest*)call {
+    void *calls = pthread_getspecific(JRPCCallCaptureKey());
+    if (!calls || 0 != ((__bridge NSMutableArray*)calls).count) {
+        return;
+    }
+    __weak typeof(self) weakSelf = self;
+    call.cancelHandler = ^(JRPCPendingRequest *request) {
+        [weakSelf abandonJSONRPCRequest:request code:JRPCErrorCancelledCode];
+    };
+    [(__bridge NSMutableArray*)calls addObject:call];
+}
+
+- (void) scheduleTimeoutForRequest:(JRPCPendingRequest*)request {
+    NSTimeInterval timeout = request.descriptor.timeout;
+    if (timeout < 0) {
+        timeout = self.defaultTimeout;
+    }
+    if (timeout <= 0) {
+        return;
+    }
+    // A timer rather than dispatch_after, so it is cancelled, and lets go of the request, as soon as the request completes
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.serializationQueue);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, NSEC_PER_MSEC);
+    dispatch_source_set_event_handler(timer, ^{
+        [weakSelf abandonJSONRPCRequest:request code:JRPCErrorTimedOutCode];
     });
+    [request setTimeoutTimer:timer];
 }
 
-- (void) invokeCompletionBlock:(id)completionBlock result:(id)result error:(NSError*)error {
-    // We need to cast the completion block according to method signature
-    CTBlockDescription *blockDesc = [[CTBlockDescription alloc] initWithBlock:completionBlock];
-    NSMethodSignature *blockSig = blockDesc.blockSignature;
-    // The block params start at index 2 (0 = ret, 1 = self), and we know 3 should be @"NSError" by convention
-    // Note: for block signatures, we don't just get '@' for object params, we get an objc string literal, e.g. '@"NSString"' / '@"NSError"'
-    // However, primitives DO follow standard objc type encodings:
-    // See https://developer.apple.com/library/mac/documentation/Cocoa/Conceptual/ObjCRuntimeGuide/Articles/ocrtTypeEncodings.html
-    const char *resultTypeEncodingStr = [blockSig getArgumentTypeAtIndex:1];
-    if (1 == strlen(resultTypeEncodingStr)) {
-        char resultTypeEncoding = resultTypeEncodingStr[0];
-        switch (resultTypeEncoding) {
-            case 'B': ((void (^)(_Bool, NSError*))blockDesc.block)([(NSNumber*)result boolValue], error); break; // char
-            case 'c': ((void (^)(char, NSError*))blockDesc.block)([(NSNumber*)result charValue], error); break; // char
-            case 'i': ((void (^)(int, NSError*))blockDesc.block)([(NSNumber*)result intValue], error); break;  // int
-            case 's': ((void (^)(short, NSError*))blockDesc.block)([(NSNumber*)result shortValue], error); break;  // short
-            case 'l': ((void (^)(long, NSError*))blockDesc.block)([(NSNumber*)result longValue], error); break;  // long
-            case 'q': ((void (^)(long long, NSError*))blockDesc.block)([(NSNumber*)result longLongValue], error); break;  // long long
-            case 'C': ((void (^)(unsigned char, NSError*))blockDesc.block)([(NSNumber*)result unsignedCharValue], error); break;  // unsigned char
-            case 'I': ((void (^)(unsigned int, NSError*))blockDesc.block)([(NSNumber*)result unsignedIntValue], error); break;  // unsigned int
-            case 'S': ((void (^)(unsigned short, NSError*))blockDesc.block)([(NSNumber*)result unsignedShortValue], error); break;  // unsigned short
-            case 'L': ((void (^)(unsigned long, NSError*))blockDesc.block)([(NSNumber*)result unsignedLongValue], error); break;  // unsigned long
-            case 'Q': ((void (^)(unsigned long long, NSError*))blockDesc.block)([(NSNumber*)result unsignedLongLongValue], error); break;  // unsigned long long
-            case 'f': ((void (^)(float, NSError*))blockDesc.block)([(NSNumber*)result floatValue], error); break;  // float
-            case 'd': ((void (^)(double, NSError*))blockDesc.block)([(NSNumber*)result doubleValue], error); break;  // double
-            case '@': ((void (^)(id, NSError*))blockDesc.block)(result, error); break;  // Object
-            default:
-                [NSException raise:NSInternalInconsistencyException format:@"Unsupported completion type encoding for result: %c", resultTypeEncoding];
-                break;
-        }
+// Completes a request with an error without waiting for its response, and tells the transport it can drop the request.
+// A request identical calls are waiting on goes on for them, and only the call that made it is completed
+- (void) abandonJSONRPCRequest:(JRPCPendingRequest*)request code:(NSInteger)code {
+    if (request.isCompleted) {
+        return;
+    }
+    NSError *error = [NSError errorWithDomain:JRPCErrorDomain code:code userInfo:nil];
+    NSData *cacheKey = request.cacheKey ? : request.coalescedCacheKey;
+    if (!cacheKey) {
+        [self endJSONRPCRequest:request error:error];
+        return;
+    }
+    JRPCPendingRequest *abandonedRequest = [self.responseCache abandonCall:request forKey:cacheKey];
+    if (request.coalescedCacheKey) {
+        // Nothing was sent for a waiting call
+        [self completeJSONRPCRequest:request response:nil error:error completionQueue:self.rpcCompletionQueue];
+    }
+    else if (abandonedRequest != request) {
+        [self completeCallOfRequest:request error:error];
+    }
+    // The last call waiting on a request whose own call has already been given up on
+    [self endJSONRPCRequest:abandonedRequest error:error];
+}
+
+- (void) endJSONRPCRequest:(JRPCPendingRequest*)request error:(NSError*)error {
+    if (!request) {
+        return;
+    }
+    // The transport is told first, so the request is gone from it by the time the completion block is called.
+    // If the response is being handled meanwhile, that completes the request and the error is not used
+    if (self.transportSupportsCancellation && request.payload) {
+        [self.transport cancelJSONRPCRequestWithId:@(request.requestId)];
+    }
+    [self completeJSONRPCRequest:request response:nil error:error completionQueue:self.rpcCompletionQueue];
+}
+
+// Completes the call that made a request with an error, leaving the request in flight for the calls waiting on it
+- (void) completeCallOfRequest:(JRPCPendingRequest*)request error:(NSError*)error {
+    id completionBlock = [request detachCompletionBlock];
+    if (!completionBlock) {
+        return;
+    }
+    JRPCMethodDescriptor *descriptor = request.descriptor;
+    void (^complete)(void) = ^{
+        [self invokeCompletionBlock:completionBlock descriptor:descriptor response:nil error:error];
+    };
+    dispatch_queue_t completionQueue = self.rpcCompletionQueue;
+    if (completionQueue) {
+        dispatch_async(completionQueue, complete);
     }
     else {
-        // Strip obj string literal syntax to get object class name
-        NSString *classStr = [NSString stringWithFormat:@"%s", resultTypeEncodingStr];
-        classStr = [classStr stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"@\""]];
-        Class argClass = NSClassFromString(classStr);
-        // Process optional transformation of result if an alternative initializaer has been supplied
-        id newResult = [self transformedResultForJSONResult:result class:argClass];
-        // Override JSON-RPC result object with transformed result if available
-        result = newResult ? : result;
-        if (!result || (argClass && [result isKindOfClass:[argClass class]])) {
-            // param type matches result type, so call completion directly
-            ((void (^)(id, NSError*))blockDesc.block)(result, error);
-        }
-        else {
-            [NSException raise:NSInternalInconsistencyException format:@"Unable to call completion block due to unsupported result type %s", resultTypeEncodingStr];
-        }
-    }
-}
-
-- (id) transformedResultForJSONResult:(id)result class:(Class)resultClass {
-    // Called just before the JSON-RPC response result is returned to caller. A chance to transform it to the required type.
-    // See if the class supports initialization by initWithJSONObject: (e.g. by extension category)
-    id retResult = result;
-    if (![retResult isKindOfClass:[resultClass class]]) {
-        SEL jsonObjectInitializer = @selector(initWithJSONRPCResponseResult:);
-        if ([resultClass respondsToSelector:@selector(instancesRespondToSelector:)] &&
-            [resultClass instancesRespondToSelector:jsonObjectInitializer]) {
-            id newResult = [resultClass alloc];
-            // workaround compiler warning "PerformSelector may cause a leak because its selector is unknown"
-            // [newResult performSelector:jsonObjectInitializer withObject:result];
-            IMP imp = [newResult methodForSelector:jsonObjectInitializer];
-            id (*func)(id, SEL, id) = (void*)imp;
-            newResult = func(newResult, jsonObjectInitializer, result);
-            if (newResult) {
-                retResult = newResult;
+        complete();
+    }
+}
+
+#pragma mark - Scheduling
+
+- (NSUInteger) maxConcurrentCalls {
+    return self.scheduler.maxConcurrentCalls;
+}
+
+- (void) setMaxConcurrentCalls:(NSUInteger)maxConcurrentCalls {
+    self.scheduler.maxConcurrentCalls = maxConcurrentCalls;
+}
+
+- (BOOL) adaptsConcurrencyLimit {
+    return self.scheduler.adaptsConcurrencyLimit;
+}
+
+- (void) setAdaptsConcurrencyLimit:(BOOL)adaptsConcurrencyLimit {
+    self.scheduler.adaptsConcurrencyLimit = adaptsConcurrencyLimit;
+}
+
+- (JRPCSchedulerStatistics) schedulerStatistics {
+    return self.scheduler.statistics;
+}
+
+- (void) setPriority:(JRPCCallPriority)priority forSelector:(SEL)selector {
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:selector];
+    if (!descriptor || descriptor.isNotification) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is not a method of the protocol with a completion block", NSStringFromSelector(selector)];
+        return;
+    }
+    descriptor.priority = priority;
+}
+
+#pragma mark - Codecs
+
+- (void) setCodecs:(NSArray<id<JRPCCodec>>*)codecs {
+    id<JRPCCodec> codec = nil;
+    if (!self.transportPerformsSerialization) {
+        // The first codec the transport supports is used. A transport that does not say only supports JSON
+        NSArray<NSString*> *supportedCodecNames = [self.transport respondsToSelector:@selector(supportedCodecNames)] ? self.transport.supportedCodecNames : nil;
+        for (id<JRPCCodec> candidate in codecs) {
+            if ([supportedCodecNames ? : @[ JRPCCodecNameJSON ] containsObject:candidate.name]) {
+                codec = candidate;
+                break;
             }
         }
+        if (!codec) {
+            [NSException raise:NSInvalidArgumentException format:@"transport supports none of the codecs %@", [codecs valueForKey:@"name"]];
+        }
+        if ([self.transport respondsToSelector:@selector(useCodecWithName:)]) {
+            [self.transport useCodecWithName:codec.name];
+        }
+    }
+    self.preferredCodecs = codecs;
+    self.codec = codec;
+}
+
+- (NSArray<id<JRPCCodec>>*) codecs {
+    return self.preferredCodecs;
+}
+
+- (id<JRPCCodec>) codec {
+    return JRPCAtomicReferenceLoad(&_codecReference);
+}
+
+- (void) setCodec:(id<JRPCCodec>)codec {
+    JRPCAtomicReferenceStore(&_codecReference, codec);
+}
+
+#pragma mark - Metrics
+
+// The recorder for a call being made now, or nil while metrics are disabled. This is all metrics cost a call when disabled
+- (JRPCMetricsRecorder*) activeMetrics {
+    return atomic_load_explicit(&_metricsEnabled, memory_order_acquire) ? JRPCAtomicReferenceLoad(&_metricsReference) : nil;
+}
+
+- (BOOL) metricsEnabled {
+    return atomic_load_explicit(&_metricsEnabled, memory_order_relaxed);
+}
+
+- (void) setMetricsEnabled:(BOOL)metricsEnabled {
+    if (metricsEnabled && !JRPCAtomicReferenceLoad(&_metricsReference)) {
+        CFIndex count = CFDictionaryGetCount(self.methodDescriptors);
+        const void **descriptors = malloc(sizeof(void*) * count);
+        CFDictionaryGetKeysAndValues(self.methodDescriptors, NULL, descriptors);
+        NSMutableArray<JRPCMethodDescriptor*> *methodDescriptors = [[NSMutableArray alloc] initWithCapacity:count];
+        for (CFIndex i = 0; i < count; ++i) {
+            [methodDescriptors addObject:(__bridge JRPCMethodDescriptor*)descriptors[i]];
+        }
+        free(descriptors);
+        JRPCAtomicReferenceStoreIfNil(&_metricsReference, [[JRPCMetricsRecorder alloc] initWithMethodDescriptors:methodDescriptors]);
     }
-    return retResult;
+    // Released after the recorder is published, so a call that sees the flag sees the recorder
+    atomic_store_explicit(&_metricsEnabled, metricsEnabled, memory_order_release);
 }
 
-- (id) transformedJSONParameterForParameter:(id)parameter {
-    // Called just before the parameter is added to the JSON-RPC request. A chance to transform it to a supported JSON type;
-    id retParam = parameter;
-    if (![[self class] isValidJSONObject:parameter] &&
-        [parameter respondsToSelector:@selector(jsonRPCRequestRepresentation)]) {
-        id newParam = [parameter jsonRPCRequestRepresentation];
-        if (newParam) {
-            retParam = newParam;
+- (JRPCMetricsSnapshot*) metricsSnapshot {
+    return [[self activeMetrics] snapshot];
+}
+
+- (void) resetMetrics {
+    [(JRPCMetricsRecorder*)JRPCAtomicReferenceLoad(&_metricsReference) reset];
+}
+
+- (NSTimeInterval) metricsReportInterval {
+    pthread_mutex_lock(&_metricsTimerLock);
+    NSTimeInterval metricsReportInterval = _metricsReportInterval;
+    pthread_mutex_unlock(&_metricsTimerLock);
+    return metricsReportInterval;
+}
+
+- (void) setMetricsReportInterval:(NSTimeInterval)metricsReportInterval {
+    pthread_mutex_lock(&_metricsTimerLock);
+    _metricsReportInterval = metricsReportInterval;
+    if (self.metricsTimer) {
+        dispatch_source_cancel(self.metricsTimer);
+        self.metricsTimer = nil;
+    }
+    if (metricsReportInterval > 0) {
+        // The timer holds the proxy weakly, and is cancelled when the proxy is deallocated
+        __weak typeof(self) weakSelf = self;
+        uint64_t interval = (uint64_t)(metricsReportInterval * NSEC_PER_SEC);
+        dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.serializationQueue);
+        dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+        dispatch_source_set_event_handler(timer, ^{
+            [weakSelf reportMetrics];
+        });
+        dispatch_resume(timer);
+        self.metricsTimer = timer;
+    }
+    pthread_mutex_unlock(&_metricsTimerLock);
+}
+
+- (void) reportMetrics {
+    id<JRPCMetricsDelegate> metricsDelegate = self.metricsDelegate;
+    JRPCMetricsSnapshot *metrics = metricsDelegate ? self.metricsSnapshot : nil;
+    if (metrics) {
+        dispatch_async(self.rpcCompletionQueue, ^{
+            [metricsDelegate proxy:self didReportMetrics:metrics];
+        });
+    }
+}
+
+#pragma mark - Tracing
+
+- (JRPCTracer*) tracer {
+    return JRPCAtomicReferenceLoad(&_tracerReference);
+}
+
+- (void) setTracer:(JRPCTracer*)tracer {
+    JRPCAtomicReferenceStore(&_tracerReference, tracer);
+}
+
+- (void) setTraceSampleRate:(double)sampleRate forSelector:(SEL)selector {
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:selector];
+    if (!descriptor) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is not a method of the protocol", NSStringFromSelector(selector)];
+        return;
+    }
+    descriptor.traceSampleRate = sampleRate;
+}
+
+#pragma mark - Streaming Results
+
+- (void) setResultChunkSize:(NSUInteger)chunkSize elementClass:(Class)elementClass forSelector:(SEL)selector {
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:selector];
+    if (!descriptor || descriptor.isNotification) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is not a method of the protocol with a completion block", NSStringFromSelector(selector)];
+        return;
+    }
+    descriptor.resultChunkSize = chunkSize;
+    descriptor.resultElementClass = elementClass;
+}
+
+#pragma mark - Notifications
+
+- (void) dispatchJSONRPCNotification:(id)payload metrics:(JRPCMetricsRecorder*)metrics trace:(JRPCCallTrace*)trace {
+    [metrics recordSentPayload:payload];
+    // Nothing follows the notification being handed to the transport, so that ends its trace
+    if (self.transportSupportsNotifications) {
+        if (self.transportPerformsSerialization) {
+            [self.transport sendJSONRPCNotificationWithRequestObject:payload];
+        }
+        else if (self.transportUsesDispatchData) {
+            [self.transport sendJSONRPCNotificationWithRequestDispatchData:payload];
         }
+        else {
+            [self.transport sendJSONRPCNotificationWithRequestData:payload];
+        }
+        [trace finishWithError:nil];
+        return;
+    }
+    // Transport can only send requests. Nothing is waiting on the reply (if any), so ignore it on an internal queue
+    static JRPCTransportObjectCompletion ignoreObjectResponse;
+    static JRPCTransportDataCompletion ignoreDataResponse;
+    static JRPCTransportDispatchDataCompletion ignoreDispatchDataResponse;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        ignoreObjectResponse = ^(NSDictionary *jsonResponse, NSError *error) {};
+        ignoreDataResponse = ^(NSData *data, NSError *error) {};
+        ignoreDispatchDataResponse = ^(dispatch_data_t data, NSError *error) {};
+    });
+    if (self.transportPerformsSerialization) {
+        [self.transport sendJSONRPCPayloadWithRequestObject:payload completionQueue:self.serializationQueue completion:ignoreObjectResponse];
     }
-    return retParam;
+    else if (self.transportUsesDispatchData) {
+        [self.transport sendJSONRPCPayloadWithRequestDispatchData:payload completionQueue:self.serializationQueue completion:ignoreDispatchDataResponse];
+    }
+    else {
+        [self.transport sendJSONRPCPayloadWithRequestData:payload completionQueue:self.serializationQueue completion:ignoreDataResponse];
+    }
+    [trace finishWithError:nil];
 }
 
-+ (BOOL) isValidJSONObject:(id)obj {
-    // Test if its a valid type. We wrap obj in an array since [NSJSONSerialization isValidJSONObject] expects top level to be an array or dictionary, but we call this for transformed request parmameters which are within the topl level JSON-RPC request dictionary
-    return [NSJSONSerialization isValidJSONObject:@[obj]];
+#pragma mark - Completion
+
+- (void) invokeCompletionBlock:(id)completionBlock descriptor:(JRPCMethodDescriptor*)descriptor response:(JRPCResponse*)response error:(NSError*)error {
+    // We need to cast the completion block according to method signature, which is fixed per selector so the thunk that does this is only resolved once
+    JRPCCompletionThunk *thunk = [descriptor completionThunkForCompletionBlock:completionBlock];
+    if (thunk.streamsResult) {
+        [thunk streamResultToCompletionBlock:completionBlock
+                                    response:response
+                                       error:error
+                                   chunkSize:descriptor.resultChunkSize
+                                elementClass:descriptor.resultElementClass];
+        return;
+    }
+    [thunk invokeCompletionBlock:completionBlock response:response error:error];
 }
 
 #pragma mark - NSProxy
 
 - (BOOL)respondsToSelector:(SEL)selector {
-    struct objc_method_description description = protocol_getMethodDescription(self.protocol, selector, YES, YES);
-    return description.name != NULL;
+    return [self descriptorForSelector:selector] != nil;
 }
 
 - (nullable NSMethodSignature *)methodSignatureForSelector:(SEL)sel {
-    struct objc_method_description methodDesc = protocol_getMethodDescription(self.protocol, sel, YES, YES);
-    if (methodDesc.name)
-    {
-        NSMethodSignature *sig = [NSMethodSignature signatureWithObjCTypes:methodDesc.types];
-        return sig; // forwardInvocation WILL be called
-    }
-    return nil; // forwardInvocation will NOT be called
+    // nil => forwardInvocation will NOT be called
+    return [self descriptorForSelector:sel].methodSignature;
 }
 
 - (void)forwardInvocation:(NSInvocation *)invocation {
-    NSMutableDictionary *jsonRPCRequest = [@{
-                                            kJSONRPCVersionKey      : kJSONRPCVersion,
-                                            kJSONRPCRequestIdKey    : @(self.jsonRPCRequestId++)
-                                            } mutableCopy];
-    // Grab parameter values from the invocation. These will be the same regardless of JSON-RPC parameter structure
-    NSArray *paramValues = [self paramValuesFromInvocation:invocation];
-    // Grab the completion block from last param of invocation
-    __unsafe_unretained id completionBlock = nil;
-    [invocation getArgument:&completionBlock atIndex:invocation.methodSignature.numberOfArguments - 1];
-    // Extract method and param names from selector
-    NSString* selStr = NSStringFromSelector(invocation.selector);
-    NSMutableArray *paramNames = [[selStr componentsSeparatedByString:@":"] mutableCopy];
-    // We expect >= TWO elements in the array, with the last an empty string, since a selector string with >= 1 param should always end with a colon ':'
-    if (paramNames.count < 2) {
-        [NSException raise:NSInternalInconsistencyException format:@"Proxied selectors MUST have AT LEAST ONE parameter, which should be the completion block"];
-    }
-    NSAssert(((NSString*)paramNames.lastObject).length == 0, @"Selector parse error, SEL does not end in colon: %@", selStr);
-    [paramNames removeLastObject];    // Ditch the trailing empty string
-    if (JRPCParameterStructureByName == self.paramStructure) {
-        // Parse out method name from first component of selector. i.e <methodName>With<Param1Name>:
-        NSString *selFirstComp = paramNames[0];
-        NSRange rangeOfWith = [selFirstComp rangeOfString:@"With"];
-        if (NSNotFound == rangeOfWith.location) {
-            [NSException raise:NSInternalInconsistencyException format:@"Selector: %@ does not match JSON-RPC params by-name naming convention: <methodName>With<ParamName>...", selStr];
-        }
-        jsonRPCRequest[kJSONRPCMethodKey] = [selFirstComp substringToIndex:rangeOfWith.location];
-        // Drop the last parameter, it's the completion block which does not participate in JSON-RPC
-        [paramNames removeLastObject];
-        if (paramNames.count > 0) {
-            // Only include "params" key in JSON-RPC payload if at least one key-value pair
-            // replace first param name with the part following 'With' so that paramNames is now the parameter list
-            NSString *firstParamName = [selFirstComp substringFromIndex:rangeOfWith.location + rangeOfWith.length];
-            // convert first char of firstParamName to lower case
-            if (firstParamName.length < 2) {
-                firstParamName = [firstParamName lowercaseString];
-            } else {
-                firstParamName = [NSString stringWithFormat:@"%@%@", [[firstParamName substringToIndex:1] lowercaseString], [firstParamName substringFromIndex:1]];
-            }
-            paramNames[0] = firstParamName;
-            // Now create params dict for JSON-RPC by-name
-            if (paramValues.count != paramNames.count) {
-                [NSException raise:NSInternalInconsistencyException format:@"Param name/value mismatch: names: %@ values: %@ ", paramNames, paramValues];
-            }
-            NSDictionary *params = [NSDictionary dictionaryWithObjects:paramValues forKeys:paramNames];
-            jsonRPCRequest[kJSONRPCParamsKey] = params;
-        }
+    JRPCMethodDescriptor *descriptor = [self descriptorForSelector:invocation.selector];
+    JRPCMetricsRecorder *metrics = [self activeMetrics];
+    JRPCTracer *tracer = self.tracer;
+    JRPCCallTrace *trace = tracer ? [JRPCCallTrace traceWithTracer:tracer descriptor:descriptor] : nil;
+    uint64_t callTime = trace ? trace.startTime : JRPCMetricsStartTime(metrics);
+    if (descriptor.isNotification) {
+        // Notifications have no id, response or completion, and are never batched, so send straight away
+        id payload = [self payloadForInvocation:invocation descriptor:descriptor requestId:0 metrics:metrics trace:trace];
+        [self dispatchJSONRPCNotification:payload metrics:metrics trace:trace];
+        return;
     }
-    else {
-        // By-Position: method name is entire first component of the selector. 'doSomethingWithCompletion:' is NOT supported, should be simply 'doSomething:'
-        jsonRPCRequest[kJSONRPCMethodKey] = paramNames[0];
-        if (paramValues.count > 0) {
-            // Only include "params" key in JSON-RPC payload if at least one key-value pair
-            jsonRPCRequest[kJSONRPCParamsKey] = paramValues;
+    // Grab the completion block from last param of invocation. Copy it, since the caller may have passed a stack block
+    __unsafe_unretained id invocationCompletionBlock = nil;
+    [invocation getArgument:&invocationCompletionBlock atIndex:descriptor.completionBlockIndex];
+    id completionBlock = [invocationCompletionBlock copy];
+    // Calls to cached methods may be answered from the cache, or by an identical request already in flight
+    JRPCCachePolicy *cachePolicy = descriptor.cachePolicy;
+    NSData *cacheKey = nil;
+    if (cachePolicy) {
+        cacheKey = [descriptor cacheKeyForInvocation:invocation];
+        if (![self lookupCachedCallWithDescriptor:descriptor policy:cachePolicy cacheKey:cacheKey completionBlock:&completionBlock]) {
+            return;
         }
     }
     
-    if (self.transportPerformsSerialization) {
-        // Transport prefers to handle request & response JSON serialization
-        [self dispatchJSONRPCRequest:[jsonRPCRequest copy] completionBlock:completionBlock];
+    NSUInteger requestId = [self nextRequestId];
+    id payload = nil;
+    @try {
+        payload = [self payloadForInvocation:invocation descriptor:descriptor requestId:requestId metrics:metrics trace:trace];
+    }
+    @catch (NSException *exception) {
+        if (cacheKey) {
+            // The lookup registered this call's request as in flight, so identical calls would otherwise wait on it forever
+            [self failCallsWaitingForKey:cacheKey exception:exception];
+        }
+        @throw;
+    }
+    JRPCPendingRequest *request = [JRPCPendingRequest requestWithId:requestId descriptor:descriptor completionBlock:completionBlock payload:payload cacheKey:cacheKey];
+    request.metrics = metrics;
+    request.trace = trace;
+    request.callTime = callTime;
+    [metrics beginRequest:request];
+    if (cacheKey) {
+        // Before the call can be cancelled or time out, so the cache knows which request it is giving up on
+        [self.responseCache startRequest:request forKey:cacheKey];
+    }
+    if (completionBlock) {
+        [self captureCall:request];
+    }
+    if (self.scheduler.maxConcurrentCalls > 0) {
+        // Sent when the scheduler has a slot free for it
+        [self.scheduler scheduleRequest:request priority:descriptor.priority];
+    }
+    else {
+        [self sendPendingRequest:request];
+    }
+    // Only once the scheduler knows of the request, so it is told if the request times out. A request already completed cancels the timer straight away
+    [self scheduleTimeoutForRequest:request];
+}
+
+- (void) sendPendingRequest:(JRPCPendingRequest*)request {
+    if (self.transportSupportsBatches && self.batchWindow > 0) {
+        [self enqueueBatchRequest:request];
     }
     else {
-        // This class will handle request & response JSON serialization
-        [self dispatchSerializedJSONRPCRequest:[jsonRPCRequest copy] completionBlock:completionBlock];
+        [self dispatchPendingRequest:request];
+    }
+}
+
+- (id) payloadForInvocation:(NSInvocation *)invocation
+                 descriptor:(JRPCMethodDescriptor*)descriptor
+                  requestId:(NSUInteger)requestId
+                    metrics:(JRPCMetricsRecorder*)metrics
+                      trace:(JRPCCallTrace*)trace {
+    uint64_t marshallingTime = JRPCPhaseStartTime(metrics, trace);
+    NSString *traceContext = (trace && self.injectsTraceContext) ? trace.traceContext : nil;
+    if (self.transportPerformsSerialization) {
+        // Transport prefers to handle request & response serialization
+        NSDictionary *requestObject = [self requestObjectForInvocation:invocation descriptor:descriptor requestId:requestId traceContext:traceContext];
+        JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseMarshalling, marshallingTime);
+        return requestObject;
+    }
+    // This class will handle request & response serialization
+    id<JRPCCodec> codec = self.codec;
+    if (JRPCCodecIsJSON(codec)) {
+        // The request is encoded straight from the invocation, so marshalling is timed as serialization
+        id payload = self.transportUsesDispatchData ?
+            [descriptor requestDispatchDataForInvocation:invocation requestId:requestId traceContext:traceContext] :
+            [descriptor requestDataForInvocation:invocation requestId:requestId traceContext:traceContext];
+        JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseSerialization, marshallingTime);
+        return payload;
+    }
+    NSDictionary *requestObject = [self requestObjectForInvocation:invocation descriptor:descriptor requestId:requestId traceContext:traceContext];
+    JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseMarshalling, marshallingTime);
+    uint64_t serializationTime = JRPCPhaseStartTime(metrics, trace);
+    NSError *error = nil;
+    NSData *payload = [codec encodeObject:requestObject error:&error];
+    if (!payload) {
+        [NSException raise:NSInvalidArgumentException format:@"Unable to encode request with codec %@: %@", codec.name, error.userInfo[NSDebugDescriptionErrorKey]];
+    }
+    JRPCRecordPhase(metrics, trace, JRPCMetricsPhaseSerialization, serializationTime);
+    return self.transportUsesDispatchData ? JRPCDispatchDataWithData(payload) : payload;
+}
+
+- (NSDictionary*) requestObjectForInvocation:(NSInvocation *)invocation
+                                  descriptor:(JRPCMethodDescriptor*)descriptor
+                                   requestId:(NSUInteger)requestId
+                                traceContext:(NSString*)traceContext {
+    NSMutableDictionary *jsonRPCRequest = [@{
+                                            kJSONRPCVersionKey      : kJSONRPCVersion,
+                                            kJSONRPCMethodKey       : descriptor.methodName
+                                            } mutableCopy];
+    if (!descriptor.isNotification) {
+        // Notifications are requests without an id
+        jsonRPCRequest[kJSONRPCRequestIdKey] = @(requestId);
+    }
+    if (traceContext) {
+        jsonRPCRequest[JRPCTraceContextKey] = traceContext;
+    }
+    // Grab parameter values from the invocation using the precompiled plans. These will be the same regardless of JSON-RPC parameter structure
+    NSArray *paramValues = [descriptor paramValuesFromInvocation:invocation];
+    if (paramValues.count > 0) {
+        // Only include "params" key in JSON-RPC payload if at least one parameter
+        if (JRPCParameterStructureByName == self.paramStructure) {
+            jsonRPCRequest[kJSONRPCParamsKey] = [NSDictionary dictionaryWithObjects:paramValues forKeys:descriptor.paramNames];
+        }
+        else {
+            jsonRPCRequest[kJSONRPCParamsKey] = paramValues;
+        }
     }
+    return [jsonRPCRequest copy];
 }
 
 @end
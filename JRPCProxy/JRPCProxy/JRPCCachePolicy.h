@@ -0,0 +1,95 @@
+//
+//  JRPCCachePolicy.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Counters for the response cache of a JRPCAbstractProxy, see cacheStatistics
+ */
+typedef struct JRPCCacheStatistics {
+    /** Calls completed with a fresh cached response */
+    NSUInteger hits;
+    /** Calls completed with a stale cached response, while it was revalidated */
+    NSUInteger staleHits;
+    /** Calls that sent a request, because no usable response was cached */
+    NSUInteger misses;
+    /** Calls that waited for an identical request already in flight, rather than sending their own */
+    NSUInteger coalesced;
+    /** Cached responses removed to keep within a policy's limits */
+    NSUInteger evictions;
+} JRPCCacheStatistics;
+
+/**
+ JRPCCachePolicy describes how the responses of an idempotent proxied method are cached by JRPCAbstractProxy. See setCachePolicy:forSelector:
+ @discussion Responses are cached by method name and params, with dictionary params compared by value. Only successful responses are cached.
+ The limits of a policy apply to every method it is set for together, so give each method its own policy for separate limits.
+ When a limit is reached, expired responses are removed first, then the oldest. Policies are immutable
+ */
+@interface JRPCCachePolicy : NSObject
+
+/**
+ Factory method to create a policy without entry or byte limits, or stale-while-revalidate
+ @param timeToLive How long a response is fresh, in seconds
+ @return An initialized policy
+ */
++ (instancetype) policyWithTimeToLive:(NSTimeInterval)timeToLive;
+
+/**
+ Initializes a policy
+ @param timeToLive How long a response is fresh, in seconds
+ @param staleWhileRevalidate How long, in seconds, after a response stops being fresh that it is still returned while a new one is fetched in the background. 0 to disable
+ @param maxEntryCount The maximum number of responses cached, 0 for no limit
+ @param maxBytes The maximum total size of the responses cached, 0 for no limit. Only the serialized size of responses is known, so this does not limit responses from transports that perform JSON serialization
+ @return An initialized policy
+ */
+- (instancetype) initWithTimeToLive:(NSTimeInterval)timeToLive
+               staleWhileRevalidate:(NSTimeInterval)staleWhileRevalidate
+                      maxEntryCount:(NSUInteger)maxEntryCount
+                           maxBytes:(NSUInteger)maxBytes NS_DESIGNATED_INITIALIZER;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+/** How long a response is fresh, in seconds */
+@property (nonatomic, readonly) NSTimeInterval timeToLive;
+
+/** How long, in seconds, after a response stops being fresh that it is still returned while a new one is fetched in the background */
+@property (nonatomic, readonly) NSTimeInterval staleWhileRevalidate;
+
+/** The maximum number of responses cached, 0 for no limit */
+@property (nonatomic, readonly) NSUInteger maxEntryCount;
+
+/** The maximum total size of the responses cached in bytes, 0 for no limit */
+@property (nonatomic, readonly) NSUInteger maxBytes;
+
+@end
+
+NS_ASSUME_NONNULL_END
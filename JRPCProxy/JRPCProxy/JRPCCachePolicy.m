@@ -0,0 +1,59 @@
+//
+//  JRPCCachePolicy.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCCachePolicy.h"
+
+@interface JRPCCachePolicy()
+@property (nonatomic, assign) NSTimeInterval timeToLive;
+@property (nonatomic, assign) NSTimeInterval staleWhileRevalidate;
+@property (nonatomic, assign) NSUInteger maxEntryCount;
+@property (nonatomic, assign) NSUInteger maxBytes;
+@end
+
+@implementation JRPCCachePolicy
+
++ (instancetype) policyWithTimeToLive:(NSTimeInterval)timeToLive {
+    return [[self alloc] initWithTimeToLive:timeToLive staleWhileRevalidate:0 maxEntryCount:0 maxBytes:0];
+}
+
+- (instancetype) initWithTimeToLive:(NSTimeInterval)timeToLive
+               staleWhileRevalidate:(NSTimeInterval)staleWhileRevalidate
+                      maxEntryCount:(NSUInteger)maxEntryCount
+                           maxBytes:(NSUInteger)maxBytes {
+    self = [super init];
+    if (self) {
+        self.timeToLive = timeToLive;
+        self.staleWhileRevalidate = staleWhileRevalidate;
+        self.maxEntryCount = maxEntryCount;
+        self.maxBytes = maxBytes;
+    }
+    return self;
+}
+
+@end
@@ -0,0 +1,69 @@
+//
+//  JRPCCodec.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCCodec encodes JSON-RPC request objects to bytes and decodes response objects from them, for transports that leave serialization to the proxy.
+ The objects are JSON-RPC envelopes whatever the encoding: dictionaries with the same members, holding strings, numbers, NSNull, arrays & dictionaries.
+ A codec may also carry values JSON cannot, e.g. NSData. See codecs in JRPCAbstractProxy.h. Codecs must be safe to use from any thread
+ */
+@protocol JRPCCodec <NSObject>
+
+/** The name the proxy & transport agree on a codec by, e.g. "json". See supportedCodecNames in JRPCProxyTransport.h */
+@property (nonatomic, readonly, copy) NSString *name;
+
+/**
+ Encodes an object
+ @param object The object to encode, e.g. a JSON-RPC request object
+ @param error On return, the reason the object could not be encoded
+ @return The encoded object, or nil if it contains a value the codec cannot encode
+ */
+- (nullable NSData*) encodeObject:(id)object error:(NSError * _Nullable * _Nullable)error;
+
+/**
+ Decodes an object
+ @param data The encoded object, e.g. a JSON-RPC response object or an array of them
+ @param error On return, the reason the data could not be decoded
+ @return The decoded object, or nil if the data is not a valid encoding
+ */
+- (nullable id) decodeData:(NSData*)data error:(NSError * _Nullable * _Nullable)error;
+
+/**
+ Joins encoded objects into an encoded array of them, e.g. the requests of a batch, without decoding them again
+ @param encodedObjects Objects encoded by encodeObject:error:
+ @return The encoded array
+ */
+- (NSData*) encodeArrayWithEncodedObjects:(NSArray<NSData*>*)encodedObjects;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,129 @@
+//
+//  JRPCDispatcher.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCAbstractProxy.h"
+#import "JRPCCodec.h"
+#import "JRPCTracer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The public Objective-C runtime describes a method's object params only as id, and its completion block only as a block, without the classes and
+ block signature the protocol declares. A dispatcher's target adopts JRPCDispatchTarget to declare them with a block of the same type as the method
+ */
+@protocol JRPCDispatchTarget <NSObject>
+
+/**
+ Returns a block taking the same params as a method, so the dispatcher can read their types from the block's signature. The block is never called
+ @param selector The selector of a protocol method, e.g. add::: for - (void) add:(NSInteger)a :(NSInteger)b :(void (^)(NSInteger result, NSError *error))completion
+ @return A block such as ^(NSInteger a, NSInteger b, void (^completion)(NSInteger result, NSError *error)) {}, or nil if the method's object params are
+ passed as they are and its completion block takes an object result
+ */
+- (nullable id) JSONRPCSignatureBlockForSelector:(SEL)selector;
+
+@end
+
+/**
+ JRPCDispatcher serves JSON-RPC 2.0 requests by calling the methods of an object implementing an Objective-C protocol. It is the server side
+ counterpart of JRPCAbstractProxy, and maps JSON-RPC method names & params onto protocol methods by the same conventions (see JRPCAbstractProxy.h),
+ so a protocol shared by both ends needs no further description
+ 
+ Each method's implementation calls its completion block with the result or an NSError, on any thread, once. Params are unmarshalled to the
+ types the method declares: primitives from numbers, and objects of a JRPCTransformable class with initWithJSONRPCResponseResult: when the
+ request holds some other type. Results are returned as they would be sent as params (see JRPCTransformable)
+ 
+ Object param classes and the completion block's result type are only known for the methods a target describes with JRPCDispatchTarget. A method
+ whose completion block takes a primitive or streamed result must be described, since the block the dispatcher passes would otherwise take an object
+ 
+ ERRORS:
+ Requests that cannot be handled get the JSON-RPC error responses of the specification (see JSONRPCErrorCode): a parse error, an invalid
+ request, an unknown method, or params that do not match the method. An exception raised by an implementation is an internal error.
+ An NSError passed to a completion block is returned as the JSON-RPC error in its kJRPCErrorCodeKey, kJRPCErrorMessageKey & kJRPCErrorDataKey
+ userInfo, as the proxy reports server errors, so errors returned by a proxy can be passed straight through. Any other NSError is returned
+ as a JSONRPCErrorCodeServerError error with its localizedDescription
+ 
+ THREAD SAFETY:
+ Requests may be handled from any number of threads at once. The method table is built when the dispatcher is created and immutable after,
+ and the requests of a batch are dispatched independently, so a slow method does not hold back the others
+ */
+@interface JRPCDispatcher : NSObject
+
+/**
+ Factory method to create and return a dispatcher for a given protocol
+ @param protocol The Objective-C protocol implemented by target
+ @param paramStructure The parameter structure of the JSON-RPC service
+ @param target The object implementing the protocol. It is retained by the dispatcher
+ @return An initialized dispatcher
+ @discussion As for JRPCAbstractProxy, only required instance methods are supported, including those of adopted protocols. Raises
+ NSInvalidArgumentException if a method does not follow the conventions, uses unsupported types, or is not implemented by target
+ */
++ (instancetype) dispatcherForProtocol:(Protocol*)protocol
+                        paramStructure:(JRPCParameterStructure)paramStructure
+                                target:(id)target;
+
+/** The object implementing the protocol */
+@property (nonatomic, readonly) id target;
+
+/**
+ The queue that protocol methods are called on. Each request is dispatched to it separately, so a concurrent queue calls the requests of a batch,
+ and requests handled at once, concurrently. If nil (the default) an internal concurrent queue is used
+ */
+@property (atomic, strong, null_resettable) dispatch_queue_t dispatchQueue;
+
+/** The codec request data is decoded & response data encoded with. Defaults to a JRPCJSONCodec */
+@property (atomic, strong) id<JRPCCodec> codec;
+
+/**
+ The tracer that requests sent with a trace context (see injectsTraceContext in JRPCAbstractProxy) write a span to, from when the request is handled
+ until its response is ready, as a child of the span of the call that sent it. nil (the default) for no tracing
+ */
+@property (atomic, strong, nullable) JRPCTracer *tracer;
+
+/**
+ Handles a serialized JSON-RPC request, or batch of requests
+ @param requestData The request, encoded with codec
+ @param completion Called on an arbitrary queue with the encoded response, or nil if there is no response to send, i.e. only notifications were received
+ */
+- (void) handleRequestData:(NSData*)requestData completion:(void (^)(NSData * _Nullable responseData))completion;
+
+/**
+ Handles a JSON-RPC request object, or batch of them, for transports that perform serialization themselves
+ @param request The request dictionary, or an array of them
+ @param completion Called on an arbitrary queue with the response dictionary, an array of them for a batch, or nil if there is no response to send
+ */
+- (void) handleRequestObject:(id)request completion:(void (^)(id _Nullable response))completion;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,393 @@
+//
+//  JRPCDispatcher.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCDispatcher.h"
+#import "JRPCDispatchMethod.h"
+#import "JRPCArgumentPlan.h"
+#import "JRPCAtomicReference.h"
+#import "JRPCError.h"
+#import "JRPCJSONCodec.h"
+#import "NSDictionary+JSONRPC.h"
+#import "JRPCCallTrace.h"
+#import <objc/runtime.h>
+#import <stdatomic.h>
+
+// JSON-RPC Version
+static const NSString * const kJSONRPCVersion = @"2.0";
+
+static const char *JSON_RPC_DISPATCH_QUEUE_NAME = "JRPCDispatcherQueue";
+
+/** Passes the response to a request on to its completion, once. An implementation calling its completion block again is ignored */
+@interface JRPCDispatchContext : NSObject {
+    @public
+    atomic_flag _replied;
+}
+@property (nonatomic, copy) void (^completion)(NSDictionary *response);
+@end
+
+@implementation JRPCDispatchContext
+
+- (instancetype) initWithCompletion:(void (^)(NSDictionary *response))completion {
+    self = [super init];
+    if (self) {
+        atomic_flag_clear(&_replied);
+        self.completion = completion;
+    }
+    return self;
+}
+
+- (BOOL) reply:(NSDictionary*)response {
+    if (atomic_flag_test_and_set(&_replied)) {
+        return NO;
+    }
+    self.completion(response);
+    return YES;
+}
+
+@end
+
+@interface JRPCDispatcher() {
+    // Read for every request, so without the lock an atomic property takes
+    JRPCAtomicReference _dispatchQueueReference;
+    JRPCAtomicReference _codecReference;
+    JRPCAtomicReference _tracerReference;
+}
+@property (nonatomic, strong) id target;
+// Method name -> JRPCDispatchMethod, immutable once the dispatcher is created
+@property (nonatomic, copy) NSDictionary<NSString*, JRPCDispatchMethod*> *methods;
+@property (nonatomic, strong) dispatch_queue_t defaultDispatchQueue;
+@end
+
+@implementation JRPCDispatcher
+
++ (instancetype) dispatcherForProtocol:(Protocol*)protocol
+                        paramStructure:(JRPCParameterStructure)paramStructure
+                                target:(id)target {
+    return [[self alloc] initWithProtocol:protocol paramStructure:paramStructure target:target];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithProtocol:(Protocol*)protocol
+                   paramStructure:(JRPCParameterStructure)paramStructure
+                           target:(id)target {
+    self = [super init];
+    if (self) {
+        JRPCAtomicReferenceInit(&_dispatchQueueReference);
+        JRPCAtomicReferenceInit(&_codecReference);
+        JRPCAtomicReferenceInit(&_tracerReference);
+        // Parse & validate the protocol methods up front. This will raise if any method does not follow convention
+        NSMutableDictionary<NSString*, JRPCDispatchMethod*> *methods = [[NSMutableDictionary alloc] init];
+        [[self class] addMethodsForProtocol:protocol paramStructure:paramStructure target:target toTable:methods];
+        self.methods = methods;
+        self.target = target;
+        self.defaultDispatchQueue = dispatch_queue_create(JSON_RPC_DISPATCH_QUEUE_NAME, DISPATCH_QUEUE_CONCURRENT);
+        self.codec = [[JRPCJSONCodec alloc] init];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    JRPCAtomicReferenceDestroy(&_dispatchQueueReference);
+    JRPCAtomicReferenceDestroy(&_codecReference);
+    JRPCAtomicReferenceDestroy(&_tracerReference);
+}
+
++ (void) addMethodsForProtocol:(Protocol *)protocol
+                paramStructure:(JRPCParameterStructure)paramStructure
+                        target:(id)target
+                       toTable:(NSMutableDictionary<NSString*, JRPCDispatchMethod*> *)methods {
+    // Only required instance methods are supported
+    unsigned int methodCount = 0;
+    struct objc_method_description *methodDescs = protocol_copyMethodDescriptionList(protocol, YES, YES, &methodCount);
+    for (unsigned int i = 0; i < methodCount; ++i) {
+        id signatureBlock = [target respondsToSelector:@selector(JSONRPCSignatureBlockForSelector:)] ? [target JSONRPCSignatureBlockForSelector:methodDescs[i].name] : nil;
+        JRPCDispatchMethod *method = [JRPCDispatchMethod methodWithMethodDescription:methodDescs[i] signatureBlock:signatureBlock paramStructure:paramStructure];
+        JRPCMethodDescriptor *descriptor = method.descriptor;
+        if (![target respondsToSelector:descriptor.selector]) {
+            free(methodDescs);
+            [NSException raise:NSInvalidArgumentException format:@"target does not implement selector: %@", NSStringFromSelector(descriptor.selector)];
+        }
+        // BY-NAME, selectors with different param names map to the same method name, and a request could not say which it is for
+        JRPCDispatchMethod *existingMethod = methods[descriptor.methodName];
+        if (existingMethod && !sel_isEqual(existingMethod.descriptor.selector, descriptor.selector)) {
+            free(methodDescs);
+            [NSException raise:NSInvalidArgumentException format:@"selectors: %@ and %@ have the same method name: %@",
+             NSStringFromSelector(existingMethod.descriptor.selector), NSStringFromSelector(descriptor.selector), descriptor.methodName];
+        }
+        methods[descriptor.methodName] = method;
+    }
+    free(methodDescs);
+    // Include the methods of adopted protocols, except NSObject
+    unsigned int protocolCount = 0;
+    Protocol * __unsafe_unretained *protocols = protocol_copyProtocolList(protocol, &protocolCount);
+    for (unsigned int i = 0; i < protocolCount; ++i) {
+        if (!protocol_isEqual(protocols[i], @protocol(NSObject))) {
+            [self addMethodsForProtocol:protocols[i] paramStructure:paramStructure target:target toTable:methods];
+        }
+    }
+    free(protocols);
+}
+
+- (dispatch_queue_t) dispatchQueue {
+    return JRPCAtomicReferenceLoad(&_dispatchQueueReference) ? : self.defaultDispatchQueue;
+}
+
+- (void) setDispatchQueue:(dispatch_queue_t)dispatchQueue {
+    JRPCAtomicReferenceStore(&_dispatchQueueReference, dispatchQueue);
+}
+
+- (id<JRPCCodec>) codec {
+    return JRPCAtomicReferenceLoad(&_codecReference);
+}
+
+- (void) setCodec:(id<JRPCCodec>)codec {
+    if (!codec) {
+        [NSException raise:NSInvalidArgumentException format:@"codec MUST not be nil"];
+    }
+    JRPCAtomicReferenceStore(&_codecReference, codec);
+}
+
+- (JRPCTracer*) tracer {
+    return JRPCAtomicReferenceLoad(&_tracerReference);
+}
+
+- (void) setTracer:(JRPCTracer*)tracer {
+    JRPCAtomicReferenceStore(&_tracerReference, tracer);
+}
+
+#pragma mark - Responses
+
++ (NSDictionary*) responseWithResult:(id)result requestId:(id)requestId {
+    return @{
+             kJSONRPCVersionKey      : kJSONRPCVersion,
+             kJSONRPCResultKey       : result,
+             kJSONRPCRequestIdKey    : requestId
+             };
+}
+
++ (NSDictionary*) responseWithErrorCode:(NSInteger)code message:(NSString*)message data:(id)data requestId:(nullable id)requestId {
+    NSMutableDictionary *jsonRPCError = [@{
+                                           kJSONRPCErrorCodeKey    : @(code),
+                                           kJSONRPCErrorMessageKey : message ? : @""
+                                           } mutableCopy];
+    if (data) {
+        jsonRPCError[kJSONRPCErrorDataKey] = data;
+    }
+    // The id is null if it could not be determined
+    return @{
+             kJSONRPCVersionKey      : kJSONRPCVersion,
+             kJSONRPCErrorKey        : [jsonRPCError copy],
+             kJSONRPCRequestIdKey    : requestId ? : [NSNull null]
+             };
+}
+
+// The JSON-RPC error for an NSError passed to a completion block
++ (NSDictionary*) responseWithError:(NSError*)error requestId:(id)requestId {
+    NSDictionary *userInfo = error.userInfo;
+    NSNumber *jsonErrorCode = userInfo[kJRPCErrorCodeKey];
+    if (![jsonErrorCode isKindOfClass:[NSNumber class]]) {
+        return [self responseWithErrorCode:JSONRPCErrorCodeServerError message:error.localizedDescription data:nil requestId:requestId];
+    }
+    NSString *jsonErrorMsg = userInfo[kJRPCErrorMessageKey];
+    if (![jsonErrorMsg isKindOfClass:[NSString class]]) {
+        jsonErrorMsg = error.localizedDescription;
+    }
+    return [self responseWithErrorCode:jsonErrorCode.integerValue
+                               message:jsonErrorMsg
+                                  data:JRPCJSONObjectForParameter(userInfo[kJRPCErrorDataKey])
+                             requestId:requestId];
+}
+
+// YES if the request object has the members of a JSON-RPC request, of the right types
+static BOOL JRPCIsValidRequest(NSDictionary *request) {
+    id params = request[kJSONRPCParamsKey];
+    id requestId = request[kJSONRPCRequestIdKey];
+    return [kJSONRPCVersion isEqual:request[kJSONRPCVersionKey]] &&
+        [request[kJSONRPCMethodKey] isKindOfClass:[NSString class]] &&
+        (!params || [params isKindOfClass:[NSArray class]] || [params isKindOfClass:[NSDictionary class]]) &&
+        (!requestId || [requestId isKindOfClass:[NSString class]] || [requestId isKindOfClass:[NSNumber class]] || [NSNull null] == requestId);
+}
+
+#pragma mark - Dispatch
+
+- (void) handleRequestObject:(id)request completion:(void (^)(id response))completion {
+    if ([request isKindOfClass:[NSArray class]]) {
+        [self handleBatch:request completion:completion];
+    }
+    else {
+        [self handleRequest:request completion:completion];
+    }
+}
+
+- (void) handleBatch:(NSArray*)requests completion:(void (^)(id response))completion {
+    NSUInteger count = requests.count;
+    if (0 == count) {
+        completion([[self class] responseWithErrorCode:JSONRPCErrorCodeInvalidRequest message:@"Invalid Request" data:nil requestId:nil]);
+        return;
+    }
+    // Responses are kept in the order of the requests, and NSNull until each arrives, or for notifications which get none
+    NSMutableArray *responses = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [responses addObject:[NSNull null]];
+    }
+    dispatch_group_t group = dispatch_group_create();
+    [requests enumerateObjectsUsingBlock:^(id request, NSUInteger index, BOOL *stop) {
+        dispatch_group_enter(group);
+        [self handleRequest:request completion:^(NSDictionary *response) {
+            if (response) {
+                @synchronized(responses) {
+                    responses[index] = response;
+                }
+            }
+            dispatch_group_leave(group);
+        }];
+    }];
+    dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        NSArray<NSDictionary*> *batchResponses = nil;
+        @synchronized(responses) {
+            [responses removeObjectIdenticalTo:[NSNull null]];
+            batchResponses = [responses copy];
+        }
+        // A batch of only notifications gets no response at all, rather than an empty array
+        completion(batchResponses.count ? batchResponses : nil);
+    });
+}
+
+- (void) handleRequest:(id)request completion:(void (^)(NSDictionary *response))completion {
+    if (![request isKindOfClass:[NSDictionary class]] || !JRPCIsValidRequest(request)) {
+        // Invalid requests get a response, with the id if it can be determined, even if they look like notifications
+        id requestId = [request isKindOfClass:[NSDictionary class]] ? ((NSDictionary*)request).jsonRPC_requestId : nil;
+        BOOL isValidRequestId = [requestId isKindOfClass:[NSString class]] || [requestId isKindOfClass:[NSNumber class]];
+        completion([[self class] responseWithErrorCode:JSONRPCErrorCodeInvalidRequest message:@"Invalid Request" data:nil
+                                             requestId:isValidRequestId ? requestId : nil]);
+        return;
+    }
+    NSDictionary *jsonRPCRequest = request;
+    // A null id is still a request, unlike a missing one. Notifications get no response, even if they fail
+    id requestId = jsonRPCRequest[kJSONRPCRequestIdKey];
+    BOOL isNotification = (nil == requestId);
+    JRPCDispatchMethod *method = self.methods[jsonRPCRequest.jsonRPC_methodName];
+    if (!method) {
+        completion(isNotification ? nil :
+                   [[self class] responseWithErrorCode:JSONRPCErrorCodeMethodNotFound message:@"Method not found" data:nil requestId:requestId]);
+        return;
+    }
+    JRPCTracer *tracer = self.tracer;
+    JRPCCallTrace *trace = tracer ? [JRPCCallTrace traceWithTracer:tracer traceContext:jsonRPCRequest[JRPCTraceContextKey] methodName:method.descriptor.methodName] : nil;
+    if (trace) {
+        // The request's span ends when its response is ready, or when it is found to need none
+        void (^tracedCompletion)(NSDictionary*) = completion;
+        completion = ^(NSDictionary *response) {
+            BOOL failed = (nil != response[kJSONRPCErrorKey]);
+            [trace finishWithError:failed ? [NSError errorWithDomain:JRPCErrorDomain code:response.jsonRPC_errorCode userInfo:nil] : nil];
+            tracedCompletion(response);
+        };
+    }
+    JRPCDispatchContext *context = [[JRPCDispatchContext alloc] initWithCompletion:completion];
+    NSInvocation *invocation = [method invocationWithTarget:self.target params:jsonRPCRequest[kJSONRPCParamsKey] reply:^(id result, NSError *error) {
+        if (isNotification) {
+            [context reply:nil];
+        }
+        else if (error) {
+            [context reply:[[self class] responseWithError:error requestId:requestId]];
+        }
+        else {
+            // Results are represented as they would be as params, and nil is null
+            id jsonResult = result ? JRPCJSONObjectForParameter(result) : [NSNull null];
+            [context reply:jsonResult ? [[self class] responseWithResult:jsonResult requestId:requestId] :
+             [[self class] responseWithErrorCode:JSONRPCErrorCodeInternalError message:@"Unsupported result type" data:nil requestId:requestId]];
+        }
+    }];
+    if (!invocation) {
+        completion(isNotification ? nil :
+                   [[self class] responseWithErrorCode:JSONRPCErrorCodeInvalidParameters message:@"Invalid params" data:nil requestId:requestId]);
+        return;
+    }
+    BOOL hasCompletionBlock = !method.descriptor.isNotification;
+    dispatch_async(self.dispatchQueue, ^{
+        @try {
+            [invocation invoke];
+        }
+        @catch (NSException *exception) {
+            [context reply:isNotification ? nil :
+             [[self class] responseWithErrorCode:JSONRPCErrorCodeInternalError message:exception.reason data:nil requestId:requestId]];
+            return;
+        }
+        // A method without a completion block has nothing to wait for, and is answered with null if called with an id
+        if (!hasCompletionBlock) {
+            [context reply:isNotification ? nil : [[self class] responseWithResult:[NSNull null] requestId:requestId]];
+        }
+    });
+}
+
+#pragma mark - Serialization
+
+- (void) handleRequestData:(NSData*)requestData completion:(void (^)(NSData *responseData))completion {
+    id<JRPCCodec> codec = self.codec;
+    id request = [codec decodeData:requestData error:nil];
+    if (!request) {
+        completion([self encodeResponse:[[self class] responseWithErrorCode:JSONRPCErrorCodeParsing message:@"Parse error" data:nil requestId:nil]
+                              withCodec:codec]);
+        return;
+    }
+    [self handleRequestObject:request completion:^(id response) {
+        if (!response) {
+            completion(nil);
+        }
+        else if ([response isKindOfClass:[NSArray class]]) {
+            // Encoded one by one, so a response that cannot be encoded only fails its own call
+            NSMutableArray<NSData*> *encodedResponses = [[NSMutableArray alloc] initWithCapacity:[response count]];
+            for (NSDictionary *batchResponse in response) {
+                [encodedResponses addObject:[self encodeResponse:batchResponse withCodec:codec]];
+            }
+            completion([codec encodeArrayWithEncodedObjects:encodedResponses]);
+        }
+        else {
+            completion([self encodeResponse:response withCodec:codec]);
+        }
+    }];
+}
+
+- (NSData*) encodeResponse:(NSDictionary*)response withCodec:(id<JRPCCodec>)codec {
+    NSError *error = nil;
+    NSData *responseData = [codec encodeObject:response error:&error];
+    if (!responseData) {
+        // e.g. NSData in a result, which JSON cannot carry
+        NSDictionary *errorResponse = [[self class] responseWithErrorCode:JSONRPCErrorCodeInternalError
+                                                                  message:error.localizedDescription ? : @"Response could not be encoded"
+                                                                     data:nil
+                                                                requestId:response.jsonRPC_requestId];
+        responseData = [codec encodeObject:errorResponse error:nil];
+    }
+    return responseData;
+}
+
+@end
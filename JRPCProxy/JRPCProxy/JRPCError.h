@@ -43,7 +43,13 @@ NS_ERROR_ENUM(JRPCErrorDomain) {
     /** Error occurred during JSON-RPC transport.  See NSUnderlyingErrorKey of userInfo */
     JRPCErrorTransportCode               = 1003,
     /** An error was returned by the JSON-PRC server in the payload. See userInfo keys below */
-    JRPCErrorServerResponseCode          = 1004
+    JRPCErrorServerResponseCode          = 1004,
+    /** The response to a JSON-RPC batch request did not include a response for the call */
+    JRPCErrorBatchResponseMissingCode    = 1005,
+    /** No response was received before the call's timeout elapsed. See defaultTimeout in JRPCAbstractProxy */
+    JRPCErrorTimedOutCode                = 1006,
+    /** The call was cancelled before a response was received. See JRPCCall */
+    JRPCErrorCancelledCode               = 1007
 };
 
 /**
@@ -76,6 +82,8 @@ typedef NS_ENUM(NSInteger, JSONRPCErrorCode) {
     /** Invalid method parameter(s). */
     JSONRPCErrorCodeInvalidParameters  = -32602,
     /** Internal JSON-RPC error. */
-    JSONRPCErrorCodeInternalError      = -32603
+    JSONRPCErrorCodeInternalError      = -32603,
+    /** An error raised by the method implementation. -32000 to -32099 are reserved for implementation-defined server errors */
+    JSONRPCErrorCodeServerError        = -32000
 };
 
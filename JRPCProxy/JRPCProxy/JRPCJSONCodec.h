@@ -0,0 +1,46 @@
+//
+//  JRPCJSONCodec.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCCodec.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The name of JRPCJSONCodec */
+FOUNDATION_EXTERN NSString * const JRPCCodecNameJSON;
+
+/**
+ JRPCJSONCodec encodes JSON-RPC objects as UTF-8 JSON text, as the JSON-RPC specification does. It is the default codec of JRPCAbstractProxy
+ @discussion The proxy does not call this codec for each request & response, but encodes requests straight from the invocation and scans responses
+ lazily, with exactly the same output. Subclasses are called like any other codec
+ */
+@interface JRPCJSONCodec : NSObject <JRPCCodec>
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,78 @@
+//
+//  JRPCJSONCodec.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCJSONCodec.h"
+#import "JRPCJSONWriter.h"
+
+NSString * const JRPCCodecNameJSON = @"json";
+
+@implementation JRPCJSONCodec
+
+- (NSString*) name {
+    return JRPCCodecNameJSON;
+}
+
+- (NSData*) encodeObject:(id)object error:(NSError**)error {
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    @try {
+        JRPCJSONWriterAppendObject(&writer, object);
+    }
+    @catch (NSException *exception) {
+        JRPCJSONWriterDestroy(&writer);
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListWriteInvalidError
+                                     userInfo:@{ NSDebugDescriptionErrorKey : exception.reason ? : @"Invalid JSON object" }];
+        }
+        return nil;
+    }
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+- (id) decodeData:(NSData*)data error:(NSError**)error {
+    return [NSJSONSerialization JSONObjectWithData:data options:0 error:error];
+}
+
+- (NSData*) encodeArrayWithEncodedObjects:(NSArray<NSData*>*)encodedObjects {
+    // The objects are already encoded, so the array is just those joined with commas
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    JRPCJSONWriterAppendByte(&writer, '[');
+    for (NSUInteger i = 0; i < encodedObjects.count; ++i) {
+        NSData *encodedObject = encodedObjects[i];
+        if (i > 0) {
+            JRPCJSONWriterAppendByte(&writer, ',');
+        }
+        JRPCJSONWriterAppendBytes(&writer, encodedObject.bytes, encodedObject.length);
+    }
+    JRPCJSONWriterAppendByte(&writer, ']');
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+@end
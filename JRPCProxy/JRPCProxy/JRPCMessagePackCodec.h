@@ -0,0 +1,47 @@
+//
+//  JRPCMessagePackCodec.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCCodec.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The name of JRPCMessagePackCodec */
+FOUNDATION_EXTERN NSString * const JRPCCodecNameMessagePack;
+
+/**
+ JRPCMessagePackCodec encodes JSON-RPC objects as MessagePack (https://msgpack.org), which is more compact than JSON and quicker to encode & decode.
+ Unlike JSON it carries NSData natively, as MessagePack bin, so binary params & results need not be base64 encoded into strings. Suited to local
+ transports where both ends are under your control, e.g. between processes on the same device
+ @discussion Integers are written in the fewest bytes, float as float32 and double as float64. MessagePack extension types are not supported
+ */
+@interface JRPCMessagePackCodec : NSObject <JRPCCodec>
+@end
+
+NS_ASSUME_NONNULL_END
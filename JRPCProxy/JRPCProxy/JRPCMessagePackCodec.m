@@ -0,0 +1,394 @@
+//
+//  JRPCMessagePackCodec.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCMessagePackCodec.h"
+#import "JRPCJSONWriter.h"
+
+NSString * const JRPCCodecNameMessagePack = @"msgpack";
+
+// Containers nested deeper than this are rejected rather than risk exhausting the stack
+#define JRPC_MESSAGE_PACK_MAX_DEPTH 512
+
+#pragma mark - Encoding
+
+// The JSON writer's growable buffer is reused as a plain byte buffer. Only its raw append functions are used here
+
+static void JRPCMessagePackAppendBigEndian(JRPCJSONWriter *writer, uint8_t type, uint64_t value, NSUInteger size) {
+    uint8_t *dest = JRPCJSONWriterReserve(writer, 1 + size);
+    dest[0] = type;
+    for (NSUInteger i = 0; i < size; ++i) {
+        dest[1 + i] = (uint8_t)(value >> (8 * (size - 1 - i)));
+    }
+    writer->length += 1 + size;
+}
+
+static void JRPCMessagePackAppendUInt64(JRPCJSONWriter *writer, uint64_t value) {
+    if (value < 0x80) {
+        JRPCJSONWriterAppendByte(writer, (uint8_t)value);               // positive fixint
+    } else if (value <= UINT8_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, 0xcc, value, 1);
+    } else if (value <= UINT16_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, 0xcd, value, 2);
+    } else if (value <= UINT32_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, 0xce, value, 4);
+    } else {
+        JRPCMessagePackAppendBigEndian(writer, 0xcf, value, 8);
+    }
+}
+
+static void JRPCMessagePackAppendInt64(JRPCJSONWriter *writer, int64_t value) {
+    if (value >= 0) {
+        JRPCMessagePackAppendUInt64(writer, (uint64_t)value);
+    } else if (value >= -32) {
+        JRPCJSONWriterAppendByte(writer, (uint8_t)value);               // negative fixint
+    } else if (value >= INT8_MIN) {
+        JRPCMessagePackAppendBigEndian(writer, 0xd0, (uint64_t)value, 1);
+    } else if (value >= INT16_MIN) {
+        JRPCMessagePackAppendBigEndian(writer, 0xd1, (uint64_t)value, 2);
+    } else if (value >= INT32_MIN) {
+        JRPCMessagePackAppendBigEndian(writer, 0xd2, (uint64_t)value, 4);
+    } else {
+        JRPCMessagePackAppendBigEndian(writer, 0xd3, (uint64_t)value, 8);
+    }
+}
+
+// Appends the header of a string, bin, array or map. fixType is 0 for types without a fix format, and type8 0 for types without an 8 bit length
+static void JRPCMessagePackAppendHeader(JRPCJSONWriter *writer, NSUInteger length, uint8_t fixType, NSUInteger fixLimit,
+                                        uint8_t type8, uint8_t type16, uint8_t type32) {
+    if (fixType && length < fixLimit) {
+        JRPCJSONWriterAppendByte(writer, fixType | (uint8_t)length);
+    } else if (type8 && length <= UINT8_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, type8, length, 1);
+    } else if (length <= UINT16_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, type16, length, 2);
+    } else if (length <= UINT32_MAX) {
+        JRPCMessagePackAppendBigEndian(writer, type32, length, 4);
+    } else {
+        [NSException raise:NSInvalidArgumentException format:@"Value too long for MessagePack (%lu)", (unsigned long)length];
+    }
+}
+
+static void JRPCMessagePackAppendNumber(JRPCJSONWriter *writer, NSNumber *number) {
+    CFTypeRef cfNumber = (__bridge CFTypeRef)number;
+    if (kCFBooleanTrue == cfNumber || kCFBooleanFalse == cfNumber) {
+        JRPCJSONWriterAppendByte(writer, kCFBooleanTrue == cfNumber ? 0xc3 : 0xc2);
+        return;
+    }
+    switch (number.objCType[0]) {
+        case 'f': {
+            float value = number.floatValue;
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof bits);
+            JRPCMessagePackAppendBigEndian(writer, 0xca, bits, 4);
+            break;
+        }
+        case 'd': {
+            double value = number.doubleValue;
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof bits);
+            JRPCMessagePackAppendBigEndian(writer, 0xcb, bits, 8);
+            break;
+        }
+        case 'Q':
+            JRPCMessagePackAppendUInt64(writer, number.unsignedLongLongValue);
+            break;
+        default:
+            JRPCMessagePackAppendInt64(writer, number.longLongValue);
+            break;
+    }
+}
+
+// Raises NSInvalidArgumentException for anything that cannot be encoded
+static void JRPCMessagePackAppendObject(JRPCJSONWriter *writer, id obj, NSUInteger depth) {
+    if ([obj isKindOfClass:[NSString class]]) {
+        NSString *string = (NSString*)obj;
+        NSUInteger maxLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        // Encode into space reserved after the longest possible header, then move the bytes down behind the actual header.
+        // Nothing written in between can outgrow the reservation, so the buffer does not move
+        uint8_t *dest = JRPCJSONWriterReserve(writer, 5 + maxLength);
+        NSUInteger length = 0;
+        [string getBytes:dest + 5 maxLength:maxLength usedLength:&length encoding:NSUTF8StringEncoding options:0
+                   range:NSMakeRange(0, string.length) remainingRange:NULL];
+        NSUInteger start = writer->length;
+        JRPCMessagePackAppendHeader(writer, length, 0xa0, 32, 0xd9, 0xda, 0xdb);
+        memmove(writer->bytes + writer->length, writer->bytes + start + 5, length);
+        writer->length += length;
+    } else if ([obj isKindOfClass:[NSNumber class]]) {
+        JRPCMessagePackAppendNumber(writer, obj);
+    } else if ([obj isKindOfClass:[NSNull class]]) {
+        JRPCJSONWriterAppendByte(writer, 0xc0);
+    } else if ([obj isKindOfClass:[NSData class]]) {
+        NSData *data = (NSData*)obj;
+        JRPCMessagePackAppendHeader(writer, data.length, 0, 0, 0xc4, 0xc5, 0xc6);
+        uint8_t *dest = JRPCJSONWriterReserve(writer, data.length);
+        [data getBytes:dest length:data.length];
+        writer->length += data.length;
+    } else if ([obj isKindOfClass:[NSArray class]]) {
+        if (depth >= JRPC_MESSAGE_PACK_MAX_DEPTH) {
+            [NSException raise:NSInvalidArgumentException format:@"Containers nested too deeply for MessagePack write"];
+        }
+        NSArray *array = (NSArray*)obj;
+        JRPCMessagePackAppendHeader(writer, array.count, 0x90, 16, 0, 0xdc, 0xdd);
+        for (id element in array) {
+            JRPCMessagePackAppendObject(writer, element, depth + 1);
+        }
+    } else if ([obj isKindOfClass:[NSDictionary class]]) {
+        if (depth >= JRPC_MESSAGE_PACK_MAX_DEPTH) {
+            [NSException raise:NSInvalidArgumentException format:@"Containers nested too deeply for MessagePack write"];
+        }
+        NSDictionary *dict = (NSDictionary*)obj;
+        JRPCMessagePackAppendHeader(writer, dict.count, 0x80, 16, 0, 0xde, 0xdf);
+        [dict enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            JRPCMessagePackAppendObject(writer, key, depth + 1);
+            JRPCMessagePackAppendObject(writer, value, depth + 1);
+        }];
+    } else {
+        [NSException raise:NSInvalidArgumentException format:@"Invalid type in MessagePack write (%@)", [obj class]];
+    }
+}
+
+#pragma mark - Decoding
+
+typedef struct JRPCMessagePackReader {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    NSData *data;
+    /** Why decoding stopped, or NULL */
+    const char *failure;
+} JRPCMessagePackReader;
+
+static BOOL JRPCMessagePackReadBigEndian(JRPCMessagePackReader *reader, NSUInteger size, uint64_t *value) {
+    if (reader->length - reader->offset < size) {
+        reader->failure = "Unexpected end of data";
+        return NO;
+    }
+    uint64_t result = 0;
+    for (NSUInteger i = 0; i < size; ++i) {
+        result = (result << 8) | reader->bytes[reader->offset + i];
+    }
+    reader->offset += size;
+    *value = result;
+    return YES;
+}
+
+// Checks at least minBytesPerElement * length bytes remain, so a corrupt length cannot cause a huge allocation
+static BOOL JRPCMessagePackCheckLength(JRPCMessagePackReader *reader, uint64_t length, NSUInteger minBytesPerElement) {
+    if (length > (reader->length - reader->offset) / minBytesPerElement) {
+        reader->failure = "Length exceeds the data";
+        return NO;
+    }
+    return YES;
+}
+
+static BOOL JRPCMessagePackReadLength(JRPCMessagePackReader *reader, NSUInteger size, NSUInteger minBytesPerElement, NSUInteger *length) {
+    uint64_t value = 0;
+    if (!JRPCMessagePackReadBigEndian(reader, size, &value) || !JRPCMessagePackCheckLength(reader, value, minBytesPerElement)) {
+        return NO;
+    }
+    *length = (NSUInteger)value;
+    return YES;
+}
+
+static id JRPCMessagePackReadObject(JRPCMessagePackReader *reader, NSUInteger depth);
+
+static id JRPCMessagePackReadString(JRPCMessagePackReader *reader, NSUInteger length) {
+    NSString *string = [[NSString alloc] initWithBytes:reader->bytes + reader->offset length:length encoding:NSUTF8StringEncoding];
+    if (!string) {
+        reader->failure = "Invalid UTF-8 in string";
+        return nil;
+    }
+    reader->offset += length;
+    return string;
+}
+
+static id JRPCMessagePackReadBinary(JRPCMessagePackReader *reader, NSUInteger length) {
+    NSData *data = [reader->data subdataWithRange:NSMakeRange(reader->offset, length)];
+    reader->offset += length;
+    return data;
+}
+
+static id JRPCMessagePackReadArray(JRPCMessagePackReader *reader, NSUInteger count, NSUInteger depth) {
+    if (depth >= JRPC_MESSAGE_PACK_MAX_DEPTH) {
+        reader->failure = "Containers nested too deeply";
+        return nil;
+    }
+    NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        id element = JRPCMessagePackReadObject(reader, depth + 1);
+        if (!element) {
+            return nil;
+        }
+        [array addObject:element];
+    }
+    return [array copy];
+}
+
+static id JRPCMessagePackReadMap(JRPCMessagePackReader *reader, NSUInteger count, NSUInteger depth) {
+    if (depth >= JRPC_MESSAGE_PACK_MAX_DEPTH) {
+        reader->failure = "Containers nested too deeply";
+        return nil;
+    }
+    NSMutableDictionary *dict = [[NSMutableDictionary alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        id key = JRPCMessagePackReadObject(reader, depth + 1);
+        id value = key ? JRPCMessagePackReadObject(reader, depth + 1) : nil;
+        if (!value) {
+            return nil;
+        }
+        dict[key] = value;
+    }
+    return [dict copy];
+}
+
+// Returns nil and sets reader->failure if the data is not valid
+static id JRPCMessagePackReadObject(JRPCMessagePackReader *reader, NSUInteger depth) {
+    if (reader->offset >= reader->length) {
+        reader->failure = "Unexpected end of data";
+        return nil;
+    }
+    uint8_t type = reader->bytes[reader->offset++];
+    uint64_t value = 0;
+    NSUInteger length = 0;
+    // Fix formats carry their value or length in the type byte
+    if (type <= 0x7f) {
+        return @(type);
+    }
+    if (type >= 0xe0) {
+        return @((int8_t)type);
+    }
+    if (type <= 0x8f) {
+        length = type & 0x0f;
+        return JRPCMessagePackCheckLength(reader, length, 2) ? JRPCMessagePackReadMap(reader, length, depth) : nil;
+    }
+    if (type <= 0x9f) {
+        length = type & 0x0f;
+        return JRPCMessagePackCheckLength(reader, length, 1) ? JRPCMessagePackReadArray(reader, length, depth) : nil;
+    }
+    if (type <= 0xbf) {
+        length = type & 0x1f;
+        return JRPCMessagePackCheckLength(reader, length, 1) ? JRPCMessagePackReadString(reader, length) : nil;
+    }
+    switch (type) {
+        case 0xc0: return [NSNull null];
+        case 0xc2: return @NO;
+        case 0xc3: return @YES;
+        case 0xc4: return JRPCMessagePackReadLength(reader, 1, 1, &length) ? JRPCMessagePackReadBinary(reader, length) : nil;
+        case 0xc5: return JRPCMessagePackReadLength(reader, 2, 1, &length) ? JRPCMessagePackReadBinary(reader, length) : nil;
+        case 0xc6: return JRPCMessagePackReadLength(reader, 4, 1, &length) ? JRPCMessagePackReadBinary(reader, length) : nil;
+        case 0xca: {
+            if (!JRPCMessagePackReadBigEndian(reader, 4, &value)) {
+                return nil;
+            }
+            uint32_t bits = (uint32_t)value;
+            float floatValue;
+            memcpy(&floatValue, &bits, sizeof floatValue);
+            return @(floatValue);
+        }
+        case 0xcb: {
+            if (!JRPCMessagePackReadBigEndian(reader, 8, &value)) {
+                return nil;
+            }
+            double doubleValue;
+            memcpy(&doubleValue, &value, sizeof doubleValue);
+            return @(doubleValue);
+        }
+        case 0xcc: return JRPCMessagePackReadBigEndian(reader, 1, &value) ? @(value) : nil;
+        case 0xcd: return JRPCMessagePackReadBigEndian(reader, 2, &value) ? @(value) : nil;
+        case 0xce: return JRPCMessagePackReadBigEndian(reader, 4, &value) ? @(value) : nil;
+        case 0xcf: return JRPCMessagePackReadBigEndian(reader, 8, &value) ? (value <= INT64_MAX ? @((int64_t)value) : @(value)) : nil;
+        case 0xd0: return JRPCMessagePackReadBigEndian(reader, 1, &value) ? @((int8_t)value) : nil;
+        case 0xd1: return JRPCMessagePackReadBigEndian(reader, 2, &value) ? @((int16_t)value) : nil;
+        case 0xd2: return JRPCMessagePackReadBigEndian(reader, 4, &value) ? @((int32_t)value) : nil;
+        case 0xd3: return JRPCMessagePackReadBigEndian(reader, 8, &value) ? @((int64_t)value) : nil;
+        case 0xd9: return JRPCMessagePackReadLength(reader, 1, 1, &length) ? JRPCMessagePackReadString(reader, length) : nil;
+        case 0xda: return JRPCMessagePackReadLength(reader, 2, 1, &length) ? JRPCMessagePackReadString(reader, length) : nil;
+        case 0xdb: return JRPCMessagePackReadLength(reader, 4, 1, &length) ? JRPCMessagePackReadString(reader, length) : nil;
+        case 0xdc: return JRPCMessagePackReadLength(reader, 2, 1, &length) ? JRPCMessagePackReadArray(reader, length, depth) : nil;
+        case 0xdd: return JRPCMessagePackReadLength(reader, 4, 1, &length) ? JRPCMessagePackReadArray(reader, length, depth) : nil;
+        case 0xde: return JRPCMessagePackReadLength(reader, 2, 2, &length) ? JRPCMessagePackReadMap(reader, length, depth) : nil;
+        case 0xdf: return JRPCMessagePackReadLength(reader, 4, 2, &length) ? JRPCMessagePackReadMap(reader, length, depth) : nil;
+        default:
+            // 0xc1 is never used, the rest are extension types
+            reader->failure = "Unsupported MessagePack type";
+            return nil;
+    }
+}
+
+#pragma mark - JRPCMessagePackCodec
+
+@implementation JRPCMessagePackCodec
+
+- (NSString*) name {
+    return JRPCCodecNameMessagePack;
+}
+
+- (NSData*) encodeObject:(id)object error:(NSError**)error {
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    @try {
+        JRPCMessagePackAppendObject(&writer, object, 0);
+    }
+    @catch (NSException *exception) {
+        JRPCJSONWriterDestroy(&writer);
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListWriteInvalidError
+                                     userInfo:@{ NSDebugDescriptionErrorKey : exception.reason ? : @"Invalid MessagePack object" }];
+        }
+        return nil;
+    }
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+- (id) decodeData:(NSData*)data error:(NSError**)error {
+    JRPCMessagePackReader reader = { .bytes = data.bytes, .length = data.length, .offset = 0, .data = data, .failure = NULL };
+    id object = JRPCMessagePackReadObject(&reader, 0);
+    if (object && reader.offset != reader.length) {
+        reader.failure = "Unexpected data after the end";
+        object = nil;
+    }
+    if (!object && error) {
+        *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError
+                                 userInfo:@{ NSDebugDescriptionErrorKey : @(reader.failure ? : "Invalid MessagePack data") }];
+    }
+    return object;
+}
+
+- (NSData*) encodeArrayWithEncodedObjects:(NSArray<NSData*>*)encodedObjects {
+    // MessagePack values are self delimiting, so the array is just a header followed by the objects
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    JRPCMessagePackAppendHeader(&writer, encodedObjects.count, 0x90, 16, 0, 0xdc, 0xdd);
+    for (NSData *encodedObject in encodedObjects) {
+        JRPCJSONWriterAppendBytes(&writer, encodedObject.bytes, encodedObject.length);
+    }
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+@end
@@ -0,0 +1,134 @@
+//
+//  JRPCMetrics.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+
+@class JRPCAbstractProxy;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The phases of a call to a proxied method, timed when metrics are enabled. See metricsEnabled in JRPCAbstractProxy
+ */
+typedef NS_ENUM(NSInteger, JRPCMetricsPhase) {
+    /** Reading the param values from the invocation into a JSON-RPC request object. JSON requests are written straight from the invocation, which is timed as serialization */
+    JRPCMetricsPhaseMarshalling = 0,
+    /** Encoding the request with the proxy's codec. Not timed when the transport performs serialization */
+    JRPCMetricsPhaseSerialization,
+    /** From passing the request (or batch) to the transport until the transport calls back with the response */
+    JRPCMetricsPhaseTransport,
+    /** Decoding the response (or batch of responses). Not timed when the transport performs serialization */
+    JRPCMetricsPhaseDeserialization,
+    /** Waiting for rpcCompletionQueue to run the completion block. Not timed when completion blocks are called inline */
+    JRPCMetricsPhaseCompletionQueue
+};
+
+/** The number of JRPCMetricsPhase values */
+#define JRPC_METRICS_PHASE_COUNT 5
+
+/**
+ JRPCHistogramSnapshot is the distribution of durations recorded by a latency histogram at one moment. Snapshots are immutable
+ @discussion Durations are counted in buckets no wider than 1/16 of the durations in them, as HdrHistogram does, so percentiles are within ~6%.
+ Durations over 2^40 nanoseconds (~18 minutes) are counted as 2^40 nanoseconds
+ */
+@interface JRPCHistogramSnapshot : NSObject
+
+/** The number of durations recorded */
+@property (nonatomic, readonly) uint64_t count;
+
+/** The shortest duration recorded, in seconds, or 0 if none were */
+@property (nonatomic, readonly) NSTimeInterval minimum;
+
+/** The longest duration recorded, in seconds, or 0 if none were */
+@property (nonatomic, readonly) NSTimeInterval maximum;
+
+/** The mean of the durations recorded, in seconds, or 0 if none were */
+@property (nonatomic, readonly) NSTimeInterval mean;
+
+/**
+ Returns the duration that the given percentage of durations recorded are shorter than or equal to
+ @param percentile The percentage, from 0 to 100, e.g. 99 for the 99th percentile
+ @return The duration in seconds, or 0 if none were recorded
+ */
+- (NSTimeInterval) valueAtPercentile:(double)percentile;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/**
+ JRPCMetricsSnapshot holds the metrics of a JRPCAbstractProxy at one moment, since they were enabled or last reset. Snapshots are immutable
+ @discussion Metrics are recorded without locks, so a snapshot taken while calls are in progress may include part of a call's metrics
+ */
+@interface JRPCMetricsSnapshot : NSObject
+
+/** The latency of each method's calls, from the call until just before its completion block is called, keyed by JSON-RPC method name */
+@property (nonatomic, readonly) NSDictionary<NSString*, JRPCHistogramSnapshot*> *methodLatencies;
+
+/** The number of calls completed with each error code of JRPCErrorDomain, keyed by code. Codes no call completed with are omitted */
+@property (nonatomic, readonly) NSDictionary<NSNumber*, NSNumber*> *errorCounts;
+
+/** The bytes of encoded requests, batches & notifications passed to the transport. Not counted when the transport performs serialization */
+@property (nonatomic, readonly) uint64_t bytesSent;
+
+/** The bytes of encoded responses passed back by the transport. Not counted when the transport performs serialization */
+@property (nonatomic, readonly) uint64_t bytesReceived;
+
+/** Calls made and not yet completed. Counted from when metrics were enabled, and not reset */
+@property (nonatomic, readonly) NSUInteger callsInFlight;
+
+/**
+ Returns the time calls spent in a phase, across all methods
+ @param phase The phase of a call
+ @return The durations of the phase. Phases of a batch are recorded once for the whole batch
+ */
+- (JRPCHistogramSnapshot*) latencyForPhase:(JRPCMetricsPhase)phase;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/**
+ JRPCMetricsDelegate is told the metrics of a proxy periodically. See metricsDelegate in JRPCAbstractProxy
+ */
+@protocol JRPCMetricsDelegate <NSObject>
+
+/**
+ Called every metricsReportInterval while metrics are enabled, on the proxy's rpcCompletionQueue
+ @param proxy The proxy whose metrics these are
+ @param metrics The proxy's metrics since they were enabled or last reset
+ */
+- (void) proxy:(JRPCAbstractProxy*)proxy didReportMetrics:(JRPCMetricsSnapshot*)metrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+//
+//  JRPCModel.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCTransformable.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCModelMapping marks a class whose instances JRPCModelMapper maps to & from JSON objects by their properties, instead of hand-written
+ JRPCTransformable methods. Each JSON member sets the property of the same name: primitives from numbers, strings, numbers, arrays & dictionaries
+ as they are, nested models from objects, and other JRPCTransformable classes with initWithJSONRPCResponseResult:. null is nil or 0.
+ Properties may be readonly, and are set directly. Nested models are created with init. Both methods are optional
+ */
+@protocol JRPCModelMapping <NSObject>
+
+@optional
+
+/**
+ The JSON keys of properties whose key is not their name
+ @return Property name => JSON member name, e.g. @{ @"identifier" : @"id" }
+ */
++ (NSDictionary<NSString*, NSString*>*) jsonRPCKeysByPropertyName;
+
+/**
+ The class of the elements of array properties, which the property type cannot say. Arrays of models or other JRPCTransformable classes are
+ mapped element by element, and arrays of other classes checked. Array properties not listed are passed as they are
+ @return Property name => element class, e.g. @{ @"episodes" : [Episode class] }
+ */
++ (NSDictionary<NSString*, Class>*) jsonRPCElementClassesByPropertyName;
+
+@end
+
+/**
+ JRPCModelMapper maps model objects (see JRPCModelMapping) to & from JSON objects. The properties of each model class are introspected once,
+ the first time it is mapped, into a plan of keys, instance variable offsets & conversions that every later mapping follows, without key-value
+ coding or parsing type encodings. Safe to use from any thread
+ */
+@interface JRPCModelMapper : NSObject
+
+/**
+ Creates a model from a JSON object
+ @param modelClass A class conforming to JRPCModelMapping. Raises NSInvalidArgumentException for any other class
+ @param jsonObject The JSON object, e.g. a JSON-RPC result
+ @return The model, or nil if jsonObject is not a dictionary or one of its members cannot be converted to its property's type
+ */
++ (nullable id) modelOfClass:(Class)modelClass withJSONObject:(id)jsonObject;
+
+/**
+ Creates models from an array of JSON objects, e.g. a JSON-RPC result listing them
+ @param modelClass A class conforming to JRPCModelMapping. Raises NSInvalidArgumentException for any other class
+ @param jsonArray The array of JSON objects
+ @return The models, or nil if jsonArray is not an array or any of its elements cannot be mapped
+ */
++ (nullable NSArray*) modelsOfClass:(Class)modelClass withJSONArray:(id)jsonArray;
+
+/**
+ Sets the properties of an existing model from a JSON object, e.g. in an initWithJSONRPCResponseResult: of its own
+ @param model An instance of a class conforming to JRPCModelMapping. Raises NSInvalidArgumentException for any other object
+ @param jsonObject The JSON object
+ @return NO if jsonObject is not a dictionary or one of its members cannot be converted. Properties set before the failure keep their value
+ */
++ (BOOL) fillModel:(id)model withJSONObject:(id)jsonObject;
+
+/**
+ Returns the JSON object representation of a model, for its jsonRPCRequestRepresentation
+ @param model An instance of a class conforming to JRPCModelMapping. Raises NSInvalidArgumentException for any other object
+ @return A dictionary of the model's properties by JSON key. Properties that are nil are omitted
+ */
++ (NSDictionary<NSString*, id>*) JSONObjectWithModel:(id)model;
+
+@end
+
+/**
+ JRPCModel is a convenient base class for models, implementing JRPCTransformable with JRPCModelMapper. Subclasses need only declare their properties
+ e.g. @interface Episode : JRPCModel
+      @property (nonatomic, copy) NSString *title;
+      @property (nonatomic, assign) NSInteger duration;
+      @end
+ */
+@interface JRPCModel : NSObject <JRPCModelMapping, JRPCTransformable>
+
+/** Initializes the model's properties from a JSON object. Returns nil if it cannot be mapped (see modelOfClass:withJSONObject:) */
+- (nullable instancetype) initWithJSONRPCResponseResult:(id)result;
+
+/** The model's properties as a JSON object (see JSONObjectWithModel:) */
+- (id) jsonRPCRequestRepresentation;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,81 @@
+//
+//  JRPCModel.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCModel.h"
+#import "JRPCModelPlan.h"
+
+@implementation JRPCModelMapper
+
++ (id) modelOfClass:(Class)modelClass withJSONObject:(id)jsonObject {
+    return [[JRPCModelPlan planForClass:modelClass] newModelWithJSONObject:jsonObject];
+}
+
++ (NSArray*) modelsOfClass:(Class)modelClass withJSONArray:(id)jsonArray {
+    JRPCModelPlan *plan = [JRPCModelPlan planForClass:modelClass];
+    if (![jsonArray isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    NSMutableArray *models = [[NSMutableArray alloc] initWithCapacity:[jsonArray count]];
+    for (id jsonObject in (NSArray*)jsonArray) {
+        id model = [plan newModelWithJSONObject:jsonObject];
+        if (!model) {
+            return nil;
+        }
+        [models addObject:model];
+    }
+    return [models copy];
+}
+
++ (BOOL) fillModel:(id)model withJSONObject:(id)jsonObject {
+    JRPCModelPlan *plan = [JRPCModelPlan planForClass:[model class]];
+    return [jsonObject isKindOfClass:[NSDictionary class]] && [plan fillModel:model withJSONObject:jsonObject];
+}
+
++ (NSDictionary*) JSONObjectWithModel:(id)model {
+    return [[JRPCModelPlan planForClass:[model class]] JSONObjectWithModel:model];
+}
+
+@end
+
+@implementation JRPCModel
+
+- (instancetype) initWithJSONRPCResponseResult:(id)result {
+    self = [super init];
+    if (self && ![JRPCModelMapper fillModel:self withJSONObject:result]) {
+        self = nil; // Failed initialization
+    }
+    return self;
+}
+
+- (id) jsonRPCRequestRepresentation {
+    return [JRPCModelMapper JSONObjectWithModel:self];
+}
+
+@end
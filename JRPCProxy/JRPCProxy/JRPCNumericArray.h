@@ -0,0 +1,106 @@
+//
+//  JRPCNumericArray.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCTransformable.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCNumericArray is an immutable array of C numbers packed into a single buffer, for passing large numeric vectors as params & results without an NSNumber per element
+ Use one of the concrete subclasses (JRPCInt16Array, JRPCInt32Array, JRPCInt64Array, JRPCFloatArray, JRPCDoubleArray) as the param or result type of a proxied method.
+ In JSON it is an array of numbers. When the proxy performs serialization, a param is written straight from the buffer and a result read straight into one,
+ so a result of any length makes a single allocation for its elements.
+ @discussion Transports that perform serialization, and codecs other than JSON, get and return an NSArray of NSNumber instead (see JRPCTransformable).
+ Elements must be finite, since JSON has no NaN or infinity. Array results whose elements are out of range for the type are converted as C casts do
+ */
+@interface JRPCNumericArray : NSObject <NSCopying, JRPCTransformable>
+
+/** The Objective-C type encoding of the elements, as for NSValue */
+@property (class, nonatomic, readonly) const char *objCType;
+
+/**
+ Initializes an array with the elements in some data
+ @param data The elements, packed in native byte order. Its length must be a multiple of the element size, otherwise NSInvalidArgumentException is raised
+ @return An initialized array. Raises NSInvalidArgumentException if called on JRPCNumericArray itself rather than a subclass
+ */
+- (instancetype) initWithData:(NSData*)data NS_DESIGNATED_INITIALIZER;
+
+/** The number of elements */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** The elements, packed in native byte order */
+@property (nonatomic, readonly, copy) NSData *data;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/** An array of int16_t, e.g. audio samples */
+@interface JRPCInt16Array : JRPCNumericArray
+/** Creates an array by copying count values */
++ (instancetype) arrayWithValues:(const int16_t*)values count:(NSUInteger)count;
+/** The elements */
+@property (nonatomic, readonly) const int16_t *values NS_RETURNS_INNER_POINTER;
+@end
+
+/** An array of int32_t */
+@interface JRPCInt32Array : JRPCNumericArray
+/** Creates an array by copying count values */
++ (instancetype) arrayWithValues:(const int32_t*)values count:(NSUInteger)count;
+/** The elements */
+@property (nonatomic, readonly) const int32_t *values NS_RETURNS_INNER_POINTER;
+@end
+
+/** An array of int64_t, e.g. timestamps */
+@interface JRPCInt64Array : JRPCNumericArray
+/** Creates an array by copying count values */
++ (instancetype) arrayWithValues:(const int64_t*)values count:(NSUInteger)count;
+/** The elements */
+@property (nonatomic, readonly) const int64_t *values NS_RETURNS_INNER_POINTER;
+@end
+
+/** An array of float. Elements are written with the fewest digits that read back as the same float */
+@interface JRPCFloatArray : JRPCNumericArray
+/** Creates an array by copying count values */
++ (instancetype) arrayWithValues:(const float*)values count:(NSUInteger)count;
+/** The elements */
+@property (nonatomic, readonly) const float *values NS_RETURNS_INNER_POINTER;
+@end
+
+/** An array of double */
+@interface JRPCDoubleArray : JRPCNumericArray
+/** Creates an array by copying count values */
++ (instancetype) arrayWithValues:(const double*)values count:(NSUInteger)count;
+/** The elements */
+@property (nonatomic, readonly) const double *values NS_RETURNS_INNER_POINTER;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,177 @@
+//
+//  JRPCNumericArray.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCNumericArray.h"
+#import "JRPCJSONReader.h"
+
+// The size of an element of the given type encoding, or 0 if it is not a supported element type
+static size_t JRPCNumericArrayElementSize(const char *objCType) {
+    switch (objCType[0]) {
+        case 's': return sizeof(int16_t);
+        case 'i': return sizeof(int32_t);
+        case 'q': return sizeof(int64_t);
+        case 'f': return sizeof(float);
+        case 'd': return sizeof(double);
+        default: return 0;
+    }
+}
+
+@interface JRPCNumericArray()
+@property (nonatomic, copy) NSData *data;
+// The elements, for the typed accessors of the subclasses
+@property (nonatomic, readonly) const void *bytes NS_RETURNS_INNER_POINTER;
+- (instancetype) initWithValues:(const void*)values count:(NSUInteger)count;
+@end
+
+@implementation JRPCNumericArray
+
++ (const char *) objCType {
+    // Only the subclasses have elements
+    return "";
+}
+
+- (instancetype) initWithData:(NSData*)data {
+    size_t elementSize = JRPCNumericArrayElementSize([[self class] objCType]);
+    if (0 == elementSize) {
+        [NSException raise:NSInvalidArgumentException format:@"%@ is abstract, use one of its subclasses", NSStringFromClass([JRPCNumericArray class])];
+        return nil;
+    }
+    if (0 != data.length % elementSize) {
+        [NSException raise:NSInvalidArgumentException format:@"data length %lu is not a multiple of the element size %zu", (unsigned long)data.length, elementSize];
+        return nil;
+    }
+    self = [super init];
+    if (self) {
+        self.data = data;
+    }
+    return self;
+}
+
+- (instancetype) initWithValues:(const void*)values count:(NSUInteger)count {
+    return [self initWithData:[NSData dataWithBytes:values length:count * JRPCNumericArrayElementSize([[self class] objCType])]];
+}
+
+- (NSUInteger) count {
+    return self.data.length / JRPCNumericArrayElementSize([[self class] objCType]);
+}
+
+- (const void *) bytes {
+    return self.data.bytes;
+}
+
+#pragma mark - NSObject
+
+- (BOOL) isEqual:(id)object {
+    if (self == object) {
+        return YES;
+    }
+    return [object isMemberOfClass:[self class]] && [self.data isEqualToData:((JRPCNumericArray*)object).data];
+}
+
+- (NSUInteger) hash {
+    return self.data.hash;
+}
+
+- (NSString*) description {
+    return [NSString stringWithFormat:@"<%@: %p, count = %lu>", NSStringFromClass([self class]), self, (unsigned long)self.count];
+}
+
+#pragma mark - NSCopying
+
+- (id) copyWithZone:(NSZone*)zone {
+    // Immutable
+    return self;
+}
+
+#pragma mark - JRPCTransformable
+
+- (id) initWithJSONRPCResponseResult:(id)result {
+    if (![result isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    NSArray *elements = (NSArray*)result;
+    const char *objCType = [[self class] objCType];
+    size_t elementSize = JRPCNumericArrayElementSize(objCType);
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:elements.count * elementSize];
+    uint8_t *bytes = data.mutableBytes;
+    for (NSUInteger i = 0; i < elements.count; ++i) {
+        NSNumber *element = elements[i];
+        // Including numbers the element type cannot hold, e.g. 1e10 for an int16_t
+        if (![element isKindOfClass:[NSNumber class]] || !JRPCJSONNumberFitsType(element, objCType[0])) {
+            return nil;
+        }
+        switch (objCType[0]) {
+            case 's': ((int16_t*)bytes)[i] = element.shortValue; break;
+            case 'i': ((int32_t*)bytes)[i] = element.intValue; break;
+            case 'q': ((int64_t*)bytes)[i] = element.longLongValue; break;
+            case 'f': ((float*)bytes)[i] = element.floatValue; break;
+            case 'd': ((double*)bytes)[i] = element.doubleValue; break;
+        }
+    }
+    return [self initWithData:data];
+}
+
+- (id) jsonRPCRequestRepresentation {
+    // Only used where the request is not written by the proxy's JSON writer, which writes the elements straight from the buffer
+    const char *objCType = [[self class] objCType];
+    const void *bytes = self.data.bytes;
+    NSUInteger count = self.count;
+    NSMutableArray<NSNumber*> *elements = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        switch (objCType[0]) {
+            case 's': [elements addObject:@(((const int16_t*)bytes)[i])]; break;
+            case 'i': [elements addObject:@(((const int32_t*)bytes)[i])]; break;
+            case 'q': [elements addObject:@(((const int64_t*)bytes)[i])]; break;
+            case 'f': [elements addObject:@(((const float*)bytes)[i])]; break;
+            case 'd': [elements addObject:@(((const double*)bytes)[i])]; break;
+        }
+    }
+    return [elements copy];
+}
+
+@end
+
+#define JRPC_NUMERIC_ARRAY_IMPLEMENTATION(className, type) \
+@implementation className \
++ (const char *) objCType { \
+    return @encode(type); \
+} \
++ (instancetype) arrayWithValues:(const type*)values count:(NSUInteger)count { \
+    return [[self alloc] initWithValues:values count:count]; \
+} \
+- (const type *) values { \
+    return (const type *)self.bytes; \
+} \
+@end
+
+JRPC_NUMERIC_ARRAY_IMPLEMENTATION(JRPCInt16Array, int16_t)
+JRPC_NUMERIC_ARRAY_IMPLEMENTATION(JRPCInt32Array, int32_t)
+JRPC_NUMERIC_ARRAY_IMPLEMENTATION(JRPCInt64Array, int64_t)
+JRPC_NUMERIC_ARRAY_IMPLEMENTATION(JRPCFloatArray, float)
+JRPC_NUMERIC_ARRAY_IMPLEMENTATION(JRPCDoubleArray, double)
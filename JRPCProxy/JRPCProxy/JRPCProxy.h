@@ -42,4 +42,22 @@ FOUNDATION_EXPORT const unsigned char JRPCProxyVersionString[];
 #import <JRPCProxy/JRPCTransformable.h>
 #import <JRPCProxy/NSDictionary+JSONRPC.h>
 #import <JRPCProxy/JRPCError.h>
-
+#import <JRPCProxy/JRPCStreamTransport.h>
+#import <JRPCProxy/JRPCCachePolicy.h>
+#import <JRPCProxy/JRPCCall.h>
+#import <JRPCProxy/JRPCScheduling.h>
+#import <JRPCProxy/JRPCCodec.h>
+#import <JRPCProxy/JRPCJSONCodec.h>
+#import <JRPCProxy/JRPCMessagePackCodec.h>
+#import <JRPCProxy/JRPCNumericArray.h>
+#import <JRPCProxy/JRPCDispatcher.h>
+#import <JRPCProxy/JRPCModel.h>
+#import <JRPCProxy/JRPCTransportPool.h>
+#import <JRPCProxy/JRPCMetrics.h>
+#import <JRPCProxy/JRPCTracer.h>
+#import <JRPCProxy/JRPCTrafficRecording.h>
+#import <JRPCProxy/JRPCRecordingTransport.h>
+#import <JRPCProxy/JRPCReplayTransport.h>
+#import <JRPCProxy/JRPCReplayDriver.h>
+#import <JRPCProxy/JRPCSharedMemoryTransport.h>
+#import <JRPCProxy/JRPCSharedMemoryEndpoint.h>
@@ -39,6 +39,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 typedef void (^JRPCTransportDataCompletion)(NSData * __nullable data , NSError * __nullable error);
 
+/**
+ JRPCTransportDispatchDataCompletion defines the block to be called on completion of async JSON-RPC requests by JRPCProxyTransport
+ This block defintion is used when the transport passes the raw data of the response in the regions it was received in, e.g. one per read from a socket
+ @param data If the request succeeded contains the raw data from the response payload in any number of regions, otherwise nil if the request failed
+ @param error if the request failed, contains an NSError describing the failure, otherwise nil if the request succeeded
+ */
+typedef void (^JRPCTransportDispatchDataCompletion)(dispatch_data_t __nullable data , NSError * __nullable error);
+
 /**
  JRPCTransportObjectCompletion defines the block to be called on completion of async JSON-RPC requests by JRPCProxyTransport
  This block defintion is used when the transport wishes to perform JSON serializtion itself and pass the resulting JSON object
@@ -47,6 +55,15 @@ typedef void (^JRPCTransportDataCompletion)(NSData * __nullable data , NSError *
  */
 typedef void (^JRPCTransportObjectCompletion)(NSDictionary * __nullable jsonResponse , NSError * __nullable error);
 
+/**
+ JRPCTransportBatchObjectCompletion defines the block to be called on completion of async JSON-RPC batch requests by JRPCProxyTransport
+ This block defintion is used when the transport wishes to perform JSON serializtion itself and pass the resulting JSON objects
+ @param jsonResponses If the request succeeded contains the deserialized JSON response objects in any order, otherwise nil if the request failed.
+ If the server could not process the batch at all, it will contain the single error response object returned by the server
+ @param error if the request failed, contains an NSError describing the failure, otherwise nil if the request succeeded
+ */
+typedef void (^JRPCTransportBatchObjectCompletion)(NSArray<NSDictionary*> * __nullable jsonResponses , NSError * __nullable error);
+
 /**
  JRPCProxyTransport is used by JRPCAbstractProxy to abstract away the actual mechanism used to make the request and receive the response.
  @discussion The transport is expected to implement ONE of these methods only, depending on whether it wishes to perform the JSON<->NSData serialiazation itself, or leave it up to the proxy. e.g.
@@ -54,6 +71,15 @@ typedef void (^JRPCTransportObjectCompletion)(NSDictionary * __nullable jsonResp
  Alternativeley, for a WebSocket, you may prefer to perform the serialization in the transport in order to match the id between request & response objects
  If NEITHER method is implemented an exception will occur.
  If BOTH methods are implemented, the proxy will prefer to delegate serialization duties to the transport
+ The transport may also implement the batch method matching its serialization strategy to support JSON-RPC batch requests (see batchWindow in JRPCAbstractProxy.h)
+ The transport may also implement the notification method matching its serialization strategy to send JSON-RPC notifications without waiting for a reply.
+ Otherwise notifications are sent with the request method, and whatever the transport returns is ignored
+ The transport may also implement cancelJSONRPCRequestWithId: to drop requests the proxy has stopped waiting for
+ A transport using raw data may also implement supportedCodecNames to carry requests & responses in an encoding other than JSON (see JRPCCodec)
+ A transport performing serialization is passed NSData params as they are. It chooses its own encoding, so should fail requests with values it cannot carry
+ A transport using raw data may implement the dispatch data methods in place of, or as well as, the NSData methods, and the proxy then prefers them.
+ Requests are passed in the regions they were encoded in, so a large request is never copied into one buffer, and may be written with a single writev().
+ Responses may be returned in the regions they were received in, and are parsed across them without being joined first
  */
 @protocol JRPCProxyTransport <NSObject>
 @optional
@@ -77,6 +103,91 @@ typedef void (^JRPCTransportObjectCompletion)(NSDictionary * __nullable jsonResp
                            completionQueue:(dispatch_queue_t __nullable)completionQueue
                                 completion:(JRPCTransportDataCompletion)completion;
 
+/**
+ Asyncronously sends the JSON-RPC request payload serialized data, and returns the raw data result, as dispatch data
+ Preferred to sendJSONRPCPayloadWithRequestData:completionQueue:completion: if both are implemented, and not used if the transport performs serialization
+ @param payload The serialized data for the JSON-RPC request object, in any number of regions
+ @param completionQueue A dispatch queue that will be used to call the completion block. Should accept nil for use of dispatch_get_main_queue()
+ @param completion A block that will be called with the result of the JSON-RPC request
+ */
+- (void) sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                   completionQueue:(dispatch_queue_t __nullable)completionQueue
+                                        completion:(JRPCTransportDispatchDataCompletion)completion;
+
+/**
+ Asyncronously sends a JSON-RPC batch request and returns the response objects
+ Only used if the transport also implements sendJSONRPCPayloadWithRequestObject:completionQueue:completion:
+ @param jsonRPCRequests The JSON-RPC request objects in the batch
+ @param completionQueue A dispatch queue that will be used to call the completion block. Should accept nil for use of dispatch_get_main_queue()
+ @param completion A block that will be called with the response objects of the JSON-RPC batch request
+ */
+- (void) sendJSONRPCBatchPayloadWithRequestObjects:(NSArray<NSDictionary*>*)jsonRPCRequests
+                                   completionQueue:(dispatch_queue_t __nullable)completionQueue
+                                        completion:(JRPCTransportBatchObjectCompletion)completion;
+
+/**
+ Asyncronously sends the serialized data of a JSON-RPC batch request and returns the raw data result
+ Only used if the transport implements sendJSONRPCPayloadWithRequestData:completionQueue:completion: and not sendJSONRPCPayloadWithRequestObject:completionQueue:completion: or sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion:
+ @param payload The serialized JSON data for the JSON-RPC batch request, an array of request objects
+ @param completionQueue A dispatch queue that will be used to call the completion block. Should accept nil for use of dispatch_get_main_queue()
+ @param completion A block that will be called with the raw data of the JSON-RPC batch response
+ */
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t __nullable)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion;
+
+/**
+ Asyncronously sends the serialized data of a JSON-RPC batch request, and returns the raw data result, as dispatch data
+ Only used if the transport implements sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion: and not sendJSONRPCPayloadWithRequestObject:completionQueue:completion:
+ @param payload The serialized data for the JSON-RPC batch request, an array of request objects, in any number of regions
+ @param completionQueue A dispatch queue that will be used to call the completion block. Should accept nil for use of dispatch_get_main_queue()
+ @param completion A block that will be called with the raw data of the JSON-RPC batch response
+ */
+- (void) sendJSONRPCBatchPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                        completionQueue:(dispatch_queue_t __nullable)completionQueue
+                                             completion:(JRPCTransportDispatchDataCompletion)completion;
+
+/**
+ Sends a JSON-RPC notification object. The server does not reply to notifications, so there is no completion
+ Only used if the transport also implements sendJSONRPCPayloadWithRequestObject:completionQueue:completion:
+ @param jsonRPCNotification The JSON-RPC notification object, a request object without an id
+ */
+- (void) sendJSONRPCNotificationWithRequestObject:(NSDictionary*)jsonRPCNotification;
+
+/**
+ Sends the serialized data of a JSON-RPC notification. The server does not reply to notifications, so there is no completion
+ Only used if the transport implements sendJSONRPCPayloadWithRequestData:completionQueue:completion: and not sendJSONRPCPayloadWithRequestObject:completionQueue:completion: or sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion:
+ @param payload The serialized JSON data for the JSON-RPC notification object, a request object without an id
+ */
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload;
+
+/**
+ Sends the serialized data of a JSON-RPC notification, as dispatch data. The server does not reply to notifications, so there is no completion
+ Only used if the transport implements sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion: and not sendJSONRPCPayloadWithRequestObject:completionQueue:completion:
+ @param payload The serialized data for the JSON-RPC notification object, in any number of regions
+ */
+- (void) sendJSONRPCNotificationWithRequestDispatchData:(dispatch_data_t)payload;
+
+/**
+ Called when the proxy stops waiting for the response to a request because it timed out or was cancelled, so the transport can drop any work for it
+ The transport need not call the request's completion block afterwards, and the proxy ignores it if it does. The calls in a batch request are cancelled individually
+ @param requestId The id of the JSON-RPC request
+ */
+- (void) cancelJSONRPCRequestWithId:(id)requestId;
+
+/**
+ The names of the codecs the transport can carry requests & responses in, e.g. @[ JRPCCodecNameMessagePack, JRPCCodecNameJSON ]. See codecs in JRPCAbstractProxy.h
+ Only used if the transport implements sendJSONRPCPayloadWithRequestData:completionQueue:completion: (or its dispatch data counterpart) and not sendJSONRPCPayloadWithRequestObject:completionQueue:completion:
+ If not implemented, the transport only carries JSON
+ */
+@property (nonatomic, readonly, copy) NSArray<NSString*> *supportedCodecNames;
+
+/**
+ Called when the proxy chooses the codec it encodes requests with and expects responses in, before it sends any requests with it
+ @param name The name of the codec, one of supportedCodecNames
+ */
+- (void) useCodecWithName:(NSString*)name;
+
 @end
 
 NS_ASSUME_NONNULL_END
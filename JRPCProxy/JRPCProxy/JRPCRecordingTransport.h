@@ -0,0 +1,87 @@
+//
+//  JRPCRecordingTransport.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCProxyTransport.h"
+#import "JRPCCodec.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCRecordingTransport is a JRPCProxyTransport that passes requests to another transport unchanged, and records each request with its response,
+ when it was sent & how long the response took, to a file that JRPCTrafficRecording reads, e.g. to replay with JRPCReplayTransport
+ @discussion The transport implements exactly the methods of the transport it wraps, so the proxy calls it just as it would that transport.
+ Responses are passed on before they are recorded, and records are encoded & written on a serial queue, so recording adds little to each call.
+ Requests & responses are recorded as JSON text whatever codec carries them, so a recording may be replayed with any codec: when the
+ transport accepts raw data in another codec, each payload is decoded with it and encoded as JSON, and a payload holding a value JSON cannot
+ carry, e.g. NSData, is not recorded. All methods are thread safe
+ */
+@interface JRPCRecordingTransport : NSObject <JRPCProxyTransport>
+
+/**
+ Factory method to create a recording transport. Creates the file, or truncates it if it exists
+ @param transport The transport requests are sent with
+ @param url The URL of the file to record to
+ @param error On return, the reason the file could not be created
+ @return An initialized transport, or nil on error
+ */
++ (nullable instancetype) transportWithTransport:(id<JRPCProxyTransport>)transport
+                                  recordingToURL:(NSURL*)url
+                                           error:(NSError * _Nullable * _Nullable)error;
+
+/** The transport requests are sent with */
+@property (nonatomic, readonly) id<JRPCProxyTransport> transport;
+
+/** The URL of the file being recorded to */
+@property (nonatomic, readonly) NSURL *URL;
+
+/**
+ The codecs the transport can read payloads in, when the wrapped transport accepts raw data. Defaults to a JRPCJSONCodec and a JRPCMessagePackCodec
+ The transport's supportedCodecNames are those of these codecs that the wrapped transport supports
+ */
+@property (atomic, copy) NSArray<id<JRPCCodec>> *codecs;
+
+/** If NO, requests are passed on without being recorded. Defaults to YES */
+@property (atomic, assign, getter=isRecording) BOOL recording;
+
+/** The number of records written so far */
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+/** Waits until every record queued so far has been written, and flushes the file */
+- (void) synchronize;
+
+/** Flushes & closes the file. Requests are passed on but no longer recorded. Called on dealloc */
+- (void) close;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,326 @@
+//
+//  JRPCRecordingTransport.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCRecordingTransport.h"
+#import "JRPCTrafficRecording.h"
+#import "JRPCTrafficRecordFormat.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+#import <objc/runtime.h>
+#import <mach/mach_time.h>
+#import <stdio.h>
+
+static const char *JSON_RPC_RECORDING_QUEUE_NAME = "JRPCRecordingTransportQueue";
+
+@interface JRPCRecordingTransport() {
+    // Only touched on queue, other than by dealloc
+    FILE *_file;
+    mach_timebase_info_data_t _timebase;
+    uint64_t _startTime;
+}
+@property (nonatomic, strong) id<JRPCProxyTransport> transport;
+@property (nonatomic, strong) NSURL *URL;
+@property (nonatomic, strong) JRPCJSONCodec *jsonCodec;
+@property (atomic, strong) id<JRPCCodec> usedCodec;
+@property (atomic, assign) NSUInteger recordCount;
+@property (atomic, assign) BOOL closed;
+// Records are written in turn on this queue
+@property (nonatomic, strong) dispatch_queue_t queue;
+@end
+
+@implementation JRPCRecordingTransport
+
++ (instancetype) transportWithTransport:(id<JRPCProxyTransport>)transport recordingToURL:(NSURL*)url error:(NSError**)error {
+    FILE *file = fopen(url.fileSystemRepresentation, "wb");
+    if (!file) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSURLErrorKey : url }];
+        }
+        return nil;
+    }
+    return [[self alloc] initWithTransport:transport url:url file:file];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithTransport:(id<JRPCProxyTransport>)transport url:(NSURL*)url file:(FILE*)file {
+    self = [super init];
+    if (self) {
+        self.transport = transport;
+        self.URL = url;
+        self.jsonCodec = [[JRPCJSONCodec alloc] init];
+        self.codecs = @[ self.jsonCodec, [[JRPCMessagePackCodec alloc] init] ];
+        self.usedCodec = self.jsonCodec;
+        self.recording = YES;
+        self.queue = dispatch_queue_create(JSON_RPC_RECORDING_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+        mach_timebase_info(&_timebase);
+        _startTime = mach_absolute_time();
+        _file = file;
+        uint8_t header[JRPC_TRAFFIC_FILE_HEADER_LENGTH];
+        uint64_t startDate = CFSwapInt64HostToLittle((uint64_t)([[NSDate date] timeIntervalSince1970] * NSEC_PER_SEC));
+        memcpy(header, JRPC_TRAFFIC_FILE_MAGIC, JRPC_TRAFFIC_FILE_MAGIC_LENGTH);
+        memcpy(header + JRPC_TRAFFIC_FILE_MAGIC_LENGTH, &startDate, 8);
+        fwrite(header, 1, JRPC_TRAFFIC_FILE_HEADER_LENGTH, _file);
+    }
+    return self;
+}
+
+- (void) dealloc {
+    // Every queued record retains self, so there are none left to write
+    if (_file) {
+        fclose(_file);
+    }
+}
+
+- (BOOL) respondsToSelector:(SEL)aSelector {
+    // The proxy chooses how to call the transport by the methods it responds to, so only claim those the wrapped transport implements.
+    // The codec in use is always wanted though, to read payloads with
+    if (sel_isEqual(aSelector, @selector(useCodecWithName:))) {
+        return YES;
+    }
+    if (protocol_getMethodDescription(@protocol(JRPCProxyTransport), aSelector, NO, YES).name) {
+        return [self.transport respondsToSelector:aSelector];
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+// Nanoseconds since recording started
+- (uint64_t) now {
+    return (mach_absolute_time() - _startTime) * _timebase.numer / _timebase.denom;
+}
+
+- (BOOL) isRecordingRequests {
+    return self.recording && !self.closed;
+}
+
+// Wraps the completion of a request so the request is recorded once its response has been passed on
+- (void (^)(id, NSError*)) completion:(void (^)(id, NSError*))completion recordingKind:(JRPCTrafficRecordKind)kind request:(id)request {
+    if (![self isRecordingRequests]) {
+        return completion;
+    }
+    uint64_t sentTime = [self now];
+    // Payloads are read with the codec they were encoded in, even if the proxy moves on to another before they are recorded
+    id<JRPCCodec> codec = self.usedCodec;
+    return ^(id response, NSError *error) {
+        uint64_t latency = [self now] - sentTime;
+        completion(response, error);
+        [self recordKind:kind request:request response:response error:error sentTime:sentTime latency:latency codec:codec];
+    };
+}
+
+- (void) recordNotification:(id)notification {
+    if ([self isRecordingRequests]) {
+        [self recordKind:JRPCTrafficRecordKindNotification request:notification response:nil error:nil sentTime:[self now] latency:0 codec:self.usedCodec];
+    }
+}
+
+// Returns the JSON text of a request or response object, or of an encoded one. nil if JSON cannot carry it
+- (NSData*) jsonDataWithPayload:(id)payload codec:(id<JRPCCodec>)codec {
+    // Dispatch data is an NSData too
+    if ([payload isKindOfClass:[NSData class]]) {
+        if ([codec.name isEqualToString:JRPCCodecNameJSON]) {
+            return payload;
+        }
+        payload = [codec decodeData:payload error:nil];
+        if (!payload) {
+            return nil;
+        }
+    }
+    return [self.jsonCodec encodeObject:payload error:nil];
+}
+
+- (void) recordKind:(JRPCTrafficRecordKind)kind
+            request:(id)request
+           response:(id)response
+              error:(NSError*)error
+           sentTime:(uint64_t)sentTime
+            latency:(uint64_t)latency
+              codec:(id<JRPCCodec>)codec {
+    dispatch_async(self.queue, ^{
+        if (!self->_file) {
+            return;
+        }
+        NSData *requestData = [self jsonDataWithPayload:request codec:codec];
+        NSData *responseData = nil;
+        if (error) {
+            responseData = [self.jsonCodec encodeObject:@{ kJRPCTrafficErrorDomainKey : error.domain,
+                                                           kJRPCTrafficErrorCodeKey : @(error.code),
+                                                           kJRPCTrafficErrorMessageKey : error.localizedDescription }
+                                                  error:nil];
+        } else if (response) {
+            responseData = [self jsonDataWithPayload:response codec:codec];
+            if (!responseData) {
+                return;
+            }
+        }
+        if (!requestData || requestData.length > UINT32_MAX || responseData.length > UINT32_MAX) {
+            return;
+        }
+        JRPCTrafficRecordHeader header = {
+            .length = (uint32_t)JRPCTrafficRecordLength(requestData.length, responseData.length),
+            .kind = kind,
+            .flags = error ? JRPC_TRAFFIC_RECORD_FLAG_FAILED : 0,
+            .sentTime = sentTime,
+            .latency = latency,
+            .requestLength = (uint32_t)requestData.length,
+            .responseLength = (uint32_t)responseData.length
+        };
+        [self writeRecordWithHeader:&header requestData:requestData responseData:responseData];
+        self.recordCount++;
+    });
+}
+
+// Called on queue
+- (void) writeRecordWithHeader:(const JRPCTrafficRecordHeader *)header requestData:(NSData*)requestData responseData:(NSData*)responseData {
+    static const uint8_t padding[JRPC_TRAFFIC_RECORD_ALIGNMENT] = { 0 };
+    uint8_t headerBytes[JRPC_TRAFFIC_RECORD_HEADER_LENGTH];
+    JRPCTrafficRecordHeaderWrite(header, headerBytes);
+    fwrite(headerBytes, 1, JRPC_TRAFFIC_RECORD_HEADER_LENGTH, _file);
+    // Written a region at a time, so dispatch data is not joined first
+    for (NSData *data in @[ requestData, responseData ? : [NSData data] ]) {
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+            fwrite(bytes, 1, byteRange.length, self->_file);
+        }];
+    }
+    fwrite(padding, 1, header->length - JRPC_TRAFFIC_RECORD_HEADER_LENGTH - header->requestLength - header->responseLength, _file);
+}
+
+#pragma mark - Public
+
+- (void) synchronize {
+    dispatch_sync(self.queue, ^{
+        if (self->_file) {
+            fflush(self->_file);
+        }
+    });
+}
+
+- (void) close {
+    self.closed = YES;
+    dispatch_sync(self.queue, ^{
+        if (self->_file) {
+            fclose(self->_file);
+            self->_file = NULL;
+        }
+    });
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestObject:(NSDictionary*)jsonRPCRequest
+                             completionQueue:(dispatch_queue_t)completionQueue
+                                  completion:(JRPCTransportObjectCompletion)completion {
+    [self.transport sendJSONRPCPayloadWithRequestObject:jsonRPCRequest
+                                        completionQueue:completionQueue
+                                             completion:[self completion:completion recordingKind:JRPCTrafficRecordKindRequest request:jsonRPCRequest]];
+}
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    [self.transport sendJSONRPCPayloadWithRequestData:payload
+                                      completionQueue:completionQueue
+                                           completion:[self completion:completion recordingKind:JRPCTrafficRecordKindRequest request:payload]];
+}
+
+- (void) sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportDispatchDataCompletion)completion {
+    [self.transport sendJSONRPCPayloadWithRequestDispatchData:payload
+                                              completionQueue:completionQueue
+                                                   completion:[self completion:completion recordingKind:JRPCTrafficRecordKindRequest request:payload]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestObjects:(NSArray<NSDictionary*>*)jsonRPCRequests
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportBatchObjectCompletion)completion {
+    [self.transport sendJSONRPCBatchPayloadWithRequestObjects:jsonRPCRequests
+                                              completionQueue:completionQueue
+                                                   completion:[self completion:completion recordingKind:JRPCTrafficRecordKindBatch request:jsonRPCRequests]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    [self.transport sendJSONRPCBatchPayloadWithRequestData:payload
+                                           completionQueue:completionQueue
+                                                completion:[self completion:completion recordingKind:JRPCTrafficRecordKindBatch request:payload]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                        completionQueue:(dispatch_queue_t)completionQueue
+                                             completion:(JRPCTransportDispatchDataCompletion)completion {
+    [self.transport sendJSONRPCBatchPayloadWithRequestDispatchData:payload
+                                                   completionQueue:completionQueue
+                                                        completion:[self completion:completion recordingKind:JRPCTrafficRecordKindBatch request:payload]];
+}
+
+- (void) sendJSONRPCNotificationWithRequestObject:(NSDictionary*)jsonRPCNotification {
+    [self.transport sendJSONRPCNotificationWithRequestObject:jsonRPCNotification];
+    [self recordNotification:jsonRPCNotification];
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    [self.transport sendJSONRPCNotificationWithRequestData:payload];
+    [self recordNotification:payload];
+}
+
+- (void) sendJSONRPCNotificationWithRequestDispatchData:(dispatch_data_t)payload {
+    [self.transport sendJSONRPCNotificationWithRequestDispatchData:payload];
+    [self recordNotification:payload];
+}
+
+- (void) cancelJSONRPCRequestWithId:(id)requestId {
+    [self.transport cancelJSONRPCRequestWithId:requestId];
+}
+
+- (NSArray<NSString*>*) supportedCodecNames {
+    NSArray<NSString*> *transportCodecNames = self.transport.supportedCodecNames;
+    NSMutableArray<NSString*> *names = [[NSMutableArray alloc] init];
+    for (id<JRPCCodec> codec in self.codecs) {
+        if ([transportCodecNames containsObject:codec.name]) {
+            [names addObject:codec.name];
+        }
+    }
+    return [names copy];
+}
+
+- (void) useCodecWithName:(NSString*)name {
+    for (id<JRPCCodec> codec in self.codecs) {
+        if ([codec.name isEqualToString:name]) {
+            self.usedCodec = codec;
+        }
+    }
+    if ([self.transport respondsToSelector:@selector(useCodecWithName:)]) {
+        [self.transport useCodecWithName:name];
+    }
+}
+
+@end
@@ -0,0 +1,90 @@
+//
+//  JRPCReplayDriver.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCAbstractProxy.h"
+#import "JRPCTrafficRecording.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The outcome of a replay by JRPCReplayDriver
+ */
+typedef struct JRPCReplayStatistics {
+    /** Requests made through the proxy, counting each call of a recorded batch */
+    NSUInteger callCount;
+    /** Notifications sent through the proxy */
+    NSUInteger notificationCount;
+    /** Requests that completed with an error, or whose recorded params did not match the protocol */
+    NSUInteger errorCount;
+    /** The time from the start of the replay until the last call completed, in seconds */
+    NSTimeInterval duration;
+    /** The largest time any call was made after it was due, in seconds, which shows whether the client kept up with the rate asked for */
+    NSTimeInterval maxLag;
+} JRPCReplayStatistics;
+
+/**
+ JRPCReplayDriver makes the calls in a JRPCTrafficRecording again through a proxy, in the order & at the times they were recorded, or faster,
+ e.g. to load test a client with the traffic of a real session, against a JRPCReplayTransport offline or a real server
+ @discussion Each recorded request is unmarshalled into an invocation of the protocol method it names, as JRPCDispatcher does, and the
+ invocation is forwarded to the proxy, so calls take the same path through the proxy as the application's: batching, scheduling, caching
+ and so on. The calls of a recorded batch are made singly, at the time the batch was sent, and are batched again by the proxy if it batches
+ */
+@interface JRPCReplayDriver : NSObject
+
+/**
+ Factory method to create a driver
+ @param recording The recording to replay
+ @param protocol The protocol the proxy implements
+ @param paramStructure The parameter structure of the proxy
+ @param proxy The proxy to make calls through
+ @return An initialized driver
+ @discussion Raises NSInvalidArgumentException if the protocol's methods do not follow the conventions described in JRPCAbstractProxy.h
+ */
++ (instancetype) driverWithRecording:(JRPCTrafficRecording*)recording
+                            protocol:(Protocol*)protocol
+                      paramStructure:(JRPCParameterStructure)paramStructure
+                               proxy:(JRPCAbstractProxy*)proxy;
+
+/** How much faster than recorded calls are made, e.g. 2 for twice the rate. 0 to make every call at once. Defaults to 1 */
+@property (atomic, assign) double speed;
+
+/**
+ Makes every recorded call, then calls a completion block once all have completed. Raises NSInternalInconsistencyException if a replay is already running
+ @param completionQueue The queue to call the completion block on, or nil for dispatch_get_main_queue()
+ @param completion Called with the statistics of the replay
+ */
+- (void) replayWithCompletionQueue:(nullable dispatch_queue_t)completionQueue completion:(void (^)(JRPCReplayStatistics statistics))completion;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,197 @@
+//
+//  JRPCReplayDriver.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCReplayDriver.h"
+#import "JRPCDispatcher.h"
+#import "NSDictionary+JSONRPC.h"
+
+static const char *JSON_RPC_REPLAY_QUEUE_NAME = "JRPCReplayDriverQueue";
+
+// Calls due within this time are made now rather than waited for, as a timer could not fire any closer to when they are due
+#define JRPC_REPLAY_SCHEDULING_SLACK 0.001
+
+/** A recorded call, and when it was made */
+@interface JRPCReplayCall : NSObject
+@property (nonatomic, assign) NSTimeInterval sentTime;
+@property (nonatomic, strong) NSDictionary *request;
+@end
+
+@implementation JRPCReplayCall
+@end
+
+@interface JRPCReplayDriver()
+@property (nonatomic, strong) JRPCTrafficRecording *recording;
+// Unmarshals recorded requests into invocations of the proxy
+@property (nonatomic, strong) JRPCDispatcher *dispatcher;
+// The state of a replay is only touched on this queue
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) NSArray<JRPCReplayCall*> *calls;
+@property (nonatomic, assign) NSUInteger nextCallIndex;
+@property (nonatomic, assign) NSUInteger outstandingCount;
+@property (nonatomic, assign) NSTimeInterval startTime;
+@property (nonatomic, assign) JRPCReplayStatistics statistics;
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, copy) void (^completion)(JRPCReplayStatistics statistics);
+@end
+
+@implementation JRPCReplayDriver
+
++ (instancetype) driverWithRecording:(JRPCTrafficRecording*)recording
+                            protocol:(Protocol*)protocol
+                      paramStructure:(JRPCParameterStructure)paramStructure
+                               proxy:(JRPCAbstractProxy*)proxy {
+    return [[self alloc] initWithRecording:recording protocol:protocol paramStructure:paramStructure proxy:proxy];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithRecording:(JRPCTrafficRecording*)recording
+                          protocol:(Protocol*)protocol
+                    paramStructure:(JRPCParameterStructure)paramStructure
+                             proxy:(JRPCAbstractProxy*)proxy {
+    self = [super init];
+    if (self) {
+        self.recording = recording;
+        self.dispatcher = [JRPCDispatcher dispatcherForProtocol:protocol paramStructure:paramStructure target:proxy];
+        self.queue = dispatch_queue_create(JSON_RPC_REPLAY_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+        self.speed = 1;
+    }
+    return self;
+}
+
+// Returns every recorded call in the order it was made, with the calls of a batch made singly
+- (NSArray<JRPCReplayCall*>*) recordedCalls {
+    NSMutableArray<JRPCReplayCall*> *calls = [[NSMutableArray alloc] initWithCapacity:self.recording.count];
+    [self.recording enumerateRecordsUsingBlock:^(JRPCTrafficRecord *record, NSUInteger index, BOOL *stop) {
+        id request = [NSJSONSerialization JSONObjectWithData:record.requestData options:0 error:nil];
+        for (NSDictionary *callRequest in ([request isKindOfClass:[NSArray class]] ? request : @[ request ? : [NSNull null] ])) {
+            JRPCReplayCall *call = [[JRPCReplayCall alloc] init];
+            call.sentTime = record.sentTime;
+            call.request = callRequest;
+            [calls addObject:call];
+        }
+    }];
+    [calls sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(JRPCReplayCall *lhs, JRPCReplayCall *rhs) {
+        return (lhs.sentTime < rhs.sentTime) ? NSOrderedAscending : ((lhs.sentTime > rhs.sentTime) ? NSOrderedDescending : NSOrderedSame);
+    }];
+    return calls;
+}
+
+// Makes every call that is due, then waits for the next. Called on queue
+- (void) makeDueCalls {
+    double speed = self.speed;
+    while (self.nextCallIndex < self.calls.count) {
+        JRPCReplayCall *call = self.calls[self.nextCallIndex];
+        NSTimeInterval dueTime = self.startTime + ((speed > 0) ? call.sentTime / speed : 0);
+        NSTimeInterval now = [NSProcessInfo processInfo].systemUptime;
+        if (dueTime > now + JRPC_REPLAY_SCHEDULING_SLACK) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((dueTime - now) * NSEC_PER_SEC)), self.queue, ^{
+                [self makeDueCalls];
+            });
+            return;
+        }
+        JRPCReplayStatistics statistics = self.statistics;
+        statistics.maxLag = MAX(statistics.maxLag, now - dueTime);
+        self.statistics = statistics;
+        self.nextCallIndex++;
+        [self makeCall:call];
+    }
+    [self completeIfDone];
+}
+
+// Called on queue
+- (void) makeCall:(JRPCReplayCall*)call {
+    BOOL isNotification = [call.request isKindOfClass:[NSDictionary class]] && !call.request.jsonRPC_requestId;
+    JRPCReplayStatistics statistics = self.statistics;
+    if (isNotification) {
+        statistics.notificationCount++;
+    } else {
+        statistics.callCount++;
+        self.outstandingCount++;
+    }
+    self.statistics = statistics;
+    [self.dispatcher handleRequestObject:call.request completion:^(NSDictionary *response) {
+        if (isNotification) {
+            return;
+        }
+        dispatch_async(self.queue, ^{
+            JRPCReplayStatistics statistics = self.statistics;
+            if (![response isKindOfClass:[NSDictionary class]] || !response.jsonRPC_success) {
+                statistics.errorCount++;
+            }
+            self.statistics = statistics;
+            self.outstandingCount--;
+            [self completeIfDone];
+        });
+    }];
+}
+
+// Called on queue
+- (void) completeIfDone {
+    if (!self.completion || self.nextCallIndex < self.calls.count || self.outstandingCount > 0) {
+        return;
+    }
+    JRPCReplayStatistics statistics = self.statistics;
+    statistics.duration = [NSProcessInfo processInfo].systemUptime - self.startTime;
+    void (^completion)(JRPCReplayStatistics) = self.completion;
+    self.completion = nil;
+    self.calls = nil;
+    dispatch_async(self.completionQueue, ^{
+        completion(statistics);
+    });
+}
+
+#pragma mark - Public
+
+- (void) replayWithCompletionQueue:(dispatch_queue_t)completionQueue completion:(void (^)(JRPCReplayStatistics statistics))completion {
+    NSArray<JRPCReplayCall*> *calls = [self recordedCalls];
+    __block BOOL running = NO;
+    dispatch_sync(self.queue, ^{
+        running = (nil != self.completion);
+        if (running) {
+            return;
+        }
+        self.calls = calls;
+        self.nextCallIndex = 0;
+        self.outstandingCount = 0;
+        self.statistics = (JRPCReplayStatistics){ 0 };
+        self.completionQueue = completionQueue ? : dispatch_get_main_queue();
+        self.completion = completion;
+        self.startTime = [NSProcessInfo processInfo].systemUptime;
+    });
+    if (running) {
+        [NSException raise:NSInternalInconsistencyException format:@"A replay is already running"];
+    }
+    dispatch_async(self.queue, ^{
+        [self makeDueCalls];
+    });
+}
+
+@end
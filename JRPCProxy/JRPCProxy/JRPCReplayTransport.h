@@ -0,0 +1,86 @@
+//
+//  JRPCReplayTransport.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+#import "JRPCProxyTransport.h"
+#import "JRPCCodec.h"
+#import "JRPCTrafficRecording.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ JRPCReplayTransport is a JRPCProxyTransport that answers requests from a JRPCTrafficRecording instead of a server, e.g. to load test a client
+ offline or in CI with the traffic of a real session
+ @discussion A request is answered with a recorded response to a request with the same method & params, whatever its id. Params are compared
+ by value, so the order of named params does not matter. When a request was recorded more than once, its responses are given in turn, and
+ then again from the first, so a stateful sequence, e.g. polling, plays out as it was recorded. Each response is delayed by its recorded
+ latency divided by speed. A request that was not recorded fails with a JRPCErrorTransportCode error, and is counted in unmatchedCount.
+ The calls of a recorded batch may be answered singly or in any batch, and a batch request is answered once its slowest call would be.
+ Notifications are accepted and dropped.
+ Requests are carried in any of codecs, or as objects if performsSerialization is set. All methods are thread safe
+ */
+@interface JRPCReplayTransport : NSObject <JRPCProxyTransport>
+
+/**
+ Factory method to create a replay transport. The recording is read once, here
+ @param recording The recording to answer requests from
+ @return An initialized transport
+ */
++ (instancetype) transportWithRecording:(JRPCTrafficRecording*)recording;
+
+/** The recording requests are answered from */
+@property (nonatomic, readonly) JRPCTrafficRecording *recording;
+
+/**
+ If YES, the transport implements the methods that take request objects, otherwise those that take raw data. Defaults to NO
+ Set before creating the proxy, which chooses how to call the transport when it is created
+ */
+@property (atomic, assign) BOOL performsSerialization;
+
+/** The codecs requests can be carried in, when the transport takes raw data. Defaults to a JRPCJSONCodec and a JRPCMessagePackCodec */
+@property (atomic, copy) NSArray<id<JRPCCodec>> *codecs;
+
+/** How much faster than recorded responses are given, e.g. 2 for half the recorded latency. 0 for no delay at all. Defaults to 1 */
+@property (atomic, assign) double speed;
+
+/** The number of requests answered from the recording. A batch counts each of its calls */
+@property (nonatomic, readonly) NSUInteger matchedCount;
+
+/** The number of requests that were not in the recording. A batch counts each of its calls */
+@property (nonatomic, readonly) NSUInteger unmatchedCount;
+
+/** Starts the responses to every request again from the first recorded, and zeroes matchedCount & unmatchedCount */
+- (void) reset;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
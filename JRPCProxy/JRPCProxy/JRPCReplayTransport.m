@@ -0,0 +1,354 @@
+//
+//  JRPCReplayTransport.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCReplayTransport.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+#import "JRPCError.h"
+#import "JRPCJSONWriter.h"
+#import "NSDictionary+JSONRPC.h"
+#import <pthread.h>
+
+/** A recorded response, or failure, to a request */
+@interface JRPCReplayResponse : NSObject
+@property (nonatomic, strong) NSDictionary *response;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) NSTimeInterval latency;
+@end
+
+@implementation JRPCReplayResponse
+@end
+
+/** The recorded responses to one method & params, in the order the requests were sent. Guarded by the transport's lock */
+@interface JRPCReplayResponses : NSObject
+@property (nonatomic, strong) NSMutableArray<JRPCReplayResponse*> *responses;
+// The index of the next response to give, modulo the count
+@property (nonatomic, assign) NSUInteger nextIndex;
+@end
+
+@implementation JRPCReplayResponses
+@end
+
+// Returns the key a request is matched by: its method & params, written with keys sorted so that equal params always give the same key
+static NSData *JRPCReplayKeyForRequest(NSDictionary *request) {
+    if (![request isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    JRPCJSONWriter writer;
+    JRPCJSONWriterInit(&writer);
+    writer.sortsKeys = YES;
+    writer.writesData = YES;
+    @try {
+        JRPCJSONWriterAppendObject(&writer, @[ request.jsonRPC_methodName ? : [NSNull null], request[kJSONRPCParamsKey] ? : [NSNull null] ]);
+    }
+    @catch (NSException *exception) {
+        JRPCJSONWriterDestroy(&writer);
+        return nil;
+    }
+    return JRPCJSONWriterCopyData(&writer);
+}
+
+@interface JRPCReplayTransport() {
+    pthread_mutex_t _lock;
+    // Guarded by _lock
+    NSUInteger _matchedCount;
+    NSUInteger _unmatchedCount;
+}
+@property (nonatomic, strong) JRPCTrafficRecording *recording;
+// Request key => the responses recorded for it. Immutable after init, other than each one's nextIndex
+@property (nonatomic, strong) NSDictionary<NSData*, JRPCReplayResponses*> *responsesByKey;
+@property (atomic, strong) id<JRPCCodec> usedCodec;
+@end
+
+@implementation JRPCReplayTransport
+
++ (instancetype) transportWithRecording:(JRPCTrafficRecording*)recording {
+    return [[self alloc] initWithRecording:recording];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithRecording:(JRPCTrafficRecording*)recording {
+    self = [super init];
+    if (self) {
+        self.recording = recording;
+        self.codecs = @[ [[JRPCJSONCodec alloc] init], [[JRPCMessagePackCodec alloc] init] ];
+        self.usedCodec = self.codecs[0];
+        self.speed = 1;
+        pthread_mutex_init(&_lock, NULL);
+        [self loadRecording:recording];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (BOOL) respondsToSelector:(SEL)aSelector {
+    // The proxy chooses how to call the transport by the methods it responds to, so only claim those taking objects, or those taking data
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:)) ||
+        sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestObjects:completionQueue:completion:)) ||
+        sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestObject:))) {
+        return self.performsSerialization;
+    }
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCPayloadWithRequestData:completionQueue:completion:)) ||
+        sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestData:completionQueue:completion:)) ||
+        sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestData:)) ||
+        sel_isEqual(aSelector, @selector(supportedCodecNames)) ||
+        sel_isEqual(aSelector, @selector(useCodecWithName:))) {
+        return !self.performsSerialization;
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+- (void) loadRecording:(JRPCTrafficRecording*)recording {
+    // Records are in the order their responses arrived, but a request's responses are given in the order it was sent
+    NSMutableArray<JRPCTrafficRecord*> *records = [[NSMutableArray alloc] initWithCapacity:recording.count];
+    [recording enumerateRecordsUsingBlock:^(JRPCTrafficRecord *record, NSUInteger index, BOOL *stop) {
+        if (JRPCTrafficRecordKindNotification != record.kind) {
+            [records addObject:record];
+        }
+    }];
+    [records sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(JRPCTrafficRecord *lhs, JRPCTrafficRecord *rhs) {
+        return (lhs.sentTime < rhs.sentTime) ? NSOrderedAscending : ((lhs.sentTime > rhs.sentTime) ? NSOrderedDescending : NSOrderedSame);
+    }];
+    NSMutableDictionary<NSData*, JRPCReplayResponses*> *responsesByKey = [[NSMutableDictionary alloc] init];
+    for (JRPCTrafficRecord *record in records) {
+        @autoreleasepool {
+            id request = [NSJSONSerialization JSONObjectWithData:record.requestData options:0 error:nil];
+            id response = record.responseData ? [NSJSONSerialization JSONObjectWithData:record.responseData options:0 error:nil] : nil;
+            NSArray *requests = (JRPCTrafficRecordKindBatch == record.kind && [request isKindOfClass:[NSArray class]]) ? request : @[ request ? : [NSNull null] ];
+            // The responses of a batch are matched to its calls by id. A single response to a batch is the server rejecting all of it
+            NSMutableDictionary<id, NSDictionary*> *responsesById = [[NSMutableDictionary alloc] init];
+            if ([response isKindOfClass:[NSArray class]]) {
+                for (NSDictionary *callResponse in response) {
+                    id requestId = [callResponse isKindOfClass:[NSDictionary class]] ? callResponse.jsonRPC_requestId : nil;
+                    if (requestId) {
+                        responsesById[requestId] = callResponse;
+                    }
+                }
+            }
+            for (NSDictionary *callRequest in requests) {
+                id requestId = [callRequest isKindOfClass:[NSDictionary class]] ? callRequest.jsonRPC_requestId : nil;
+                NSData *key = JRPCReplayKeyForRequest(callRequest);
+                NSDictionary *callResponse = [response isKindOfClass:[NSDictionary class]] ? response : (requestId ? responsesById[requestId] : nil);
+                if (!key || !requestId || (!callResponse && !record.error)) {
+                    continue;
+                }
+                JRPCReplayResponse *replayResponse = [[JRPCReplayResponse alloc] init];
+                replayResponse.response = callResponse;
+                replayResponse.error = record.error;
+                replayResponse.latency = record.latency;
+                JRPCReplayResponses *responses = responsesByKey[key];
+                if (!responses) {
+                    responses = [[JRPCReplayResponses alloc] init];
+                    responses.responses = [[NSMutableArray alloc] init];
+                    responsesByKey[key] = responses;
+                }
+                [responses.responses addObject:replayResponse];
+            }
+        }
+    }
+    self.responsesByKey = responsesByKey;
+}
+
+// Returns the next recorded response to a request, with its id, or nil and the recorded error, or an error if the request was not recorded
+- (NSDictionary*) responseToRequest:(NSDictionary*)request latency:(NSTimeInterval*)latency error:(NSError**)error {
+    JRPCReplayResponses *responses = self.responsesByKey[JRPCReplayKeyForRequest(request) ? : [NSData data]];
+    JRPCReplayResponse *replayResponse = nil;
+    pthread_mutex_lock(&_lock);
+    if (responses) {
+        replayResponse = responses.responses[responses.nextIndex++ % responses.responses.count];
+        _matchedCount++;
+    } else {
+        _unmatchedCount++;
+    }
+    pthread_mutex_unlock(&_lock);
+    if (!replayResponse) {
+        NSString *methodName = [request isKindOfClass:[NSDictionary class]] ? request.jsonRPC_methodName : nil;
+        *latency = 0;
+        *error = [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode
+                                 userInfo:@{ NSLocalizedDescriptionKey : [NSString stringWithFormat:@"No recorded response to %@ with these params", methodName] }];
+        return nil;
+    }
+    *latency = replayResponse.latency;
+    *error = replayResponse.error;
+    if (!replayResponse.response) {
+        return nil;
+    }
+    NSMutableDictionary *response = [replayResponse.response mutableCopy];
+    response[kJSONRPCRequestIdKey] = request.jsonRPC_requestId;
+    return [response copy];
+}
+
+// Returns the responses to the calls of a batch, leaving out those not recorded. Fails with the first error if none has a response
+- (NSArray<NSDictionary*>*) responsesToRequests:(NSArray<NSDictionary*>*)requests latency:(NSTimeInterval*)latency error:(NSError**)error {
+    NSMutableArray<NSDictionary*> *responses = [[NSMutableArray alloc] initWithCapacity:requests.count];
+    NSError *firstError = nil;
+    *latency = 0;
+    for (NSDictionary *request in requests) {
+        // Notifications in a batch get no response
+        if (![request isKindOfClass:[NSDictionary class]] || !request.jsonRPC_requestId) {
+            continue;
+        }
+        NSTimeInterval callLatency = 0;
+        NSError *callError = nil;
+        NSDictionary *response = [self responseToRequest:request latency:&callLatency error:&callError];
+        *latency = MAX(*latency, callLatency);
+        if (response) {
+            [responses addObject:response];
+        }
+        firstError = firstError ? : callError;
+    }
+    *error = (0 == responses.count) ? firstError : nil;
+    return *error ? nil : responses;
+}
+
+- (void) afterLatency:(NSTimeInterval)latency queue:(dispatch_queue_t)queue perform:(dispatch_block_t)block {
+    double speed = self.speed;
+    queue = queue ? : dispatch_get_main_queue();
+    if (speed > 0 && latency > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(latency / speed * NSEC_PER_SEC)), queue, block);
+    } else {
+        dispatch_async(queue, block);
+    }
+}
+
+- (NSError*) transportErrorWithError:(NSError*)error {
+    return [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorTransportCode userInfo:error ? @{ NSUnderlyingErrorKey : error } : nil];
+}
+
+#pragma mark - Public
+
+- (void) reset {
+    pthread_mutex_lock(&_lock);
+    for (JRPCReplayResponses *responses in self.responsesByKey.allValues) {
+        responses.nextIndex = 0;
+    }
+    _matchedCount = 0;
+    _unmatchedCount = 0;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger) matchedCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger matchedCount = _matchedCount;
+    pthread_mutex_unlock(&_lock);
+    return matchedCount;
+}
+
+- (NSUInteger) unmatchedCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger unmatchedCount = _unmatchedCount;
+    pthread_mutex_unlock(&_lock);
+    return unmatchedCount;
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestObject:(NSDictionary*)jsonRPCRequest
+                             completionQueue:(dispatch_queue_t)completionQueue
+                                  completion:(JRPCTransportObjectCompletion)completion {
+    NSTimeInterval latency = 0;
+    NSError *error = nil;
+    NSDictionary *response = [self responseToRequest:jsonRPCRequest latency:&latency error:&error];
+    [self afterLatency:latency queue:completionQueue perform:^{
+        completion(response, error);
+    }];
+}
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    id<JRPCCodec> codec = self.usedCodec;
+    NSError *error = nil;
+    NSTimeInterval latency = 0;
+    NSDictionary *request = [codec decodeData:payload error:&error];
+    NSDictionary *response = request ? [self responseToRequest:request latency:&latency error:&error] : nil;
+    error = request ? error : [self transportErrorWithError:error];
+    NSData *responseData = response ? [codec encodeObject:response error:&error] : nil;
+    error = (response && !responseData) ? [self transportErrorWithError:error] : error;
+    [self afterLatency:latency queue:completionQueue perform:^{
+        completion(responseData, responseData ? nil : error);
+    }];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestObjects:(NSArray<NSDictionary*>*)jsonRPCRequests
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportBatchObjectCompletion)completion {
+    NSTimeInterval latency = 0;
+    NSError *error = nil;
+    NSArray<NSDictionary*> *responses = [self responsesToRequests:jsonRPCRequests latency:&latency error:&error];
+    [self afterLatency:latency queue:completionQueue perform:^{
+        completion(responses, error);
+    }];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    id<JRPCCodec> codec = self.usedCodec;
+    NSError *error = nil;
+    NSTimeInterval latency = 0;
+    NSArray<NSDictionary*> *requests = [codec decodeData:payload error:&error];
+    if (![requests isKindOfClass:[NSArray class]]) {
+        requests = nil;
+        error = [self transportErrorWithError:error];
+    }
+    NSArray<NSDictionary*> *responses = requests ? [self responsesToRequests:requests latency:&latency error:&error] : nil;
+    NSData *responseData = responses ? [codec encodeObject:responses error:&error] : nil;
+    error = (responses && !responseData) ? [self transportErrorWithError:error] : error;
+    [self afterLatency:latency queue:completionQueue perform:^{
+        completion(responseData, responseData ? nil : error);
+    }];
+}
+
+- (void) sendJSONRPCNotificationWithRequestObject:(NSDictionary*)jsonRPCNotification {
+    // Nothing to answer
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    // Nothing to answer
+}
+
+- (NSArray<NSString*>*) supportedCodecNames {
+    return [self.codecs valueForKey:@"name"];
+}
+
+- (void) useCodecWithName:(NSString*)name {
+    for (id<JRPCCodec> codec in self.codecs) {
+        if ([codec.name isEqualToString:name]) {
+            self.usedCodec = codec;
+        }
+    }
+}
+
+@end
@@ -0,0 +1,76 @@
+//
+//  JRPCScheduling.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The priority of calls to a proxied method, see setPriority:forSelector: in JRPCAbstractProxy
+ Each priority has its own queue of calls waiting to be sent, and a queue is only drained while the queues of higher priorities are empty
+ */
+typedef NS_ENUM(NSInteger, JRPCCallPriority) {
+    /** Calls the user is waiting on */
+    JRPCCallPriorityInteractive = 0,
+    /** Calls to methods without a priority set */
+    JRPCCallPriorityDefault,
+    /** Background work such as prefetching, sent only when nothing else is waiting */
+    JRPCCallPriorityBulk
+};
+
+/** The number of JRPCCallPriority values */
+#define JRPC_CALL_PRIORITY_COUNT 3
+
+/**
+ Statistics for the calls of one priority
+ */
+typedef struct JRPCSchedulerLaneStatistics {
+    /** Calls waiting to be sent */
+    NSUInteger queueDepth;
+    /** Calls sent */
+    NSUInteger sentCount;
+    /** The total time calls waited before they were sent, in seconds. Divide by sentCount for the mean */
+    NSTimeInterval totalWaitTime;
+    /** The longest time a call waited before it was sent, in seconds */
+    NSTimeInterval maxWaitTime;
+} JRPCSchedulerLaneStatistics;
+
+/**
+ Statistics for the call scheduler of a JRPCAbstractProxy, see schedulerStatistics
+ */
+typedef struct JRPCSchedulerStatistics {
+    /** The number of calls currently allowed in flight at once */
+    NSUInteger concurrencyLimit;
+    /** Calls sent and not yet completed */
+    NSUInteger inFlightCount;
+    /** Statistics for each priority, indexed by JRPCCallPriority */
+    JRPCSchedulerLaneStatistics lanes[JRPC_CALL_PRIORITY_COUNT];
+} JRPCSchedulerStatistics;
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,103 @@
+//
+//  JRPCSharedMemoryEndpoint.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCDispatcher.h"
+#import "JRPCSharedMemoryTransport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The bytes of each ring of an endpoint, unless given. Payloads are limited to half this */
+#define JRPC_SHARED_MEMORY_DEFAULT_RING_CAPACITY (1024 * 1024)
+
+/**
+ JRPCSharedMemoryEndpoint serves the requests of a JRPCSharedMemoryTransport in another process, or the same one, with a JRPCDispatcher.
+ It creates the shared memory the two exchange requests & responses through (see JRPCSharedMemoryTransport.h) under a name both sides know,
+ and a reader thread that takes every request that has arrived at once and hands each to the dispatcher, spinning then sleeping while there
+ are none. Responses are written back from whichever queue the dispatcher completes them on, in the order they are ready.
+ @discussion An endpoint serves a single transport, and stops once that transport is invalidated or its process exits: create another endpoint to
+ serve the next.
+ Creating an endpoint replaces any shared memory left under the same name, e.g. by a server that crashed, and invalidating it removes the name.
+ A response larger than half the ringCapacity cannot be sent, and fails the call with EBADMSG on the client.
+ */
+@interface JRPCSharedMemoryEndpoint : NSObject
+
+/**
+ Factory method to create an endpoint with rings of JRPC_SHARED_MEMORY_DEFAULT_RING_CAPACITY bytes
+ @param name The name of the endpoint, starting with '/' and otherwise without slashes, e.g. "/tv.youview.guide". Apple platforms limit it to 29 characters
+ @param dispatcher The dispatcher that handles requests, with its codec
+ @param error Set to an NSPOSIXErrorDomain error if the shared memory cannot be created
+ @return An endpoint, which starts serving immediately, or nil
+ */
++ (nullable instancetype) endpointWithName:(NSString*)name dispatcher:(JRPCDispatcher*)dispatcher error:(NSError**)error;
+
+/**
+ Factory method to create an endpoint
+ @param name The name of the endpoint, as above
+ @param ringCapacity The bytes of each ring, rounded up to a power of 2 of at least 4096. The region mapped holds two
+ @param dispatcher The dispatcher that handles requests, with its codec
+ @param error Set to an NSPOSIXErrorDomain error if the shared memory cannot be created
+ @return An endpoint, which starts serving immediately, or nil
+ */
++ (nullable instancetype) endpointWithName:(NSString*)name
+                              ringCapacity:(NSUInteger)ringCapacity
+                                dispatcher:(JRPCDispatcher*)dispatcher
+                                     error:(NSError**)error;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+/** The name transports connect with */
+@property (nonatomic, readonly) NSString *name;
+
+/** The bytes of each ring */
+@property (nonatomic, readonly) NSUInteger ringCapacity;
+
+/** The dispatcher that handles requests */
+@property (nonatomic, readonly) JRPCDispatcher *dispatcher;
+
+/** The times the reader checks for a request before going to sleep. Defaults to JRPC_SHARED_MEMORY_DEFAULT_SPIN_COUNT, 0 to sleep straight away */
+@property (atomic, assign) NSUInteger spinCount;
+
+/** YES while a transport is connected */
+@property (nonatomic, readonly, getter=isClientConnected) BOOL clientConnected;
+
+/** NO once the endpoint has been invalidated, or the transport it served has been */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+/**
+ Stops serving, failing the transport's pending requests, and removes the name. Responses the dispatcher completes afterwards are discarded
+ Waits for the reader thread to finish unless called from it. The reader thread retains the endpoint, so it is only released once it or its transport is invalidated
+ */
+- (void) invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,227 @@
+//
+//  JRPCSharedMemoryEndpoint.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCSharedMemoryEndpoint.h"
+#import "JRPCSharedRing.h"
+#import <pthread.h>
+#import <unistd.h>
+
+static NSString * const JSON_RPC_SHARED_MEMORY_ENDPOINT_THREAD_NAME = @"JRPCSharedMemoryEndpointReader";
+
+@interface JRPCSharedMemoryEndpoint() {
+    JRPCSharedRegion _region;
+    // Guards the response ring, which responses are written to from whichever queue the dispatcher completes them on
+    pthread_mutex_t _writeLock;
+    // Read without a lock by the reader thread & responses
+    atomic_bool _valid;
+    // Recorded by the transport when it attaches, 0 until then
+    _Atomic pid_t _clientPid;
+    // Wakes the reader when the client process exits, where its waits cannot time out. Guarded by @synchronized (self)
+    dispatch_source_t _clientExitSource;
+}
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, strong) JRPCDispatcher *dispatcher;
+@property (nonatomic, strong) NSThread *readerThread;
+@property (nonatomic, strong) dispatch_semaphore_t readerExited;
+@end
+
+@implementation JRPCSharedMemoryEndpoint
+
++ (instancetype) endpointWithName:(NSString*)name dispatcher:(JRPCDispatcher*)dispatcher error:(NSError**)error {
+    return [self endpointWithName:name ringCapacity:JRPC_SHARED_MEMORY_DEFAULT_RING_CAPACITY dispatcher:dispatcher error:error];
+}
+
++ (instancetype) endpointWithName:(NSString*)name
+                     ringCapacity:(NSUInteger)ringCapacity
+                       dispatcher:(JRPCDispatcher*)dispatcher
+                            error:(NSError**)error {
+    JRPCSharedRegion region;
+    if (!JRPCSharedRegionCreate(name, ringCapacity, &region, error)) {
+        return nil;
+    }
+    return [[self alloc] initWithName:name region:&region dispatcher:dispatcher];
+}
+
+- (instancetype) initWithName:(NSString*)name region:(JRPCSharedRegion*)region dispatcher:(JRPCDispatcher*)dispatcher {
+    self = [super init];
+    if (self) {
+        _region = *region;
+        pthread_mutex_init(&_writeLock, NULL);
+        atomic_init(&_valid, YES);
+        atomic_init(&_clientPid, 0);
+        self.name = name;
+        self.dispatcher = dispatcher;
+        self.spinCount = JRPC_SHARED_MEMORY_DEFAULT_SPIN_COUNT;
+        self.readerExited = dispatch_semaphore_create(0);
+        // Transports may attach from here on, and check this process is still running
+        atomic_store(&_region.header->serverPid, getpid());
+        atomic_store(&_region.header->serverState, JRPCSharedPeerStateOpen);
+        // The thread retains the endpoint until it exits, i.e. until the endpoint or its transport is invalidated
+        self.readerThread = [[NSThread alloc] initWithTarget:self selector:@selector(readRequests) object:nil];
+        self.readerThread.name = JSON_RPC_SHARED_MEMORY_ENDPOINT_THREAD_NAME;
+        [self.readerThread start];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    [self cancelClientExitSource];
+    JRPCSharedRegionClose(&_region);
+    pthread_mutex_destroy(&_writeLock);
+}
+
+- (NSUInteger) ringCapacity {
+    return (NSUInteger)_region.rings[JRPCSharedRingIndexResponses].capacity;
+}
+
+- (BOOL) isClientConnected {
+    return JRPCSharedPeerStateOpen == atomic_load(&_region.header->clientState);
+}
+
+- (BOOL) isValid {
+    return atomic_load(&_valid);
+}
+
+- (void) invalidate {
+    [self stop];
+    if (![[NSThread currentThread] isEqual:self.readerThread]) {
+        // Signal again so that later calls don't wait
+        dispatch_semaphore_wait(self.readerExited, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(self.readerExited);
+    }
+}
+
+#pragma mark - Private
+
+- (BOOL) isServing {
+    return atomic_load(&_valid) && JRPCSharedPeerStateClosed != atomic_load(&_region.header->clientState);
+}
+
+- (void) stop {
+    if (!atomic_exchange(&_valid, NO)) {
+        return;
+    }
+    [self cancelClientExitSource];
+    // Tell the transport, waking its reader to fail its pending requests, and wake this end's reader to exit
+    atomic_store(&_region.header->serverState, JRPCSharedPeerStateClosed);
+    JRPCSharedRingWake(&_region.rings[JRPCSharedRingIndexResponses]);
+    JRPCSharedRingWake(&_region.rings[JRPCSharedRingIndexRequests]);
+    JRPCSharedRegionUnlink(self.name);
+}
+
+- (void) cancelClientExitSource {
+    dispatch_source_t source = nil;
+    @synchronized (self) {
+        source = _clientExitSource;
+        _clientExitSource = nil;
+    }
+    if (source) {
+        dispatch_source_cancel(source);
+    }
+}
+
+// The transport wakes this end once it has recorded its pid
+- (void) watchClientProcess {
+    pid_t pid = atomic_load(&_region.header->clientPid);
+    if (0 == pid || 0 != atomic_load(&_clientPid)) {
+        return;
+    }
+    atomic_store(&_clientPid, pid);
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_t source = JRPCSharedProcessExitSource(pid, ^{
+        __strong typeof(self) strongSelf = weakSelf;
+        if (strongSelf) {
+            JRPCSharedRingWake(&strongSelf->_region.rings[JRPCSharedRingIndexRequests]);
+        }
+    });
+    @synchronized (self) {
+        _clientExitSource = source;
+    }
+    if (source && !atomic_load(&_valid)) {
+        // Stopped while the source was being made
+        [self cancelClientExitSource];
+    }
+}
+
+- (void) readRequests {
+    JRPCSharedRing *ring = &_region.rings[JRPCSharedRingIndexRequests];
+    while (atomic_load(&_valid)) {
+        @autoreleasepool {
+            // Everything that has arrived is taken at once, then freed for the transport together
+            NSUInteger count = JRPCSharedRingDrain(ring, ^(uint32_t tag, const uint8_t *bytes, uint32_t length) {
+                // The frame is reused once drained, so the request is copied for the dispatcher, which may handle it on another queue
+                [self handleRequestData:[NSData dataWithBytes:bytes length:length] tag:tag];
+            });
+            if (JRPCSharedPeerStateClosed == atomic_load(&_region.header->clientState)) {
+                [self stop];
+                break;
+            }
+            [self watchClientProcess];
+            // Only checked when there was nothing to read, i.e. after sleeping, so a busy reader makes no system call for it
+            if (0 == count && !JRPCSharedProcessIsRunning(atomic_load(&_clientPid))) {
+                [self stop];
+                break;
+            }
+            JRPCSharedRingWait(ring, self.spinCount, ^BOOL{
+                return ![self isServing];
+            });
+        }
+    }
+    dispatch_semaphore_signal(self.readerExited);
+}
+
+- (void) handleRequestData:(NSData*)requestData tag:(uint32_t)tag {
+    [self.dispatcher handleRequestData:requestData completion:^(NSData *responseData) {
+        // Notifications are tagged 0, and get no response. A request that gets none is still answered, with an empty frame, so it is not left waiting
+        if (0 != tag) {
+            [self writeResponseData:responseData tag:tag];
+        }
+    }];
+}
+
+// Waits for room while the response ring is full, which the transport makes as it reads. Gives up if either end stops first,
+// and stops this end if the transport has gone without closing
+- (void) writeResponseData:(NSData*)responseData tag:(uint32_t)tag {
+    JRPCSharedRing *ring = &_region.rings[JRPCSharedRingIndexResponses];
+    if (!responseData || responseData.length > JRPCSharedRingMaxPayloadLength(ring->capacity)) {
+        responseData = [NSData data];
+    }
+    NSError *error = nil;
+    pthread_mutex_lock(&_writeLock);
+    BOOL written = JRPCSharedRingWriteWaiting(ring, tag, responseData, atomic_load(&_clientPid), ^BOOL{
+        return ![self isServing];
+    }, &error);
+    pthread_mutex_unlock(&_writeLock);
+    if (!written && ECONNRESET == error.code) {
+        [self stop];
+    }
+}
+
+@end
@@ -0,0 +1,93 @@
+//
+//  JRPCSharedMemoryTransport.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTransport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** The times a reader checks for a frame before going to sleep, unless set. Tens of microseconds on current hardware */
+#define JRPC_SHARED_MEMORY_DEFAULT_SPIN_COUNT 2000
+
+/**
+ JRPCSharedMemoryTransport is a JRPCProxyTransport to a JRPCSharedMemoryEndpoint on the same host, in another process or the same one, that passes
+ requests & responses through a pair of rings in shared memory rather than a socket, so a busy client & server exchange them without system calls
+ @discussion Requests are copied into the request ring as the proxy encoded them, and each response is copied out of the response ring into a
+ buffer of its own, carried as dispatch data. Frames are tagged, so responses are matched to their requests without reading the payload, and
+ any number of requests may be outstanding at once. Only the ids of requests are scanned as they are sent, so they can be cancelled. The proxy performs the serialization (see JRPCProxyTransport.h), batches are supported, and
+ notifications are sent without waiting for a reply.
+ 
+ A single reader thread takes every response that has arrived at once, then spins for spinCount checks waiting for more, then sleeps until the
+ endpoint wakes it, which the endpoint only does when it sees the reader asleep. When the request ring is full, senders wait for the endpoint
+ to make room. Payloads are limited to half the endpoint's ringCapacity.
+ 
+ An endpoint serves one transport at a time. If the endpoint is invalidated, its process exits, or it stops reading requests for long enough
+ that a sender waits JRPC_SHARED_RING_STALL_TIMEOUT for room, every pending request is completed with an ECONNRESET NSPOSIXErrorDomain error and
+ the transport is invalidated. A server that is running but never answers is not detected, so set a timeout on the proxy (see defaultTimeout in
+ JRPCAbstractProxy) for that. A call the proxy stops waiting for is dropped at once, and its response discarded when it arrives. A batch is
+ dropped once every call in it has been.
+ */
+@interface JRPCSharedMemoryTransport : NSObject <JRPCProxyTransport>
+
+/**
+ Factory method to create a transport to the endpoint with a name
+ @param name The name the endpoint was created with
+ @param error Set to an NSPOSIXErrorDomain error if the transport cannot be created: ENOENT if there is no endpoint with the name,
+ ECONNREFUSED if it has been invalidated, EBUSY if it is serving another transport, or EPROTO if it is not an endpoint of this version
+ @return A transport, which starts reading responses immediately, or nil
+ */
++ (nullable instancetype) transportWithName:(NSString*)name error:(NSError**)error;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+/** The name of the endpoint */
+@property (nonatomic, readonly) NSString *name;
+
+/** The largest request or response payload, in bytes. Larger requests fail with EMSGSIZE */
+@property (nonatomic, readonly) NSUInteger maxPayloadLength;
+
+/** The times the reader checks for a response before going to sleep. 0 to sleep straight away, which saves CPU but adds a wakeup to each call */
+@property (atomic, assign) NSUInteger spinCount;
+
+/** The number of requests waiting for a response */
+@property (nonatomic, readonly) NSUInteger pendingRequestCount;
+
+/** NO once the transport has been invalidated, or the endpoint has been. Requests sent after this fail immediately */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+/**
+ Stops the transport, completing any pending requests with an ECANCELED error, and tells the endpoint, which stops too
+ Waits for the reader thread to finish unless called from it. The reader thread retains the transport, so it is only released once it or the endpoint is invalidated
+ */
+- (void) invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,400 @@
+//
+//  JRPCSharedMemoryTransport.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCSharedMemoryTransport.h"
+#import "JRPCSharedRing.h"
+#import "JRPCJSONReader.h"
+#import "JRPCDispatchData.h"
+#import <pthread.h>
+#import <unistd.h>
+
+static NSString * const JSON_RPC_SHARED_MEMORY_READER_THREAD_NAME = @"JRPCSharedMemoryTransportReader";
+
+/** A request waiting for its response */
+@interface JRPCSharedPendingCall : NSObject
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, copy) JRPCTransportDataCompletion completion;
+// The ids of the requests in the frame that have not been cancelled. Guarded by the transport's _pendingLock
+@property (nonatomic, strong) NSMutableArray<id> *requestIds;
+@end
+
+@implementation JRPCSharedPendingCall
+
+- (void) completeWithData:(NSData*)data error:(NSError*)error {
+    JRPCTransportDataCompletion completion = self.completion;
+    dispatch_async(self.completionQueue ? : dispatch_get_main_queue(), ^{
+        completion(data, error);
+    });
+}
+
+@end
+
+// The id of the JSON-RPC request object in some dispatch data. nil if it has no id, or a null id. Only the id is made contiguous
+static id JRPCSharedRequestIdInDispatchData(dispatch_data_t data) {
+    JRPCJSONResponseEnvelope envelope;
+    if (!JRPCJSONScanResponseEnvelopeInDispatchData(data, &envelope) || NSNotFound == envelope.requestId.location) {
+        return nil;
+    }
+    return JRPCJSONRequestIdInRange(JRPCDispatchDataInRange(data, envelope.requestId), NSMakeRange(0, envelope.requestId.length));
+}
+
+@interface JRPCSharedMemoryTransport() {
+    JRPCSharedRegion _region;
+    // Guards the request ring, which one thread writes at a time, and _lastTag
+    pthread_mutex_t _writeLock;
+    uint32_t _lastTag;
+    // Guards _pendingCalls, a table of JRPCSharedPendingCall keyed by tag, and _pendingTags, the tag of each pending request id
+    pthread_mutex_t _pendingLock;
+    CFMutableDictionaryRef _pendingCalls;
+    CFMutableDictionaryRef _pendingTags;
+    // Read without a lock by senders & the reader thread
+    atomic_bool _valid;
+    pid_t _serverPid;
+    // Wakes the reader when the server process exits, where its waits cannot time out. Guarded by @synchronized (self)
+    dispatch_source_t _serverExitSource;
+}
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, strong) NSThread *readerThread;
+@property (nonatomic, strong) dispatch_semaphore_t readerExited;
+@end
+
+@implementation JRPCSharedMemoryTransport
+
++ (instancetype) transportWithName:(NSString*)name error:(NSError**)error {
+    JRPCSharedRegion region;
+    if (!JRPCSharedRegionOpen(name, &region, error)) {
+        return nil;
+    }
+    NSError *attachError = nil;
+    uint32_t absent = JRPCSharedPeerStateAbsent;
+    if (JRPCSharedPeerStateOpen != atomic_load(&region.header->serverState) ||
+        !JRPCSharedProcessIsRunning(atomic_load(&region.header->serverPid))) {
+        attachError = JRPCSharedPOSIXError(ECONNREFUSED, @"The endpoint is not serving");
+    }
+    else if (!atomic_compare_exchange_strong(&region.header->clientState, &absent, JRPCSharedPeerStateOpen)) {
+        attachError = JRPCSharedPOSIXError(EBUSY, @"The endpoint is serving another transport");
+    }
+    if (attachError) {
+        JRPCSharedRegionClose(&region);
+        if (error) {
+            *error = attachError;
+        }
+        return nil;
+    }
+    // The endpoint is woken to start watching this process
+    atomic_store(&region.header->clientPid, getpid());
+    JRPCSharedRingWake(&region.rings[JRPCSharedRingIndexRequests]);
+    return [[self alloc] initWithName:name region:&region];
+}
+
+- (instancetype) initWithName:(NSString*)name region:(JRPCSharedRegion*)region {
+    self = [super init];
+    if (self) {
+        _region = *region;
+        pthread_mutex_init(&_writeLock, NULL);
+        pthread_mutex_init(&_pendingLock, NULL);
+        // Tags are keys as they are, rather than objects
+        _pendingCalls = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        _pendingTags = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+        atomic_init(&_valid, YES);
+        self.name = name;
+        self.spinCount = JRPC_SHARED_MEMORY_DEFAULT_SPIN_COUNT;
+        self.readerExited = dispatch_semaphore_create(0);
+        _serverPid = atomic_load(&_region.header->serverPid);
+        __weak typeof(self) weakSelf = self;
+        _serverExitSource = JRPCSharedProcessExitSource(_serverPid, ^{
+            [weakSelf wakeReader];
+        });
+        // The thread retains the transport until it exits, i.e. until the transport or the endpoint is invalidated
+        self.readerThread = [[NSThread alloc] initWithTarget:self selector:@selector(readResponses) object:nil];
+        self.readerThread.name = JSON_RPC_SHARED_MEMORY_READER_THREAD_NAME;
+        [self.readerThread start];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    [self cancelServerExitSource];
+    JRPCSharedRegionClose(&_region);
+    CFRelease(_pendingCalls);
+    CFRelease(_pendingTags);
+    pthread_mutex_destroy(&_pendingLock);
+    pthread_mutex_destroy(&_writeLock);
+}
+
+- (NSUInteger) maxPayloadLength {
+    return JRPCSharedRingMaxPayloadLength(_region.rings[JRPCSharedRingIndexRequests].capacity);
+}
+
+- (BOOL) isValid {
+    return atomic_load(&_valid);
+}
+
+- (NSUInteger) pendingRequestCount {
+    pthread_mutex_lock(&_pendingLock);
+    NSUInteger count = (NSUInteger)CFDictionaryGetCount(_pendingCalls);
+    pthread_mutex_unlock(&_pendingLock);
+    return count;
+}
+
+- (void) invalidate {
+    [self invalidateWithError:JRPCSharedPOSIXError(ECANCELED, @"Transport invalidated")];
+    if (![[NSThread currentThread] isEqual:self.readerThread]) {
+        // Signal again so that later calls don't wait
+        dispatch_semaphore_wait(self.readerExited, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(self.readerExited);
+    }
+}
+
+#pragma mark - Private
+
+- (BOOL) isServing {
+    return atomic_load(&_valid) && JRPCSharedPeerStateOpen == atomic_load(&_region.header->serverState);
+}
+
+- (void) invalidateWithError:(NSError*)error {
+    if (!atomic_exchange(&_valid, NO)) {
+        return;
+    }
+    [self cancelServerExitSource];
+    // Tell the endpoint this end has gone, waking its reader to notice, and wake this end's reader to exit
+    atomic_store(&_region.header->clientState, JRPCSharedPeerStateClosed);
+    JRPCSharedRingWake(&_region.rings[JRPCSharedRingIndexRequests]);
+    JRPCSharedRingWake(&_region.rings[JRPCSharedRingIndexResponses]);
+    pthread_mutex_lock(&_pendingLock);
+    NSArray<JRPCSharedPendingCall*> *calls = [(__bridge NSDictionary*)_pendingCalls allValues];
+    CFDictionaryRemoveAllValues(_pendingCalls);
+    CFDictionaryRemoveAllValues(_pendingTags);
+    pthread_mutex_unlock(&_pendingLock);
+    for (JRPCSharedPendingCall *call in calls) {
+        [call completeWithData:nil error:error];
+    }
+}
+
+- (void) wakeReader {
+    JRPCSharedRingWake(&_region.rings[JRPCSharedRingIndexResponses]);
+}
+
+- (void) cancelServerExitSource {
+    dispatch_source_t source = nil;
+    @synchronized (self) {
+        source = _serverExitSource;
+        _serverExitSource = nil;
+    }
+    if (source) {
+        dispatch_source_cancel(source);
+    }
+}
+
+- (JRPCSharedPendingCall*) removePendingCallWithTag:(uint32_t)tag {
+    pthread_mutex_lock(&_pendingLock);
+    JRPCSharedPendingCall *call = (__bridge JRPCSharedPendingCall*)CFDictionaryGetValue(_pendingCalls, (const void*)(uintptr_t)tag);
+    if (call) {
+        CFDictionaryRemoveValue(_pendingCalls, (const void*)(uintptr_t)tag);
+        for (id requestId in call.requestIds) {
+            // Unless another call has since been sent with the same id
+            if (CFDictionaryGetValue(_pendingTags, (__bridge const void*)requestId) == (const void*)(uintptr_t)tag) {
+                CFDictionaryRemoveValue(_pendingTags, (__bridge const void*)requestId);
+            }
+        }
+    }
+    pthread_mutex_unlock(&_pendingLock);
+    return call;
+}
+
+#pragma mark - Writing
+
+- (void) sendPayload:(NSData*)payload
+          requestIds:(NSArray<id>*)requestIds
+     completionQueue:(dispatch_queue_t)completionQueue
+          completion:(JRPCTransportDataCompletion)completion {
+    JRPCSharedPendingCall *call = nil;
+    if (completion) {
+        call = [[JRPCSharedPendingCall alloc] init];
+        call.completionQueue = completionQueue;
+        call.completion = completion;
+        call.requestIds = [requestIds mutableCopy];
+    }
+    if (payload.length > self.maxPayloadLength) {
+        [call completeWithData:nil error:JRPCSharedPOSIXError(EMSGSIZE, @"Request is larger than maxPayloadLength")];
+        return;
+    }
+    pthread_mutex_lock(&_writeLock);
+    // Notifications are tagged 0, and get no response
+    uint32_t tag = 0;
+    if (call) {
+        tag = ++_lastTag ? : ++_lastTag;
+        // Entered in the table before it is written, so the response cannot arrive before it is there
+        pthread_mutex_lock(&_pendingLock);
+        CFDictionarySetValue(_pendingCalls, (const void*)(uintptr_t)tag, (__bridge const void*)call);
+        for (id requestId in call.requestIds) {
+            CFDictionarySetValue(_pendingTags, (__bridge const void*)requestId, (const void*)(uintptr_t)tag);
+        }
+        pthread_mutex_unlock(&_pendingLock);
+    }
+    // Waits for room while the request ring is full, which the endpoint makes as it reads
+    NSError *error = nil;
+    BOOL written = JRPCSharedRingWriteWaiting(&_region.rings[JRPCSharedRingIndexRequests], tag, payload, _serverPid, ^BOOL{
+        return ![self isServing];
+    }, &error);
+    pthread_mutex_unlock(&_writeLock);
+    if (written) {
+        return;
+    }
+    if (ECONNRESET == error.code) {
+        // The endpoint has gone without closing, so none of the pending calls will be answered
+        [self invalidateWithError:error];
+    }
+    if (call && [self removePendingCallWithTag:tag]) {
+        // Invalidated after the call was entered in the table, but before the others were failed
+        [call completeWithData:nil error:JRPCSharedPOSIXError(ENOTCONN, @"Transport is not valid")];
+    }
+}
+
+#pragma mark - Reading
+
+- (void) readResponses {
+    JRPCSharedRing *ring = &_region.rings[JRPCSharedRingIndexResponses];
+    while (atomic_load(&_valid)) {
+        @autoreleasepool {
+            // Everything that has arrived is taken at once, then freed for the endpoint together
+            NSUInteger count = JRPCSharedRingDrain(ring, ^(uint32_t tag, const uint8_t *bytes, uint32_t length) {
+                [self receiveResponseWithTag:tag bytes:bytes length:length];
+            });
+            if (JRPCSharedPeerStateOpen != atomic_load(&_region.header->serverState)) {
+                // Responses written before the endpoint stopped have been taken
+                [self invalidateWithError:JRPCSharedPOSIXError(ECONNRESET, @"Endpoint invalidated")];
+                break;
+            }
+            // Only checked when there was nothing to read, i.e. after sleeping, so a busy reader makes no system call for it
+            if (0 == count && !JRPCSharedProcessIsRunning(_serverPid)) {
+                [self invalidateWithError:JRPCSharedPOSIXError(ECONNRESET, @"Endpoint process exited")];
+                break;
+            }
+            JRPCSharedRingWait(ring, self.spinCount, ^BOOL{
+                return ![self isServing];
+            });
+        }
+    }
+    dispatch_semaphore_signal(self.readerExited);
+}
+
+- (void) receiveResponseWithTag:(uint32_t)tag bytes:(const uint8_t*)bytes length:(uint32_t)length {
+    JRPCSharedPendingCall *call = [self removePendingCallWithTag:tag];
+    if (!call) {
+        // The transport was invalidated, or every request in the frame cancelled, while the response was on its way
+        return;
+    }
+    if (0 == length) {
+        [call completeWithData:nil error:JRPCSharedPOSIXError(EBADMSG, @"The endpoint had no response, or one larger than maxPayloadLength")];
+        return;
+    }
+    // The frame is reused once drained, so the response is copied into a buffer of its own, which its dispatch data frees
+    void *buffer = malloc(length);
+    if (!buffer) {
+        [call completeWithData:nil error:JRPCSharedPOSIXError(ENOMEM, nil)];
+        return;
+    }
+    memcpy(buffer, bytes, length);
+    dispatch_data_t data = dispatch_data_create(buffer, length, NULL, DISPATCH_DATA_DESTRUCTOR_FREE);
+    // Dispatch data is an NSData, so it is passed on as it is
+    [call completeWithData:(NSData*)data error:nil];
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    id requestId = JRPCSharedRequestIdInDispatchData(JRPCDispatchDataWithData(payload));
+    [self sendPayload:payload requestIds:requestId ? @[requestId] : nil completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportDispatchDataCompletion)completion {
+    // Copied into the ring straight from its regions
+    [self sendJSONRPCPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:^(NSData *data, NSError *error) {
+        // Responses are always dispatch data
+        completion((dispatch_data_t)data, error);
+    }];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    // A batch is one frame, answered by one frame, which waits for as long as any of its calls is not cancelled
+    dispatch_data_t dispatchPayload = JRPCDispatchDataWithData(payload);
+    NSMutableArray<id> *requestIds = [[NSMutableArray alloc] init];
+    JRPCJSONScanArrayInDispatchData(dispatchPayload, ^(NSRange elementRange) {
+        id requestId = JRPCSharedRequestIdInDispatchData(dispatch_data_create_subrange(dispatchPayload, elementRange.location, elementRange.length));
+        if (requestId) {
+            [requestIds addObject:requestId];
+        }
+    });
+    [self sendPayload:payload requestIds:requestIds completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                        completionQueue:(dispatch_queue_t)completionQueue
+                                             completion:(JRPCTransportDispatchDataCompletion)completion {
+    [self sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:^(NSData *data, NSError *error) {
+        // Responses are always dispatch data
+        completion((dispatch_data_t)data, error);
+    }];
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    [self sendPayload:payload requestIds:nil completionQueue:nil completion:nil];
+}
+
+- (void) sendJSONRPCNotificationWithRequestDispatchData:(dispatch_data_t)payload {
+    [self sendPayload:(NSData*)payload requestIds:nil completionQueue:nil completion:nil];
+}
+
+- (void) cancelJSONRPCRequestWithId:(id)requestId {
+    // Only this id is removed, so a batch is still answered for its other calls. The call is dropped with its last id, and its response ignored
+    pthread_mutex_lock(&_pendingLock);
+    const void *tag = NULL;
+    JRPCSharedPendingCall *call = nil;
+    if (CFDictionaryGetValueIfPresent(_pendingTags, (__bridge const void*)requestId, &tag)) {
+        CFDictionaryRemoveValue(_pendingTags, (__bridge const void*)requestId);
+        // Keep the call alive until the lock is released, so its completion is not released under it
+        call = (__bridge JRPCSharedPendingCall*)CFDictionaryGetValue(_pendingCalls, tag);
+        [call.requestIds removeObject:requestId];
+        if (call && 0 == call.requestIds.count) {
+            CFDictionaryRemoveValue(_pendingCalls, tag);
+        }
+    }
+    pthread_mutex_unlock(&_pendingLock);
+    call = nil;
+}
+
+@end
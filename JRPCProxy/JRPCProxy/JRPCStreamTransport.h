@@ -0,0 +1,99 @@
+//
+//  JRPCStreamTransport.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTransport.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** How JSON-RPC payloads are delimited on the byte stream */
+typedef NS_ENUM(NSInteger, JRPCStreamFraming) {
+    /** Each payload is followed by a line feed. Serialized JSON-RPC payloads never contain a raw line feed, so no escaping is needed */
+    JRPCStreamFramingNewlineDelimited = 0,
+    /** Each payload is preceded by its length in bytes, as a 32 bit big-endian unsigned integer */
+    JRPCStreamFramingLengthPrefixed
+};
+
+/**
+ JRPCStreamTransport is a JRPCProxyTransport that sends JSON-RPC requests over a persistent bidirectional byte stream, e.g. a socket or a pair of pipes
+ @discussion Any number of requests may be outstanding at once. Each request is recorded in a table of pending requests keyed by its JSON-RPC id,
+ and a single reader thread reads responses off the stream as they arrive and completes the matching request, whatever order the server replies in.
+ Writes are made on a private queue, with requests sent while a write is in progress coalesced into the next one.
+ The proxy performs the JSON serialization (see JRPCProxyTransport.h), batches are supported, and notifications are sent without waiting for a reply.
+ Payloads are carried as dispatch data both ways. Requests are written with writev() straight from the regions they were encoded in, and each read
+ goes into a buffer of its own that becomes a region of the responses it holds, so a response is passed on without being moved or joined.
+ The transport does not own the file descriptors. Call invalidate before closing them, which also stops the reader thread and so releases the transport.
+ If the stream is closed or fails, every pending request is completed with an NSPOSIXErrorDomain error and the transport is invalidated.
+ Responses whose id does not match a pending request (including error responses with a null id) are discarded.
+ Requests the proxy stops waiting for (see defaultTimeout in JRPCAbstractProxy) are removed from the table, and their responses discarded.
+ */
+@interface JRPCStreamTransport : NSObject <JRPCProxyTransport>
+
+/**
+ Factory method to create a transport for a socket, or any other file descriptor that may be both read and written
+ @param fileDescriptor The file descriptor of the stream
+ @param framing How payloads are delimited on the stream
+ @return A transport, which starts reading the stream immediately
+ */
++ (instancetype) transportWithFileDescriptor:(int)fileDescriptor framing:(JRPCStreamFraming)framing;
+
+/**
+ Initializes a transport that reads & writes separate file descriptors, e.g. a pair of pipes
+ @param readFileDescriptor The file descriptor responses are read from
+ @param writeFileDescriptor The file descriptor requests are written to
+ @param framing How payloads are delimited on the stream
+ @return A transport, which starts reading the stream immediately
+ */
+- (instancetype) initWithReadFileDescriptor:(int)readFileDescriptor
+                        writeFileDescriptor:(int)writeFileDescriptor
+                                    framing:(JRPCStreamFraming)framing NS_DESIGNATED_INITIALIZER;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+/** How payloads are delimited on the stream */
+@property (nonatomic, readonly) JRPCStreamFraming framing;
+
+/** The largest response payload accepted, in bytes. A larger one fails the stream with EMSGSIZE. Defaults to 16MB */
+@property (atomic, assign) NSUInteger maxFrameLength;
+
+/** The number of requests waiting for a response */
+@property (nonatomic, readonly) NSUInteger pendingRequestCount;
+
+/** NO once the transport has been invalidated, or the stream has closed or failed. Requests sent after this fail immediately */
+@property (atomic, readonly, getter=isValid) BOOL valid;
+
+/**
+ Stops the transport, completing any pending requests with an ECANCELED error
+ Waits for the reader thread to finish unless called from it, so the file descriptors may be closed as soon as this returns
+ */
+- (void) invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,562 @@
+//
+//  JRPCStreamTransport.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCStreamTransport.h"
+#import "JRPCJSONReader.h"
+#import "JRPCDispatchData.h"
+#import <pthread.h>
+#import <poll.h>
+#import <unistd.h>
+#import <sys/socket.h>
+#import <sys/uio.h>
+
+// The pending request table is split into shards, each with its own lock, so senders & the reader thread rarely contend
+#define JRPC_STREAM_PENDING_SHARD_COUNT 16
+
+// Bytes read from the stream at a time
+#define JRPC_STREAM_READ_CHUNK_SIZE 65536
+
+// The most regions of the write buffer written by one system call
+#define JRPC_STREAM_WRITE_VECTOR_COUNT 64
+
+static const NSUInteger kJRPCStreamDefaultMaxFrameLength = 16 * 1024 * 1024;
+
+static const char *JSON_RPC_STREAM_WRITE_QUEUE_NAME = "JRPCStreamTransportWriteQueue";
+static NSString * const JSON_RPC_STREAM_READER_THREAD_NAME = @"JRPCStreamTransportReader";
+
+/**
+ A request waiting for its response
+ A batch is a single pending call, entered in the table under the id of each of its requests
+ */
+@interface JRPCStreamPendingCall : NSObject
+@property (nonatomic, copy) NSArray<id> *requestIds;
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, copy) JRPCTransportDataCompletion completion;
+@end
+
+@implementation JRPCStreamPendingCall
+
+- (void) completeWithData:(NSData*)data error:(NSError*)error {
+    JRPCTransportDataCompletion completion = self.completion;
+    dispatch_async(self.completionQueue ? : dispatch_get_main_queue(), ^{
+        completion(data, error);
+    });
+}
+
+@end
+
+static NSError *JRPCStreamPOSIXError(int code, NSString *description) {
+    NSDictionary *userInfo = description ? @{ NSDebugDescriptionErrorKey : description } : nil;
+    return [NSError errorWithDomain:NSPOSIXErrorDomain code:code userInfo:userInfo];
+}
+
+// Writes to the stream, without raising SIGPIPE if it is a socket that has been closed, where the platform allows
+static ssize_t JRPCStreamWrite(int fileDescriptor, const void *bytes, size_t length) {
+#ifdef MSG_NOSIGNAL
+    ssize_t count = send(fileDescriptor, bytes, length, MSG_NOSIGNAL);
+    if (count >= 0 || ENOTSOCK != errno) {
+        return count;
+    }
+#endif
+    return write(fileDescriptor, bytes, length);
+}
+
+// Gathers several buffers into one write, likewise without raising SIGPIPE where the platform allows
+static ssize_t JRPCStreamWriteVector(int fileDescriptor, const struct iovec *vectors, int count) {
+#ifdef MSG_NOSIGNAL
+    struct msghdr message = { .msg_iov = (struct iovec*)vectors, .msg_iovlen = count };
+    ssize_t written = sendmsg(fileDescriptor, &message, MSG_NOSIGNAL);
+    if (written >= 0 || ENOTSOCK != errno) {
+        return written;
+    }
+#endif
+    return writev(fileDescriptor, vectors, count);
+}
+
+// The id of the JSON-RPC request or response object in some dispatch data. nil if it has no id, or a null id. Only the id is made contiguous
+static id JRPCStreamRequestIdInDispatchData(dispatch_data_t data) {
+    JRPCJSONResponseEnvelope envelope;
+    if (!JRPCJSONScanResponseEnvelopeInDispatchData(data, &envelope) || NSNotFound == envelope.requestId.location) {
+        return nil;
+    }
+    return JRPCJSONRequestIdInRange(JRPCDispatchDataInRange(data, envelope.requestId), NSMakeRange(0, envelope.requestId.length));
+}
+
+@interface JRPCStreamTransport() {
+    // One lock & table of JRPCStreamPendingCall keyed by request id per shard
+    pthread_mutex_t _pendingLocks[JRPC_STREAM_PENDING_SHARD_COUNT];
+    CFMutableDictionaryRef _pendingCalls[JRPC_STREAM_PENDING_SHARD_COUNT];
+    // Guards _valid, _writeBuffer & _flushScheduled
+    pthread_mutex_t _writeLock;
+    BOOL _valid;
+    // The frames waiting to be written, linked rather than copied together
+    dispatch_data_t _writeBuffer;
+    BOOL _flushScheduled;
+    // Written to by invalidate to wake the reader thread
+    int _wakeFileDescriptors[2];
+}
+@property (nonatomic, assign) int readFileDescriptor;
+@property (nonatomic, assign) int writeFileDescriptor;
+@property (nonatomic, assign) JRPCStreamFraming framing;
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+@property (nonatomic, strong) NSThread *readerThread;
+@property (nonatomic, strong) dispatch_semaphore_t readerExited;
+@end
+
+@implementation JRPCStreamTransport
+
++ (instancetype) transportWithFileDescriptor:(int)fileDescriptor framing:(JRPCStreamFraming)framing {
+    return [[self alloc] initWithReadFileDescriptor:fileDescriptor writeFileDescriptor:fileDescriptor framing:framing];
+}
+
+- (instancetype) initWithReadFileDescriptor:(int)readFileDescriptor
+                        writeFileDescriptor:(int)writeFileDescriptor
+                                    framing:(JRPCStreamFraming)framing {
+    self = [super init];
+    if (self) {
+        if (0 != pipe(_wakeFileDescriptors)) {
+            [NSException raise:NSInternalInconsistencyException format:@"Unable to create pipe, errno=%i", errno];
+        }
+        for (NSUInteger i = 0; i < JRPC_STREAM_PENDING_SHARD_COUNT; ++i) {
+            pthread_mutex_init(&_pendingLocks[i], NULL);
+            _pendingCalls[i] = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+        }
+        pthread_mutex_init(&_writeLock, NULL);
+        _writeBuffer = dispatch_data_empty;
+        _valid = YES;
+#ifdef SO_NOSIGPIPE
+        // Report writes to a closed socket as EPIPE rather than raising SIGPIPE. Fails harmlessly if it is not a socket
+        int noSigPipe = 1;
+        setsockopt(writeFileDescriptor, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+        self.readFileDescriptor = readFileDescriptor;
+        self.writeFileDescriptor = writeFileDescriptor;
+        self.framing = framing;
+        self.maxFrameLength = kJRPCStreamDefaultMaxFrameLength;
+        self.writeQueue = dispatch_queue_create(JSON_RPC_STREAM_WRITE_QUEUE_NAME, DISPATCH_QUEUE_SERIAL);
+        self.readerExited = dispatch_semaphore_create(0);
+        // The thread retains the transport until it exits, i.e. until the transport is invalidated or the stream closes
+        self.readerThread = [[NSThread alloc] initWithTarget:self selector:@selector(readStream) object:nil];
+        self.readerThread.name = JSON_RPC_STREAM_READER_THREAD_NAME;
+        [self.readerThread start];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    for (NSUInteger i = 0; i < JRPC_STREAM_PENDING_SHARD_COUNT; ++i) {
+        CFRelease(_pendingCalls[i]);
+        pthread_mutex_destroy(&_pendingLocks[i]);
+    }
+    pthread_mutex_destroy(&_writeLock);
+    close(_wakeFileDescriptors[0]);
+    close(_wakeFileDescriptors[1]);
+}
+
+- (BOOL) isValid {
+    pthread_mutex_lock(&_writeLock);
+    BOOL valid = _valid;
+    pthread_mutex_unlock(&_writeLock);
+    return valid;
+}
+
+- (NSUInteger) pendingRequestCount {
+    NSUInteger count = 0;
+    for (NSUInteger i = 0; i < JRPC_STREAM_PENDING_SHARD_COUNT; ++i) {
+        pthread_mutex_lock(&_pendingLocks[i]);
+        count += (NSUInteger)CFDictionaryGetCount(_pendingCalls[i]);
+        pthread_mutex_unlock(&_pendingLocks[i]);
+    }
+    return count;
+}
+
+- (void) invalidate {
+    [self invalidateWithError:JRPCStreamPOSIXError(ECANCELED, @"Transport invalidated")];
+    if (![[NSThread currentThread] isEqual:self.readerThread]) {
+        // Signal again so that later calls don't wait
+        dispatch_semaphore_wait(self.readerExited, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(self.readerExited);
+    }
+}
+
+#pragma mark - Private
+
+- (void) invalidateWithError:(NSError*)error {
+    pthread_mutex_lock(&_writeLock);
+    BOOL wasValid = _valid;
+    _valid = NO;
+    pthread_mutex_unlock(&_writeLock);
+    if (!wasValid) {
+        return;
+    }
+    // Wake the reader thread, then fail everything still waiting for a response
+    uint8_t wake = 0;
+    while (write(_wakeFileDescriptors[1], &wake, 1) < 0 && EINTR == errno);
+    for (JRPCStreamPendingCall *call in [self removeAllPendingCalls]) {
+        [call completeWithData:nil error:error];
+    }
+}
+
+#pragma mark - Pending request table
+
+- (NSUInteger) shardForRequestId:(id)requestId {
+    return [requestId hash] % JRPC_STREAM_PENDING_SHARD_COUNT;
+}
+
+- (void) addPendingCall:(JRPCStreamPendingCall*)call {
+    for (id requestId in call.requestIds) {
+        NSUInteger shard = [self shardForRequestId:requestId];
+        pthread_mutex_lock(&_pendingLocks[shard]);
+        CFDictionarySetValue(_pendingCalls[shard], (__bridge const void*)requestId, (__bridge const void*)call);
+        pthread_mutex_unlock(&_pendingLocks[shard]);
+    }
+}
+
+// Removes the call from the table under each of its ids. Returns NO if it had already been removed i.e. it has been, or is being, completed elsewhere
+- (BOOL) removePendingCall:(JRPCStreamPendingCall*)call {
+    BOOL removed = NO;
+    for (id requestId in call.requestIds) {
+        NSUInteger shard = [self shardForRequestId:requestId];
+        pthread_mutex_lock(&_pendingLocks[shard]);
+        if (CFDictionaryGetValue(_pendingCalls[shard], (__bridge const void*)requestId) == (__bridge const void*)call) {
+            CFDictionaryRemoveValue(_pendingCalls[shard], (__bridge const void*)requestId);
+            removed = YES;
+        }
+        pthread_mutex_unlock(&_pendingLocks[shard]);
+    }
+    return removed;
+}
+
+- (JRPCStreamPendingCall*) removePendingCallForRequestId:(id)requestId {
+    NSUInteger shard = [self shardForRequestId:requestId];
+    pthread_mutex_lock(&_pendingLocks[shard]);
+    JRPCStreamPendingCall *call = (__bridge JRPCStreamPendingCall*)CFDictionaryGetValue(_pendingCalls[shard], (__bridge const void*)requestId);
+    pthread_mutex_unlock(&_pendingLocks[shard]);
+    // The call is only completed by whoever removes it, so a batch answered twice is completed once
+    return (call && [self removePendingCall:call]) ? call : nil;
+}
+
+- (NSArray<JRPCStreamPendingCall*>*) removeAllPendingCalls {
+    NSMutableSet<JRPCStreamPendingCall*> *calls = [[NSMutableSet alloc] init];
+    for (NSUInteger i = 0; i < JRPC_STREAM_PENDING_SHARD_COUNT; ++i) {
+        pthread_mutex_lock(&_pendingLocks[i]);
+        [calls addObjectsFromArray:[(__bridge NSDictionary*)_pendingCalls[i] allValues]];
+        CFDictionaryRemoveAllValues(_pendingCalls[i]);
+        pthread_mutex_unlock(&_pendingLocks[i]);
+    }
+    return calls.allObjects;
+}
+
+#pragma mark - Writing
+
+- (void) sendPayload:(dispatch_data_t)payload
+          requestIds:(NSArray<id>*)requestIds
+     completionQueue:(dispatch_queue_t)completionQueue
+          completion:(JRPCTransportDataCompletion)completion {
+    JRPCStreamPendingCall *call = [[JRPCStreamPendingCall alloc] init];
+    call.requestIds = requestIds;
+    call.completionQueue = completionQueue;
+    call.completion = completion;
+    if (0 == requestIds.count) {
+        // The server does not reply to requests without an id, so there is nothing to wait for
+        [self writeFrameWithPayload:payload];
+        [call completeWithData:nil error:JRPCStreamPOSIXError(EINVAL, @"Request has no id to match a response to")];
+        return;
+    }
+    if (JRPCStreamFramingLengthPrefixed == self.framing && dispatch_data_get_size(payload) > UINT32_MAX) {
+        [call completeWithData:nil error:JRPCStreamPOSIXError(EMSGSIZE, nil)];
+        return;
+    }
+    // Enter the call in the table before writing, so the response cannot arrive before it is there
+    [self addPendingCall:call];
+    if (![self writeFrameWithPayload:payload] && [self removePendingCall:call]) {
+        // Invalidated before the call was entered in the table, so it was not failed with the others
+        [call completeWithData:nil error:JRPCStreamPOSIXError(ENOTCONN, @"Transport is not valid")];
+    }
+}
+
+// Appends the framed payload to the write buffer, scheduling a write if one is not already due. Returns NO if the transport is not valid
+- (BOOL) writeFrameWithPayload:(dispatch_data_t)payload {
+    static dispatch_data_t lineFeed;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        lineFeed = dispatch_data_create("\n", 1, NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+    });
+    // The payload's regions are linked into the buffer, not copied
+    dispatch_data_t frame = payload;
+    if (JRPCStreamFramingLengthPrefixed == self.framing) {
+        uint32_t frameLength = CFSwapInt32HostToBig((uint32_t)dispatch_data_get_size(payload));
+        frame = dispatch_data_create_concat(dispatch_data_create(&frameLength, sizeof(frameLength), NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT), payload);
+    }
+    else {
+        frame = dispatch_data_create_concat(payload, lineFeed);
+    }
+    pthread_mutex_lock(&_writeLock);
+    if (!_valid) {
+        pthread_mutex_unlock(&_writeLock);
+        return NO;
+    }
+    _writeBuffer = dispatch_data_create_concat(_writeBuffer, frame);
+    BOOL scheduleFlush = !_flushScheduled;
+    _flushScheduled = YES;
+    pthread_mutex_unlock(&_writeLock);
+    if (scheduleFlush) {
+        dispatch_async(self.writeQueue, ^{
+            [self flushWriteBuffer];
+        });
+    }
+    return YES;
+}
+
+- (void) flushWriteBuffer {
+    // Take everything written since the last flush, so frames queued while this one is writing go out together in the next
+    pthread_mutex_lock(&_writeLock);
+    dispatch_data_t data = _writeBuffer;
+    _writeBuffer = dispatch_data_empty;
+    _flushScheduled = NO;
+    pthread_mutex_unlock(&_writeLock);
+    struct iovec vectorStorage[JRPC_STREAM_WRITE_VECTOR_COUNT];
+    struct iovec *vectors = vectorStorage;
+    while (dispatch_data_get_size(data) > 0) {
+        // Gather the regions straight from the payloads. They are retained by data, so their bytes stay put after the applier returns
+        __block int vectorCount = 0;
+        dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+            vectors[vectorCount++] = (struct iovec){ .iov_base = (void*)buffer, .iov_len = size };
+            return vectorCount < JRPC_STREAM_WRITE_VECTOR_COUNT;
+        });
+        ssize_t count = (1 == vectorCount) ?
+            JRPCStreamWrite(self.writeFileDescriptor, vectors[0].iov_base, vectors[0].iov_len) :
+            JRPCStreamWriteVector(self.writeFileDescriptor, vectors, vectorCount);
+        if (count >= 0) {
+            size_t remaining = dispatch_data_get_size(data) - (size_t)count;
+            data = dispatch_data_create_subrange(data, (size_t)count, remaining);
+        }
+        else if (EAGAIN == errno) {
+            // Non-blocking descriptor, wait until there is room
+            struct pollfd pollFileDescriptor = { .fd = self.writeFileDescriptor, .events = POLLOUT };
+            poll(&pollFileDescriptor, 1, -1);
+        }
+        else if (EINTR != errno) {
+            [self invalidateWithError:JRPCStreamPOSIXError(errno, @"Write to stream failed")];
+            return;
+        }
+    }
+}
+
+#pragma mark - Reading
+
+- (void) readStream {
+    // The bytes read but not yet consumed, in the regions they were read into
+    dispatch_data_t received = dispatch_data_empty;
+    NSUInteger scanOffset = 0;
+    NSError *error = nil;
+    while (!error) {
+        @autoreleasepool {
+            struct pollfd pollFileDescriptors[2] = {
+                { .fd = self.readFileDescriptor, .events = POLLIN },
+                { .fd = _wakeFileDescriptors[0], .events = POLLIN }
+            };
+            if (poll(pollFileDescriptors, 2, -1) < 0) {
+                if (EINTR != errno) {
+                    error = JRPCStreamPOSIXError(errno, @"Poll of stream failed");
+                }
+                continue;
+            }
+            if (0 != pollFileDescriptors[1].revents) {
+                // Invalidated, which has already failed the pending calls
+                break;
+            }
+            if (0 == pollFileDescriptors[0].revents) {
+                continue;
+            }
+            // Each read goes into a buffer of its own, which becomes a region of the frames it holds, so nothing is moved or copied afterwards
+            uint8_t *buffer = malloc(JRPC_STREAM_READ_CHUNK_SIZE);
+            if (!buffer) {
+                error = JRPCStreamPOSIXError(ENOMEM, nil);
+                break;
+            }
+            ssize_t count = read(self.readFileDescriptor, buffer, JRPC_STREAM_READ_CHUNK_SIZE);
+            if (count > 0) {
+                if (count < JRPC_STREAM_READ_CHUNK_SIZE) {
+                    // Give back the unused end of the buffer, which shrinks in place
+                    buffer = realloc(buffer, (size_t)count) ? : buffer;
+                }
+                received = dispatch_data_create_concat(received, dispatch_data_create(buffer, (size_t)count, NULL, DISPATCH_DATA_DESTRUCTOR_FREE));
+                received = [self receiveFramesInData:received scanOffset:&scanOffset error:&error];
+            }
+            else {
+                free(buffer);
+                if (0 == count) {
+                    error = JRPCStreamPOSIXError(ECONNRESET, @"Stream closed");
+                }
+                else if (EINTR != errno && EAGAIN != errno) {
+                    error = JRPCStreamPOSIXError(errno, @"Read from stream failed");
+                }
+            }
+        }
+    }
+    if (error) {
+        [self invalidateWithError:error];
+    }
+    dispatch_semaphore_signal(self.readerExited);
+}
+
+// Passes each complete frame in the data to receiveFrame:, as a subrange sharing its regions, and returns the data left over.
+// scanOffset is where to continue looking for the end of an incomplete frame, relative to the start of the data left over
+- (dispatch_data_t) receiveFramesInData:(dispatch_data_t)data
+                             scanOffset:(NSUInteger*)scanOffset
+                                  error:(NSError**)error {
+    NSUInteger maxFrameLength = self.maxFrameLength;
+    NSUInteger length = dispatch_data_get_size(data);
+    NSUInteger start = 0;
+    if (JRPCStreamFramingLengthPrefixed == self.framing) {
+        while (length - start >= sizeof(uint32_t)) {
+            uint32_t frameLength;
+            JRPCDispatchDataGetBytes(data, start, &frameLength, sizeof(frameLength));
+            frameLength = CFSwapInt32BigToHost(frameLength);
+            if (frameLength > maxFrameLength) {
+                *error = JRPCStreamPOSIXError(EMSGSIZE, @"Response exceeds maxFrameLength");
+                break;
+            }
+            if (length - start - sizeof(uint32_t) < frameLength) {
+                break;
+            }
+            [self receiveFrame:dispatch_data_create_subrange(data, start + sizeof(uint32_t), frameLength)];
+            start += sizeof(uint32_t) + frameLength;
+        }
+    }
+    else {
+        NSUInteger scanFrom = *scanOffset;
+        while (start + scanFrom < length) {
+            NSUInteger end = JRPCDispatchDataIndexOfByte(data, '\n', start + scanFrom);
+            if (NSNotFound == end) {
+                scanFrom = length - start;
+                if (scanFrom > maxFrameLength) {
+                    *error = JRPCStreamPOSIXError(EMSGSIZE, @"Response exceeds maxFrameLength");
+                }
+                break;
+            }
+            NSUInteger frameLength = end - start;
+            uint8_t lastByte = 0;
+            if (frameLength > 0) {
+                JRPCDispatchDataGetBytes(data, end - 1, &lastByte, 1);
+            }
+            if ('\r' == lastByte) {
+                frameLength--;
+            }
+            if (frameLength > 0) {
+                [self receiveFrame:dispatch_data_create_subrange(data, start, frameLength)];
+            }
+            start = end + 1;
+            scanFrom = 0;
+        }
+        *scanOffset = scanFrom;
+    }
+    // Regions wholly consumed are released with the subrange
+    return (0 == start) ? data : dispatch_data_create_subrange(data, start, length - start);
+}
+
+- (void) receiveFrame:(dispatch_data_t)frame {
+    __block JRPCStreamPendingCall *call = nil;
+    // A batch response is matched to the pending batch by the id of any of its responses
+    BOOL isBatch = JRPCJSONScanArrayInDispatchData(frame, ^(NSRange elementRange) {
+        if (!call) {
+            id requestId = JRPCStreamRequestIdInDispatchData(dispatch_data_create_subrange(frame, elementRange.location, elementRange.length));
+            call = requestId ? [self removePendingCallForRequestId:requestId] : nil;
+        }
+    });
+    if (!isBatch) {
+        id requestId = JRPCStreamRequestIdInDispatchData(frame);
+        call = requestId ? [self removePendingCallForRequestId:requestId] : nil;
+    }
+    // Dispatch data is an NSData, so the frame is passed on in the regions it was read into
+    [call completeWithData:(NSData*)frame error:nil];
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    dispatch_data_t dispatchPayload = JRPCDispatchDataWithData(payload);
+    id requestId = JRPCStreamRequestIdInDispatchData(dispatchPayload);
+    [self sendPayload:dispatchPayload requestIds:requestId ? @[requestId] : nil completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportDispatchDataCompletion)completion {
+    [self sendJSONRPCPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:^(NSData *data, NSError *error) {
+        // Frames are always dispatch data
+        completion((dispatch_data_t)data, error);
+    }];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    dispatch_data_t dispatchPayload = JRPCDispatchDataWithData(payload);
+    NSMutableArray<id> *requestIds = [[NSMutableArray alloc] init];
+    JRPCJSONScanArrayInDispatchData(dispatchPayload, ^(NSRange elementRange) {
+        id requestId = JRPCStreamRequestIdInDispatchData(dispatch_data_create_subrange(dispatchPayload, elementRange.location, elementRange.length));
+        if (requestId) {
+            [requestIds addObject:requestId];
+        }
+    });
+    [self sendPayload:dispatchPayload requestIds:[requestIds copy] completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                        completionQueue:(dispatch_queue_t)completionQueue
+                                             completion:(JRPCTransportDispatchDataCompletion)completion {
+    [self sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:^(NSData *data, NSError *error) {
+        completion((dispatch_data_t)data, error);
+    }];
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    [self writeFrameWithPayload:JRPCDispatchDataWithData(payload)];
+}
+
+- (void) sendJSONRPCNotificationWithRequestDispatchData:(dispatch_data_t)payload {
+    [self writeFrameWithPayload:payload];
+}
+
+- (void) cancelJSONRPCRequestWithId:(id)requestId {
+    // Only this id's entry is removed, so a batch is still matched by the ids of its other calls. The call is released with its last entry
+    NSUInteger shard = [self shardForRequestId:requestId];
+    pthread_mutex_lock(&_pendingLocks[shard]);
+    // Keep the call alive until the lock is released, so its completion is not released under it
+    JRPCStreamPendingCall *call = (__bridge JRPCStreamPendingCall*)CFDictionaryGetValue(_pendingCalls[shard], (__bridge const void*)requestId);
+    CFDictionaryRemoveValue(_pendingCalls[shard], (__bridge const void*)requestId);
+    pthread_mutex_unlock(&_pendingLocks[shard]);
+    call = nil;
+}
+
+@end
@@ -0,0 +1,99 @@
+//
+//  JRPCTracer.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The name of the request member holding the trace context of a traced call, when the proxy injects it. See injectsTraceContext in JRPCAbstractProxy.
+ Its value is a W3C Trace Context traceparent: "00-<32 hex digit trace id>-<16 hex digit span id>-01"
+ */
+FOUNDATION_EXTERN NSString * const JRPCTraceContextKey;
+
+/**
+ The formats a JRPCTracer exports its spans in
+ */
+typedef NS_ENUM(NSInteger, JRPCTraceFormat) {
+    /** Chrome trace_event JSON, which chrome://tracing & Perfetto open. Each call is a track of its own, with its phases nested under it */
+    JRPCTraceFormatChrome = 0,
+    /** OpenTelemetry OTLP/JSON, as an ExportTraceServiceRequest */
+    JRPCTraceFormatOTLP
+};
+
+/**
+ JRPCTracer collects the spans of traced calls, to be exported to a file. See tracer in JRPCAbstractProxy & JRPCDispatcher
+ @discussion A sampled call has a span from when it is made until its completion block is called, with a child span for each phase of the call
+ that is timed (see JRPCMetricsPhase). Spans are written to a ring buffer of fixed size without locks, so once it is full the oldest spans are
+ overwritten, and a tracer may be shared by any number of proxies & dispatchers. A call that is not sampled costs a random number
+ */
+@interface JRPCTracer : NSObject
+
+/**
+ Initializes a tracer
+ @param capacity The number of spans kept, from the most recent. A call has up to 6 spans
+ @return An initialized tracer
+ */
+- (instancetype) initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/** Initializes a tracer that keeps the most recent 4096 spans */
+- (instancetype) init;
+
+/** The number of spans kept */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ The fraction of calls traced, from 0 to 1, unless the method has its own rate. Defaults to 1, i.e. every call
+ See setTraceSampleRate:forSelector: in JRPCAbstractProxy. Requests joining a trace from a proxy are always traced by a dispatcher
+ */
+@property (atomic, assign) double sampleRate;
+
+/**
+ Exports the spans kept
+ @param format The format to export in
+ @return The spans, as UTF-8 encoded JSON. Spans still being written are left out
+ */
+- (NSData*) dataWithFormat:(JRPCTraceFormat)format;
+
+/**
+ Exports the spans kept to a file
+ @param url The file URL to write to, which is replaced
+ @param format The format to export in
+ @param error On failure, the reason the file could not be written
+ @return YES on success
+ */
+- (BOOL) writeToURL:(NSURL*)url format:(JRPCTraceFormat)format error:(NSError**)error;
+
+/** Discards the spans kept. Spans being written meanwhile may be kept or discarded */
+- (void) removeAllSpans;
+
+@end
+
+NS_ASSUME_NONNULL_END
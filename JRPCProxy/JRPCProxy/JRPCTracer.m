@@ -0,0 +1,290 @@
+//
+//  JRPCTracer.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCTracer.h"
+#import "JRPCCallTrace.h"
+#import <mach/mach_time.h>
+#import <stdatomic.h>
+#import <unistd.h>
+
+NSString * const JRPCTraceContextKey = @"traceparent";
+
+#define JRPC_TRACER_DEFAULT_CAPACITY 4096
+
+// A span as kept in the ring buffer, with its name copied in
+typedef struct JRPCSpanData {
+    char name[JRPC_SPAN_NAME_LENGTH];
+    JRPCSpanKind kind;
+    BOOL failed;
+    uint32_t track;
+    uint64_t traceIdHigh;
+    uint64_t traceIdLow;
+    uint64_t spanId;
+    uint64_t parentSpanId;
+    uint64_t startTime;
+    uint64_t endTime;
+    NSInteger errorCode;
+} JRPCSpanData;
+
+// A slot of the ring buffer. The sequence is a seqlock: odd while the span with ticket (sequence - 1) / 2 is written, then 2 * ticket + 2
+typedef struct JRPCSpanRecord {
+    _Atomic(uint64_t) sequence;
+    JRPCSpanData data;
+} JRPCSpanRecord;
+
+@interface JRPCTracer() {
+    JRPCSpanRecord *_records;
+    // The ticket of the next span written, which picks its slot
+    _Atomic(uint64_t) _nextTicket;
+    // Spans with earlier tickets were removed
+    _Atomic(uint64_t) _firstTicket;
+    _Atomic(uint32_t) _nextTrack;
+    _Atomic(double) _sampleRate;
+    mach_timebase_info_data_t _timebase;
+    // Added to a time in nanoseconds from mach_absolute_time() to give nanoseconds since 1970, for OTLP
+    int64_t _unixTimeOffset;
+}
+@end
+
+@implementation JRPCTracer
+
+- (instancetype) init {
+    return [self initWithCapacity:JRPC_TRACER_DEFAULT_CAPACITY];
+}
+
+- (instancetype) initWithCapacity:(NSUInteger)capacity {
+    if (0 == capacity) {
+        [NSException raise:NSInvalidArgumentException format:@"capacity MUST be greater than 0"];
+        return nil;
+    }
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _records = calloc(capacity, sizeof(JRPCSpanRecord));
+        for (NSUInteger i = 0; i < capacity; ++i) {
+            atomic_init(&_records[i].sequence, 0);
+        }
+        atomic_init(&_nextTicket, 0);
+        atomic_init(&_firstTicket, 0);
+        atomic_init(&_nextTrack, 1);
+        atomic_init(&_sampleRate, 1.0);
+        mach_timebase_info(&_timebase);
+        _unixTimeOffset = (int64_t)([[NSDate date] timeIntervalSince1970] * NSEC_PER_SEC) - (int64_t)[self nanosecondsWithTime:mach_absolute_time()];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    free(_records);
+}
+
+- (double) sampleRate {
+    return atomic_load_explicit(&_sampleRate, memory_order_relaxed);
+}
+
+- (void) setSampleRate:(double)sampleRate {
+    atomic_store_explicit(&_sampleRate, sampleRate, memory_order_relaxed);
+}
+
+- (uint64_t) nanosecondsWithTime:(uint64_t)time {
+    return time * _timebase.numer / _timebase.denom;
+}
+
+#pragma mark - Recording
+
+- (BOOL) sampleWithRate:(double)sampleRate {
+    if (sampleRate < 0) {
+        sampleRate = self.sampleRate;
+    }
+    if (sampleRate >= 1.0) {
+        return YES;
+    }
+    return sampleRate > 0 && arc4random() < (uint32_t)(sampleRate * UINT32_MAX);
+}
+
+- (uint64_t) newIdentifier {
+    uint64_t identifier = 0;
+    while (0 == identifier) {
+        arc4random_buf(&identifier, sizeof(identifier));
+    }
+    return identifier;
+}
+
+- (uint32_t) newTrack {
+    return atomic_fetch_add_explicit(&_nextTrack, 1, memory_order_relaxed);
+}
+
+- (void) recordSpan:(const JRPCSpan*)span {
+    uint64_t ticket = atomic_fetch_add_explicit(&_nextTicket, 1, memory_order_relaxed);
+    JRPCSpanRecord *record = &_records[ticket % _capacity];
+    // Marked as being written before the span is, so a reader copying it meanwhile discards its copy
+    atomic_store_explicit(&record->sequence, 2 * ticket + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    JRPCSpanData *data = &record->data;
+    strlcpy(data->name, span->name, sizeof(data->name));
+    data->kind = span->kind;
+    data->failed = span->failed;
+    data->track = span->track;
+    data->traceIdHigh = span->traceIdHigh;
+    data->traceIdLow = span->traceIdLow;
+    data->spanId = span->spanId;
+    data->parentSpanId = span->parentSpanId;
+    data->startTime = span->startTime;
+    data->endTime = span->endTime;
+    data->errorCode = span->errorCode;
+    atomic_store_explicit(&record->sequence, 2 * ticket + 2, memory_order_release);
+}
+
+- (void) removeAllSpans {
+    atomic_store_explicit(&_firstTicket, atomic_load_explicit(&_nextTicket, memory_order_relaxed), memory_order_relaxed);
+}
+
+#pragma mark - Export
+
+// Copies the spans kept, oldest first. Returns the number copied
+- (NSUInteger) copySpans:(JRPCSpanData *)spans {
+    uint64_t endTicket = atomic_load_explicit(&_nextTicket, memory_order_acquire);
+    uint64_t firstTicket = atomic_load_explicit(&_firstTicket, memory_order_relaxed);
+    if (endTicket > _capacity && endTicket - _capacity > firstTicket) {
+        firstTicket = endTicket - _capacity;
+    }
+    NSUInteger count = 0;
+    for (uint64_t ticket = firstTicket; ticket < endTicket; ++ticket) {
+        JRPCSpanRecord *record = &_records[ticket % _capacity];
+        uint64_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+        if (sequence != 2 * ticket + 2) {
+            // Still being written, or already overwritten by a later span
+            continue;
+        }
+        spans[count] = record->data;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&record->sequence, memory_order_relaxed) == sequence) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static NSString *JRPCHexIdentifier(uint64_t identifier) {
+    return [NSString stringWithFormat:@"%016llx", identifier];
+}
+
+// Names are truncated to fit their record, possibly within a UTF-8 sequence, so fall back to an encoding every byte string is valid in
+static NSString *JRPCSpanName(const JRPCSpanData *span) {
+    return [NSString stringWithUTF8String:span->name] ? : [NSString stringWithCString:span->name encoding:NSISOLatin1StringEncoding];
+}
+
+static NSString *JRPCHexTraceId(const JRPCSpanData *span) {
+    return [NSString stringWithFormat:@"%016llx%016llx", span->traceIdHigh, span->traceIdLow];
+}
+
+- (NSData*) dataWithFormat:(JRPCTraceFormat)format {
+    JRPCSpanData *spans = malloc(sizeof(JRPCSpanData) * _capacity);
+    NSUInteger count = [self copySpans:spans];
+    NSMutableArray *spanObjects = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; ++i) {
+        [spanObjects addObject:(JRPCTraceFormatOTLP == format) ? [self OTLPSpan:&spans[i]] : [self chromeEvent:&spans[i]]];
+    }
+    free(spans);
+    id trace = nil;
+    if (JRPCTraceFormatOTLP == format) {
+        trace = @{ @"resourceSpans" : @[ @{
+                           @"resource"   : @{ @"attributes" : @[ [self OTLPAttribute:@"service.name" value:[NSProcessInfo processInfo].processName] ] },
+                           @"scopeSpans" : @[ @{ @"scope" : @{ @"name" : @"JRPCProxy" }, @"spans" : spanObjects } ]
+                           } ] };
+    }
+    else {
+        trace = @{ @"traceEvents" : spanObjects, @"displayTimeUnit" : @"ms" };
+    }
+    return [NSJSONSerialization dataWithJSONObject:trace options:0 error:NULL];
+}
+
+- (BOOL) writeToURL:(NSURL*)url format:(JRPCTraceFormat)format error:(NSError**)error {
+    return [[self dataWithFormat:format] writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+- (NSDictionary*) chromeEvent:(const JRPCSpanData *)span {
+    NSMutableDictionary *args = [@{
+                                   @"traceId" : JRPCHexTraceId(span),
+                                   @"spanId"  : JRPCHexIdentifier(span->spanId)
+                                   } mutableCopy];
+    if (span->parentSpanId) {
+        args[@"parentSpanId"] = JRPCHexIdentifier(span->parentSpanId);
+    }
+    if (span->failed) {
+        args[@"error"] = @(span->errorCode);
+    }
+    // Complete events, timed in microseconds
+    uint64_t start = [self nanosecondsWithTime:span->startTime];
+    uint64_t end = [self nanosecondsWithTime:MAX(span->endTime, span->startTime)];
+    return @{
+             @"name" : JRPCSpanName(span),
+             @"cat"  : (JRPCSpanKindInternal == span->kind) ? @"phase" : (JRPCSpanKindServer == span->kind) ? @"server" : @"client",
+             @"ph"   : @"X",
+             @"ts"   : @(start / 1000.0),
+             @"dur"  : @((end - start) / 1000.0),
+             @"pid"  : @(getpid()),
+             @"tid"  : @(span->track),
+             @"args" : [args copy]
+             };
+}
+
+- (NSDictionary*) OTLPSpan:(const JRPCSpanData *)span {
+    NSMutableDictionary *otlpSpan = [@{
+                                       @"traceId"           : JRPCHexTraceId(span),
+                                       @"spanId"            : JRPCHexIdentifier(span->spanId),
+                                       @"name"              : JRPCSpanName(span),
+                                       @"kind"              : @(span->kind),
+                                       // 64 bit integers are strings in OTLP/JSON
+                                       @"startTimeUnixNano" : [self unixNanosecondsWithTime:span->startTime],
+                                       @"endTimeUnixNano"   : [self unixNanosecondsWithTime:MAX(span->endTime, span->startTime)]
+                                       } mutableCopy];
+    if (span->parentSpanId) {
+        otlpSpan[@"parentSpanId"] = JRPCHexIdentifier(span->parentSpanId);
+    }
+    if (JRPCSpanKindInternal != span->kind) {
+        otlpSpan[@"attributes"] = @[ [self OTLPAttribute:@"rpc.system" value:@"jsonrpc"], [self OTLPAttribute:@"rpc.method" value:JRPCSpanName(span)] ];
+    }
+    if (span->failed) {
+        // STATUS_CODE_ERROR
+        otlpSpan[@"status"] = @{ @"code" : @2, @"message" : [NSString stringWithFormat:@"%ld", (long)span->errorCode] };
+    }
+    return [otlpSpan copy];
+}
+
+- (NSDictionary*) OTLPAttribute:(NSString*)key value:(NSString*)value {
+    return @{ @"key" : key, @"value" : @{ @"stringValue" : value } };
+}
+
+- (NSString*) unixNanosecondsWithTime:(uint64_t)time {
+    return [NSString stringWithFormat:@"%lld", (long long)([self nanosecondsWithTime:time] + _unixTimeOffset)];
+}
+
+@end
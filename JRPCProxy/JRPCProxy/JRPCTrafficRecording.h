@@ -0,0 +1,114 @@
+//
+//  JRPCTrafficRecording.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** What a JRPCTrafficRecord records */
+typedef NS_ENUM(uint8_t, JRPCTrafficRecordKind) {
+    /** A single request & its response */
+    JRPCTrafficRecordKindRequest = 0,
+    /** A batch request & its response */
+    JRPCTrafficRecordKindBatch,
+    /** A notification, which has no response */
+    JRPCTrafficRecordKindNotification
+};
+
+/**
+ A request sent through a JRPCRecordingTransport, and the response it got. Immutable
+ */
+@interface JRPCTrafficRecord : NSObject
+
+/** What was sent */
+@property (nonatomic, readonly) JRPCTrafficRecordKind kind;
+
+/** When the request was sent, in seconds since recording started */
+@property (nonatomic, readonly) NSTimeInterval sentTime;
+
+/** The time from sending the request to its response or failure, in seconds. 0 for a notification */
+@property (nonatomic, readonly) NSTimeInterval latency;
+
+/** The JSON text of the request object, or of the array of them for a batch */
+@property (nonatomic, readonly) NSData *requestData;
+
+/** The JSON text of the response, as returned by the server. nil for a notification, or if the request failed */
+@property (nonatomic, readonly, nullable) NSData *responseData;
+
+/** The error the request failed with, or nil if it did not. Only the domain, code & localizedDescription are recorded */
+@property (nonatomic, readonly, nullable) NSError *error;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+/**
+ JRPCTrafficRecording reads a file written by JRPCRecordingTransport. The file is mapped rather than read, and records are read from it
+ in place as they are asked for, so recordings far larger than memory can be replayed. Records are in the order their responses arrived,
+ so are not sorted by sentTime. A file cut short while being written, e.g. by a crash, is read up to its last whole record
+ */
+@interface JRPCTrafficRecording : NSObject
+
+/**
+ Factory method to open a recording
+ @param url The URL of the file
+ @param error On return, the reason the file could not be opened: it could not be mapped, or is not a recording
+ @return An initialized recording, or nil on error
+ */
++ (nullable instancetype) recordingWithContentsOfURL:(NSURL*)url error:(NSError * _Nullable * _Nullable)error;
+
+/** When recording started */
+@property (nonatomic, readonly) NSDate *startDate;
+
+/** The number of records */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** The time from the start of recording to when the last request was sent, in seconds */
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+/**
+ Returns a record
+ @param index The index of the record, less than count. Raises NSRangeException otherwise
+ @return The record, whose data refers to the mapped file without copying it
+ */
+- (JRPCTrafficRecord*) recordAtIndex:(NSUInteger)index;
+
+/**
+ Calls a block with each record in turn
+ @param block The block, which may set *stop to YES to stop
+ */
+- (void) enumerateRecordsUsingBlock:(void (NS_NOESCAPE ^)(JRPCTrafficRecord *record, NSUInteger index, BOOL *stop))block;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,163 @@
+//
+//  JRPCTrafficRecording.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCTrafficRecording.h"
+#import "JRPCTrafficRecordFormat.h"
+
+@interface JRPCTrafficRecord()
+@property (nonatomic, assign) JRPCTrafficRecordKind kind;
+@property (nonatomic, assign) NSTimeInterval sentTime;
+@property (nonatomic, assign) NSTimeInterval latency;
+@property (nonatomic, strong) NSData *requestData;
+@property (nonatomic, strong) NSData *responseData;
+@property (nonatomic, strong) NSError *error;
+@end
+
+@implementation JRPCTrafficRecord
+@end
+
+@interface JRPCTrafficRecording() {
+    // The offset of each whole record in data
+    NSUInteger *_offsets;
+}
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDate *startDate;
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSTimeInterval duration;
+@end
+
+@implementation JRPCTrafficRecording
+
++ (instancetype) recordingWithContentsOfURL:(NSURL*)url error:(NSError**)error {
+    NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:error];
+    if (!data) {
+        return nil;
+    }
+    if (data.length < JRPC_TRAFFIC_FILE_HEADER_LENGTH || 0 != memcmp(data.bytes, JRPC_TRAFFIC_FILE_MAGIC, JRPC_TRAFFIC_FILE_MAGIC_LENGTH)) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError
+                                     userInfo:@{ NSURLErrorKey : url, NSLocalizedDescriptionKey : @"The file is not a traffic recording" }];
+        }
+        return nil;
+    }
+    return [[self alloc] initWithData:data];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithData:(NSData*)data {
+    self = [super init];
+    if (self) {
+        self.data = data;
+        uint64_t startTime;
+        memcpy(&startTime, (const uint8_t *)data.bytes + JRPC_TRAFFIC_FILE_MAGIC_LENGTH, 8);
+        self.startDate = [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)CFSwapInt64LittleToHost(startTime) / NSEC_PER_SEC];
+        [self indexRecords];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    free(_offsets);
+}
+
+- (void) indexRecords {
+    const uint8_t *bytes = self.data.bytes;
+    NSUInteger length = self.data.length;
+    NSUInteger capacity = 0;
+    NSUInteger count = 0;
+    uint64_t lastSentTime = 0;
+    NSUInteger offset = JRPC_TRAFFIC_FILE_HEADER_LENGTH;
+    while (offset + JRPC_TRAFFIC_RECORD_HEADER_LENGTH <= length) {
+        JRPCTrafficRecordHeader header;
+        JRPCTrafficRecordHeaderRead(&header, bytes + offset);
+        // Stop at the first record that is incomplete or does not add up, which can only be the end of a file cut short
+        if (header.length != JRPCTrafficRecordLength(header.requestLength, header.responseLength) ||
+            header.length > length - offset ||
+            header.kind > JRPCTrafficRecordKindNotification) {
+            break;
+        }
+        if (count == capacity) {
+            capacity = MAX(2 * capacity, 64);
+            _offsets = reallocf(_offsets, capacity * sizeof(NSUInteger));
+        }
+        _offsets[count++] = offset;
+        lastSentTime = MAX(lastSentTime, header.sentTime);
+        offset += header.length;
+    }
+    self.count = count;
+    self.duration = (NSTimeInterval)lastSentTime / NSEC_PER_SEC;
+}
+
+- (NSError*) errorWithData:(NSData*)data {
+    NSDictionary *errorObject = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    NSString *domain = [errorObject isKindOfClass:[NSDictionary class]] ? errorObject[kJRPCTrafficErrorDomainKey] : nil;
+    NSNumber *code = [errorObject isKindOfClass:[NSDictionary class]] ? errorObject[kJRPCTrafficErrorCodeKey] : nil;
+    NSString *message = [errorObject isKindOfClass:[NSDictionary class]] ? errorObject[kJRPCTrafficErrorMessageKey] : nil;
+    return [NSError errorWithDomain:[domain isKindOfClass:[NSString class]] ? domain : NSCocoaErrorDomain
+                               code:[code isKindOfClass:[NSNumber class]] ? code.integerValue : 0
+                           userInfo:[message isKindOfClass:[NSString class]] ? @{ NSLocalizedDescriptionKey : message } : nil];
+}
+
+#pragma mark - Public
+
+- (JRPCTrafficRecord*) recordAtIndex:(NSUInteger)index {
+    if (index >= self.count) {
+        [NSException raise:NSRangeException format:@"index %lu beyond bounds of %lu records", (unsigned long)index, (unsigned long)self.count];
+    }
+    NSUInteger offset = _offsets[index];
+    JRPCTrafficRecordHeader header;
+    JRPCTrafficRecordHeaderRead(&header, (const uint8_t *)self.data.bytes + offset);
+    JRPCTrafficRecord *record = [[JRPCTrafficRecord alloc] init];
+    record.kind = header.kind;
+    record.sentTime = (NSTimeInterval)header.sentTime / NSEC_PER_SEC;
+    record.latency = (NSTimeInterval)header.latency / NSEC_PER_SEC;
+    // Subdata of mapped data refers to the same pages
+    NSUInteger requestOffset = offset + JRPC_TRAFFIC_RECORD_HEADER_LENGTH;
+    record.requestData = [self.data subdataWithRange:NSMakeRange(requestOffset, header.requestLength)];
+    NSData *responseData = [self.data subdataWithRange:NSMakeRange(requestOffset + header.requestLength, header.responseLength)];
+    if (header.flags & JRPC_TRAFFIC_RECORD_FLAG_FAILED) {
+        record.error = [self errorWithData:responseData];
+    } else if (JRPCTrafficRecordKindNotification != header.kind) {
+        record.responseData = responseData;
+    }
+    return record;
+}
+
+- (void) enumerateRecordsUsingBlock:(void (NS_NOESCAPE ^)(JRPCTrafficRecord *record, NSUInteger index, BOOL *stop))block {
+    BOOL stop = NO;
+    for (NSUInteger i = 0; i < self.count && !stop; ++i) {
+        @autoreleasepool {
+            block([self recordAtIndex:i], i, &stop);
+        }
+    }
+}
+
+@end
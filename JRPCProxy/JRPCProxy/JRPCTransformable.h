@@ -32,6 +32,7 @@
 /**
  JRPCTransformable defines the methods that allow a client to extend support of custom types to JSON-RPC or modify the existing behaviour for supported types.
  You would typically add support to existing types by implementing a category/extension to conform to this protocol. or conform to it in your own custom types.
+ JRPCDispatcher uses the same methods the other way round: initWithJSONRPCResponseResult: to create params, and jsonRPCRequestRepresentation for results.
  */
 @protocol JRPCTransformable <NSObject>
 
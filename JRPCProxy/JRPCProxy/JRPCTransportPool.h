@@ -0,0 +1,103 @@
+//
+//  JRPCTransportPool.h
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+@import Foundation;
+#import "JRPCProxyTransport.h"
+#import "JRPCCodec.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Statistics for one transport of a JRPCTransportPool, see statisticsForTransportAtIndex:
+ */
+typedef struct JRPCTransportPoolStatistics {
+    /** Requests sent to the transport and not yet completed */
+    NSUInteger outstandingCount;
+    /** Requests sent to the transport, including hedged duplicates */
+    NSUInteger sentCount;
+    /** Hedged duplicates sent to the transport */
+    NSUInteger hedgedCount;
+    /** Requests the transport failed */
+    NSUInteger errorCount;
+    /** The exponentially weighted moving average latency of the transport's responses, in seconds. 0 until the first response */
+    NSTimeInterval latency;
+    /** The exponentially weighted moving average of the transport's failures, from 0 (none recently) to 1 (all recently) */
+    double errorRate;
+} JRPCTransportPoolStatistics;
+
+/**
+ JRPCTransportPool is a JRPCProxyTransport that spreads requests over several child transports, e.g. one per backend endpoint
+ @discussion Each request is sent to the child with the fewest requests outstanding. Ties go to the child with the lower error rate, then the lower latency,
+ so a failing or slow endpoint is used less while others are free. Batches are sent to a single child, and notifications to the least busy.
+ Requests to idempotent methods (see idempotentMethodNames) may also be hedged: if the first child has not responded within the 95th percentile
+ latency of recent responses, the request is sent to a second child too, the first successful response is passed to the proxy, and the other child
+ told to cancel. A transport error is only passed on once no other child is still working on the request.
+ The pool performs serialization if all of its children do, and otherwise all must accept raw data, which the pool decodes with the codec in use
+ to read each request's id & method. The batch & notification methods are only used if all children implement them. All methods are thread safe
+ */
+@interface JRPCTransportPool : NSObject <JRPCProxyTransport>
+
+/**
+ Factory method to create a pool of transports
+ @param transports The child transports, at least one. Raises NSInvalidArgumentException if they do not all perform serialization, and do not all accept raw data
+ @return An initialized pool
+ */
++ (instancetype) poolWithTransports:(NSArray<id<JRPCProxyTransport>>*)transports;
+
+/** The child transports */
+@property (nonatomic, readonly, copy) NSArray<id<JRPCProxyTransport>> *transports;
+
+/**
+ The codecs the pool can read requests in, when its children accept raw data. Defaults to a JRPCJSONCodec and a JRPCMessagePackCodec
+ The pool's supportedCodecNames are those of these codecs that every child supports
+ */
+@property (atomic, copy) NSArray<id<JRPCCodec>> *codecs;
+
+/** The names of the JSON-RPC methods that are safe to send more than once, and so may be hedged. Empty by default */
+@property (atomic, copy) NSSet<NSString*> *idempotentMethodNames;
+
+/** If YES, requests to idempotent methods are hedged once the latency of enough responses has been seen. Defaults to NO */
+@property (atomic, assign) BOOL hedgesRequests;
+
+/** The time after which an idempotent request is hedged: the 95th percentile latency of recent responses, or 0 until enough have been seen */
+@property (nonatomic, readonly) NSTimeInterval hedgeDelay;
+
+/**
+ Returns the statistics of a child transport
+ @param index The index of the transport in transports
+ */
+- (JRPCTransportPoolStatistics) statisticsForTransportAtIndex:(NSUInteger)index;
+
+/** init is unavailable */
+- (instancetype) init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,553 @@
+//
+//  JRPCTransportPool.m
+//  JRPCProxy
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCTransportPool.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+#import "JRPCJSONReader.h"
+#import "NSDictionary+JSONRPC.h"
+#import <objc/runtime.h>
+#import <pthread.h>
+
+// The weight of each new response in the moving averages of latency & errors
+#define JRPC_POOL_EWMA_WEIGHT 0.1
+// The number of recent latencies the hedge delay is taken from
+#define JRPC_POOL_LATENCY_SAMPLE_COUNT 256
+// The number of responses seen before requests are hedged, so the hedge delay means something
+#define JRPC_POOL_MIN_HEDGE_SAMPLE_COUNT 20
+// The hedge delay is recomputed after this many responses
+#define JRPC_POOL_HEDGE_DELAY_INTERVAL 16
+// Error rates closer than this are treated as equal when choosing a child
+#define JRPC_POOL_ERROR_RATE_TOLERANCE 0.01
+
+static const char *JSON_RPC_POOL_QUEUE_NAME = "JRPCTransportPoolQueue";
+
+/** What a request from the proxy is, and so which child method sends it */
+typedef NS_ENUM(NSUInteger, JRPCTransportPoolRequestKind) {
+    JRPCTransportPoolRequestKindObject = 0,
+    JRPCTransportPoolRequestKindData,
+    JRPCTransportPoolRequestKindBatchObjects,
+    JRPCTransportPoolRequestKindBatchData
+};
+
+/** One send of a request to a child transport */
+@interface JRPCTransportPoolAttempt : NSObject
+@property (nonatomic, assign) NSUInteger transportIndex;
+@property (nonatomic, assign) CFAbsoluteTime startTime;
+// Completed, or cancelled on the child, so its outstanding count no longer includes it
+@property (nonatomic, assign) BOOL finished;
+@end
+
+@implementation JRPCTransportPoolAttempt
+@end
+
+/** A request from the proxy, and the attempts made to send it. Guarded by the pool's lock */
+@interface JRPCTransportPoolRequest : NSObject
+@property (nonatomic, assign) JRPCTransportPoolRequestKind kind;
+@property (nonatomic, strong) id payload;
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@property (nonatomic, copy) void (^completion)(id response, NSError *error);
+// The method name of a single request, if it could be read
+@property (nonatomic, copy) NSString *methodName;
+// The ids of the calls in the request not yet cancelled
+@property (nonatomic, strong) NSMutableArray *requestIds;
+@property (nonatomic, strong) NSMutableArray<JRPCTransportPoolAttempt*> *attempts;
+// The proxy's completion has been called, or every call cancelled
+@property (nonatomic, assign) BOOL completed;
+@end
+
+@implementation JRPCTransportPoolRequest
+@end
+
+// Reads the id, and if wanted the method name, of the JSON-RPC request object in range without decoding the rest of it
+static void JRPCTransportPoolScanRequest(NSData *data, NSRange range, JRPCTransportPoolRequest *request, BOOL readsMethodName) {
+    JRPCJSONResponseEnvelope envelope;
+    if (!JRPCJSONScanResponseEnvelope(data, range, &envelope)) {
+        return;
+    }
+    id requestId = (NSNotFound != envelope.requestId.location) ? JRPCJSONRequestIdInRange(data, envelope.requestId) : nil;
+    if (requestId) {
+        [request.requestIds addObject:requestId];
+    }
+    if (readsMethodName && NSNotFound != envelope.method.location) {
+        id methodName = JRPCJSONObjectInRange(data, envelope.method, NULL);
+        request.methodName = [methodName isKindOfClass:[NSString class]] ? methodName : nil;
+    }
+}
+
+static int JRPCCompareTimeIntervals(const void *a, const void *b) {
+    NSTimeInterval lhs = *(const NSTimeInterval *)a;
+    NSTimeInterval rhs = *(const NSTimeInterval *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// YES if a child with statistics a should be sent a request rather than one with statistics b
+static BOOL JRPCTransportPoolPrefers(const JRPCTransportPoolStatistics *a, const JRPCTransportPoolStatistics *b) {
+    if (a->outstandingCount != b->outstandingCount) {
+        return a->outstandingCount < b->outstandingCount;
+    }
+    if (fabs(a->errorRate - b->errorRate) > JRPC_POOL_ERROR_RATE_TOLERANCE) {
+        return a->errorRate < b->errorRate;
+    }
+    return a->latency < b->latency;
+}
+
+@interface JRPCTransportPool() {
+    pthread_mutex_t _lock;
+    // Indexed as transports, guarded by _lock
+    JRPCTransportPoolStatistics *_statistics;
+    BOOL *_supportsCancellation;
+    BOOL _supportsAnyCancellation;
+    // A ring of the latencies of recent single requests, guarded by _lock
+    NSTimeInterval _latencySamples[JRPC_POOL_LATENCY_SAMPLE_COUNT];
+    NSUInteger _latencySampleCount;
+    NSTimeInterval _hedgeDelay;
+    // Where the search for the least busy child starts, so exact ties take turns
+    NSUInteger _nextTransportIndex;
+}
+@property (nonatomic, copy) NSArray<id<JRPCProxyTransport>> *transports;
+@property (nonatomic, assign) BOOL performsSerialization;
+@property (nonatomic, assign) BOOL supportsBatches;
+@property (nonatomic, assign) BOOL supportsNotifications;
+// Hedge timers fire on this queue
+@property (nonatomic, strong) dispatch_queue_t queue;
+// Request id => the request holding it, guarded by _lock
+@property (nonatomic, strong) NSMutableDictionary<id, JRPCTransportPoolRequest*> *pendingRequests;
+@property (atomic, strong) id<JRPCCodec> usedCodec;
+@end
+
+@implementation JRPCTransportPool
+
++ (instancetype) poolWithTransports:(NSArray<id<JRPCProxyTransport>>*)transports {
+    return [[self alloc] initWithTransports:transports];
+}
+
+#pragma mark - Private
+
+- (instancetype) initWithTransports:(NSArray<id<JRPCProxyTransport>>*)transports {
+    self = [super init];
+    if (self) {
+        if (0 == transports.count) {
+            [NSException raise:NSInvalidArgumentException format:@"transports MUST contain at least one transport"];
+        }
+        self.performsSerialization = [self allTransports:transports respondToSelector:@selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:)];
+        if (!self.performsSerialization &&
+            ![self allTransports:transports respondToSelector:@selector(sendJSONRPCPayloadWithRequestData:completionQueue:completion:)]) {
+            [NSException raise:NSInvalidArgumentException format:@"transports MUST all perform serialization, or all accept raw data"];
+        }
+        self.supportsBatches = self.performsSerialization ?
+            [self allTransports:transports respondToSelector:@selector(sendJSONRPCBatchPayloadWithRequestObjects:completionQueue:completion:)] :
+            [self allTransports:transports respondToSelector:@selector(sendJSONRPCBatchPayloadWithRequestData:completionQueue:completion:)];
+        self.supportsNotifications = self.performsSerialization ?
+            [self allTransports:transports respondToSelector:@selector(sendJSONRPCNotificationWithRequestObject:)] :
+            [self allTransports:transports respondToSelector:@selector(sendJSONRPCNotificationWithRequestData:)];
+        self.transports = transports;
+        pthread_mutex_init(&_lock, NULL);
+        _statistics = calloc(transports.count, sizeof(JRPCTransportPoolStatistics));
+        _supportsCancellation = calloc(transports.count, sizeof(BOOL));
+        for (NSUInteger i = 0; i < transports.count; ++i) {
+            _supportsCancellation[i] = [transports[i] respondsToSelector:@selector(cancelJSONRPCRequestWithId:)];
+            _supportsAnyCancellation = _supportsAnyCancellation || _supportsCancellation[i];
+        }
+        self.queue = dispatch_queue_create(JSON_RPC_POOL_QUEUE_NAME, DISPATCH_QUEUE_CONCURRENT);
+        self.pendingRequests = [[NSMutableDictionary alloc] init];
+        self.codecs = @[ [[JRPCJSONCodec alloc] init], [[JRPCMessagePackCodec alloc] init] ];
+        self.usedCodec = self.codecs[0];
+        self.idempotentMethodNames = [NSSet set];
+    }
+    return self;
+}
+
+- (void) dealloc {
+    pthread_mutex_destroy(&_lock);
+    free(_statistics);
+    free(_supportsCancellation);
+}
+
+- (BOOL) allTransports:(NSArray<id<JRPCProxyTransport>>*)transports respondToSelector:(SEL)selector {
+    for (id<JRPCProxyTransport> transport in transports) {
+        if (![transport respondsToSelector:selector]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (BOOL) respondsToSelector:(SEL)aSelector {
+    // The proxy chooses how to call the pool by the methods it responds to, so only claim those every child implements
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:))) {
+        return self.performsSerialization;
+    }
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestObjects:completionQueue:completion:))) {
+        return self.performsSerialization && self.supportsBatches;
+    }
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestData:completionQueue:completion:))) {
+        return !self.performsSerialization && self.supportsBatches;
+    }
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestObject:))) {
+        return self.performsSerialization && self.supportsNotifications;
+    }
+    if (sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestData:))) {
+        return !self.performsSerialization && self.supportsNotifications;
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+#pragma mark - Routing (called with _lock held)
+
+// Returns the index of the least busy child other than excludedIndex, or NSNotFound if there is none
+- (NSUInteger) leastBusyTransportIndexExcluding:(NSUInteger)excludedIndex {
+    NSUInteger count = self.transports.count;
+    NSUInteger start = _nextTransportIndex++ % count;
+    NSUInteger bestIndex = NSNotFound;
+    for (NSUInteger i = 0; i < count; ++i) {
+        NSUInteger index = (start + i) % count;
+        if (index != excludedIndex &&
+            (NSNotFound == bestIndex || JRPCTransportPoolPrefers(&_statistics[index], &_statistics[bestIndex]))) {
+            bestIndex = index;
+        }
+    }
+    return bestIndex;
+}
+
+- (JRPCTransportPoolAttempt*) addAttemptToRequest:(JRPCTransportPoolRequest*)request transportIndex:(NSUInteger)transportIndex {
+    JRPCTransportPoolAttempt *attempt = [[JRPCTransportPoolAttempt alloc] init];
+    attempt.transportIndex = transportIndex;
+    attempt.startTime = CFAbsoluteTimeGetCurrent();
+    [request.attempts addObject:attempt];
+    _statistics[transportIndex].outstandingCount++;
+    _statistics[transportIndex].sentCount++;
+    return attempt;
+}
+
+- (BOOL) shouldHedgeRequest:(JRPCTransportPoolRequest*)request {
+    return self.hedgesRequests &&
+        self.transports.count > 1 &&
+        _latencySampleCount >= JRPC_POOL_MIN_HEDGE_SAMPLE_COUNT &&
+        1 == request.requestIds.count &&
+        request.methodName &&
+        [self.idempotentMethodNames containsObject:request.methodName];
+}
+
+- (void) recordAttempt:(JRPCTransportPoolAttempt*)attempt ofRequest:(JRPCTransportPoolRequest*)request failed:(BOOL)failed {
+    JRPCTransportPoolStatistics *statistics = &_statistics[attempt.transportIndex];
+    statistics->outstandingCount--;
+    statistics->errorRate += JRPC_POOL_EWMA_WEIGHT * ((failed ? 1.0 : 0.0) - statistics->errorRate);
+    if (failed) {
+        statistics->errorCount++;
+        return;
+    }
+    NSTimeInterval latency = CFAbsoluteTimeGetCurrent() - attempt.startTime;
+    statistics->latency = (0 == statistics->latency) ? latency : statistics->latency + JRPC_POOL_EWMA_WEIGHT * (latency - statistics->latency);
+    // Batches take longer than single requests, so are not counted towards the hedge delay
+    if (JRPCTransportPoolRequestKindObject != request.kind && JRPCTransportPoolRequestKindData != request.kind) {
+        return;
+    }
+    _latencySamples[_latencySampleCount % JRPC_POOL_LATENCY_SAMPLE_COUNT] = latency;
+    _latencySampleCount++;
+    if (_latencySampleCount >= JRPC_POOL_MIN_HEDGE_SAMPLE_COUNT &&
+        (0 == _hedgeDelay || 0 == _latencySampleCount % JRPC_POOL_HEDGE_DELAY_INTERVAL)) {
+        NSUInteger count = MIN(_latencySampleCount, JRPC_POOL_LATENCY_SAMPLE_COUNT);
+        NSTimeInterval sorted[JRPC_POOL_LATENCY_SAMPLE_COUNT];
+        memcpy(sorted, _latencySamples, count * sizeof(NSTimeInterval));
+        qsort(sorted, count, sizeof(NSTimeInterval), JRPCCompareTimeIntervals);
+        _hedgeDelay = sorted[(NSUInteger)ceil(0.95 * count) - 1];
+    }
+}
+
+// Returns the unfinished attempts of a request whose child can be told to cancel. If finish is YES they are finished, freeing their slots
+- (NSArray<JRPCTransportPoolAttempt*>*) cancellableAttemptsOfRequest:(JRPCTransportPoolRequest*)request finish:(BOOL)finish {
+    NSMutableArray<JRPCTransportPoolAttempt*> *attempts = [[NSMutableArray alloc] init];
+    for (JRPCTransportPoolAttempt *attempt in request.attempts) {
+        if (!attempt.finished && _supportsCancellation[attempt.transportIndex]) {
+            if (finish) {
+                attempt.finished = YES;
+                _statistics[attempt.transportIndex].outstandingCount--;
+            }
+            [attempts addObject:attempt];
+        }
+    }
+    return attempts;
+}
+
+- (BOOL) hasUnfinishedAttempts:(JRPCTransportPoolRequest*)request {
+    for (JRPCTransportPoolAttempt *attempt in request.attempts) {
+        if (!attempt.finished) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+#pragma mark - Sending
+
+// Reads the ids & method name of a request, for cancellation & hedging, when either could need them
+- (JRPCTransportPoolRequest*) requestWithKind:(JRPCTransportPoolRequestKind)kind
+                                      payload:(id)payload
+                              completionQueue:(dispatch_queue_t)completionQueue
+                                   completion:(void (^)(id response, NSError *error))completion {
+    JRPCTransportPoolRequest *request = [[JRPCTransportPoolRequest alloc] init];
+    request.kind = kind;
+    request.payload = payload;
+    request.completionQueue = completionQueue;
+    request.completion = completion;
+    request.requestIds = [[NSMutableArray alloc] init];
+    request.attempts = [[NSMutableArray alloc] initWithCapacity:1];
+    BOOL hedges = self.hedgesRequests && self.transports.count > 1;
+    if (!hedges && !_supportsAnyCancellation) {
+        return request;
+    }
+    BOOL isData = (JRPCTransportPoolRequestKindData == kind || JRPCTransportPoolRequestKindBatchData == kind);
+    if (isData && [self.usedCodec.name isEqualToString:JRPCCodecNameJSON]) {
+        // Batches are never hedged, so only single requests need a method name
+        BOOL readsMethodName = hedges && JRPCTransportPoolRequestKindData == kind && self.idempotentMethodNames.count > 0;
+        if (JRPCTransportPoolRequestKindData == kind) {
+            JRPCTransportPoolScanRequest(payload, NSMakeRange(0, [payload length]), request, readsMethodName);
+        } else {
+            JRPCJSONScanArray(payload, ^(NSRange elementRange) {
+                JRPCTransportPoolScanRequest(payload, elementRange, request, NO);
+            });
+        }
+        return request;
+    }
+    id jsonObject = payload;
+    if (isData) {
+        // Other codecs have no scanner, so are decoded
+        jsonObject = [self.usedCodec decodeData:payload error:nil];
+    }
+    NSArray *jsonRPCRequests = [jsonObject isKindOfClass:[NSArray class]] ? jsonObject : (jsonObject ? @[ jsonObject ] : @[]);
+    for (NSDictionary *jsonRPCRequest in jsonRPCRequests) {
+        id requestId = [jsonRPCRequest isKindOfClass:[NSDictionary class]] ? jsonRPCRequest.jsonRPC_requestId : nil;
+        if (requestId) {
+            [request.requestIds addObject:requestId];
+        }
+    }
+    if ([jsonObject isKindOfClass:[NSDictionary class]]) {
+        request.methodName = ((NSDictionary*)jsonObject).jsonRPC_methodName;
+    }
+    return request;
+}
+
+- (void) sendRequest:(JRPCTransportPoolRequest*)request {
+    pthread_mutex_lock(&_lock);
+    JRPCTransportPoolAttempt *attempt = [self addAttemptToRequest:request transportIndex:[self leastBusyTransportIndexExcluding:NSNotFound]];
+    for (id requestId in request.requestIds) {
+        self.pendingRequests[requestId] = request;
+    }
+    NSTimeInterval hedgeDelay = [self shouldHedgeRequest:request] ? _hedgeDelay : 0;
+    pthread_mutex_unlock(&_lock);
+    [self sendAttempt:attempt ofRequest:request];
+    if (hedgeDelay > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(hedgeDelay * NSEC_PER_SEC)), self.queue, ^{
+            [self hedgeRequest:request];
+        });
+    }
+}
+
+- (void) hedgeRequest:(JRPCTransportPoolRequest*)request {
+    pthread_mutex_lock(&_lock);
+    if (request.completed || request.attempts.count > 1) {
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    NSUInteger transportIndex = [self leastBusyTransportIndexExcluding:request.attempts[0].transportIndex];
+    JRPCTransportPoolAttempt *attempt = [self addAttemptToRequest:request transportIndex:transportIndex];
+    _statistics[transportIndex].hedgedCount++;
+    pthread_mutex_unlock(&_lock);
+    [self sendAttempt:attempt ofRequest:request];
+}
+
+- (void) sendAttempt:(JRPCTransportPoolAttempt*)attempt ofRequest:(JRPCTransportPoolRequest*)request {
+    id<JRPCProxyTransport> transport = self.transports[attempt.transportIndex];
+    void (^completion)(id, NSError*) = ^(id response, NSError *error) {
+        [self attempt:attempt ofRequest:request completedWithResponse:response error:error];
+    };
+    // Children call back on the proxy's completion queue, so the winning response is passed on without another dispatch
+    switch (request.kind) {
+        case JRPCTransportPoolRequestKindObject:
+            [transport sendJSONRPCPayloadWithRequestObject:request.payload completionQueue:request.completionQueue completion:completion];
+            break;
+        case JRPCTransportPoolRequestKindData:
+            [transport sendJSONRPCPayloadWithRequestData:request.payload completionQueue:request.completionQueue completion:completion];
+            break;
+        case JRPCTransportPoolRequestKindBatchObjects:
+            [transport sendJSONRPCBatchPayloadWithRequestObjects:request.payload completionQueue:request.completionQueue completion:completion];
+            break;
+        case JRPCTransportPoolRequestKindBatchData:
+            [transport sendJSONRPCBatchPayloadWithRequestData:request.payload completionQueue:request.completionQueue completion:completion];
+            break;
+    }
+}
+
+- (void) attempt:(JRPCTransportPoolAttempt*)attempt
+       ofRequest:(JRPCTransportPoolRequest*)request
+completedWithResponse:(id)response
+           error:(NSError*)error {
+    NSArray<JRPCTransportPoolAttempt*> *cancelledAttempts = nil;
+    pthread_mutex_lock(&_lock);
+    if (attempt.finished) {
+        // Cancelled on its child, which replied anyway
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    attempt.finished = YES;
+    [self recordAttempt:attempt ofRequest:request failed:(nil != error)];
+    // The first success wins. A failure only completes the request once no other child is still working on it
+    BOOL completes = !request.completed && (!error || ![self hasUnfinishedAttempts:request]);
+    if (completes) {
+        request.completed = YES;
+        for (id requestId in request.requestIds) {
+            if (self.pendingRequests[requestId] == request) {
+                [self.pendingRequests removeObjectForKey:requestId];
+            }
+        }
+        cancelledAttempts = [self cancellableAttemptsOfRequest:request finish:YES];
+    }
+    pthread_mutex_unlock(&_lock);
+    [self cancelRequestIds:request.requestIds onAttempts:cancelledAttempts];
+    if (completes) {
+        request.completion(response, error);
+    }
+}
+
+- (void) cancelRequestIds:(NSArray*)requestIds onAttempts:(NSArray<JRPCTransportPoolAttempt*>*)attempts {
+    for (JRPCTransportPoolAttempt *attempt in attempts) {
+        id<JRPCProxyTransport> transport = self.transports[attempt.transportIndex];
+        for (id requestId in requestIds) {
+            [transport cancelJSONRPCRequestWithId:requestId];
+        }
+    }
+}
+
+- (id<JRPCProxyTransport>) leastBusyTransport {
+    pthread_mutex_lock(&_lock);
+    NSUInteger transportIndex = [self leastBusyTransportIndexExcluding:NSNotFound];
+    pthread_mutex_unlock(&_lock);
+    return self.transports[transportIndex];
+}
+
+#pragma mark - Public
+
+- (NSTimeInterval) hedgeDelay {
+    pthread_mutex_lock(&_lock);
+    NSTimeInterval hedgeDelay = (_latencySampleCount >= JRPC_POOL_MIN_HEDGE_SAMPLE_COUNT) ? _hedgeDelay : 0;
+    pthread_mutex_unlock(&_lock);
+    return hedgeDelay;
+}
+
+- (JRPCTransportPoolStatistics) statisticsForTransportAtIndex:(NSUInteger)index {
+    if (index >= self.transports.count) {
+        [NSException raise:NSRangeException format:@"index %lu beyond bounds of %lu transports", (unsigned long)index, (unsigned long)self.transports.count];
+    }
+    pthread_mutex_lock(&_lock);
+    JRPCTransportPoolStatistics statistics = _statistics[index];
+    pthread_mutex_unlock(&_lock);
+    return statistics;
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestObject:(NSDictionary*)jsonRPCRequest
+                             completionQueue:(dispatch_queue_t)completionQueue
+                                  completion:(JRPCTransportObjectCompletion)completion {
+    [self sendRequest:[self requestWithKind:JRPCTransportPoolRequestKindObject payload:jsonRPCRequest completionQueue:completionQueue completion:completion]];
+}
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    [self sendRequest:[self requestWithKind:JRPCTransportPoolRequestKindData payload:payload completionQueue:completionQueue completion:completion]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestObjects:(NSArray<NSDictionary*>*)jsonRPCRequests
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportBatchObjectCompletion)completion {
+    [self sendRequest:[self requestWithKind:JRPCTransportPoolRequestKindBatchObjects payload:jsonRPCRequests completionQueue:completionQueue completion:completion]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    [self sendRequest:[self requestWithKind:JRPCTransportPoolRequestKindBatchData payload:payload completionQueue:completionQueue completion:completion]];
+}
+
+- (void) sendJSONRPCNotificationWithRequestObject:(NSDictionary*)jsonRPCNotification {
+    [[self leastBusyTransport] sendJSONRPCNotificationWithRequestObject:jsonRPCNotification];
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    [[self leastBusyTransport] sendJSONRPCNotificationWithRequestData:payload];
+}
+
+- (void) cancelJSONRPCRequestWithId:(id)requestId {
+    NSArray<JRPCTransportPoolAttempt*> *cancelledAttempts = nil;
+    pthread_mutex_lock(&_lock);
+    JRPCTransportPoolRequest *request = self.pendingRequests[requestId];
+    if (request) {
+        [self.pendingRequests removeObjectForKey:requestId];
+        [request.requestIds removeObject:requestId];
+        // The children of a batch go on with its other calls, so only finish its attempts once every call is cancelled
+        BOOL finish = (0 == request.requestIds.count);
+        request.completed = request.completed || finish;
+        cancelledAttempts = [self cancellableAttemptsOfRequest:request finish:finish];
+    }
+    pthread_mutex_unlock(&_lock);
+    [self cancelRequestIds:@[ requestId ] onAttempts:cancelledAttempts];
+}
+
+- (NSArray<NSString*>*) supportedCodecNames {
+    NSMutableArray<NSString*> *names = [[NSMutableArray alloc] init];
+    for (id<JRPCCodec> codec in self.codecs) {
+        BOOL supported = YES;
+        for (id<JRPCProxyTransport> transport in self.transports) {
+            NSArray<NSString*> *transportCodecNames = [transport respondsToSelector:@selector(supportedCodecNames)] ? transport.supportedCodecNames : @[ JRPCCodecNameJSON ];
+            supported = supported && [transportCodecNames containsObject:codec.name];
+        }
+        if (supported) {
+            [names addObject:codec.name];
+        }
+    }
+    return [names copy];
+}
+
+- (void) useCodecWithName:(NSString*)name {
+    for (id<JRPCCodec> codec in self.codecs) {
+        if ([codec.name isEqualToString:name]) {
+            self.usedCodec = codec;
+        }
+    }
+    for (id<JRPCProxyTransport> transport in self.transports) {
+        if ([transport respondsToSelector:@selector(useCodecWithName:)]) {
+            [transport useCodecWithName:name];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  JRPCBenchmarkMeasurement.h
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Process level measurements used by the benchmarks
+ */
+
+/**
+ Installs a malloc logger that counts every heap allocation made by the process, on any thread.
+ Any logger already installed (e.g. by MallocStackLogging) continues to be called. Safe to call more than once
+ */
+extern void JRPCBenchmarkStartCountingAllocations(void);
+
+/** The number of heap allocations made since JRPCBenchmarkStartCountingAllocations() was first called */
+extern uint64_t JRPCBenchmarkAllocationCount(void);
+
+/** The peak resident set size of the process, in bytes */
+extern uint64_t JRPCBenchmarkPeakResidentSize(void);
+
+/** Converts an interval in mach_absolute_time() ticks to nanoseconds */
+extern double JRPCBenchmarkNanosecondsWithTicks(uint64_t ticks);
@@ -0,0 +1,89 @@
+//
+//  JRPCBenchmarkMeasurement.m
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCBenchmarkMeasurement.h"
+#import <mach/mach_time.h>
+#import <sys/resource.h>
+#import <stdatomic.h>
+
+/*
+ libmalloc calls malloc_logger, when set, for every allocation & deallocation. It is what MallocStackLogging is built on.
+ The flags below match those in libmalloc's private headers
+ */
+typedef void (JRPCMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern JRPCMallocLogger *malloc_logger;
+
+#define JRPC_MALLOC_LOG_TYPE_ALLOCATE 2
+
+static JRPCMallocLogger *previousMallocLogger;
+static atomic_uint_fast64_t allocationCount;
+
+static void JRPCBenchmarkMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    // realloc is logged as both an allocation & a deallocation
+    if (type & JRPC_MALLOC_LOG_TYPE_ALLOCATE) {
+        atomic_fetch_add_explicit(&allocationCount, 1, memory_order_relaxed);
+    }
+    if (previousMallocLogger) {
+        previousMallocLogger(type, arg1, arg2, arg3, result, numHotFramesToSkip + 1);
+    }
+}
+
+void JRPCBenchmarkStartCountingAllocations(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        previousMallocLogger = malloc_logger;
+        malloc_logger = JRPCBenchmarkMallocLogger;
+    });
+}
+
+uint64_t JRPCBenchmarkAllocationCount(void) {
+    return atomic_load_explicit(&allocationCount, memory_order_relaxed);
+}
+
+uint64_t JRPCBenchmarkPeakResidentSize(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss;
+#else
+    // Kilobytes everywhere else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+double JRPCBenchmarkNanosecondsWithTicks(uint64_t ticks) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return (double)ticks * timebase.numer / timebase.denom;
+}
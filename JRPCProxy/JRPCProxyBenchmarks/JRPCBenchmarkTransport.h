@@ -0,0 +1,57 @@
+//
+//  JRPCBenchmarkTransport.h
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTransport.h"
+
+/**
+ JRPCBenchmarkTransport is a zero latency JRPCProxyTransport that echoes the first param of every request back as its result.
+ It is a lean variant of JRPCProxyTransportStub: nothing is logged or recorded, and each response is dispatched straight to the completion queue.
+ The time & allocations spent inside the transport are measured, so they can be separated from the proxy's own
+ */
+@interface JRPCBenchmarkTransport : NSObject <JRPCProxyTransport>
+
+/**
+ If YES, the proxy passes request objects and the transport returns response objects, as a transport performing JSON serialization would.
+ If NO, the transport decodes the serialized request and encodes the response with NSJSONSerialization. Set before the proxy is created
+ */
+@property (nonatomic, assign) BOOL performsSerialization;
+
+/** The mach_absolute_time() at which the most recent request reached the transport */
+@property (nonatomic, readonly) uint64_t lastRequestTime;
+
+/** The mach_absolute_time() at which the transport dispatched the most recent response to the completion queue */
+@property (nonatomic, readonly) uint64_t lastResponseTime;
+
+/** The number of heap allocations made inside the transport since the last reset. See JRPCBenchmarkAllocationCount() */
+@property (nonatomic, readonly) uint64_t allocationCount;
+
+/** Resets allocationCount */
+- (void) resetAllocationCount;
+
+@end
@@ -0,0 +1,97 @@
+//
+//  JRPCBenchmarkTransport.m
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCBenchmarkTransport.h"
+#import "JRPCBenchmarkMeasurement.h"
+#import "NSDictionary+JSONRPC.h"
+#import <mach/mach_time.h>
+
+static const NSString * const kJSONRPCVersion = @"2.0";
+
+@interface JRPCBenchmarkTransport()
+@property (nonatomic, assign) uint64_t lastRequestTime;
+@property (nonatomic, assign) uint64_t lastResponseTime;
+@property (nonatomic, assign) uint64_t allocationCount;
+@end
+
+@implementation JRPCBenchmarkTransport
+
+- (BOOL) respondsToSelector:(SEL)aSelector {
+    // Only one serialization strategy is offered to the proxy
+    if (!self.performsSerialization && sel_isEqual(aSelector, @selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:))) {
+        return NO;
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+- (void) resetAllocationCount {
+    self.allocationCount = 0;
+}
+
+- (NSDictionary*) responseForRequest:(NSDictionary*)request {
+    id params = request[kJSONRPCParamsKey];
+    id result = [params isKindOfClass:[NSArray class]] ? [params firstObject] : [[params allValues] firstObject];
+    return @{ kJSONRPCVersionKey   : kJSONRPCVersion,
+              kJSONRPCRequestIdKey : request.jsonRPC_requestId ? : [NSNull null],
+              kJSONRPCResultKey    : result ? : [NSNull null] };
+}
+
+#pragma mark - JRPCProxyTransport
+
+- (void) sendJSONRPCPayloadWithRequestObject:(NSDictionary*)jsonRPCRequest
+                             completionQueue:(dispatch_queue_t)completionQueue
+                                  completion:(JRPCTransportObjectCompletion)completion {
+    self.lastRequestTime = mach_absolute_time();
+    uint64_t allocationCount = JRPCBenchmarkAllocationCount();
+    NSDictionary *jsonRPCResponse = [self responseForRequest:jsonRPCRequest];
+    self.allocationCount += JRPCBenchmarkAllocationCount() - allocationCount;
+    self.lastResponseTime = mach_absolute_time();
+    dispatch_async(completionQueue ? : dispatch_get_main_queue(), ^{
+        completion(jsonRPCResponse, nil);
+    });
+}
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    self.lastRequestTime = mach_absolute_time();
+    uint64_t allocationCount = JRPCBenchmarkAllocationCount();
+    NSData *data = nil;
+    @autoreleasepool {
+        NSDictionary *jsonRPCRequest = [NSJSONSerialization JSONObjectWithData:payload options:0 error:nil];
+        data = [NSJSONSerialization dataWithJSONObject:[self responseForRequest:jsonRPCRequest] options:0 error:nil];
+    }
+    self.allocationCount += JRPCBenchmarkAllocationCount() - allocationCount;
+    self.lastResponseTime = mach_absolute_time();
+    dispatch_async(completionQueue ? : dispatch_get_main_queue(), ^{
+        completion(data, nil);
+    });
+}
+
+@end
@@ -0,0 +1,403 @@
+//
+//  JRPCProxyBenchmarks.m
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCBenchmarkTransport.h"
+#import "JRPCBenchmarkMeasurement.h"
+#import <mach/mach_time.h>
+
+// The calls measured in each case, unless JRPC_BENCHMARK_ITERATIONS is set. Cases with large payloads make a tenth as many
+#define JRPC_BENCHMARK_DEFAULT_ITERATIONS 5000
+// The calls made before measuring, so one time costs (method descriptors, caches, pools) are not counted
+#define JRPC_BENCHMARK_WARMUP_ITERATIONS 100
+// How far a case may fall behind the baseline before it fails, as a fraction, unless the baseline gives its own
+#define JRPC_BENCHMARK_DEFAULT_THROUGHPUT_TOLERANCE 0.25
+#define JRPC_BENCHMARK_DEFAULT_ALLOCATION_TOLERANCE 0.10
+
+// Environment variables read by the benchmarks
+static NSString * const kJRPCBenchmarkIterationsVariable = @"JRPC_BENCHMARK_ITERATIONS";
+static NSString * const kJRPCBenchmarkOutputVariable     = @"JRPC_BENCHMARK_OUTPUT";
+static NSString * const kJRPCBenchmarkBaselineVariable   = @"JRPC_BENCHMARK_BASELINE";
+
+// Keys of the results & baseline files
+static NSString * const kJRPCBenchmarkBenchmarksKey           = @"benchmarks";
+static NSString * const kJRPCBenchmarkToleranceKey            = @"tolerance";
+static NSString * const kJRPCBenchmarkIterationsKey           = @"iterations";
+static NSString * const kJRPCBenchmarkCallsPerSecondKey       = @"callsPerSecond";
+static NSString * const kJRPCBenchmarkRequestNanosKey         = @"requestNanosecondsPerCall";
+static NSString * const kJRPCBenchmarkTransportNanosKey       = @"transportNanosecondsPerCall";
+static NSString * const kJRPCBenchmarkResponseNanosKey        = @"responseNanosecondsPerCall";
+static NSString * const kJRPCBenchmarkAllocationsKey          = @"allocationsPerCall";
+static NSString * const kJRPCBenchmarkTransportAllocationsKey = @"transportAllocationsPerCall";
+static NSString * const kJRPCBenchmarkPeakResidentBytesKey    = @"peakResidentBytes";
+
+/** Makes one call on the proxy, calling done with its error (if any) from the completion block */
+typedef void (^JRPCBenchmarkCall)(JRPCAbstractProxy *proxy, void (^done)(NSError *error));
+
+/**
+ Measures the overhead of JRPCAbstractProxy against a zero latency transport, when the proxy performs serialization.
+ Every case calls the proxy sequentially and records, per call: the time from the call until the request reaches the transport, the time spent in
+ the transport, the time from the response leaving the transport until the completion block is called, and the heap allocations made by the proxy.
+ Calls per second and the peak resident size of the process are recorded too.
+ 
+ The results are written as JSON to the path in JRPC_BENCHMARK_OUTPUT (JRPCProxyBenchmarks.json in the temporary directory by default) and each case
+ fails if it falls behind its entry in JRPCProxyBenchmarksBaseline.json, or the file at JRPC_BENCHMARK_BASELINE. A results file can be used as a baseline
+ */
+@interface JRPCProxyBenchmarks : XCTestCase
+@property (nonatomic, assign) BOOL transportPerformsSerialization;
+@end
+
+/**
+ The same cases, when the transport performs serialization
+ */
+@interface JRPCProxyObjectBenchmarks : JRPCProxyBenchmarks
+@end
+
+// These are the protocols being proxied ...
+@protocol JRPCProxyBenchmarksByPositionProtocol
+- (void) echoInteger:(NSInteger)value :(void (^)(NSInteger result, NSError *error))completion;
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoObject:(NSDictionary*)value :(void (^)(NSDictionary *result, NSError *error))completion;
+@end
+
+@protocol JRPCProxyBenchmarksByNameProtocol
+- (void) echoIntegerWithValue:(NSInteger)value completion:(void (^)(NSInteger result, NSError *error))completion;
+- (void) echoStringWithValue:(NSString*)value completion:(void (^)(NSString *result, NSError *error))completion;
+- (void) echoObjectWithValue:(NSDictionary*)value completion:(void (^)(NSDictionary *result, NSError *error))completion;
+@end
+// ... so we declare conformance to the protocols by the proxy to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyBenchmarksByPositionProtocol, JRPCProxyBenchmarksByNameProtocol>
+@end
+
+// The results of every case run so far, by case name
+static NSMutableDictionary<NSString*, NSDictionary*> *benchmarkResults;
+
+@implementation JRPCProxyBenchmarks
+
++ (void) setUp {
+    [super setUp];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        benchmarkResults = [NSMutableDictionary dictionary];
+    });
+    JRPCBenchmarkStartCountingAllocations();
+}
+
++ (void) tearDown {
+    // Rewritten after each class, so the file holds every case run
+    [self writeResults];
+    [super tearDown];
+}
+
+- (void) setUp {
+    [super setUp];
+    self.continueAfterFailure = YES;
+}
+
+#pragma mark - Payloads
+
++ (NSString*) stringPayload {
+    static NSString *string;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableString *mutableString = [NSMutableString stringWithCapacity:1024];
+        while (mutableString.length < 1024) {
+            [mutableString appendString:@"The quick brown fox jumps over the lazy dog. "];
+        }
+        string = [mutableString copy];
+    });
+    return string;
+}
+
++ (NSDictionary*) itemWithIndex:(NSUInteger)index {
+    return @{ @"id"       : @(index),
+              @"title"    : [NSString stringWithFormat:@"Programme %lu", (unsigned long)index],
+              @"duration" : @(1800.5),
+              @"live"     : @(index % 2 == 0),
+              @"channel"  : @{ @"id" : @(index % 16), @"name" : @"Channel", @"hd" : @YES },
+              @"genres"   : @[ @"drama", @"comedy", @"news" ],
+              @"ratings"  : @[ @(4.5), @(3), @(5) ],
+              @"synopsis" : [NSNull null] };
+}
+
++ (NSDictionary*) smallObjectPayload {
+    static NSDictionary *object;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        object = [self itemWithIndex:1];
+    });
+    return object;
+}
+
++ (NSDictionary*) largeObjectPayload {
+    static NSDictionary *object;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray *items = [NSMutableArray arrayWithCapacity:200];
+        for (NSUInteger i = 0; i < 200; ++i) {
+            [items addObject:[self itemWithIndex:i]];
+        }
+        object = @{ @"schedule" : @{ @"date" : @"2017-10-14", @"items" : items }, @"count" : @(items.count) };
+    });
+    return object;
+}
+
+#pragma mark - Settings
+
++ (NSUInteger) iterations {
+    NSInteger iterations = [NSProcessInfo.processInfo.environment[kJRPCBenchmarkIterationsVariable] integerValue];
+    return iterations > 0 ? (NSUInteger)iterations : JRPC_BENCHMARK_DEFAULT_ITERATIONS;
+}
+
++ (NSURL*) outputURL {
+    NSString *path = NSProcessInfo.processInfo.environment[kJRPCBenchmarkOutputVariable];
+    if (path.length) {
+        return [NSURL fileURLWithPath:path];
+    }
+    return [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"JRPCProxyBenchmarks.json"]];
+}
+
++ (NSDictionary*) baseline {
+    static NSDictionary *baseline;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString *path = NSProcessInfo.processInfo.environment[kJRPCBenchmarkBaselineVariable];
+        NSURL *url = path.length ? [NSURL fileURLWithPath:path]
+                                 : [[NSBundle bundleForClass:[JRPCProxyBenchmarks class]] URLForResource:@"JRPCProxyBenchmarksBaseline" withExtension:@"json"];
+        NSData *data = url ? [NSData dataWithContentsOfURL:url] : nil;
+        if (!data) {
+            [NSException raise:NSInvalidArgumentException format:@"Unable to read the benchmark baseline at %@", url ? : path];
+        }
+        baseline = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+        if (![baseline isKindOfClass:[NSDictionary class]]) {
+            [NSException raise:NSInvalidArgumentException format:@"The benchmark baseline at %@ is not a JSON object", url];
+        }
+    });
+    return baseline;
+}
+
+#pragma mark - Measurement
+
+- (void) measureCaseNamed:(NSString*)name
+                 protocol:(Protocol*)protocol
+           paramStructure:(JRPCParameterStructure)paramStructure
+               iterations:(NSUInteger)iterations
+                     call:(JRPCBenchmarkCall)call {
+    NSString *caseName = [NSString stringWithFormat:@"%@.%@.%@",
+                          self.transportPerformsSerialization ? @"object" : @"data",
+                          paramStructure == JRPCParameterStructureByName ? @"byName" : @"byPosition",
+                          name];
+    JRPCBenchmarkTransport *transport = [[JRPCBenchmarkTransport alloc] init];
+    transport.performsSerialization = self.transportPerformsSerialization;
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:protocol paramStructure:paramStructure transport:transport];
+    proxy.rpcCompletionQueue = dispatch_queue_create("tv.youview.JRPCProxyBenchmarks.completion", DISPATCH_QUEUE_SERIAL);
+    proxy.invokesCompletionBlocksInline = YES;
+    
+    // Only touched between signalling & waiting on the semaphore, which orders the accesses
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block uint64_t completionTime = 0;
+    __block NSUInteger errorCount = 0;
+    void (^done)(NSError*) = ^(NSError *error) {
+        completionTime = mach_absolute_time();
+        if (error) {
+            ++errorCount;
+        }
+        dispatch_semaphore_signal(semaphore);
+    };
+    for (NSUInteger i = 0; i < JRPC_BENCHMARK_WARMUP_ITERATIONS; ++i) {
+        @autoreleasepool {
+            call(proxy, done);
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+        }
+    }
+    
+    uint64_t requestTicks = 0, transportTicks = 0, responseTicks = 0;
+    [transport resetAllocationCount];
+    uint64_t allocationCount = JRPCBenchmarkAllocationCount();
+    uint64_t startTime = mach_absolute_time();
+    for (NSUInteger i = 0; i < iterations; ++i) {
+        @autoreleasepool {
+            uint64_t callTime = mach_absolute_time();
+            call(proxy, done);
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+            requestTicks += transport.lastRequestTime - callTime;
+            transportTicks += transport.lastResponseTime - transport.lastRequestTime;
+            responseTicks += completionTime - transport.lastResponseTime;
+        }
+    }
+    double elapsedNanos = JRPCBenchmarkNanosecondsWithTicks(mach_absolute_time() - startTime);
+    uint64_t allocations = JRPCBenchmarkAllocationCount() - allocationCount;
+    XCTAssertEqual(errorCount, 0, @"%@ calls failed", caseName);
+    
+    NSDictionary *result = @{ kJRPCBenchmarkIterationsKey           : @(iterations),
+                              kJRPCBenchmarkCallsPerSecondKey       : @(round(iterations / (elapsedNanos / NSEC_PER_SEC))),
+                              kJRPCBenchmarkRequestNanosKey         : @(round(JRPCBenchmarkNanosecondsWithTicks(requestTicks) / iterations)),
+                              kJRPCBenchmarkTransportNanosKey       : @(round(JRPCBenchmarkNanosecondsWithTicks(transportTicks) / iterations)),
+                              kJRPCBenchmarkResponseNanosKey        : @(round(JRPCBenchmarkNanosecondsWithTicks(responseTicks) / iterations)),
+                              kJRPCBenchmarkAllocationsKey          : @((double)(allocations - transport.allocationCount) / iterations),
+                              kJRPCBenchmarkTransportAllocationsKey : @((double)transport.allocationCount / iterations),
+                              kJRPCBenchmarkPeakResidentBytesKey    : @(JRPCBenchmarkPeakResidentSize()) };
+    @synchronized (benchmarkResults) {
+        benchmarkResults[caseName] = result;
+    }
+    [self compareResult:result withBaselineForCaseNamed:caseName];
+}
+
+- (void) compareResult:(NSDictionary*)result withBaselineForCaseNamed:(NSString*)caseName {
+    NSDictionary *baseline = [[self class] baseline];
+    NSDictionary *expected = baseline[kJRPCBenchmarkBenchmarksKey][caseName];
+    if (!expected) {
+        // A case that is never compared could regress unnoticed, and made up figures would hide it just as well
+        XCTFail(@"No baseline for %@: record a baseline by running the benchmarks on the reference machine and copying the results file (%@) over "
+                @"JRPCProxyBenchmarksBaseline.json, or set %@ to a results file of your own",
+                caseName, [[self class] outputURL].path, kJRPCBenchmarkBaselineVariable);
+        return;
+    }
+    NSDictionary *tolerance = baseline[kJRPCBenchmarkToleranceKey];
+    double throughputTolerance = tolerance[kJRPCBenchmarkCallsPerSecondKey] ? [tolerance[kJRPCBenchmarkCallsPerSecondKey] doubleValue] : JRPC_BENCHMARK_DEFAULT_THROUGHPUT_TOLERANCE;
+    double allocationTolerance = tolerance[kJRPCBenchmarkAllocationsKey] ? [tolerance[kJRPCBenchmarkAllocationsKey] doubleValue] : JRPC_BENCHMARK_DEFAULT_ALLOCATION_TOLERANCE;
+    
+    double callsPerSecond = [result[kJRPCBenchmarkCallsPerSecondKey] doubleValue];
+    double minimumCallsPerSecond = [expected[kJRPCBenchmarkCallsPerSecondKey] doubleValue] * (1.0 - throughputTolerance);
+    XCTAssertGreaterThanOrEqual(callsPerSecond, minimumCallsPerSecond,
+                                @"REGRESSION %@: %.0f calls/sec, baseline %@ calls/sec", caseName, callsPerSecond, expected[kJRPCBenchmarkCallsPerSecondKey]);
+    
+    // At least one whole allocation per call of slack, since small counts can't move by a fraction
+    double allocationsPerCall = [result[kJRPCBenchmarkAllocationsKey] doubleValue];
+    double expectedAllocationsPerCall = [expected[kJRPCBenchmarkAllocationsKey] doubleValue];
+    double maximumAllocationsPerCall = MAX(expectedAllocationsPerCall * (1.0 + allocationTolerance), expectedAllocationsPerCall + 1.0);
+    XCTAssertLessThanOrEqual(allocationsPerCall, maximumAllocationsPerCall,
+                             @"REGRESSION %@: %.1f allocations/call, baseline %.1f allocations/call", caseName, allocationsPerCall, expectedAllocationsPerCall);
+}
+
++ (void) writeResults {
+    NSDictionary *results;
+    @synchronized (benchmarkResults) {
+        results = @{ kJRPCBenchmarkBenchmarksKey : [benchmarkResults copy] };
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted error:nil];
+    NSURL *url = [self outputURL];
+    NSError *error;
+    if (![data writeToURL:url options:NSDataWritingAtomic error:&error]) {
+        [NSException raise:NSInternalInconsistencyException format:@"Unable to write the benchmark results to %@: %@", url, error];
+    }
+    NSLog(@"JRPCProxyBenchmarks: results written to %@", url.path);
+}
+
+#pragma mark - Cases
+
+- (void) testByPositionScalar {
+    [self measureCaseNamed:@"scalar" protocol:@protocol(JRPCProxyBenchmarksByPositionProtocol) paramStructure:JRPCParameterStructureByPosition
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoInteger:42 :^(NSInteger result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByPositionString {
+    NSString *value = [[self class] stringPayload];
+    [self measureCaseNamed:@"string" protocol:@protocol(JRPCProxyBenchmarksByPositionProtocol) paramStructure:JRPCParameterStructureByPosition
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoString:value :^(NSString *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByPositionSmallObject {
+    NSDictionary *value = [[self class] smallObjectPayload];
+    [self measureCaseNamed:@"smallObject" protocol:@protocol(JRPCProxyBenchmarksByPositionProtocol) paramStructure:JRPCParameterStructureByPosition
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoObject:value :^(NSDictionary *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByPositionLargeObject {
+    NSDictionary *value = [[self class] largeObjectPayload];
+    [self measureCaseNamed:@"largeObject" protocol:@protocol(JRPCProxyBenchmarksByPositionProtocol) paramStructure:JRPCParameterStructureByPosition
+                iterations:MAX([[self class] iterations] / 10, 1) call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoObject:value :^(NSDictionary *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByNameScalar {
+    [self measureCaseNamed:@"scalar" protocol:@protocol(JRPCProxyBenchmarksByNameProtocol) paramStructure:JRPCParameterStructureByName
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoIntegerWithValue:42 completion:^(NSInteger result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByNameString {
+    NSString *value = [[self class] stringPayload];
+    [self measureCaseNamed:@"string" protocol:@protocol(JRPCProxyBenchmarksByNameProtocol) paramStructure:JRPCParameterStructureByName
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoStringWithValue:value completion:^(NSString *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByNameSmallObject {
+    NSDictionary *value = [[self class] smallObjectPayload];
+    [self measureCaseNamed:@"smallObject" protocol:@protocol(JRPCProxyBenchmarksByNameProtocol) paramStructure:JRPCParameterStructureByName
+                iterations:[[self class] iterations] call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoObjectWithValue:value completion:^(NSDictionary *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+- (void) testByNameLargeObject {
+    NSDictionary *value = [[self class] largeObjectPayload];
+    [self measureCaseNamed:@"largeObject" protocol:@protocol(JRPCProxyBenchmarksByNameProtocol) paramStructure:JRPCParameterStructureByName
+                iterations:MAX([[self class] iterations] / 10, 1) call:^(JRPCAbstractProxy *proxy, void (^done)(NSError *)) {
+        [proxy echoObjectWithValue:value completion:^(NSDictionary *result, NSError *error) {
+            done(error);
+        }];
+    }];
+}
+
+@end
+
+@implementation JRPCProxyObjectBenchmarks
+
+- (void) setUp {
+    self.transportPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
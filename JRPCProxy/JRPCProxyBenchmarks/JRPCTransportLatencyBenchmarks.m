@@ -0,0 +1,251 @@
+//
+//  JRPCTransportLatencyBenchmarks.m
+//  JRPCProxyBenchmarks
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCDispatcher.h"
+#import "JRPCStreamTransport.h"
+#import "JRPCSharedMemoryTransport.h"
+#import "JRPCSharedMemoryEndpoint.h"
+#import "JRPCBenchmarkMeasurement.h"
+#import <mach/mach_time.h>
+#import <sys/socket.h>
+#import <unistd.h>
+
+// The sequential calls timed for each transport, after as many again to warm up
+#define JRPC_LATENCY_BENCHMARK_ITERATIONS 10000
+// The calls kept in flight when measuring throughput
+#define JRPC_LATENCY_BENCHMARK_THROUGHPUT_CALLS 10000
+
+// This is the protocol served on the far side of each transport ...
+@protocol JRPCTransportLatencyBenchmarksProtocol
+- (void) echoInteger:(NSInteger)value :(void (^)(NSInteger result, NSError *error))completion;
+@end
+// ... so we declare conformance to the protocol by the proxy to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCTransportLatencyBenchmarksProtocol>
+@end
+
+/** Implements the benchmark protocol */
+@interface JRPCTransportLatencyBenchmarksService : NSObject <JRPCTransportLatencyBenchmarksProtocol, JRPCDispatchTarget>
+@end
+
+/**
+ Serves newline delimited requests on a socket with a dispatcher, from a thread of its own, until the other end of the socket is closed
+ */
+@interface JRPCTransportLatencyBenchmarksSocketServer : NSObject
+- (instancetype) initWithFileDescriptor:(int)fileDescriptor dispatcher:(JRPCDispatcher*)dispatcher;
+- (void) start;
+@end
+
+/**
+ Compares the round trip latency & throughput of a proxy calling a service in the same process through JRPCSharedMemoryTransport,
+ with JRPCStreamTransport over a Unix domain socket. Both serve the requests with a JRPCDispatcher on a thread of their own, and the
+ proxy completes calls inline, so the difference is that of the transports. The results are logged, not compared against a baseline,
+ since they depend on how the scheduler places the threads more than the other benchmarks
+ */
+@interface JRPCTransportLatencyBenchmarks : XCTestCase
+@property (nonatomic, strong) JRPCDispatcher *dispatcher;
+@end
+
+@implementation JRPCTransportLatencyBenchmarks
+
+- (void) setUp {
+    [super setUp];
+    self.continueAfterFailure = YES;
+    self.dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCTransportLatencyBenchmarksProtocol)
+                                             paramStructure:JRPCParameterStructureByPosition
+                                                     target:[[JRPCTransportLatencyBenchmarksService alloc] init]];
+}
+
+#pragma mark - Measurement
+
+static int JRPCCompareTicks(const void *a, const void *b) {
+    uint64_t lhs = *(const uint64_t*)a, rhs = *(const uint64_t*)b;
+    return lhs < rhs ? -1 : lhs > rhs;
+}
+
+- (void) measureTransportNamed:(NSString*)name transport:(id<JRPCProxyTransport>)transport {
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCTransportLatencyBenchmarksProtocol)
+                                                    paramStructure:JRPCParameterStructureByPosition
+                                                         transport:transport];
+    proxy.rpcCompletionQueue = dispatch_queue_create("tv.youview.JRPCTransportLatencyBenchmarks.completion", DISPATCH_QUEUE_SERIAL);
+    proxy.invokesCompletionBlocksInline = YES;
+    
+    // Only touched between signalling & waiting on the semaphore, or on the serial completion queue
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    __block NSUInteger errorCount = 0;
+    uint64_t *ticks = calloc(JRPC_LATENCY_BENCHMARK_ITERATIONS, sizeof(uint64_t));
+    for (NSUInteger i = 0; i < 2 * JRPC_LATENCY_BENCHMARK_ITERATIONS; ++i) {
+        @autoreleasepool {
+            uint64_t callTime = mach_absolute_time();
+            [proxy echoInteger:(NSInteger)i :^(NSInteger result, NSError *error) {
+                if (error || result != (NSInteger)i) {
+                    ++errorCount;
+                }
+                dispatch_semaphore_signal(semaphore);
+            }];
+            dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+            if (i >= JRPC_LATENCY_BENCHMARK_ITERATIONS) {
+                ticks[i - JRPC_LATENCY_BENCHMARK_ITERATIONS] = mach_absolute_time() - callTime;
+            }
+        }
+    }
+    qsort(ticks, JRPC_LATENCY_BENCHMARK_ITERATIONS, sizeof(uint64_t), JRPCCompareTicks);
+    double medianNanos = JRPCBenchmarkNanosecondsWithTicks(ticks[JRPC_LATENCY_BENCHMARK_ITERATIONS / 2]);
+    double p99Nanos = JRPCBenchmarkNanosecondsWithTicks(ticks[JRPC_LATENCY_BENCHMARK_ITERATIONS * 99 / 100]);
+    free(ticks);
+    
+    __block NSUInteger completedCount = 0;
+    uint64_t startTime = mach_absolute_time();
+    for (NSUInteger i = 0; i < JRPC_LATENCY_BENCHMARK_THROUGHPUT_CALLS; ++i) {
+        @autoreleasepool {
+            [proxy echoInteger:(NSInteger)i :^(NSInteger result, NSError *error) {
+                if (error || result != (NSInteger)i) {
+                    ++errorCount;
+                }
+                if (++completedCount == JRPC_LATENCY_BENCHMARK_THROUGHPUT_CALLS) {
+                    dispatch_semaphore_signal(semaphore);
+                }
+            }];
+        }
+    }
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    double elapsedNanos = JRPCBenchmarkNanosecondsWithTicks(mach_absolute_time() - startTime);
+    
+    XCTAssertEqual(errorCount, 0, @"%@ calls failed", name);
+    NSLog(@"JRPCTransportLatencyBenchmarks: %@ median %.0fns, p99 %.0fns, %.0f calls/sec in flight",
+          name, medianNanos, p99Nanos, JRPC_LATENCY_BENCHMARK_THROUGHPUT_CALLS / (elapsedNanos / NSEC_PER_SEC));
+}
+
+#pragma mark - Cases
+
+- (void) testSharedMemory {
+    NSError *error = nil;
+    NSString *name = [NSString stringWithFormat:@"/jrpcb%d", getpid()];
+    JRPCSharedMemoryEndpoint *endpoint = [JRPCSharedMemoryEndpoint endpointWithName:name dispatcher:self.dispatcher error:&error];
+    XCTAssertNotNil(endpoint, @"%@", error);
+    JRPCSharedMemoryTransport *transport = [JRPCSharedMemoryTransport transportWithName:name error:&error];
+    XCTAssertNotNil(transport, @"%@", error);
+    [self measureTransportNamed:@"shared memory" transport:transport];
+    [transport invalidate];
+    [endpoint invalidate];
+}
+
+- (void) testUnixDomainSocket {
+    int fileDescriptors[2];
+    XCTAssertEqual(socketpair(AF_UNIX, SOCK_STREAM, 0, fileDescriptors), 0);
+    JRPCTransportLatencyBenchmarksSocketServer *server = [[JRPCTransportLatencyBenchmarksSocketServer alloc] initWithFileDescriptor:fileDescriptors[1]
+                                                                                                                          dispatcher:self.dispatcher];
+    [server start];
+    JRPCStreamTransport *transport = [JRPCStreamTransport transportWithFileDescriptor:fileDescriptors[0] framing:JRPCStreamFramingNewlineDelimited];
+    [self measureTransportNamed:@"unix domain socket" transport:transport];
+    [transport invalidate];
+    // Which ends the server
+    close(fileDescriptors[0]);
+}
+
+@end
+
+@implementation JRPCTransportLatencyBenchmarksService
+
+- (id) JSONRPCSignatureBlockForSelector:(SEL)selector {
+    return ^(NSInteger value, void (^completion)(NSInteger result, NSError *error)) {};
+}
+
+- (void) echoInteger:(NSInteger)value :(void (^)(NSInteger result, NSError *error))completion {
+    completion(value, nil);
+}
+
+@end
+
+@interface JRPCTransportLatencyBenchmarksSocketServer()
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, strong) JRPCDispatcher *dispatcher;
+@end
+
+@implementation JRPCTransportLatencyBenchmarksSocketServer
+
+- (instancetype) initWithFileDescriptor:(int)fileDescriptor dispatcher:(JRPCDispatcher*)dispatcher {
+    self = [super init];
+    if (self) {
+        self.fileDescriptor = fileDescriptor;
+        self.dispatcher = dispatcher;
+    }
+    return self;
+}
+
+- (void) start {
+    NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(serve) object:nil];
+    thread.name = @"JRPCTransportLatencyBenchmarksSocketServer";
+    [thread start];
+}
+
+- (void) serve {
+    NSMutableData *buffer = [NSMutableData data];
+    uint8_t bytes[16384];
+    ssize_t length;
+    while ((length = read(self.fileDescriptor, bytes, sizeof(bytes))) > 0) {
+        [buffer appendBytes:bytes length:(NSUInteger)length];
+        NSUInteger start = 0;
+        const uint8_t *buffered = buffer.bytes;
+        for (NSUInteger i = 0; i < buffer.length; ++i) {
+            if ('\n' == buffered[i]) {
+                [self handleRequestData:[buffer subdataWithRange:NSMakeRange(start, i - start)]];
+                start = i + 1;
+            }
+        }
+        [buffer replaceBytesInRange:NSMakeRange(0, start) withBytes:NULL length:0];
+    }
+    close(self.fileDescriptor);
+}
+
+- (void) handleRequestData:(NSData*)requestData {
+    [self.dispatcher handleRequestData:requestData completion:^(NSData *responseData) {
+        if (!responseData) {
+            return;
+        }
+        NSMutableData *frame = [responseData mutableCopy];
+        [frame appendBytes:"\n" length:1];
+        // Responses may be completed on any queue, so each frame is written whole
+        @synchronized (self) {
+            const uint8_t *bytes = frame.bytes;
+            NSUInteger offset = 0;
+            while (offset < frame.length) {
+                ssize_t written = write(self.fileDescriptor, bytes + offset, frame.length - offset);
+                if (written <= 0) {
+                    return;
+                }
+                offset += (NSUInteger)written;
+            }
+        }
+    }];
+}
+
+@end
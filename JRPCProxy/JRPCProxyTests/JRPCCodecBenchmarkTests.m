@@ -0,0 +1,222 @@
+//
+//  JRPCCodecBenchmarkTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+#import "NSDictionary+JSONRPC.h"
+
+static const NSString * const kJSONRPCVersion = @"2.0";
+
+// The number of times each payload is encoded or decoded per measurement
+#define JRPC_CODEC_BENCHMARK_ITERATIONS 1000
+
+/**
+ Compares the encoded size and the encode & decode time of each codec, for the requests & responses of the calls made by the other tests.
+ Sizes are logged, and times reported by XCTest's performance measurements
+ */
+@interface JRPCCodecBenchmarkTests : XCTestCase
+@property (nonatomic, strong) NSArray<id<JRPCCodec>> *codecs;
+/** JSON-RPC request & response objects, without binary */
+@property (nonatomic, strong) NSArray<NSDictionary*> *payloads;
+/** A call passing a 4KB blob and its response. MessagePack carries it as bin, JSON as a base64 string */
+@property (nonatomic, strong) NSData *blob;
+@end
+
+@implementation JRPCCodecBenchmarkTests
+
+- (void)setUp {
+    [super setUp];
+    self.codecs = @[ [[JRPCJSONCodec alloc] init], [[JRPCMessagePackCodec alloc] init] ];
+    NSMutableArray<NSDictionary*> *payloads = [[NSMutableArray alloc] init];
+    // Calls of JRPCProxyByPositionTestsProtocol & JRPCProxyByNameTestsProtocol, with the results the stub returns for them
+    NSArray *calls = @[
+        @[ @"methodTakesNoParamsReturnsHelloWorldString", @[], @"Hello World!" ],
+        @[ @"appendStrings", @[ @"Hello ", @"World!" ], @"Hello World!" ],
+        @[ @"addIntegers", @[ @1234, @-5678 ], @-4444 ],
+        @[ @"returnTransformable", @[ @"Hello World!", @42 ], @{ @"string" : @"Hello World!", @"unsignedInteger" : @42 } ],
+        @[ @"echoBool", @[ @YES ], @YES ],
+        @[ @"echoInteger", @[ @(NSIntegerMin) ], @(NSIntegerMin) ],
+        @[ @"echoUnsignedInteger", @[ @(NSUIntegerMax) ], @(NSUIntegerMax) ],
+        @[ @"echoDouble", @[ @M_PI ], @M_PI ],
+        @[ @"echoString", @[ @"Hello World! ✅" ], @"Hello World! ✅" ],
+    ];
+    NSUInteger requestId = 0;
+    for (NSArray *call in calls) {
+        NSArray *params = call[1];
+        [payloads addObject:@{ kJSONRPCVersionKey : kJSONRPCVersion, kJSONRPCMethodKey : call[0], kJSONRPCParamsKey : params, kJSONRPCRequestIdKey : @(requestId) }];
+        if (params.count > 0) {
+            NSMutableDictionary *namedParams = [[NSMutableDictionary alloc] init];
+            for (NSUInteger i = 0; i < params.count; ++i) {
+                namedParams[[NSString stringWithFormat:@"param%lu", (unsigned long)i + 1]] = params[i];
+            }
+            [payloads addObject:@{ kJSONRPCVersionKey : kJSONRPCVersion, kJSONRPCMethodKey : call[0], kJSONRPCParamsKey : namedParams, kJSONRPCRequestIdKey : @(requestId) }];
+        }
+        [payloads addObject:@{ kJSONRPCVersionKey : kJSONRPCVersion, kJSONRPCResultKey : call[2], kJSONRPCRequestIdKey : @(requestId) }];
+        requestId++;
+    }
+    [payloads addObject:@{ kJSONRPCVersionKey : kJSONRPCVersion,
+                           kJSONRPCErrorKey : @{ kJSONRPCErrorCodeKey : @-32601, kJSONRPCErrorMessageKey : @"Method not found" },
+                           kJSONRPCRequestIdKey : @(requestId) }];
+    self.payloads = [payloads copy];
+    NSMutableData *blob = [[NSMutableData alloc] initWithLength:4096];
+    arc4random_buf(blob.mutableBytes, blob.length);
+    self.blob = [blob copy];
+}
+
+- (void)tearDown {
+    self.codecs = nil;
+    self.payloads = nil;
+    self.blob = nil;
+    [super tearDown];
+}
+
+// The blob call as each codec carries it
+- (NSArray<NSDictionary*>*) blobPayloadsForCodec:(id<JRPCCodec>)codec {
+    id param = [codec isKindOfClass:[JRPCMessagePackCodec class]] ? self.blob : [self.blob base64EncodedStringWithOptions:0];
+    return @[ @{ kJSONRPCVersionKey : kJSONRPCVersion, kJSONRPCMethodKey : @"echoData", kJSONRPCParamsKey : @[ param ], kJSONRPCRequestIdKey : @0 },
+              @{ kJSONRPCVersionKey : kJSONRPCVersion, kJSONRPCResultKey : param, kJSONRPCRequestIdKey : @0 } ];
+}
+
+- (NSArray<NSData*>*) encodePayloads:(NSArray<NSDictionary*>*)payloads codec:(id<JRPCCodec>)codec {
+    NSMutableArray<NSData*> *encodedPayloads = [[NSMutableArray alloc] initWithCapacity:payloads.count];
+    for (NSDictionary *payload in payloads) {
+        NSData *encodedPayload = [codec encodeObject:payload error:nil];
+        XCTAssertNotNil(encodedPayload);
+        [encodedPayloads addObject:encodedPayload ? : [NSData data]];
+    }
+    return [encodedPayloads copy];
+}
+
+- (NSUInteger) totalLength:(NSArray<NSData*>*)encodedPayloads {
+    NSUInteger length = 0;
+    for (NSData *encodedPayload in encodedPayloads) {
+        length += encodedPayload.length;
+    }
+    return length;
+}
+
+- (void) measureEncodingPayloads:(NSArray<NSDictionary*>*)payloads codec:(id<JRPCCodec>)codec {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < JRPC_CODEC_BENCHMARK_ITERATIONS; ++i) {
+            @autoreleasepool {
+                for (NSDictionary *payload in payloads) {
+                    [codec encodeObject:payload error:nil];
+                }
+            }
+        }
+    }];
+}
+
+- (void) measureDecodingPayloads:(NSArray<NSDictionary*>*)payloads codec:(id<JRPCCodec>)codec {
+    NSArray<NSData*> *encodedPayloads = [self encodePayloads:payloads codec:codec];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < JRPC_CODEC_BENCHMARK_ITERATIONS; ++i) {
+            @autoreleasepool {
+                for (NSData *encodedPayload in encodedPayloads) {
+                    [codec decodeData:encodedPayload error:nil];
+                }
+            }
+        }
+    }];
+}
+
+#pragma mark - Tests
+
+- (void) testEncodedSize {
+    NSUInteger jsonLength = 0;
+    NSUInteger jsonBlobLength = 0;
+    for (id<JRPCCodec> codec in self.codecs) {
+        NSArray<NSData*> *encodedPayloads = [self encodePayloads:self.payloads codec:codec];
+        NSUInteger length = [self totalLength:encodedPayloads];
+        NSUInteger blobLength = [self totalLength:[self encodePayloads:[self blobPayloadsForCodec:codec] codec:codec]];
+        NSLog(@"%@: %lu bytes for %lu test protocol payloads, %lu bytes for a 4KB blob call", codec.name,
+              (unsigned long)length, (unsigned long)encodedPayloads.count, (unsigned long)blobLength);
+        for (NSUInteger i = 0; i < self.payloads.count; ++i) {
+            XCTAssertEqualObjects([codec decodeData:encodedPayloads[i] error:nil], self.payloads[i]);
+        }
+        if ([codec isKindOfClass:[JRPCJSONCodec class]]) {
+            jsonLength = length;
+            jsonBlobLength = blobLength;
+        }
+        else {
+            XCTAssertLessThan(length, jsonLength);
+            XCTAssertLessThan(blobLength, jsonBlobLength);
+        }
+    }
+}
+
+- (void) testJSONEncodePerformance {
+    [self measureEncodingPayloads:self.payloads codec:self.codecs[0]];
+}
+
+- (void) testMessagePackEncodePerformance {
+    [self measureEncodingPayloads:self.payloads codec:self.codecs[1]];
+}
+
+- (void) testJSONDecodePerformance {
+    [self measureDecodingPayloads:self.payloads codec:self.codecs[0]];
+}
+
+- (void) testMessagePackDecodePerformance {
+    [self measureDecodingPayloads:self.payloads codec:self.codecs[1]];
+}
+
+- (void) testJSONBlobPerformance {
+    NSArray<NSDictionary*> *payloads = [self blobPayloadsForCodec:self.codecs[0]];
+    NSArray<NSData*> *encodedPayloads = [self encodePayloads:payloads codec:self.codecs[0]];
+    NSData *blob = self.blob;
+    // Includes base64 encoding & decoding the blob, which JSON needs to carry it
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < JRPC_CODEC_BENCHMARK_ITERATIONS / 10; ++i) {
+            @autoreleasepool {
+                NSString *param = [blob base64EncodedStringWithOptions:0];
+                [self.codecs[0] encodeObject:@{ kJSONRPCMethodKey : @"echoData", kJSONRPCParamsKey : @[ param ] } error:nil];
+                NSDictionary *response = [self.codecs[0] decodeData:encodedPayloads[1] error:nil];
+                (void)[[NSData alloc] initWithBase64EncodedString:response[kJSONRPCResultKey] options:0];
+            }
+        }
+    }];
+}
+
+- (void) testMessagePackBlobPerformance {
+    NSArray<NSDictionary*> *payloads = [self blobPayloadsForCodec:self.codecs[1]];
+    NSArray<NSData*> *encodedPayloads = [self encodePayloads:payloads codec:self.codecs[1]];
+    NSData *blob = self.blob;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < JRPC_CODEC_BENCHMARK_ITERATIONS / 10; ++i) {
+            @autoreleasepool {
+                [self.codecs[1] encodeObject:@{ kJSONRPCMethodKey : @"echoData", kJSONRPCParamsKey : @[ blob ] } error:nil];
+                (void)[self.codecs[1] decodeData:encodedPayloads[1] error:nil];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,179 @@
+//
+//  JRPCCodecTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+
+/**
+ Test cases for the JSON & MessagePack codecs
+ */
+@interface JRPCCodecTests : XCTestCase
+@property (nonatomic, strong) JRPCJSONCodec *jsonCodec;
+@property (nonatomic, strong) JRPCMessagePackCodec *messagePackCodec;
+@end
+
+@implementation JRPCCodecTests
+
+- (void)setUp {
+    [super setUp];
+    self.jsonCodec = [[JRPCJSONCodec alloc] init];
+    self.messagePackCodec = [[JRPCMessagePackCodec alloc] init];
+}
+
+- (void)tearDown {
+    self.jsonCodec = nil;
+    self.messagePackCodec = nil;
+    [super tearDown];
+}
+
+- (id) messagePackRoundTrip:(id)object {
+    NSError *error = nil;
+    NSData *data = [self.messagePackCodec encodeObject:object error:&error];
+    XCTAssertNotNil(data, @"%@", error);
+    id decoded = [self.messagePackCodec decodeData:data error:&error];
+    XCTAssertNotNil(decoded, @"%@", error);
+    return decoded;
+}
+
+#pragma mark - JSON
+
+- (void) testJSONCodecMatchesJSONSerialization {
+    id object = @{ @"jsonrpc" : @"2.0", @"method" : @"echo", @"params" : @[ @1, @-2.5, @YES, [NSNull null], @"café/\n" ], @"id" : @7 };
+    NSData *data = [self.jsonCodec encodeObject:object error:nil];
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], object);
+    XCTAssertEqualObjects([self.jsonCodec decodeData:data error:nil], object);
+    NSError *error = nil;
+    XCTAssertNil([self.jsonCodec encodeObject:@[ [NSData data] ] error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertNil([self.jsonCodec decodeData:[@"{" dataUsingEncoding:NSUTF8StringEncoding] error:NULL]);
+}
+
+- (void) testJSONCodecJoinsArray {
+    NSArray<NSData*> *encoded = @[ [self.jsonCodec encodeObject:@{ @"id" : @1 } error:nil], [self.jsonCodec encodeObject:@{ @"id" : @2 } error:nil] ];
+    XCTAssertEqualObjects([self.jsonCodec decodeData:[self.jsonCodec encodeArrayWithEncodedObjects:encoded] error:nil], (@[ @{ @"id" : @1 }, @{ @"id" : @2 } ]));
+    XCTAssertEqualObjects([self.jsonCodec decodeData:[self.jsonCodec encodeArrayWithEncodedObjects:@[]] error:nil], @[]);
+}
+
+#pragma mark - MessagePack
+
+- (void) testMessagePackEncodesSmallestFormat {
+    // Expected bytes from the MessagePack specification
+    struct { id object; const char *hex; } cases[] = {
+        { @0, "00" }, { @127, "7f" }, { @128, "cc80" }, { @256, "cd0100" }, { @65536, "ce00010000" }, { @4294967296, "cf0000000100000000" },
+        { @-1, "ff" }, { @-32, "e0" }, { @-33, "d0df" }, { @-129, "d1ff7f" }, { @-32769, "d2ffff7fff" }, { @(INT64_MIN), "d38000000000000000" },
+        { @(UINT64_MAX), "cfffffffffffffffff" }, { @1.5f, "ca3fc00000" }, { @1.5, "cb3ff8000000000000" },
+        { @YES, "c3" }, { @NO, "c2" }, { [NSNull null], "c0" },
+        { @"", "a0" }, { @"a", "a161" }, { [@"" stringByPaddingToLength:32 withString:@"x" startingAtIndex:0], "d920" },
+        { [NSData dataWithBytes:"\x01" length:1], "c40101" }, { @[], "90" }, { @[ @1, @2 ], "920102" }, { @{}, "80" }, { @{ @"a" : @1 }, "81a16101" },
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i) {
+        NSData *data = [self.messagePackCodec encodeObject:cases[i].object error:nil];
+        NSMutableString *hex = [[NSMutableString alloc] init];
+        const uint8_t *bytes = data.bytes;
+        // Long values are only compared up to the end of the expected header
+        for (NSUInteger j = 0; j < MIN(data.length, strlen(cases[i].hex) / 2); ++j) {
+            [hex appendFormat:@"%02x", bytes[j]];
+        }
+        XCTAssertEqualObjects(hex, @(cases[i].hex), @"%@", cases[i].object);
+    }
+}
+
+- (void) testMessagePackRoundTrip {
+    uint8_t bytes[300];
+    for (NSUInteger i = 0; i < sizeof bytes; ++i) {
+        bytes[i] = (uint8_t)i;
+    }
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof bytes];
+    NSString *longString = [@"" stringByPaddingToLength:70000 withString:@"é" startingAtIndex:0];
+    NSMutableArray *longArray = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 20; ++i) {
+        [longArray addObject:@(i * 1000)];
+    }
+    id object = @{ @"jsonrpc" : @"2.0", @"result" : @{ @"data" : data, @"string" : longString, @"array" : longArray, @"nested" : @[ @[ @[ @{} ] ] ],
+                                                       @"numbers" : @[ @0, @-1, @(INT64_MIN), @(UINT64_MAX), @M_PI, @1.25f, @YES, [NSNull null] ] },
+                   @"id" : @42 };
+    XCTAssertEqualObjects([self messagePackRoundTrip:object], object);
+}
+
+- (void) testMessagePackDecodesNumberTypes {
+    XCTAssertEqual([[self messagePackRoundTrip:@(UINT64_MAX)] unsignedLongLongValue], UINT64_MAX);
+    XCTAssertEqual([[self messagePackRoundTrip:@(INT64_MIN)] longLongValue], INT64_MIN);
+    XCTAssertEqual([[self messagePackRoundTrip:@(-200)] integerValue], -200);
+    XCTAssertEqual([[self messagePackRoundTrip:@1.25f] floatValue], 1.25f);
+    XCTAssertTrue((__bridge CFTypeRef)[self messagePackRoundTrip:@YES] == kCFBooleanTrue);
+}
+
+- (void) testMessagePackJoinsArray {
+    NSMutableArray<NSData*> *encoded = [[NSMutableArray alloc] init];
+    NSMutableArray *expected = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 17; ++i) {
+        // More than a fixarray holds
+        [encoded addObject:[self.messagePackCodec encodeObject:@{ @"id" : @(i) } error:nil]];
+        [expected addObject:@{ @"id" : @(i) }];
+    }
+    XCTAssertEqualObjects([self.messagePackCodec decodeData:[self.messagePackCodec encodeArrayWithEncodedObjects:encoded] error:nil], expected);
+}
+
+- (void) testMessagePackRejectsInvalidData {
+    struct { const char *bytes; NSUInteger length; } cases[] = {
+        { "", 0 },                  // Empty
+        { "\xc1", 1 },              // Never used
+        { "\xd4\x01\x00", 3 },      // fixext 1
+        { "\x92\x01", 2 },          // Array shorter than its count
+        { "\xdd\xff\xff\xff\xff", 5 },  // Array count beyond the data
+        { "\xa2\x61", 2 },          // String shorter than its length
+        { "\xa1\xff", 2 },          // Invalid UTF-8
+        { "\xcd\x01", 2 },          // Truncated uint16
+        { "\x01\x02", 2 },          // Trailing data
+        { "\x81\x01", 2 },          // Map without a value
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; ++i) {
+        NSError *error = nil;
+        XCTAssertNil([self.messagePackCodec decodeData:[NSData dataWithBytes:cases[i].bytes length:cases[i].length] error:&error], @"case %zu", i);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+    }
+}
+
+- (void) testMessagePackRejectsDeepNesting {
+    NSMutableData *data = [[NSMutableData alloc] init];
+    for (NSUInteger i = 0; i < 100000; ++i) {
+        [data appendBytes:"\x91" length:1];
+    }
+    [data appendBytes:"\xc0" length:1];
+    XCTAssertNil([self.messagePackCodec decodeData:data error:NULL]);
+}
+
+- (void) testMessagePackRejectsUnsupportedTypes {
+    NSError *error = nil;
+    XCTAssertNil([self.messagePackCodec encodeObject:@[ [NSDate date] ] error:&error]);
+    XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+}
+
+@end
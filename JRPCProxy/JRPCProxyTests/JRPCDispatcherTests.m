@@ -0,0 +1,595 @@
+//
+//  JRPCDispatcherTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCDispatcher.h"
+#import "JRPCProxyTransport.h"
+#import "JRPCError.h"
+#import <objc/runtime.h>
+
+// This is the protocol implemented by JRPCDispatcherTestsService and served by the SUT ...
+@protocol JRPCDispatcherTestsProtocol
+- (void) add:(NSInteger)a :(NSInteger)b :(void (^)(NSInteger result, NSError *error))completion;
+- (void) divide:(double)a :(double)b :(void (^)(double result, NSError *error))completion;
+- (void) greet:(NSString*)name :(void (^)(NSString *result, NSError *error))completion;
+- (void) twice:(JRPCTestTransformableResult*)value :(void (^)(JRPCTestTransformableResult *result, NSError *error))completion;
+- (void) fail:(NSInteger)code :(void (^)(id result, NSError *error))completion;
+- (void) crash:(void (^)(id result, NSError *error))completion;
+- (void) sleep:(double)seconds :(void (^)(id result, NSError *error))completion;
+- (void) countTo:(NSInteger)count :(void (^)(NSNumber *element, BOOL done, NSError *error))completion;
+- (void) pagesOf:(NSInteger)count :(void (^)(NSArray *chunk, BOOL done, NSError *error))completion;
+- (void) log:(NSString*)message;
+@end
+
+// ... and BY-NAME
+@protocol JRPCDispatcherByNameTestsProtocol
+- (void) subtractWithMinuend:(NSInteger)minuend subtrahend:(NSInteger)subtrahend completion:(void (^)(NSInteger result, NSError *error))completion;
+- (void) joinWithPrefix:(NSString*)prefix suffix:(NSString*)suffix completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
+// The proxy calls the same protocol in the round trip tests
+@interface JRPCAbstractProxy() <JRPCDispatcherTestsProtocol>
+@end
+
+static const void *JRPCDispatcherTestsQueueKey = &JRPCDispatcherTestsQueueKey;
+
+/** Implements the test protocols, recording notifications & the queue methods are called on */
+@interface JRPCDispatcherTestsService : NSObject <JRPCDispatcherTestsProtocol, JRPCDispatcherByNameTestsProtocol, JRPCDispatchTarget>
+@property (nonatomic, strong) NSMutableArray<NSString*> *loggedMessages;
+/** The value of JRPCDispatcherTestsQueueKey on the queue add:: was most recently called on */
+@property (atomic, assign) void *lastQueueValue;
+@end
+
+/** Describes add::: with a signature block that does not match it */
+@interface JRPCDispatcherTestsMisdescribedService : JRPCDispatcherTestsService
+@end
+
+/** A transport that hands requests straight to a dispatcher, so a proxy can call a service in the same process */
+@interface JRPCDispatcherLoopbackTransport : NSObject <JRPCProxyTransport>
+@property (nonatomic, strong) JRPCDispatcher *dispatcher;
+@end
+
+/**
+ Test cases for JRPCDispatcher
+ */
+@interface JRPCDispatcherTests : XCTestCase
+/** The System Under Test, serving service BY-POSITION */
+@property (nonatomic, strong) JRPCDispatcher *SUT;
+@property (nonatomic, strong) JRPCDispatcherTestsService *service;
+@end
+
+@implementation JRPCDispatcherTests
+
+- (void)setUp {
+    [super setUp];
+    self.service = [[JRPCDispatcherTestsService alloc] init];
+    self.SUT = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCDispatcherTestsProtocol)
+                                      paramStructure:JRPCParameterStructureByPosition
+                                              target:self.service];
+}
+
+- (void)tearDown {
+    self.SUT = nil;
+    self.service = nil;
+    [super tearDown];
+}
+
+// Handles a request object and waits for the response
+- (id) responseFromDispatcher:(JRPCDispatcher*)dispatcher forRequest:(id)request {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    __block id response = nil;
+    [dispatcher handleRequestObject:request completion:^(id jsonResponse) {
+        response = jsonResponse;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    return response;
+}
+
+- (id) responseForRequest:(id)request {
+    return [self responseFromDispatcher:self.SUT forRequest:request];
+}
+
+// Handles serialized JSON text and waits for the response, returning it deserialized, or NSNull if there is none
+- (id) responseForRequestText:(NSString*)text {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    __block NSData *responseData = nil;
+    [self.SUT handleRequestData:[text dataUsingEncoding:NSUTF8StringEncoding] completion:^(NSData *data) {
+        responseData = data;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    return responseData ? [NSJSONSerialization JSONObjectWithData:responseData options:0 error:nil] : [NSNull null];
+}
+
+- (NSDictionary*) requestWithMethod:(NSString*)method params:(id)params requestId:(id)requestId {
+    NSMutableDictionary *request = [@{ @"jsonrpc" : @"2.0", @"method" : method } mutableCopy];
+    request[@"params"] = params;
+    request[@"id"] = requestId;
+    return [request copy];
+}
+
+- (void) assertResponse:(NSDictionary*)response hasErrorCode:(NSInteger)code requestId:(id)requestId {
+    XCTAssertEqualObjects(response[@"jsonrpc"], @"2.0");
+    XCTAssertNil(response[@"result"]);
+    XCTAssertEqualObjects(response[@"error"][@"code"], @(code));
+    XCTAssertTrue([response[@"error"][@"message"] isKindOfClass:[NSString class]]);
+    XCTAssertEqualObjects(response[@"id"], requestId);
+}
+
+#pragma mark - Calls
+
+- (void) testByPositionCall {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"add" params:@[ @2, @3 ] requestId:@1]];
+    XCTAssertEqualObjects(response, (@{ @"jsonrpc" : @"2.0", @"result" : @5, @"id" : @1 }));
+    response = [self responseForRequest:[self requestWithMethod:@"divide" params:@[ @1, @4 ] requestId:@"a"]];
+    XCTAssertEqualObjects(response, (@{ @"jsonrpc" : @"2.0", @"result" : @0.25, @"id" : @"a" }));
+}
+
+- (void) testByNameCall {
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCDispatcherByNameTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByName
+                                                                target:self.service];
+    NSDictionary *response = [self responseFromDispatcher:dispatcher forRequest:[self requestWithMethod:@"subtract"
+                                                                                                 params:@{ @"subtrahend" : @23, @"minuend" : @42 }
+                                                                                              requestId:@1]];
+    XCTAssertEqualObjects(response[@"result"], @19);
+    // A missing object param is nil, but a missing primitive param cannot be
+    response = [self responseFromDispatcher:dispatcher forRequest:[self requestWithMethod:@"join" params:@{ @"prefix" : @"a" } requestId:@2]];
+    XCTAssertEqualObjects(response[@"result"], @"a");
+    response = [self responseFromDispatcher:dispatcher forRequest:[self requestWithMethod:@"subtract" params:@{ @"minuend" : @42 } requestId:@3]];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeInvalidParameters requestId:@3];
+    // BY-NAME methods also accept params BY-POSITION
+    response = [self responseFromDispatcher:dispatcher forRequest:[self requestWithMethod:@"subtract" params:@[ @42, @23 ] requestId:@4]];
+    XCTAssertEqualObjects(response[@"result"], @19);
+}
+
+- (void) testObjectParamAndResult {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"greet" params:@[ @"World" ] requestId:@1]];
+    XCTAssertEqualObjects(response[@"result"], @"Hello World");
+    // null is nil, and a nil result is null
+    response = [self responseForRequest:[self requestWithMethod:@"greet" params:@[ [NSNull null] ] requestId:@2]];
+    XCTAssertEqualObjects(response[@"result"], [NSNull null]);
+}
+
+- (void) testTransformableParamAndResult {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"twice"
+                                                                        params:@[ @{ @"string" : @"ab", @"unsignedInteger" : @21 } ]
+                                                                     requestId:@1]];
+    XCTAssertEqualObjects(response[@"result"], (@{ @"string" : @"abab", @"unsignedInteger" : @42 }));
+    // Not a dictionary, so the transformable class cannot be created from it
+    response = [self responseForRequest:[self requestWithMethod:@"twice" params:@[ @"ab" ] requestId:@2]];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeInvalidParameters requestId:@2];
+}
+
+- (void) testNullRequestIdIsAnswered {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"add" params:@[ @2, @3 ] requestId:[NSNull null]]];
+    XCTAssertEqualObjects(response, (@{ @"jsonrpc" : @"2.0", @"result" : @5, @"id" : [NSNull null] }));
+}
+
+#pragma mark - Notifications
+
+- (void) testNotificationHasNoResponse {
+    XCTAssertNil([self responseForRequest:[self requestWithMethod:@"log" params:@[ @"one" ] requestId:nil]]);
+    // Nor does a call to a method with a completion block without an id, or a notification that fails
+    XCTAssertNil([self responseForRequest:[self requestWithMethod:@"add" params:@[ @2, @3 ] requestId:nil]]);
+    XCTAssertNil([self responseForRequest:[self requestWithMethod:@"unknown" params:nil requestId:nil]]);
+    XCTAssertNil([self responseForRequest:[self requestWithMethod:@"log" params:@[ @1 ] requestId:nil]]);
+    XCTAssertEqualObjects(self.service.loggedMessages, @[ @"one" ]);
+}
+
+- (void) testMethodWithoutCompletionBlockCalledWithIdReturnsNull {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"log" params:@[ @"two" ] requestId:@7]];
+    XCTAssertEqualObjects(response, (@{ @"jsonrpc" : @"2.0", @"result" : [NSNull null], @"id" : @7 }));
+    XCTAssertEqualObjects(self.service.loggedMessages, @[ @"two" ]);
+}
+
+#pragma mark - Batches
+
+- (void) testBatch {
+    NSArray *responses = [self responseForRequest:@[ [self requestWithMethod:@"add" params:@[ @1, @2 ] requestId:@1],
+                                                     [self requestWithMethod:@"log" params:@[ @"batched" ] requestId:nil],
+                                                     @1,
+                                                     [self requestWithMethod:@"unknown" params:nil requestId:@"x"],
+                                                     [self requestWithMethod:@"greet" params:@[ @"Batch" ] requestId:@2] ]];
+    // In the order of the requests, without the notification
+    XCTAssertEqual(responses.count, 4);
+    XCTAssertEqualObjects(responses[0][@"result"], @3);
+    [self assertResponse:responses[1] hasErrorCode:JSONRPCErrorCodeInvalidRequest requestId:[NSNull null]];
+    [self assertResponse:responses[2] hasErrorCode:JSONRPCErrorCodeMethodNotFound requestId:@"x"];
+    XCTAssertEqualObjects(responses[3][@"result"], @"Hello Batch");
+    XCTAssertEqualObjects(self.service.loggedMessages, @[ @"batched" ]);
+}
+
+- (void) testBatchOfNotificationsHasNoResponse {
+    XCTAssertNil([self responseForRequest:@[ [self requestWithMethod:@"log" params:@[ @"1" ] requestId:nil],
+                                             [self requestWithMethod:@"log" params:@[ @"2" ] requestId:nil] ]]);
+    XCTAssertEqual(self.service.loggedMessages.count, 2);
+}
+
+- (void) testEmptyBatchIsInvalid {
+    [self assertResponse:[self responseForRequest:@[]] hasErrorCode:JSONRPCErrorCodeInvalidRequest requestId:[NSNull null]];
+}
+
+- (void) testBatchIsDispatchedConcurrently {
+    NSMutableArray *requests = [[NSMutableArray alloc] init];
+    for (NSInteger i = 0; i < 8; ++i) {
+        [requests addObject:[self requestWithMethod:@"sleep" params:@[ @0.5 ] requestId:@(i)]];
+    }
+    NSDate *start = [NSDate date];
+    NSArray *responses = [self responseForRequest:requests];
+    // One after another would take 4 seconds
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 2.0);
+    XCTAssertEqual(responses.count, 8);
+    XCTAssertEqualObjects([responses valueForKey:@"id"], [requests valueForKey:@"id"]);
+}
+
+- (void) testMethodsAreCalledOnDispatchQueue {
+    dispatch_queue_t queue = dispatch_queue_create("JRPCDispatcherTestsQueue", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(queue, JRPCDispatcherTestsQueueKey, (void*)JRPCDispatcherTestsQueueKey, NULL);
+    self.SUT.dispatchQueue = queue;
+    [self responseForRequest:[self requestWithMethod:@"add" params:@[ @1, @1 ] requestId:@1]];
+    XCTAssertEqual(self.service.lastQueueValue, JRPCDispatcherTestsQueueKey);
+    self.SUT.dispatchQueue = nil;
+    XCTAssertNotNil(self.SUT.dispatchQueue);
+    [self responseForRequest:[self requestWithMethod:@"add" params:@[ @1, @1 ] requestId:@2]];
+    XCTAssertEqual(self.service.lastQueueValue, NULL);
+}
+
+#pragma mark - Errors
+
+- (void) testParseError {
+    [self assertResponse:[self responseForRequestText:@"{\"jsonrpc\": \"2.0\", \"method\": \"add\", \"params\": [1, 2"]
+            hasErrorCode:JSONRPCErrorCodeParsing
+               requestId:[NSNull null]];
+}
+
+- (void) testInvalidRequest {
+    NSArray *invalidRequests = @[ @"add",
+                                  @{ @"method" : @"add", @"params" : @[ @1, @2 ], @"id" : @1 },
+                                  @{ @"jsonrpc" : @"1.0", @"method" : @"add", @"params" : @[ @1, @2 ], @"id" : @1 },
+                                  @{ @"jsonrpc" : @"2.0", @"method" : @1, @"id" : @1 },
+                                  @{ @"jsonrpc" : @"2.0", @"method" : @"add", @"params" : @"bar", @"id" : @1 } ];
+    for (id request in invalidRequests) {
+        NSDictionary *response = [self responseForRequest:request];
+        // The id is returned if it could be read from the request
+        [self assertResponse:response hasErrorCode:JSONRPCErrorCodeInvalidRequest requestId:[request isKindOfClass:[NSDictionary class]] ? @1 : [NSNull null]];
+    }
+    NSDictionary *response = [self responseForRequest:@{ @"jsonrpc" : @"2.0", @"method" : @"add", @"id" : @{} }];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeInvalidRequest requestId:[NSNull null]];
+}
+
+- (void) testMethodNotFound {
+    [self assertResponse:[self responseForRequest:[self requestWithMethod:@"multiply" params:@[ @1, @2 ] requestId:@1]]
+            hasErrorCode:JSONRPCErrorCodeMethodNotFound
+               requestId:@1];
+}
+
+- (void) testInvalidParams {
+    // Including numbers an NSInteger cannot hold
+    NSArray *invalidParams = @[ @[ @1 ], @[ @1, @2, @3 ], @[ @"1", @2 ], @{ @"a" : @1, @"b" : @2 }, @[ @1e300, @2 ], @[ @(NAN), @2 ] ];
+    for (id params in invalidParams) {
+        [self assertResponse:[self responseForRequest:[self requestWithMethod:@"add" params:params requestId:@1]]
+                hasErrorCode:JSONRPCErrorCodeInvalidParameters
+                   requestId:@1];
+    }
+    [self assertResponse:[self responseForRequest:[self requestWithMethod:@"add" params:nil requestId:@2]]
+            hasErrorCode:JSONRPCErrorCodeInvalidParameters
+               requestId:@2];
+    [self assertResponse:[self responseForRequest:[self requestWithMethod:@"greet" params:@[ @5 ] requestId:@3]]
+            hasErrorCode:JSONRPCErrorCodeInvalidParameters
+               requestId:@3];
+}
+
+- (void) testErrorIsServerError {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"fail" params:@[ @0 ] requestId:@1]];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeServerError requestId:@1];
+    XCTAssertEqualObjects(response[@"error"][@"message"], @"Something failed");
+}
+
+- (void) testErrorWithJSONRPCErrorUserInfo {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"fail" params:@[ @-32001 ] requestId:@1]];
+    XCTAssertEqualObjects(response[@"error"], (@{ @"code" : @-32001, @"message" : @"Custom failure", @"data" : @{ @"reason" : @"test" } }));
+}
+
+- (void) testExceptionIsInternalError {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"crash" params:nil requestId:@1]];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeInternalError requestId:@1];
+    XCTAssertEqualObjects(response[@"error"][@"message"], @"Crashed");
+}
+
+- (void) testUnimplementedMethodRaises {
+    XCTAssertThrowsSpecificNamed([JRPCDispatcher dispatcherForProtocol:@protocol(JRPCDispatcherTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:[[NSObject alloc] init]],
+                                 NSException, NSInvalidArgumentException);
+}
+
+- (void) testMismatchedSignatureBlockRaises {
+    XCTAssertThrowsSpecificNamed([JRPCDispatcher dispatcherForProtocol:@protocol(JRPCDispatcherTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:[[JRPCDispatcherTestsMisdescribedService alloc] init]],
+                                 NSException, NSInvalidArgumentException);
+}
+
+#pragma mark - Serialization
+
+- (void) testRequestData {
+    NSDictionary *response = [self responseForRequestText:@"{\"jsonrpc\": \"2.0\", \"method\": \"add\", \"params\": [40, 2], \"id\": 3}"];
+    XCTAssertEqualObjects(response, (@{ @"jsonrpc" : @"2.0", @"result" : @42, @"id" : @3 }));
+    NSArray *responses = [self responseForRequestText:@"[{\"jsonrpc\": \"2.0\", \"method\": \"add\", \"params\": [1, 2], \"id\": 1}, {\"foo\": \"boo\"}]"];
+    XCTAssertEqual(responses.count, 2);
+    XCTAssertEqualObjects(responses[0][@"result"], @3);
+    XCTAssertEqualObjects(responses[1][@"error"][@"code"], @(JSONRPCErrorCodeInvalidRequest));
+    XCTAssertEqualObjects([self responseForRequestText:@"{\"jsonrpc\": \"2.0\", \"method\": \"log\", \"params\": [\"data\"]}"], [NSNull null]);
+}
+
+- (void) testStreamedResultIsRepliedAsArray {
+    NSDictionary *response = [self responseForRequest:[self requestWithMethod:@"countTo" params:@[ @5 ] requestId:@1]];
+    XCTAssertEqualObjects(response[@"result"], (@[ @1, @2, @3, @4, @5 ]));
+    // Chunks are joined
+    response = [self responseForRequest:[self requestWithMethod:@"pagesOf" params:@[ @7 ] requestId:@2]];
+    XCTAssertEqualObjects(response[@"result"], (@[ @0, @1, @2, @3, @4, @5, @6 ]));
+    // A stream ending in an error replies with the error, not the elements streamed so far
+    response = [self responseForRequest:[self requestWithMethod:@"countTo" params:@[ @-1 ] requestId:@3]];
+    [self assertResponse:response hasErrorCode:JSONRPCErrorCodeServerError requestId:@3];
+    XCTAssertNil(response[@"result"]);
+}
+
+#pragma mark - Round trip
+
+- (void) testProxyCallsDispatcher {
+    JRPCDispatcherLoopbackTransport *transport = [[JRPCDispatcherLoopbackTransport alloc] init];
+    transport.dispatcher = self.SUT;
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCDispatcherTestsProtocol)
+                                                    paramStructure:JRPCParameterStructureByPosition
+                                                         transport:transport];
+    proxy.batchWindow = 0.05;
+    // Serially, so the notification sent first is handled before the batch
+    self.SUT.dispatchQueue = dispatch_queue_create("JRPCDispatcherTestsQueue", DISPATCH_QUEUE_SERIAL);
+    [proxy log:@"round trip"];
+    XCTestExpectation *addExpectation = [self expectationWithDescription:@"add expectation"];
+    [proxy add:40 :2 :^(NSInteger result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, 42);
+        [addExpectation fulfill];
+    }];
+    XCTestExpectation *twiceExpectation = [self expectationWithDescription:@"twice expectation"];
+    JRPCTestTransformableResult *value = [[JRPCTestTransformableResult alloc] init];
+    value.string = @"x";
+    value.unsignedInteger = 3;
+    [proxy twice:value :^(JRPCTestTransformableResult *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result.string, @"xx");
+        XCTAssertEqual(result.unsignedInteger, 6);
+        [twiceExpectation fulfill];
+    }];
+    XCTestExpectation *failExpectation = [self expectationWithDescription:@"fail expectation"];
+    [proxy fail:-32001 :^(id result, NSError *error) {
+        XCTAssertNil(result);
+        XCTAssertEqual(error.code, JRPCErrorServerResponseCode);
+        XCTAssertEqualObjects(error.userInfo[kJRPCErrorCodeKey], @-32001);
+        XCTAssertEqualObjects(error.userInfo[kJRPCErrorMessageKey], @"Custom failure");
+        [failExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqualObjects(self.service.loggedMessages, @[ @"round trip" ]);
+}
+
+- (void) testProxyStreamsDispatcherResult {
+    JRPCDispatcherLoopbackTransport *transport = [[JRPCDispatcherLoopbackTransport alloc] init];
+    transport.dispatcher = self.SUT;
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCDispatcherTestsProtocol)
+                                                    paramStructure:JRPCParameterStructureByPosition
+                                                         transport:transport];
+    [proxy setResultChunkSize:3 elementClass:[NSNumber class] forSelector:@selector(pagesOf::)];
+    XCTestExpectation *countExpectation = [self expectationWithDescription:@"countTo expectation"];
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    [proxy countTo:4 :^(NSNumber *element, BOOL done, NSError *error) {
+        XCTAssertNil(error);
+        if (!done) {
+            [elements addObject:element];
+            return;
+        }
+        XCTAssertEqualObjects(elements, (@[ @1, @2, @3, @4 ]));
+        [countExpectation fulfill];
+    }];
+    XCTestExpectation *pagesExpectation = [self expectationWithDescription:@"pagesOf expectation"];
+    NSMutableArray *chunks = [[NSMutableArray alloc] init];
+    [proxy pagesOf:8 :^(NSArray *chunk, BOOL done, NSError *error) {
+        XCTAssertNil(error);
+        if (!done) {
+            [chunks addObject:chunk];
+            return;
+        }
+        XCTAssertEqualObjects(chunks, (@[ @[ @0, @1, @2 ], @[ @3, @4, @5 ], @[ @6, @7 ] ]));
+        [pagesExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+@end
+
+#pragma mark - JRPCDispatcherTestsService
+
+@implementation JRPCDispatcherTestsService
+
+- (instancetype) init {
+    self = [super init];
+    if (self) {
+        self.loggedMessages = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (id) JSONRPCSignatureBlockForSelector:(SEL)selector {
+    if (sel_isEqual(selector, @selector(add:::))) {
+        return ^(NSInteger a, NSInteger b, void (^completion)(NSInteger result, NSError *error)) {};
+    }
+    if (sel_isEqual(selector, @selector(divide:::))) {
+        return ^(double a, double b, void (^completion)(double result, NSError *error)) {};
+    }
+    if (sel_isEqual(selector, @selector(twice::))) {
+        return ^(JRPCTestTransformableResult *value, void (^completion)(JRPCTestTransformableResult *result, NSError *error)) {};
+    }
+    if (sel_isEqual(selector, @selector(countTo::))) {
+        return ^(NSInteger count, void (^completion)(NSNumber *element, BOOL done, NSError *error)) {};
+    }
+    if (sel_isEqual(selector, @selector(pagesOf::))) {
+        return ^(NSInteger count, void (^completion)(NSArray *chunk, BOOL done, NSError *error)) {};
+    }
+    if (sel_isEqual(selector, @selector(subtractWithMinuend:subtrahend:completion:))) {
+        return ^(NSInteger minuend, NSInteger subtrahend, void (^completion)(NSInteger result, NSError *error)) {};
+    }
+    // The others take & return objects
+    return nil;
+}
+
+- (void) add:(NSInteger)a :(NSInteger)b :(void (^)(NSInteger, NSError *))completion {
+    self.lastQueueValue = dispatch_get_specific(JRPCDispatcherTestsQueueKey);
+    completion(a + b, nil);
+}
+
+- (void) divide:(double)a :(double)b :(void (^)(double, NSError *))completion {
+    completion(a / b, nil);
+}
+
+- (void) greet:(NSString *)name :(void (^)(NSString *, NSError *))completion {
+    // Replies from another queue, as an asynchronous implementation would
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+        completion(name ? [@"Hello " stringByAppendingString:name] : nil, nil);
+    });
+}
+
+- (void) twice:(JRPCTestTransformableResult *)value :(void (^)(JRPCTestTransformableResult *, NSError *))completion {
+    JRPCTestTransformableResult *result = [[JRPCTestTransformableResult alloc] init];
+    result.string = [value.string stringByAppendingString:value.string];
+    result.unsignedInteger = value.unsignedInteger * 2;
+    completion(result, nil);
+}
+
+- (void) fail:(NSInteger)code :(void (^)(id, NSError *))completion {
+    if (0 == code) {
+        completion(nil, [NSError errorWithDomain:@"JRPCDispatcherTests" code:1 userInfo:@{ NSLocalizedDescriptionKey : @"Something failed" }]);
+        return;
+    }
+    completion(nil, [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorServerResponseCode userInfo:@{ kJRPCErrorCodeKey    : @(code),
+                                                                                                          kJRPCErrorMessageKey : @"Custom failure",
+                                                                                                          kJRPCErrorDataKey    : @{ @"reason" : @"test" } }]);
+    // Only the first call of a completion block is replied
+    completion(@"ignored", nil);
+}
+
+- (void) crash:(void (^)(id, NSError *))completion {
+    [NSException raise:NSInternalInconsistencyException format:@"Crashed"];
+}
+
+- (void) sleep:(double)seconds :(void (^)(id, NSError *))completion {
+    [NSThread sleepForTimeInterval:seconds];
+    completion(@(seconds), nil);
+}
+
+- (void) countTo:(NSInteger)count :(void (^)(NSNumber *, BOOL, NSError *))completion {
+    for (NSInteger i = 1; i <= count; ++i) {
+        completion(@(i), NO, nil);
+    }
+    NSError *error = (count < 0) ? [NSError errorWithDomain:@"JRPCDispatcherTests" code:1 userInfo:@{ NSLocalizedDescriptionKey : @"Negative count" }] : nil;
+    completion(nil, YES, error);
+}
+
+- (void) pagesOf:(NSInteger)count :(void (^)(NSArray *, BOOL, NSError *))completion {
+    NSMutableArray *page = [[NSMutableArray alloc] init];
+    for (NSInteger i = 0; i < count; ++i) {
+        [page addObject:@(i)];
+        if (2 == page.count) {
+            completion([page copy], NO, nil);
+            [page removeAllObjects];
+        }
+    }
+    if (page.count) {
+        completion(page, NO, nil);
+    }
+    completion(nil, YES, nil);
+}
+
+- (void) log:(NSString *)message {
+    @synchronized(self.loggedMessages) {
+        [self.loggedMessages addObject:message];
+    }
+}
+
+- (void) subtractWithMinuend:(NSInteger)minuend subtrahend:(NSInteger)subtrahend completion:(void (^)(NSInteger, NSError *))completion {
+    completion(minuend - subtrahend, nil);
+}
+
+- (void) joinWithPrefix:(NSString *)prefix suffix:(NSString *)suffix completion:(void (^)(NSString *, NSError *))completion {
+    completion([prefix stringByAppendingString:suffix ? : @""], nil);
+}
+
+@end
+
+#pragma mark - JRPCDispatcherTestsMisdescribedService
+
+@implementation JRPCDispatcherTestsMisdescribedService
+
+- (id) JSONRPCSignatureBlockForSelector:(SEL)selector {
+    if (sel_isEqual(selector, @selector(add:::))) {
+        return ^(double a, void (^completion)(NSInteger result, NSError *error)) {};
+    }
+    return [super JSONRPCSignatureBlockForSelector:selector];
+}
+
+@end
+
+#pragma mark - JRPCDispatcherLoopbackTransport
+
+@implementation JRPCDispatcherLoopbackTransport
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData *)payload
+                           completionQueue:(dispatch_queue_t)completionQueue
+                                completion:(JRPCTransportDataCompletion)completion {
+    [self.dispatcher handleRequestData:payload completion:^(NSData *responseData) {
+        dispatch_async(completionQueue ? : dispatch_get_main_queue(), ^{
+            completion(responseData, nil);
+        });
+    }];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData *)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    [self sendJSONRPCPayloadWithRequestData:payload completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData *)payload {
+    [self.dispatcher handleRequestData:payload completion:^(NSData *responseData) {}];
+}
+
+@end
@@ -0,0 +1,170 @@
+//
+//  JRPCModelBenchmarkTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "JRPCModel.h"
+
+// The number of JSON objects in the list mapped per measurement, e.g. the items of a catalogue page
+#define JRPC_MODEL_BENCHMARK_COUNT 10000
+
+// The runs of each mapping in the comparisons, of which the fastest is compared
+#define JRPC_MODEL_BENCHMARK_RUNS 5
+
+/** A flat catalogue item, which key-value coding can also map, since its JSON keys are its property names */
+@interface JRPCBenchmarkItem : JRPCModel
+@property (nonatomic, copy) NSString *identifier;
+@property (nonatomic, copy) NSString *title;
+@property (nonatomic, copy) NSString *synopsis;
+@property (nonatomic, assign) NSInteger channelNumber;
+@property (nonatomic, assign) int64_t startTime;
+@property (nonatomic, assign) double duration;
+@property (nonatomic, assign) float rating;
+@property (nonatomic, assign) BOOL subtitled;
+@end
+
+/**
+ Compares JRPCModelMapper with key-value coding, setValuesForKeysWithDictionary: & dictionaryWithValuesForKeys:, mapping a list of catalogue items.
+ The times of each are logged, and the mapper must be faster. Times are also reported by XCTest's performance measurements
+ */
+@interface JRPCModelBenchmarkTests : XCTestCase
+@property (nonatomic, strong) NSArray<NSDictionary*> *jsonObjects;
+@end
+
+@implementation JRPCModelBenchmarkTests
+
+- (void)setUp {
+    [super setUp];
+    NSMutableArray<NSDictionary*> *jsonObjects = [[NSMutableArray alloc] initWithCapacity:JRPC_MODEL_BENCHMARK_COUNT];
+    for (NSInteger i = 0; i < JRPC_MODEL_BENCHMARK_COUNT; ++i) {
+        [jsonObjects addObject:@{ @"identifier"     : [NSString stringWithFormat:@"crid://example.com/%ld", (long)i],
+                                  @"title"          : [NSString stringWithFormat:@"Programme %ld", (long)i],
+                                  @"synopsis"       : @"A programme in the catalogue, with a synopsis of typical length for a listing.",
+                                  @"channelNumber"  : @(100 + i % 50),
+                                  @"startTime"      : @(1500000000000 + i * 1800000),
+                                  @"duration"       : @(1800.0 + i % 7),
+                                  @"rating"         : @((i % 10) / 2.0),
+                                  @"subtitled"      : @(i % 2 == 0) }];
+    }
+    self.jsonObjects = [jsonObjects copy];
+}
+
+- (void)tearDown {
+    self.jsonObjects = nil;
+    [super tearDown];
+}
+
+- (NSArray<JRPCBenchmarkItem*>*) itemsWithMapper {
+    return [JRPCModelMapper modelsOfClass:[JRPCBenchmarkItem class] withJSONArray:self.jsonObjects];
+}
+
+- (NSArray<JRPCBenchmarkItem*>*) itemsWithKeyValueCoding {
+    NSMutableArray<JRPCBenchmarkItem*> *items = [[NSMutableArray alloc] initWithCapacity:self.jsonObjects.count];
+    for (NSDictionary *jsonObject in self.jsonObjects) {
+        JRPCBenchmarkItem *item = [[JRPCBenchmarkItem alloc] init];
+        [item setValuesForKeysWithDictionary:jsonObject];
+        [items addObject:item];
+    }
+    return [items copy];
+}
+
+// The fastest of JRPC_MODEL_BENCHMARK_RUNS runs of block, in seconds
+- (CFTimeInterval) fastestRunOf:(void (^)(void))block {
+    CFTimeInterval fastest = DBL_MAX;
+    for (NSUInteger run = 0; run < JRPC_MODEL_BENCHMARK_RUNS; ++run) {
+        @autoreleasepool {
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            block();
+            fastest = MIN(fastest, CFAbsoluteTimeGetCurrent() - start);
+        }
+    }
+    return fastest;
+}
+
+#pragma mark - Tests
+
+- (void) testMapperMatchesKeyValueCoding {
+    NSArray<JRPCBenchmarkItem*> *mapped = [self itemsWithMapper];
+    NSArray<JRPCBenchmarkItem*> *coded = [self itemsWithKeyValueCoding];
+    XCTAssertEqual(mapped.count, coded.count);
+    NSArray<NSString*> *keys = self.jsonObjects[0].allKeys;
+    for (NSUInteger i = 0; i < mapped.count; i += 997) {
+        XCTAssertEqualObjects([mapped[i] dictionaryWithValuesForKeys:keys], [coded[i] dictionaryWithValuesForKeys:keys]);
+        XCTAssertEqualObjects([mapped[i] jsonRPCRequestRepresentation], [coded[i] dictionaryWithValuesForKeys:keys]);
+    }
+}
+
+- (void) testDecodingIsFasterThanKeyValueCoding {
+    // Plans are built on first use, which is not what is measured
+    [JRPCModelMapper modelOfClass:[JRPCBenchmarkItem class] withJSONObject:self.jsonObjects[0]];
+    CFTimeInterval mapperTime = [self fastestRunOf:^{
+        [self itemsWithMapper];
+    }];
+    CFTimeInterval kvcTime = [self fastestRunOf:^{
+        [self itemsWithKeyValueCoding];
+    }];
+    NSLog(@"Decoding %d items: JRPCModelMapper %.1fms, setValuesForKeysWithDictionary: %.1fms (%.1fx)",
+          JRPC_MODEL_BENCHMARK_COUNT, mapperTime * 1000.0, kvcTime * 1000.0, kvcTime / mapperTime);
+    XCTAssertLessThan(mapperTime, kvcTime);
+}
+
+- (void) testEncodingIsFasterThanKeyValueCoding {
+    NSArray<JRPCBenchmarkItem*> *items = [self itemsWithMapper];
+    NSArray<NSString*> *keys = self.jsonObjects[0].allKeys;
+    CFTimeInterval mapperTime = [self fastestRunOf:^{
+        for (JRPCBenchmarkItem *item in items) {
+            [JRPCModelMapper JSONObjectWithModel:item];
+        }
+    }];
+    CFTimeInterval kvcTime = [self fastestRunOf:^{
+        for (JRPCBenchmarkItem *item in items) {
+            [item dictionaryWithValuesForKeys:keys];
+        }
+    }];
+    NSLog(@"Encoding %d items: JRPCModelMapper %.1fms, dictionaryWithValuesForKeys: %.1fms (%.1fx)",
+          JRPC_MODEL_BENCHMARK_COUNT, mapperTime * 1000.0, kvcTime * 1000.0, kvcTime / mapperTime);
+    XCTAssertLessThan(mapperTime, kvcTime);
+}
+
+- (void) testMapperDecodePerformance {
+    [self measureBlock:^{
+        [self itemsWithMapper];
+    }];
+}
+
+- (void) testKeyValueCodingDecodePerformance {
+    [self measureBlock:^{
+        [self itemsWithKeyValueCoding];
+    }];
+}
+
+@end
+
+@implementation JRPCBenchmarkItem
+@end
@@ -0,0 +1,258 @@
+//
+//  JRPCModelTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "JRPCProxyTestsBase.h"
+#import "JRPCModel.h"
+
+/** A nested model */
+@interface JRPCTestChannel : JRPCModel
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) NSInteger number;
+@end
+
+/** A model with properties of every kind the mapper converts */
+@interface JRPCTestProgramme : JRPCModel
+@property (nonatomic, copy, readonly) NSString *identifier;
+@property (nonatomic, copy) NSString *title;
+@property (nonatomic, assign) double duration;
+@property (nonatomic, assign) BOOL subtitled;
+@property (nonatomic, assign) int64_t startTime;
+@property (nonatomic, assign) float rating;
+@property (nonatomic, strong) JRPCTestChannel *channel;
+@property (nonatomic, copy) NSArray<JRPCTestChannel*> *alternativeChannels;
+@property (nonatomic, copy) NSArray<NSString*> *genres;
+@property (nonatomic, strong) JRPCTestTransformableResult *extra;
+@property (nonatomic, copy) NSDictionary *metadata;
+@property (nonatomic, strong) id anything;
+/** Computed, so not mapped */
+@property (nonatomic, readonly) NSString *displayTitle;
+@end
+
+/** Inherits the properties of JRPCTestProgramme, as well as its key & element class mappings */
+@interface JRPCTestEpisode : JRPCTestProgramme
+@property (nonatomic, assign) unsigned short episodeNumber;
+@end
+
+/** A model that does not derive from JRPCModel, with a property implemented by accessors rather than an instance variable */
+@interface JRPCTestAccessorModel : NSObject <JRPCModelMapping>
+@property (nonatomic, assign) NSInteger value;
+@property (nonatomic, assign) NSUInteger setterCallCount;
+@end
+
+/**
+ Test cases for JRPCModelMapper & JRPCModel
+ */
+@interface JRPCModelTests : XCTestCase
+@end
+
+@implementation JRPCModelTests
+
+- (NSDictionary*) programmeJSONObject {
+    return @{
+             @"id"                  : @"p1",
+             @"title"               : @"News",
+             @"duration"            : @1800.5,
+             @"subtitled"           : @YES,
+             @"startTime"           : @1500000000000,
+             @"rating"              : @4.5,
+             @"channel"             : @{ @"name" : @"One", @"number" : @101 },
+             @"alternativeChannels" : @[ @{ @"name" : @"One HD", @"number" : @201 }, @{ @"name" : @"One +1", @"number" : @301 } ],
+             @"genres"              : @[ @"news", @"current affairs" ],
+             @"extra"               : @{ @"string" : @"extra", @"unsignedInteger" : @7 },
+             @"metadata"            : @{ @"source" : @"feed" },
+             @"anything"            : @[ @1, @"two" ]
+             };
+}
+
+#pragma mark - Decoding
+
+- (void) testMapsProperties {
+    JRPCTestProgramme *programme = [JRPCModelMapper modelOfClass:[JRPCTestProgramme class] withJSONObject:[self programmeJSONObject]];
+    XCTAssertNotNil(programme);
+    // Renamed & readonly
+    XCTAssertEqualObjects(programme.identifier, @"p1");
+    XCTAssertEqualObjects(programme.title, @"News");
+    XCTAssertEqual(programme.duration, 1800.5);
+    XCTAssertTrue(programme.subtitled);
+    XCTAssertEqual(programme.startTime, 1500000000000);
+    XCTAssertEqual(programme.rating, 4.5f);
+    XCTAssertEqualObjects(programme.metadata, @{ @"source" : @"feed" });
+    XCTAssertEqualObjects(programme.anything, (@[ @1, @"two" ]));
+    JRPCTestTransformableResult *extra = [[JRPCTestTransformableResult alloc] init];
+    extra.string = @"extra";
+    extra.unsignedInteger = 7;
+    XCTAssertEqualObjects(programme.extra, extra);
+}
+
+- (void) testMapsNestedModelsAndArrays {
+    JRPCTestProgramme *programme = [JRPCModelMapper modelOfClass:[JRPCTestProgramme class] withJSONObject:[self programmeJSONObject]];
+    XCTAssertTrue([programme.channel isKindOfClass:[JRPCTestChannel class]]);
+    XCTAssertEqualObjects(programme.channel.name, @"One");
+    XCTAssertEqual(programme.channel.number, 101);
+    XCTAssertEqual(programme.alternativeChannels.count, 2);
+    XCTAssertTrue([programme.alternativeChannels[1] isKindOfClass:[JRPCTestChannel class]]);
+    XCTAssertEqualObjects(programme.alternativeChannels[1].name, @"One +1");
+    XCTAssertEqual(programme.alternativeChannels[1].number, 301);
+    XCTAssertEqualObjects(programme.genres, (@[ @"news", @"current affairs" ]));
+}
+
+- (void) testInitWithJSONRPCResponseResult {
+    JRPCTestProgramme *programme = [[JRPCTestProgramme alloc] initWithJSONRPCResponseResult:[self programmeJSONObject]];
+    XCTAssertEqualObjects(programme.title, @"News");
+    XCTAssertNil([[JRPCTestProgramme alloc] initWithJSONRPCResponseResult:@"News"]);
+}
+
+- (void) testInheritedProperties {
+    NSMutableDictionary *jsonObject = [[self programmeJSONObject] mutableCopy];
+    jsonObject[@"episodeNumber"] = @12;
+    JRPCTestEpisode *episode = [JRPCModelMapper modelOfClass:[JRPCTestEpisode class] withJSONObject:jsonObject];
+    XCTAssertEqual(episode.episodeNumber, 12);
+    XCTAssertEqualObjects(episode.identifier, @"p1");
+    XCTAssertEqualObjects(episode.alternativeChannels[0].name, @"One HD");
+    XCTAssertEqualObjects([JRPCModelMapper JSONObjectWithModel:episode], jsonObject);
+}
+
+- (void) testNullAndMissingMembers {
+    JRPCTestProgramme *programme = [JRPCModelMapper modelOfClass:[JRPCTestProgramme class]
+                                                  withJSONObject:@{ @"title" : [NSNull null], @"duration" : [NSNull null], @"channel" : [NSNull null],
+                                                                    @"genres" : [NSNull null], @"unknown" : @1 }];
+    XCTAssertNotNil(programme);
+    XCTAssertNil(programme.title);
+    XCTAssertEqual(programme.duration, 0);
+    XCTAssertNil(programme.channel);
+    XCTAssertNil(programme.genres);
+    XCTAssertNil(programme.identifier);
+    XCTAssertEqualObjects([JRPCModelMapper modelsOfClass:[JRPCTestChannel class] withJSONArray:@[]], @[]);
+}
+
+- (void) testMismatchedTypesFail {
+    NSArray *mismatches = @[ @{ @"title" : @5 },
+                             @{ @"duration" : @"long" },
+                             @{ @"channel" : @"One" },
+                             @{ @"channel" : @{ @"number" : @"101" } },
+                             @{ @"alternativeChannels" : @[ @1 ] },
+                             @{ @"alternativeChannels" : @{} },
+                             @{ @"genres" : @[ @"news", @1 ] },
+                             @{ @"genres" : @[ [NSNull null] ] },
+                             @{ @"extra" : @"extra" } ];
+    for (NSDictionary *jsonObject in mismatches) {
+        XCTAssertNil([JRPCModelMapper modelOfClass:[JRPCTestProgramme class] withJSONObject:jsonObject], @"%@", jsonObject);
+    }
+    XCTAssertNil([JRPCModelMapper modelOfClass:[JRPCTestProgramme class] withJSONObject:@[]]);
+    XCTAssertNil([JRPCModelMapper modelsOfClass:[JRPCTestChannel class] withJSONArray:@[ @{ @"name" : @"One" }, @2 ]]);
+}
+
+- (void) testModelsOfClass {
+    NSArray<JRPCTestChannel*> *channels = [JRPCModelMapper modelsOfClass:[JRPCTestChannel class]
+                                                           withJSONArray:@[ @{ @"name" : @"One" }, @{ @"name" : @"Two", @"number" : @2 } ]];
+    XCTAssertEqual(channels.count, 2);
+    XCTAssertEqualObjects(channels[0].name, @"One");
+    XCTAssertEqual(channels[0].number, 0);
+    XCTAssertEqual(channels[1].number, 2);
+}
+
+- (void) testAccessorsAreUsed {
+    JRPCTestAccessorModel *model = [JRPCModelMapper modelOfClass:[JRPCTestAccessorModel class] withJSONObject:@{ @"value" : @42 }];
+    XCTAssertEqual(model.value, 42);
+    XCTAssertEqual(model.setterCallCount, 1);
+    XCTAssertEqualObjects([JRPCModelMapper JSONObjectWithModel:model][@"value"], @42);
+}
+
+- (void) testNonModelClassRaises {
+    XCTAssertThrowsSpecificNamed([JRPCModelMapper modelOfClass:[NSObject class] withJSONObject:@{}], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([JRPCModelMapper JSONObjectWithModel:[[NSObject alloc] init]], NSException, NSInvalidArgumentException);
+}
+
+- (void) testConcurrentMapping {
+    NSDictionary *jsonObject = [self programmeJSONObject];
+    dispatch_apply(16, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        JRPCTestEpisode *episode = [JRPCModelMapper modelOfClass:[JRPCTestEpisode class] withJSONObject:jsonObject];
+        XCTAssertEqualObjects(episode.channel.name, @"One");
+    });
+}
+
+#pragma mark - Encoding
+
+- (void) testJSONRepresentation {
+    NSDictionary *jsonObject = [self programmeJSONObject];
+    JRPCTestProgramme *programme = [JRPCModelMapper modelOfClass:[JRPCTestProgramme class] withJSONObject:jsonObject];
+    NSDictionary *representation = [programme jsonRPCRequestRepresentation];
+    XCTAssertEqualObjects(representation, jsonObject);
+    // Computed properties are not included
+    XCTAssertNil(representation[@"displayTitle"]);
+    XCTAssertTrue([NSJSONSerialization isValidJSONObject:representation]);
+}
+
+- (void) testNilPropertiesAreOmitted {
+    JRPCTestChannel *channel = [[JRPCTestChannel alloc] init];
+    XCTAssertEqualObjects([channel jsonRPCRequestRepresentation], @{ @"number" : @0 });
+}
+
+@end
+
+#pragma mark - Models
+
+@implementation JRPCTestChannel
+@end
+
+@implementation JRPCTestProgramme
+
++ (NSDictionary<NSString*, NSString*>*) jsonRPCKeysByPropertyName {
+    return @{ @"identifier" : @"id" };
+}
+
++ (NSDictionary<NSString*, Class>*) jsonRPCElementClassesByPropertyName {
+    return @{ @"alternativeChannels" : [JRPCTestChannel class], @"genres" : [NSString class] };
+}
+
+- (NSString*) displayTitle {
+    return [NSString stringWithFormat:@"%@ (%@)", self.title, self.channel.name];
+}
+
+@end
+
+@implementation JRPCTestEpisode
+@end
+
+@implementation JRPCTestAccessorModel {
+    NSInteger _storage;
+}
+
+- (NSInteger) value {
+    return _storage;
+}
+
+- (void) setValue:(NSInteger)value {
+    _storage = value;
+    self.setterCallCount++;
+}
+
+@end
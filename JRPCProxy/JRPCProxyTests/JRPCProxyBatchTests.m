@@ -0,0 +1,219 @@
+//
+//  JRPCProxyBatchTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for JSON-RPC batch requests, when the proxy performs serialization
+ */
+@interface JRPCProxyBatchTests : JRPCProxyTestsBase
+@end
+
+/**
+ Test cases for JSON-RPC batch requests, when the transport performs serialization
+ */
+@interface JRPCProxyObjectBatchTests : JRPCProxyBatchTests
+@end
+
+/**
+ Test cases for JSON-RPC batch requests, when the transport takes & returns dispatch data, with responses split into small regions
+ */
+@interface JRPCProxyDispatchDataBatchTests : JRPCProxyBatchTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyBatchTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoInt:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) echoDouble:(double)value :(void (^)(double result, NSError *error))completion;
+- (void) methodReturnsErrorNotInt:(void (^)(int result, NSError *error))completion;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyBatchTestsProtocol>
+@end
+
+@implementation JRPCProxyBatchTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyBatchTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (XCTestExpectation*) echoString:(NSString*)value withProxy:(JRPCAbstractProxy*)proxy {
+    XCTestExpectation *expectation = [self expectationWithDescription:value];
+    [proxy echoString:value :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, value);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    return expectation;
+}
+
+#pragma mark - Tests
+
+- (void) testCallsWithinWindowAreBatched {
+    self.SUT.batchWindow = 0.1;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    XCTestExpectation *stringExpectation = [self echoString:@"Hello World!" withProxy:self.SUT];
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc int expectation"];
+    [self.SUT echoInt:-2017 :^(int result, NSError *error) {
+        XCTAssertEqual(result, -2017);
+        XCTAssertNil(error);
+        [intExpectation fulfill];
+    }];
+    XCTestExpectation *doubleExpectation = [self expectationWithDescription:@"json-rpc double expectation"];
+    [self.SUT echoDouble:M_PI :^(double result, NSError *error) {
+        XCTAssertEqual(result, M_PI);
+        XCTAssertNil(error);
+        [doubleExpectation fulfill];
+    }];
+    [waiter waitForExpectations:@[stringExpectation, intExpectation, doubleExpectation] timeout:60.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+    XCTAssertEqual(self.jsonRPCTransport.lastBatchSize, 3);
+}
+
+- (void) testOutOfOrderResponsesAndPartialErrors {
+    self.SUT.batchWindow = 0.1;
+    self.jsonRPCTransport.reversesBatchResponses = YES;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    XCTestExpectation *stringExpectation = [self echoString:@"Hello World!" withProxy:self.SUT];
+    XCTestExpectation *errorExpectation = [self expectationWithDescription:@"json-rpc error expectation"];
+    [self.SUT methodReturnsErrorNotInt:^(int result, NSError *error) {
+        XCTAssertEqual(result, 0);
+        XCTAssertEqual(error.code, JRPCErrorServerResponseCode);
+        XCTAssertEqual([error.userInfo[kJRPCErrorCodeKey] integerValue], -32000);
+        [errorExpectation fulfill];
+    }];
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc int expectation"];
+    [self.SUT echoInt:42 :^(int result, NSError *error) {
+        XCTAssertEqual(result, 42);
+        XCTAssertNil(error);
+        [intExpectation fulfill];
+    }];
+    [waiter waitForExpectations:@[stringExpectation, errorExpectation, intExpectation] timeout:60.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+}
+
+- (void) testFullBatchIsSentImmediately {
+    // The window is longer than the test timeout, so only reaching maxBatchSize sends the batch
+    self.SUT.batchWindow = 600.0;
+    self.SUT.maxBatchSize = 2;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    NSArray *expectations = @[ [self echoString:@"one" withProxy:self.SUT], [self echoString:@"two" withProxy:self.SUT] ];
+    [waiter waitForExpectations:expectations timeout:5.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+    XCTAssertEqual(self.jsonRPCTransport.lastBatchSize, 2);
+}
+
+- (void) testBatchByteBudget {
+    if (self.transportStubPerformsSerialization) {
+        // The byte budget only applies when the proxy performs serialization
+        return;
+    }
+    // Each request is ~70 bytes, so only two fit in a batch
+    self.SUT.batchWindow = 0.1;
+    self.SUT.maxBatchBytes = 150;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    NSArray *expectations = @[ [self echoString:@"Hello World!" withProxy:self.SUT], [self echoString:@"Hello World?" withProxy:self.SUT],
+                               [self echoString:@"Hello World." withProxy:self.SUT], [self echoString:@"Hello World;" withProxy:self.SUT] ];
+    [waiter waitForExpectations:expectations timeout:60.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 2);
+    XCTAssertEqual(self.jsonRPCTransport.lastBatchSize, 2);
+}
+
+- (void) testFlushBatch {
+    self.SUT.batchWindow = 600.0;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    NSArray *expectations = @[ [self echoString:@"one" withProxy:self.SUT], [self echoString:@"two" withProxy:self.SUT] ];
+    [self.SUT flushBatch];
+    [waiter waitForExpectations:expectations timeout:5.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+}
+
+- (void) testSingleCallIsNotBatched {
+    self.SUT.batchWindow = 0.1;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    [waiter waitForExpectations:@[ [self echoString:@"Hello World!" withProxy:self.SUT] ] timeout:60.0];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 0);
+}
+
+- (void) testBatchingRequiresTransportSupport {
+    JRPCProxyTransportStub *transport = [[JRPCProxyTransportStub alloc] init];
+    transport.performsSerialization = self.transportStubPerformsSerialization;
+    transport.supportsBatches = NO;
+    [transport configureMethod:@"echoString" result:^id(id params) {
+        return params[0];
+    }];
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:self.protocol paramStructure:self.paramsStructure transport:transport];
+    proxy.batchWindow = 0.1;
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    NSArray *expectations = @[ [self echoString:@"one" withProxy:proxy], [self echoString:@"two" withProxy:proxy] ];
+    [waiter waitForExpectations:expectations timeout:60.0];
+    XCTAssertEqual(transport.batchCount, 0);
+}
+
+@end
+
+@implementation JRPCProxyObjectBatchTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
+
+@implementation JRPCProxyDispatchDataBatchTests
+
+- (void)setUp {
+    self.transportStubUsesDispatchData = YES;
+    [super setUp];
+    self.jsonRPCTransport.responseFragmentSize = 7;
+}
+
+- (void) testLargeRequestIsSentInChunks {
+    // Too big for the writer's buffers, so the request is handed over in regions rather than copied into one
+    NSMutableString *value = [[NSMutableString alloc] init];
+    while (value.length < 200000) {
+        [value appendString:@"Hello World!"];
+    }
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    [waiter waitForExpectations:@[ [self echoString:value withProxy:self.SUT] ] timeout:60.0];
+    XCTAssertGreaterThan(self.jsonRPCTransport.lastRequestRegionCount, 1);
+}
+
+@end
+
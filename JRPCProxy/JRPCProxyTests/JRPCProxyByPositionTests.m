@@ -28,6 +28,7 @@
  */
 
 #import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
 
 /**
  Test cases for JSON-RPC with 'by-position' parameter structure
@@ -35,6 +36,12 @@
 @interface JRPCProxyByPositionTests : JRPCProxyTestsBase
 @end
 
+/**
+ The by-position test cases, when the transport takes & returns dispatch data, with responses split into small regions
+ */
+@interface JRPCProxyDispatchDataByPositionTests : JRPCProxyByPositionTests
+@end
+
 // This is the protocol being proxied by the SUT ...
 @protocol JRPCProxyByPositionTestsProtocol
 - (void) methodTakesNoParamsReturnsHelloWorldString:(void (^)(NSString *result, NSError *error))completion;
@@ -294,4 +301,14 @@
 }
 
 
+@end
+
+@implementation JRPCProxyDispatchDataByPositionTests
+
+- (void)setUp {
+    self.transportStubUsesDispatchData = YES;
+    [super setUp];
+    self.jsonRPCTransport.responseFragmentSize = 3;
+}
+
 @end
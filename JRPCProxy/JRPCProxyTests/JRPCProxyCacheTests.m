@@ -0,0 +1,314 @@
+//
+//  JRPCProxyCacheTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for the response cache, when the proxy performs serialization
+ */
+@interface JRPCProxyCacheTests : JRPCProxyTestsBase
+// The number of requests the stub has received for each method
+@property (nonatomic, strong) NSCountedSet<NSString*> *requestCounts;
+@end
+
+/**
+ Test cases for the response cache, when the transport performs serialization
+ */
+@interface JRPCProxyObjectCacheTests : JRPCProxyCacheTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyCacheTestsProtocol
+- (void) lookup:(NSString*)key :(void (^)(NSString *result, NSError *error))completion;
+- (void) lookupOptions:(NSDictionary*)options :(void (^)(NSDictionary *result, NSError *error))completion;
+- (void) lookupData:(NSData*)data :(void (^)(NSString *result, NSError *error))completion;
+- (void) fail:(void (^)(NSString *result, NSError *error))completion;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyCacheTestsProtocol>
+@end
+
+@implementation JRPCProxyCacheTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyCacheTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    self.requestCounts = [[NSCountedSet alloc] init];
+    __weak typeof(self) weakSelf = self;
+    // Results include the number of requests for the method, so a cached result can be told from a fresh one
+    [self.jsonRPCTransport configureMethod:@"lookup" result:^id(id params) {
+        [weakSelf.requestCounts addObject:@"lookup"];
+        return [NSString stringWithFormat:@"%@-%lu", params[0], (unsigned long)[weakSelf.requestCounts countForObject:@"lookup"]];
+    }];
+    [self.jsonRPCTransport configureMethod:@"lookupOptions" result:^id(id params) {
+        [weakSelf.requestCounts addObject:@"lookupOptions"];
+        return params[0];
+    }];
+    // Returning no result makes the stub return an error
+    [self.jsonRPCTransport configureMethod:@"fail" result:^id(id params) {
+        [weakSelf.requestCounts addObject:@"fail"];
+        return nil;
+    }];
+}
+
+- (void)tearDown {
+    self.requestCounts = nil;
+    [super tearDown];
+}
+
+- (NSString*) lookup:(NSString*)key {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    __block NSString *lookupResult = nil;
+    [self.SUT lookup:key :^(NSString *result, NSError *error) {
+        XCTAssertNil(error);
+        lookupResult = result;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    return lookupResult;
+}
+
+- (void) waitForInterval:(NSTimeInterval)interval {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"interval expectation"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+#pragma mark - Tests
+
+- (void) testUncachedMethodSendsEveryCall {
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 0);
+}
+
+- (void) testCachedResponseIsReturned {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqual([self.requestCounts countForObject:@"lookup"], 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.hits, 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 1);
+}
+
+- (void) testDifferentParamsAreCachedSeparately {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqualObjects([self lookup:@"b"], @"b-2");
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqual([self.requestCounts countForObject:@"lookup"], 2);
+}
+
+- (void) testDictionaryKeyOrderIsIgnored {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookupOptions::)];
+    NSMutableDictionary *first = [[NSMutableDictionary alloc] init];
+    NSMutableDictionary *second = [[NSMutableDictionary alloc] init];
+    for (NSUInteger i = 0; i < 16; ++i) {
+        first[[NSString stringWithFormat:@"key%lu", (unsigned long)i]] = @(i);
+        second[[NSString stringWithFormat:@"key%lu", (unsigned long)(15 - i)]] = @(15 - i);
+    }
+    for (NSDictionary *options in @[first, second]) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+        [self.SUT lookupOptions:options :^(NSDictionary *result, NSError *error) {
+            XCTAssertEqualObjects(result, first);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    }
+    XCTAssertEqual([self.requestCounts countForObject:@"lookupOptions"], 1);
+}
+
+- (void) testConcurrentCallsShareRequest {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    // The stub responds asynchronously, so every call is made while the first request is in flight
+    for (NSUInteger i = 0; i < 3; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc expectation %lu", (unsigned long)i]];
+        [self.SUT lookup:@"a" :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, @"a-1");
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual([self.requestCounts countForObject:@"lookup"], 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.coalesced, 2);
+}
+
+- (void) testCancellingFirstCallLeavesSharedRequestInFlight {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    self.jsonRPCTransport.withholdsResponses = YES;
+    XCTestExpectation *cancelledExpectation = [self expectationWithDescription:@"cancelled expectation"];
+    id<JRPCCall> call = [self.SUT callWithHandle:^{
+        [self.SUT lookup:@"a" :^(NSString *result, NSError *error) {
+            XCTAssertEqual(error.code, JRPCErrorCancelledCode);
+            [cancelledExpectation fulfill];
+        }];
+    }];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT lookup:@"a" :^(NSString *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, @"a-1");
+        [expectation fulfill];
+    }];
+    [call cancel];
+    [self waitForExpectations:@[cancelledExpectation] timeout:60.0];
+    // The second call still waits on the request the first sent
+    XCTAssertEqual(self.jsonRPCTransport.cancelledRequestIds.count, 0);
+    self.jsonRPCTransport.withholdsResponses = NO;
+    [self.jsonRPCTransport releaseWithheldResponses];
+    [self waitForExpectations:@[expectation] timeout:60.0];
+    XCTAssertEqual([self.requestCounts countForObject:@"lookup"], 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.coalesced, 1);
+}
+
+- (void) testCancellingEveryCallCancelsSharedRequest {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    self.jsonRPCTransport.withholdsResponses = YES;
+    NSMutableArray<id<JRPCCall>> *calls = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < 2; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"cancelled expectation %lu", (unsigned long)i]];
+        [calls addObject:[self.SUT callWithHandle:^{
+            [self.SUT lookup:@"a" :^(NSString *result, NSError *error) {
+                XCTAssertEqual(error.code, JRPCErrorCancelledCode);
+                [expectation fulfill];
+            }];
+        }]];
+    }
+    [calls[0] cancel];
+    XCTAssertEqual(self.jsonRPCTransport.cancelledRequestIds.count, 0);
+    [calls[1] cancel];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.jsonRPCTransport.cancelledRequestIds.count, 1);
+    // The next identical call sends a request of its own
+    self.jsonRPCTransport.withholdsResponses = NO;
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+}
+
+- (void) testRequestThatCannotBeEncodedIsNotLeftInFlight {
+    if (self.transportStubPerformsSerialization) {
+        // Request objects are not encoded by the proxy
+        return;
+    }
+    // NSData makes a cache key, but is not valid JSON, so each call raises as its request is encoded
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookupData::)];
+    NSData *data = [@"a" dataUsingEncoding:NSUTF8StringEncoding];
+    for (NSUInteger i = 0; i < 2; ++i) {
+        XCTAssertThrowsSpecificNamed([self.SUT lookupData:data :^(NSString *result, NSError *error) {
+            XCTFail(@"Completion block called for a call that raised");
+        }], NSException, NSInvalidArgumentException);
+    }
+    // The second call was not coalesced onto the first, which was never sent
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 2);
+    XCTAssertEqual(self.SUT.cacheStatistics.coalesced, 0);
+}
+
+- (void) testExpiredResponseIsNotReturned {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:0.05] forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    [self waitForInterval:0.1];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 2);
+}
+
+- (void) testStaleResponseIsReturnedWhileRevalidating {
+    JRPCCachePolicy *policy = [[JRPCCachePolicy alloc] initWithTimeToLive:0.05 staleWhileRevalidate:60.0 maxEntryCount:0 maxBytes:0];
+    [self.SUT setCachePolicy:policy forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    [self waitForInterval:0.1];
+    // The stale response is returned, and a request sent to refresh it
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqual([self.requestCounts countForObject:@"lookup"], 2);
+    [self waitForInterval:0.01];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+    XCTAssertEqual(self.SUT.cacheStatistics.staleHits, 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.hits, 1);
+}
+
+- (void) testErrorsAreNotCached {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(fail:)];
+    for (NSUInteger i = 0; i < 2; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+        [self.SUT fail:^(NSString *result, NSError *error) {
+            XCTAssertNil(result);
+            XCTAssertNotNil(error);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    }
+    XCTAssertEqual([self.requestCounts countForObject:@"fail"], 2);
+}
+
+- (void) testMaxEntryCountEvictsOldest {
+    JRPCCachePolicy *policy = [[JRPCCachePolicy alloc] initWithTimeToLive:60.0 staleWhileRevalidate:0 maxEntryCount:2 maxBytes:0];
+    [self.SUT setCachePolicy:policy forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    XCTAssertEqualObjects([self lookup:@"b"], @"b-2");
+    XCTAssertEqualObjects([self lookup:@"c"], @"c-3");
+    XCTAssertEqual(self.SUT.cacheStatistics.evictions, 1);
+    XCTAssertEqualObjects([self lookup:@"c"], @"c-3");
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-4");
+}
+
+- (void) testRemoveAllCachedResponses {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    [self.SUT removeAllCachedResponses];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+}
+
+- (void) testRemovingPolicyStopsCaching {
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-1");
+    [self.SUT setCachePolicy:nil forSelector:@selector(lookup::)];
+    XCTAssertEqualObjects([self lookup:@"a"], @"a-2");
+}
+
+- (void) testPolicyForNotificationRaises {
+    XCTAssertThrowsSpecificNamed([self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(ping)],
+                                 NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(description)],
+                                 NSException, NSInvalidArgumentException);
+}
+
+@end
+
+@implementation JRPCProxyObjectCacheTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,220 @@
+//
+//  JRPCProxyCodecTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCMessagePackCodec.h"
+#import "NSDictionary+JSONRPC.h"
+
+/**
+ Test cases for negotiating codecs with the transport, and calls encoded with MessagePack
+ */
+@interface JRPCProxyCodecTests : JRPCProxyTestsBase
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyCodecTestsProtocol
+- (void) appendStrings:(NSString*)string1 :(NSString*)string2 :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoInteger:(NSInteger)value :(void (^)(NSInteger result, NSError *error))completion;
+- (void) echoData:(NSData*)value :(void (^)(NSData *result, NSError *error))completion;
+- (void) echoObject:(id)value :(void (^)(id result, NSError *error))completion;
+- (void) ping:(NSData*)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyCodecTestsProtocol>
+@end
+
+@implementation JRPCProxyCodecTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyCodecTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethod:@"appendStrings" result:^id(id params) {
+        return [params[0] stringByAppendingString:params[1]];
+    }];
+    [self.jsonRPCTransport configureMethods:@[ @"echoInteger", @"echoData", @"echoObject" ] result:^id(id params) {
+        return params[0];
+    }];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void) useMessagePack {
+    self.jsonRPCTransport.codec = [[JRPCMessagePackCodec alloc] init];
+    self.SUT.codecs = @[ [[JRPCMessagePackCodec alloc] init], [[JRPCJSONCodec alloc] init] ];
+}
+
+#pragma mark - Tests
+
+- (void) testDefaultCodecIsJSON {
+    XCTAssertEqual(self.SUT.codecs.count, 1);
+    XCTAssertTrue([self.SUT.codec isKindOfClass:[JRPCJSONCodec class]]);
+    XCTAssertEqualObjects(self.jsonRPCTransport.usedCodecName, JRPCCodecNameJSON);
+}
+
+- (void) testFirstCodecSupportedByTransportIsUsed {
+    // The stub only supports JSON, so MessagePack is passed over
+    self.SUT.codecs = @[ [[JRPCMessagePackCodec alloc] init], [[JRPCJSONCodec alloc] init] ];
+    XCTAssertEqualObjects(self.SUT.codec.name, JRPCCodecNameJSON);
+    [self useMessagePack];
+    XCTAssertEqualObjects(self.SUT.codec.name, JRPCCodecNameMessagePack);
+    XCTAssertEqualObjects(self.jsonRPCTransport.usedCodecName, JRPCCodecNameMessagePack);
+}
+
+- (void) testCodecsTheTransportDoesNotSupportRaise {
+    XCTAssertThrowsSpecificNamed(self.SUT.codecs = @[ [[JRPCMessagePackCodec alloc] init] ], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed(self.SUT.codecs = @[], NSException, NSInvalidArgumentException);
+    // The codec in use is unchanged
+    XCTAssertEqualObjects(self.SUT.codec.name, JRPCCodecNameJSON);
+}
+
+- (void) testMessagePackRequestHasSameEnvelope {
+    [self useMessagePack];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT appendStrings:@"Hello " :@"World!" :^(NSString *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, @"Hello World!");
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSDictionary *request = [[[JRPCMessagePackCodec alloc] init] decodeData:self.jsonRPCTransport.lastRequestData error:nil];
+    XCTAssertEqualObjects(request[kJSONRPCVersionKey], @"2.0");
+    XCTAssertEqualObjects(request[kJSONRPCMethodKey], @"appendStrings");
+    XCTAssertEqualObjects(request[kJSONRPCParamsKey], (@[ @"Hello ", @"World!" ]));
+    XCTAssertNotNil(request[kJSONRPCRequestIdKey]);
+}
+
+- (void) testMessagePackScalarResult {
+    [self useMessagePack];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoInteger:-123456789 :^(NSInteger result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, -123456789);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testMessagePackCarriesBinary {
+    [self useMessagePack];
+    uint8_t bytes[] = { 0x00, 0xff, 0x7f, 0x80, '"', '\\' };
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof bytes];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoData:data :^(NSData *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, data);
+        [expectation fulfill];
+    }];
+    XCTestExpectation *nestedExpectation = [self expectationWithDescription:@"json-rpc nested expectation"];
+    [self.SUT echoObject:@{ @"blob" : data, @"blobs" : @[ data ] } :^(id result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, (@{ @"blob" : data, @"blobs" : @[ data ] }));
+        [nestedExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testJSONRejectsBinary {
+    void (^completion)(id, NSError*) = ^(id result, NSError *error) {
+        XCTFail(@"Completion should not be called");
+    };
+    XCTAssertThrowsSpecificNamed([self.SUT echoObject:[NSData data] :completion], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT echoObject:@[ [NSData data] ] :completion], NSException, NSInvalidArgumentException);
+    [self useMessagePack];
+    XCTAssertThrowsSpecificNamed([self.SUT echoObject:@[ [NSDate date] ] :completion], NSException, NSInvalidArgumentException);
+}
+
+- (void) testMessagePackBatch {
+    [self useMessagePack];
+    self.SUT.batchWindow = 60.0;
+    self.SUT.maxBatchSize = 2;
+    XCTestExpectation *expectation1 = [self expectationWithDescription:@"json-rpc expectation 1"];
+    XCTestExpectation *expectation2 = [self expectationWithDescription:@"json-rpc expectation 2"];
+    [self.SUT echoInteger:1 :^(NSInteger result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, 1);
+        [expectation1 fulfill];
+    }];
+    [self.SUT echoData:[NSData dataWithBytes:"\x02" length:1] :^(NSData *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, [NSData dataWithBytes:"\x02" length:1]);
+        [expectation2 fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+    XCTAssertEqual(self.jsonRPCTransport.lastBatchSize, 2);
+}
+
+- (void) testMessagePackNotification {
+    [self useMessagePack];
+    NSData *data = [NSData dataWithBytes:"\x01\x02" length:2];
+    [self.SUT ping:data];
+    XCTAssertEqual(self.jsonRPCTransport.receivedNotifications.count, 1);
+    XCTAssertEqualObjects(self.jsonRPCTransport.receivedNotifications.firstObject[kJSONRPCParamsKey], @[ data ]);
+}
+
+- (void) testCachedCallsWithBinaryParams {
+    [self useMessagePack];
+    [self.SUT setCachePolicy:[JRPCCachePolicy policyWithTimeToLive:60.0] forSelector:@selector(echoData::)];
+    for (NSString *string in @[ @"a", @"a", @"b" ]) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+        [self.SUT echoData:data :^(NSData *result, NSError *error) {
+            XCTAssertEqualObjects(result, data);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    }
+    XCTAssertEqual(self.SUT.cacheStatistics.hits, 1);
+    XCTAssertEqual(self.SUT.cacheStatistics.misses, 2);
+}
+
+- (void) testTransportPerformingSerializationIsPassedBinary {
+    JRPCProxyTransportStub *transport = [[JRPCProxyTransportStub alloc] init];
+    transport.performsSerialization = YES;
+    [transport configureMethod:@"echoData" result:^id(id params) {
+        return params[0];
+    }];
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:self.protocol paramStructure:JRPCParameterStructureByPosition transport:transport];
+    XCTAssertNil(proxy.codec);
+    NSData *data = [NSData dataWithBytes:"\x00" length:1];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [proxy echoData:data :^(NSData *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, data);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+@end
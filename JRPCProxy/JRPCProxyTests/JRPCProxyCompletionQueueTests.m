@@ -0,0 +1,139 @@
+//
+//  JRPCProxyCompletionQueueTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+
+/**
+ Test cases for the queues responses are handled & completion blocks called on, when the proxy performs serialization
+ */
+@interface JRPCProxyCompletionQueueTests : JRPCProxyTestsBase
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+@end
+
+/**
+ Test cases for the queues responses are handled & completion blocks called on, when the transport performs serialization
+ */
+@interface JRPCProxyObjectCompletionQueueTests : JRPCProxyCompletionQueueTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyCompletionQueueTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyCompletionQueueTestsProtocol>
+@end
+
+static void *kJRPCCompletionQueueKey = &kJRPCCompletionQueueKey;
+
+@implementation JRPCProxyCompletionQueueTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyCompletionQueueTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    self.completionQueue = dispatch_queue_create("JRPCProxyCompletionQueueTests", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(self.completionQueue, kJRPCCompletionQueueKey, kJRPCCompletionQueueKey, NULL);
+}
+
+- (void)tearDown {
+    self.completionQueue = nil;
+    [super tearDown];
+}
+
+- (void) echoStringExpectingCompletionOnQueue:(BOOL)onCompletionQueue {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, @"Hello World!");
+        XCTAssertEqual(onCompletionQueue, (NULL != dispatch_get_specific(kJRPCCompletionQueueKey)));
+        XCTAssertNotEqual(onCompletionQueue, [NSThread isMainThread]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+#pragma mark - Tests
+
+- (void) testCompletionOnMainQueueByDefault {
+    [self echoStringExpectingCompletionOnQueue:NO];
+    if (!self.transportStubPerformsSerialization) {
+        // The response is parsed off the main queue
+        XCTAssertNotEqual(self.jsonRPCTransport.lastCompletionQueue, dispatch_get_main_queue());
+    }
+}
+
+- (void) testCompletionOnRPCCompletionQueue {
+    self.SUT.rpcCompletionQueue = self.completionQueue;
+    [self echoStringExpectingCompletionOnQueue:YES];
+    XCTAssertNotEqual(self.jsonRPCTransport.lastCompletionQueue, dispatch_get_main_queue());
+}
+
+- (void) testInlineCompletionOnRPCCompletionQueue {
+    self.SUT.rpcCompletionQueue = self.completionQueue;
+    self.SUT.invokesCompletionBlocksInline = YES;
+    [self echoStringExpectingCompletionOnQueue:YES];
+    // The transport calls back on the completion queue, where the completion block is called without another dispatch
+    XCTAssertEqual(self.jsonRPCTransport.lastCompletionQueue, self.completionQueue);
+}
+
+- (void) testInlineCompletionIgnoredForMainQueue {
+    self.SUT.invokesCompletionBlocksInline = YES;
+    [self echoStringExpectingCompletionOnQueue:NO];
+    if (!self.transportStubPerformsSerialization) {
+        XCTAssertNotEqual(self.jsonRPCTransport.lastCompletionQueue, dispatch_get_main_queue());
+    }
+}
+
+- (void) testBatchCompletionOnRPCCompletionQueue {
+    self.SUT.rpcCompletionQueue = self.completionQueue;
+    self.SUT.batchWindow = 0.05;
+    XCTestExpectation *firstExpectation = [self expectationWithDescription:@"json-rpc first expectation"];
+    XCTestExpectation *secondExpectation = [self expectationWithDescription:@"json-rpc second expectation"];
+    for (XCTestExpectation *expectation in @[firstExpectation, secondExpectation]) {
+        [self.SUT echoString:expectation.description :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, expectation.description);
+            XCTAssertTrue(NULL != dispatch_get_specific(kJRPCCompletionQueueKey));
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+}
+
+@end
+
+@implementation JRPCProxyObjectCompletionQueueTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,258 @@
+//
+//  JRPCProxyConcurrencyTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCCachePolicy.h"
+#import <stdatomic.h>
+
+// The number of threads calling the proxy at once, and the calls each makes, in the stress tests
+#define JRPC_STRESS_THREAD_COUNT 16
+#define JRPC_STRESS_CALLS_PER_THREAD 125
+
+// The calls made at each thread count in the benchmark
+#define JRPC_BENCHMARK_CALL_COUNT 20000
+// How many times the single thread rate the best multi-thread rate must reach on a machine with two or more cores. Two cores would
+// ideally give 2x, so this leaves a 25% margin for scheduling noise while still failing if calls serialize on a shared lock
+#define JRPC_BENCHMARK_MIN_SCALING 1.5
+
+/**
+ Stress test cases for a proxy called from many threads at once, when the proxy performs serialization
+ */
+@interface JRPCProxyConcurrencyTests : JRPCProxyTestsBase
+@end
+
+/**
+ Stress test cases for a proxy called from many threads at once, when the transport performs serialization
+ */
+@interface JRPCProxyObjectConcurrencyTests : JRPCProxyConcurrencyTests
+@end
+
+/**
+ Measures the throughput of a proxy called from 1 to 16 threads at once, with a transport that answers straight away, so the proxy's own cost
+ dominates. Calls per second are logged for each thread count, and on a machine with two or more cores the best multi-thread rate must
+ be at least JRPC_BENCHMARK_MIN_SCALING times the single thread rate
+ */
+@interface JRPCProxyConcurrencyBenchmarkTests : XCTestCase
+@end
+
+/** A transport that answers every request at once with its first param, without logging, for the benchmark */
+@interface JRPCConcurrencyBenchmarkTransport : NSObject <JRPCProxyTransport>
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyConcurrencyTestsProtocol
+- (void) echoInteger:(NSInteger)value :(void (^)(NSInteger result, NSError *error))completion;
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) ping:(NSInteger)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyConcurrencyTestsProtocol>
+@end
+
+@implementation JRPCProxyConcurrencyTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyConcurrencyTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethods:@[ @"echoInteger", @"echoString" ] result:^id(id params) {
+        return params[0];
+    }];
+    // Completion blocks are called on many threads too
+    self.SUT.rpcCompletionQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+// Calls the proxy from JRPC_STRESS_THREAD_COUNT threads at once, checking every call gets its own result, and waits for all of them to complete
+- (void) stressWithCall:(void (^)(NSInteger value, void (^completion)(NSInteger result, NSError *error)))call {
+    dispatch_group_t group = dispatch_group_create();
+    // Only used while this frame waits for the calls
+    atomic_uint mismatchCount;
+    atomic_init(&mismatchCount, 0);
+    atomic_uint *mismatches = &mismatchCount;
+    dispatch_apply(JRPC_STRESS_THREAD_COUNT, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSInteger i = 0; i < JRPC_STRESS_CALLS_PER_THREAD; ++i) {
+            NSInteger value = (NSInteger)thread * JRPC_STRESS_CALLS_PER_THREAD + i;
+            dispatch_group_enter(group);
+            call(value, ^(NSInteger result, NSError *error) {
+                if (error || result != value) {
+                    atomic_fetch_add(mismatches, 1);
+                }
+                dispatch_group_leave(group);
+            });
+        }
+    });
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    dispatch_group_notify(group, dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(atomic_load(mismatches), 0);
+}
+
+#pragma mark - Tests
+
+- (void) testConcurrentCallsHaveUniqueIds {
+    [self stressWithCall:^(NSInteger value, void (^completion)(NSInteger, NSError *)) {
+        [self.SUT echoInteger:value :completion];
+    }];
+    NSArray<id> *requestIds = self.jsonRPCTransport.receivedRequestIds;
+    XCTAssertEqual(requestIds.count, JRPC_STRESS_THREAD_COUNT * JRPC_STRESS_CALLS_PER_THREAD);
+    XCTAssertEqual([NSSet setWithArray:requestIds].count, requestIds.count);
+}
+
+- (void) testConcurrentCallsWithLimitsAndCaching {
+    self.SUT.maxConcurrentCalls = 4;
+    [self.SUT setCachePolicy:[[JRPCCachePolicy alloc] initWithTimeToLive:60.0 staleWhileRevalidate:0 maxEntryCount:0 maxBytes:0]
+                 forSelector:@selector(echoString::)];
+    [self stressWithCall:^(NSInteger value, void (^completion)(NSInteger, NSError *)) {
+        // Half the calls share a few cached results
+        if (value % 2) {
+            [self.SUT echoInteger:value :completion];
+        }
+        else {
+            NSInteger shared = value % 8;
+            [self.SUT echoString:[NSString stringWithFormat:@"%ld", (long)shared] :^(NSString *result, NSError *error) {
+                completion(result.integerValue - shared + value, error);
+            }];
+        }
+    }];
+    NSArray<id> *requestIds = self.jsonRPCTransport.receivedRequestIds;
+    XCTAssertEqual([NSSet setWithArray:requestIds].count, requestIds.count);
+    XCTAssertEqual(self.SUT.schedulerStatistics.inFlightCount, 0);
+}
+
+- (void) testSettingsChangedWhileCalling {
+    dispatch_queue_t completionQueue = self.SUT.rpcCompletionQueue;
+    atomic_bool stopFlag;
+    atomic_init(&stopFlag, false);
+    atomic_bool *stop = &stopFlag;
+    dispatch_group_t settingsGroup = dispatch_group_create();
+    dispatch_group_async(settingsGroup, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        JRPCCachePolicy *policy = [[JRPCCachePolicy alloc] initWithTimeToLive:60.0 staleWhileRevalidate:0 maxEntryCount:0 maxBytes:0];
+        for (NSUInteger i = 0; !atomic_load(stop); ++i) {
+            self.SUT.rpcCompletionQueue = completionQueue;
+            self.SUT.codecs = self.SUT.codecs;
+            [self.SUT setCachePolicy:(i % 2) ? policy : nil forSelector:@selector(echoInteger::)];
+        }
+    });
+    [self stressWithCall:^(NSInteger value, void (^completion)(NSInteger, NSError *)) {
+        [self.SUT echoInteger:value :completion];
+        [self.SUT ping:value];
+    }];
+    atomic_store(stop, true);
+    dispatch_group_wait(settingsGroup, DISPATCH_TIME_FOREVER);
+}
+
+- (void) testReplacedSettingsAreReleased {
+    __weak dispatch_queue_t weakQueue = nil;
+    @autoreleasepool {
+        dispatch_queue_t queue = dispatch_queue_create("JRPCProxyConcurrencyTestsReplacedQueue", DISPATCH_QUEUE_SERIAL);
+        weakQueue = queue;
+        self.SUT.rpcCompletionQueue = queue;
+        XCTAssertEqual(self.SUT.rpcCompletionQueue, queue);
+        self.SUT.rpcCompletionQueue = dispatch_get_main_queue();
+    }
+    // Nothing was reading it as it was replaced, so it is released straight away rather than kept for the life of the proxy
+    XCTAssertNil(weakQueue);
+}
+
+@end
+
+@implementation JRPCProxyObjectConcurrencyTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
+
+@implementation JRPCProxyConcurrencyBenchmarkTests
+
+- (void) testThroughputByThreadCount {
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCProxyConcurrencyTestsProtocol)
+                                                    paramStructure:JRPCParameterStructureByPosition
+                                                         transport:[[JRPCConcurrencyBenchmarkTransport alloc] init]];
+    proxy.rpcCompletionQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    proxy.invokesCompletionBlocksInline = YES;
+    double singleThreadRate = 0;
+    double bestMultiThreadRate = 0;
+    for (size_t threadCount = 1; threadCount <= 16; threadCount *= 2) {
+        dispatch_group_t group = dispatch_group_create();
+        size_t callsPerThread = JRPC_BENCHMARK_CALL_COUNT / threadCount;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        dispatch_apply(threadCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+            for (size_t i = 0; i < callsPerThread; ++i) {
+                dispatch_group_enter(group);
+                [proxy echoInteger:(NSInteger)i :^(NSInteger result, NSError *error) {
+                    dispatch_group_leave(group);
+                }];
+            }
+        });
+        XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 60 * NSEC_PER_SEC)), 0);
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        double rate = (double)(callsPerThread * threadCount) / elapsed;
+        NSLog(@"%s - %zu threads: %.0f calls/s", __func__, threadCount, rate);
+        if (threadCount == 1) {
+            singleThreadRate = rate;
+        } else {
+            bestMultiThreadRate = MAX(bestMultiThreadRate, rate);
+        }
+    }
+    // A single core can't show any scaling
+    if ([NSProcessInfo processInfo].activeProcessorCount < 2) {
+        NSLog(@"%s - only one core, not checking the scaling", __func__);
+        return;
+    }
+    XCTAssertGreaterThanOrEqual(bestMultiThreadRate, singleThreadRate * JRPC_BENCHMARK_MIN_SCALING,
+                                @"Calls from several threads should run at least %.1fx as fast as from one", JRPC_BENCHMARK_MIN_SCALING);
+}
+
+@end
+
+@implementation JRPCConcurrencyBenchmarkTransport
+
+- (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
+                           completionQueue:(dispatch_queue_t)queue
+                                completion:(JRPCTransportDataCompletion)completion {
+    NSDictionary *request = [NSJSONSerialization JSONObjectWithData:payload options:0 error:nil];
+    NSString *response = [NSString stringWithFormat:@"{\"jsonrpc\":\"2.0\",\"result\":%@,\"id\":%@}", request[@"params"][0], request[@"id"]];
+    NSData *responseData = [response dataUsingEncoding:NSUTF8StringEncoding];
+    dispatch_async(queue, ^{
+        completion(responseData, nil);
+    });
+}
+
+@end
@@ -41,6 +41,7 @@
 - (void) methodNotStubbedWithString:(NSString*)string completion:(void (^)(NSString *result, NSError *error))completion;
 - (void) methodReturnsErrorNotIntWithCompletion:(void (^)(int result, NSError *error))completion;
 - (void) methodReturnsErrorNotDoubleWithCompletion:(void (^)(double result, NSError *error))completion;
+- (void) methodNotStubbedWithObject:(id)object completion:(void (^)(NSString *result, NSError *error))completion;
 @end
 // ... so we declare conformance to the protocol by the SUT to satisfy the compiler
 @interface JRPCAbstractProxy() <JRPCProxyErrorTestsProtocol>
@@ -102,4 +103,13 @@
     [waiter waitForExpectations:@[expectation] timeout:60.0];
 }
 
+- (void) testUnsupportedObjectParamRaises {
+    void (^completion)(NSString*, NSError*) = ^(NSString *result, NSError *error) {
+        XCTFail(@"Completion should not be called");
+    };
+    XCTAssertThrowsSpecificNamed([self.SUT methodNotStubbedWithObject:[NSDate date] completion:completion], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT methodNotStubbedWithObject:@(NAN) completion:completion], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT methodNotStubbedWithObject:@[[NSDate date]] completion:completion], NSException, NSInvalidArgumentException);
+}
+
 @end
@@ -0,0 +1,293 @@
+//
+//  JRPCProxyMetricsTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+#import "JRPCHistogram.h"
+
+/**
+ Test cases for metrics, when the proxy performs serialization
+ */
+@interface JRPCProxyMetricsTests : JRPCProxyTestsBase <JRPCMetricsDelegate>
+@property (nonatomic, strong) XCTestExpectation *reportExpectation;
+@end
+
+/**
+ Test cases for metrics, when the transport performs serialization
+ */
+@interface JRPCProxyObjectMetricsTests : JRPCProxyMetricsTests
+@end
+
+/**
+ Test cases for the latency histogram behind metrics
+ */
+@interface JRPCHistogramTests : XCTestCase
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyMetricsTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) notStubbed:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) ping:(NSInteger)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyMetricsTestsProtocol>
+@end
+
+@implementation JRPCProxyMetricsTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyMetricsTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethod:@"echoString" result:^id(id params) {
+        return params[0];
+    }];
+}
+
+- (void)tearDown {
+    self.SUT.metricsReportInterval = 0;
+    [super tearDown];
+}
+
+- (void) echoStrings:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+        [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, @"Hello World!");
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+#pragma mark - JRPCMetricsDelegate
+
+- (void) proxy:(JRPCAbstractProxy*)proxy didReportMetrics:(JRPCMetricsSnapshot*)metrics {
+    XCTAssertEqual(proxy, self.SUT);
+    XCTAssertEqual(metrics.methodLatencies[@"echoString"].count, 1);
+    [self.reportExpectation fulfill];
+    self.reportExpectation = nil;
+}
+
+#pragma mark - Tests
+
+- (void) testMetricsDisabledByDefault {
+    XCTAssertFalse(self.SUT.metricsEnabled);
+    [self echoStrings:1];
+    XCTAssertNil(self.SUT.metricsSnapshot);
+}
+
+- (void) testMethodAndPhaseLatencies {
+    self.SUT.metricsEnabled = YES;
+    [self echoStrings:3];
+    JRPCMetricsSnapshot *metrics = self.SUT.metricsSnapshot;
+    JRPCHistogramSnapshot *latency = metrics.methodLatencies[@"echoString"];
+    XCTAssertEqual(latency.count, 3);
+    XCTAssertGreaterThan(latency.minimum, 0);
+    XCTAssertLessThanOrEqual(latency.minimum, [latency valueAtPercentile:50]);
+    XCTAssertLessThanOrEqual([latency valueAtPercentile:50], latency.maximum);
+    XCTAssertEqual(metrics.methodLatencies[@"notStubbed"].count, 0);
+    XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseTransport].count, 3);
+    if (self.transportStubPerformsSerialization) {
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseMarshalling].count, 3);
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseSerialization].count, 0);
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseDeserialization].count, 0);
+        XCTAssertEqual(metrics.bytesSent, 0);
+        // The transport calls back on rpcCompletionQueue, so completion blocks are called inline
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseCompletionQueue].count, 0);
+    }
+    else {
+        // JSON is written straight from the invocation
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseSerialization].count, 3);
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseDeserialization].count, 3);
+        XCTAssertGreaterThan(metrics.bytesSent, 0);
+        XCTAssertGreaterThan(metrics.bytesReceived, 0);
+        // Completion blocks are dispatched to the main queue
+        XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseCompletionQueue].count, 3);
+    }
+    XCTAssertEqual(metrics.callsInFlight, 0);
+    XCTAssertEqual(metrics.errorCounts.count, 0);
+}
+
+- (void) testNotificationBytesSent {
+    self.SUT.metricsEnabled = YES;
+    [self.SUT ping:42];
+    JRPCMetricsSnapshot *metrics = self.SUT.metricsSnapshot;
+    XCTAssertEqual(metrics.bytesSent, self.transportStubPerformsSerialization ? 0 : self.jsonRPCTransport.lastRequestData.length);
+    XCTAssertEqual(metrics.callsInFlight, 0);
+}
+
+- (void) testErrorCounts {
+    self.SUT.metricsEnabled = YES;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT notStubbed:@"foo" :^(NSString *result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorServerResponseCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.defaultTimeout = 0.05;
+    expectation = [self expectationWithDescription:@"json-rpc timeout expectation"];
+    [self.SUT echoString:@"foo" :^(NSString *result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTimedOutCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSDictionary *expected = @{ @(JRPCErrorServerResponseCode) : @1, @(JRPCErrorTimedOutCode) : @1 };
+    XCTAssertEqualObjects(self.SUT.metricsSnapshot.errorCounts, expected);
+    XCTAssertEqual(self.SUT.metricsSnapshot.methodLatencies[@"notStubbed"].count, 1);
+}
+
+- (void) testCallsInFlight {
+    self.SUT.metricsEnabled = YES;
+    self.jsonRPCTransport.withholdsResponses = YES;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoString:@"foo" :^(NSString *result, NSError *error) {
+        [expectation fulfill];
+    }];
+    XCTAssertEqual(self.SUT.metricsSnapshot.callsInFlight, 1);
+    [self.jsonRPCTransport releaseWithheldResponses];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.SUT.metricsSnapshot.callsInFlight, 0);
+}
+
+- (void) testResetMetrics {
+    self.SUT.metricsEnabled = YES;
+    [self echoStrings:2];
+    [self.SUT resetMetrics];
+    JRPCMetricsSnapshot *metrics = self.SUT.metricsSnapshot;
+    XCTAssertEqual(metrics.methodLatencies[@"echoString"].count, 0);
+    XCTAssertEqual([metrics latencyForPhase:JRPCMetricsPhaseTransport].count, 0);
+    XCTAssertEqual(metrics.bytesSent, 0);
+    [self echoStrings:1];
+    XCTAssertEqual(self.SUT.metricsSnapshot.methodLatencies[@"echoString"].count, 1);
+}
+
+- (void) testDisablingKeepsMetrics {
+    self.SUT.metricsEnabled = YES;
+    [self echoStrings:1];
+    self.SUT.metricsEnabled = NO;
+    [self echoStrings:1];
+    XCTAssertNil(self.SUT.metricsSnapshot);
+    self.SUT.metricsEnabled = YES;
+    XCTAssertEqual(self.SUT.metricsSnapshot.methodLatencies[@"echoString"].count, 1);
+}
+
+- (void) testDelegateReports {
+    self.SUT.metricsEnabled = YES;
+    [self echoStrings:1];
+    self.reportExpectation = [self expectationWithDescription:@"report expectation"];
+    self.SUT.metricsDelegate = self;
+    self.SUT.metricsReportInterval = 0.05;
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+@end
+
+@implementation JRPCProxyObjectMetricsTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
+
+@implementation JRPCHistogramTests
+
+- (void) testEmptyHistogram {
+    JRPCHistogramSnapshot *snapshot = [[[JRPCHistogram alloc] init] snapshot];
+    XCTAssertEqual(snapshot.count, 0);
+    XCTAssertEqual(snapshot.minimum, 0);
+    XCTAssertEqual(snapshot.maximum, 0);
+    XCTAssertEqual(snapshot.mean, 0);
+    XCTAssertEqual([snapshot valueAtPercentile:99], 0);
+}
+
+- (void) testPercentilesAreWithinBucketPrecision {
+    JRPCHistogram *histogram = [[JRPCHistogram alloc] init];
+    // 1 to 1000 microseconds
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        [histogram recordNanoseconds:i * NSEC_PER_USEC];
+    }
+    JRPCHistogramSnapshot *snapshot = [histogram snapshot];
+    XCTAssertEqual(snapshot.count, 1000);
+    XCTAssertEqualWithAccuracy(snapshot.minimum, 1e-6, 1e-12);
+    XCTAssertEqualWithAccuracy(snapshot.maximum, 1e-3, 1e-12);
+    XCTAssertEqualWithAccuracy(snapshot.mean, 500.5e-6, 1e-12);
+    XCTAssertEqualWithAccuracy([snapshot valueAtPercentile:50], 500e-6, 500e-6 / 16);
+    XCTAssertEqualWithAccuracy([snapshot valueAtPercentile:99], 990e-6, 990e-6 / 16);
+    XCTAssertEqualWithAccuracy([snapshot valueAtPercentile:100], 1e-3, 1e-12);
+    XCTAssertEqualWithAccuracy([snapshot valueAtPercentile:0], 1e-6, 1e-6 / 16);
+}
+
+- (void) testSmallValuesAreExact {
+    JRPCHistogram *histogram = [[JRPCHistogram alloc] init];
+    for (uint64_t i = 0; i < 32; ++i) {
+        [histogram recordNanoseconds:i];
+    }
+    JRPCHistogramSnapshot *snapshot = [histogram snapshot];
+    XCTAssertEqualWithAccuracy([snapshot valueAtPercentile:50], 15e-9, 1e-15);
+}
+
+- (void) testLongDurationsAreClamped {
+    JRPCHistogram *histogram = [[JRPCHistogram alloc] init];
+    [histogram recordNanoseconds:UINT64_MAX];
+    JRPCHistogramSnapshot *snapshot = [histogram snapshot];
+    XCTAssertEqual(snapshot.count, 1);
+    XCTAssertEqualWithAccuracy(snapshot.maximum, (double)((1ULL << 41) - 1) / NSEC_PER_SEC, 1e-9);
+}
+
+- (void) testConcurrentRecording {
+    JRPCHistogram *histogram = [[JRPCHistogram alloc] init];
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (uint64_t i = 1; i <= 1000; ++i) {
+            [histogram recordNanoseconds:i];
+        }
+    });
+    JRPCHistogramSnapshot *snapshot = [histogram snapshot];
+    XCTAssertEqual(snapshot.count, 8000);
+    XCTAssertEqualWithAccuracy(snapshot.minimum, 1e-9, 1e-15);
+    XCTAssertEqualWithAccuracy(snapshot.maximum, 1000e-9, 1e-15);
+}
+
+- (void) testReset {
+    JRPCHistogram *histogram = [[JRPCHistogram alloc] init];
+    [histogram recordNanoseconds:1000];
+    [histogram reset];
+    [histogram recordNanoseconds:10];
+    JRPCHistogramSnapshot *snapshot = [histogram snapshot];
+    XCTAssertEqual(snapshot.count, 1);
+    XCTAssertEqualWithAccuracy(snapshot.maximum, 10e-9, 1e-15);
+}
+
+@end
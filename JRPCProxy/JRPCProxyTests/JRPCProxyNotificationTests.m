@@ -0,0 +1,143 @@
+//
+//  JRPCProxyNotificationTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "NSDictionary+JSONRPC.h"
+
+/**
+ Test cases for JSON-RPC notifications, when the proxy performs serialization
+ */
+@interface JRPCProxyNotificationTests : JRPCProxyTestsBase
+@end
+
+/**
+ Test cases for JSON-RPC notifications, when the transport performs serialization
+ */
+@interface JRPCProxyObjectNotificationTests : JRPCProxyNotificationTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyNotificationTestsProtocol
+- (void) logMessage:(NSString*)message :(int)level;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyNotificationTestsProtocol>
+@end
+
+@protocol JRPCProxyNotificationTestsByNameProtocol
+- (void) logWithMessage:(NSString*)message level:(int)level;
+@end
+@interface JRPCAbstractProxy() <JRPCProxyNotificationTestsByNameProtocol>
+@end
+
+@implementation JRPCProxyNotificationTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyNotificationTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void) testNotificationIsSentWithoutId {
+    [self.SUT logMessage:@"Hello World!" :3];
+    NSDictionary *notification = self.jsonRPCTransport.receivedNotifications.firstObject;
+    XCTAssertEqual(self.jsonRPCTransport.receivedNotifications.count, 1);
+    XCTAssertNil(notification[kJSONRPCRequestIdKey]);
+    XCTAssertEqualObjects(notification[kJSONRPCVersionKey], @"2.0");
+    XCTAssertEqualObjects(notification[kJSONRPCMethodKey], @"logMessage");
+    XCTAssertEqualObjects(notification[kJSONRPCParamsKey], (@[ @"Hello World!", @3 ]));
+}
+
+- (void) testNotificationEncoding {
+    if (self.transportStubPerformsSerialization) {
+        // The encoded bytes are only visible when the proxy performs serialization
+        return;
+    }
+    [self.SUT logMessage:@"Hello World!" :3];
+    NSString *expected = @"{\"jsonrpc\":\"2.0\",\"method\":\"logMessage\",\"params\":[\"Hello World!\",3]}";
+    XCTAssertEqualObjects([[NSString alloc] initWithData:self.jsonRPCTransport.lastRequestData encoding:NSUTF8StringEncoding], expected);
+}
+
+- (void) testNotificationWithoutParams {
+    [self.SUT ping];
+    NSDictionary *notification = self.jsonRPCTransport.receivedNotifications.firstObject;
+    XCTAssertEqualObjects(notification[kJSONRPCMethodKey], @"ping");
+    XCTAssertNil(notification[kJSONRPCParamsKey]);
+    XCTAssertNil(notification[kJSONRPCRequestIdKey]);
+}
+
+- (void) testNotificationByName {
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCProxyNotificationTestsByNameProtocol)
+                                                     paramStructure:JRPCParameterStructureByName
+                                                          transport:self.jsonRPCTransport];
+    [proxy logWithMessage:@"Hello World!" level:3];
+    NSDictionary *notification = self.jsonRPCTransport.receivedNotifications.firstObject;
+    XCTAssertEqualObjects(notification[kJSONRPCMethodKey], @"log");
+    XCTAssertEqualObjects(notification[kJSONRPCParamsKey], (@{ @"message" : @"Hello World!", @"level" : @3 }));
+    XCTAssertNil(notification[kJSONRPCRequestIdKey]);
+}
+
+- (void) testNotificationIsNotBatched {
+    self.SUT.batchWindow = 0.1;
+    [self.SUT ping];
+    [self.SUT ping];
+    XCTAssertEqual(self.jsonRPCTransport.receivedNotifications.count, 2);
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 0);
+}
+
+- (void) testNotificationWithoutTransportSupportIsSentAsRequest {
+    JRPCProxyTransportStub *transport = [[JRPCProxyTransportStub alloc] init];
+    transport.performsSerialization = self.transportStubPerformsSerialization;
+    transport.supportsNotifications = NO;
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:self.protocol paramStructure:self.paramsStructure transport:transport];
+    [proxy logMessage:@"Hello World!" :3];
+    NSDictionary *notification = transport.receivedNotifications.firstObject;
+    XCTAssertEqual(transport.receivedNotifications.count, 1);
+    XCTAssertEqualObjects(notification[kJSONRPCMethodKey], @"logMessage");
+    XCTAssertNil(notification[kJSONRPCRequestIdKey]);
+}
+
+@end
+
+@implementation JRPCProxyObjectNotificationTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
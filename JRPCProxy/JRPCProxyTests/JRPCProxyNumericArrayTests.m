@@ -0,0 +1,269 @@
+//
+//  JRPCProxyNumericArrayTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCNumericArray.h"
+#import "JRPCJSONReader.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for numeric array params & results, when the proxy performs serialization
+ */
+@interface JRPCProxyNumericArrayTests : JRPCProxyTestsBase
+@end
+
+/**
+ Test cases for numeric array params & results, when the transport performs serialization
+ */
+@interface JRPCProxyObjectNumericArrayTests : JRPCProxyNumericArrayTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyNumericArrayTestsProtocol
+- (void) echoInt16s:(JRPCInt16Array*)values :(void (^)(JRPCInt16Array *result, NSError *error))completion;
+- (void) echoInt32s:(JRPCInt32Array*)values :(void (^)(JRPCInt32Array *result, NSError *error))completion;
+- (void) echoInt64s:(JRPCInt64Array*)values :(void (^)(JRPCInt64Array *result, NSError *error))completion;
+- (void) echoFloats:(JRPCFloatArray*)values :(void (^)(JRPCFloatArray *result, NSError *error))completion;
+- (void) echoDoubles:(JRPCDoubleArray*)values :(void (^)(JRPCDoubleArray *result, NSError *error))completion;
+- (void) sum:(JRPCDoubleArray*)values :(void (^)(double result, NSError *error))completion;
+- (void) range:(NSInteger)count :(void (^)(JRPCDoubleArray *result, NSError *error))completion;
+- (void) mixed:(void (^)(JRPCInt32Array *result, NSError *error))completion;
+- (void) huge:(void (^)(int result, NSError *error))completion;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyNumericArrayTestsProtocol>
+@end
+
+@implementation JRPCProxyNumericArrayTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyNumericArrayTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethods:@[ @"echoInt16s", @"echoInt32s", @"echoInt64s", @"echoFloats", @"echoDoubles" ] result:^id(id params) {
+        return params[0];
+    }];
+    [self.jsonRPCTransport configureMethod:@"sum" result:^id(id params) {
+        double sum = 0;
+        for (NSNumber *value in params[0]) {
+            sum += value.doubleValue;
+        }
+        return @(sum);
+    }];
+    [self.jsonRPCTransport configureMethod:@"range" result:^id(id params) {
+        NSInteger count = [params[0] integerValue];
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:count];
+        for (NSInteger i = 0; i < count; ++i) {
+            [values addObject:@(i * 0.5)];
+        }
+        return values;
+    }];
+    [self.jsonRPCTransport configureMethod:@"mixed" result:^id(id params) {
+        return @[ @1, @2.75, @-3.5, @YES ];
+    }];
+    [self.jsonRPCTransport configureMethod:@"huge" result:^id(id params) {
+        // Not integral, so it is read as a real
+        return @10000000000.5;
+    }];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSString*) lastRequestString {
+    return [[NSString alloc] initWithData:self.jsonRPCTransport.lastRequestData encoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - Tests
+
+- (void) testIntegerArraysRoundTrip {
+    int16_t int16s[] = { INT16_MIN, -1, 0, 1, INT16_MAX };
+    int32_t int32s[] = { INT32_MIN, -1, 0, 1, INT32_MAX };
+    int64_t int64s[] = { INT64_MIN, -1, 0, 1, INT64_MAX };
+    JRPCInt16Array *int16Array = [JRPCInt16Array arrayWithValues:int16s count:5];
+    JRPCInt32Array *int32Array = [JRPCInt32Array arrayWithValues:int32s count:5];
+    JRPCInt64Array *int64Array = [JRPCInt64Array arrayWithValues:int64s count:5];
+    XCTestExpectation *expectation16 = [self expectationWithDescription:@"json-rpc int16 expectation"];
+    [self.SUT echoInt16s:int16Array :^(JRPCInt16Array *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, int16Array);
+        [expectation16 fulfill];
+    }];
+    XCTestExpectation *expectation32 = [self expectationWithDescription:@"json-rpc int32 expectation"];
+    [self.SUT echoInt32s:int32Array :^(JRPCInt32Array *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, int32Array);
+        [expectation32 fulfill];
+    }];
+    XCTestExpectation *expectation64 = [self expectationWithDescription:@"json-rpc int64 expectation"];
+    [self.SUT echoInt64s:int64Array :^(JRPCInt64Array *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, int64Array);
+        XCTAssertEqual(result.values[0], INT64_MIN);
+        XCTAssertEqual(result.values[4], INT64_MAX);
+        [expectation64 fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testRealArraysRoundTrip {
+    float floats[] = { 0.1f, -1.5f, 1e38f, 1e-30f, 0, 16777216.0f };
+    double doubles[] = { 0.1, -1.5, 123456.789, 1e-10, 0, 1e300 };
+    JRPCFloatArray *floatArray = [JRPCFloatArray arrayWithValues:floats count:6];
+    JRPCDoubleArray *doubleArray = [JRPCDoubleArray arrayWithValues:doubles count:6];
+    XCTestExpectation *floatExpectation = [self expectationWithDescription:@"json-rpc float expectation"];
+    [self.SUT echoFloats:floatArray :^(JRPCFloatArray *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, floatArray);
+        [floatExpectation fulfill];
+    }];
+    XCTestExpectation *doubleExpectation = [self expectationWithDescription:@"json-rpc double expectation"];
+    [self.SUT echoDoubles:doubleArray :^(JRPCDoubleArray *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(result, doubleArray);
+        [doubleExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testEmptyArrayRoundTrips {
+    JRPCDoubleArray *empty = [JRPCDoubleArray arrayWithValues:NULL count:0];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoDoubles:empty :^(JRPCDoubleArray *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result.count, 0);
+        XCTAssertTrue([result isKindOfClass:[JRPCDoubleArray class]]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testParamIsSentAsArrayOfNumbers {
+    double doubles[] = { 1, 2.5, 3 };
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT sum:[JRPCDoubleArray arrayWithValues:doubles count:3] :^(double result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, 6.5);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    if (!self.transportStubPerformsSerialization) {
+        XCTAssertTrue([self.lastRequestString containsString:@"\"params\":[[1,2.5,3]]"], @"%@", self.lastRequestString);
+    }
+}
+
+- (void) testFloatsAreWrittenWithShortestDigits {
+    if (self.transportStubPerformsSerialization) {
+        return;
+    }
+    float floats[] = { 0.1f, 1.0f / 3.0f };
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT echoFloats:[JRPCFloatArray arrayWithValues:floats count:2] :^(JRPCFloatArray *result, NSError *error) {
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertTrue([self.lastRequestString containsString:@"\"params\":[[0.1,0.33333334]]"], @"%@", self.lastRequestString);
+}
+
+- (void) testLargeResult {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT range:100000 :^(JRPCDoubleArray *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result.count, 100000);
+        XCTAssertEqual(result.values[0], 0);
+        XCTAssertEqual(result.values[99999], 49999.5);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testNonFiniteElementsRaise {
+    double doubles[] = { 1, NAN };
+    float floats[] = { INFINITY };
+    XCTAssertThrowsSpecificNamed([self.SUT echoDoubles:[JRPCDoubleArray arrayWithValues:doubles count:2] :^(JRPCDoubleArray *result, NSError *error) {}],
+                                 NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT echoFloats:[JRPCFloatArray arrayWithValues:floats count:1] :^(JRPCFloatArray *result, NSError *error) {}],
+                                 NSException, NSInvalidArgumentException);
+}
+
+- (void) testInvalidDataRaises {
+    NSData *data = [NSData dataWithBytes:"\0\0\0" length:3];
+    XCTAssertThrowsSpecificNamed((void)[[JRPCInt16Array alloc] initWithData:data], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed((void)[[JRPCNumericArray alloc] initWithData:[NSData data]], NSException, NSInvalidArgumentException);
+    XCTAssertEqual([[JRPCInt16Array alloc] initWithData:[data subdataWithRange:NSMakeRange(0, 2)]].count, 1);
+}
+
+- (void) testElementsAreConvertedToElementType {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT mixed:^(JRPCInt32Array *result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result.count, 4);
+        XCTAssertEqual(result.values[0], 1);
+        XCTAssertEqual(result.values[1], 2);
+        XCTAssertEqual(result.values[2], -3);
+        XCTAssertEqual(result.values[3], 1);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testElementsOutOfRangeAreNotConverted {
+    XCTAssertNil([[JRPCInt16Array alloc] initWithJSONRPCResponseResult:@[ @1, @40000.5 ]]);
+    XCTAssertNil([[JRPCInt32Array alloc] initWithJSONRPCResponseResult:@[ @(NAN) ]]);
+    XCTAssertNil([[JRPCInt64Array alloc] initWithJSONRPCResponseResult:@[ @1e19 ]]);
+    XCTAssertEqual([[JRPCInt64Array alloc] initWithJSONRPCResponseResult:@[ @-9.2e18 ]].count, 1);
+    const char *text = "[1,1e10]";
+    XCTAssertNil(JRPCJSONReadNumericArray((const uint8_t*)text, strlen(text), 'i'));
+    XCTAssertNotNil(JRPCJSONReadNumericArray((const uint8_t*)text, strlen(text), 'q'));
+}
+
+- (void) testResultOutOfRangeIsError {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT huge:^(int result, NSError *error) {
+        XCTAssertEqual(result, 0);
+        XCTAssertEqual(error.code, JRPCErrorResponseSerializationCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+@end
+
+@implementation JRPCProxyObjectNumericArrayTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,148 @@
+//
+//  JRPCProxyRequestEncodingTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+
+/**
+ Test cases for the JSON text of requests encoded by the proxy, when the transport does not perform serialization
+ */
+@interface JRPCProxyRequestEncodingTests : JRPCProxyTestsBase
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyRequestEncodingTestsProtocol
+- (void) methodTakesNoParamsReturnsHelloWorldString:(void (^)(NSString *result, NSError *error))completion;
+- (void) addIntegers:(NSInteger)first :(NSInteger)second :(void (^)(NSInteger result, NSError *error))completion;
+- (void) echoBool:(BOOL)value :(void (^)(BOOL result, NSError *error))completion;
+- (void) echoDouble:(double)value :(void (^)(double result, NSError *error))completion;
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoObject:(id)value :(void (^)(id result, NSError *error))completion;
+@end
+
+@protocol JRPCProxyRequestEncodingTestsByNameProtocol
+- (void) appendStringsWithString1:(NSString*)string1 string2:(NSString*)string2 completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyRequestEncodingTestsProtocol, JRPCProxyRequestEncodingTestsByNameProtocol>
+@end
+
+@implementation JRPCProxyRequestEncodingTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyRequestEncodingTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    self.transportStubPerformsSerialization = NO;
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSString*) lastRequestString {
+    return [[NSString alloc] initWithData:self.jsonRPCTransport.lastRequestData encoding:NSUTF8StringEncoding];
+}
+
+- (NSDictionary*) lastRequest {
+    return [NSJSONSerialization JSONObjectWithData:self.jsonRPCTransport.lastRequestData options:0 error:nil];
+}
+
+#pragma mark - Tests
+
+- (void) testRequestLayout {
+    [self.SUT addIntegers:-42 :2017 :^(NSInteger result, NSError *error) {}];
+    XCTAssertEqualObjects([self lastRequestString], @"{\"jsonrpc\":\"2.0\",\"method\":\"addIntegers\",\"params\":[-42,2017],\"id\":0}");
+    [self.SUT echoBool:YES :^(BOOL result, NSError *error) {}];
+    XCTAssertEqualObjects([self lastRequestString], @"{\"jsonrpc\":\"2.0\",\"method\":\"echoBool\",\"params\":[true],\"id\":1}");
+}
+
+- (void) testRequestWithoutParamsOmitsParams {
+    [self.SUT methodTakesNoParamsReturnsHelloWorldString:^(NSString *result, NSError *error) {}];
+    XCTAssertEqualObjects([self lastRequestString], @"{\"jsonrpc\":\"2.0\",\"method\":\"methodTakesNoParamsReturnsHelloWorldString\",\"id\":0}");
+}
+
+- (void) testByNameRequestLayout {
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCProxyRequestEncodingTestsByNameProtocol)
+                                                    paramStructure:JRPCParameterStructureByName
+                                                         transport:self.jsonRPCTransport];
+    [proxy appendStringsWithString1:@"Hello " string2:@"World!" completion:^(NSString *result, NSError *error) {}];
+    XCTAssertEqualObjects([self lastRequestString], @"{\"jsonrpc\":\"2.0\",\"method\":\"appendStrings\",\"params\":{\"string1\":\"Hello \",\"string2\":\"World!\"},\"id\":0}");
+}
+
+- (void) testStringEscapingMatchesNSJSONSerialization {
+    NSArray<NSString*> *strings = @[ @"Hello World!", @"", @"quote\" backslash\\ slash/", @"\b\f\n\r\t\x01\x1f", @"café ☃ \U0001F600",
+                                     [@"" stringByPaddingToLength:5000 withString:@"é\n" startingAtIndex:0] ];
+    NSUInteger requestId = 0;
+    for (NSString *string in strings) {
+        [self.SUT echoString:string :^(NSString *result, NSError *error) {}];
+        // Params arrays are ordered, so the encoding can be compared byte for byte
+        NSData *params = [NSJSONSerialization dataWithJSONObject:@[string] options:0 error:nil];
+        NSString *expected = [NSString stringWithFormat:@"{\"jsonrpc\":\"2.0\",\"method\":\"echoString\",\"params\":%@,\"id\":%lu}",
+                              [[NSString alloc] initWithData:params encoding:NSUTF8StringEncoding], (unsigned long)requestId++];
+        XCTAssertEqualObjects([self lastRequestString], expected);
+    }
+}
+
+- (void) testObjectParamsMatchNSJSONSerialization {
+    NSArray *objects = @[ @[ @0, @-1, @(-2000000000), @(4000000000ULL), @0.5, @YES, @NO, [NSNull null] ],
+                          @{ @"string" : @"Hello World!", @"nested" : @{ @"array" : @[ @1, @[ @2 ] ] }, @"number" : @(M_PI) },
+                          @[] ];
+    for (id object in objects) {
+        [self.SUT echoObject:object :^(id result, NSError *error) {}];
+        // Dictionary key order is unspecified, so compare parsed objects
+        XCTAssertEqualObjects([self lastRequest][@"params"], @[object]);
+    }
+}
+
+- (void) testDoubleParamsRoundTrip {
+    double values[] = { M_PI, 0.1, 1e-7, -2.5e300, 42.0, (double)(float)M_PI, DBL_MIN, DBL_MAX };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        [self.SUT echoDouble:values[i] :^(double result, NSError *error) {}];
+        XCTAssertEqual([[self lastRequest][@"params"][0] doubleValue], values[i]);
+    }
+}
+
+- (void) testNegativeZeroParamKeepsItsSign {
+    [self.SUT echoDouble:-0.0 :^(double result, NSError *error) {}];
+    XCTAssertTrue([[self lastRequestString] containsString:@"\"params\":[-0.0]"], @"%@", [self lastRequestString]);
+    [self.SUT echoDouble:0.0 :^(double result, NSError *error) {}];
+    XCTAssertTrue([[self lastRequestString] containsString:@"\"params\":[0]"], @"%@", [self lastRequestString]);
+}
+
+- (void) testNonFiniteDoubleParamRaises {
+    void (^completion)(double, NSError*) = ^(double result, NSError *error) {
+        XCTFail(@"Completion should not be called");
+    };
+    XCTAssertThrowsSpecificNamed([self.SUT echoDouble:NAN :completion], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT echoDouble:INFINITY :completion], NSException, NSInvalidArgumentException);
+}
+
+@end
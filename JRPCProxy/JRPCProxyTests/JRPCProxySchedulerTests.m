@@ -0,0 +1,246 @@
+//
+//  JRPCProxySchedulerTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for limiting the calls in flight, when the proxy performs serialization
+ */
+@interface JRPCProxySchedulerTests : JRPCProxyTestsBase
+// The params of the calls, in the order the stub received them
+@property (nonatomic, strong) NSMutableArray<NSNumber*> *receivedValues;
+@end
+
+/**
+ Test cases for limiting the calls in flight, when the transport performs serialization
+ */
+@interface JRPCProxyObjectSchedulerTests : JRPCProxySchedulerTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxySchedulerTestsProtocol
+- (void) interactive:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) standard:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) background:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxySchedulerTestsProtocol>
+@end
+
+@implementation JRPCProxySchedulerTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxySchedulerTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    self.receivedValues = [[NSMutableArray alloc] init];
+    __weak typeof(self) weakSelf = self;
+    [self.jsonRPCTransport configureMethods:@[ @"interactive", @"standard", @"background" ] result:^id(id params) {
+        // Requests may be sent from any thread
+        NSMutableArray<NSNumber*> *receivedValues = weakSelf.receivedValues;
+        @synchronized (receivedValues) {
+            [receivedValues addObject:params[0]];
+        }
+        return params[0];
+    }];
+    [self.SUT setPriority:JRPCCallPriorityInteractive forSelector:@selector(interactive::)];
+    [self.SUT setPriority:JRPCCallPriorityBulk forSelector:@selector(background::)];
+}
+
+- (void)tearDown {
+    self.receivedValues = nil;
+    [super tearDown];
+}
+
+- (XCTestExpectation*) call:(SEL)selector value:(int)value {
+    XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc expectation %@ %i", NSStringFromSelector(selector), value]];
+    void (^completion)(int, NSError*) = ^(int result, NSError *error) {
+        XCTAssertEqual(result, value);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    };
+    if (sel_isEqual(selector, @selector(interactive::))) {
+        [self.SUT interactive:value :completion];
+    }
+    else if (sel_isEqual(selector, @selector(background::))) {
+        [self.SUT background:value :completion];
+    }
+    else {
+        [self.SUT standard:value :completion];
+    }
+    return expectation;
+}
+
+// Returns the 99th percentile latency of interactive calls made one at a time
+- (NSTimeInterval) interactiveP99WithCallCount:(NSUInteger)callCount {
+    NSMutableArray<NSNumber*> *latencies = [[NSMutableArray alloc] initWithCapacity:callCount];
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    for (NSUInteger i = 0; i < callCount; ++i) {
+        NSDate *start = [NSDate date];
+        [waiter waitForExpectations:@[ [self call:@selector(interactive::) value:(int)i] ] timeout:60.0];
+        [latencies addObject:@(-start.timeIntervalSinceNow)];
+    }
+    [latencies sortUsingSelector:@selector(compare:)];
+    NSUInteger index = (NSUInteger)ceil(0.99 * callCount) - 1;
+    return latencies[index].doubleValue;
+}
+
+#pragma mark - Tests
+
+- (void) testCallsBeyondLimitWait {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.maxConcurrentCalls = 2;
+    for (int i = 0; i < 5; ++i) {
+        [self call:@selector(standard::) value:i];
+    }
+    JRPCSchedulerStatistics statistics = self.SUT.schedulerStatistics;
+    XCTAssertEqual(statistics.inFlightCount, 2);
+    XCTAssertEqual(statistics.lanes[JRPCCallPriorityDefault].queueDepth, 3);
+    XCTAssertEqual(self.receivedValues.count, 2);
+    self.jsonRPCTransport.withholdsResponses = NO;
+    [self.jsonRPCTransport releaseWithheldResponses];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    statistics = self.SUT.schedulerStatistics;
+    XCTAssertEqual(statistics.inFlightCount, 0);
+    XCTAssertEqual(statistics.lanes[JRPCCallPriorityDefault].queueDepth, 0);
+    XCTAssertEqual(statistics.lanes[JRPCCallPriorityDefault].sentCount, 5);
+    XCTAssertGreaterThan(statistics.lanes[JRPCCallPriorityDefault].maxWaitTime, 0);
+}
+
+- (void) testTimedOutCallsFreeTheirSlots {
+    // Calls time out while they wait & while they are in flight, some as soon as they are made
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.maxConcurrentCalls = 2;
+    self.SUT.adaptsConcurrencyLimit = NO;
+    self.SUT.defaultTimeout = 0.0001;
+    for (int i = 0; i < 200; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc expectation %i", i]];
+        [self.SUT standard:i :^(int result, NSError *error) {
+            XCTAssertEqual(error.code, JRPCErrorTimedOutCode);
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    JRPCSchedulerStatistics statistics = self.SUT.schedulerStatistics;
+    XCTAssertEqual(statistics.inFlightCount, 0);
+    XCTAssertEqual(statistics.lanes[JRPCCallPriorityDefault].queueDepth, 0);
+    // Every slot is free for the calls that follow, which would otherwise never be sent
+    self.jsonRPCTransport.withholdsResponses = NO;
+    self.SUT.defaultTimeout = 0;
+    for (int i = 0; i < 2; ++i) {
+        [self call:@selector(standard::) value:i];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testHigherPrioritiesAreSentFirst {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.maxConcurrentCalls = 1;
+    self.SUT.adaptsConcurrencyLimit = NO;
+    [self call:@selector(background::) value:1];
+    [self call:@selector(background::) value:2];
+    [self call:@selector(standard::) value:3];
+    [self call:@selector(interactive::) value:4];
+    self.jsonRPCTransport.withholdsResponses = NO;
+    [self.jsonRPCTransport releaseWithheldResponses];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqualObjects(self.receivedValues, (@[ @1, @4, @3, @2 ]));
+}
+
+- (void) testInteractiveLatencyIsFlatUnderBulkFlood {
+    const int bulkCallCount = 400;
+    self.jsonRPCTransport.responseLatency = 0.01;
+    self.SUT.maxConcurrentCalls = 4;
+    // Keep completions off the main queue, so they do not queue behind each other there
+    self.SUT.rpcCompletionQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    NSTimeInterval baselineP99 = [self interactiveP99WithCallCount:20];
+    
+    // Sent one after another, the flood takes about bulkCallCount / maxConcurrentCalls * responseLatency = 1s
+    XCTestExpectation *bulkExpectation = [self expectationWithDescription:@"json-rpc bulk expectation"];
+    __block int completedCount = 0;
+    NSObject *lock = [[NSObject alloc] init];
+    for (int i = 0; i < bulkCallCount; ++i) {
+        [self.SUT background:i :^(int result, NSError *error) {
+            @synchronized (lock) {
+                if (++completedCount == bulkCallCount) {
+                    [bulkExpectation fulfill];
+                }
+            }
+        }];
+    }
+    NSTimeInterval floodP99 = [self interactiveP99WithCallCount:20];
+    XCTAssertGreaterThan(self.SUT.schedulerStatistics.lanes[JRPCCallPriorityBulk].queueDepth, 0, @"The flood should outlast the interactive calls");
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSLog(@"%s - interactive p99 %.1fms alone, %.1fms under flood", __func__, baselineP99 * 1000.0, floodP99 * 1000.0);
+    // An interactive call waits for at most one slot to free up, never for the flood
+    XCTAssertLessThan(floodP99, baselineP99 + 0.1);
+    JRPCSchedulerStatistics statistics = self.SUT.schedulerStatistics;
+    XCTAssertLessThan(statistics.lanes[JRPCCallPriorityInteractive].maxWaitTime, statistics.lanes[JRPCCallPriorityBulk].maxWaitTime);
+}
+
+- (void) testLimitAdaptsToLatency {
+    self.SUT.maxConcurrentCalls = 16;
+    self.SUT.rpcCompletionQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    self.jsonRPCTransport.responseLatency = 0.005;
+    for (int i = 0; i < 50; ++i) {
+        [self call:@selector(standard::) value:i];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    // Responses now take ten times as long, which the scheduler reads as congestion
+    self.jsonRPCTransport.responseLatency = 0.05;
+    for (int i = 0; i < 50; ++i) {
+        [self call:@selector(standard::) value:i];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertLessThan(self.SUT.schedulerStatistics.concurrencyLimit, 16);
+}
+
+- (void) testFixedLimit {
+    self.SUT.maxConcurrentCalls = 3;
+    self.SUT.adaptsConcurrencyLimit = NO;
+    XCTAssertEqual(self.SUT.schedulerStatistics.concurrencyLimit, 3);
+}
+
+- (void) testPriorityForNotificationRaises {
+    XCTAssertThrowsSpecificNamed([self.SUT setPriority:JRPCCallPriorityBulk forSelector:@selector(ping)], NSException, NSInvalidArgumentException);
+}
+
+@end
+
+@implementation JRPCProxyObjectSchedulerTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,264 @@
+//
+//  JRPCProxyStreamingTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for completion blocks streaming array results, when the proxy performs serialization
+ */
+@interface JRPCProxyStreamingTests : JRPCProxyTestsBase
+@end
+
+/**
+ Test cases for completion blocks streaming array results, when the transport uses dispatch data
+ */
+@interface JRPCProxyDispatchDataStreamingTests : JRPCProxyStreamingTests
+@end
+
+/**
+ Test cases for completion blocks streaming array results, when the transport performs serialization
+ */
+@interface JRPCProxyObjectStreamingTests : JRPCProxyStreamingTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyStreamingTestsProtocol
+- (void) numbers:(NSInteger)count :(void (^)(NSNumber *element, BOOL done, NSError *error))completion;
+- (void) results:(NSInteger)count :(void (^)(JRPCTestTransformableResult *element, BOOL done, NSError *error))completion;
+- (void) anything:(void (^)(id element, BOOL done, NSError *error))completion;
+- (void) numberChunks:(NSInteger)count :(void (^)(NSArray<NSNumber*> *chunk, BOOL done, NSError *error))completion;
+- (void) resultChunks:(NSInteger)count :(void (^)(NSArray<JRPCTestTransformableResult*> *chunk, BOOL done, NSError *error))completion;
+- (void) failure:(void (^)(NSNumber *element, BOOL done, NSError *error))completion;
+- (void) notifyWithValue:(NSInteger)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyStreamingTestsProtocol>
+@end
+
+@implementation JRPCProxyStreamingTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyStreamingTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethods:@[ @"numbers", @"numberChunks" ] result:^id(id params) {
+        NSInteger count = [params[0] integerValue];
+        if (count < 0) {
+            return @"not an array";
+        }
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:count];
+        for (NSInteger i = 0; i < count; ++i) {
+            [values addObject:@(i)];
+        }
+        return values;
+    }];
+    [self.jsonRPCTransport configureMethods:@[ @"results", @"resultChunks" ] result:^id(id params) {
+        NSInteger count = [params[0] integerValue];
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:count];
+        for (NSInteger i = 0; i < count; ++i) {
+            [values addObject:@{ @"string" : [NSString stringWithFormat:@"%ld", (long)i], @"unsignedInteger" : @(i) }];
+        }
+        return values;
+    }];
+    [self.jsonRPCTransport configureMethod:@"anything" result:^id(id params) {
+        return @[ @1, @"two", @{ @"three" : @3 }, @[ @4 ], [NSNull null] ];
+    }];
+    [self.jsonRPCTransport configureMethod:@"failure" errorCode:-32000 errorMessage:@"Failed" errorData:nil];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+// Collects what a streaming completion block is passed before it is done, and the error it is done with
+- (void (^)(id, BOOL, NSError*)) streamCollectingInto:(NSMutableArray*)elements
+                                                error:(NSError * __strong *)error
+                                          expectation:(XCTestExpectation*)expectation {
+    __block BOOL finished = NO;
+    return ^(id elementOrChunk, BOOL done, NSError *doneError) {
+        XCTAssertFalse(finished, @"Called after done");
+        if (!done) {
+            XCTAssertNil(doneError);
+            XCTAssertNotNil(elementOrChunk);
+            [elements addObject:elementOrChunk];
+            return;
+        }
+        XCTAssertNil(elementOrChunk);
+        finished = YES;
+        *error = doneError;
+        [expectation fulfill];
+    };
+}
+
+#pragma mark - Tests
+
+- (void) testElementsAreStreamedThenDone {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numbers:1000 :[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertEqual(elements.count, 1000);
+    XCTAssertEqualObjects(elements.firstObject, @0);
+    XCTAssertEqualObjects(elements.lastObject, @999);
+}
+
+- (void) testElementsAreTransformedToDeclaredClass {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT results:3 :[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertEqual(elements.count, 3);
+    for (NSUInteger i = 0; i < elements.count; ++i) {
+        XCTAssertTrue([elements[i] isKindOfClass:[JRPCTestTransformableResult class]]);
+        XCTAssertEqual([elements[i] unsignedInteger], i);
+    }
+}
+
+- (void) testIdElementsArePassedAsTheyAre {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT anything:[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(elements, (@[ @1, @"two", @{ @"three" : @3 }, @[ @4 ], [NSNull null] ]));
+}
+
+- (void) testChunksOfDefaultSize {
+    NSMutableArray *chunks = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numberChunks:250 :[self streamCollectingInto:chunks error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertEqual(chunks.count, 3);
+    XCTAssertEqual([chunks[0] count], 100);
+    XCTAssertEqual([chunks[1] count], 100);
+    XCTAssertEqual([chunks[2] count], 50);
+    XCTAssertEqualObjects([chunks[1] firstObject], @100);
+    XCTAssertEqualObjects([chunks[2] lastObject], @249);
+}
+
+- (void) testChunkSizeAndElementClassForSelector {
+    [self.SUT setResultChunkSize:4 elementClass:[JRPCTestTransformableResult class] forSelector:@selector(resultChunks::)];
+    NSMutableArray *chunks = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT resultChunks:10 :[self streamCollectingInto:chunks error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([chunks valueForKey:@"@count"], (@[ @4, @4, @2 ]));
+    JRPCTestTransformableResult *last = [chunks.lastObject lastObject];
+    XCTAssertTrue([last isKindOfClass:[JRPCTestTransformableResult class]]);
+    XCTAssertEqualObjects(last.string, @"9");
+}
+
+- (void) testEmptyResultIsOnlyDone {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numbers:0 :[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    NSMutableArray *chunks = [[NSMutableArray alloc] init];
+    NSError *chunkError = nil;
+    [self.SUT numberChunks:0 :[self streamCollectingInto:chunks error:&chunkError expectation:[self expectationWithDescription:@"json-rpc chunk expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertNil(error);
+    XCTAssertNil(chunkError);
+    XCTAssertEqual(elements.count, 0);
+    XCTAssertEqual(chunks.count, 0);
+}
+
+- (void) testServerErrorIsOnlyDone {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT failure:[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(elements.count, 0);
+    XCTAssertEqual(error.code, JRPCErrorServerResponseCode);
+    XCTAssertEqual([error.userInfo[kJRPCErrorCodeKey] integerValue], -32000);
+}
+
+- (void) testResultThatIsNotAnArrayIsSerializationError {
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numbers:-1 :[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(elements.count, 0);
+    XCTAssertEqualObjects(error.domain, JRPCErrorDomain);
+    XCTAssertEqual(error.code, JRPCErrorResponseSerializationCode);
+}
+
+- (void) testElementOfWrongClassEndsStream {
+    // The elements before the one that is not an NSNumber are still passed
+    [self.jsonRPCTransport configureMethod:@"numbers" result:^id(id params) {
+        return @[ @1, @2, @"three", @4 ];
+    }];
+    NSMutableArray *elements = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numbers:4 :[self streamCollectingInto:elements error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqualObjects(elements, (@[ @1, @2 ]));
+    XCTAssertEqual(error.code, JRPCErrorResponseSerializationCode);
+}
+
+- (void) testChunkElementOfWrongClassEndsStream {
+    [self.SUT setResultChunkSize:2 elementClass:[JRPCTestTransformableResult class] forSelector:@selector(numberChunks::)];
+    NSMutableArray *chunks = [[NSMutableArray alloc] init];
+    NSError *error = nil;
+    [self.SUT numberChunks:3 :[self streamCollectingInto:chunks error:&error expectation:[self expectationWithDescription:@"json-rpc expectation"]]];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(chunks.count, 0);
+    XCTAssertEqual(error.code, JRPCErrorResponseSerializationCode);
+}
+
+- (void) testSetResultChunkSizeRaisesForMethodsWithoutCompletionBlock {
+    XCTAssertThrowsSpecificNamed([self.SUT setResultChunkSize:10 elementClass:Nil forSelector:@selector(notifyWithValue:)], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([self.SUT setResultChunkSize:10 elementClass:Nil forSelector:@selector(description)], NSException, NSInvalidArgumentException);
+}
+
+@end
+
+@implementation JRPCProxyDispatchDataStreamingTests
+
+- (void)setUp {
+    self.transportStubUsesDispatchData = YES;
+    [super setUp];
+}
+
+@end
+
+@implementation JRPCProxyObjectStreamingTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -28,6 +28,7 @@
  */
 
 #import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
 
 @interface JRPCProxyTests : JRPCProxyTestsBase
 @end
@@ -40,6 +41,29 @@
 @interface JRPCAbstractProxy() <JRPCProxyTestsProtocol>
 @end
 
+// Protocols that do not follow the proxy conventions, and should be rejected when the proxy is created
+@protocol JRPCProxyTestsUnsupportedParamTypeProtocol
+- (void) methodWithRange:(NSRange)range completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
+@protocol JRPCProxyTestsNonVoidReturnProtocol
+- (NSString*) methodReturnsStringWithString:(NSString*)string completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
+@protocol JRPCProxyTestsByNameMissingWithProtocol
+- (void) method:(NSString*)string completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
+// Methods without a completion block are proxied as notifications
+@protocol JRPCProxyTestsNoCompletionProtocol
+- (void) methodWithString:(NSString*)string;
+@end
+
+// Adopted protocols are proxied too
+@protocol JRPCProxyTestsAdoptingProtocol <JRPCProxyTestsProtocol>
+- (void) otherMethodWithString:(NSString*)string completion:(void (^)(NSString *result, NSError *error))completion;
+@end
+
 @implementation JRPCProxyTests
 
 - (void)setUp {
@@ -66,4 +90,36 @@
     XCTAssertEqual(expected, responds);
 }
 
+- (void) testProxyRejectsUnsupportedParamType {
+    XCTAssertThrowsSpecificNamed([self proxyForProtocol:@protocol(JRPCProxyTestsUnsupportedParamTypeProtocol)], NSException, NSInvalidArgumentException);
+}
+
+- (void) testProxyRejectsNonVoidReturn {
+    XCTAssertThrowsSpecificNamed([self proxyForProtocol:@protocol(JRPCProxyTestsNonVoidReturnProtocol)], NSException, NSInvalidArgumentException);
+}
+
+- (void) testProxyAcceptsMissingCompletionAsNotification {
+    id proxy = nil;
+    XCTAssertNoThrow(proxy = [self proxyForProtocol:@protocol(JRPCProxyTestsNoCompletionProtocol)]);
+    XCTAssertTrue([proxy respondsToSelector:@selector(methodWithString:)]);
+}
+
+- (void) testProxyRejectsByNameSelectorWithoutWith {
+    XCTAssertThrowsSpecificNamed([self proxyForProtocol:@protocol(JRPCProxyTestsByNameMissingWithProtocol)], NSException, NSInvalidArgumentException);
+}
+
+- (void) testProxyRespondsToAdoptedProtocolSelector {
+    id proxy = [self proxyForProtocol:@protocol(JRPCProxyTestsAdoptingProtocol)];
+    XCTAssertTrue([proxy respondsToSelector:@selector(otherMethodWithString:completion:)]);
+    XCTAssertTrue([proxy respondsToSelector:@selector(methodWithString:completion:)]);
+}
+
+#pragma mark - Private
+
+- (id) proxyForProtocol:(Protocol*)protocol {
+    return [JRPCAbstractProxy proxyForProtocol:protocol
+                                paramStructure:JRPCParameterStructureByName
+                                     transport:[[JRPCProxyTransportStub alloc] init]];
+}
+
 @end
@@ -46,6 +46,10 @@
 /** Determines whether the stubbed transport should perform serialization (YES), or whether the SUT (de)serializes requests/responses.
     Should be set by sub-classes BEFORE calling [super setup] */
 @property (nonatomic, assign) BOOL transportStubPerformsSerialization;
+/** Determines whether the stubbed transport implements the dispatch data methods, which the SUT then uses. Should be set by sub-classes BEFORE calling [super setup] */
+@property (nonatomic, assign) BOOL transportStubUsesDispatchData;
+/** The stubbed transport used by the SUT */
+@property (nonatomic, readonly) JRPCProxyTransportStub *jsonRPCTransport;
 @end
 
 @interface JRPCTestTransformableResult : NSObject <JRPCTransformable>
@@ -52,6 +52,7 @@
     [super setUp];
     self.jsonRPCTransport = [[JRPCProxyTransportStub alloc] init];
     self.jsonRPCTransport.performsSerialization = self.transportStubPerformsSerialization;
+    self.jsonRPCTransport.usesDispatchData = self.transportStubUsesDispatchData;
     self.SUT = [JRPCAbstractProxy proxyForProtocol:self.protocol
                                               paramStructure:self.paramsStructure
                                                    transport:self.jsonRPCTransport];
@@ -0,0 +1,220 @@
+//
+//  JRPCProxyTimeoutTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for call timeouts & cancellation, when the proxy performs serialization
+ */
+@interface JRPCProxyTimeoutTests : JRPCProxyTestsBase
+@end
+
+/**
+ Test cases for call timeouts & cancellation, when the transport performs serialization
+ */
+@interface JRPCProxyObjectTimeoutTests : JRPCProxyTimeoutTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyTimeoutTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoInt:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyTimeoutTestsProtocol>
+@end
+
+@implementation JRPCProxyTimeoutTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyTimeoutTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (XCTestExpectation*) echoStringExpectingErrorCode:(NSInteger)errorCode {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    expectation.assertForOverFulfill = YES;
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        if (errorCode) {
+            XCTAssertNil(result);
+            XCTAssertEqualObjects(error.domain, JRPCErrorDomain);
+            XCTAssertEqual(error.code, errorCode);
+        }
+        else {
+            XCTAssertEqualObjects(result, @"Hello World!");
+            XCTAssertNil(error);
+        }
+        [expectation fulfill];
+    }];
+    return expectation;
+}
+
+// Sends any withheld responses, and gives them time to arrive
+- (void) releaseWithheldResponses {
+    [self.jsonRPCTransport releaseWithheldResponses];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"interval expectation"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+#pragma mark - Tests
+
+- (void) testDefaultTimeout {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.defaultTimeout = 0.05;
+    [self echoStringExpectingErrorCode:JRPCErrorTimedOutCode];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqualObjects(self.jsonRPCTransport.cancelledRequestIds, @[ @0 ]);
+    // The late response is discarded, rather than calling the completion block again
+    [self releaseWithheldResponses];
+}
+
+- (void) testMethodTimeoutOverridesDefault {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.defaultTimeout = 60.0;
+    [self.SUT setTimeout:0.05 forSelector:@selector(echoString::)];
+    [self echoStringExpectingErrorCode:JRPCErrorTimedOutCode];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void) testMethodWithoutTimeout {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    self.SUT.defaultTimeout = 0.05;
+    [self.SUT setTimeout:0 forSelector:@selector(echoString::)];
+    [self echoStringExpectingErrorCode:0];
+    [self releaseWithheldResponses];
+    XCTAssertEqual(self.jsonRPCTransport.cancelledRequestIds.count, 0);
+}
+
+- (void) testResponseBeforeTimeout {
+    self.SUT.defaultTimeout = 60.0;
+    [self echoStringExpectingErrorCode:0];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+- (void) testCompletedCallIsReleasedBeforeTimeout {
+    self.SUT.defaultTimeout = 3600.0;
+    __weak id<JRPCCall> weakCall = nil;
+    @autoreleasepool {
+        id<JRPCCall> call = [self.SUT callWithHandle:^{
+            [self echoStringExpectingErrorCode:0];
+        }];
+        weakCall = call;
+        [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    }
+    // Once whatever the transport & completion queue still hold has been let go, nothing waits for the timeout to keep the call alive
+    [self releaseWithheldResponses];
+    XCTAssertNil(weakCall);
+}
+
+- (void) testCancel {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    id<JRPCCall> call = [self.SUT callWithHandle:^{
+        [self echoStringExpectingErrorCode:JRPCErrorCancelledCode];
+    }];
+    XCTAssertNotNil(call);
+    XCTAssertFalse(call.completed);
+    [call cancel];
+    XCTAssertTrue(call.completed);
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqualObjects(self.jsonRPCTransport.cancelledRequestIds, @[ @0 ]);
+    [self releaseWithheldResponses];
+}
+
+- (void) testCancelAfterCompletionIsIgnored {
+    id<JRPCCall> call = [self.SUT callWithHandle:^{
+        [self echoStringExpectingErrorCode:0];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertTrue(call.completed);
+    [call cancel];
+    XCTAssertEqual(self.jsonRPCTransport.cancelledRequestIds.count, 0);
+}
+
+- (void) testHandleIsForFirstCall {
+    self.jsonRPCTransport.withholdsResponses = YES;
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc int expectation"];
+    id<JRPCCall> call = [self.SUT callWithHandle:^{
+        [self echoStringExpectingErrorCode:JRPCErrorCancelledCode];
+        [self.SUT echoInt:42 :^(int result, NSError *error) {
+            XCTAssertEqual(result, 42);
+            [intExpectation fulfill];
+        }];
+    }];
+    [call cancel];
+    [self.jsonRPCTransport releaseWithheldResponses];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testNoHandleForNotification {
+    XCTAssertNil([self.SUT callWithHandle:^{
+        [self.SUT ping];
+    }]);
+}
+
+- (void) testCancelledCallIsNotBatched {
+    self.SUT.batchWindow = 0.05;
+    id<JRPCCall> call = [self.SUT callWithHandle:^{
+        [self echoStringExpectingErrorCode:JRPCErrorCancelledCode];
+    }];
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc int expectation"];
+    [self.SUT echoInt:42 :^(int result, NSError *error) {
+        XCTAssertEqual(result, 42);
+        [intExpectation fulfill];
+    }];
+    [call cancel];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    // Only the remaining call was sent, on its own
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 0);
+}
+
+- (void) testTimeoutForNotificationRaises {
+    XCTAssertThrowsSpecificNamed([self.SUT setTimeout:1.0 forSelector:@selector(ping)], NSException, NSInvalidArgumentException);
+}
+
+@end
+
+@implementation JRPCProxyObjectTimeoutTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
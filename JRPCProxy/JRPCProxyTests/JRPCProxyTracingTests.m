@@ -0,0 +1,422 @@
+//
+//  JRPCProxyTracingTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import "JRPCProxyTestsBase.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCDispatcher.h"
+#import "JRPCError.h"
+#import "JRPCCallTrace.h"
+
+/**
+ Test cases for tracing, when the proxy performs serialization
+ */
+@interface JRPCProxyTracingTests : JRPCProxyTestsBase
+@property (nonatomic, strong) JRPCTracer *tracer;
+@end
+
+/**
+ Test cases for tracing, when the transport performs serialization
+ */
+@interface JRPCProxyObjectTracingTests : JRPCProxyTracingTests
+@end
+
+/**
+ Test cases for the tracer's ring buffer & export, and for a dispatcher joining a trace
+ */
+@interface JRPCTracerTests : XCTestCase
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCProxyTracingTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) notStubbed:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) ping:(NSInteger)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCProxyTracingTestsProtocol>
+@end
+
+/** Served by a dispatcher in JRPCTracerTests */
+@interface JRPCTracingTestsService : NSObject <JRPCProxyTracingTestsProtocol>
+@end
+
+@implementation JRPCTracingTestsService
+
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion {
+    completion(value, nil);
+}
+
+- (void) notStubbed:(NSString*)value :(void (^)(NSString *result, NSError *error))completion {
+    completion(nil, [NSError errorWithDomain:JRPCErrorDomain code:JRPCErrorServerResponseCode userInfo:@{ kJRPCErrorCodeKey : @(-32000) }]);
+}
+
+- (void) ping:(NSInteger)value {
+}
+
+@end
+
+// The Chrome trace events exported by a tracer
+static NSArray<NSDictionary*> *JRPCChromeEvents(JRPCTracer *tracer) {
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[tracer dataWithFormat:JRPCTraceFormatChrome] options:0 error:nil];
+    return trace[@"traceEvents"];
+}
+
+static NSArray<NSDictionary*> *JRPCEventsInCategory(NSArray<NSDictionary*> *events, NSString *category) {
+    return [events filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"cat == %@", category]];
+}
+
+@implementation JRPCProxyTracingTests
+
+- (void)setUp {
+    self.protocol = @protocol(JRPCProxyTracingTestsProtocol);
+    self.paramsStructure = JRPCParameterStructureByPosition;
+    [super setUp];
+    [self.jsonRPCTransport configureMethod:@"echoString" result:^id(id params) {
+        return params[0];
+    }];
+    self.tracer = [[JRPCTracer alloc] initWithCapacity:256];
+}
+
+- (void) echoStrings:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+        [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, @"Hello World!");
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+#pragma mark - Tests
+
+- (void) testTracingDisabledByDefault {
+    XCTAssertNil(self.SUT.tracer);
+    XCTAssertFalse(self.SUT.injectsTraceContext);
+    [self echoStrings:1];
+    XCTAssertEqual(JRPCChromeEvents(self.tracer).count, 0);
+}
+
+- (void) testCallAndPhaseSpans {
+    self.SUT.tracer = self.tracer;
+    [self echoStrings:2];
+    NSArray<NSDictionary*> *events = JRPCChromeEvents(self.tracer);
+    NSArray<NSDictionary*> *calls = JRPCEventsInCategory(events, @"client");
+    XCTAssertEqual(calls.count, 2);
+    XCTAssertNotEqualObjects(calls[0][@"tid"], calls[1][@"tid"]);
+    XCTAssertNotEqualObjects(calls[0][@"args"][@"traceId"], calls[1][@"args"][@"traceId"]);
+    for (NSDictionary *call in calls) {
+        XCTAssertEqualObjects(call[@"name"], @"echoString");
+        XCTAssertEqualObjects(call[@"ph"], @"X");
+        XCTAssertNil(call[@"args"][@"parentSpanId"]);
+        XCTAssertNil(call[@"args"][@"error"]);
+        // Each phase is a child of the call, on its track & within it
+        NSArray<NSDictionary*> *phases = [JRPCEventsInCategory(events, @"phase") filteredArrayUsingPredicate:
+                                          [NSPredicate predicateWithFormat:@"args.parentSpanId == %@", call[@"args"][@"spanId"]]];
+        NSArray<NSString*> *phaseNames = [phases valueForKey:@"name"];
+        XCTAssertTrue([phaseNames containsObject:@"transport"]);
+        XCTAssertTrue([phaseNames containsObject:self.transportStubPerformsSerialization ? @"marshalling" : @"serialization"]);
+        for (NSDictionary *phase in phases) {
+            XCTAssertEqualObjects(phase[@"tid"], call[@"tid"]);
+            XCTAssertEqualObjects(phase[@"args"][@"traceId"], call[@"args"][@"traceId"]);
+            XCTAssertGreaterThanOrEqual([phase[@"ts"] doubleValue], [call[@"ts"] doubleValue]);
+            XCTAssertLessThanOrEqual([phase[@"ts"] doubleValue] + [phase[@"dur"] doubleValue], [call[@"ts"] doubleValue] + [call[@"dur"] doubleValue] + 0.001);
+        }
+    }
+}
+
+- (void) testSampleRates {
+    self.SUT.tracer = self.tracer;
+    self.tracer.sampleRate = 0;
+    [self echoStrings:3];
+    XCTAssertEqual(JRPCChromeEvents(self.tracer).count, 0);
+    // The method's rate overrides the tracer's
+    [self.SUT setTraceSampleRate:1 forSelector:@selector(echoString::)];
+    [self echoStrings:3];
+    XCTAssertEqual(JRPCEventsInCategory(JRPCChromeEvents(self.tracer), @"client").count, 3);
+    [self.SUT setTraceSampleRate:-1 forSelector:@selector(echoString::)];
+    [self.tracer removeAllSpans];
+    [self echoStrings:3];
+    XCTAssertEqual(JRPCChromeEvents(self.tracer).count, 0);
+}
+
+- (void) testSampleRateForUnknownSelectorRaises {
+    XCTAssertThrowsSpecificNamed([self.SUT setTraceSampleRate:1 forSelector:@selector(description)], NSException, NSInvalidArgumentException);
+    XCTAssertNoThrow([self.SUT setTraceSampleRate:1 forSelector:@selector(ping:)]);
+}
+
+- (void) testFailedCallSpan {
+    self.SUT.tracer = self.tracer;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    [self.SUT notStubbed:@"foo" :^(NSString *result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorServerResponseCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSDictionary *call = JRPCEventsInCategory(JRPCChromeEvents(self.tracer), @"client").firstObject;
+    XCTAssertEqualObjects(call[@"args"][@"error"], @(JRPCErrorServerResponseCode));
+}
+
+- (void) testNotificationSpan {
+    self.SUT.tracer = self.tracer;
+    [self.SUT ping:42];
+    NSArray<NSDictionary*> *calls = JRPCEventsInCategory(JRPCChromeEvents(self.tracer), @"client");
+    XCTAssertEqual(calls.count, 1);
+    XCTAssertEqualObjects(calls.firstObject[@"name"], @"ping");
+}
+
+- (void) testTraceContextInjected {
+    self.SUT.tracer = self.tracer;
+    [self.SUT ping:1];
+    XCTAssertNil(self.jsonRPCTransport.receivedNotifications.lastObject[JRPCTraceContextKey]);
+    self.SUT.injectsTraceContext = YES;
+    [self.SUT ping:2];
+    NSDictionary *notification = self.jsonRPCTransport.receivedNotifications.lastObject;
+    XCTAssertEqualObjects(notification[@"params"], @[ @2 ]);
+    NSString *traceContext = notification[JRPCTraceContextKey];
+    NSDictionary *call = JRPCEventsInCategory(JRPCChromeEvents(self.tracer), @"client").lastObject;
+    NSString *expected = [NSString stringWithFormat:@"00-%@-%@-01", call[@"args"][@"traceId"], call[@"args"][@"spanId"]];
+    XCTAssertEqualObjects(traceContext, expected);
+    // Calls that are not sampled carry no context
+    self.tracer.sampleRate = 0;
+    [self.SUT ping:3];
+    XCTAssertNil(self.jsonRPCTransport.receivedNotifications.lastObject[JRPCTraceContextKey]);
+}
+
+- (void) testTraceContextInjectedIntoRequest {
+    self.SUT.tracer = self.tracer;
+    self.SUT.injectsTraceContext = YES;
+    [self echoStrings:1];
+    if (!self.transportStubPerformsSerialization) {
+        NSDictionary *request = [NSJSONSerialization JSONObjectWithData:self.jsonRPCTransport.lastRequestData options:0 error:nil];
+        XCTAssertEqualObjects(request[@"method"], @"echoString");
+        XCTAssertNotNil(request[@"id"]);
+        XCTAssertEqual([request[JRPCTraceContextKey] length], 55);
+    }
+}
+
+- (void) testBatchPhasesAreTracedForEachCall {
+    self.SUT.tracer = self.tracer;
+    self.SUT.batchWindow = 0.05;
+    [self echoStrings:3];
+    XCTAssertEqual(self.jsonRPCTransport.batchCount, 1);
+    NSArray<NSDictionary*> *events = JRPCChromeEvents(self.tracer);
+    NSArray<NSDictionary*> *transports = [JRPCEventsInCategory(events, @"phase") filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"name == 'transport'"]];
+    XCTAssertEqual(transports.count, 3);
+    XCTAssertEqual([NSSet setWithArray:[transports valueForKey:@"tid"]].count, 3);
+}
+
+@end
+
+@implementation JRPCProxyObjectTracingTests
+
+- (void)setUp {
+    self.transportStubPerformsSerialization = YES;
+    [super setUp];
+}
+
+@end
+
+@implementation JRPCTracerTests
+
+- (void) recordSpanNamed:(const char *)name tracer:(JRPCTracer*)tracer {
+    uint64_t now = JRPCHistogramNow();
+    JRPCSpan span = {
+        .name = name,
+        .kind = JRPCSpanKindClient,
+        .traceIdHigh = 1,
+        .traceIdLow = 2,
+        .spanId = [tracer newIdentifier],
+        .startTime = now,
+        .endTime = now,
+        .track = [tracer newTrack]
+    };
+    [tracer recordSpan:&span];
+}
+
+- (void) testRingBufferKeepsMostRecentSpans {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:4];
+    for (int i = 0; i < 10; ++i) {
+        [self recordSpanNamed:[NSString stringWithFormat:@"span%d", i].UTF8String tracer:tracer];
+    }
+    NSArray<NSString*> *names = [JRPCChromeEvents(tracer) valueForKey:@"name"];
+    NSArray<NSString*> *expected = @[ @"span6", @"span7", @"span8", @"span9" ];
+    XCTAssertEqualObjects(names, expected);
+}
+
+- (void) testRemoveAllSpans {
+    JRPCTracer *tracer = [[JRPCTracer alloc] init];
+    XCTAssertEqual(tracer.capacity, 4096);
+    [self recordSpanNamed:"first" tracer:tracer];
+    [tracer removeAllSpans];
+    XCTAssertEqual(JRPCChromeEvents(tracer).count, 0);
+    [self recordSpanNamed:"second" tracer:tracer];
+    XCTAssertEqualObjects([JRPCChromeEvents(tracer) valueForKey:@"name"], @[ @"second" ]);
+}
+
+- (void) testLongNamesAreTruncated {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:1];
+    NSString *name = [@"" stringByPaddingToLength:100 withString:@"x" startingAtIndex:0];
+    [self recordSpanNamed:name.UTF8String tracer:tracer];
+    XCTAssertEqual([JRPCChromeEvents(tracer).firstObject[@"name"] length], JRPC_SPAN_NAME_LENGTH - 1);
+}
+
+- (void) testConcurrentRecording {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:10000];
+    dispatch_apply(10000, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t i) {
+        [self recordSpanNamed:"concurrent" tracer:tracer];
+    });
+    XCTAssertEqual(JRPCChromeEvents(tracer).count, 10000);
+}
+
+- (void) testOTLPExport {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:4];
+    NSTimeInterval before = [[NSDate date] timeIntervalSince1970];
+    [self recordSpanNamed:"sum" tracer:tracer];
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[tracer dataWithFormat:JRPCTraceFormatOTLP] options:0 error:nil];
+    NSDictionary *span = [trace[@"resourceSpans"][0][@"scopeSpans"][0][@"spans"] firstObject];
+    XCTAssertEqualObjects(span[@"name"], @"sum");
+    XCTAssertEqualObjects(span[@"traceId"], @"00000000000000010000000000000002");
+    XCTAssertEqual([span[@"spanId"] length], 16);
+    XCTAssertEqualObjects(span[@"kind"], @(JRPCSpanKindClient));
+    XCTAssertNil(span[@"parentSpanId"]);
+    XCTAssertNil(span[@"status"]);
+    // Unix time in nanoseconds, as a string
+    XCTAssertTrue([span[@"startTimeUnixNano"] isKindOfClass:[NSString class]]);
+    XCTAssertEqualWithAccuracy([span[@"startTimeUnixNano"] doubleValue] / NSEC_PER_SEC, before, 5.0);
+    XCTAssertEqualObjects(span[@"startTimeUnixNano"], span[@"endTimeUnixNano"]);
+}
+
+- (void) testWriteToURL {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:4];
+    [self recordSpanNamed:"sum" tracer:tracer];
+    NSURL *url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:@"JRPCTracerTests.json"];
+    NSError *error = nil;
+    XCTAssertTrue([tracer writeToURL:url format:JRPCTraceFormatChrome error:&error]);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:url], [tracer dataWithFormat:JRPCTraceFormatChrome]);
+    [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+}
+
+- (void) testSampling {
+    JRPCTracer *tracer = [[JRPCTracer alloc] init];
+    XCTAssertEqual(tracer.sampleRate, 1.0);
+    XCTAssertTrue([tracer sampleWithRate:-1]);
+    XCTAssertFalse([tracer sampleWithRate:0]);
+    tracer.sampleRate = 0;
+    XCTAssertFalse([tracer sampleWithRate:-1]);
+    XCTAssertTrue([tracer sampleWithRate:1]);
+    NSUInteger sampled = 0;
+    for (int i = 0; i < 10000; ++i) {
+        sampled += [tracer sampleWithRate:0.01] ? 1 : 0;
+    }
+    XCTAssertGreaterThan(sampled, 50);
+    XCTAssertLessThan(sampled, 200);
+}
+
+#pragma mark - Dispatcher
+
+- (NSDictionary*) responseFromDispatcher:(JRPCDispatcher*)dispatcher forRequest:(NSDictionary*)request {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc expectation"];
+    __block NSDictionary *response = nil;
+    [dispatcher handleRequestObject:request completion:^(id jsonResponse) {
+        response = jsonResponse;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    return response;
+}
+
+- (void) testDispatcherJoinsTrace {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:16];
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCProxyTracingTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:[[JRPCTracingTestsService alloc] init]];
+    XCTAssertNil(dispatcher.tracer);
+    dispatcher.tracer = tracer;
+    NSString *traceContext = @"00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+    NSDictionary *response = [self responseFromDispatcher:dispatcher forRequest:@{ @"jsonrpc" : @"2.0", @"method" : @"echoString", @"params" : @[ @"a" ], @"id" : @1,
+                                                                                   JRPCTraceContextKey : traceContext }];
+    XCTAssertEqualObjects(response[@"result"], @"a");
+    [self responseFromDispatcher:dispatcher forRequest:@{ @"jsonrpc" : @"2.0", @"method" : @"notStubbed", @"params" : @[ @"a" ], @"id" : @2,
+                                                          JRPCTraceContextKey : traceContext }];
+    NSArray<NSDictionary*> *events = JRPCChromeEvents(tracer);
+    XCTAssertEqual(events.count, 2);
+    XCTAssertEqualObjects(events[0][@"name"], @"echoString");
+    XCTAssertEqualObjects(events[0][@"cat"], @"server");
+    XCTAssertEqualObjects(events[0][@"args"][@"traceId"], @"4bf92f3577b34da6a3ce929d0e0e4736");
+    XCTAssertEqualObjects(events[0][@"args"][@"parentSpanId"], @"00f067aa0ba902b7");
+    XCTAssertNil(events[0][@"args"][@"error"]);
+    XCTAssertEqualObjects(events[1][@"args"][@"error"], @(-32000));
+}
+
+- (void) testDispatcherIgnoresInvalidTraceContexts {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:16];
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCProxyTracingTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:[[JRPCTracingTestsService alloc] init]];
+    dispatcher.tracer = tracer;
+    NSArray *traceContexts = @[
+                               @"00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00",  // not sampled
+                               @"00-00000000000000000000000000000000-00f067aa0ba902b7-01",  // zero trace id
+                               @"00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01",  // zero parent id
+                               @"00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01",  // uppercase
+                               @"01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01",  // unknown version
+                               @"00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7",     // truncated
+                               @42
+                               ];
+    for (id traceContext in traceContexts) {
+        NSDictionary *response = [self responseFromDispatcher:dispatcher forRequest:@{ @"jsonrpc" : @"2.0", @"method" : @"echoString", @"params" : @[ @"a" ], @"id" : @1,
+                                                                                       JRPCTraceContextKey : traceContext }];
+        XCTAssertEqualObjects(response[@"result"], @"a");
+    }
+    XCTAssertEqual(JRPCChromeEvents(tracer).count, 0);
+}
+
+- (void) testProxyTraceJoinedByDispatcher {
+    JRPCTracer *tracer = [[JRPCTracer alloc] initWithCapacity:64];
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCProxyTracingTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:[[JRPCTracingTestsService alloc] init]];
+    dispatcher.tracer = tracer;
+    JRPCProxyTransportStub *transport = [[JRPCProxyTransportStub alloc] init];
+    JRPCAbstractProxy *proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCProxyTracingTestsProtocol) paramStructure:JRPCParameterStructureByPosition transport:transport];
+    proxy.tracer = tracer;
+    proxy.injectsTraceContext = YES;
+    [proxy ping:1];
+    [self responseFromDispatcher:dispatcher forRequest:transport.receivedNotifications.lastObject];
+    NSArray<NSDictionary*> *events = JRPCChromeEvents(tracer);
+    NSDictionary *client = JRPCEventsInCategory(events, @"client").firstObject;
+    NSDictionary *server = JRPCEventsInCategory(events, @"server").firstObject;
+    XCTAssertEqualObjects(server[@"args"][@"traceId"], client[@"args"][@"traceId"]);
+    XCTAssertEqualObjects(server[@"args"][@"parentSpanId"], client[@"args"][@"spanId"]);
+}
+
+@end
@@ -0,0 +1,206 @@
+//
+//  JRPCResponseTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "JRPCResponse.h"
+#import "JRPCNumericArray.h"
+#import "JRPCJSONReader.h"
+
+/**
+ Test cases for lazily parsed JSON-RPC responses
+ */
+@interface JRPCResponseTests : XCTestCase
+@end
+
+@implementation JRPCResponseTests
+
+- (JRPCResponse*) responseWithString:(NSString*)string {
+    return [JRPCResponse responseWithData:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+// The string as dispatch data, split into regions of fragmentSize bytes as reads from a socket might be
+- (dispatch_data_t) dispatchDataWithString:(NSString*)string fragmentSize:(NSUInteger)fragmentSize {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    dispatch_data_t dispatchData = dispatch_data_empty;
+    for (NSUInteger offset = 0; offset < data.length; offset += fragmentSize) {
+        dispatch_data_t region = dispatch_data_create((const uint8_t*)data.bytes + offset, MIN(fragmentSize, data.length - offset), NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+        dispatchData = dispatch_data_create_concat(dispatchData, region);
+    }
+    return dispatchData;
+}
+
+- (JRPCResponse*) responseWithString:(NSString*)string fragmentSize:(NSUInteger)fragmentSize {
+    dispatch_data_t data = [self dispatchDataWithString:string fragmentSize:fragmentSize];
+    return [JRPCResponse responseWithDispatchData:data range:NSMakeRange(0, dispatch_data_get_size(data))];
+}
+
+#pragma mark - Tests
+
+- (void) testMalformedResponsesAreRejected {
+    NSArray<NSString*> *malformed = @[ @"", @"[1]", @"\"result\"", @"{\"result\":1", @"{\"result\":1} x", @"{\"result\":[1,]}",
+                                       @"{\"result\":01}", @"{\"result\":tru}", @"{\"result\":\"a\nb\"}", @"{\"result\":1,}" ];
+    for (NSString *string in malformed) {
+        XCTAssertNil([self responseWithString:string], @"%@", string);
+    }
+    XCTAssertNil([JRPCResponse responseWithJSONObject:@[]]);
+}
+
+- (void) testErrorResponse {
+    JRPCResponse *response = [self responseWithString:@"{\"jsonrpc\":\"2.0\",\"error\":{\"code\":-32601,\"message\":\"Method not found\"},\"id\":1}"];
+    XCTAssertTrue(response.hasError);
+    XCTAssertEqualObjects(response.error, (@{ @"code" : @-32601, @"message" : @"Method not found" }));
+    XCTAssertNil([response resultWithError:NULL]);
+}
+
+- (void) testNullErrorIsNotAnError {
+    JRPCResponse *response = [self responseWithString:@"{\"jsonrpc\":\"2.0\",\"result\":\"Hello World!\",\"error\":null,\"id\":1}"];
+    XCTAssertFalse(response.hasError);
+    XCTAssertNil(response.error);
+    XCTAssertEqualObjects([response resultWithError:NULL], @"Hello World!");
+    response = [JRPCResponse responseWithJSONObject:@{ @"result" : @"Hello World!", @"error" : [NSNull null] }];
+    XCTAssertFalse(response.hasError);
+}
+
+- (void) testScalarResults {
+    JRPCJSONScalar scalar;
+    XCTAssertTrue([[self responseWithString:@"{\"result\":-2000000000,\"id\":1}"] getResultScalar:&scalar]);
+    XCTAssertEqual(scalar.kind, JRPCJSONScalarKindInteger);
+    XCTAssertEqual(JRPC_JSON_SCALAR_VALUE(int, scalar), -2000000000);
+    XCTAssertTrue([[self responseWithString:@"{\"result\":18446744073709551615}"] getResultScalar:&scalar]);
+    XCTAssertEqual(scalar.kind, JRPCJSONScalarKindUnsignedInteger);
+    XCTAssertEqual(JRPC_JSON_SCALAR_VALUE(unsigned long long, scalar), ULLONG_MAX);
+    XCTAssertTrue([[self responseWithString:@"{\"result\":3.141592653589793}"] getResultScalar:&scalar]);
+    XCTAssertEqual(scalar.kind, JRPCJSONScalarKindReal);
+    XCTAssertEqual(JRPC_JSON_SCALAR_VALUE(double, scalar), M_PI);
+    XCTAssertEqual(JRPC_JSON_SCALAR_VALUE(int, scalar), 3);
+    XCTAssertTrue([[self responseWithString:@"{\"result\":true}"] getResultScalar:&scalar]);
+    XCTAssertTrue(JRPC_JSON_SCALAR_VALUE(BOOL, scalar));
+    XCTAssertFalse([[self responseWithString:@"{\"result\":\"42\"}"] getResultScalar:&scalar]);
+    XCTAssertFalse([[self responseWithString:@"{\"error\":{}}"] getResultScalar:&scalar]);
+    XCTAssertFalse([[JRPCResponse responseWithJSONObject:@{ @"result" : @42 }] getResultScalar:&scalar]);
+}
+
+- (void) testObjectResults {
+    XCTAssertEqualObjects([[self responseWithString:@"{\"result\":\"café\"}"] resultWithError:NULL], @"café");
+    XCTAssertEqualObjects([[self responseWithString:@"{\"result\":\"\\\"\\/\\u00e9\\n\"}"] resultWithError:NULL], @"\"/é\n");
+    id expected = @{ @"string" : @"Hello World!", @"array" : @[ @1, @2.5, @YES, [NSNull null] ] };
+    JRPCResponse *response = [self responseWithString:@" { \"id\" : 1 , \"result\" : {\"string\":\"Hello World!\",\"array\":[1,2.5,true,null]} } "];
+    XCTAssertEqualObjects([response resultWithError:NULL], expected);
+    XCTAssertEqualObjects([[JRPCResponse responseWithJSONObject:@{ @"result" : expected }] resultWithError:NULL], expected);
+}
+
+- (void) testUnparseableResultReportsError {
+    // Syntactically valid, but not UTF-8
+    const char bytes[] = "{\"result\":\"\xff\"}";
+    JRPCResponse *response = [JRPCResponse responseWithData:[NSData dataWithBytes:bytes length:strlen(bytes)]];
+    XCTAssertNotNil(response);
+    NSError *error = nil;
+    XCTAssertNil([response resultWithError:&error]);
+    XCTAssertNotNil(error);
+}
+
+- (void) testNumericArrayResults {
+    JRPCResponse *response = [self responseWithString:@"{\"result\": [ 1 , -2.5,3e2 ] ,\"id\":1}"];
+    JRPCDoubleArray *doubles = [response resultAsNumericArrayOfClass:[JRPCDoubleArray class]];
+    XCTAssertEqual(doubles.count, 3);
+    XCTAssertEqual(doubles.values[0], 1);
+    XCTAssertEqual(doubles.values[1], -2.5);
+    XCTAssertEqual(doubles.values[2], 300);
+    // Created once per class, and shared with copies
+    XCTAssertEqual([response resultAsNumericArrayOfClass:[JRPCDoubleArray class]], doubles);
+    XCTAssertEqual([[response copy] resultAsNumericArrayOfClass:[JRPCDoubleArray class]], doubles);
+    JRPCInt16Array *int16s = [response resultAsNumericArrayOfClass:[JRPCInt16Array class]];
+    XCTAssertEqual(int16s.values[1], -2);
+    XCTAssertEqual([[self responseWithString:@"{\"result\":[]}"] resultAsNumericArrayOfClass:[JRPCInt64Array class]].count, 0);
+}
+
+- (void) testResultsThatAreNotNumericArraysAreNotRead {
+    NSArray<NSString*> *results = @[ @"{\"result\":1}", @"{\"result\":[1,\"2\"]}", @"{\"result\":[1,[2]]}", @"{\"result\":[true]}",
+                                     @"{\"result\":{}}", @"{\"error\":{}}" ];
+    for (NSString *string in results) {
+        XCTAssertNil([[self responseWithString:string] resultAsNumericArrayOfClass:[JRPCInt32Array class]], @"%@", string);
+    }
+    XCTAssertNil([[JRPCResponse responseWithJSONObject:@{ @"result" : @[ @1 ] }] resultAsNumericArrayOfClass:[JRPCInt32Array class]]);
+}
+
+- (void) testFragmentedResponses {
+    // Every split of keys, literals, numbers & strings between regions, down to a byte per region
+    NSString *string = @"{\"jsonrpc\":\"2.0\",\"result\":{\"title\":\"caf\u00e9 \\\"bar\\\"\",\"on\":true,\"off\":null,\"count\":-12.5e1},\"id\":42}";
+    for (NSUInteger fragmentSize = 1; fragmentSize <= 9; ++fragmentSize) {
+        JRPCResponse *response = [self responseWithString:string fragmentSize:fragmentSize];
+        XCTAssertNotNil(response, @"%lu", (unsigned long)fragmentSize);
+        XCTAssertFalse(response.hasError);
+        XCTAssertEqualObjects(response.requestId, @42);
+        NSDictionary *expected = @{ @"title" : @"caf\u00e9 \"bar\"", @"on" : @YES, @"off" : [NSNull null], @"count" : @-125 };
+        XCTAssertEqualObjects([response resultWithError:NULL], expected, @"%lu", (unsigned long)fragmentSize);
+        XCTAssertEqualObjects([[response copy] resultWithError:NULL], expected);
+    }
+}
+
+- (void) testFragmentedScalarsErrorsAndNumericArrays {
+    for (NSUInteger fragmentSize = 1; fragmentSize <= 5; ++fragmentSize) {
+        JRPCJSONScalar scalar;
+        XCTAssertTrue([[self responseWithString:@"{\"result\":123456789,\"id\":1}" fragmentSize:fragmentSize] getResultScalar:&scalar]);
+        XCTAssertEqual(scalar.integer, 123456789);
+        JRPCResponse *response = [self responseWithString:@"{\"error\":{\"code\":-32601,\"message\":\"Method not found\"},\"id\":\"abc\"}" fragmentSize:fragmentSize];
+        XCTAssertTrue(response.hasError);
+        XCTAssertEqualObjects(response.requestId, @"abc");
+        XCTAssertEqualObjects(response.error[@"code"], @-32601);
+        XCTAssertFalse([self responseWithString:@"{\"error\":null,\"result\":1}" fragmentSize:fragmentSize].hasError);
+        JRPCInt32Array *ints = [[self responseWithString:@"{\"result\":[1,22,-333]}" fragmentSize:fragmentSize] resultAsNumericArrayOfClass:[JRPCInt32Array class]];
+        XCTAssertEqual(ints.count, 3);
+        XCTAssertEqual(ints.values[2], -333);
+    }
+}
+
+- (void) testMalformedFragmentedResponsesAreRejected {
+    NSArray<NSString*> *malformed = @[ @"", @"[1]", @"{\"result\":1", @"{\"result\":tru}", @"{\"result\":1,}", @"{\"result\":\"a\nb\"}" ];
+    for (NSString *string in malformed) {
+        XCTAssertNil([self responseWithString:string fragmentSize:2], @"%@", string);
+    }
+}
+
+- (void) testFragmentedBatchResponses {
+    NSString *string = @" [ {\"result\":\"one\",\"id\":1} ,{\"result\":[2],\"id\":2},{\"error\":{\"code\":1},\"id\":3} ] ";
+    for (NSUInteger fragmentSize = 1; fragmentSize <= 7; ++fragmentSize) {
+        dispatch_data_t data = [self dispatchDataWithString:string fragmentSize:fragmentSize];
+        NSMutableArray<JRPCResponse*> *responses = [[NSMutableArray alloc] init];
+        XCTAssertTrue(JRPCJSONScanArrayInDispatchData(data, ^(NSRange elementRange) {
+            [responses addObject:[JRPCResponse responseWithDispatchData:data range:elementRange]];
+        }));
+        XCTAssertEqual(responses.count, 3);
+        XCTAssertEqualObjects([responses[0] resultWithError:NULL], @"one");
+        XCTAssertEqualObjects([responses[1] resultWithError:NULL], @[ @2 ]);
+        XCTAssertTrue(responses[2].hasError);
+        XCTAssertEqualObjects(responses[2].requestId, @3);
+    }
+    XCTAssertFalse(JRPCJSONScanArrayInDispatchData([self dispatchDataWithString:@"[1,2" fragmentSize:1], ^(NSRange elementRange) {}));
+}
+
+@end
@@ -0,0 +1,405 @@
+//
+//  JRPCSharedMemoryTransportTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import <unistd.h>
+#import <spawn.h>
+#import <signal.h>
+#import <sys/wait.h>
+#import <objc/runtime.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCDispatcher.h"
+#import "JRPCSharedMemoryTransport.h"
+#import "JRPCSharedMemoryEndpoint.h"
+#import "JRPCError.h"
+#import "JRPCSharedRing.h"
+
+extern char **environ;
+
+// This is the protocol served by the endpoint's dispatcher & proxied by the SUT ...
+@protocol JRPCSharedMemoryTransportTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoInt:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) ignore:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) notify:(int)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCSharedMemoryTransportTestsProtocol>
+@end
+
+/** Implements the test protocol, counting notifications */
+@interface JRPCSharedMemoryTransportTestsService : NSObject <JRPCSharedMemoryTransportTestsProtocol, JRPCDispatchTarget> {
+    atomic_int _notificationCount;
+}
+@property (nonatomic, readonly) int notificationCount;
+@end
+
+/**
+ Test cases for JRPCSharedMemoryTransport, served by a JRPCSharedMemoryEndpoint in the same process, so client & server run on separate threads
+ */
+@interface JRPCSharedMemoryTransportTests : XCTestCase
+@property (nonatomic, strong) JRPCSharedMemoryTransportTestsService *service;
+@property (nonatomic, strong) JRPCSharedMemoryEndpoint *endpoint;
+@property (nonatomic, strong) JRPCSharedMemoryTransport *transport;
+@property (nonatomic, strong) JRPCAbstractProxy *SUT;
+@end
+
+@implementation JRPCSharedMemoryTransportTests
+
+// Unique per test, and short enough for the limit Apple platforms put on shared memory names
++ (NSString*) uniqueName {
+    static atomic_uint count;
+    return [NSString stringWithFormat:@"/jrpct%d.%u", getpid(), atomic_fetch_add(&count, 1)];
+}
+
+- (void)setUp {
+    [super setUp];
+    self.service = [[JRPCSharedMemoryTransportTestsService alloc] init];
+    [self connectWithRingCapacity:JRPC_SHARED_MEMORY_DEFAULT_RING_CAPACITY];
+}
+
+- (void)tearDown {
+    [self.transport invalidate];
+    [self.endpoint invalidate];
+    [super tearDown];
+}
+
+// A process to stand in for a peer, killed to show it exiting without closing
++ (pid_t) spawnPeerProcess {
+    pid_t pid = 0;
+    char *argv[] = { "sleep", "60", NULL };
+    return 0 == posix_spawn(&pid, "/bin/sleep", NULL, NULL, argv, environ) ? pid : 0;
+}
+
++ (void) killPeerProcess:(pid_t)pid {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+- (void) connectWithRingCapacity:(NSUInteger)ringCapacity {
+    [self.transport invalidate];
+    [self.endpoint invalidate];
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCSharedMemoryTransportTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:self.service];
+    NSError *error = nil;
+    self.endpoint = [JRPCSharedMemoryEndpoint endpointWithName:[[self class] uniqueName] ringCapacity:ringCapacity dispatcher:dispatcher error:&error];
+    XCTAssertNotNil(self.endpoint, @"%@", error);
+    self.transport = [JRPCSharedMemoryTransport transportWithName:self.endpoint.name error:&error];
+    XCTAssertNotNil(self.transport, @"%@", error);
+    self.SUT = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCSharedMemoryTransportTestsProtocol)
+                                    paramStructure:JRPCParameterStructureByPosition
+                                         transport:self.transport];
+}
+
+#pragma mark - Tests
+
+- (void) testRequestResponse {
+    XCTAssertTrue(self.endpoint.clientConnected);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, @"Hello World!");
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testTenThousandRequestsInFlight {
+    const int requestCount = 10000;
+    self.SUT.rpcCompletionQueue = dispatch_queue_create("JRPCSharedMemoryTransportTestsCompletionQueue", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    __block int completedCount = 0;
+    __block int mismatchCount = 0;
+    NSDate *start = [NSDate date];
+    for (int i = 0; i < requestCount; ++i) {
+        [self.SUT echoInt:i :^(int result, NSError *error) {
+            // Serial completion queue, so no need to synchronize
+            if (result != i || error) {
+                mismatchCount++;
+            }
+            if (++completedCount == requestCount) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSLog(@"%s - %i requests in %.3fs", __func__, requestCount, -start.timeIntervalSinceNow);
+    XCTAssertEqual(mismatchCount, 0);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testRingsWrapAround {
+    // Each ring holds only a few of these, so both wrap many times & the client waits for room
+    [self connectWithRingCapacity:4096];
+    NSString *value = [@"" stringByPaddingToLength:1000 withString:@"Hello World!" startingAtIndex:0];
+    for (int i = 0; i < 50; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc shared memory expectation %i", i]];
+        [self.SUT echoString:value :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, value);
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testOversizeRequestFails {
+    [self connectWithRingCapacity:4096];
+    NSMutableData *payload = [NSMutableData dataWithLength:self.transport.maxPayloadLength + 1];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.transport sendJSONRPCPayloadWithRequestData:payload completionQueue:nil completion:^(NSData *data, NSError *error) {
+        XCTAssertNil(data);
+        XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+        XCTAssertEqual(error.code, EMSGSIZE);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertTrue(self.transport.valid);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testBatch {
+    self.SUT.batchWindow = 0.05;
+    XCTestExpectation *stringExpectation = [self expectationWithDescription:@"json-rpc shared memory string expectation"];
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, @"Hello World!");
+        [stringExpectation fulfill];
+    }];
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc shared memory int expectation"];
+    [self.SUT echoInt:-2017 :^(int result, NSError *error) {
+        XCTAssertEqual(result, -2017);
+        [intExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testNotificationsAreSent {
+    for (int i = 0; i < 10; ++i) {
+        [self.SUT notify:i];
+    }
+    // The ring is ordered, so the notifications have been handed to the dispatcher by the time this request is answered
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.service.notificationCount, 10);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testRequestsWakeSleepingPeers {
+    // Neither side spins, so every request & response rings the other's doorbell
+    self.transport.spinCount = 0;
+    self.endpoint.spinCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        [NSThread sleepForTimeInterval:0.05];
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc shared memory expectation %i", i]];
+        [self.SUT echoInt:i :^(int result, NSError *error) {
+            XCTAssertEqual(result, i);
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    }
+}
+
+- (void) testEndpointInvalidateFailsPendingRequests {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT ignore:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        NSError *underlyingError = error.userInfo[NSUnderlyingErrorKey];
+        XCTAssertEqualObjects(underlyingError.domain, NSPOSIXErrorDomain);
+        XCTAssertEqual(underlyingError.code, ECONNRESET);
+        [expectation fulfill];
+    }];
+    // Once the request has been handed to the service
+    XCTestExpectation *readExpectation = [self expectationWithDescription:@"json-rpc shared memory read expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        [readExpectation fulfill];
+    }];
+    [self waitForExpectations:@[readExpectation] timeout:60.0];
+    [self.endpoint invalidate];
+    [self waitForExpectations:@[expectation] timeout:60.0];
+    XCTAssertFalse(self.transport.valid);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testTimedOutRequestIsDropped {
+    self.SUT.defaultTimeout = 0.1;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT ignore:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTimedOutCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    // Gone from the transport, though the endpoint never answers it
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+    XCTAssertTrue(self.transport.valid);
+    XCTestExpectation *nextExpectation = [self expectationWithDescription:@"json-rpc shared memory next expectation"];
+    [self.SUT echoInt:2 :^(int result, NSError *error) {
+        XCTAssertEqual(result, 2);
+        XCTAssertNil(error);
+        [nextExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testTransportInvalidateStopsEndpoint {
+    [self.transport invalidate];
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:60.0];
+    while (self.endpoint.valid && deadline.timeIntervalSinceNow > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    XCTAssertFalse(self.endpoint.valid);
+    XCTAssertFalse(self.endpoint.clientConnected);
+    // The endpoint removes its name as it stops
+    NSError *error = nil;
+    XCTAssertNil([JRPCSharedMemoryTransport transportWithName:self.endpoint.name error:&error]);
+    XCTAssertEqual(error.code, ENOENT);
+}
+
+- (void) testExitedEndpointProcessFailsPendingRequests {
+    // Serve from a region the test made for another process, which never reads it
+    NSString *name = [[self class] uniqueName];
+    pid_t peer = [[self class] spawnPeerProcess];
+    XCTAssertGreaterThan(peer, 0);
+    JRPCSharedRegion region;
+    NSError *error = nil;
+    XCTAssertTrue(JRPCSharedRegionCreate(name, JRPC_SHARED_MEMORY_DEFAULT_RING_CAPACITY, &region, &error), @"%@", error);
+    atomic_store(&region.header->serverPid, peer);
+    atomic_store(&region.header->serverState, JRPCSharedPeerStateOpen);
+    self.transport = [JRPCSharedMemoryTransport transportWithName:name error:&error];
+    XCTAssertNotNil(self.transport, @"%@", error);
+    self.SUT = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCSharedMemoryTransportTestsProtocol)
+                                    paramStructure:JRPCParameterStructureByPosition
+                                         transport:self.transport];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        NSError *underlyingError = error.userInfo[NSUnderlyingErrorKey];
+        XCTAssertEqualObjects(underlyingError.domain, NSPOSIXErrorDomain);
+        XCTAssertEqual(underlyingError.code, ECONNRESET);
+        [expectation fulfill];
+    }];
+    [[self class] killPeerProcess:peer];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertFalse(self.transport.valid);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+    [self.transport invalidate];
+    JRPCSharedRegionClose(&region);
+    JRPCSharedRegionUnlink(name);
+}
+
+- (void) testExitedTransportProcessStopsEndpoint {
+    JRPCDispatcher *dispatcher = [JRPCDispatcher dispatcherForProtocol:@protocol(JRPCSharedMemoryTransportTestsProtocol)
+                                                        paramStructure:JRPCParameterStructureByPosition
+                                                                target:self.service];
+    NSError *error = nil;
+    JRPCSharedMemoryEndpoint *endpoint = [JRPCSharedMemoryEndpoint endpointWithName:[[self class] uniqueName] dispatcher:dispatcher error:&error];
+    XCTAssertNotNil(endpoint, @"%@", error);
+    // Attach as another process would, then have that process exit without closing
+    pid_t peer = [[self class] spawnPeerProcess];
+    XCTAssertGreaterThan(peer, 0);
+    JRPCSharedRegion region;
+    XCTAssertTrue(JRPCSharedRegionOpen(endpoint.name, &region, &error), @"%@", error);
+    atomic_store(&region.header->clientState, JRPCSharedPeerStateOpen);
+    atomic_store(&region.header->clientPid, peer);
+    JRPCSharedRingWake(&region.rings[JRPCSharedRingIndexRequests]);
+    XCTAssertTrue(endpoint.clientConnected);
+    [[self class] killPeerProcess:peer];
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:60.0];
+    while (endpoint.valid && deadline.timeIntervalSinceNow > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    XCTAssertFalse(endpoint.valid);
+    [endpoint invalidate];
+    JRPCSharedRegionClose(&region);
+}
+
+- (void) testRequestAfterInvalidateFails {
+    [self.transport invalidate];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc shared memory expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testSecondTransportIsRefused {
+    NSError *error = nil;
+    XCTAssertNil([JRPCSharedMemoryTransport transportWithName:self.endpoint.name error:&error]);
+    XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+    XCTAssertEqual(error.code, EBUSY);
+}
+
+- (void) testMissingEndpointFails {
+    NSError *error = nil;
+    XCTAssertNil([JRPCSharedMemoryTransport transportWithName:[[self class] uniqueName] error:&error]);
+    XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+    XCTAssertEqual(error.code, ENOENT);
+}
+
+@end
+
+@implementation JRPCSharedMemoryTransportTestsService
+
+- (int) notificationCount {
+    return atomic_load(&_notificationCount);
+}
+
+- (id) JSONRPCSignatureBlockForSelector:(SEL)selector {
+    if (sel_isEqual(selector, @selector(echoInt::)) || sel_isEqual(selector, @selector(ignore::))) {
+        return ^(int value, void (^completion)(int result, NSError *error)) {};
+    }
+    return nil;
+}
+
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion {
+    completion(value, nil);
+}
+
+- (void) echoInt:(int)value :(void (^)(int result, NSError *error))completion {
+    completion(value, nil);
+}
+
+- (void) ignore:(int)value :(void (^)(int result, NSError *error))completion {
+}
+
+- (void) notify:(int)value {
+    atomic_fetch_add(&_notificationCount, 1);
+}
+
+@end
@@ -0,0 +1,256 @@
+//
+//  JRPCStreamTransportTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <sys/socket.h>
+#import <unistd.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCStreamTransport.h"
+#import "JRPCStreamEchoServer.h"
+#import "JRPCError.h"
+
+/**
+ Test cases for JRPCStreamTransport using newline delimited framing, over a socketpair to a local echo server
+ */
+@interface JRPCStreamTransportTests : XCTestCase
+@property (nonatomic, assign) JRPCStreamFraming framing;
+@property (nonatomic, assign) int clientFileDescriptor;
+@property (nonatomic, strong) JRPCStreamEchoServer *server;
+@property (nonatomic, strong) JRPCStreamTransport *transport;
+@property (nonatomic, strong) JRPCAbstractProxy *SUT;
+@end
+
+/**
+ Test cases for JRPCStreamTransport using length prefixed framing
+ */
+@interface JRPCStreamTransportLengthPrefixedTests : JRPCStreamTransportTests
+@end
+
+// This is the protocol being proxied by the SUT ...
+@protocol JRPCStreamTransportTestsProtocol
+- (void) echoString:(NSString*)value :(void (^)(NSString *result, NSError *error))completion;
+- (void) echoInt:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) notify:(int)value;
+@end
+// ... so we declare conformance to the protocol by the SUT to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCStreamTransportTestsProtocol>
+@end
+
+@implementation JRPCStreamTransportTests
+
+- (void)setUp {
+    [super setUp];
+    int fileDescriptors[2];
+    XCTAssertEqual(socketpair(AF_UNIX, SOCK_STREAM, 0, fileDescriptors), 0);
+    self.clientFileDescriptor = fileDescriptors[0];
+    self.server = [[JRPCStreamEchoServer alloc] initWithFileDescriptor:fileDescriptors[1] framing:self.framing];
+    [self.server start];
+    self.transport = [JRPCStreamTransport transportWithFileDescriptor:self.clientFileDescriptor framing:self.framing];
+    self.SUT = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCStreamTransportTestsProtocol)
+                                    paramStructure:JRPCParameterStructureByPosition
+                                         transport:self.transport];
+}
+
+- (void)tearDown {
+    [self.transport invalidate];
+    close(self.clientFileDescriptor);
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void) testRequestResponse {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, @"Hello World!");
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testOutOfOrderResponsesAreMatched {
+    self.server.respondsInReverseOrder = YES;
+    for (int i = 0; i < 100; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc stream expectation %i", i]];
+        [self.SUT echoInt:i :^(int result, NSError *error) {
+            XCTAssertEqual(result, i);
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testTenThousandRequestsInFlight {
+    const int requestCount = 10000;
+    self.server.respondsInReverseOrder = YES;
+    self.SUT.rpcCompletionQueue = dispatch_queue_create("JRPCStreamTransportTestsCompletionQueue", DISPATCH_QUEUE_SERIAL);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    __block int completedCount = 0;
+    __block int mismatchCount = 0;
+    NSDate *start = [NSDate date];
+    for (int i = 0; i < requestCount; ++i) {
+        [self.SUT echoInt:i :^(int result, NSError *error) {
+            // Serial completion queue, so no need to synchronize
+            if (result != i || error) {
+                mismatchCount++;
+            }
+            if (++completedCount == requestCount) {
+                [expectation fulfill];
+            }
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSLog(@"%s - %i requests in %.3fs", __func__, requestCount, -start.timeIntervalSinceNow);
+    XCTAssertEqual(mismatchCount, 0);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testBatch {
+    self.SUT.batchWindow = 0.05;
+    XCTestExpectation *stringExpectation = [self expectationWithDescription:@"json-rpc stream string expectation"];
+    [self.SUT echoString:@"Hello World!" :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, @"Hello World!");
+        [stringExpectation fulfill];
+    }];
+    XCTestExpectation *intExpectation = [self expectationWithDescription:@"json-rpc stream int expectation"];
+    [self.SUT echoInt:-2017 :^(int result, NSError *error) {
+        XCTAssertEqual(result, -2017);
+        [intExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.server.batchCount, 1);
+}
+
+- (void) testResponsesSplitAcrossReads {
+    // Every frame, including its length prefix or line feed, is split between reads
+    self.server.fragmentSize = 5;
+    for (int i = 0; i < 3; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"json-rpc stream expectation %i", i]];
+        [self.SUT echoString:@"caf\u00e9 \"quoted\"" :^(NSString *result, NSError *error) {
+            XCTAssertEqualObjects(result, @"caf\u00e9 \"quoted\"");
+            XCTAssertNil(error);
+            [expectation fulfill];
+        }];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testLargeRequestAndResponse {
+    // Larger than a read, so the response arrives in several regions and the request is encoded in several chunks
+    NSMutableString *value = [[NSMutableString alloc] init];
+    while (value.length < 300000) {
+        [value appendString:@"Hello World!"];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoString:value :^(NSString *result, NSError *error) {
+        XCTAssertEqualObjects(result, value);
+        XCTAssertNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testDataMethodsAreStillSupported {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    NSData *payload = [@"{\"jsonrpc\":\"2.0\",\"method\":\"echoInt\",\"params\":[7],\"id\":\"data\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    [self.transport sendJSONRPCPayloadWithRequestData:payload completionQueue:nil completion:^(NSData *data, NSError *error) {
+        NSDictionary *response = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+        XCTAssertEqualObjects(response[@"result"], @7);
+        XCTAssertEqualObjects(response[@"id"], @"data");
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+- (void) testNotificationsAreSent {
+    for (int i = 0; i < 10; ++i) {
+        [self.SUT notify:i];
+    }
+    // The stream is ordered, so the notifications have been received by the time this request is answered
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.server.notificationCount, 10);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testStreamClosedFailsPendingRequests {
+    self.server.ignoresRequests = YES;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        NSError *underlyingError = error.userInfo[NSUnderlyingErrorKey];
+        XCTAssertEqualObjects(underlyingError.domain, NSPOSIXErrorDomain);
+        [expectation fulfill];
+    }];
+    [self.server stop];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertFalse(self.transport.valid);
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+}
+
+- (void) testTimedOutRequestIsRemoved {
+    self.server.ignoresRequests = YES;
+    self.SUT.defaultTimeout = 0.05;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTimedOutCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqual(self.transport.pendingRequestCount, 0);
+    XCTAssertTrue(self.transport.valid);
+}
+
+- (void) testRequestAfterInvalidateFails {
+    [self.transport invalidate];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"json-rpc stream expectation"];
+    [self.SUT echoInt:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+}
+
+@end
+
+@implementation JRPCStreamTransportLengthPrefixedTests
+
+- (void)setUp {
+    self.framing = JRPCStreamFramingLengthPrefixed;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,494 @@
+//
+//  JRPCTrafficReplayTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCRecordingTransport.h"
+#import "JRPCReplayTransport.h"
+#import "JRPCReplayDriver.h"
+#import "JRPCTrafficRecording.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCMessagePackCodec.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCError.h"
+
+// This is the protocol being proxied over the SUT ...
+@protocol JRPCTrafficReplayTestsProtocol
+- (void) echo:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) next:(NSString*)counter :(void (^)(int result, NSError *error))completion;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the proxy to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCTrafficReplayTestsProtocol>
+@end
+
+/**
+ Test cases for JRPCRecordingTransport, JRPCTrafficRecording, JRPCReplayTransport & JRPCReplayDriver, when the proxy performs serialization
+ */
+@interface JRPCTrafficReplayTests : XCTestCase
+/** The System Under Test, recording the traffic of proxy to transport */
+@property (nonatomic, strong) JRPCRecordingTransport *SUT;
+@property (nonatomic, strong) JRPCProxyTransportStub *transport;
+@property (nonatomic, strong) JRPCAbstractProxy *proxy;
+@property (nonatomic, strong) NSURL *url;
+/** Whether the stub & replay transports perform serialization. Set by sub-classes BEFORE calling [super setUp] */
+@property (nonatomic, assign) BOOL transportsPerformSerialization;
+@end
+
+/**
+ Test cases for JRPCRecordingTransport, JRPCTrafficRecording, JRPCReplayTransport & JRPCReplayDriver, when the transports perform serialization
+ */
+@interface JRPCTrafficReplayObjectTests : JRPCTrafficReplayTests
+@end
+
+@implementation JRPCTrafficReplayTests
+
+- (void)setUp {
+    [super setUp];
+    self.url = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:[[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"jrpcrec"]];
+    self.transport = [[JRPCProxyTransportStub alloc] init];
+    self.transport.performsSerialization = self.transportsPerformSerialization;
+    [self.transport configureMethod:@"echo" result:^id(id params) {
+        return params[0];
+    }];
+    __block int count = 0;
+    [self.transport configureMethod:@"next" result:^id(id params) {
+        return @(++count);
+    }];
+    NSError *error = nil;
+    self.SUT = [JRPCRecordingTransport transportWithTransport:self.transport recordingToURL:self.url error:&error];
+    XCTAssertNotNil(self.SUT, @"%@", error);
+    self.proxy = [self proxyWithTransport:self.SUT];
+}
+
+- (void)tearDown {
+    self.proxy = nil;
+    self.SUT = nil;
+    self.transport = nil;
+    [[NSFileManager defaultManager] removeItemAtURL:self.url error:nil];
+    [super tearDown];
+}
+
+- (JRPCAbstractProxy*) proxyWithTransport:(id<JRPCProxyTransport>)transport {
+    return [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCTrafficReplayTestsProtocol)
+                                paramStructure:JRPCParameterStructureByPosition
+                                     transport:transport];
+}
+
+- (void) echo:(int)value {
+    XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"echo %i", value]];
+    [self.proxy echo:value :^(int result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, value);
+        [expectation fulfill];
+    }];
+}
+
+// Closes the recording and opens it
+- (JRPCTrafficRecording*) finishRecording {
+    [self.SUT close];
+    NSError *error = nil;
+    JRPCTrafficRecording *recording = [JRPCTrafficRecording recordingWithContentsOfURL:self.url error:&error];
+    XCTAssertNotNil(recording, @"%@", error);
+    return recording;
+}
+
+// Records some calls, then returns a proxy over a transport replaying them
+- (JRPCAbstractProxy*) replayProxyAfterRecording:(void (^)(void))calls replayTransport:(JRPCReplayTransport * __autoreleasing *)replayTransport {
+    calls();
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    *replayTransport = [JRPCReplayTransport transportWithRecording:[self finishRecording]];
+    (*replayTransport).performsSerialization = self.transportsPerformSerialization;
+    return [self proxyWithTransport:*replayTransport];
+}
+
+#pragma mark - Recording
+
+- (void) testRecordsRequestsAndResponses {
+    [self echo:1];
+    [self echo:2];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 2);
+    NSMutableSet<NSNumber*> *results = [[NSMutableSet alloc] init];
+    for (NSUInteger i = 0; i < recording.count; ++i) {
+        JRPCTrafficRecord *record = [recording recordAtIndex:i];
+        XCTAssertEqual(record.kind, JRPCTrafficRecordKindRequest);
+        XCTAssertNil(record.error);
+        NSDictionary *request = [NSJSONSerialization JSONObjectWithData:record.requestData options:0 error:nil];
+        NSDictionary *response = [NSJSONSerialization JSONObjectWithData:record.responseData options:0 error:nil];
+        XCTAssertEqualObjects(request[@"method"], @"echo");
+        XCTAssertEqualObjects(request[@"id"], response[@"id"]);
+        XCTAssertEqualObjects(request[@"params"][0], response[@"result"]);
+        [results addObject:response[@"result"]];
+    }
+    XCTAssertEqualObjects(results, ([NSSet setWithObjects:@1, @2, nil]));
+    XCTAssertThrowsSpecificNamed([recording recordAtIndex:2], NSException, NSRangeException);
+}
+
+- (void) testRecordsTimes {
+    self.transport.responseLatency = 0.1;
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    [NSThread sleepForTimeInterval:0.1];
+    [self echo:2];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 2);
+    JRPCTrafficRecord *first = [recording recordAtIndex:0];
+    JRPCTrafficRecord *second = [recording recordAtIndex:1];
+    XCTAssertGreaterThanOrEqual(first.latency, 0.1);
+    XCTAssertGreaterThanOrEqual(second.latency, 0.1);
+    XCTAssertGreaterThanOrEqual(second.sentTime - first.sentTime, 0.2);
+    XCTAssertEqualWithAccuracy(recording.duration, second.sentTime, 1e-9);
+    XCTAssertLessThan(fabs(recording.startDate.timeIntervalSinceNow), 60.0);
+}
+
+- (void) testRecordsFailures {
+    self.transport.transportError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet
+                                                    userInfo:@{ NSLocalizedDescriptionKey : @"Offline" }];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"echo"];
+    [self.proxy echo:1 :^(int result, NSError *error) {
+        XCTAssertNotNil(error);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 1);
+    JRPCTrafficRecord *record = [recording recordAtIndex:0];
+    XCTAssertNil(record.responseData);
+    XCTAssertEqualObjects(record.error.domain, NSURLErrorDomain);
+    XCTAssertEqual(record.error.code, NSURLErrorNotConnectedToInternet);
+    XCTAssertEqualObjects(record.error.localizedDescription, @"Offline");
+}
+
+- (void) testRecordsNotifications {
+    [self.proxy ping];
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 1);
+    JRPCTrafficRecord *record = [recording recordAtIndex:0];
+    XCTAssertEqual(record.kind, JRPCTrafficRecordKindNotification);
+    XCTAssertEqual(record.latency, 0);
+    XCTAssertNil(record.responseData);
+    NSDictionary *notification = [NSJSONSerialization JSONObjectWithData:record.requestData options:0 error:nil];
+    XCTAssertEqualObjects(notification[@"method"], @"ping");
+    XCTAssertNil(notification[@"id"]);
+}
+
+- (void) testRecordsBatches {
+    self.proxy.batchWindow = 0.05;
+    [self echo:1];
+    [self echo:2];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 1);
+    JRPCTrafficRecord *record = [recording recordAtIndex:0];
+    XCTAssertEqual(record.kind, JRPCTrafficRecordKindBatch);
+    NSArray *requests = [NSJSONSerialization JSONObjectWithData:record.requestData options:0 error:nil];
+    NSArray *responses = [NSJSONSerialization JSONObjectWithData:record.responseData options:0 error:nil];
+    XCTAssertEqual(requests.count, 2);
+    XCTAssertEqual(responses.count, 2);
+}
+
+- (void) testDoesNotRecordWhenNotRecording {
+    self.SUT.recording = NO;
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    self.SUT.recording = YES;
+    [self echo:2];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    [self.SUT synchronize];
+    XCTAssertEqual(self.SUT.recordCount, 1);
+    XCTAssertEqual([self finishRecording].count, 1);
+}
+
+- (void) testReadsRecordingCutShort {
+    for (int i = 0; i < 3; ++i) {
+        [self echo:i];
+    }
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    [self.SUT close];
+    NSData *data = [NSData dataWithContentsOfURL:self.url];
+    [[data subdataWithRange:NSMakeRange(0, data.length - 5)] writeToURL:self.url atomically:YES];
+    NSError *error = nil;
+    JRPCTrafficRecording *recording = [JRPCTrafficRecording recordingWithContentsOfURL:self.url error:&error];
+    XCTAssertNotNil(recording, @"%@", error);
+    XCTAssertEqual(recording.count, 2);
+}
+
+- (void) testRejectsFileThatIsNotRecording {
+    [self.SUT close];
+    [[@"{\"not\":\"a recording\"}" dataUsingEncoding:NSUTF8StringEncoding] writeToURL:self.url atomically:YES];
+    NSError *error = nil;
+    XCTAssertNil([JRPCTrafficRecording recordingWithContentsOfURL:self.url error:&error]);
+    XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void) testRecordsJSONWhateverTheCodec {
+    if (self.transportsPerformSerialization) {
+        return;
+    }
+    self.transport.codec = [[JRPCMessagePackCodec alloc] init];
+    self.proxy = [self proxyWithTransport:self.SUT];
+    self.proxy.codecs = @[ [[JRPCMessagePackCodec alloc] init], [[JRPCJSONCodec alloc] init] ];
+    [self echo:7];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqualObjects(self.transport.usedCodecName, JRPCCodecNameMessagePack);
+    JRPCTrafficRecording *recording = [self finishRecording];
+    XCTAssertEqual(recording.count, 1);
+    NSDictionary *response = [NSJSONSerialization JSONObjectWithData:[recording recordAtIndex:0].responseData options:0 error:nil];
+    XCTAssertEqualObjects(response[@"result"], @7);
+}
+
+#pragma mark - Replay
+
+- (void) testReplayAnswersRecordedRequests {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+        [self echo:2];
+    } replayTransport:&replayTransport];
+    [self echo:2];
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 2);
+    XCTAssertEqual(replayTransport.unmatchedCount, 0);
+}
+
+- (void) testReplayGivesResponsesInTurn {
+    JRPCReplayTransport *replayTransport = nil;
+    JRPCAbstractProxy *proxy = self.proxy;
+    self.proxy = [self replayProxyAfterRecording:^{
+        // One at a time, so they are sent in the order the stub answers them
+        XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+        for (int i = 1; i <= 3; ++i) {
+            XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"next %i", i]];
+            [proxy next:@"a" :^(int result, NSError *error) {
+                XCTAssertEqual(result, i);
+                [expectation fulfill];
+            }];
+            [waiter waitForExpectations:@[ expectation ] timeout:5.0];
+        }
+    } replayTransport:&replayTransport];
+    NSMutableArray<NSNumber*> *results = [[NSMutableArray alloc] init];
+    for (int i = 0; i < 4; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"replayed next %i", i]];
+        [self.proxy next:@"a" :^(int result, NSError *error) {
+            XCTAssertNil(error);
+            [results addObject:@(result)];
+            [expectation fulfill];
+        }];
+        [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    }
+    XCTAssertEqualObjects(results, (@[ @1, @2, @3, @1 ]));
+    [replayTransport reset];
+    XCTAssertEqual(replayTransport.matchedCount, 0);
+}
+
+- (void) testReplayFailsUnrecordedRequests {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+    } replayTransport:&replayTransport];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"echo"];
+    [self.proxy echo:2 :^(int result, NSError *error) {
+        XCTAssertEqualObjects(error.domain, JRPCErrorDomain);
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 0);
+    XCTAssertEqual(replayTransport.unmatchedCount, 1);
+}
+
+- (void) testReplayFailsRequestsThatFailed {
+    self.transport.transportError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        XCTestExpectation *expectation = [self expectationWithDescription:@"recorded echo"];
+        [self.proxy echo:1 :^(int result, NSError *error) {
+            [expectation fulfill];
+        }];
+    } replayTransport:&replayTransport];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"echo"];
+    [self.proxy echo:1 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorTransportCode);
+        NSError *underlyingError = error.userInfo[NSUnderlyingErrorKey];
+        XCTAssertEqualObjects(underlyingError.domain, NSURLErrorDomain);
+        XCTAssertEqual(underlyingError.code, NSURLErrorTimedOut);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 1);
+}
+
+- (void) testReplayDelaysResponsesByRecordedLatency {
+    self.transport.responseLatency = 0.2;
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+    } replayTransport:&replayTransport];
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - startTime, 0.19);
+    replayTransport.speed = 0;
+    startTime = CFAbsoluteTimeGetCurrent();
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - startTime, 0.15);
+}
+
+- (void) testReplayAnswersCallsOfRecordedBatchSingly {
+    self.proxy.batchWindow = 0.05;
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+        [self echo:2];
+    } replayTransport:&replayTransport];
+    [self echo:2];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    [self echo:1];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 2);
+}
+
+- (void) testReplayAnswersBatches {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+        [self echo:2];
+    } replayTransport:&replayTransport];
+    self.proxy.batchWindow = 0.05;
+    [self echo:1];
+    [self echo:2];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"echo 3"];
+    [self.proxy echo:3 :^(int result, NSError *error) {
+        XCTAssertEqual(error.code, JRPCErrorBatchResponseMissingCode);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 2);
+    XCTAssertEqual(replayTransport.unmatchedCount, 1);
+}
+
+#pragma mark - Driver
+
+- (void) testDriverMakesRecordedCalls {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+        [self echo:2];
+        [self echo:3];
+        [self.proxy ping];
+    } replayTransport:&replayTransport];
+    JRPCReplayDriver *driver = [JRPCReplayDriver driverWithRecording:replayTransport.recording
+                                                            protocol:@protocol(JRPCTrafficReplayTestsProtocol)
+                                                      paramStructure:JRPCParameterStructureByPosition
+                                                               proxy:self.proxy];
+    driver.speed = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"replay"];
+    [driver replayWithCompletionQueue:nil completion:^(JRPCReplayStatistics statistics) {
+        XCTAssertEqual(statistics.callCount, 3);
+        XCTAssertEqual(statistics.notificationCount, 1);
+        XCTAssertEqual(statistics.errorCount, 0);
+        [expectation fulfill];
+    }];
+    XCTAssertThrowsSpecificNamed([driver replayWithCompletionQueue:nil completion:^(JRPCReplayStatistics statistics) {}],
+                                 NSException, NSInternalInconsistencyException);
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayTransport.matchedCount, 3);
+    XCTAssertEqual(replayTransport.unmatchedCount, 0);
+}
+
+- (void) testDriverMakesCallsAtRecordedRate {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+        [self waitForExpectationsWithTimeout:5.0 handler:nil];
+        [NSThread sleepForTimeInterval:0.2];
+        [self echo:2];
+    } replayTransport:&replayTransport];
+    JRPCReplayDriver *driver = [JRPCReplayDriver driverWithRecording:replayTransport.recording
+                                                            protocol:@protocol(JRPCTrafficReplayTestsProtocol)
+                                                      paramStructure:JRPCParameterStructureByPosition
+                                                               proxy:self.proxy];
+    __block JRPCReplayStatistics replayStatistics;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"replay"];
+    [driver replayWithCompletionQueue:nil completion:^(JRPCReplayStatistics statistics) {
+        replayStatistics = statistics;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayStatistics.callCount, 2);
+    XCTAssertGreaterThanOrEqual(replayStatistics.duration, 0.19);
+    driver.speed = 4;
+    expectation = [self expectationWithDescription:@"replay faster"];
+    [driver replayWithCompletionQueue:nil completion:^(JRPCReplayStatistics statistics) {
+        replayStatistics = statistics;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertEqual(replayStatistics.callCount, 2);
+    XCTAssertLessThan(replayStatistics.duration, 0.15);
+}
+
+- (void) testDriverCountsErrors {
+    JRPCReplayTransport *replayTransport = nil;
+    self.proxy = [self replayProxyAfterRecording:^{
+        [self echo:1];
+    } replayTransport:&replayTransport];
+    // Replayed against the live transport, now failing
+    JRPCReplayDriver *driver = [JRPCReplayDriver driverWithRecording:replayTransport.recording
+                                                            protocol:@protocol(JRPCTrafficReplayTestsProtocol)
+                                                      paramStructure:JRPCParameterStructureByPosition
+                                                               proxy:[self proxyWithTransport:self.transport]];
+    self.transport.transportError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    driver.speed = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"replay"];
+    [driver replayWithCompletionQueue:nil completion:^(JRPCReplayStatistics statistics) {
+        XCTAssertEqual(statistics.callCount, 1);
+        XCTAssertEqual(statistics.errorCount, 1);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+}
+
+@end
+
+@implementation JRPCTrafficReplayObjectTests
+
+- (void)setUp {
+    self.transportsPerformSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -0,0 +1,360 @@
+//
+//  JRPCTransportPoolTests.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "JRPCAbstractProxy.h"
+#import "JRPCTransportPool.h"
+#import "JRPCProxyTransportStub.h"
+#import "JRPCMessagePackCodec.h"
+#import "JRPCJSONCodec.h"
+#import "JRPCError.h"
+
+// The number of child transports in the pool
+static const NSUInteger JRPCTransportPoolTestsTransportCount = 3;
+
+// This is the protocol being proxied over the SUT ...
+@protocol JRPCTransportPoolTestsProtocol
+- (void) echo:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) write:(int)value :(void (^)(int result, NSError *error))completion;
+- (void) ping;
+@end
+// ... so we declare conformance to the protocol by the proxy to satisfy the compiler
+@interface JRPCAbstractProxy() <JRPCTransportPoolTestsProtocol>
+@end
+
+/**
+ Test cases for JRPCTransportPool, when the proxy performs serialization
+ */
+@interface JRPCTransportPoolTests : XCTestCase
+/** The System Under Test */
+@property (nonatomic, strong) JRPCTransportPool *SUT;
+@property (nonatomic, strong) NSArray<JRPCProxyTransportStub*> *transports;
+@property (nonatomic, strong) JRPCAbstractProxy *proxy;
+/** Whether the stubs perform serialization. Set by sub-classes BEFORE calling [super setUp] */
+@property (nonatomic, assign) BOOL transportStubsPerformSerialization;
+@end
+
+/**
+ Test cases for JRPCTransportPool, when the transports perform serialization
+ */
+@interface JRPCTransportPoolObjectTests : JRPCTransportPoolTests
+@end
+
+@implementation JRPCTransportPoolTests
+
+- (void)setUp {
+    [super setUp];
+    NSMutableArray<JRPCProxyTransportStub*> *transports = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        JRPCProxyTransportStub *transport = [[JRPCProxyTransportStub alloc] init];
+        transport.performsSerialization = self.transportStubsPerformSerialization;
+        [transport configureMethods:@[ @"echo", @"write" ] result:^id(id params) {
+            return params[0];
+        }];
+        [transports addObject:transport];
+    }
+    self.transports = transports;
+    self.SUT = [JRPCTransportPool poolWithTransports:transports];
+    self.SUT.idempotentMethodNames = [NSSet setWithObject:@"echo"];
+    self.proxy = [JRPCAbstractProxy proxyForProtocol:@protocol(JRPCTransportPoolTestsProtocol)
+                                      paramStructure:JRPCParameterStructureByPosition
+                                           transport:self.SUT];
+}
+
+- (void)tearDown {
+    self.proxy = nil;
+    self.SUT = nil;
+    self.transports = nil;
+    [super tearDown];
+}
+
+- (XCTestExpectation*) echo:(int)value {
+    XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"echo %i", value]];
+    [self.proxy echo:value :^(int result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, value);
+        [expectation fulfill];
+    }];
+    return expectation;
+}
+
+// Makes calls one at a time, so every child is idle when each is sent. Returns the number that failed
+- (NSUInteger) echoInTurn:(NSUInteger)callCount {
+    NSMutableArray<NSError*> *errors = [[NSMutableArray alloc] init];
+    XCTWaiter *waiter = [[XCTWaiter alloc] initWithDelegate:self];
+    for (NSUInteger i = 0; i < callCount; ++i) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"echo %lu", (unsigned long)i]];
+        [self.proxy echo:(int)i :^(int result, NSError *error) {
+            if (error) {
+                [errors addObject:error];
+            }
+            [expectation fulfill];
+        }];
+        [waiter waitForExpectations:@[ expectation ] timeout:60.0];
+    }
+    return errors.count;
+}
+
+- (NSArray<id>*) allReceivedRequestIds {
+    NSMutableArray<id> *requestIds = [[NSMutableArray alloc] init];
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        [requestIds addObjectsFromArray:transport.receivedRequestIds];
+    }
+    return requestIds;
+}
+
+#pragma mark - Tests
+
+- (void) testRequestsGoToTransportWithFewestOutstanding {
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.withholdsResponses = YES;
+    }
+    for (int i = 0; i < 2 * JRPCTransportPoolTestsTransportCount; ++i) {
+        [self echo:i];
+    }
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        XCTAssertEqual(self.transports[i].receivedRequestIds.count, 2);
+        XCTAssertEqual([self.SUT statisticsForTransportAtIndex:i].outstandingCount, 2);
+    }
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.withholdsResponses = NO;
+        [transport releaseWithheldResponses];
+    }
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        JRPCTransportPoolStatistics statistics = [self.SUT statisticsForTransportAtIndex:i];
+        XCTAssertEqual(statistics.outstandingCount, 0);
+        XCTAssertEqual(statistics.sentCount, 2);
+        XCTAssertEqual(statistics.errorCount, 0);
+    }
+}
+
+- (void) testFasterTransportIsPreferredWhenIdle {
+    self.transports[0].latencyDistribution = ^NSTimeInterval{ return 0.05; };
+    self.transports[1].latencyDistribution = ^NSTimeInterval{ return 0.05 + 0.01 * drand48(); };
+    self.transports[2].latencyDistribution = ^NSTimeInterval{ return 0.001; };
+    XCTAssertEqual([self echoInTurn:20], 0);
+    // Each child is tried once before its latency is known
+    XCTAssertLessThanOrEqual(self.transports[0].receivedRequestIds.count, 1);
+    XCTAssertLessThanOrEqual(self.transports[1].receivedRequestIds.count, 1);
+    XCTAssertGreaterThanOrEqual(self.transports[2].receivedRequestIds.count, 18);
+    XCTAssertGreaterThan([self.SUT statisticsForTransportAtIndex:0].latency, [self.SUT statisticsForTransportAtIndex:2].latency);
+}
+
+- (void) testFailingTransportIsAvoided {
+    self.transports[0].transportError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNetworkConnectionLost userInfo:nil];
+    XCTAssertLessThanOrEqual([self echoInTurn:20], 1);
+    JRPCTransportPoolStatistics statistics = [self.SUT statisticsForTransportAtIndex:0];
+    XCTAssertLessThanOrEqual(statistics.sentCount, 1);
+    XCTAssertEqual(statistics.errorCount, statistics.sentCount);
+}
+
+- (void) testSlowRequestIsHedged {
+    self.SUT.hedgesRequests = YES;
+    XCTAssertEqual(self.SUT.hedgeDelay, 0);
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.latencyDistribution = ^NSTimeInterval{ return 0.005 + 0.005 * drand48(); };
+    }
+    XCTAssertEqual([self echoInTurn:40], 0);
+    XCTAssertGreaterThan(self.SUT.hedgeDelay, 0);
+    // The next request stalls, wherever it is sent
+    NSMutableArray<NSNumber*> *stalls = [@[ @YES ] mutableCopy];
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.latencyDistribution = ^NSTimeInterval{
+            @synchronized (stalls) {
+                BOOL stalled = stalls.count > 0;
+                [stalls removeAllObjects];
+                return stalled ? 30.0 : 0.005;
+            }
+        };
+    }
+    NSDate *start = [NSDate date];
+    [self echo:42];
+    [self waitForExpectationsWithTimeout:10.0 handler:nil];
+    XCTAssertLessThan(-start.timeIntervalSinceNow, 10.0);
+    NSUInteger hedgedCount = 0;
+    NSMutableArray<id> *cancelledRequestIds = [[NSMutableArray alloc] init];
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        hedgedCount += [self.SUT statisticsForTransportAtIndex:i].hedgedCount;
+        [cancelledRequestIds addObjectsFromArray:self.transports[i].cancelledRequestIds];
+    }
+    XCTAssertEqual(hedgedCount, 1);
+    // The stalled child is told to drop the request, which no longer counts as outstanding
+    XCTAssertEqualObjects(cancelledRequestIds, @[ @40 ]);
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        XCTAssertEqual([self.SUT statisticsForTransportAtIndex:i].outstandingCount, 0);
+    }
+    NSArray<id> *requestIds = [self allReceivedRequestIds];
+    XCTAssertEqual([requestIds indexesOfObjectsPassingTest:^BOOL(id requestId, NSUInteger idx, BOOL *stop) { return [requestId isEqual:@40]; }].count, 2);
+}
+
+- (void) testNonIdempotentRequestIsNotHedged {
+    self.SUT.hedgesRequests = YES;
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.latencyDistribution = ^NSTimeInterval{ return 0.005 + 0.005 * drand48(); };
+    }
+    XCTAssertEqual([self echoInTurn:40], 0);
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.latencyDistribution = ^NSTimeInterval{ return 0.5; };
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"write"];
+    [self.proxy write:7 :^(int result, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(result, 7);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        XCTAssertEqual([self.SUT statisticsForTransportAtIndex:i].hedgedCount, 0);
+    }
+    XCTAssertEqual([self allReceivedRequestIds].count, 41);
+}
+
+- (void) testCancelIsForwardedToTransport {
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.withholdsResponses = YES;
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"cancelled"];
+    id<JRPCCall> call = [self.proxy callWithHandle:^{
+        [self.proxy echo:1 :^(int result, NSError *error) {
+            XCTAssertEqual(error.code, JRPCErrorCancelledCode);
+            [expectation fulfill];
+        }];
+    }];
+    [call cancel];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSUInteger cancelledCount = 0;
+    for (NSUInteger i = 0; i < JRPCTransportPoolTestsTransportCount; ++i) {
+        JRPCProxyTransportStub *transport = self.transports[i];
+        if (transport.receivedRequestIds.count > 0) {
+            XCTAssertEqualObjects(transport.cancelledRequestIds, @[ @0 ]);
+            cancelledCount++;
+        }
+        XCTAssertEqual([self.SUT statisticsForTransportAtIndex:i].outstandingCount, 0);
+    }
+    XCTAssertEqual(cancelledCount, 1);
+}
+
+- (void) testCancelInBatchIsForwardedToTransport {
+    self.proxy.batchWindow = 60.0;
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.withholdsResponses = YES;
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"cancelled"];
+    id<JRPCCall> call = [self.proxy callWithHandle:^{
+        [self.proxy echo:1 :^(int result, NSError *error) {
+            XCTAssertEqual(error.code, JRPCErrorCancelledCode);
+            [expectation fulfill];
+        }];
+    }];
+    [self.proxy echo:2 :^(int result, NSError *error) {
+    }];
+    [self.proxy flushBatch];
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:60.0];
+    while (0 == [[self.transports valueForKeyPath:@"@sum.batchCount"] unsignedIntegerValue] && deadline.timeIntervalSinceNow > 0) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    [call cancel];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    // The ids of the calls in the batch were read, so the one cancelled is forwarded to the child sent the batch
+    XCTAssertEqualObjects([self.transports valueForKeyPath:@"@unionOfArrays.cancelledRequestIds"], @[ @0 ]);
+}
+
+- (void) testBatchIsSentToOneTransport {
+    self.proxy.batchWindow = 60.0;
+    for (int i = 0; i < 4; ++i) {
+        [self echo:i];
+    }
+    [self.proxy flushBatch];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    NSUInteger batchCount = 0;
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        if (transport.batchCount > 0) {
+            XCTAssertEqual(transport.lastBatchSize, 4);
+        }
+        batchCount += transport.batchCount;
+    }
+    XCTAssertEqual(batchCount, 1);
+}
+
+- (void) testNotificationIsSentToOneTransport {
+    [self.proxy ping];
+    NSUInteger notificationCount = 0;
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        notificationCount += transport.receivedNotifications.count;
+    }
+    XCTAssertEqual(notificationCount, 1);
+}
+
+- (void) testTransportsMustShareSerialization {
+    JRPCProxyTransportStub *objectTransport = [[JRPCProxyTransportStub alloc] init];
+    objectTransport.performsSerialization = YES;
+    JRPCProxyTransportStub *dataTransport = [[JRPCProxyTransportStub alloc] init];
+    XCTAssertThrowsSpecificNamed([JRPCTransportPool poolWithTransports:(@[ objectTransport, dataTransport ])], NSException, NSInvalidArgumentException);
+    XCTAssertThrowsSpecificNamed([JRPCTransportPool poolWithTransports:@[]], NSException, NSInvalidArgumentException);
+}
+
+- (void) testCodecSupportedByAllTransportsIsUsed {
+    if (self.transportStubsPerformSerialization) {
+        // The proxy only negotiates a codec when it performs serialization
+        return;
+    }
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        transport.codec = [[JRPCMessagePackCodec alloc] init];
+    }
+    XCTAssertEqualObjects(self.SUT.supportedCodecNames, @[ JRPCCodecNameMessagePack ]);
+    self.proxy.codecs = @[ [[JRPCJSONCodec alloc] init], [[JRPCMessagePackCodec alloc] init] ];
+    for (JRPCProxyTransportStub *transport in self.transports) {
+        XCTAssertEqualObjects(transport.usedCodecName, JRPCCodecNameMessagePack);
+        transport.withholdsResponses = YES;
+    }
+    // The pool reads the ids of MessagePack requests, so can still forward cancellation
+    XCTestExpectation *expectation = [self expectationWithDescription:@"cancelled"];
+    id<JRPCCall> call = [self.proxy callWithHandle:^{
+        [self.proxy echo:1 :^(int result, NSError *error) {
+            XCTAssertEqual(error.code, JRPCErrorCancelledCode);
+            [expectation fulfill];
+        }];
+    }];
+    [call cancel];
+    [self waitForExpectationsWithTimeout:60.0 handler:nil];
+    XCTAssertEqualObjects([self.transports valueForKeyPath:@"@unionOfArrays.cancelledRequestIds"], @[ @0 ]);
+}
+
+@end
+
+@implementation JRPCTransportPoolObjectTests
+
+- (void)setUp {
+    self.transportStubsPerformSerialization = YES;
+    [super setUp];
+}
+
+@end
@@ -28,6 +28,7 @@
  */
 
 #import "JRPCProxyTransport.h"
+#import "JRPCCodec.h"
 
 /**
  JRPCProxyTransportStub provides a stub service to use as a JRPCProxyTransport
@@ -42,6 +43,72 @@
  */
 @property (nonatomic, assign) BOOL performsSerialization;
 
+/**
+ Configure the codec requests & responses are encoded with when performsSerialization is NO. The stub reports it to the proxy as the only codec it supports.
+ nil (the default) for JSON. Set before the proxy is created, or set the proxy's codecs again to renegotiate
+ */
+@property (nonatomic, strong) id<JRPCCodec> codec;
+
+/**
+ Configure whether the stub implements the dispatch data methods, which the proxy then prefers to the NSData methods. Defaults to NO
+ Set before the proxy is created
+ */
+@property (nonatomic, assign) BOOL usesDispatchData;
+
+/** Configure the stub to split each response passed back as dispatch data into regions of this many bytes, as reads from a socket would. 0 (the default) for one region */
+@property (atomic, assign) NSUInteger responseFragmentSize;
+
+/** The number of regions in the dispatch data of the request most recently sent to the stub with usesDispatchData */
+@property (nonatomic, readonly) NSUInteger lastRequestRegionCount;
+
+/** The name of the codec the proxy most recently chose with useCodecWithName: */
+@property (nonatomic, readonly, copy) NSString *usedCodecName;
+
+/** The serialized JSON-RPC request most recently sent to the stub when performsSerialization is NO */
+@property (nonatomic, readonly) NSData *lastRequestData;
+
+/** The completion queue most recently passed to the stub with a request */
+@property (nonatomic, readonly) dispatch_queue_t lastCompletionQueue;
+
+/** Configure whether the stub implements the JSON-RPC batch methods. Defaults to YES */
+@property (nonatomic, assign) BOOL supportsBatches;
+
+/** Configure the stub to return batch responses in the reverse order of the requests */
+@property (nonatomic, assign) BOOL reversesBatchResponses;
+
+/** Configure whether the stub implements the JSON-RPC notification methods. Defaults to YES */
+@property (nonatomic, assign) BOOL supportsNotifications;
+
+/** The JSON-RPC notification objects sent to the stub, by either the notification or request methods, in the order they were received */
+@property (nonatomic, readonly) NSArray<NSDictionary*> *receivedNotifications;
+
+/** Configure the stub to hold back responses until releaseWithheldResponses is called, as a stalled server would */
+@property (nonatomic, assign) BOOL withholdsResponses;
+
+/** Configure the stub to delay each response by this many seconds, as the round trip to a server would. Defaults to 0 */
+@property (atomic, assign) NSTimeInterval responseLatency;
+
+/** Configure the stub to delay each response by the number of seconds this block returns, e.g. drawn from a distribution. Overrides responseLatency */
+@property (atomic, copy) NSTimeInterval (^latencyDistribution)(void);
+
+/** Configure the stub to fail every request with this error, as a broken connection would. nil (the default) to respond normally */
+@property (atomic, strong) NSError *transportError;
+
+/** Sends the responses held back while withholdsResponses was YES */
+- (void) releaseWithheldResponses;
+
+/** The ids of the requests the proxy has cancelled, in the order they were cancelled */
+@property (nonatomic, readonly) NSArray<id> *cancelledRequestIds;
+
+/** The ids of the JSON-RPC requests sent to the stub, in the order they were received */
+@property (nonatomic, readonly) NSArray<id> *receivedRequestIds;
+
+/** The number of JSON-RPC batch requests sent to the stub */
+@property (nonatomic, readonly) NSUInteger batchCount;
+
+/** The number of calls in the JSON-RPC batch request most recently sent to the stub */
+@property (nonatomic, readonly) NSUInteger lastBatchSize;
+
 /**
  Configure the stub to return result on calling the method
  @param methodName the name of the method to be stubbed
@@ -30,10 +30,22 @@
 #import "JRPCProxyTransportStub.h"
 #import "NSDictionary+JSONRPC.h"
 #import "JRPCError.h"
+#import "JRPCJSONCodec.h"
 
 @interface JRPCProxyTransportStub()
 @property (nonatomic, strong) NSMutableDictionary<NSString*, id> *stubbedResponses;
 @property (nonatomic, strong) NSMutableDictionary<NSString*, NSDictionary*> *stubbedErrors;
+// Atomic, as the proxy may send requests from any thread
+@property (atomic, copy) NSData *lastRequestData;
+@property (atomic, strong) dispatch_queue_t lastCompletionQueue;
+@property (atomic, assign) NSUInteger lastRequestRegionCount;
+@property (nonatomic, assign) NSUInteger batchCount;
+@property (nonatomic, assign) NSUInteger lastBatchSize;
+@property (nonatomic, strong) NSMutableArray<NSDictionary*> *notifications;
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *withheldResponses;
+@property (nonatomic, strong) NSMutableArray<id> *cancelled;
+@property (nonatomic, strong) NSMutableArray<id> *requestIds;
+@property (nonatomic, copy) NSString *usedCodecName;
 @end
 
 // JSON-RPC Version
@@ -84,8 +96,41 @@ static NSDictionary *internalError;
     self.stubbedErrors[methodName] = [error copy];  // copy trips mutability
 }
 
+- (NSArray<NSDictionary*>*) receivedNotifications {
+    @synchronized (self.notifications) {
+        return [self.notifications copy];
+    }
+}
+
+- (NSArray<id>*) cancelledRequestIds {
+    @synchronized (self.cancelled) {
+        return [self.cancelled copy];
+    }
+}
+
+- (NSArray<id>*) receivedRequestIds {
+    @synchronized (self.requestIds) {
+        return [self.requestIds copy];
+    }
+}
+
+- (void) releaseWithheldResponses {
+    NSArray<dispatch_block_t> *withheldResponses = [self.withheldResponses copy];
+    [self.withheldResponses removeAllObjects];
+    for (dispatch_block_t sendResponse in withheldResponses) {
+        sendResponse();
+    }
+}
+
 #pragma mark - Private
 
+- (void) receiveNotification:(NSDictionary*)jsonRPCNotification {
+    NSLog(@"%s - notification: %@", __func__, jsonRPCNotification);
+    @synchronized (self.notifications) {
+        [self.notifications addObject:jsonRPCNotification];
+    }
+}
+
 - (NSDictionary*) responseForRequest:(NSDictionary*)jsonRPCRequest {
     NSLog(@"%s - request: %@", __func__, jsonRPCRequest);
     id result = nil;
@@ -94,6 +139,15 @@ static NSDictionary *internalError;
     NSString *version = jsonRPCRequest[kJSONRPCVersionKey];
     NSString *methodName = jsonRPCRequest[kJSONRPCMethodKey];
     id requestId = jsonRPCRequest[kJSONRPCRequestIdKey];
+    if (requestId) {
+        @synchronized (self.requestIds) {
+            [self.requestIds addObject:requestId];
+        }
+    }
+    else {
+        // A notification sent as a request. A server would not reply, but the stub has to complete the request so returns an error like any invalid request
+        [self receiveNotification:jsonRPCRequest];
+    }
     if (![kJSONRPCVersion isEqualToString:version] ||
         !requestId ||
         methodName.length == 0) {
@@ -145,24 +199,102 @@ static NSDictionary *internalError;
     // Complete request
     if (NULL != completion) {
         dispatch_queue_t queue = completionQueue ? : dispatch_get_main_queue();
-        dispatch_async(queue, ^{
-            completion(jsonRPCResponse, nil);
-        });
+        NSError *transportError = self.transportError;
+        [self sendResponse:^{
+            dispatch_async(queue, ^{
+                completion(transportError ? nil : jsonRPCResponse, transportError);
+            });
+        }];
+    }
+}
+
+- (NSArray<NSDictionary*>*) responsesForBatchRequest:(id)jsonRPCRequests {
+    if (![jsonRPCRequests isKindOfClass:[NSArray class]] || 0 == [jsonRPCRequests count]) {
+        // Not a valid batch, so a single error response
+        return @[ @{ kJSONRPCVersionKey   : kJSONRPCVersion,
+                     kJSONRPCRequestIdKey : [NSNull null],
+                     kJSONRPCErrorKey     : invalidRequestError } ];
+    }
+    self.batchCount++;
+    self.lastBatchSize = [jsonRPCRequests count];
+    NSMutableArray<NSDictionary*> *jsonRPCResponses = [[NSMutableArray alloc] init];
+    for (id jsonRPCRequest in jsonRPCRequests) {
+        if ([jsonRPCRequest isKindOfClass:[NSDictionary class]]) {
+            [jsonRPCResponses addObject:[self responseForRequest:jsonRPCRequest]];
+        }
+        else {
+            [jsonRPCResponses addObject:@{ kJSONRPCVersionKey   : kJSONRPCVersion,
+                                           kJSONRPCRequestIdKey : [NSNull null],
+                                           kJSONRPCErrorKey     : invalidRequestError }];
+        }
     }
+    return self.reversesBatchResponses ? jsonRPCResponses.reverseObjectEnumerator.allObjects : [jsonRPCResponses copy];
 }
 
-- (void) completeRequestWithSerializedResponse:(NSDictionary*)jsonRPCResponse
+- (void) completeRequestWithSerializedResponse:(id)jsonRPCResponse
                                completionQueue:(dispatch_queue_t)completionQueue
                                     completion:(JRPCTransportDataCompletion)completion {
     NSLog(@"%s - response: %@", __func__, jsonRPCResponse);
     // Seralize response
-    NSData *data = [NSJSONSerialization dataWithJSONObject:jsonRPCResponse options:0 error:nil];
+    NSData *data = [self dataWithObject:jsonRPCResponse];
     // Complete request
     if (NULL != completion) {
         dispatch_queue_t queue = completionQueue ? : dispatch_get_main_queue();
-        dispatch_async(queue, ^{
-            completion(data, nil);
-        });
+        NSError *transportError = self.transportError;
+        [self sendResponse:^{
+            dispatch_async(queue, ^{
+                completion(transportError ? nil : data, transportError);
+            });
+        }];
+    }
+}
+
+- (NSUInteger) regionCountOfDispatchData:(dispatch_data_t)data {
+    __block NSUInteger count = 0;
+    dispatch_data_apply(data, ^bool(dispatch_data_t region, size_t offset, const void *buffer, size_t size) {
+        ++count;
+        return true;
+    });
+    return count;
+}
+
+// Passes the serialized response on as dispatch data, split into regions of responseFragmentSize bytes
+- (JRPCTransportDataCompletion) dataCompletionWithDispatchDataCompletion:(JRPCTransportDispatchDataCompletion)completion {
+    NSUInteger fragmentSize = self.responseFragmentSize;
+    return ^(NSData *data, NSError *error) {
+        if (!data) {
+            completion(nil, error);
+            return;
+        }
+        NSUInteger regionSize = fragmentSize ? : MAX(data.length, 1);
+        dispatch_data_t dispatchData = dispatch_data_empty;
+        for (NSUInteger offset = 0; offset < data.length; offset += regionSize) {
+            dispatch_data_t region = dispatch_data_create((const uint8_t*)data.bytes + offset, MIN(regionSize, data.length - offset), NULL, DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+            dispatchData = dispatch_data_create_concat(dispatchData, region);
+        }
+        completion(dispatchData, nil);
+    };
+}
+
+- (id) objectWithData:(NSData*)data error:(NSError**)error {
+    return self.codec ? [self.codec decodeData:data error:error] : [NSJSONSerialization JSONObjectWithData:data options:0 error:error];
+}
+
+- (NSData*) dataWithObject:(id)object {
+    return self.codec ? [self.codec encodeObject:object error:nil] : [NSJSONSerialization dataWithJSONObject:object options:0 error:nil];
+}
+
+- (void) sendResponse:(dispatch_block_t)sendResponse {
+    NSTimeInterval (^latencyDistribution)(void) = self.latencyDistribution;
+    NSTimeInterval responseLatency = latencyDistribution ? latencyDistribution() : self.responseLatency;
+    if (self.withholdsResponses) {
+        [self.withheldResponses addObject:sendResponse];
+    }
+    else if (responseLatency > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(responseLatency * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), sendResponse);
+    }
+    else {
+        sendResponse();
     }
 }
 
@@ -173,6 +305,12 @@ static NSDictionary *internalError;
     if (self) {
         self.stubbedResponses = [[NSMutableDictionary alloc] init];
         self.stubbedErrors = [[NSMutableDictionary alloc] init];
+        self.supportsBatches = YES;
+        self.supportsNotifications = YES;
+        self.notifications = [[NSMutableArray alloc] init];
+        self.withheldResponses = [[NSMutableArray alloc] init];
+        self.cancelled = [[NSMutableArray alloc] init];
+        self.requestIds = [[NSMutableArray alloc] init];
     }
     return self;
 }
@@ -182,6 +320,27 @@ static NSDictionary *internalError;
     if (!self.performsSerialization && [NSStringFromSelector(aSelector) isEqualToString:NSStringFromSelector(@selector(sendJSONRPCPayloadWithRequestObject:completionQueue:completion:))]) {
         return NO;
     }
+    // ... and to not respond to the dispatch data methods unless self.usesDispatchData == YES
+    if (!self.usesDispatchData &&
+        (sel_isEqual(aSelector, @selector(sendJSONRPCPayloadWithRequestDispatchData:completionQueue:completion:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestDispatchData:completionQueue:completion:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestDispatchData:)))) {
+        return NO;
+    }
+    // ... and to not respond to the batch methods if self.supportsBatches == NO
+    if (!self.supportsBatches &&
+        (sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestObjects:completionQueue:completion:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestData:completionQueue:completion:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCBatchPayloadWithRequestDispatchData:completionQueue:completion:)))) {
+        return NO;
+    }
+    // ... and to not respond to the notification methods if self.supportsNotifications == NO
+    if (!self.supportsNotifications &&
+        (sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestObject:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestData:)) ||
+         sel_isEqual(aSelector, @selector(sendJSONRPCNotificationWithRequestDispatchData:)))) {
+        return NO;
+    }
     return [super respondsToSelector:aSelector];
 }
 
@@ -190,6 +349,7 @@ static NSDictionary *internalError;
 - (void) sendJSONRPCPayloadWithRequestObject:(NSDictionary*)jsonRPCRequest
                              completionQueue:(dispatch_queue_t)completionQueue
                                   completion:(JRPCTransportObjectCompletion)completion {
+    self.lastCompletionQueue = completionQueue;
     // When the stub declares that the transport performs serialzation, the proxy will pass us the JSON-PRC request object rather than serialized data
     // Obviously the stub doesn't serialize it, since we don't send it anywhere and just prepare a response
     NSDictionary *jsonRPCResponse = nil;
@@ -212,10 +372,12 @@ static NSDictionary *internalError;
 - (void) sendJSONRPCPayloadWithRequestData:(NSData*)payload
             completionQueue:(dispatch_queue_t)completionQueue
                  completion:(JRPCTransportDataCompletion)completion {
+    self.lastCompletionQueue = completionQueue;
     // Ironically, when the stub declares that the transport does NOT perform serialization, we need to reverse the serialization that the proxy has already done on its behalf!
+    self.lastRequestData = payload;
     // Deserialize request
     NSError *serializationError = nil;
-    id jsonObject = [NSJSONSerialization JSONObjectWithData:payload options:0 error:&serializationError];
+    id jsonObject = [self objectWithData:payload error:&serializationError];
     NSDictionary *jsonRPCResponse = nil;
     if ([jsonObject isKindOfClass:[NSDictionary class]]) {
         // Successful serialization
@@ -234,5 +396,92 @@ static NSDictionary *internalError;
     [self completeRequestWithSerializedResponse:jsonRPCResponse completionQueue:completionQueue completion:completion];
 }
 
+- (void) sendJSONRPCPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportDispatchDataCompletion)completion {
+    self.lastRequestRegionCount = [self regionCountOfDispatchData:payload];
+    // Dispatch data is an NSData, joined into one buffer when the stub decodes it
+    [self sendJSONRPCPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:[self dataCompletionWithDispatchDataCompletion:completion]];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestObjects:(NSArray<NSDictionary*>*)jsonRPCRequests
+                                   completionQueue:(dispatch_queue_t)completionQueue
+                                        completion:(JRPCTransportBatchObjectCompletion)completion {
+    self.lastCompletionQueue = completionQueue;
+    NSArray<NSDictionary*> *jsonRPCResponses = [self responsesForBatchRequest:jsonRPCRequests];
+    NSLog(@"%s - responses: %@", __func__, jsonRPCResponses);
+    if (NULL != completion) {
+        dispatch_queue_t queue = completionQueue ? : dispatch_get_main_queue();
+        NSError *transportError = self.transportError;
+        [self sendResponse:^{
+            dispatch_async(queue, ^{
+                completion(transportError ? nil : jsonRPCResponses, transportError);
+            });
+        }];
+    }
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload
+                                completionQueue:(dispatch_queue_t)completionQueue
+                                     completion:(JRPCTransportDataCompletion)completion {
+    self.lastCompletionQueue = completionQueue;
+    self.lastRequestData = payload;
+    // Deserialize the batch request
+    id jsonObject = [self objectWithData:payload error:nil];
+    id jsonRPCResponse = nil;
+    if (jsonObject) {
+        jsonRPCResponse = [self responsesForBatchRequest:jsonObject];
+        if (![jsonObject isKindOfClass:[NSArray class]] || 0 == [jsonObject count]) {
+            // The error for a request that is not a valid batch is not wrapped in an array
+            jsonRPCResponse = [jsonRPCResponse firstObject];
+        }
+    }
+    else {
+        // JSON parse failed
+        jsonRPCResponse = @{ kJSONRPCVersionKey   : kJSONRPCVersion,
+                             kJSONRPCRequestIdKey : [NSNull null],
+                             kJSONRPCErrorKey     : parseError };
+    }
+    [self completeRequestWithSerializedResponse:jsonRPCResponse completionQueue:completionQueue completion:completion];
+}
+
+- (void) sendJSONRPCBatchPayloadWithRequestDispatchData:(dispatch_data_t)payload
+                                        completionQueue:(dispatch_queue_t)completionQueue
+                                             completion:(JRPCTransportDispatchDataCompletion)completion {
+    self.lastRequestRegionCount = [self regionCountOfDispatchData:payload];
+    [self sendJSONRPCBatchPayloadWithRequestData:(NSData*)payload completionQueue:completionQueue completion:[self dataCompletionWithDispatchDataCompletion:completion]];
+}
+
+- (void) sendJSONRPCNotificationWithRequestObject:(NSDictionary*)jsonRPCNotification {
+    [self receiveNotification:jsonRPCNotification];
+}
+
+- (void) cancelJSONRPCRequestWithId:(id)requestId {
+    // Called on the proxy's internal queue
+    @synchronized (self.cancelled) {
+        [self.cancelled addObject:requestId];
+    }
+}
+
+- (NSArray<NSString*>*) supportedCodecNames {
+    return @[ self.codec.name ? : JRPCCodecNameJSON ];
+}
+
+- (void) useCodecWithName:(NSString*)name {
+    self.usedCodecName = name;
+}
+
+- (void) sendJSONRPCNotificationWithRequestData:(NSData*)payload {
+    self.lastRequestData = payload;
+    id jsonObject = [self objectWithData:payload error:nil];
+    if ([jsonObject isKindOfClass:[NSDictionary class]]) {
+        [self receiveNotification:jsonObject];
+    }
+}
+
+- (void) sendJSONRPCNotificationWithRequestDispatchData:(dispatch_data_t)payload {
+    self.lastRequestRegionCount = [self regionCountOfDispatchData:payload];
+    [self sendJSONRPCNotificationWithRequestData:(NSData*)payload];
+}
 
 @end
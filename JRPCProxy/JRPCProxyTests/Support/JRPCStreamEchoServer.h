@@ -0,0 +1,68 @@
+//
+//  JRPCStreamEchoServer.h
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "JRPCStreamTransport.h"
+
+/**
+ JRPCStreamEchoServer is a minimal JSON-RPC server for testing JRPCStreamTransport over one end of a socketpair()
+ Every request is answered with its first by-position param as the result. Notifications are counted but not answered.
+ The server runs on its own thread from start until the other end of the stream is closed, or stop is called
+ */
+@interface JRPCStreamEchoServer : NSObject
+
+/**
+ Creates a server for a connected stream
+ @param fileDescriptor The server end of the stream. The server closes it when it finishes
+ @param framing How payloads are delimited on the stream, which must match the transport
+ */
+- (instancetype) initWithFileDescriptor:(int)fileDescriptor framing:(JRPCStreamFraming)framing;
+
+/** Configure the server to answer the requests received in each read from the stream in reverse order */
+@property (atomic, assign) BOOL respondsInReverseOrder;
+
+/** Configure the server to read requests without ever answering them */
+@property (atomic, assign) BOOL ignoresRequests;
+
+/** Configure the server to write responses this many bytes at a time, pausing between writes so each arrives in a read of its own. 0 (the default) to write them whole */
+@property (atomic, assign) NSUInteger fragmentSize;
+
+/** The number of notifications received */
+@property (atomic, readonly) NSUInteger notificationCount;
+
+/** The number of batch requests received */
+@property (atomic, readonly) NSUInteger batchCount;
+
+/** Starts serving on a new thread */
+- (void) start;
+
+/** Shuts down the stream, which the transport sees as the stream closing */
+- (void) stop;
+
+@end
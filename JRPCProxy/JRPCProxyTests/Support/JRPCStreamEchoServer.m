@@ -0,0 +1,167 @@
+//
+//  JRPCStreamEchoServer.m
+//  JRPCProxyTests
+//
+//  Created on: 17/10/2026
+//
+
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2017 YouView Ltd
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import "JRPCStreamEchoServer.h"
+#import "NSDictionary+JSONRPC.h"
+#import <unistd.h>
+#import <sys/socket.h>
+
+// JSON-RPC Version
+static const NSString * const kJSONRPCVersion = @"2.0";
+
+@interface JRPCStreamEchoServer()
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, assign) JRPCStreamFraming framing;
+@property (atomic, assign) NSUInteger notificationCount;
+@property (atomic, assign) NSUInteger batchCount;
+@end
+
+@implementation JRPCStreamEchoServer
+
+- (instancetype) initWithFileDescriptor:(int)fileDescriptor framing:(JRPCStreamFraming)framing {
+    self = [super init];
+    if (self) {
+        self.fileDescriptor = fileDescriptor;
+        self.framing = framing;
+    }
+    return self;
+}
+
+- (void) start {
+    [NSThread detachNewThreadSelector:@selector(serve) toTarget:self withObject:nil];
+}
+
+- (void) stop {
+    shutdown(self.fileDescriptor, SHUT_RDWR);
+}
+
+#pragma mark - Private
+
+- (void) serve {
+    NSMutableData *buffer = [[NSMutableData alloc] init];
+    uint8_t chunk[65536];
+    ssize_t count;
+    while ((count = read(self.fileDescriptor, chunk, sizeof(chunk))) > 0) {
+        @autoreleasepool {
+            [buffer appendBytes:chunk length:(NSUInteger)count];
+            NSMutableArray *responses = [[NSMutableArray alloc] init];
+            NSData *frame = nil;
+            while ((frame = [self nextFrameFromBuffer:buffer])) {
+                id response = [self responseForPayload:[NSJSONSerialization JSONObjectWithData:frame options:0 error:nil]];
+                if (response) {
+                    [responses addObject:response];
+                }
+            }
+            if (self.ignoresRequests) {
+                continue;
+            }
+            NSArray *ordered = self.respondsInReverseOrder ? responses.reverseObjectEnumerator.allObjects : responses;
+            NSMutableData *output = [[NSMutableData alloc] init];
+            for (id response in ordered) {
+                NSData *payload = [NSJSONSerialization dataWithJSONObject:response options:0 error:nil];
+                if (JRPCStreamFramingLengthPrefixed == self.framing) {
+                    uint32_t frameLength = CFSwapInt32HostToBig((uint32_t)payload.length);
+                    [output appendBytes:&frameLength length:sizeof(frameLength)];
+                }
+                [output appendData:payload];
+                if (JRPCStreamFramingNewlineDelimited == self.framing) {
+                    [output appendBytes:"\n" length:1];
+                }
+            }
+            const uint8_t *bytes = output.bytes;
+            NSUInteger fragmentSize = self.fragmentSize;
+            NSUInteger written = 0;
+            while (written < output.length) {
+                NSUInteger length = fragmentSize ? MIN(fragmentSize, output.length - written) : output.length - written;
+                if ((count = write(self.fileDescriptor, bytes + written, length)) <= 0) {
+                    break;
+                }
+                written += (NSUInteger)count;
+                if (fragmentSize) {
+                    usleep(1000);
+                }
+            }
+        }
+    }
+    close(self.fileDescriptor);
+}
+
+- (NSData*) nextFrameFromBuffer:(NSMutableData*)buffer {
+    NSData *frame = nil;
+    if (JRPCStreamFramingLengthPrefixed == self.framing) {
+        uint32_t frameLength;
+        if (buffer.length < sizeof(frameLength)) {
+            return nil;
+        }
+        [buffer getBytes:&frameLength length:sizeof(frameLength)];
+        frameLength = CFSwapInt32BigToHost(frameLength);
+        if (buffer.length < sizeof(frameLength) + frameLength) {
+            return nil;
+        }
+        frame = [buffer subdataWithRange:NSMakeRange(sizeof(frameLength), frameLength)];
+        [buffer replaceBytesInRange:NSMakeRange(0, sizeof(frameLength) + frameLength) withBytes:NULL length:0];
+    }
+    else {
+        const uint8_t *lineFeed = memchr(buffer.bytes, '\n', buffer.length);
+        if (!lineFeed) {
+            return nil;
+        }
+        NSUInteger frameLength = (NSUInteger)(lineFeed - (const uint8_t*)buffer.bytes);
+        frame = [buffer subdataWithRange:NSMakeRange(0, frameLength)];
+        [buffer replaceBytesInRange:NSMakeRange(0, frameLength + 1) withBytes:NULL length:0];
+    }
+    return frame;
+}
+
+- (id) responseForPayload:(id)payload {
+    if ([payload isKindOfClass:[NSArray class]]) {
+        self.batchCount++;
+        NSMutableArray *responses = [[NSMutableArray alloc] init];
+        for (id request in payload) {
+            id response = [self responseForPayload:request];
+            if (response) {
+                [responses addObject:response];
+            }
+        }
+        return responses.count > 0 ? [responses copy] : nil;
+    }
+    if (![payload isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+    NSDictionary *request = payload;
+    if (!request.jsonRPC_requestId) {
+        self.notificationCount++;
+        return nil;
+    }
+    return @{ kJSONRPCVersionKey   : kJSONRPCVersion,
+              kJSONRPCRequestIdKey : request.jsonRPC_requestId,
+              kJSONRPCResultKey    : request.jsonRPC_parametersByPosition.firstObject ? : [NSNull null] };
+}
+
+@end